@@ -69,6 +69,8 @@ private:
   DCParameter *_element_type;
   int _array_size;
   DCUnsignedIntRange _array_size_range;
+
+  friend class DCPackerLayout;
 };
 
 #endif
@@ -14,6 +14,7 @@
 #include "dcField.h"
 #include "dcFile.h"
 #include "dcPacker.h"
+#include "dcPackerLayout.h"
 #include "dcClass.h"
 #include "hashGenerator.h"
 #include "dcmsgtypes.h"
@@ -201,6 +202,17 @@ parse_string(const string &formatted_string) {
  */
 bool DCField::
 validate_ranges(const vector_uchar &packed_data) const {
+  const DCPackerLayout *layout = get_layout();
+  if (layout->is_valid()) {
+    // Validate the record in place, without copying it into a DCPacker.
+    size_t p = 0;
+    bool pack_error = false;
+    bool range_error = false;
+    layout->validate((const char *)packed_data.data(), packed_data.size(), p,
+                     pack_error, range_error);
+    return !pack_error && !range_error && p == packed_data.size();
+  }
+
   DCPacker packer;
   packer.set_unpack_data(packed_data);
   packer.begin_unpack(this);
@@ -12,6 +12,7 @@
  */
 
 #include "dcPacker.h"
+#include "dcPackerLayout.h"
 #include "dcSwitch.h"
 #include "dcParserDefs.h"
 #include "dcLexerDefs.h"
@@ -584,6 +585,13 @@ unpack_validate() {
     if (_current_field->unpack_validate(_unpack_data, _unpack_length, _unpack_p,
                                         _pack_error, _range_error)) {
       advance();
+
+    } else if (_current_field->get_layout()->validate(_unpack_data, _unpack_length,
+                                                      _unpack_p, _pack_error,
+                                                      _range_error)) {
+      // The field's compiled layout validated the whole thing at once.
+      advance();
+
     } else {
       // If the single field couldn't be validated, try validating nested
       // fields.
@@ -611,6 +619,10 @@ unpack_skip() {
                                     _pack_error)) {
       advance();
 
+    } else if (_current_field->get_layout()->skip(_unpack_data, _unpack_length,
+                                                  _unpack_p, _pack_error)) {
+      advance();
+
     } else {
       // If the single field couldn't be skipped, try skipping nested fields.
       push();
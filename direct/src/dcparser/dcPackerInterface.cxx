@@ -13,6 +13,7 @@
 
 #include "dcPackerInterface.h"
 #include "dcPackerCatalog.h"
+#include "dcPackerLayout.h"
 #include "dcField.h"
 #include "dcParserDefs.h"
 #include "dcLexerDefs.h"
@@ -35,6 +36,7 @@ DCPackerInterface(const string &name) :
   _num_nested_fields = -1;
   _pack_type = PT_invalid;
   _catalog = nullptr;
+  _layout = nullptr;
 }
 
 /**
@@ -53,6 +55,7 @@ DCPackerInterface(const DCPackerInterface &copy) :
   _pack_type(copy._pack_type)
 {
   _catalog = nullptr;
+  _layout = nullptr;
 }
 
 /**
@@ -63,6 +66,9 @@ DCPackerInterface::
   if (_catalog != nullptr) {
     delete _catalog;
   }
+  if (_layout != nullptr) {
+    delete _layout;
+  }
 }
 
 /**
@@ -391,6 +397,19 @@ get_catalog() const {
   return _catalog;
 }
 
+/**
+ * Returns the DCPackerLayout associated with this field: its compiled wire
+ * format, used to validate, skip, pack or unpack a whole record at once.  Be
+ * sure to check DCPackerLayout::is_valid(); not every field can be compiled.
+ */
+const DCPackerLayout *DCPackerInterface::
+get_layout() const {
+  if (_layout == nullptr) {
+    ((DCPackerInterface *)this)->make_layout();
+  }
+  return _layout;
+}
+
 /**
  * Returns true if this field matches the indicated simple parameter, false
  * otherwise.
@@ -455,3 +474,12 @@ make_catalog() {
 
   _catalog->r_fill_catalog("", this, nullptr, 0);
 }
+
+/**
+ * Called internally to create a new DCPackerLayout object.
+ */
+void DCPackerInterface::
+make_layout() {
+  nassertv(_layout == nullptr);
+  _layout = new DCPackerLayout(this);
+}
@@ -27,6 +27,7 @@ class DCAtomicField;
 class DCMolecularField;
 class DCPackData;
 class DCPackerCatalog;
+class DCPackerLayout;
 
 BEGIN_PUBLISH
 // This enumerated type is returned by get_pack_type() and represents the best
@@ -169,6 +170,7 @@ public:
                                             bool &range_error);
 
   const DCPackerCatalog *get_catalog() const;
+  const DCPackerLayout *get_layout() const;
 
 protected:
   virtual bool do_check_match(const DCPackerInterface *other) const=0;
@@ -186,6 +188,7 @@ public:
 
 private:
   void make_catalog();
+  void make_layout();
 
 protected:
   std::string _name;
@@ -200,6 +203,7 @@ protected:
 
 private:
   DCPackerCatalog *_catalog;
+  DCPackerLayout *_layout;
 };
 
 #include "dcPackerInterface.I"
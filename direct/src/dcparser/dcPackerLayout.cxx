@@ -0,0 +1,1124 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file dcPackerLayout.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "dcPackerLayout.h"
+#include "dcPackData.h"
+#include "dcField.h"
+#include "dcParameter.h"
+#include "dcSimpleParameter.h"
+#include "dcArrayParameter.h"
+
+/**
+ * The layout is created only by DCPackerInterface::get_layout().
+ */
+DCPackerLayout::
+DCPackerLayout(const DCPackerInterface *root) : _root(root) {
+  size_t offset = 0;
+  _is_valid = r_compile(root, false, offset);
+  if (!_is_valid) {
+    _ops.clear();
+  }
+}
+
+/**
+ *
+ */
+DCPackerLayout::
+~DCPackerLayout() {
+}
+
+/**
+ * Validates the packed data for the field that begins at data + p, the same
+ * as DCPackerInterface::unpack_validate() and its nested fields would,
+ * advancing p to the end of the field.  Returns true if the layout was able
+ * to do this, or false if the layout is not valid.
+ */
+bool DCPackerLayout::
+validate(const char *data, size_t length, size_t &p,
+         bool &pack_error, bool &range_error) const {
+  if (!_is_valid) {
+    return false;
+  }
+  r_validate(&_ops[0], &_ops[0] + _ops.size(), data, length, p, true,
+             pack_error, range_error);
+  return true;
+}
+
+/**
+ * Advances p past the packed data for the field without performing any
+ * range validation.  Returns true if the layout was able to do this, or
+ * false if the layout is not valid.
+ */
+bool DCPackerLayout::
+skip(const char *data, size_t length, size_t &p, bool &pack_error) const {
+  if (!_is_valid) {
+    return false;
+  }
+  bool range_error = false;
+  r_validate(&_ops[0], &_ops[0] + _ops.size(), data, length, p, false,
+             pack_error, range_error);
+  return true;
+}
+
+/**
+ * Unpacks all of the values of the field that begins at data + p, appending
+ * them to the end of values, and advances p to the end of the field.  String
+ * and blob values reference the packed data directly, so they remain valid
+ * only as long as the data does.
+ *
+ * Returns true if the layout was able to do this, or false if the layout is
+ * not valid.  Once values has grown to accommodate the largest record, this
+ * does not allocate any memory.
+ */
+bool DCPackerLayout::
+unpack(const char *data, size_t length, size_t &p, Values &values,
+       bool &pack_error, bool &range_error) const {
+  if (!_is_valid) {
+    return false;
+  }
+  r_unpack(&_ops[0], &_ops[0] + _ops.size(), data, length, p, values,
+           pack_error, range_error);
+  return true;
+}
+
+/**
+ * Packs the field from the indicated list of values, in the same form that
+ * is produced by unpack(), onto the end of pack_data.  num_used is set to
+ * the number of values that were consumed.
+ *
+ * Returns true if the layout was able to do this, or false if the layout is
+ * not valid.  If pack_data is reused, this does not allocate any memory once
+ * its buffer has grown to accommodate the largest record.
+ */
+bool DCPackerLayout::
+pack(DCPackData &pack_data, const Value *values, size_t num_values,
+     size_t &num_used, bool &pack_error, bool &range_error) const {
+  if (!_is_valid) {
+    return false;
+  }
+  const Value *value = values;
+  r_pack(&_ops[0], &_ops[0] + _ops.size(), pack_data, value,
+         values + num_values, pack_error, range_error);
+  num_used = value - values;
+  return true;
+}
+
+/**
+ * Writes a one-line-per-operation description of the layout, for debugging.
+ */
+void DCPackerLayout::
+output(std::ostream &out) const {
+  static const char *const type_names[] = {
+    "int", "uint", "int", "uint", "float", "string", "blob",
+    "block", "repeat", "array",
+  };
+
+  if (!_is_valid) {
+    out << "(not compiled)\n";
+    return;
+  }
+
+  // Keep track of where each nested sequence ends so we can indent.  The
+  // offsets are only meaningful within a block.
+  pvector<size_t> ends;
+  size_t block_end = 0;
+  for (size_t i = 0; i < _ops.size(); ++i) {
+    while (!ends.empty() && i >= ends.back()) {
+      ends.pop_back();
+    }
+    const Op &op = _ops[i];
+    out << std::string(ends.size() * 2, ' ') << type_names[op._type];
+    switch (op._type) {
+    case OT_block:
+      out << " " << op._fixed_size << " bytes";
+      block_end = i + 1 + op._num_ops;
+      break;
+    case OT_repeat:
+      out << " " << op._count << " x " << op._fixed_size << " bytes";
+      break;
+    case OT_array:
+    case OT_string:
+    case OT_blob:
+      if (op._size != 0) {
+        out << " (" << op._size << "-byte length)";
+      } else {
+        out << " " << op._fixed_size << " bytes";
+      }
+      break;
+    default:
+      out << op._size * 8;
+      if (op._scaled) {
+        out << " / " << op._divisor;
+      }
+      break;
+    }
+    if (i < block_end && op._type != OT_block) {
+      out << " @" << op._offset;
+    }
+    if (op._has_range_limits) {
+      out << " ranged";
+    }
+    out << "\n";
+    if (op._num_ops != 0) {
+      ends.push_back(i + 1 + op._num_ops);
+    }
+  }
+}
+
+/**
+ * Appends the operations that describe the indicated field.  If in_block is
+ * true, the field is part of a fixed-size block, and offset is the position
+ * of the field within it; offset is advanced past the field.  Returns false
+ * if the field cannot be represented.
+ */
+bool DCPackerLayout::
+r_compile(const DCPackerInterface *field, bool in_block, size_t &offset) {
+  if (field->as_switch_parameter() != nullptr) {
+    return false;
+  }
+
+  const DCParameter *param = nullptr;
+  const DCField *as_field = field->as_field();
+  if (as_field != nullptr) {
+    param = as_field->as_parameter();
+  }
+  const DCSimpleParameter *simple = nullptr;
+  const DCArrayParameter *array = nullptr;
+  if (param != nullptr) {
+    simple = param->as_simple_parameter();
+    array = param->as_array_parameter();
+  }
+
+  if (simple != nullptr && compile_simple(simple, in_block, offset)) {
+    return true;
+  }
+
+  if (!field->has_nested_fields()) {
+    return false;
+  }
+
+  if (!in_block && field->has_fixed_byte_size()) {
+    // This is the outermost field of a run of fixed-size data.  Gather it
+    // into a block, so that it needs only one bounds check.
+    size_t block_index = _ops.size();
+    size_t block_offset = 0;
+    add_op(OT_block, field, block_offset, 0);
+    if (!r_compile(field, true, block_offset)) {
+      return false;
+    }
+    nassertr(block_offset == field->get_fixed_byte_size(), false);
+
+    Op &block = _ops[block_index];
+    block._fixed_size = block_offset;
+    block._num_ops = _ops.size() - block_index - 1;
+    for (size_t i = block_index + 1; i < _ops.size(); ++i) {
+      block._has_range_limits = block._has_range_limits || _ops[i]._has_range_limits;
+    }
+    return true;
+  }
+
+  // An array of single bytes that would be packed as a string is compiled
+  // as a string, provided that its length is unconstrained or fixed.
+  DCPackType pack_type = field->get_pack_type();
+  if ((pack_type == PT_string || pack_type == PT_blob) &&
+      (array == nullptr || array->_array_size_range.is_empty() ||
+       array->_array_size >= 0)) {
+    const DCPackerInterface *element = field->get_nested_field(0);
+    if (element != nullptr && element->has_fixed_byte_size() &&
+        element->get_fixed_byte_size() == 1 && !element->has_range_limits() &&
+        field->get_num_length_bytes() <= 2) {
+      OpType type = (pack_type == PT_string) ? OT_string : OT_blob;
+      if (field->has_fixed_byte_size()) {
+        Op &op = add_op(type, field, offset, field->get_fixed_byte_size());
+        op._size = 0;
+        op._fixed_size = field->get_fixed_byte_size();
+      } else {
+        Op &op = add_op(type, field, offset, 0);
+        op._size = field->get_num_length_bytes();
+      }
+      return true;
+    }
+  }
+
+  if (field->get_num_length_bytes() != 0) {
+    // A variable-length array with a length prefix.  All of the nested
+    // fields are of the same type.
+    nassertr(!in_block, false);
+    const DCPackerInterface *element = field->get_nested_field(0);
+    if (element == nullptr) {
+      return false;
+    }
+    size_t element_size = 0;
+    if (element->has_fixed_byte_size()) {
+      element_size = element->get_fixed_byte_size();
+      if (element_size == 0) {
+        return false;
+      }
+    }
+
+    size_t array_index = _ops.size();
+    add_op(OT_array, field, offset, 0);
+    size_t element_offset = 0;
+    if (!r_compile(element, false, element_offset)) {
+      return false;
+    }
+
+    Op &op = _ops[array_index];
+    op._size = field->get_num_length_bytes();
+    op._fixed_size = element_size;
+    op._num_ops = _ops.size() - array_index - 1;
+    op._has_range_limits = field->has_range_limits();
+    if (array != nullptr && !array->_array_size_range.is_empty()) {
+      op._uint_range = &array->_array_size_range;
+    }
+    return true;
+  }
+
+  int num_nested_fields = field->get_num_nested_fields();
+  if (num_nested_fields < 0) {
+    return false;
+  }
+
+  if (array != nullptr) {
+    // A fixed-size array of fixed-size elements.  This is necessarily
+    // within a block.
+    nassertr(in_block, false);
+    const DCPackerInterface *element = array->get_element_type();
+    size_t repeat_index = _ops.size();
+    add_op(OT_repeat, field, offset, 0);
+    size_t element_offset = 0;
+    if (!r_compile(element, true, element_offset)) {
+      return false;
+    }
+
+    Op &op = _ops[repeat_index];
+    op._count = num_nested_fields;
+    op._fixed_size = element_offset;
+    op._num_ops = _ops.size() - repeat_index - 1;
+    for (size_t i = repeat_index + 1; i < _ops.size(); ++i) {
+      op._has_range_limits = op._has_range_limits || _ops[i]._has_range_limits;
+    }
+    offset += element_offset * num_nested_fields;
+    return true;
+  }
+
+  // Otherwise, this is a structure of some kind (an atomic or molecular
+  // field, or a class parameter); its nested fields are simply laid out in
+  // sequence.
+  for (int i = 0; i < num_nested_fields; ++i) {
+    const DCPackerInterface *nested = field->get_nested_field(i);
+    if (nested == nullptr || !r_compile(nested, in_block, offset)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Appends the operation for the indicated simple parameter, if it is a
+ * single number or string.  Returns false if it is one of the array types,
+ * which must be compiled as an array instead.
+ */
+bool DCPackerLayout::
+compile_simple(const DCSimpleParameter *simple, bool in_block, size_t &offset) {
+  bool has_range = simple->has_range_limits();
+  bool scaled = (simple->_divisor != 1 || simple->_has_modulus);
+
+  Op *op;
+  switch (simple->_type) {
+  case ST_int8:
+  case ST_int16:
+  case ST_int32:
+    op = &add_op(OT_int, simple, offset, simple->get_fixed_byte_size());
+    if (has_range) {
+      op->_int_range = &simple->_int_range;
+    }
+    break;
+
+  case ST_int64:
+    op = &add_op(OT_int64, simple, offset, 8);
+    if (has_range) {
+      op->_int64_range = &simple->_int64_range;
+    }
+    break;
+
+  case ST_char:
+  case ST_uint8:
+  case ST_uint16:
+  case ST_uint32:
+    op = &add_op(OT_uint, simple, offset, simple->get_fixed_byte_size());
+    if (has_range) {
+      op->_uint_range = &simple->_uint_range;
+    }
+    break;
+
+  case ST_uint64:
+    op = &add_op(OT_uint64, simple, offset, 8);
+    if (has_range) {
+      op->_uint64_range = &simple->_uint64_range;
+    }
+    break;
+
+  case ST_float64:
+    op = &add_op(OT_double, simple, offset, 8);
+    if (has_range) {
+      op->_double_range = &simple->_double_range;
+    }
+    break;
+
+  case ST_string:
+  case ST_blob:
+  case ST_blob32:
+    {
+      OpType type = (simple->_type == ST_string) ? OT_string : OT_blob;
+      if (simple->get_num_length_bytes() == 0) {
+        op = &add_op(type, simple, offset, simple->get_fixed_byte_size());
+        op->_size = 0;
+        op->_fixed_size = simple->get_fixed_byte_size();
+      } else {
+        op = &add_op(type, simple, offset, 0);
+        op->_size = simple->get_num_length_bytes();
+      }
+      if (has_range) {
+        op->_uint_range = &simple->_uint_range;
+        op->_has_range_limits = true;
+      }
+      // Strings are never scaled.
+      return true;
+    }
+
+  default:
+    return false;
+  }
+
+  op->_has_range_limits = has_range;
+  op->_scaled = scaled;
+  op->_divisor = simple->_divisor;
+  return true;
+}
+
+/**
+ * Appends a new operation with default settings, located at the indicated
+ * offset, and advances offset by size bytes.
+ */
+DCPackerLayout::Op &DCPackerLayout::
+add_op(OpType type, const DCPackerInterface *field, size_t &offset,
+       size_t size) {
+  Op op;
+  op._type = type;
+  op._size = (unsigned int)size;
+  op._offset = offset;
+  op._fixed_size = 0;
+  op._count = 0;
+  op._num_ops = 0;
+  op._has_range_limits = false;
+  op._int_range = nullptr;
+  op._field = field;
+  op._scaled = false;
+  op._divisor = 1.0;
+  _ops.push_back(op);
+
+  offset += size;
+  return _ops.back();
+}
+
+/**
+ * Walks the packed data described by the operations in the range [op, end),
+ * checking range limits along the way if check_ranges is true.
+ */
+void DCPackerLayout::
+r_validate(const Op *op, const Op *end, const char *data, size_t length,
+           size_t &p, bool check_ranges,
+           bool &pack_error, bool &range_error) const {
+  while (op < end && !pack_error) {
+    switch (op->_type) {
+    case OT_int:
+    case OT_uint:
+    case OT_int64:
+    case OT_uint64:
+    case OT_double:
+      if (p + op->_size > length) {
+        pack_error = true;
+        return;
+      }
+      if (check_ranges && op->_has_range_limits) {
+        validate_value(*op, data + p, range_error);
+      }
+      p += op->_size;
+      ++op;
+      break;
+
+    case OT_string:
+    case OT_blob:
+      {
+        size_t string_length = op->_fixed_size;
+        if (op->_size != 0) {
+          if (p + op->_size > length) {
+            pack_error = true;
+            return;
+          }
+          if (op->_size == 4) {
+            string_length = DCPackerInterface::do_unpack_uint32(data + p);
+          } else {
+            string_length = DCPackerInterface::do_unpack_uint16(data + p);
+          }
+          p += op->_size;
+          if (check_ranges && op->_uint_range != nullptr) {
+            op->_uint_range->validate(string_length, range_error);
+          }
+        }
+        p += string_length;
+        if (p > length) {
+          pack_error = true;
+          return;
+        }
+        ++op;
+      }
+      break;
+
+    case OT_block:
+      if (p + op->_fixed_size > length) {
+        pack_error = true;
+        return;
+      }
+      if (check_ranges && op->_has_range_limits) {
+        r_validate_fixed(op + 1, op + 1 + op->_num_ops, data + p, range_error);
+      }
+      p += op->_fixed_size;
+      op += 1 + op->_num_ops;
+      break;
+
+    case OT_array:
+      {
+        if (p + op->_size > length) {
+          pack_error = true;
+          return;
+        }
+        size_t array_length;
+        if (op->_size == 4) {
+          array_length = DCPackerInterface::do_unpack_uint32(data + p);
+        } else {
+          array_length = DCPackerInterface::do_unpack_uint16(data + p);
+        }
+        p += op->_size;
+        size_t array_end = p + array_length;
+
+        const Op &array = *op;
+        const Op *element = op + 1;
+        const Op *element_end = element + op->_num_ops;
+        op = element_end;
+
+        if (!check_ranges || !array._has_range_limits) {
+          // Without range limits, we only need the length prefix.
+          p = array_end;
+          if (p > length) {
+            pack_error = true;
+            return;
+          }
+          break;
+        }
+
+        unsigned int count = 0;
+        if (array._fixed_size != 0) {
+          unsigned int num_elements = array_length / array._fixed_size;
+          while (count < num_elements && !pack_error) {
+            r_validate(element, element_end, data, length, p, check_ranges,
+                       pack_error, range_error);
+            ++count;
+          }
+        } else {
+          while (p < array_end && !pack_error) {
+            r_validate(element, element_end, data, length, p, check_ranges,
+                       pack_error, range_error);
+            ++count;
+          }
+        }
+
+        if (p != array_end) {
+          pack_error = true;
+        }
+        if (array._uint_range != nullptr) {
+          // An incorrect number of elements is a pack error, not a range
+          // error; see DCPacker::pop().
+          bool count_error = false;
+          array._uint_range->validate(count, count_error);
+          if (count_error) {
+            pack_error = true;
+          }
+        }
+      }
+      break;
+
+    case OT_repeat:
+      // A repeat only ever appears within a block.
+      nassertv(false);
+      pack_error = true;
+      return;
+    }
+  }
+}
+
+/**
+ * Checks the range limits of the fixed-size data described by the
+ * operations in the range [op, end), which begins at base.  The caller has
+ * already verified that all of the data lies within the buffer.
+ */
+void DCPackerLayout::
+r_validate_fixed(const Op *op, const Op *end, const char *base,
+                 bool &range_error) const {
+  while (op < end) {
+    switch (op->_type) {
+    case OT_repeat:
+      {
+        const Op *element = op + 1;
+        const Op *element_end = element + op->_num_ops;
+        if (op->_has_range_limits) {
+          const char *ptr = base + op->_offset;
+          for (unsigned int i = 0; i < op->_count; ++i) {
+            r_validate_fixed(element, element_end, ptr, range_error);
+            ptr += op->_fixed_size;
+          }
+        }
+        op = element_end;
+      }
+      break;
+
+    default:
+      if (op->_has_range_limits) {
+        validate_value(*op, base + op->_offset, range_error);
+      }
+      ++op;
+      break;
+    }
+  }
+}
+
+/**
+ * Unpacks the values described by the operations in the range [op, end),
+ * appending them to values.
+ */
+void DCPackerLayout::
+r_unpack(const Op *op, const Op *end, const char *data, size_t length,
+         size_t &p, Values &values,
+         bool &pack_error, bool &range_error) const {
+  while (op < end && !pack_error) {
+    switch (op->_type) {
+    case OT_int:
+    case OT_uint:
+    case OT_int64:
+    case OT_uint64:
+    case OT_double:
+      if (p + op->_size > length) {
+        pack_error = true;
+        return;
+      }
+      values.push_back(Value());
+      unpack_value(*op, data + p, values.back(), range_error);
+      p += op->_size;
+      ++op;
+      break;
+
+    case OT_string:
+    case OT_blob:
+      {
+        size_t string_length = op->_fixed_size;
+        if (op->_size != 0) {
+          if (p + op->_size > length) {
+            pack_error = true;
+            return;
+          }
+          if (op->_size == 4) {
+            string_length = DCPackerInterface::do_unpack_uint32(data + p);
+          } else {
+            string_length = DCPackerInterface::do_unpack_uint16(data + p);
+          }
+          p += op->_size;
+          if (op->_uint_range != nullptr) {
+            op->_uint_range->validate(string_length, range_error);
+          }
+        }
+        if (p + string_length > length) {
+          pack_error = true;
+          return;
+        }
+        values.push_back(Value());
+        Value &value = values.back();
+        value._type = (op->_type == OT_string) ? PT_string : PT_blob;
+        value._uint64 = 0;
+        value._data = data + p;
+        value._length = string_length;
+        p += string_length;
+        ++op;
+      }
+      break;
+
+    case OT_block:
+      if (p + op->_fixed_size > length) {
+        pack_error = true;
+        return;
+      }
+      r_unpack_fixed(op + 1, op + 1 + op->_num_ops, data + p, values,
+                     range_error);
+      p += op->_fixed_size;
+      op += 1 + op->_num_ops;
+      break;
+
+    case OT_array:
+      {
+        if (p + op->_size > length) {
+          pack_error = true;
+          return;
+        }
+        size_t array_length;
+        if (op->_size == 4) {
+          array_length = DCPackerInterface::do_unpack_uint32(data + p);
+        } else {
+          array_length = DCPackerInterface::do_unpack_uint16(data + p);
+        }
+        p += op->_size;
+        size_t array_end = p + array_length;
+
+        // We fill in the number of elements when we know it.
+        size_t array_index = values.size();
+        values.push_back(Value());
+        values.back()._type = PT_array;
+        values.back()._uint64 = 0;
+        values.back()._data = nullptr;
+
+        const Op &array = *op;
+        const Op *element = op + 1;
+        const Op *element_end = element + op->_num_ops;
+        unsigned int count = 0;
+        if (array._fixed_size != 0) {
+          unsigned int num_elements = array_length / array._fixed_size;
+          while (count < num_elements && !pack_error) {
+            r_unpack(element, element_end, data, length, p, values,
+                     pack_error, range_error);
+            ++count;
+          }
+        } else {
+          while (p < array_end && !pack_error) {
+            r_unpack(element, element_end, data, length, p, values,
+                     pack_error, range_error);
+            ++count;
+          }
+        }
+        values[array_index]._length = count;
+
+        if (p != array_end) {
+          pack_error = true;
+        }
+        if (array._uint_range != nullptr) {
+          bool count_error = false;
+          array._uint_range->validate(count, count_error);
+          if (count_error) {
+            pack_error = true;
+          }
+        }
+        op = element_end;
+      }
+      break;
+
+    case OT_repeat:
+      nassertv(false);
+      pack_error = true;
+      return;
+    }
+  }
+}
+
+/**
+ * Unpacks the fixed-size data described by the operations in the range [op,
+ * end), which begins at base.  The caller has already verified that all of
+ * the data lies within the buffer.
+ */
+void DCPackerLayout::
+r_unpack_fixed(const Op *op, const Op *end, const char *base,
+               Values &values, bool &range_error) const {
+  while (op < end) {
+    switch (op->_type) {
+    case OT_string:
+    case OT_blob:
+      {
+        values.push_back(Value());
+        Value &value = values.back();
+        value._type = (op->_type == OT_string) ? PT_string : PT_blob;
+        value._uint64 = 0;
+        value._data = base + op->_offset;
+        value._length = op->_fixed_size;
+        ++op;
+      }
+      break;
+
+    case OT_repeat:
+      {
+        values.push_back(Value());
+        Value &value = values.back();
+        value._type = PT_array;
+        value._uint64 = 0;
+        value._data = nullptr;
+        value._length = op->_count;
+
+        const Op *element = op + 1;
+        const Op *element_end = element + op->_num_ops;
+        const char *ptr = base + op->_offset;
+        for (unsigned int i = 0; i < op->_count; ++i) {
+          r_unpack_fixed(element, element_end, ptr, values, range_error);
+          ptr += op->_fixed_size;
+        }
+        op = element_end;
+      }
+      break;
+
+    default:
+      values.push_back(Value());
+      unpack_value(*op, base + op->_offset, values.back(), range_error);
+      ++op;
+      break;
+    }
+  }
+}
+
+/**
+ * Packs the values beginning at value according to the operations in the
+ * range [op, end), advancing value past the values that were consumed.
+ */
+void DCPackerLayout::
+r_pack(const Op *op, const Op *end, DCPackData &pack_data,
+       const Value *&value, const Value *values_end,
+       bool &pack_error, bool &range_error) const {
+  while (op < end && !pack_error) {
+    if (value >= values_end) {
+      // Not enough values.
+      pack_error = true;
+      return;
+    }
+
+    switch (op->_type) {
+    case OT_block:
+      // The contents of a block are already in the order they are packed.
+      ++op;
+      break;
+
+    case OT_repeat:
+      {
+        if (value->_type != PT_array || value->_length != op->_count) {
+          pack_error = true;
+          return;
+        }
+        ++value;
+        const Op *element = op + 1;
+        const Op *element_end = element + op->_num_ops;
+        for (unsigned int i = 0; i < op->_count && !pack_error; ++i) {
+          r_pack(element, element_end, pack_data, value, values_end,
+                 pack_error, range_error);
+        }
+        op = element_end;
+      }
+      break;
+
+    case OT_array:
+      {
+        if (value->_type != PT_array) {
+          pack_error = true;
+          return;
+        }
+        size_t count = value->_length;
+        ++value;
+
+        // Reserve room for the length prefix, and go back to fill it in when
+        // we know it.
+        size_t push_marker = pack_data.get_length();
+        pack_data.append_junk(op->_size);
+
+        const Op *element = op + 1;
+        const Op *element_end = element + op->_num_ops;
+        for (size_t i = 0; i < count && !pack_error; ++i) {
+          r_pack(element, element_end, pack_data, value, values_end,
+                 pack_error, range_error);
+        }
+
+        size_t length = pack_data.get_length() - push_marker - op->_size;
+        if (op->_size == 4) {
+          DCPackerInterface::do_pack_uint32
+            (pack_data.get_rewrite_pointer(push_marker, 4), length);
+        } else {
+          DCPackerInterface::validate_uint_limits(length, 16, range_error);
+          DCPackerInterface::do_pack_uint16
+            (pack_data.get_rewrite_pointer(push_marker, 2), length);
+        }
+
+        if (op->_uint_range != nullptr) {
+          bool count_error = false;
+          op->_uint_range->validate(count, count_error);
+          if (count_error) {
+            pack_error = true;
+          }
+        }
+        op = element_end;
+      }
+      break;
+
+    default:
+      pack_value(*op, pack_data, *value, pack_error, range_error);
+      ++value;
+      ++op;
+      break;
+    }
+  }
+}
+
+/**
+ * Unpacks the single number or string that begins at ptr into value,
+ * checking it against the range limits of the operation.  The caller has
+ * already verified that the data lies within the buffer.
+ */
+void DCPackerLayout::
+unpack_value(const Op &op, const char *ptr, Value &value, bool &range_error) {
+  value._data = nullptr;
+  value._length = 0;
+
+  switch (op._type) {
+  case OT_int:
+    {
+      int int_value;
+      switch (op._size) {
+      case 1:
+        int_value = DCPackerInterface::do_unpack_int8(ptr);
+        break;
+      case 2:
+        int_value = DCPackerInterface::do_unpack_int16(ptr);
+        break;
+      default:
+        int_value = DCPackerInterface::do_unpack_int32(ptr);
+        break;
+      }
+      if (op._int_range != nullptr) {
+        op._int_range->validate(int_value, range_error);
+      }
+      value._type = PT_int64;
+      value._int64 = int_value;
+    }
+    break;
+
+  case OT_uint:
+    {
+      unsigned int uint_value;
+      switch (op._size) {
+      case 1:
+        uint_value = DCPackerInterface::do_unpack_uint8(ptr);
+        break;
+      case 2:
+        uint_value = DCPackerInterface::do_unpack_uint16(ptr);
+        break;
+      default:
+        uint_value = DCPackerInterface::do_unpack_uint32(ptr);
+        break;
+      }
+      if (op._uint_range != nullptr) {
+        op._uint_range->validate(uint_value, range_error);
+      }
+      value._type = PT_uint64;
+      value._uint64 = uint_value;
+    }
+    break;
+
+  case OT_int64:
+    value._type = PT_int64;
+    value._int64 = DCPackerInterface::do_unpack_int64(ptr);
+    if (op._int64_range != nullptr) {
+      op._int64_range->validate(value._int64, range_error);
+    }
+    break;
+
+  case OT_uint64:
+    value._type = PT_uint64;
+    value._uint64 = DCPackerInterface::do_unpack_uint64(ptr);
+    if (op._uint64_range != nullptr) {
+      op._uint64_range->validate(value._uint64, range_error);
+    }
+    break;
+
+  case OT_double:
+    value._type = PT_double;
+    value._double = DCPackerInterface::do_unpack_float64(ptr);
+    if (op._double_range != nullptr) {
+      op._double_range->validate(value._double, range_error);
+    }
+    break;
+
+  default:
+    nassertv(false);
+  }
+
+  if (op._divisor != 1.0) {
+    // A fixed-point number is reported as a double, as DCPacker would.
+    switch (value._type) {
+    case PT_int64:
+      value._double = (double)value._int64 / op._divisor;
+      break;
+    case PT_uint64:
+      value._double = (double)value._uint64 / op._divisor;
+      break;
+    default:
+      value._double /= op._divisor;
+      break;
+    }
+    value._type = PT_double;
+  }
+}
+
+/**
+ * Packs the single number or string described by the operation from the
+ * indicated value.
+ */
+void DCPackerLayout::
+pack_value(const Op &op, DCPackData &pack_data, const Value &value,
+           bool &pack_error, bool &range_error) {
+  if (op._type == OT_string || op._type == OT_blob) {
+    if (value._type != PT_string && value._type != PT_blob) {
+      pack_error = true;
+      return;
+    }
+    if (op._uint_range != nullptr) {
+      op._uint_range->validate(value._length, range_error);
+    } else if (op._size == 0 && value._length != op._fixed_size) {
+      range_error = true;
+    }
+    if (op._size == 4) {
+      DCPackerInterface::validate_uint64_limits(value._length, 32, range_error);
+      DCPackerInterface::do_pack_uint32(pack_data.get_write_pointer(4), value._length);
+    } else if (op._size == 2) {
+      DCPackerInterface::validate_uint64_limits(value._length, 16, range_error);
+      DCPackerInterface::do_pack_uint16(pack_data.get_write_pointer(2), value._length);
+    }
+    pack_data.append_data(value._data, value._length);
+    return;
+  }
+
+  if (op._scaled || (value._type == PT_double && op._type != OT_double)) {
+    // Let the parameter itself apply the divisor, modulus, and rounding.
+    switch (value._type) {
+    case PT_double:
+      op._field->pack_double(pack_data, value._double, pack_error, range_error);
+      break;
+    case PT_int64:
+      op._field->pack_int64(pack_data, value._int64, pack_error, range_error);
+      break;
+    case PT_uint64:
+      op._field->pack_uint64(pack_data, value._uint64, pack_error, range_error);
+      break;
+    default:
+      pack_error = true;
+    }
+    return;
+  }
+
+  if (value._type != PT_int64 && value._type != PT_uint64 &&
+      value._type != PT_double) {
+    pack_error = true;
+    return;
+  }
+
+  switch (op._type) {
+  case OT_int:
+  case OT_int64:
+    {
+      int64_t int_value = value._int64;
+      if (value._type == PT_uint64 && (int64_t)value._uint64 < 0) {
+        range_error = true;
+      }
+      if (op._type == OT_int) {
+        DCPackerInterface::validate_int64_limits(int_value, op._size * 8, range_error);
+        if (op._int_range != nullptr) {
+          op._int_range->validate((int)int_value, range_error);
+        }
+        char *buffer = pack_data.get_write_pointer(op._size);
+        switch (op._size) {
+        case 1:
+          DCPackerInterface::do_pack_int8(buffer, (int)int_value);
+          break;
+        case 2:
+          DCPackerInterface::do_pack_int16(buffer, (int)int_value);
+          break;
+        default:
+          DCPackerInterface::do_pack_int32(buffer, (int)int_value);
+          break;
+        }
+      } else {
+        if (op._int64_range != nullptr) {
+          op._int64_range->validate(int_value, range_error);
+        }
+        DCPackerInterface::do_pack_int64(pack_data.get_write_pointer(8), int_value);
+      }
+    }
+    break;
+
+  case OT_uint:
+  case OT_uint64:
+    {
+      uint64_t uint_value = value._uint64;
+      if (value._type == PT_int64 && value._int64 < 0) {
+        range_error = true;
+      }
+      if (op._type == OT_uint) {
+        DCPackerInterface::validate_uint64_limits(uint_value, op._size * 8, range_error);
+        if (op._uint_range != nullptr) {
+          op._uint_range->validate((unsigned int)uint_value, range_error);
+        }
+        char *buffer = pack_data.get_write_pointer(op._size);
+        switch (op._size) {
+        case 1:
+          DCPackerInterface::do_pack_uint8(buffer, (unsigned int)uint_value);
+          break;
+        case 2:
+          DCPackerInterface::do_pack_uint16(buffer, (unsigned int)uint_value);
+          break;
+        default:
+          DCPackerInterface::do_pack_uint32(buffer, (unsigned int)uint_value);
+          break;
+        }
+      } else {
+        if (op._uint64_range != nullptr) {
+          op._uint64_range->validate(uint_value, range_error);
+        }
+        DCPackerInterface::do_pack_uint64(pack_data.get_write_pointer(8), uint_value);
+      }
+    }
+    break;
+
+  case OT_double:
+    {
+      double real_value;
+      switch (value._type) {
+      case PT_int64:
+        real_value = (double)value._int64;
+        break;
+      case PT_uint64:
+        real_value = (double)value._uint64;
+        break;
+      default:
+        real_value = value._double;
+        break;
+      }
+      if (op._double_range != nullptr) {
+        op._double_range->validate(real_value, range_error);
+      }
+      DCPackerInterface::do_pack_float64(pack_data.get_write_pointer(8), real_value);
+    }
+    break;
+
+  default:
+    pack_error = true;
+  }
+}
@@ -0,0 +1,187 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file dcPackerLayout.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef DCPACKERLAYOUT_H
+#define DCPACKERLAYOUT_H
+
+#include "dcbase.h"
+#include "dcPackerInterface.h"
+#include "dcNumericRange.h"
+
+class DCPackData;
+
+/**
+ * This is a flattened, precompiled description of the wire format of a
+ * particular field, used to validate, skip, pack and unpack whole records of
+ * that field without walking the DCPackerInterface hierarchy.
+ *
+ * The nested structure of the field is compiled into a linear list of
+ * operations.  Runs of fixed-size data are collected into blocks with
+ * precomputed byte offsets, so that such a block requires only a single
+ * bounds check, and the range limits of each value are referenced directly
+ * from the operation that reads it.  None of the operations allocate memory,
+ * except to grow the caller's output buffers.
+ *
+ * Not every field can be compiled; in particular, fields that contain a
+ * switch cannot.  It is created on demand when a layout is first requested
+ * from a particular field; its ownership is retained by the field so it must
+ * not be deleted.
+ */
+class EXPCL_DIRECT_DCPARSER DCPackerLayout {
+private:
+  DCPackerLayout(const DCPackerInterface *root);
+  ~DCPackerLayout();
+
+public:
+  DCPackerLayout(const DCPackerLayout &copy) = delete;
+  DCPackerLayout &operator = (const DCPackerLayout &copy) = delete;
+
+  // A Value is one unpacked element of the record, or one element to be
+  // packed.  Numbers are stored in the member appropriate to _type; a
+  // numeric field with a divisor is reported as PT_double.  String and blob
+  // values point directly into the packed data.  An array is represented by
+  // a PT_array value giving the number of elements in _length, followed by
+  // the values of each of its elements in turn.
+  class Value {
+  public:
+    DCPackType _type;
+    union {
+      int64_t _int64;
+      uint64_t _uint64;
+      double _double;
+    };
+    const char *_data;
+    size_t _length;
+  };
+  typedef pvector<Value> Values;
+
+  INLINE bool is_valid() const;
+  INLINE size_t get_num_ops() const;
+
+  bool validate(const char *data, size_t length, size_t &p,
+                bool &pack_error, bool &range_error) const;
+  bool skip(const char *data, size_t length, size_t &p,
+            bool &pack_error) const;
+  bool unpack(const char *data, size_t length, size_t &p, Values &values,
+              bool &pack_error, bool &range_error) const;
+  bool pack(DCPackData &pack_data, const Value *values, size_t num_values,
+            size_t &num_used, bool &pack_error, bool &range_error) const;
+
+  void output(std::ostream &out) const;
+
+private:
+  enum OpType {
+    OT_int,
+    OT_uint,
+    OT_int64,
+    OT_uint64,
+    OT_double,
+    OT_string,
+    OT_blob,
+
+    // A run of fixed-size data.  The following _num_ops operations describe
+    // its contents, with offsets relative to the start of the block.
+    OT_block,
+
+    // A fixed number of fixed-size elements within a block.  The following
+    // _num_ops operations describe one element, with offsets relative to the
+    // start of that element.
+    OT_repeat,
+
+    // A variable-length array with a length prefix.  The following _num_ops
+    // operations describe one element.
+    OT_array,
+  };
+
+  class Op {
+  public:
+    OpType _type;
+
+    // The number of bytes of a number, or of the length prefix of a string
+    // or array; zero for a fixed-length string.
+    unsigned int _size;
+
+    // The offset of this value within its enclosing block or repeat.
+    size_t _offset;
+
+    // The total size of a block, of a fixed-length string, or of each
+    // element of a repeat or array (zero if the elements vary in size).
+    size_t _fixed_size;
+
+    // The number of elements of a repeat, or the number of operations that
+    // follow a block, repeat or array.
+    unsigned int _count;
+    unsigned int _num_ops;
+
+    // True if this operation, or any of its nested operations, needs to
+    // check range limits.
+    bool _has_range_limits;
+
+    // The range limits that apply to this value, or nullptr if there are
+    // none.  For strings and arrays, this limits the length.
+    union {
+      const DCIntRange *_int_range;
+      const DCUnsignedIntRange *_uint_range;
+      const DCInt64Range *_int64_range;
+      const DCUnsignedInt64Range *_uint64_range;
+      const DCDoubleRange *_double_range;
+    };
+
+    // A number with a divisor or modulus is unpacked as a double, and is
+    // packed via the parameter itself, which knows how to apply these.
+    const DCPackerInterface *_field;
+    bool _scaled;
+    double _divisor;
+  };
+  typedef pvector<Op> Ops;
+
+  bool r_compile(const DCPackerInterface *field, bool in_block,
+                 size_t &offset);
+  bool compile_simple(const DCSimpleParameter *simple, bool in_block,
+                      size_t &offset);
+  Op &add_op(OpType type, const DCPackerInterface *field, size_t &offset,
+             size_t size);
+
+  void r_validate(const Op *op, const Op *end, const char *data,
+                  size_t length, size_t &p, bool check_ranges,
+                  bool &pack_error, bool &range_error) const;
+  void r_validate_fixed(const Op *op, const Op *end, const char *base,
+                        bool &range_error) const;
+  void r_unpack(const Op *op, const Op *end, const char *data,
+                size_t length, size_t &p, Values &values,
+                bool &pack_error, bool &range_error) const;
+  void r_unpack_fixed(const Op *op, const Op *end, const char *base,
+                      Values &values, bool &range_error) const;
+  void r_pack(const Op *op, const Op *end, DCPackData &pack_data,
+              const Value *&value, const Value *values_end,
+              bool &pack_error, bool &range_error) const;
+
+  INLINE static void validate_value(const Op &op, const char *ptr,
+                                    bool &range_error);
+  static void unpack_value(const Op &op, const char *ptr, Value &value,
+                           bool &range_error);
+  static void pack_value(const Op &op, DCPackData &pack_data,
+                         const Value &value, bool &pack_error,
+                         bool &range_error);
+
+private:
+  const DCPackerInterface *_root;
+  bool _is_valid;
+  Ops _ops;
+
+  friend class DCPackerInterface;
+};
+
+#include "dcPackerLayout.I"
+
+#endif
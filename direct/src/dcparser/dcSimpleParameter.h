@@ -133,6 +133,8 @@ private:
   double _double_modulus;
 
   static DCClassParameter *_uint32uint8_type;
+
+  friend class DCPackerLayout;
 };
 
 #endif
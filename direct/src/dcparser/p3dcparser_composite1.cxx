@@ -10,5 +10,6 @@
 #include "dcPacker.cxx"
 #include "dcPackerCatalog.cxx"
 #include "dcPackerInterface.cxx"
+#include "dcPackerLayout.cxx"
 #include "dcindent.cxx"
 
@@ -0,0 +1,419 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_dcpacker_layout.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "dcbase.h"
+#include "dcFile.h"
+#include "dcClass.h"
+#include "dcField.h"
+#include "dcPacker.h"
+#include "dcPackData.h"
+#include "dcPackerLayout.h"
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+
+using std::string;
+
+static const char *const dc_source =
+  "struct WayPoint {\n"
+  "  int16 / 10 x;\n"
+  "  int16 / 10 y;\n"
+  "  uint8(0-9) kind;\n"
+  "};\n"
+  "dclass Avatar {\n"
+  "  setXYZH(int16 / 10 x, int16 / 10 y, int16 / 10 z, int16 / 10 h) broadcast ram;\n"
+  "  setName(string name) required broadcast;\n"
+  "  setHp(int16(0-100) hp, uint32 maxHp) broadcast;\n"
+  "  setInventory(uint16(0-999) items[]) ownrecv;\n"
+  "  setWaypoints(WayPoint points[0-20]) broadcast;\n"
+  "  setFlags(uint8 flags[4], char tag[8], float64(0-1) scale) broadcast;\n"
+  "  setChat(string(0-200) text, uint64 sender, int8 emotes[]) broadcast;\n"
+  "};\n";
+
+typedef DCPackerLayout::Values Values;
+typedef DCPackerLayout::Value Value;
+
+/**
+ * Packs random values into the field at which the packer is positioned,
+ * choosing values that satisfy all of the range limits used above.
+ */
+static void
+r_pack_random(DCPacker &packer) {
+  const DCPackerInterface *field = packer.get_current_field();
+  switch (packer.get_pack_type()) {
+  case PT_int:
+  case PT_uint:
+  case PT_int64:
+  case PT_uint64:
+    packer.pack_int(rand() % 10);
+    break;
+
+  case PT_double:
+    packer.pack_double((rand() % 11) / 10.0);
+    break;
+
+  case PT_string:
+  case PT_blob:
+    {
+      size_t length = 3 + rand() % 20;
+      if (field->has_fixed_byte_size()) {
+        length = field->get_fixed_byte_size();
+      }
+      string str(length, 'a' + rand() % 26);
+      packer.pack_string(str);
+    }
+    break;
+
+  default:
+    {
+      packer.push();
+      int count = packer.get_num_nested_fields();
+      if (count < 0) {
+        count = rand() % 10;
+      }
+      for (int i = 0; i < count; ++i) {
+        r_pack_random(packer);
+      }
+      packer.pop();
+    }
+  }
+}
+
+/**
+ * Validates the field the way DCPacker did before fields had compiled
+ * layouts: by walking all the way down to each individual value.
+ */
+static void
+r_walk_validate(DCPacker &packer) {
+  DCPackType pack_type = packer.get_pack_type();
+  if (packer.has_nested_fields() && pack_type != PT_string &&
+      pack_type != PT_blob) {
+    packer.push();
+    while (packer.more_nested_fields()) {
+      r_walk_validate(packer);
+    }
+    packer.pop();
+  } else {
+    packer.unpack_validate();
+  }
+}
+
+/**
+ * Unpacks every value of the field via the DCPacker interface, and returns a
+ * checksum of the values so the work cannot be optimized away.
+ */
+static double
+r_walk_unpack(DCPacker &packer) {
+  double sum = 0.0;
+  switch (packer.get_pack_type()) {
+  case PT_int:
+    sum += packer.unpack_int();
+    break;
+  case PT_uint:
+    sum += packer.unpack_uint();
+    break;
+  case PT_int64:
+    sum += packer.unpack_int64();
+    break;
+  case PT_uint64:
+    sum += packer.unpack_uint64();
+    break;
+  case PT_double:
+    sum += packer.unpack_double();
+    break;
+  case PT_string:
+  case PT_blob:
+    sum += packer.unpack_string().size();
+    break;
+  default:
+    packer.push();
+    while (packer.more_nested_fields()) {
+      sum += r_walk_unpack(packer);
+    }
+    packer.pop();
+  }
+  return sum;
+}
+
+/**
+ * Packs a single number or string via the DCPacker interface from a value in
+ * the form produced by DCPackerLayout::unpack().
+ */
+static void
+pack_walk_value(DCPacker &packer, const Value &value) {
+  switch (value._type) {
+  case PT_int64:
+    packer.pack_int64(value._int64);
+    break;
+  case PT_uint64:
+    packer.pack_uint64(value._uint64);
+    break;
+  case PT_double:
+    packer.pack_double(value._double);
+    break;
+  default:
+    packer.pack_string(string(value._data, value._length));
+    break;
+  }
+}
+
+/**
+ * Packs the entire field, walking into any structures that are flattened in
+ * the values.
+ */
+static void
+r_walk_pack_field(DCPacker &packer, const Value *&value) {
+  DCPackType pack_type = packer.get_pack_type();
+  if (packer.has_nested_fields() && pack_type != PT_array &&
+      pack_type != PT_string && pack_type != PT_blob) {
+    packer.push();
+    while (packer.more_nested_fields()) {
+      r_walk_pack_field(packer, value);
+    }
+    packer.pop();
+  } else if (pack_type == PT_array) {
+    size_t count = value->_length;
+    ++value;
+    packer.push();
+    for (size_t i = 0; i < count; ++i) {
+      r_walk_pack_field(packer, value);
+    }
+    packer.pop();
+  } else {
+    pack_walk_value(packer, *value);
+    ++value;
+  }
+}
+
+class Record {
+public:
+  const DCField *_field;
+  string _data;
+};
+
+static double
+elapsed(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Parses a small .dc description, packs a set of random records for each of
+ * its fields, and then measures how many records per second can be
+ * validated, unpacked and packed via the DCPacker tree walk and via each
+ * field's compiled DCPackerLayout.  It also confirms that both agree on
+ * every record, including corrupted copies of them.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_records = 10000;
+  int num_passes = 20;
+  if (argc > 1) {
+    num_records = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_passes = atoi(argv[2]);
+  }
+
+  DCFile dcfile;
+  std::istringstream in(dc_source);
+  if (!dcfile.read(in, "test.dc")) {
+    std::cerr << "Unable to parse .dc source.\n";
+    return 1;
+  }
+  DCClass *dclass = dcfile.get_class_by_name("Avatar");
+  nassertr(dclass != nullptr, 1);
+
+  pvector<const DCField *> fields;
+  for (int i = 0; i < dclass->get_num_fields(); ++i) {
+    const DCField *field = dclass->get_field(i);
+    fields.push_back(field);
+    std::cout << *field << ":\n";
+    field->get_layout()->output(std::cout);
+  }
+
+  srand(1);
+  pvector<Record> records;
+  for (int i = 0; i < num_records; ++i) {
+    Record record;
+    record._field = fields[i % fields.size()];
+    DCPacker packer;
+    packer.begin_pack(record._field);
+    r_pack_random(packer);
+    if (!packer.end_pack()) {
+      std::cerr << "Could not pack " << *record._field << "\n";
+      return 1;
+    }
+    record._data = packer.get_string();
+    records.push_back(record);
+  }
+
+  // First, make sure that both paths agree on every record, and on damaged
+  // versions of them.
+  int num_mismatches = 0;
+  int num_invalid = 0;
+  for (int i = 0; i < num_records; ++i) {
+    const Record &record = records[i];
+    string data = record._data;
+    if (i % 3 == 1) {
+      data[rand() % data.size()] ^= (char)(1 << (rand() % 8));
+    } else if (i % 3 == 2) {
+      data.resize(rand() % data.size());
+    }
+
+    DCPacker packer;
+    packer.set_unpack_data(data.data(), data.size(), false);
+    packer.begin_unpack(record._field);
+    r_walk_validate(packer);
+    size_t walk_p = packer.get_num_unpacked_bytes();
+    bool walk_ok = packer.end_unpack() && walk_p == data.size();
+
+    size_t p = 0;
+    bool pack_error = false;
+    bool range_error = false;
+    record._field->get_layout()->validate(data.data(), data.size(), p,
+                                          pack_error, range_error);
+    bool layout_ok = !pack_error && !range_error && p == data.size();
+    if (walk_ok != layout_ok) {
+      ++num_mismatches;
+    }
+    if (!layout_ok) {
+      ++num_invalid;
+    }
+
+    if (i % 3 == 0) {
+      // Also make sure the layout repacks the same bytes it unpacked.
+      Values values;
+      p = 0;
+      record._field->get_layout()->unpack(data.data(), data.size(), p, values,
+                                          pack_error, range_error);
+      DCPackData pack_data;
+      size_t num_used;
+      record._field->get_layout()->pack(pack_data, &values[0], values.size(),
+                                        num_used, pack_error, range_error);
+      if (pack_error || range_error || num_used != values.size() ||
+          string(pack_data.get_data(), pack_data.get_length()) != data) {
+        std::cerr << "Repack mismatch on " << *record._field << "\n";
+        ++num_mismatches;
+      }
+    }
+  }
+  std::cout << num_invalid << " of " << num_records
+       << " records are invalid; " << num_mismatches << " mismatches.\n";
+
+  // Now measure throughput.
+  DCPacker packer;
+  Values values;
+  DCPackData pack_data;
+  double sum = 0.0;
+  size_t total_records = (size_t)num_records * num_passes;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < num_passes; ++pass) {
+    for (const Record &record : records) {
+      packer.set_unpack_data(record._data.data(), record._data.size(), false);
+      packer.begin_unpack(record._field);
+      r_walk_validate(packer);
+      sum += packer.end_unpack();
+    }
+  }
+  double walk_validate = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < num_passes; ++pass) {
+    for (const Record &record : records) {
+      size_t p = 0;
+      bool pack_error = false;
+      bool range_error = false;
+      record._field->get_layout()->validate(record._data.data(), record._data.size(),
+                                            p, pack_error, range_error);
+      sum += !pack_error;
+    }
+  }
+  double layout_validate = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < num_passes; ++pass) {
+    for (const Record &record : records) {
+      packer.set_unpack_data(record._data.data(), record._data.size(), false);
+      packer.begin_unpack(record._field);
+      sum += r_walk_unpack(packer);
+      packer.end_unpack();
+    }
+  }
+  double walk_unpack = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < num_passes; ++pass) {
+    for (const Record &record : records) {
+      size_t p = 0;
+      bool pack_error = false;
+      bool range_error = false;
+      values.clear();
+      record._field->get_layout()->unpack(record._data.data(), record._data.size(),
+                                          p, values, pack_error, range_error);
+      sum += values.size();
+    }
+  }
+  double layout_unpack = elapsed(start);
+
+  // Unpack each record once more to have the values to pack from.
+  pvector<Values> all_values(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    size_t p = 0;
+    bool pack_error = false;
+    bool range_error = false;
+    records[i]._field->get_layout()->unpack(records[i]._data.data(),
+                                            records[i]._data.size(), p,
+                                            all_values[i], pack_error,
+                                            range_error);
+  }
+
+  start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < num_passes; ++pass) {
+    for (size_t i = 0; i < records.size(); ++i) {
+      packer.clear_data();
+      packer.begin_pack(records[i]._field);
+      const Value *value = &all_values[i][0];
+      r_walk_pack_field(packer, value);
+      sum += packer.end_pack();
+    }
+  }
+  double walk_pack = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < num_passes; ++pass) {
+    for (size_t i = 0; i < records.size(); ++i) {
+      size_t num_used;
+      bool pack_error = false;
+      bool range_error = false;
+      pack_data.clear();
+      records[i]._field->get_layout()->pack(pack_data, &all_values[i][0],
+                                            all_values[i].size(), num_used,
+                                            pack_error, range_error);
+      sum += pack_data.get_length();
+    }
+  }
+  double layout_pack = elapsed(start);
+
+  std::cout << "Records per second, DCPacker walk vs. compiled layout:\n"
+       << "  validate: " << total_records / walk_validate << " vs. "
+       << total_records / layout_validate << "\n"
+       << "  unpack:   " << total_records / walk_unpack << " vs. "
+       << total_records / layout_unpack << "\n"
+       << "  pack:     " << total_records / walk_pack << " vs. "
+       << total_records / layout_pack << "\n"
+       << "(checksum " << sum << ")\n";
+
+  return (num_mismatches == 0) ? 0 : 1;
+}
@@ -31,6 +31,13 @@ ConfigVariableBool accept_clock_skew
  PRC_DESC("This controls the default value of "
           "SmoothMover::get_accept_clock_skew()."));
 
+ConfigVariableInt smooth_mover_threads
+("smooth-mover-threads", 1,
+ PRC_DESC("The default number of threads, including the calling thread, "
+          "that SmoothMoverGroup::compute_and_apply() may use to compute "
+          "the smooth positions of its movers.  Only large groups are "
+          "split across threads."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
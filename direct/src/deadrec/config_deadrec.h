@@ -17,10 +17,12 @@
 #include "directbase.h"
 #include "notifyCategoryProxy.h"
 #include "configVariableBool.h"
+#include "configVariableInt.h"
 
 NotifyCategoryDecl(deadrec, EXPCL_DIRECT_DEADREC, EXPTP_DIRECT_DEADREC);
 
 extern ConfigVariableBool accept_clock_skew;
+extern ConfigVariableInt smooth_mover_threads;
 
 extern EXPCL_DIRECT_DEADREC void init_libdeadrec();
 
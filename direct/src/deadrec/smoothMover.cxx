@@ -413,7 +413,18 @@ compute_smooth_position(double timestamp) {
             << "\n";
         }
         if (new_point._timestamp > point_b._timestamp) {
-          _points.insert(_points.begin() + point_after, new_point);
+          // The points before point_way_before are about to be popped
+          // anyway; drop them now if we need the room.
+          while (_points.full() && point_way_before > 0) {
+            _points.pop_front();
+            --point_way_before;
+            --point_before;
+            --point_after;
+            --_last_point_before;
+            --_last_point_after;
+          }
+          nassertr_always(!_points.full(), false);
+          _points.insert(point_after, new_point);
 
           // Now we've monkeyed with the sequence.  Start over.
           if (deadrec_cat.is_spam()) {
@@ -710,17 +721,15 @@ record_timestamp_delay(double timestamp) {
  */
 void SmoothMover::
 handle_wrt_reparent(NodePath &old_parent, NodePath &new_parent) {
-  Points::iterator pi;
   NodePath np = old_parent.attach_new_node("smoothMoverWrtReparent");
 
-  // cout << "handle_wrt_reparent: ";
-  for (pi = _points.begin(); pi != _points.end(); pi++) {
-    np.set_pos_hpr((*pi)._pos, (*pi)._hpr);
-    (*pi)._pos = np.get_pos(new_parent);
-    (*pi)._hpr = np.get_hpr(new_parent);
-    // cout << "(" << (*pi)._pos << "), ";
+  int num_points = _points.size();
+  for (int i = 0; i < num_points; ++i) {
+    SamplePoint &point = _points[i];
+    np.set_pos_hpr(point._pos, point._hpr);
+    point._pos = np.get_pos(new_parent);
+    point._hpr = np.get_hpr(new_parent);
   }
-  // cout << endl;
 
   np.set_pos_hpr(_sample._pos, _sample._hpr);
   _sample._pos = np.get_pos(new_parent);
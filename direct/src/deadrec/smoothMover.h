@@ -19,11 +19,15 @@
 #include "clockObject.h"
 #include "circBuffer.h"
 #include "nodePath.h"
-#include "pdeque.h"
 
 static const int max_position_reports = 10;
 static const int max_timestamp_delays = 10;
 
+// mark_position() keeps no more than max_position_reports, but
+// compute_smooth_position() inserts standing-still reports of its own on top
+// of those, a few at a time.  Leave plenty of room for them.
+static const int max_sample_points = max_position_reports * 2;
+
 
 /**
  * This class handles smoothing of sampled motion points over time, e.g.  for
@@ -178,8 +182,10 @@ private:
   bool _has_most_recent_timestamp;
   double _most_recent_timestamp;
 
-  // typedef CircBuffer<SamplePoint, max_position_reports> Points;
-  typedef pdeque<SamplePoint> Points;
+  // The position reports are kept within the SmoothMover itself, rather than
+  // on the heap, so that an array of SmoothMovers (see SmoothMoverGroup) is
+  // one contiguous block of memory.
+  typedef CircBuffer<SamplePoint, max_sample_points> Points;
   Points _points;
   int _last_point_before;
   int _last_point_after;
@@ -202,6 +208,8 @@ private:
   double _reset_velocity_age;
   bool _directional_velocity;
   bool _default_to_standing_still;
+
+  friend class SmoothMoverGroup;
 };
 
 #include "smoothMover.I"
@@ -0,0 +1,210 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file smoothMoverGroup.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "smoothMoverGroup.h"
+#include "config_deadrec.h"
+
+// Below this many movers for each thread, it isn't worth waking up the
+// worker threads.
+static const int min_movers_per_thread = 128;
+
+/**
+ *
+ */
+SmoothMoverGroup::
+SmoothMoverGroup() :
+  _num_movers(0),
+  _pool("SmoothMoverGroup"),
+  _timestamp(0.0)
+{
+  _pool.set_num_threads(std::max((int)smooth_mover_threads, 1));
+}
+
+/**
+ *
+ */
+SmoothMoverGroup::
+~SmoothMoverGroup() {
+}
+
+/**
+ * Adds a new mover to the group, whose position is to be applied to pos_node
+ * and its orientation to hpr_node.  These may be the same node.  Either one
+ * may be empty, in which case that part is not applied.  Returns the index
+ * of the new mover.
+ */
+int SmoothMoverGroup::
+add_mover(const NodePath &pos_node, const NodePath &hpr_node) {
+  int index;
+  if (!_free_slots.empty()) {
+    index = _free_slots.back();
+    _free_slots.pop_back();
+  } else {
+    index = (int)_slots.size();
+    _slots.push_back(Slot());
+    _movers.push_back(SmoothMover());
+  }
+
+  Slot &slot = _slots[index];
+  slot._pos_node = pos_node;
+  slot._hpr_node = hpr_node;
+  slot._in_use = true;
+  slot._changed = false;
+
+  // Start from a fresh mover with the group's settings.
+  SmoothMover &mover = _movers[index];
+  mover = _template;
+  mover.clear_positions(true);
+
+  ++_num_movers;
+  return index;
+}
+
+/**
+ * Removes the indicated mover from the group.  Its nodes are left where they
+ * are.
+ */
+void SmoothMoverGroup::
+remove_mover(int index) {
+  nassertv(has_mover(index));
+
+  Slot &slot = _slots[index];
+  slot._pos_node.clear();
+  slot._hpr_node.clear();
+  slot._in_use = false;
+  _free_slots.push_back(index);
+  --_num_movers;
+}
+
+/**
+ * Copies the smoothing settings (the smooth mode, prediction mode, delay and
+ * so on) of the indicated SmoothMover to every mover in the group, and to
+ * any movers added later.
+ */
+void SmoothMoverGroup::
+set_template(const SmoothMover &settings) {
+  _template = settings;
+  _template.clear_positions(true);
+
+  for (SmoothMover &mover : _movers) {
+    mover._smooth_mode = settings._smooth_mode;
+    mover._prediction_mode = settings._prediction_mode;
+    mover._delay = settings._delay;
+    mover._accept_clock_skew = settings._accept_clock_skew;
+    mover._max_position_age = settings._max_position_age;
+    mover._expected_broadcast_period = settings._expected_broadcast_period;
+    mover._reset_velocity_age = settings._reset_velocity_age;
+    mover._directional_velocity = settings._directional_velocity;
+    mover._default_to_standing_still = settings._default_to_standing_still;
+  }
+}
+
+/**
+ * Specifies the number of threads, including the calling thread, that
+ * compute_and_apply() may use to compute the smooth positions.  The default
+ * is given by smooth-mover-threads.  This has no effect without true thread
+ * support.
+ */
+void SmoothMoverGroup::
+set_num_threads(int num_threads) {
+  _pool.set_num_threads(std::max(num_threads, 1));
+}
+
+/**
+ * Records a new position report for the indicated mover.  This is
+ * equivalent to calling set_pos_hpr(), set_timestamp() and mark_position()
+ * on the SmoothMover.
+ */
+void SmoothMoverGroup::
+mark_position(int index, const LVecBase3 &pos, const LVecBase3 &hpr,
+              double timestamp) {
+  nassertv(has_mover(index));
+
+  SmoothMover &mover = _movers[index];
+  mover.set_pos_hpr(pos, hpr);
+  mover.set_timestamp(timestamp);
+  mover.mark_position();
+}
+
+/**
+ * Erases the position reports of the indicated mover.  See
+ * SmoothMover::clear_positions().
+ */
+void SmoothMoverGroup::
+clear_positions(int index, bool reset_velocity) {
+  nassertv(has_mover(index));
+  _movers[index].clear_positions(reset_velocity);
+}
+
+/**
+ * Computes the smooth position of every mover as of the indicated time, and
+ * applies it to its nodes.  Returns the number of movers whose position
+ * changed.
+ */
+int SmoothMoverGroup::
+compute_and_apply(double timestamp) {
+  int num_slots = (int)_slots.size();
+  _timestamp = timestamp;
+  _pool.run(num_slots, min_movers_per_thread, &compute_range_func, this);
+
+  // Scene graph changes are made only from this thread.
+  int num_changed = 0;
+  for (int i = 0; i < num_slots; ++i) {
+    Slot &slot = _slots[i];
+    if (!slot._changed) {
+      continue;
+    }
+    slot._changed = false;
+    ++num_changed;
+
+    const SmoothMover &mover = _movers[i];
+    if (slot._pos_node == slot._hpr_node) {
+      if (!slot._pos_node.is_empty()) {
+        slot._pos_node.set_pos_hpr(mover.get_smooth_pos(), mover.get_smooth_hpr());
+      }
+    } else {
+      if (!slot._pos_node.is_empty()) {
+        slot._pos_node.set_pos(mover.get_smooth_pos());
+      }
+      if (!slot._hpr_node.is_empty()) {
+        slot._hpr_node.set_hpr(mover.get_smooth_hpr());
+      }
+    }
+  }
+
+  return num_changed;
+}
+
+/**
+ * Computes the smooth positions of the movers in the indicated range of
+ * slots.  This may be called on several threads at once, for different
+ * ranges.
+ */
+void SmoothMoverGroup::
+compute_range(size_t begin, size_t end, double timestamp) {
+  for (size_t i = begin; i < end; ++i) {
+    Slot &slot = _slots[i];
+    if (slot._in_use) {
+      slot._changed = _movers[i].compute_smooth_position(timestamp);
+    }
+  }
+}
+
+/**
+ * The function run by the WorkerThreadPool for each range of slots.
+ */
+void SmoothMoverGroup::
+compute_range_func(void *data, int thread_index, size_t begin, size_t end) {
+  SmoothMoverGroup *group = (SmoothMoverGroup *)data;
+  group->compute_range(begin, end, group->_timestamp);
+}
@@ -0,0 +1,105 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file smoothMoverGroup.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef SMOOTHMOVERGROUP_H
+#define SMOOTHMOVERGROUP_H
+
+#include "directbase.h"
+#include "smoothMover.h"
+#include "nodePath.h"
+#include "pvector.h"
+#include "workerThreadPool.h"
+
+/**
+ * This class manages a whole set of SmoothMovers at once, for instance, one
+ * for each remote avatar in view.  Rather than calling
+ * compute_and_apply_smooth_pos_hpr() on each one from Python, the
+ * application reports positions to the group as they arrive, and calls
+ * compute_and_apply() once per frame to update all of the nodes.
+ *
+ * The SmoothMovers, including their position reports, are stored in one
+ * contiguous array.  The smoothing computation may be split across several
+ * threads (see set_num_threads()); the results are always applied to the
+ * nodes on the calling thread.
+ *
+ * Each mover is identified by the index returned by add_mover(), which stays
+ * the same until it is removed.  The index of a removed mover may be reused
+ * by a later call to add_mover().
+ *
+ * All of the movers share the smoothing settings of a template SmoothMover,
+ * set via set_template().
+ */
+class EXPCL_DIRECT_DEADREC SmoothMoverGroup {
+PUBLISHED:
+  SmoothMoverGroup();
+  ~SmoothMoverGroup();
+
+  int add_mover(const NodePath &pos_node, const NodePath &hpr_node);
+  INLINE int add_mover(const NodePath &node);
+  void remove_mover(int index);
+  INLINE bool has_mover(int index) const;
+  INLINE int get_num_movers() const;
+
+  void set_template(const SmoothMover &settings);
+  INLINE const SmoothMover &get_template() const;
+
+  void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+
+  void mark_position(int index, const LVecBase3 &pos, const LVecBase3 &hpr,
+                     double timestamp);
+  void clear_positions(int index, bool reset_velocity);
+
+  INLINE int compute_and_apply();
+  int compute_and_apply(double timestamp);
+
+  INLINE const LPoint3 &get_smooth_pos(int index) const;
+  INLINE const LVecBase3 &get_smooth_hpr(int index) const;
+  INLINE PN_stdfloat get_smooth_forward_velocity(int index) const;
+  INLINE PN_stdfloat get_smooth_lateral_velocity(int index) const;
+  INLINE PN_stdfloat get_smooth_rotational_velocity(int index) const;
+
+public:
+  INLINE SmoothMover &modify_mover(int index);
+
+private:
+  void compute_range(size_t begin, size_t end, double timestamp);
+  static void compute_range_func(void *data, int thread_index,
+                                 size_t begin, size_t end);
+
+  class Slot {
+  public:
+    NodePath _pos_node;
+    NodePath _hpr_node;
+    bool _in_use;
+    bool _changed;
+  };
+  typedef pvector<Slot> Slots;
+  typedef pvector<SmoothMover> Movers;
+
+  // These two arrays are parallel.
+  Movers _movers;
+  Slots _slots;
+  pvector<int> _free_slots;
+  int _num_movers;
+
+  SmoothMover _template;
+
+  // The threads that share the computation, and the time they compute for.
+  WorkerThreadPool _pool;
+  double _timestamp;
+};
+
+#include "smoothMoverGroup.I"
+
+#endif
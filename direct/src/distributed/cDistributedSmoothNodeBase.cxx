@@ -62,6 +62,23 @@ initialize(const NodePath &node_path, DCClass *dclass, CHANNEL_TYPE do_id) {
   _store_xyz = _node_path.get_pos();
   _store_hpr = _node_path.get_hpr();
   _store_stop = false;
+
+  update_interest_grid(F_new_x | F_new_y);
+}
+
+/**
+ * Specifies a CInterestGrid that should track the position of this object.
+ * The object is placed on the grid right away, and moved whenever one of the
+ * broadcast_pos_hpr_*() methods sends a new position.  The object must be
+ * removed from the grid explicitly when it is deleted.  Pass NULL to stop
+ * tracking.
+ */
+void CDistributedSmoothNodeBase::
+set_interest_grid(CInterestGrid *grid) {
+  _interest_grid = grid;
+  if (_interest_grid != nullptr) {
+    _interest_grid->set_object_pos((DOID_TYPE)_do_id, _store_xyz);
+  }
 }
 
 /**
@@ -115,6 +132,8 @@ broadcast_pos_hpr_full() {
     flags |= F_new_r;
   }
 
+  update_interest_grid(flags);
+
   if (_currL[0] != _currL[1]) {
     // location (zoneId) has changed, send out all info copy over 'set'
     // location over to 'sent' location
@@ -205,6 +224,8 @@ broadcast_pos_hpr_xyh() {
     flags |= F_new_h;
   }
 
+  update_interest_grid(flags);
+
   if (flags == 0) {
     // No change.  Send one and only one "stop" message.
     if (!_store_stop) {
@@ -249,6 +270,8 @@ broadcast_pos_hpr_xy() {
     flags |= F_new_y;
   }
 
+  update_interest_grid(flags);
+
   if (flags == 0) {
     // No change.  Send one and only one "stop" message.
     if (!_store_stop) {
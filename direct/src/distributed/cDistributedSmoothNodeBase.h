@@ -20,6 +20,7 @@
 #include "dcPacker.h"
 #include "dcPython.h"  // to pick up Python.h
 #include "clockObject.h"
+#include "cInterestGrid.h"
 
 class DCClass;
 class CConnectionRepository;
@@ -45,6 +46,9 @@ PUBLISHED:
   void initialize(const NodePath &node_path, DCClass *dclass,
                   CHANNEL_TYPE do_id);
 
+  void set_interest_grid(CInterestGrid *grid);
+  INLINE CInterestGrid *get_interest_grid() const;
+
   void send_everything();
 
   void broadcast_pos_hpr_full();
@@ -56,6 +60,7 @@ PUBLISHED:
 
 private:
   INLINE static bool only_changed(int flags, int compare);
+  INLINE void update_interest_grid(int flags);
 
   INLINE void d_setSmStop();
   INLINE void d_setSmH(PN_stdfloat h);
@@ -98,6 +103,8 @@ private:
   // contains most recently sent location info as index 0, index 1 contains
   // most recently set location info
   uint64_t _currL[2];
+
+  PT(CInterestGrid) _interest_grid;
 };
 
 #include "cDistributedSmoothNodeBase.I"
@@ -0,0 +1,364 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cInterestGrid.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "cInterestGrid.h"
+#include "cmath.h"
+
+#include <algorithm>
+
+/**
+ * Creates a grid of grid_size by grid_size cells, each cell_width units
+ * wide, centered on the origin.
+ */
+CInterestGrid::
+CInterestGrid(PN_stdfloat cell_width, int grid_size,
+              ZONEID_TYPE starting_zone) :
+  _cell_width(cell_width),
+  _grid_size(std::max(grid_size, 1)),
+  _starting_zone(starting_zone)
+{
+  nassertv(cell_width > 0);
+  _cells.resize((size_t)_grid_size * _grid_size);
+}
+
+/**
+ *
+ */
+CInterestGrid::
+~CInterestGrid() {
+}
+
+/**
+ * Returns the zone number of the cell containing the indicated position, in
+ * the same way as CartesianGridBase.getZoneFromXYZ().
+ */
+ZONEID_TYPE CInterestGrid::
+get_zone_from_xyz(const LPoint3 &pos) const {
+  return _starting_zone + get_row(pos[1]) * _grid_size + get_col(pos[0]);
+}
+
+/**
+ * Adds the indicated object to the grid at the indicated position, or moves
+ * it there if it is already on the grid.
+ */
+void CInterestGrid::
+set_object_pos(DOID_TYPE do_id, const LPoint3 &pos) {
+  int col = get_col(pos[0]);
+  int row = get_row(pos[1]);
+  int cell = row * _grid_size + col;
+
+  std::pair<Objects::iterator, bool> result =
+    _objects.insert(Objects::value_type(do_id, ObjectInfo()));
+  ObjectInfo &object = (*result.first).second;
+
+  if (result.second) {
+    // A new object; everyone watching its cell sees it appear.
+    object._do_id = do_id;
+    add_to_cell(object, cell);
+
+    for (ClientInfo *client : _cells[cell]._watchers) {
+      record_change(*client, do_id, 1);
+    }
+    return;
+  }
+
+  if (object._cell == cell) {
+    return;
+  }
+
+  int old_col = object._cell % _grid_size;
+  int old_row = object._cell / _grid_size;
+
+  // The clients that could see the old cell but not the new one lose sight
+  // of the object, and vice versa.
+  for (ClientInfo *client : _cells[object._cell]._watchers) {
+    if (!client->_view.contains(col, row)) {
+      record_change(*client, do_id, -1);
+    }
+  }
+  for (ClientInfo *client : _cells[cell]._watchers) {
+    if (!client->_view.contains(old_col, old_row)) {
+      record_change(*client, do_id, 1);
+    }
+  }
+
+  remove_from_cell(object);
+  add_to_cell(object, cell);
+}
+
+/**
+ * Removes the indicated object from the grid.  Any clients that could see it
+ * will report it as having left their view.
+ */
+void CInterestGrid::
+remove_object(DOID_TYPE do_id) {
+  Objects::iterator oi = _objects.find(do_id);
+  if (oi == _objects.end()) {
+    return;
+  }
+
+  ObjectInfo &object = (*oi).second;
+  for (ClientInfo *client : _cells[object._cell]._watchers) {
+    record_change(*client, do_id, -1);
+  }
+
+  remove_from_cell(object);
+  _objects.erase(oi);
+}
+
+/**
+ * Returns true if the indicated object is on the grid.
+ */
+bool CInterestGrid::
+has_object(DOID_TYPE do_id) const {
+  return _objects.find(do_id) != _objects.end();
+}
+
+/**
+ * Adds the indicated client to the grid, or changes its position and radius
+ * if it is already on the grid.  The client will see all objects within
+ * radius cells of its own cell in each direction; a radius of 0 sees only
+ * its own cell.
+ */
+void CInterestGrid::
+set_client(CHANNEL_TYPE client_id, const LPoint3 &pos, int radius) {
+  nassertv(radius >= 0);
+
+  std::pair<Clients::iterator, bool> result =
+    _clients.insert(Clients::value_type(client_id, ClientInfo()));
+  ClientInfo &client = (*result.first).second;
+
+  if (result.second) {
+    client._client_id = client_id;
+    client._view = make_view(0, 0, -1);
+    client._dirty = false;
+  }
+
+  client._col = get_col(pos[0]);
+  client._row = get_row(pos[1]);
+  client._radius = radius;
+  set_view(client, make_view(client._col, client._row, radius));
+}
+
+/**
+ * Moves a client that has already been added with set_client().
+ */
+void CInterestGrid::
+set_client_pos(CHANNEL_TYPE client_id, const LPoint3 &pos) {
+  Clients::iterator ci = _clients.find(client_id);
+  nassertv(ci != _clients.end());
+
+  ClientInfo &client = (*ci).second;
+  int col = get_col(pos[0]);
+  int row = get_row(pos[1]);
+  if (col != client._col || row != client._row) {
+    client._col = col;
+    client._row = row;
+    set_view(client, make_view(col, row, client._radius));
+  }
+}
+
+/**
+ * Removes the indicated client from the grid.  Any changes to its view that
+ * have not yet been collected by update() are discarded.
+ */
+void CInterestGrid::
+remove_client(CHANNEL_TYPE client_id) {
+  Clients::iterator ci = _clients.find(client_id);
+  if (ci == _clients.end()) {
+    return;
+  }
+
+  ClientInfo &client = (*ci).second;
+  set_view(client, make_view(0, 0, -1));
+
+  if (client._dirty) {
+    Watchers::iterator di =
+      std::find(_dirty_clients.begin(), _dirty_clients.end(), &client);
+    nassertv(di != _dirty_clients.end());
+    _dirty_clients.erase(di);
+  }
+
+  _clients.erase(ci);
+}
+
+/**
+ * Returns true if the indicated client is on the grid.
+ */
+bool CInterestGrid::
+has_client(CHANNEL_TYPE client_id) const {
+  return _clients.find(client_id) != _clients.end();
+}
+
+/**
+ * Returns true if the indicated object is currently within view of the
+ * indicated client, whether or not this has been reported by update() yet.
+ */
+bool CInterestGrid::
+is_visible(CHANNEL_TYPE client_id, DOID_TYPE do_id) const {
+  Clients::const_iterator ci = _clients.find(client_id);
+  Objects::const_iterator oi = _objects.find(do_id);
+  if (ci == _clients.end() || oi == _objects.end()) {
+    return false;
+  }
+
+  int cell = (*oi).second._cell;
+  return (*ci).second._view.contains(cell % _grid_size, cell / _grid_size);
+}
+
+/**
+ * Collects the changes in each client's view since the previous call to
+ * update(), and makes them available through get_changed_client() and
+ * related methods.  This should be called once per tick, after all of the
+ * objects and clients have been moved.
+ *
+ * An object that entered and then left a client's view again between
+ * updates (or vice versa) is not reported at all.
+ */
+void CInterestGrid::
+update() {
+  _deltas.clear();
+
+  for (ClientInfo *client : _dirty_clients) {
+    Changes &changes = client->_changes;
+    std::sort(changes.begin(), changes.end());
+
+    Delta delta;
+    delta._client_id = client->_client_id;
+
+    Changes::const_iterator ci = changes.begin();
+    while (ci != changes.end()) {
+      DOID_TYPE do_id = (*ci)._do_id;
+      int net = 0;
+      for (; ci != changes.end() && (*ci)._do_id == do_id; ++ci) {
+        net += (*ci)._delta;
+      }
+
+      // Enter and leave events for the same object always alternate, so the
+      // net change can only be one of these.
+      nassertd(net >= -1 && net <= 1) continue;
+      if (net > 0) {
+        delta._entered.push_back(do_id);
+      } else if (net < 0) {
+        delta._left.push_back(do_id);
+      }
+    }
+
+    changes.clear();
+    client->_dirty = false;
+
+    if (!delta._entered.empty() || !delta._left.empty()) {
+      _deltas.push_back(std::move(delta));
+    }
+  }
+
+  _dirty_clients.clear();
+}
+
+/**
+ *
+ */
+void CInterestGrid::
+output(std::ostream &out) const {
+  out << "CInterestGrid(" << _grid_size << "x" << _grid_size
+      << ", " << _objects.size() << " objects, " << _clients.size()
+      << " clients)";
+}
+
+/**
+ * Returns the view of a client in the indicated cell with the indicated
+ * radius, clipped to the grid.  A negative radius returns an empty view.
+ */
+CInterestGrid::View CInterestGrid::
+make_view(int col, int row, int radius) const {
+  View view;
+  if (radius < 0) {
+    view._min_col = view._min_row = 0;
+    view._max_col = view._max_row = -1;
+  } else {
+    view._min_col = std::max(col - radius, 0);
+    view._max_col = std::min(col + radius, _grid_size - 1);
+    view._min_row = std::max(row - radius, 0);
+    view._max_row = std::min(row + radius, _grid_size - 1);
+  }
+  return view;
+}
+
+/**
+ * Changes the client's view to the indicated view.  The client stops
+ * watching the cells that are only in its old view, losing sight of their
+ * objects, and starts watching those that are only in its new view.
+ */
+void CInterestGrid::
+set_view(ClientInfo &client, const View &view) {
+  const View old_view = client._view;
+
+  for (int row = old_view._min_row; row <= old_view._max_row; ++row) {
+    for (int col = old_view._min_col; col <= old_view._max_col; ++col) {
+      if (view.contains(col, row)) {
+        continue;
+      }
+      Cell &cell = _cells[row * _grid_size + col];
+      Watchers::iterator wi =
+        std::find(cell._watchers.begin(), cell._watchers.end(), &client);
+      nassertd(wi != cell._watchers.end()) continue;
+      *wi = cell._watchers.back();
+      cell._watchers.pop_back();
+
+      for (ObjectInfo *object : cell._objects) {
+        record_change(client, object->_do_id, -1);
+      }
+    }
+  }
+
+  for (int row = view._min_row; row <= view._max_row; ++row) {
+    for (int col = view._min_col; col <= view._max_col; ++col) {
+      if (old_view.contains(col, row)) {
+        continue;
+      }
+      Cell &cell = _cells[row * _grid_size + col];
+      cell._watchers.push_back(&client);
+
+      for (ObjectInfo *object : cell._objects) {
+        record_change(client, object->_do_id, 1);
+      }
+    }
+  }
+
+  client._view = view;
+}
+
+/**
+ * Adds the object to the list of objects in the indicated cell.
+ */
+void CInterestGrid::
+add_to_cell(ObjectInfo &object, int cell) {
+  CellObjects &objects = _cells[cell]._objects;
+  object._cell = cell;
+  object._index = objects.size();
+  objects.push_back(&object);
+}
+
+/**
+ * Removes the object from the list of objects in its cell.
+ */
+void CInterestGrid::
+remove_from_cell(ObjectInfo &object) {
+  CellObjects &objects = _cells[object._cell]._objects;
+  nassertv(object._index < objects.size() && objects[object._index] == &object);
+
+  ObjectInfo *last = objects.back();
+  objects[object._index] = last;
+  last->_index = object._index;
+  objects.pop_back();
+}
@@ -0,0 +1,174 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cInterestGrid.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef CINTERESTGRID_H
+#define CINTERESTGRID_H
+
+#include "directbase.h"
+#include "dcbase.h"
+#include "referenceCount.h"
+#include "luse.h"
+#include "pvector.h"
+#include "pmap.h"
+
+/**
+ * This class computes which distributed objects each client should be able
+ * to see, based on their positions on a uniform grid of square cells.  It
+ * uses the same layout of cells as CartesianGridBase.py: grid_size cells on
+ * each side, cell_width units wide, centered on the origin, and numbered by
+ * zone starting from starting_zone.
+ *
+ * Each client sees the objects in the cells within its radius (counted in
+ * cells) of the cell it occupies.  As objects and clients are moved, the
+ * changes in what each client can see are accumulated incrementally; once
+ * per tick, update() collects them into a list of the objects that have
+ * entered and left each client's view since the previous update().  Only the
+ * clients whose view has actually changed are reported.
+ *
+ * Object positions may be supplied directly with set_object_pos(), or by a
+ * CDistributedSmoothNodeBase that has been given this grid with
+ * set_interest_grid(), which reports its position whenever it broadcasts it.
+ *
+ * Positions outside the grid are treated as though they were in the nearest
+ * cell along the edge of the grid.
+ */
+class EXPCL_DIRECT_DISTRIBUTED CInterestGrid : public ReferenceCount {
+PUBLISHED:
+  explicit CInterestGrid(PN_stdfloat cell_width, int grid_size,
+                         ZONEID_TYPE starting_zone = 0);
+  ~CInterestGrid();
+
+  INLINE PN_stdfloat get_cell_width() const;
+  INLINE int get_grid_size() const;
+  INLINE ZONEID_TYPE get_starting_zone() const;
+  ZONEID_TYPE get_zone_from_xyz(const LPoint3 &pos) const;
+
+  void set_object_pos(DOID_TYPE do_id, const LPoint3 &pos);
+  void remove_object(DOID_TYPE do_id);
+  bool has_object(DOID_TYPE do_id) const;
+  INLINE size_t get_num_objects() const;
+
+  void set_client(CHANNEL_TYPE client_id, const LPoint3 &pos, int radius);
+  void set_client_pos(CHANNEL_TYPE client_id, const LPoint3 &pos);
+  void remove_client(CHANNEL_TYPE client_id);
+  bool has_client(CHANNEL_TYPE client_id) const;
+  INLINE size_t get_num_clients() const;
+
+  bool is_visible(CHANNEL_TYPE client_id, DOID_TYPE do_id) const;
+
+  void update();
+  INLINE size_t get_num_changed_clients() const;
+  INLINE CHANNEL_TYPE get_changed_client(size_t n) const;
+  MAKE_SEQ(get_changed_clients, get_num_changed_clients, get_changed_client);
+  INLINE size_t get_num_entered(size_t n) const;
+  INLINE DOID_TYPE get_entered(size_t n, size_t i) const;
+  INLINE size_t get_num_left(size_t n) const;
+  INLINE DOID_TYPE get_left(size_t n, size_t i) const;
+
+  void output(std::ostream &out) const;
+
+private:
+  class ClientInfo;
+  class ObjectInfo;
+  typedef pvector<ObjectInfo *> CellObjects;
+  typedef pvector<ClientInfo *> Watchers;
+
+  // A single cell of the grid, listing the objects within it and the
+  // clients whose view includes it.
+  class Cell {
+  public:
+    CellObjects _objects;
+    Watchers _watchers;
+  };
+  typedef pvector<Cell> Cells;
+
+  class ObjectInfo {
+  public:
+    DOID_TYPE _do_id;
+    int _cell;
+    // The index of this object within _cells[_cell]._objects.
+    size_t _index;
+  };
+  typedef pmap<DOID_TYPE, ObjectInfo> Objects;
+
+  // One entry for each time an object entered (+1) or left (-1) a client's
+  // view since the last update().
+  class Change {
+  public:
+    INLINE bool operator < (const Change &other) const;
+
+    DOID_TYPE _do_id;
+    int _delta;
+  };
+  typedef pvector<Change> Changes;
+
+  // The rectangle of cells a client can see.  An empty view has _min_col >
+  // _max_col.
+  class View {
+  public:
+    INLINE bool contains(int col, int row) const;
+
+    int _min_col, _max_col;
+    int _min_row, _max_row;
+  };
+
+  class ClientInfo {
+  public:
+    CHANNEL_TYPE _client_id;
+    int _col, _row;
+    int _radius;
+    View _view;
+    Changes _changes;
+    bool _dirty;
+  };
+  typedef pmap<CHANNEL_TYPE, ClientInfo> Clients;
+
+  // The net result of update() for one client.
+  class Delta {
+  public:
+    CHANNEL_TYPE _client_id;
+    pvector<DOID_TYPE> _entered;
+    pvector<DOID_TYPE> _left;
+  };
+  typedef pvector<Delta> Deltas;
+
+  INLINE int get_col(PN_stdfloat x) const;
+  INLINE int get_row(PN_stdfloat y) const;
+  View make_view(int col, int row, int radius) const;
+  void set_view(ClientInfo &client, const View &view);
+  void add_to_cell(ObjectInfo &object, int cell);
+  void remove_from_cell(ObjectInfo &object);
+  INLINE void record_change(ClientInfo &client, DOID_TYPE do_id, int delta);
+
+  PN_stdfloat _cell_width;
+  int _grid_size;
+  ZONEID_TYPE _starting_zone;
+
+  Cells _cells;
+  Objects _objects;
+  Clients _clients;
+
+  // The clients that have a nonempty _changes list.
+  Watchers _dirty_clients;
+
+  Deltas _deltas;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const CInterestGrid &grid) {
+  grid.output(out);
+  return out;
+}
+
+#include "cInterestGrid.I"
+
+#endif  // CINTERESTGRID_H
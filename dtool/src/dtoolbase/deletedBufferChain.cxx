@@ -14,6 +14,29 @@
 #include "deletedBufferChain.h"
 #include "memoryHook.h"
 
+DeletedBufferChain *DeletedBufferChain::_chains[DeletedBufferChain::max_cached_chains];
+TVOLATILE AtomicAdjust::Integer DeletedBufferChain::_num_chains = 0;
+bool DeletedBufferChain::_thread_cache = true;
+
+#ifdef DELETED_CHAIN_THREAD_CACHE
+// 0 before the thread has used its cache, 1 while it is in use, and 2 once
+// the thread is exiting and the cache has been flushed for good.
+static thread_local unsigned char thread_cache_state = 0;
+
+/**
+ * An instance of this class is created the first time each thread uses its
+ * cache, so that the cached buffers are returned to the shared chains when
+ * the thread exits.
+ */
+class ThreadCacheFlusher {
+public:
+  ~ThreadCacheFlusher() {
+    DeletedBufferChain::flush_thread_cache();
+    thread_cache_state = 2;
+  }
+};
+#endif  // DELETED_CHAIN_THREAD_CACHE
+
 /**
  * Use the global MemoryHook to get a new DeletedBufferChain of the
  * appropriate size.
@@ -25,6 +48,23 @@ DeletedBufferChain(size_t buffer_size) {
 
   // We must allocate at least this much space for bookkeeping reasons.
   _buffer_size = std::max(_buffer_size, sizeof(ObjectNode));
+
+  // Move about 2K worth of buffers between a thread cache and the shared
+  // chain at a time, within reason.
+  _batch_size = std::min(std::max(2048 / _buffer_size, (size_t)4), (size_t)32);
+
+  _num_free = 0;
+  _num_allocated = 0;
+  _num_refills = 0;
+  _num_flushes = 0;
+
+  // MemoryHook holds its lock while it constructs us, so we don't need to
+  // protect _chains ourselves.
+  _index = (size_t)AtomicAdjust::get(_num_chains);
+  if (_index < max_cached_chains) {
+    _chains[_index] = this;
+    AtomicAdjust::set(_num_chains, (AtomicAdjust::Integer)(_index + 1));
+  }
 }
 
 /**
@@ -44,12 +84,17 @@ allocate(size_t size, TypeHandle type_handle) {
 
   ObjectNode *obj;
 
-  _lock.lock();
-  if (_deleted_chain != nullptr) {
-    obj = _deleted_chain;
-    _deleted_chain = _deleted_chain->_next;
-    _lock.unlock();
+  Magazine *mag = get_magazine();
+  if (mag != nullptr && mag->_head != nullptr) {
+    // The fast path: take a buffer from this thread's cache.
+    obj = mag->_head;
+    mag->_head = obj->_next;
+    --mag->_count;
+  } else {
+    obj = take_shared(mag);
+  }
 
+  if (obj != nullptr) {
 #ifdef USE_DELETEDCHAINFLAG
     assert(obj->_flag == (AtomicAdjust::Integer)DCF_deleted);
     obj->_flag = DCF_alive;
@@ -65,7 +110,6 @@ allocate(size_t size, TypeHandle type_handle) {
 
     return ptr;
   }
-  _lock.unlock();
 
   // If we get here, the deleted_chain is empty; we have to allocate a new
   // object from the system pool.
@@ -127,10 +171,24 @@ deallocate(void *ptr, TypeHandle type_handle) {
   assert(orig_flag == (AtomicAdjust::Integer)DCF_alive);
 #endif  // USE_DELETEDCHAINFLAG
 
+  Magazine *mag = get_magazine();
+  if (mag != nullptr) {
+    // The fast path: keep the buffer in this thread's cache, returning a
+    // batch to the shared chain if the cache has grown too large.
+    obj->_next = mag->_head;
+    mag->_head = obj;
+    if (++mag->_count > _batch_size * 2) {
+      flush_magazine(mag, _batch_size);
+    }
+    return;
+  }
+
   _lock.lock();
 
   obj->_next = _deleted_chain;
   _deleted_chain = obj;
+  ++_num_free;
+  ++_num_flushes;
 
   _lock.unlock();
 
@@ -138,3 +196,210 @@ deallocate(void *ptr, TypeHandle type_handle) {
   PANDA_FREE_SINGLE(ptr);
 #endif  // USE_DELETED_CHAIN
 }
+
+/**
+ * Returns the number of free buffers currently waiting on the shared chain.
+ * This does not include buffers held in the threads' private caches.
+ */
+size_t DeletedBufferChain::
+get_num_free() const {
+  _lock.lock();
+  size_t result = _num_free;
+  _lock.unlock();
+  return result;
+}
+
+/**
+ * Returns the total number of buffers this chain has ever had to allocate
+ * from the system, which is the most that have ever been in use at once.
+ */
+size_t DeletedBufferChain::
+get_num_allocated() const {
+  _lock.lock();
+  size_t result = _num_allocated;
+  _lock.unlock();
+  return result;
+}
+
+/**
+ * Returns the number of times a thread has locked the shared chain to take
+ * buffers from it.  Without a thread cache, this is once per allocation.
+ */
+size_t DeletedBufferChain::
+get_num_refills() const {
+  _lock.lock();
+  size_t result = _num_refills;
+  _lock.unlock();
+  return result;
+}
+
+/**
+ * Returns the number of times a thread has locked the shared chain to return
+ * buffers to it.  Without a thread cache, this is once per deallocation.
+ */
+size_t DeletedBufferChain::
+get_num_flushes() const {
+  _lock.lock();
+  size_t result = _num_flushes;
+  _lock.unlock();
+  return result;
+}
+
+/**
+ * Returns the number of DeletedBufferChains that may be retrieved with
+ * get_chain(), for reporting statistics.
+ */
+size_t DeletedBufferChain::
+get_num_chains() {
+  return (size_t)AtomicAdjust::get(_num_chains);
+}
+
+/**
+ * Returns the nth DeletedBufferChain that has been created.
+ */
+DeletedBufferChain *DeletedBufferChain::
+get_chain(size_t n) {
+  assert(n < get_num_chains());
+  return _chains[n];
+}
+
+/**
+ * Returns all of the buffers held in the current thread's private caches to
+ * the shared chains.  This is called automatically when a thread exits; it
+ * may also be called explicitly by a thread that is about to go idle for a
+ * long time.
+ */
+void DeletedBufferChain::
+flush_thread_cache() {
+#ifdef DELETED_CHAIN_THREAD_CACHE
+  if (thread_cache_state != 1) {
+    return;
+  }
+  Magazine *mags = get_thread_magazines();
+  size_t num_chains = get_num_chains();
+  for (size_t i = 0; i < num_chains; ++i) {
+    if (mags[i]._count != 0) {
+      _chains[i]->flush_magazine(&mags[i], 0);
+    }
+  }
+#endif  // DELETED_CHAIN_THREAD_CACHE
+}
+
+/**
+ * Returns the current thread's cache for this chain, or NULL if the cache
+ * should not be used.
+ */
+DeletedBufferChain::Magazine *DeletedBufferChain::
+get_magazine() {
+#ifdef DELETED_CHAIN_THREAD_CACHE
+  if (_index >= max_cached_chains || !_thread_cache) {
+    return nullptr;
+  }
+  if (thread_cache_state != 1) {
+    if (thread_cache_state != 0) {
+      // The thread is exiting.
+      return nullptr;
+    }
+    static thread_local ThreadCacheFlusher flusher;
+    (void)flusher;
+    thread_cache_state = 1;
+  }
+  return &get_thread_magazines()[_index];
+#else
+  return nullptr;
+#endif  // DELETED_CHAIN_THREAD_CACHE
+}
+
+/**
+ * Returns the array of the current thread's caches, one for each chain.
+ */
+DeletedBufferChain::Magazine *DeletedBufferChain::
+get_thread_magazines() {
+#ifdef DELETED_CHAIN_THREAD_CACHE
+  // This is trivially constructed and destructed, so it remains valid even
+  // while the thread's other thread_local objects are being destroyed.
+  static thread_local Magazine magazines[max_cached_chains];
+  return magazines;
+#else
+  return nullptr;
+#endif  // DELETED_CHAIN_THREAD_CACHE
+}
+
+/**
+ * Takes a buffer from the shared chain, and if mag is not NULL, up to a
+ * batch more to put in that cache.  Returns NULL if the shared chain is
+ * empty.
+ */
+DeletedBufferChain::ObjectNode *DeletedBufferChain::
+take_shared(Magazine *mag) {
+  _lock.lock();
+  ++_num_refills;
+
+  ObjectNode *obj = _deleted_chain;
+  if (obj == nullptr) {
+    // The caller will allocate a new buffer.
+    ++_num_allocated;
+    _lock.unlock();
+    return nullptr;
+  }
+
+  ObjectNode *last = obj;
+  size_t count = 1;
+  if (mag != nullptr) {
+    while (count < _batch_size && last->_next != nullptr) {
+      last = last->_next;
+      ++count;
+    }
+  }
+  _deleted_chain = last->_next;
+  _num_free -= count;
+  _lock.unlock();
+
+  if (count > 1) {
+    // Everything after the first one goes into the cache, which is empty.
+    mag->_head = obj->_next;
+    mag->_count = count - 1;
+    last->_next = nullptr;
+  }
+  return obj;
+}
+
+/**
+ * Returns all but the first keep buffers in the indicated cache to the shared
+ * chain.
+ */
+void DeletedBufferChain::
+flush_magazine(Magazine *mag, size_t keep) {
+  if (mag->_count <= keep) {
+    return;
+  }
+
+  // Find the part of the list to give back.  We keep the front of the list,
+  // which holds the buffers that were freed most recently.
+  ObjectNode *first;
+  if (keep == 0) {
+    first = mag->_head;
+    mag->_head = nullptr;
+  } else {
+    ObjectNode *split = mag->_head;
+    for (size_t i = 1; i < keep; ++i) {
+      split = split->_next;
+    }
+    first = split->_next;
+    split->_next = nullptr;
+  }
+
+  ObjectNode *last = first;
+  while (last->_next != nullptr) {
+    last = last->_next;
+  }
+  size_t count = mag->_count - keep;
+  mag->_count = keep;
+
+  _lock.lock();
+  last->_next = _deleted_chain;
+  _deleted_chain = first;
+  _num_free += count;
+  ++_num_flushes;
+  _lock.unlock();
+}
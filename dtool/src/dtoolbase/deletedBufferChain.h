@@ -36,6 +36,15 @@
 #define USE_DELETEDCHAINFLAG 1
 #endif // NDEBUG
 
+#if defined(USE_DELETED_CHAIN) && defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
+// When we have true threads, we define DELETED_CHAIN_THREAD_CACHE, which
+// gives each thread a small cache of free buffers for each chain.  Most
+// allocations and deallocations are then satisfied from the cache without
+// touching the lock; the cache is refilled from, and returned to, the shared
+// chain a batch at a time.
+#define DELETED_CHAIN_THREAD_CACHE 1
+#endif
+
 #ifdef USE_DELETEDCHAINFLAG
 enum DeletedChainFlag {
   DCF_deleted = 0xfeedba0f,
@@ -54,6 +63,10 @@ enum DeletedChainFlag {
  * template class that manages object allocations.
  *
  * Use MemoryHook to get a new DeletedBufferChain of a particular size.
+ *
+ * With true threads, each thread also keeps a small private cache of free
+ * buffers for each chain, which it refills from and returns to the shared
+ * chain a batch at a time, so that the lock is rarely contended.
  */
 class EXPCL_DTOOL_DTOOLBASE DeletedBufferChain {
 protected:
@@ -66,6 +79,18 @@ public:
   INLINE bool validate(void *ptr);
   INLINE size_t get_buffer_size() const;
 
+  size_t get_num_free() const;
+  size_t get_num_allocated() const;
+  size_t get_num_refills() const;
+  size_t get_num_flushes() const;
+
+  static size_t get_num_chains();
+  static DeletedBufferChain *get_chain(size_t n);
+
+  INLINE static void set_thread_cache(bool thread_cache);
+  INLINE static bool get_thread_cache();
+  static void flush_thread_cache();
+
 private:
   class ObjectNode {
   public:
@@ -86,10 +111,37 @@ private:
   static INLINE void *node_to_buffer(ObjectNode *node);
   static INLINE ObjectNode *buffer_to_node(void *buffer);
 
+  // A thread's private cache of free buffers for one chain.
+  class Magazine {
+  public:
+    ObjectNode *_head;
+    size_t _count;
+  };
+
+  Magazine *get_magazine();
+  static Magazine *get_thread_magazines();
+  ObjectNode *take_shared(Magazine *mag);
+  void flush_magazine(Magazine *mag, size_t keep);
+
   ObjectNode *_deleted_chain;
 
-  MutexImpl _lock;
+  mutable MutexImpl _lock;
   size_t _buffer_size;
+  size_t _batch_size;
+  size_t _index;
+
+  // These are protected by _lock.
+  size_t _num_free;
+  size_t _num_allocated;
+  size_t _num_refills;
+  size_t _num_flushes;
+
+  // Only this many chains get a thread cache; any beyond this always use the
+  // shared chain.
+  static const size_t max_cached_chains = 256;
+  static DeletedBufferChain *_chains[max_cached_chains];
+  static TVOLATILE AtomicAdjust::Integer _num_chains;
+  static bool _thread_cache;
 
 #ifndef USE_DELETEDCHAINFLAG
   // Without DELETEDCHAINFLAG, we don't even store the _flag member at all.
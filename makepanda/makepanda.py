@@ -91,7 +91,7 @@ PkgListSet(["PYTHON", "DIRECT",                        # Python support
   ] + MAYAVERSIONS + MAXVERSIONS + [ "FCOLLADA", "ASSIMP", "EGG", # 3D Formats support
   "FREETYPE", "HARFBUZZ",                              # Text rendering
   "VRPN", "OPENSSL",                                   # Transport
-  "FFTW",                                              # Algorithm helpers
+  "FFTW", "LZ4",                                       # Algorithm helpers
   "ARTOOLKIT", "OPENCV", "DIRECTCAM", "VISION",        # Augmented Reality
   "GTK2",                                              # GTK2 is used for PStats on Unix
   "MFC", "WX", "FLTK",                                 # Used for web plug-in only
@@ -876,6 +876,7 @@ if (COMPILER == "MSVC"):
         if os.path.isfile(GetThirdpartyDir() + "assimp/lib/IrrXML.lib"):
             LibName("ASSIMP", GetThirdpartyDir() + "assimp/lib/IrrXML.lib")
         IncDirectory("ASSIMP", GetThirdpartyDir() + "assimp/include")
+    if (PkgSkip("LZ4")==0):      LibName("LZ4",      GetThirdpartyDir() + "lz4/lib/liblz4_static.lib")
     if (PkgSkip("SQUISH")==0):
         if GetOptimize() <= 2:
             LibName("SQUISH",   GetThirdpartyDir() + "squish/lib/squishd.lib")
@@ -1055,6 +1056,7 @@ if (COMPILER=="GCC"):
         SmartPkgEnable("ODE",       "",          ("ode"), "ode/ode.h", tool = "ode-config")
         SmartPkgEnable("OPENAL",    "openal",    ("openal"), "AL/al.h", framework = "OpenAL")
         SmartPkgEnable("SQUISH",    "",          ("squish"), "squish.h")
+        SmartPkgEnable("LZ4",       "liblz4",    ("lz4"), "lz4.h")
         SmartPkgEnable("TIFF",      "libtiff-4", ("tiff"), "tiff.h")
         SmartPkgEnable("OPENEXR",   "OpenEXR",   ("IlmImf", "Imath", "Half", "Iex", "IexMath", "IlmThread"), ("OpenEXR", "Imath", "OpenEXR/ImfOutputFile.h"))
         SmartPkgEnable("VRPN",      "",          ("vrpn", "quat"), ("vrpn", "quat.h", "vrpn/vrpn_Types.h"))
@@ -2696,6 +2698,7 @@ DTOOL_CONFIG=[
     ("HAVE_ARTOOLKIT",                 'UNDEF',                  'UNDEF'),
     ("HAVE_DIRECTCAM",                 'UNDEF',                  'UNDEF'),
     ("HAVE_SQUISH",                    'UNDEF',                  'UNDEF'),
+    ("HAVE_LZ4",                       'UNDEF',                  'UNDEF'),
     ("HAVE_CARBON",                    'UNDEF',                  'UNDEF'),
     ("HAVE_COCOA",                     'UNDEF',                  'UNDEF'),
     ("HAVE_OPENAL_FRAMEWORK",          'UNDEF',                  'UNDEF'),
@@ -4259,7 +4262,7 @@ if (not RUNTIME):
 #
 
 if (not RUNTIME):
-  OPTS=['DIR:panda/src/gobj', 'BUILDING:PANDA',  'NVIDIACG', 'ZLIB', 'SQUISH']
+  OPTS=['DIR:panda/src/gobj', 'BUILDING:PANDA',  'NVIDIACG', 'ZLIB', 'LZ4', 'SQUISH']
   TargetAdd('p3gobj_composite1.obj', opts=OPTS, input='p3gobj_composite1.cxx')
   TargetAdd('p3gobj_composite2.obj', opts=OPTS+['BIGOBJ'], input='p3gobj_composite2.cxx')
 
@@ -4561,7 +4564,7 @@ if (not RUNTIME):
 if (not RUNTIME):
   OPTS=['DIR:panda/metalibs/panda', 'BUILDING:PANDA', 'JPEG', 'PNG', 'HARFBUZZ',
       'TIFF', 'OPENEXR', 'ZLIB', 'OPENSSL', 'FREETYPE', 'FFTW', 'ADVAPI', 'WINSOCK2',
-      'SQUISH', 'NVIDIACG', 'VORBIS', 'OPUS', 'WINUSER', 'WINMM', 'WINGDI', 'IPHLPAPI',
+      'SQUISH', 'LZ4', 'NVIDIACG', 'VORBIS', 'OPUS', 'WINUSER', 'WINMM', 'WINGDI', 'IPHLPAPI',
       'SETUPAPI', 'INOTIFY']
 
   TargetAdd('panda_panda.obj', opts=OPTS, input='panda.cxx')
@@ -5615,6 +5618,7 @@ if not RUNTIME and not PkgSkip("TINYDISPLAY"):
   TargetAdd('p3tinydisplay_ztriangle_3.obj', opts=OPTS, input='ztriangle_3.cxx')
   TargetAdd('p3tinydisplay_ztriangle_4.obj', opts=OPTS, input='ztriangle_4.cxx')
   TargetAdd('p3tinydisplay_ztriangle_table.obj', opts=OPTS, input='ztriangle_table.cxx')
+  TargetAdd('p3tinydisplay_ztriangle_sse2.obj', opts=OPTS+['SSE2'], input='ztriangle_sse2.cxx')
   if GetTarget() == 'darwin':
     TargetAdd('p3tinydisplay_tinyOsxGraphicsWindow.obj', opts=OPTS, input='tinyOsxGraphicsWindow.mm')
     TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_tinyOsxGraphicsWindow.obj')
@@ -5632,6 +5636,7 @@ if not RUNTIME and not PkgSkip("TINYDISPLAY"):
   TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_ztriangle_3.obj')
   TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_ztriangle_4.obj')
   TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_ztriangle_table.obj')
+  TargetAdd('libp3tinydisplay.dll', input='p3tinydisplay_ztriangle_sse2.obj')
   TargetAdd('libp3tinydisplay.dll', input=COMMON_PANDA_LIBS)
 
 #
@@ -5684,6 +5689,7 @@ if (PkgSkip("DIRECT")==0):
   TargetAdd('p3distributed_config_distributed.obj', opts=OPTS, input='config_distributed.cxx')
   PyTargetAdd('p3distributed_cConnectionRepository.obj', opts=OPTS, input='cConnectionRepository.cxx')
   PyTargetAdd('p3distributed_cDistributedSmoothNodeBase.obj', opts=OPTS, input='cDistributedSmoothNodeBase.cxx')
+  TargetAdd('p3distributed_cInterestGrid.obj', opts=OPTS, input='cInterestGrid.cxx')
 
   OPTS=['DIR:direct/src/distributed', 'WITHINPANDA']
   IGATEFILES=GetDirectoryContents('direct/src/distributed', ["*.h", "*.cxx"])
@@ -5775,6 +5781,7 @@ if (PkgSkip("DIRECT")==0):
   PyTargetAdd('direct.pyd', input='p3distributed_config_distributed.obj')
   PyTargetAdd('direct.pyd', input='p3distributed_cConnectionRepository.obj')
   PyTargetAdd('direct.pyd', input='p3distributed_cDistributedSmoothNodeBase.obj')
+  PyTargetAdd('direct.pyd', input='p3distributed_cInterestGrid.obj')
 
   PyTargetAdd('direct.pyd', input='direct_module.obj')
   PyTargetAdd('direct.pyd', input='libp3direct.dll')
@@ -6543,6 +6550,13 @@ if not PkgSkip("PANDATOOL"):
   TargetAdd('pfm-bba.exe', input=COMMON_PANDA_LIBS)
   TargetAdd('pfm-bba.exe', opts=['ADVAPI'])
 
+  TargetAdd('pfm-bench_pfmBench.obj', opts=OPTS, input='pfmBench.cxx')
+  TargetAdd('pfm-bench.exe', input='pfm-bench_pfmBench.obj')
+  TargetAdd('pfm-bench.exe', input='libp3progbase.lib')
+  TargetAdd('pfm-bench.exe', input='libp3pandatoolbase.lib')
+  TargetAdd('pfm-bench.exe', input=COMMON_PANDA_LIBS)
+  TargetAdd('pfm-bench.exe', opts=['ADVAPI'])
+
 #
 # DIRECTORY: pandatool/src/lwo/
 #
@@ -18,6 +18,7 @@
 
 #include "collisionLevelStateBase.h"
 #include "collisionNode.h"
+#include "boundingSphere.h"
 #include "bitMask.h"
 #include "doubleBitMask.h"
 
@@ -45,6 +46,7 @@ public:
   INLINE void prepare_collider(const ColliderDef &def, const NodePath &root);
 
   bool any_in_bounds();
+  bool any_in_record(const PandaNode::ChildRecord &record) const;
   bool apply_transform();
 
   INLINE static bool has_max_colliders();
@@ -682,12 +682,29 @@ r_traverse_single(CollisionLevelStateSingle &level_state, size_t pass) {
     }
 
   } else {
-    // Otherwise, visit all the children.
-    PandaNode::Children children = node->get_children();
-    int num_children = children.get_num_children();
-    for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateSingle next_state(level_state, children.get_child(i));
-      r_traverse_single(next_state, pass);
+    // Otherwise, visit all the children.  If the node keeps records of its
+    // children, we can pass over those that no collider could reach without
+    // looking at the children themselves.  The records don't hold a
+    // reference to the children, so we take them from the same reader as the
+    // children list, which keeps the children alive until we're done.
+    PandaNodePipelineReader node_reader(node, Thread::get_current_thread());
+    node_reader.check_cached(true);
+    PandaNode::Children children = node_reader.get_children();
+    CPT(PandaNode::ChildRecords) records = node_reader.get_child_records();
+    node_reader.release();
+    if (records != nullptr) {
+      for (const PandaNode::ChildRecord &record : *records) {
+        if (level_state.any_in_record(record)) {
+          CollisionLevelStateSingle next_state(level_state, record.get_child());
+          r_traverse_single(next_state, pass);
+        }
+      }
+    } else {
+      int num_children = children.get_num_children();
+      for (int i = 0; i < num_children; ++i) {
+        CollisionLevelStateSingle next_state(level_state, children.get_child(i));
+        r_traverse_single(next_state, pass);
+      }
     }
   }
 }
@@ -893,12 +910,29 @@ r_traverse_double(CollisionLevelStateDouble &level_state, size_t pass) {
     }
 
   } else {
-    // Otherwise, visit all the children.
-    PandaNode::Children children = node->get_children();
-    int num_children = children.get_num_children();
-    for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateDouble next_state(level_state, children.get_child(i));
-      r_traverse_double(next_state, pass);
+    // Otherwise, visit all the children.  If the node keeps records of its
+    // children, we can pass over those that no collider could reach without
+    // looking at the children themselves.  The records don't hold a
+    // reference to the children, so we take them from the same reader as the
+    // children list, which keeps the children alive until we're done.
+    PandaNodePipelineReader node_reader(node, Thread::get_current_thread());
+    node_reader.check_cached(true);
+    PandaNode::Children children = node_reader.get_children();
+    CPT(PandaNode::ChildRecords) records = node_reader.get_child_records();
+    node_reader.release();
+    if (records != nullptr) {
+      for (const PandaNode::ChildRecord &record : *records) {
+        if (level_state.any_in_record(record)) {
+          CollisionLevelStateDouble next_state(level_state, record.get_child());
+          r_traverse_double(next_state, pass);
+        }
+      }
+    } else {
+      int num_children = children.get_num_children();
+      for (int i = 0; i < num_children; ++i) {
+        CollisionLevelStateDouble next_state(level_state, children.get_child(i));
+        r_traverse_double(next_state, pass);
+      }
     }
   }
 }
@@ -1104,12 +1138,29 @@ r_traverse_quad(CollisionLevelStateQuad &level_state, size_t pass) {
     }
 
   } else {
-    // Otherwise, visit all the children.
-    PandaNode::Children children = node->get_children();
-    int num_children = children.get_num_children();
-    for (int i = 0; i < num_children; ++i) {
-      CollisionLevelStateQuad next_state(level_state, children.get_child(i));
-      r_traverse_quad(next_state, pass);
+    // Otherwise, visit all the children.  If the node keeps records of its
+    // children, we can pass over those that no collider could reach without
+    // looking at the children themselves.  The records don't hold a
+    // reference to the children, so we take them from the same reader as the
+    // children list, which keeps the children alive until we're done.
+    PandaNodePipelineReader node_reader(node, Thread::get_current_thread());
+    node_reader.check_cached(true);
+    PandaNode::Children children = node_reader.get_children();
+    CPT(PandaNode::ChildRecords) records = node_reader.get_child_records();
+    node_reader.release();
+    if (records != nullptr) {
+      for (const PandaNode::ChildRecord &record : *records) {
+        if (level_state.any_in_record(record)) {
+          CollisionLevelStateQuad next_state(level_state, record.get_child());
+          r_traverse_quad(next_state, pass);
+        }
+      }
+    } else {
+      int num_children = children.get_num_children();
+      for (int i = 0; i < num_children; ++i) {
+        CollisionLevelStateQuad next_state(level_state, children.get_child(i));
+        r_traverse_quad(next_state, pass);
+      }
     }
   }
 }
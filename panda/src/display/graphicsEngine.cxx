@@ -39,6 +39,7 @@
 #include "throw_event.h"
 #include "bamCache.h"
 #include "cullableObject.h"
+#include "cullArena.h"
 #include "geomVertexArrayData.h"
 #include "vertexDataSaveFile.h"
 #include "vertexDataBook.h"
@@ -86,6 +87,8 @@ PStatCollector GraphicsEngine::_render_states_pcollector("RenderStates");
 PStatCollector GraphicsEngine::_render_states_unused_pcollector("RenderStates:Unused");
 PStatCollector GraphicsEngine::_cyclers_pcollector("PipelineCyclers");
 PStatCollector GraphicsEngine::_dirty_cyclers_pcollector("Dirty PipelineCyclers");
+PStatCollector GraphicsEngine::_cycle_copy_pcollector("Pipeline cycle:Copy");
+PStatCollector GraphicsEngine::_cycle_release_pcollector("Pipeline cycle:Release");
 PStatCollector GraphicsEngine::_delete_pcollector("App:Delete");
 
 
@@ -840,6 +843,12 @@ render_frame() {
       PStatTimer timer(_cycle_pcollector, current_thread);
       _pipeline->cycle();
     }
+#ifdef DO_PSTATS
+    // The pipeline can't report to PStats itself, so we pass on its timing of
+    // the two halves of the cycle.
+    _cycle_copy_pcollector.set_level(_pipeline->get_cycle_time());
+    _cycle_release_pcollector.set_level(_pipeline->get_release_time());
+#endif  // DO_PSTATS
 #endif  // THREADED_PIPELINE
 
     global_clock->tick(current_thread);
@@ -1531,6 +1540,11 @@ cull_and_draw_together(GraphicsOutput *win, DisplayRegion *dr,
   } else {
     DrawCullHandler cull_handler(gsg);
     if (gsg->begin_scene()) {
+      // The objects are drawn and deleted as soon as they are culled, so
+      // the arena is only needed for the duration of the traversal.
+      CullArena *arena = CullArena::make_arena();
+      CullArena *prev_arena = CullArena::set_current(arena);
+
       CallbackObject *cbobj = dr->get_cull_callback();
       if (cbobj != nullptr) {
         // Issue the cull callback on this DisplayRegion.
@@ -1544,6 +1558,11 @@ cull_and_draw_together(GraphicsOutput *win, DisplayRegion *dr,
         dr->do_cull(&cull_handler, scene_setup, gsg, current_thread);
       }
 
+      CullArena::set_current(prev_arena);
+      if (arena != nullptr) {
+        arena->release();
+      }
+
       gsg->end_scene();
     }
   }
@@ -1640,6 +1659,10 @@ cull_to_bins(GraphicsOutput *win, GraphicsStateGuardian *gsg,
              DisplayRegion *dr, SceneSetup *scene_setup,
              CullResult *cull_result, Thread *current_thread) {
 
+  // The CullableObjects are allocated from an arena belonging to the
+  // CullResult, which is released in one go after the frame has been drawn.
+  CullArena *prev_arena = CullArena::set_current(cull_result->get_arena());
+
   BinCullHandler cull_handler(cull_result);
   CallbackObject *cbobj = dr->get_cull_callback();
   if (cbobj != nullptr) {
@@ -1654,8 +1677,12 @@ cull_to_bins(GraphicsOutput *win, GraphicsStateGuardian *gsg,
     dr->do_cull(&cull_handler, scene_setup, gsg, current_thread);
   }
 
-  PStatTimer timer(_cull_sort_pcollector, current_thread);
-  cull_result->finish_cull(scene_setup, current_thread);
+  {
+    PStatTimer timer(_cull_sort_pcollector, current_thread);
+    cull_result->finish_cull(scene_setup, current_thread);
+  }
+
+  CullArena::set_current(prev_arena);
 }
 
 /**
@@ -376,6 +376,8 @@ private:
   static PStatCollector _render_states_unused_pcollector;
   static PStatCollector _cyclers_pcollector;
   static PStatCollector _dirty_cyclers_pcollector;
+  static PStatCollector _cycle_copy_pcollector;
+  static PStatCollector _cycle_release_pcollector;
   static PStatCollector _delete_pcollector;
 
   static PStatCollector _sw_sprites_pcollector;
@@ -51,6 +51,7 @@ public:
   INLINE const Thing &back() const;
   INLINE Thing &back();
   INLINE void push_back(const Thing &t);
+  INLINE void insert(int n, const Thing &t);
 
   INLINE void clear();
 
@@ -0,0 +1,170 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_vfs_lookup.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "virtualFileSystem.h"
+#include "dSearchPath.h"
+#include "thread.h"
+#include "trueClock.h"
+
+/**
+ * Each thread resolves all of the asset names on the search path, as a
+ * loader thread would at startup.
+ */
+class LookupThread : public Thread {
+public:
+  LookupThread(const DSearchPath &searchpath, const pvector<Filename> &names,
+               int num_rounds) :
+    Thread("lookup", "lookup"),
+    _searchpath(searchpath),
+    _names(names),
+    _num_rounds(num_rounds),
+    _num_found(0)
+  {
+  }
+
+  virtual void thread_main() {
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    for (int r = 0; r < _num_rounds; ++r) {
+      for (const Filename &name : _names) {
+        Filename filename = name;
+        if (vfs->resolve_filename(filename, _searchpath, "bam")) {
+          ++_num_found;
+        }
+      }
+    }
+  }
+
+  const DSearchPath &_searchpath;
+  const pvector<Filename> &_names;
+  int _num_rounds;
+  int _num_found;
+};
+
+/**
+ * Runs the indicated number of lookup threads at once, and returns the time
+ * taken.
+ */
+static double
+run_threads(int num_threads, int num_rounds, const DSearchPath &searchpath,
+            const pvector<Filename> &names, int &num_found) {
+  pvector<PT(LookupThread) > threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new LookupThread(searchpath, names, num_rounds));
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int i = 0; i < num_threads; ++i) {
+    threads[i]->start(TP_normal, true);
+  }
+  num_found = 0;
+  for (int i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+    num_found += threads[i]->_num_found;
+  }
+  return clock->get_short_time() - start;
+}
+
+/**
+ * Times resolving many filenames along a search path of several directories
+ * from several threads, with and without vfs-lookup-cache, and checks that
+ * the cache notices files created through the VirtualFileSystem.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_threads = 4;
+  int num_files = 500;
+
+  if (argc > 1) {
+    num_threads = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_files = atoi(argv[2]);
+  }
+  if (argc > 3 || num_threads <= 0 || num_files <= 0) {
+    nout << "test_vfs_lookup [num_threads [num_files]]\n";
+    exit(1);
+  }
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+
+  // Make a search path of eight directories, with the models in the last
+  // one, as with a long model-path.
+  Filename root = Filename::temporary("", "vfs_lookup");
+  DSearchPath searchpath;
+  for (int d = 0; d < 8; ++d) {
+    Filename dir(root, "dir" + std::to_string(d));
+    vfs->make_directory_full(dir);
+    searchpath.append_directory(dir);
+  }
+  Filename models = searchpath.get_directory(7);
+
+  // Half of the names exist (with the default extension), and half don't.
+  pvector<Filename> names;
+  for (int i = 0; i < num_files; ++i) {
+    Filename name("model" + std::to_string(i));
+    if (i % 2 == 0) {
+      vfs->write_file(Filename(models, name.get_fullpath() + ".bam"), "", false);
+    }
+    names.push_back(name);
+  }
+
+  int uncached_found, cached_found;
+  vfs->vfs_lookup_cache.set_value(false);
+  double uncached_time = run_threads(num_threads, 4, searchpath, names,
+                                     uncached_found);
+
+  vfs->vfs_lookup_cache.set_value(true);
+  double cached_time = run_threads(num_threads, 4, searchpath, names,
+                                   cached_found);
+
+  // A file created through the vfs must be found at once, even though it was
+  // just looked up and not found.
+  Filename missing = names[1];
+  Filename filename = missing;
+  bool found_before = vfs->resolve_filename(filename, searchpath, "bam");
+  vfs->write_file(Filename(models, missing.get_fullpath() + ".bam"), "", false);
+  filename = missing;
+  bool found_after = vfs->resolve_filename(filename, searchpath, "bam");
+
+  // The same file looked up as text and as binary must come back with the
+  // flag it was asked for.
+  Filename text_name = Filename::text_filename(Filename(models, names[0].get_fullpath() + ".bam"));
+  Filename binary_name = Filename::binary_filename(text_name);
+  PT(VirtualFile) text_file = vfs->get_file(text_name, true);
+  PT(VirtualFile) binary_file = vfs->get_file(binary_name, true);
+  bool flags_kept = text_file != nullptr && binary_file != nullptr &&
+    text_file->get_original_filename().is_text() &&
+    binary_file->get_original_filename().is_binary();
+
+  nout << num_threads << " threads, " << num_files << " files on "
+       << searchpath.get_num_directories() << " directories: "
+       << uncached_time << " s without cache, " << cached_time
+       << " s with cache; found " << uncached_found << " / " << cached_found
+       << "\n";
+
+  // Clean up.
+  for (const Filename &name : names) {
+    vfs->delete_file(Filename(models, name.get_fullpath() + ".bam"));
+  }
+  for (int d = 7; d >= 0; --d) {
+    vfs->delete_file(searchpath.get_directory(d));
+  }
+  vfs->delete_file(root);
+
+  Thread::prepare_for_exit();
+  bool ok = (uncached_found == cached_found && !found_before && found_after &&
+             flags_kept);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_vfs_prefetch.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "virtualFileSystem.h"
+#include "dSearchPath.h"
+#include "thread.h"
+#include "trueClock.h"
+
+/**
+ * Each of num_threads threads prefetches every num_threads'th file from the
+ * list, as the Loader's prefetch threads would.
+ */
+class PrefetchThread : public Thread {
+public:
+  PrefetchThread(const DSearchPath::Results &files, size_t first,
+                 size_t stride) :
+    Thread("prefetch", "prefetch"),
+    _files(files),
+    _first(first),
+    _stride(stride)
+  {
+  }
+
+  virtual void thread_main() {
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    for (size_t n = _first; n < _files.get_num_files(); n += _stride) {
+      vfs->prefetch_file(_files.get_file(n));
+    }
+  }
+
+  const DSearchPath::Results &_files;
+  size_t _first;
+  size_t _stride;
+};
+
+/**
+ * Reads all of the files in order, as a level load would, and returns the
+ * time taken.  Counts the files whose contents are not as expected.
+ */
+static double
+read_all(const DSearchPath::Results &files, const std::string &expected,
+         int &num_wrong) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  num_wrong = 0;
+  for (size_t i = 0; i < files.get_num_files(); ++i) {
+    std::istream *in = vfs->open_read_file(files.get_file(i), true);
+    std::string data;
+    if (in != nullptr) {
+      char buffer[4096];
+      while (in->read(buffer, sizeof(buffer)), in->gcount() != 0) {
+        data.append(buffer, in->gcount());
+      }
+      vfs->close_read_file(in);
+    }
+    if (data != expected) {
+      ++num_wrong;
+    }
+  }
+  return clock->get_short_time() - start;
+}
+
+/**
+ * Writes many compressed files, then times reading them in order, both cold
+ * and after prefetching them on several threads; and checks that a manifest
+ * recorded from the first read lists the files in the order they were read.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_threads = 4;
+  int num_files = 500;
+
+  if (argc > 1) {
+    num_threads = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_files = atoi(argv[2]);
+  }
+  if (argc > 3 || num_threads <= 0 || num_files <= 0) {
+    nout << "test_vfs_prefetch [num_threads [num_files]]\n";
+    exit(1);
+  }
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+
+  // Some compressible data, about the size of a small model.
+  std::string expected;
+  for (int i = 0; expected.size() < 100000; ++i) {
+    expected += "vertex " + std::to_string(i % 977) + " " +
+      std::to_string((i * 31) % 1013) + "\n";
+  }
+
+  Filename root = Filename::temporary("", "vfs_prefetch");
+  vfs->make_directory_full(root);
+  DSearchPath::Results files;
+  for (int i = 0; i < num_files; ++i) {
+    Filename filename(root, "model" + std::to_string(i) + ".egg.pz");
+    vfs->write_file(filename, expected, true);
+    files.add_file(filename);
+  }
+
+  // Read them cold, recording the order.
+  vfs->set_record_accesses(true);
+  int cold_wrong;
+  double cold_time = read_all(files, expected, cold_wrong);
+  vfs->set_record_accesses(false);
+
+  Filename manifest(root, "manifest.txt");
+  DSearchPath::Results listed;
+  bool manifest_ok = vfs->write_access_manifest(manifest) &&
+    vfs->read_manifest(manifest, listed) &&
+    listed.get_num_files() == files.get_num_files();
+  for (size_t i = 0; manifest_ok && i < listed.get_num_files(); ++i) {
+    manifest_ok = (listed.get_file(i) == files.get_file(i));
+  }
+
+  // Now prefetch them from the manifest on several threads, then read them.
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  pvector<PT(PrefetchThread) > threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new PrefetchThread(listed, i, num_threads));
+    threads.back()->start(TP_normal, true);
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+  double prefetch_time = clock->get_short_time() - start;
+  size_t prefetched_size = vfs->get_prefetched_size();
+
+  int warm_wrong;
+  double warm_time = read_all(files, expected, warm_wrong);
+
+  // Once they have been read, nothing should be left over.
+  bool drained = (vfs->get_prefetched_size() == 0);
+
+  nout << num_files << " files of " << expected.size() << " bytes: "
+       << cold_time << " s to read cold (" << cold_wrong << " wrong), "
+       << prefetch_time << " s to prefetch " << prefetched_size
+       << " bytes on " << num_threads << " threads, " << warm_time
+       << " s to read prefetched (" << warm_wrong << " wrong); manifest "
+       << (manifest_ok ? "ok" : "WRONG") << "\n";
+
+  // Clean up.
+  for (size_t i = 0; i < files.get_num_files(); ++i) {
+    vfs->delete_file(files.get_file(i));
+  }
+  vfs->delete_file(manifest);
+  vfs->delete_file(root);
+
+  Thread::prepare_for_exit();
+  bool ok = (cold_wrong == 0 && warm_wrong == 0 && manifest_ok && drained);
+  return ok ? 0 : 1;
+}
@@ -14,6 +14,7 @@
 #include "virtualFileSimple.h"
 #include "virtualFileMount.h"
 #include "virtualFileList.h"
+#include "virtualFileSystem.h"
 #include "dcast.h"
 
 using std::iostream;
@@ -209,9 +210,13 @@ istream *VirtualFileSimple::
 open_read_file(bool auto_unwrap) const {
 
   // Will we be automatically unwrapping a .pz file?
-  bool do_uncompress = (_implicit_pz_file ||
-    (auto_unwrap && (_local_filename.get_extension() == "pz" ||
-                     _local_filename.get_extension() == "gz")));
+  bool do_uncompress = is_unwrapped(auto_unwrap);
+
+  // If the file has been prefetched, we can return its contents from memory.
+  vector_uchar data;
+  if (_mount->get_file_system()->note_read_file(this, do_uncompress, data)) {
+    return new PrefetchedStream(std::move(data));
+  }
 
   Filename local_filename(_local_filename);
   if (do_uncompress) {
@@ -380,17 +385,13 @@ bool VirtualFileSimple::
 read_file(vector_uchar &result, bool auto_unwrap) const {
 
   // Will we be automatically unwrapping a .pz file?
-  bool do_uncompress = (_implicit_pz_file ||
-    (auto_unwrap && (_local_filename.get_extension() == "pz" ||
-                     _local_filename.get_extension() == "gz")));
+  bool do_uncompress = is_unwrapped(auto_unwrap);
 
-  Filename local_filename(_local_filename);
-  if (do_uncompress) {
-    // .pz files are always binary, of course.
-    local_filename.set_binary();
+  if (_mount->get_file_system()->note_read_file(this, do_uncompress, result)) {
+    return true;
   }
 
-  return _mount->read_file(local_filename, do_uncompress, result);
+  return do_read_file(result, do_uncompress);
 }
 
 /**
@@ -444,3 +445,81 @@ scan_local_directory(VirtualFileList *file_list,
 
   return true;
 }
+
+/**
+ * Returns true if reading the file with the indicated auto_unwrap flag will
+ * decompress it: that is, if it is an implicit .pz file, or if auto_unwrap is
+ * true and it is an explicitly-named .pz or .gz file.
+ */
+bool VirtualFileSimple::
+is_unwrapped(bool auto_unwrap) const {
+  return (_implicit_pz_file ||
+    (auto_unwrap && (_local_filename.get_extension() == "pz" ||
+                     _local_filename.get_extension() == "gz")));
+}
+
+/**
+ * Reads the contents of the file from its mount, decompressing it if
+ * do_uncompress is true, without consulting the VirtualFileSystem's
+ * prefetched files.
+ */
+bool VirtualFileSimple::
+do_read_file(vector_uchar &result, bool do_uncompress) const {
+  Filename local_filename(_local_filename);
+  if (do_uncompress) {
+    // .pz files are always binary, of course.
+    local_filename.set_binary();
+  }
+
+  return _mount->read_file(local_filename, do_uncompress, result);
+}
+
+/**
+ *
+ */
+VirtualFileSimple::PrefetchedStreamBuf::
+PrefetchedStreamBuf(vector_uchar &&data) :
+  _data(std::move(data))
+{
+  char *start = (char *)_data.data();
+  setg(start, start, start + _data.size());
+}
+
+/**
+ * Implements seeking within the stream.
+ */
+std::streampos VirtualFileSimple::PrefetchedStreamBuf::
+seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which) {
+  if ((which & std::ios::in) == 0) {
+    return pos_type(-1);
+  }
+
+  std::streamoff pos;
+  switch (dir) {
+  case std::ios::beg:
+    pos = off;
+    break;
+  case std::ios::cur:
+    pos = (gptr() - eback()) + off;
+    break;
+  case std::ios::end:
+    pos = (egptr() - eback()) + off;
+    break;
+  default:
+    return pos_type(-1);
+  }
+
+  if (pos < 0 || pos > egptr() - eback()) {
+    return pos_type(-1);
+  }
+  setg(eback(), eback() + pos, egptr());
+  return pos;
+}
+
+/**
+ * A variant on seekoff() to implement seeking within a stream.
+ */
+std::streampos VirtualFileSimple::PrefetchedStreamBuf::
+seekpos(std::streampos pos, ios_openmode which) {
+  return seekoff(pos, std::ios::beg, which);
+}
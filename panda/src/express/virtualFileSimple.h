@@ -71,10 +71,34 @@ protected:
                                     const ov_set<std::string> &mount_points) const;
 
 private:
+  bool is_unwrapped(bool auto_unwrap) const;
+  bool do_read_file(vector_uchar &result, bool do_uncompress) const;
+
   VirtualFileMount *_mount;
   Filename _local_filename;
   bool _implicit_pz_file;
 
+  // Reads the contents of a prefetched file straight out of the buffer that
+  // was prefetched, which it takes over.
+  class PrefetchedStreamBuf : public std::streambuf {
+  public:
+    PrefetchedStreamBuf(vector_uchar &&data);
+
+    virtual std::streampos seekoff(std::streamoff off, ios_seekdir dir, ios_openmode which);
+    virtual std::streampos seekpos(std::streampos pos, ios_openmode which);
+
+  private:
+    vector_uchar _data;
+  };
+
+  class PrefetchedStream : public std::istream {
+  public:
+    INLINE PrefetchedStream(vector_uchar &&data);
+
+  private:
+    PrefetchedStreamBuf _buf;
+  };
+
 public:
   virtual TypeHandle get_type() const {
     return get_class_type();
@@ -95,6 +119,8 @@ public:
 
 private:
   static TypeHandle _type_handle;
+
+  friend class VirtualFileSystem;
 };
 
 #include "virtualFileSimple.I"
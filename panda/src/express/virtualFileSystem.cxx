@@ -26,6 +26,7 @@
 #include "configVariableString.h"
 #include "executionEnvironment.h"
 #include "pset.h"
+#include "string_utils.h"
 
 using std::iostream;
 using std::istream;
@@ -69,10 +70,44 @@ VirtualFileSystem() :
             "will implicitly retrieve a file named 'dirname/mytex.jpg' "
             "within the multifile /c/files/foo.mf, even if the multifile "
             "has not already been mounted.  This makes all of your multifiles "
-            "act like directories."))
+            "act like directories.")),
+  vfs_lookup_cache
+  ("vfs-lookup-cache", false,
+   PRC_DESC("Set this true to make the VirtualFileSystem remember the result "
+            "of each status-only lookup, such as those made by exists(), "
+            "find_file() and resolve_filename(), including the lookups that "
+            "find nothing.  This makes searching the model-path for "
+            "thousands of files much faster, but files that are created or "
+            "removed on disk other than through the VirtualFileSystem will "
+            "not be noticed until the next mount or unmount, or a call to "
+            "clear_lookup_cache().  It is therefore best suited to "
+            "applications whose assets don't change while they run.")),
+  vfs_lookup_cache_size
+  ("vfs-lookup-cache-size", 65536,
+   PRC_DESC("The maximum number of lookups remembered when vfs-lookup-cache "
+            "is enabled.  When this is exceeded, part of the cache is "
+            "emptied.")),
+  vfs_prefetch_cache_size
+  ("vfs-prefetch-cache-size", 64 * 1024 * 1024,
+   PRC_DESC("The maximum number of bytes of file data that may be held in "
+            "memory at once by prefetch_file(), waiting to be read.  "
+            "Files that would exceed this are not prefetched, and are read "
+            "from disk as usual when they are needed.")),
+  vfs_record_accesses
+  ("vfs-record-accesses", false,
+   PRC_DESC("Set this true to make the VirtualFileSystem remember, from "
+            "startup, the name of each file that is read through it, in the "
+            "order they are first read.  The list may be saved with "
+            "write_access_manifest() and given to Loader::prefetch_manifest() "
+            "on a later run."))
 {
   _cwd = "/";
   _mount_seq = 0;
+  _cache_seq = 0;
+  _prefetched_size = 0;
+  _num_prefetched = 0;
+  _record_accesses = vfs_record_accesses;
+  update_mount_table();
 }
 
 /**
@@ -240,7 +275,7 @@ unmount(Multifile *multifile) {
 
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
-  ++_mount_seq;
+  mounts_changed();
   _lock.unlock();
   return num_removed;
 }
@@ -299,7 +334,7 @@ unmount(const Filename &physical_filename) {
 
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
-  ++_mount_seq;
+  mounts_changed();
   _lock.unlock();
   return num_removed;
 }
@@ -332,7 +367,7 @@ unmount(VirtualFileMount *mount) {
 
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
-  ++_mount_seq;
+  mounts_changed();
   _lock.unlock();
   return num_removed;
 }
@@ -368,7 +403,7 @@ unmount_point(const Filename &mount_point) {
 
   int num_removed = _mounts.end() - wi;
   _mounts.erase(wi, _mounts.end());
-  ++_mount_seq;
+  mounts_changed();
   _lock.unlock();
   return num_removed;
 }
@@ -392,7 +427,7 @@ unmount_all() {
 
   int num_removed = _mounts.size();
   _mounts.clear();
-  ++_mount_seq;
+  mounts_changed();
   _lock.unlock();
   return num_removed;
 }
@@ -434,6 +469,7 @@ chdir(const Filename &new_directory) {
   if (new_directory == "/") {
     // We can always return to the root.
     _cwd = new_directory;
+    update_mount_table();
     _lock.unlock();
     return true;
   }
@@ -441,6 +477,7 @@ chdir(const Filename &new_directory) {
   PT(VirtualFile) file = do_get_file(new_directory, OF_status_only);
   if (file != nullptr && file->is_directory()) {
     _cwd = file->get_filename();
+    update_mount_table();
     _lock.unlock();
     return true;
   }
@@ -470,6 +507,7 @@ make_directory(const Filename &filename) {
   _lock.lock();
   PT(VirtualFile) result = do_get_file(filename, OF_make_directory);
   _lock.unlock();
+  clear_lookup_cache();
   nassertr_always(result != nullptr, false);
   return result->is_directory();
 }
@@ -497,6 +535,7 @@ make_directory_full(const Filename &filename) {
   // Now make the last one, and check the return value.
   PT(VirtualFile) result = do_get_file(filename, OF_make_directory);
   _lock.unlock();
+  clear_lookup_cache();
   return (result != nullptr) ? result->is_directory() : false;
 }
 
@@ -513,10 +552,73 @@ make_directory_full(const Filename &filename) {
  */
 PT(VirtualFile) VirtualFileSystem::
 get_file(const Filename &filename, bool status_only) const {
+  if (filename.empty()) {
+    return nullptr;
+  }
   int open_flags = status_only ? OF_status_only : 0;
-  _lock.lock();
-  PT(VirtualFile) result = do_get_file(filename, open_flags);
-  _lock.unlock();
+
+  // Note the cache sequence before taking the snapshot of the mount table.
+  // A mount that replaces the table after this point also bumps the
+  // sequence, so we won't cache a result found in the old table under the
+  // new sequence.
+  AtomicAdjust::Integer cache_seq = AtomicAdjust::get(_cache_seq);
+
+  // We search a snapshot of the mount table, so other threads can look up
+  // files at the same time.
+  CPT(MountTable) table = get_mount_table();
+
+  CacheShard *shard = nullptr;
+  string key;
+  if (status_only && vfs_lookup_cache) {
+    Filename pathname(filename);
+    if (pathname.is_local()) {
+      pathname = Filename(table->_cwd, filename);
+    }
+    pathname.standardize();
+
+    // The file type and the text/binary flag are part of the key, since they
+    // are passed on to the VirtualFile we return.
+    key = pathname.get_fullpath();
+    key += (char)('0' + (int)filename.get_type());
+    key += filename.is_text() ? 't' : (filename.is_binary() ? 'b' : '-');
+    size_t hash = sequence_hash<string>::add_hash(0, key);
+    shard = &_cache_shards[hash % num_cache_shards];
+
+    shard->_lock.lock();
+    CacheShard::Entries::const_iterator ei = shard->_entries.find(key);
+    if (ei != shard->_entries.end()) {
+      PT(VirtualFile) result = (*ei).second;
+      shard->_lock.unlock();
+      return result;
+    }
+    shard->_lock.unlock();
+  }
+
+  PT(VirtualFile) result =
+    do_get_file(table->_mounts, table->_cwd, filename, open_flags);
+
+  if (result == nullptr && vfs_implicit_mf) {
+    // It might be within a multifile that hasn't been mounted yet.  Mounting
+    // it changes the mount table, so this needs the lock.
+    _lock.lock();
+    result = do_get_file(filename, open_flags);
+    _lock.unlock();
+  }
+
+  if (shard != nullptr) {
+    shard->_lock.lock();
+    // Don't store the result if the cache was cleared since we started, since
+    // it might have been found in the old mount table.
+    if (AtomicAdjust::get(_cache_seq) == cache_seq) {
+      size_t max_entries = std::max((int)vfs_lookup_cache_size / (int)num_cache_shards, 1);
+      if (shard->_entries.size() >= max_entries) {
+        shard->_entries.clear();
+      }
+      shard->_entries[key] = result;
+    }
+    shard->_lock.unlock();
+  }
+
   return result;
 }
 
@@ -531,6 +633,9 @@ create_file(const Filename &filename) {
   _lock.lock();
   PT(VirtualFile) result = do_get_file(filename, OF_create_file);
   _lock.unlock();
+
+  // The file may be about to come into existence.
+  clear_lookup_cache();
   return result;
 }
 
@@ -578,7 +683,9 @@ delete_file(const Filename &filename) {
     return false;
   }
 
-  return file->delete_file();
+  bool result = file->delete_file();
+  clear_lookup_cache();
+  return result;
 }
 
 /**
@@ -609,7 +716,9 @@ rename_file(const Filename &orig_filename, const Filename &new_filename) {
 
   _lock.unlock();
 
-  return orig_file->rename_file(new_file);
+  bool result = orig_file->rename_file(new_file);
+  clear_lookup_cache();
+  return result;
 }
 
 /**
@@ -728,6 +837,187 @@ write(ostream &out) const {
 }
 
 
+/**
+ * Forgets the results of all previous lookups, when vfs-lookup-cache is
+ * enabled.  Call this after files have been added to or removed from a
+ * mounted directory by some means other than this VirtualFileSystem.
+ *
+ * The cache is also cleared automatically whenever anything is mounted or
+ * unmounted, or a file is created, deleted or renamed through this object.
+ */
+void VirtualFileSystem::
+clear_lookup_cache() {
+  // Bump the sequence first, so that a lookup that is still running won't
+  // store a result that it found before the clear.
+  AtomicAdjust::inc(_cache_seq);
+  for (int i = 0; i < num_cache_shards; ++i) {
+    CacheShard &shard = _cache_shards[i];
+    shard._lock.lock();
+    shard._entries.clear();
+    shard._lock.unlock();
+  }
+}
+
+/**
+ * Reads the indicated file into memory now, so that the next attempt to read
+ * it through this VirtualFileSystem is satisfied without touching the disk.
+ * A compressed file (either an explicit .pz file or a compressed subfile of a
+ * Multifile) is also decompressed now.  This is meant to be called from
+ * several threads at once, for a list of files that will be needed soon; see
+ * Loader::prefetch_file().
+ *
+ * The contents are handed over to the first reader of the file, and then
+ * forgotten.  Returns true if the file is now prefetched, or false if it
+ * could not be read, or if it would not fit within vfs-prefetch-cache-size.
+ */
+bool VirtualFileSystem::
+prefetch_file(const Filename &filename) {
+  PT(VirtualFile) file = get_file(filename, false);
+  if (file == nullptr ||
+      !file->is_of_type(VirtualFileSimple::get_class_type()) ||
+      !file->is_regular_file()) {
+    return false;
+  }
+  VirtualFileSimple *simple = DCAST(VirtualFileSimple, file);
+  string key = simple->get_filename().get_fullpath();
+
+  size_t max_size = (size_t)vfs_prefetch_cache_size.get_value();
+  _prefetch_lock.lock();
+  bool already = (_prefetched_files.find(key) != _prefetched_files.end());
+  bool full = (_prefetched_size >= max_size);
+  _prefetch_lock.unlock();
+  if (already) {
+    return true;
+  }
+  if (full) {
+    return false;
+  }
+
+  // Read the file outside of the lock, so that several threads may be
+  // reading and decompressing at once.  We read it the way a loader would,
+  // unwrapping any .pz file.
+  PrefetchedFile prefetched;
+  prefetched._uncompressed = simple->is_unwrapped(true);
+  prefetched._timestamp = simple->get_timestamp();
+  if (!simple->do_read_file(prefetched._data, prefetched._uncompressed)) {
+    return false;
+  }
+
+  _prefetch_lock.lock();
+  bool added = false;
+  if (_prefetched_size + prefetched._data.size() <= max_size) {
+    size_t size = prefetched._data.size();
+    if (_prefetched_files.insert(PrefetchedFiles::value_type(key, std::move(prefetched))).second) {
+      _prefetched_size += size;
+      AtomicAdjust::inc(_num_prefetched);
+    }
+    added = true;
+  }
+  _prefetch_lock.unlock();
+
+  if (express_cat.is_debug()) {
+    express_cat.debug()
+      << (added ? "Prefetched " : "No room to prefetch ") << key << "\n";
+  }
+  return added;
+}
+
+/**
+ * Returns the total number of bytes of prefetched file data that are being
+ * held in memory, waiting to be read.
+ */
+size_t VirtualFileSystem::
+get_prefetched_size() const {
+  _prefetch_lock.lock();
+  size_t size = _prefetched_size;
+  _prefetch_lock.unlock();
+  return size;
+}
+
+/**
+ * Discards all of the file data that has been prefetched but not yet read.
+ */
+void VirtualFileSystem::
+clear_prefetched_files() {
+  _prefetch_lock.lock();
+  _prefetched_files.clear();
+  _prefetched_size = 0;
+  AtomicAdjust::set(_num_prefetched, 0);
+  _prefetch_lock.unlock();
+}
+
+/**
+ * Forgets the list of files that have been read so far.  See
+ * set_record_accesses().
+ */
+void VirtualFileSystem::
+clear_accessed_files() {
+  _prefetch_lock.lock();
+  _accessed_files.clear();
+  _accessed_names.clear();
+  _prefetch_lock.unlock();
+}
+
+/**
+ * Writes the names of the files that have been read while accesses were
+ * being recorded, one per line, in the order they were first read.  The
+ * resulting manifest may be read back with read_manifest(), or passed to
+ * Loader::prefetch_manifest() on a later run.  Returns true on success.
+ */
+bool VirtualFileSystem::
+write_access_manifest(const Filename &manifest) const {
+  pvector<Filename> files;
+  _prefetch_lock.lock();
+  files = _accessed_files;
+  _prefetch_lock.unlock();
+
+  Filename filename = Filename::text_filename(manifest);
+  ostream *out = ((VirtualFileSystem *)this)->open_write_file(filename, false, true);
+  if (out == nullptr) {
+    express_cat.error()
+      << "Unable to write " << filename << "\n";
+    return false;
+  }
+
+  (*out) << "# Files read, in the order they were first read.\n";
+  for (const Filename &file : files) {
+    (*out) << file.get_fullpath() << "\n";
+  }
+  bool okflag = !out->fail();
+  close_write_file(out);
+  return okflag;
+}
+
+/**
+ * Reads a list of filenames, one per line, such as the one written by
+ * write_access_manifest(), and appends them to results.  Blank lines and
+ * lines beginning with a hash mark are ignored.  Returns true on success.
+ */
+bool VirtualFileSystem::
+read_manifest(const Filename &manifest, DSearchPath::Results &results) const {
+  Filename filename = Filename::text_filename(manifest);
+  string contents;
+  if (!read_file(filename, contents, true)) {
+    express_cat.error()
+      << "Unable to read " << filename << "\n";
+    return false;
+  }
+
+  size_t p = 0;
+  while (p < contents.size()) {
+    size_t q = contents.find('\n', p);
+    if (q == string::npos) {
+      q = contents.size();
+    }
+    string line = trim(contents.substr(p, q - p));
+    if (!line.empty() && line[0] != '#') {
+      results.add_file(Filename(line));
+    }
+    p = q + 1;
+  }
+  return true;
+}
+
 /**
  * Returns the default global VirtualFileSystem.  You may create your own
  * personal VirtualFileSystem objects and use them for whatever you like, but
@@ -1129,22 +1419,73 @@ do_mount(VirtualFileMount *mount, const Filename &mount_point, int flags) {
   mount->_mount_point = normalize_mount_point(mount_point);
   mount->_mount_flags = flags;
   _mounts.push_back(mount);
-  ++_mount_seq;
+  mounts_changed();
   return true;
 }
 
 /**
- * The private implementation of get_file(), create_file(), and
- * make_directory().  Assumes the lock is already held.
+ * Called whenever the list of mounts changes.  Assumes the lock is already
+ * held.
+ */
+void VirtualFileSystem::
+mounts_changed() {
+  ++_mount_seq;
+  update_mount_table();
+  clear_lookup_cache();
+}
+
+/**
+ * Replaces the snapshot of the mount table returned by get_mount_table() with
+ * one that reflects the current mounts and current directory.  Assumes the
+ * lock is already held.
+ */
+void VirtualFileSystem::
+update_mount_table() {
+  PT(MountTable) table = new MountTable;
+  table->_mounts = _mounts;
+  table->_cwd = _cwd;
+  _mount_table = table;
+}
+
+/**
+ * The private implementation of create_file(), make_directory(), and so on,
+ * and of get_file() when it needs to implicitly mount a multifile.  Assumes
+ * the lock is already held.
  */
 PT(VirtualFile) VirtualFileSystem::
 do_get_file(const Filename &filename, int open_flags) const {
+  PT(VirtualFile) found_file = do_get_file(_mounts, _cwd, filename, open_flags);
+
+  if (found_file == nullptr && vfs_implicit_mf) {
+    // The file wasn't found, as-is.  Does it appear to be an implicit .mf
+    // file reference?
+    unsigned int start_seq = _mount_seq;
+    ((VirtualFileSystem *)this)->consider_mount_mf(filename);
+
+    if (start_seq != _mount_seq) {
+      // Yes, it was, or some nested file was.  Now that we've implicitly
+      // mounted the .mf file, go back and look again.
+      return do_get_file(filename, open_flags);
+    }
+  }
+
+  return found_file;
+}
+
+/**
+ * Searches the indicated mounts for the file, interpreting a relative
+ * filename with respect to the indicated directory.  This does not need the
+ * lock, as long as the mounts cannot be changed while it runs.
+ */
+PT(VirtualFile) VirtualFileSystem::
+do_get_file(const Mounts &mounts, const Filename &cwd,
+            const Filename &filename, int open_flags) const {
   if (filename.empty()) {
     return nullptr;
   }
   Filename pathname(filename);
   if (pathname.is_local()) {
-    pathname = Filename(_cwd, filename);
+    pathname = Filename(cwd, filename);
     if (filename.is_text()) {
       pathname.set_text();
     }
@@ -1160,14 +1501,10 @@ do_get_file(const Filename &filename, int open_flags) const {
   PT(VirtualFile) found_file = nullptr;
   VirtualFileComposite *composite_file = nullptr;
 
-  // We use an index instead of an iterator, since the vector might change if
-  // implicit mounts are added during this loop.
-  unsigned int start_seq = _mount_seq;
-
-  size_t i = _mounts.size();
+  size_t i = mounts.size();
   while (i > 0) {
     --i;
-    VirtualFileMount *mount = _mounts[i];
+    VirtualFileMount *mount = mounts[i];
     Filename mount_point = mount->get_mount_point();
     if (strpath == mount_point) {
       // Here's an exact match on the mount point.  This filename is the root
@@ -1211,25 +1548,6 @@ do_get_file(const Filename &filename, int open_flags) const {
       }
 #endif  // HAVE_ZLIB
     }
-
-    // If we discover that a file has been implicitly mounted during one of
-    // the above operations, start over from the beginning of the loop.
-    if (start_seq != _mount_seq) {
-      start_seq = _mount_seq;
-      i = _mounts.size();
-    }
-  }
-
-  if (found_file == nullptr && vfs_implicit_mf) {
-    // The file wasn't found, as-is.  Does it appear to be an implicit .mf
-    // file reference?
-    ((VirtualFileSystem *)this)->consider_mount_mf(filename);
-
-    if (start_seq != _mount_seq) {
-      // Yes, it was, or some nested file was.  Now that we've implicitly
-      // mounted the .mf file, go back and look again.
-      return do_get_file(filename, open_flags);
-    }
   }
 
 #if defined(_WIN32) && !defined(NDEBUG)
@@ -1330,7 +1648,8 @@ consider_mount_mf(const Filename &filename) {
     // Reached the top directory; no .mf file references.
     return false;
   }
-  if (is_directory(dirname)) {
+  PT(VirtualFile) dir = do_get_file(dirname, OF_status_only);
+  if (dir != nullptr && dir->is_directory()) {
     // Reached a real (or already-mounted) directory; no unmounted .mf file
     // references.
     return false;
@@ -1373,3 +1692,40 @@ consider_mount_mf(const Filename &filename) {
   // Recurse.
   return consider_mount_mf(dirname);
 }
+
+/**
+ * The implementation of note_read_file(), called when something has been
+ * prefetched or accesses are being recorded.
+ */
+bool VirtualFileSystem::
+do_note_read_file(const VirtualFileSimple *file, bool uncompressed,
+                  vector_uchar &result) {
+  Filename filename = file->get_filename();
+  string key = filename.get_fullpath();
+
+  _prefetch_lock.lock();
+  if (_record_accesses && _accessed_names.insert(key).second) {
+    _accessed_files.push_back(filename);
+  }
+
+  PrefetchedFiles::iterator fi = _prefetched_files.find(key);
+  if (fi == _prefetched_files.end() || (*fi).second._uncompressed != uncompressed) {
+    _prefetch_lock.unlock();
+    return false;
+  }
+
+  PrefetchedFile prefetched = std::move((*fi).second);
+  _prefetched_files.erase(fi);
+  _prefetched_size -= prefetched._data.size();
+  AtomicAdjust::dec(_num_prefetched);
+  _prefetch_lock.unlock();
+
+  // If the file has been modified since it was prefetched, the data we have
+  // is stale.
+  if (file->get_timestamp() != prefetched._timestamp) {
+    return false;
+  }
+
+  result.swap(prefetched._data);
+  return true;
+}
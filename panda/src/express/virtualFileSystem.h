@@ -25,9 +25,15 @@
 #include "config_express.h"
 #include "mutexImpl.h"
 #include "pvector.h"
+#include "pmap.h"
+#include "pset.h"
+#include "referenceCount.h"
+#include "atomicAdjust.h"
+#include "configVariableInt64.h"
 
 class Multifile;
 class VirtualFileComposite;
+class VirtualFileSimple;
 
 /**
  * A hierarchy of directories and files that appears to be one continuous file
@@ -93,6 +99,19 @@ PUBLISHED:
 
   void write(std::ostream &out) const;
 
+  void clear_lookup_cache();
+
+  BLOCKING bool prefetch_file(const Filename &filename);
+  size_t get_prefetched_size() const;
+  void clear_prefetched_files();
+
+  INLINE void set_record_accesses(bool flag);
+  INLINE bool get_record_accesses() const;
+  void clear_accessed_files();
+  BLOCKING bool write_access_manifest(const Filename &manifest) const;
+  BLOCKING bool read_manifest(const Filename &manifest,
+                              DSearchPath::Results &results) const;
+
   static VirtualFileSystem *get_global_ptr();
 
   EXTENSION(PyObject *read_file(const Filename &filename, bool auto_unwrap) const);
@@ -123,6 +142,9 @@ public:
 
   void scan_mount_points(vector_string &names, const Filename &path) const;
 
+  INLINE bool note_read_file(const VirtualFileSimple *file, bool uncompressed,
+                             vector_uchar &result);
+
   static void parse_options(const std::string &options,
                             int &flags, std::string &password);
   static void parse_option(const std::string &option,
@@ -145,24 +167,80 @@ public:
   ConfigVariableBool vfs_case_sensitive;
   ConfigVariableBool vfs_implicit_pz;
   ConfigVariableBool vfs_implicit_mf;
+  ConfigVariableBool vfs_lookup_cache;
+  ConfigVariableInt vfs_lookup_cache_size;
+  ConfigVariableInt64 vfs_prefetch_cache_size;
+  ConfigVariableBool vfs_record_accesses;
 
 private:
+  typedef pvector<PT(VirtualFileMount) > Mounts;
+
+  // A read-only copy of the mount list and current directory.  A new one is
+  // made whenever either changes, so that lookups can walk the mounts
+  // without holding the lock.
+  class MountTable : public ReferenceCount {
+  public:
+    Mounts _mounts;
+    Filename _cwd;
+  };
+
   Filename normalize_mount_point(const Filename &mount_point) const;
   bool do_mount(VirtualFileMount *mount, const Filename &mount_point, int flags);
+  void mounts_changed();
+  void update_mount_table();
+  INLINE CPT(MountTable) get_mount_table() const;
   PT(VirtualFile) do_get_file(const Filename &filename, int open_flags) const;
+  PT(VirtualFile) do_get_file(const Mounts &mounts, const Filename &cwd,
+                              const Filename &filename, int open_flags) const;
 
   bool consider_match(PT(VirtualFile) &found_file, VirtualFileComposite *&composite_file,
                       VirtualFileMount *mount, const Filename &local_filename,
                       const Filename &original_filename, bool implicit_pz_file,
                       int open_flags) const;
   bool consider_mount_mf(const Filename &filename);
+  bool do_note_read_file(const VirtualFileSimple *file, bool uncompressed,
+                         vector_uchar &result);
 
   mutable MutexImpl _lock;
-  typedef pvector<PT(VirtualFileMount) > Mounts;
   Mounts _mounts;
   unsigned int _mount_seq;
 
   Filename _cwd;
+  CPT(MountTable) _mount_table;
+
+  // The results of recent status-only lookups, including failed ones, by
+  // full pathname.  This is divided into several shards, each with its own
+  // lock, so that threads looking up different files rarely contend.
+  enum { num_cache_shards = 16 };
+  class CacheShard {
+  public:
+    MutexImpl _lock;
+    typedef pmap<std::string, PT(VirtualFile) > Entries;
+    Entries _entries;
+  };
+  mutable CacheShard _cache_shards[num_cache_shards];
+  TVOLATILE AtomicAdjust::Integer _cache_seq;
+
+  // The contents of files that have been read ahead of time by
+  // prefetch_file(), by full pathname.  Each is handed over to the first
+  // reader of the file, and then forgotten.
+  class PrefetchedFile {
+  public:
+    vector_uchar _data;
+    bool _uncompressed;
+    time_t _timestamp;
+  };
+  typedef pmap<std::string, PrefetchedFile> PrefetchedFiles;
+  mutable MutexImpl _prefetch_lock;
+  PrefetchedFiles _prefetched_files;
+  size_t _prefetched_size;
+  TVOLATILE AtomicAdjust::Integer _num_prefetched;
+
+  // The files that have been read, in the order they were first read, while
+  // set_record_accesses() is on.  This is also protected by _prefetch_lock.
+  bool _record_accesses;
+  pvector<Filename> _accessed_files;
+  pset<std::string> _accessed_names;
 
   static VirtualFileSystem *_global_ptr;
 };
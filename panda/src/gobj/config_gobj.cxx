@@ -120,6 +120,16 @@ ConfigVariableBool keep_texture_ram
           "texture image from disk; but it will consume memory somewhat "
           "wastefully."));
 
+ConfigVariableInt64 texture_pool_ram_budget
+("texture-pool-ram-budget", 0,
+ PRC_DESC("The maximum number of bytes of main RAM that the images of the "
+          "textures in the TexturePool may occupy, or 0 for no limit.  When "
+          "a load takes the pool over this budget, the least-recently-used "
+          "textures that are referenced only by the pool are released, and "
+          "then the RAM images of textures that have already been uploaded "
+          "to the graphics card are dropped, even if keep-texture-ram is "
+          "set.  Either will be reloaded from disk when needed again."));
+
 ConfigVariableBool driver_compress_textures
 ("driver-compress-textures", false,
  PRC_DESC("Set this true to ask the graphics driver to compress textures, "
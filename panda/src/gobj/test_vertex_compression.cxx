@@ -0,0 +1,160 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_vertex_compression.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "config_gobj.h"
+#include "configVariableInt.h"
+#include "configVariableString.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomVertexWriter.h"
+#include "vertexDataBook.h"
+#include "vertexDataBlock.h"
+#include "vertexDataPage.h"
+#include "trueClock.h"
+#include "pset.h"
+
+/**
+ * Fills in a GeomVertexData with a finely tessellated torus, in the common
+ * position/normal/color/texcoord format, as typical vertex data.
+ */
+static CPT(GeomVertexArrayData)
+make_torus(int num_rings, int num_sides) {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("torus", GeomVertexFormat::get_v3n3c4t2(), GeomEnums::UH_static);
+  vdata->unclean_set_num_rows(num_rings * num_sides);
+
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  GeomVertexWriter normal(vdata, InternalName::get_normal());
+  GeomVertexWriter color(vdata, InternalName::get_color());
+  GeomVertexWriter texcoord(vdata, InternalName::get_texcoord());
+
+  for (int i = 0; i < num_rings; ++i) {
+    PN_stdfloat u = (PN_stdfloat)i / num_rings;
+    PN_stdfloat cu = ccos(u * 2.0f * MathNumbers::pi);
+    PN_stdfloat su = csin(u * 2.0f * MathNumbers::pi);
+    for (int j = 0; j < num_sides; ++j) {
+      PN_stdfloat v = (PN_stdfloat)j / num_sides;
+      PN_stdfloat cv = ccos(v * 2.0f * MathNumbers::pi);
+      PN_stdfloat sv = csin(v * 2.0f * MathNumbers::pi);
+      LVector3 n(cu * cv, su * cv, sv);
+      vertex.add_data3(cu * 10.0f + n[0], su * 10.0f + n[1], n[2]);
+      normal.add_data3(n);
+      color.add_data4(0.5f + 0.5f * cv, 0.8f, 0.5f + 0.5f * sv, 1.0f);
+      texcoord.add_data2(u * 8.0f, v);
+    }
+  }
+  return vdata->get_array(0);
+}
+
+/**
+ * Compresses all of the pages of the book with the indicated codec, then
+ * makes them resident again, and reports the time taken and the ratio
+ * achieved.  Returns false if the data did not survive the round trip.
+ */
+static bool
+run_codec(const pvector<VertexDataBlock *> &blocks,
+          const pvector<unsigned char> &expected, const std::string &codec,
+          int level) {
+  ConfigVariableString compression("vertex-data-compression");
+  ConfigVariableInt compression_level("vertex-data-compression-level");
+  compression.set_value(codec);
+  compression_level.set_value(level);
+
+  pset<VertexDataPage *> pages;
+  size_t total_size = 0;
+  for (VertexDataBlock *block : blocks) {
+    if (pages.insert(block->get_page()).second) {
+      total_size += block->get_page()->get_max_size();
+    }
+  }
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  double start = clock->get_short_time();
+  VertexDataPage::get_global_lru(VertexDataPage::RC_resident)->evict_to(0);
+  double compress_time = clock->get_short_time() - start;
+
+  // A compressed page occupies only its compressed size in the LRU.
+  size_t compressed_size = 0;
+  for (VertexDataPage *page : pages) {
+    nassertr(page->get_ram_class() == VertexDataPage::RC_compressed, false);
+    compressed_size += page->get_lru_size();
+  }
+
+  start = clock->get_short_time();
+  for (VertexDataBlock *block : blocks) {
+    block->get_pointer(true);
+  }
+  double expand_time = clock->get_short_time() - start;
+
+  bool ok = true;
+  size_t block_size = expected.size();
+  for (VertexDataBlock *block : blocks) {
+    if (memcmp(block->get_pointer(true), &expected[0], block_size) != 0) {
+      ok = false;
+    }
+  }
+
+  double mb = total_size / 1048576.0;
+  nout << codec << " level " << level << ": ratio "
+       << (double)total_size / compressed_size << ", compress "
+       << mb / compress_time << " MB/s, expand " << mb / expand_time
+       << " MB/s" << (ok ? "" : " (DATA MISMATCH)") << "\n";
+  return ok;
+}
+
+/**
+ * Measures the throughput and ratio of each vertex data compression codec on
+ * a book full of typical vertex data.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_blocks = 256;
+  if (argc > 1) {
+    num_blocks = atoi(argv[1]);
+  }
+  if (argc > 2 || num_blocks <= 0) {
+    nout << "test_vertex_compression [num_blocks]\n";
+    exit(1);
+  }
+
+  // Page synchronously, and keep compressed pages in RAM.
+  vertex_data_page_threads.set_value(0);
+  VertexDataPage::get_global_lru(VertexDataPage::RC_compressed)->set_max_size(~(size_t)0);
+
+  CPT(GeomVertexArrayData) array = make_torus(128, 64);
+  CPT(GeomVertexArrayDataHandle) handle = array->get_handle();
+  const unsigned char *data = handle->get_read_pointer(true);
+  pvector<unsigned char> expected(data, data + handle->get_data_size_bytes());
+
+  VertexDataBook book(expected.size() * 4);
+  pvector<VertexDataBlock *> blocks;
+  for (int i = 0; i < num_blocks; ++i) {
+    VertexDataBlock *block = book.alloc(expected.size());
+    memcpy(block->get_pointer(true), &expected[0], expected.size());
+    blocks.push_back(block);
+  }
+
+  nout << book.get_num_pages() << " pages of " << expected.size() * 4
+       << " bytes:\n";
+
+  bool ok = run_codec(blocks, expected, "zlib", 1);
+  ok = run_codec(blocks, expected, "zlib", 6) && ok;
+  ok = run_codec(blocks, expected, "lz4", 1) && ok;
+  ok = run_codec(blocks, expected, "lz4", 9) && ok;
+
+  for (VertexDataBlock *block : blocks) {
+    delete block;
+  }
+  return ok ? 0 : 1;
+}
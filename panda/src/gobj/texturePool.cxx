@@ -26,13 +26,16 @@
 #include "configVariableList.h"
 #include "load_dso.h"
 #include "mutexHolder.h"
+#include "textureContext.h"
 #include "dcast.h"
+#include <algorithm>
 
 using std::istream;
 using std::ostream;
 using std::string;
 
 TexturePool *TexturePool::_global_ptr;
+PStatCollector TexturePool::_ram_pcollector("Texture pool");
 
 /**
  * Lists the contents of the texture pool to the indicated output stream.  For
@@ -159,7 +162,11 @@ get_global_ptr() {
  * supposed to be one TexturePool in the universe and it constructs itself.
  */
 TexturePool::
-TexturePool() {
+TexturePool() :
+  _use_count(0),
+  _ram_budget((size_t)std::max(texture_pool_ram_budget.get_value(), (int64_t)0)),
+  _ram_size(0)
+{
   ConfigVariableFilename fake_texture_image
     ("fake-texture-image", "",
      PRC_DESC("Set this to enable a speedy-load mode in which you don't care "
@@ -209,11 +216,12 @@ ns_get_texture(const Filename &orig_filename, int primary_file_num_channels,
     MutexHolder holder(_lock);
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, LoaderOptions());
 
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -240,11 +248,12 @@ ns_get_texture(const Filename &orig_filename,
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, options);
     resolve_filename(key._alpha_fullpath, orig_alpha_filename, read_mipmaps, options);
 
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -265,11 +274,12 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
     MutexHolder holder(_lock);
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, options);
 
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -376,16 +386,17 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
 
     // Now look again--someone may have just loaded this texture in another
     // thread.
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
 
-    _textures[std::move(key)] = tex;
+    _textures[key] = Entry(tex, ++_use_count);
   }
 
   if (store_record && tex->is_cacheable()) {
@@ -404,6 +415,9 @@ ns_load_texture(const Filename &orig_filename, int primary_file_num_channels,
   // Finally, apply any post-loading texture filters.
   tex = post_load(tex);
 
+  // Make room for it, if the pool has a budget.
+  consider_evict(key);
+
   return tex;
 }
 
@@ -429,11 +443,12 @@ ns_load_texture(const Filename &orig_filename,
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, options);
     resolve_filename(key._alpha_fullpath, orig_alpha_filename, read_mipmaps, options);
 
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -506,16 +521,17 @@ ns_load_texture(const Filename &orig_filename,
     MutexHolder holder(_lock);
 
     // Now look again.
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
 
-    _textures[std::move(key)] = tex;
+    _textures[key] = Entry(tex, ++_use_count);
   }
 
   if (store_record && tex->is_cacheable()) {
@@ -534,6 +550,9 @@ ns_load_texture(const Filename &orig_filename,
   // Finally, apply any post-loading texture filters.
   tex = post_load(tex);
 
+  // Make room for it, if the pool has a budget.
+  consider_evict(key);
+
   return tex;
 }
 
@@ -552,11 +571,12 @@ ns_load_3d_texture(const Filename &filename_pattern,
     MutexHolder holder(_lock);
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, options);
 
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -617,16 +637,17 @@ ns_load_3d_texture(const Filename &filename_pattern,
     MutexHolder holder(_lock);
 
     // Now look again.
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
 
-    _textures[std::move(key)] = tex;
+    _textures[key] = Entry(tex, ++_use_count);
   }
 
   if (store_record && tex->is_cacheable()) {
@@ -635,6 +656,8 @@ ns_load_3d_texture(const Filename &filename_pattern,
     cache->store(record);
   }
 
+  consider_evict(key);
+
   nassertr(!tex->get_fullpath().empty(), tex);
   return tex;
 }
@@ -654,11 +677,12 @@ ns_load_2d_texture_array(const Filename &filename_pattern,
     MutexHolder holder(_lock);
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, options);
 
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -719,16 +743,17 @@ ns_load_2d_texture_array(const Filename &filename_pattern,
     MutexHolder holder(_lock);
 
     // Now look again.
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
 
-    _textures[std::move(key)] = tex;
+    _textures[key] = Entry(tex, ++_use_count);
   }
 
   if (store_record && tex->is_cacheable()) {
@@ -737,6 +762,8 @@ ns_load_2d_texture_array(const Filename &filename_pattern,
     cache->store(record);
   }
 
+  consider_evict(key);
+
   nassertr(!tex->get_fullpath().empty(), tex);
   return tex;
 }
@@ -756,11 +783,12 @@ ns_load_cube_map(const Filename &filename_pattern, bool read_mipmaps,
     MutexHolder holder(_lock);
     resolve_filename(key._fullpath, orig_filename, read_mipmaps, options);
 
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
@@ -821,16 +849,17 @@ ns_load_cube_map(const Filename &filename_pattern, bool read_mipmaps,
     MutexHolder holder(_lock);
 
     // Now look again.
-    Textures::const_iterator ti;
+    Textures::iterator ti;
     ti = _textures.find(key);
     if (ti != _textures.end()) {
       // This texture was previously loaded.
-      Texture *tex = (*ti).second;
+      Texture *tex = (*ti).second._texture;
+      (*ti).second._last_use = ++_use_count;
       nassertr(!tex->get_fullpath().empty(), tex);
       return tex;
     }
 
-    _textures[std::move(key)] = tex;
+    _textures[key] = Entry(tex, ++_use_count);
   }
 
   if (store_record && tex->is_cacheable()) {
@@ -839,6 +868,8 @@ ns_load_cube_map(const Filename &filename_pattern, bool read_mipmaps,
     cache->store(record);
   }
 
+  consider_evict(key);
+
   nassertr(!tex->get_fullpath().empty(), tex);
   return tex;
 }
@@ -882,27 +913,33 @@ ns_get_alpha_scale_map() {
 void TexturePool::
 ns_add_texture(Texture *tex) {
   PT(Texture) keep = tex;
-  MutexHolder holder(_lock);
+  LookupKey key;
+  {
+    MutexHolder holder(_lock);
 
-  if (!tex->_texture_pool_key.empty()) {
-    ns_release_texture(tex);
-  }
+    if (!tex->_texture_pool_key.empty()) {
+      ns_release_texture(tex);
+    }
 
-  Texture::CDReader tex_cdata(tex->_cycler);
-  if (tex_cdata->_fullpath.empty()) {
-    gobj_cat.error() << "Attempt to call add_texture() on an unnamed texture.\n";
-    return;
-  }
+    Texture::CDReader tex_cdata(tex->_cycler);
+    if (tex_cdata->_fullpath.empty()) {
+      gobj_cat.error() << "Attempt to call add_texture() on an unnamed texture.\n";
+      return;
+    }
 
-  LookupKey key;
-  key._fullpath = tex_cdata->_fullpath;
-  key._alpha_fullpath = tex_cdata->_alpha_fullpath;
-  key._alpha_file_channel = tex_cdata->_alpha_file_channel;
-  key._texture_type = tex_cdata->_texture_type;
+    key._fullpath = tex_cdata->_fullpath;
+    key._alpha_fullpath = tex_cdata->_alpha_fullpath;
+    key._alpha_file_channel = tex_cdata->_alpha_file_channel;
+    key._texture_type = tex_cdata->_texture_type;
 
-  // We blow away whatever texture was there previously, if any.
-  tex->_texture_pool_key = key._fullpath;
-  _textures[key] = tex;
+    // We blow away whatever texture was there previously, if any.
+    tex->_texture_pool_key = key._fullpath;
+    Entry &entry = _textures[key];
+    _ram_size -= entry._ram_size;
+    entry = Entry(tex, ++_use_count);
+  }
+
+  consider_evict(key);
 }
 
 /**
@@ -914,7 +951,9 @@ ns_release_texture(Texture *tex) {
 
   Textures::iterator ti;
   for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
-    if (tex == (*ti).second) {
+    if (tex == (*ti).second._texture) {
+      _ram_size -= (*ti).second._ram_size;
+      _ram_pcollector.set_level((double)_ram_size);
       _textures.erase(ti);
       tex->_texture_pool_key = string();
       break;
@@ -934,12 +973,14 @@ ns_release_all_textures() {
 
   Textures::iterator ti;
   for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
-    Texture *tex = (*ti).second;
+    Texture *tex = (*ti).second._texture;
     tex->_texture_pool_key = string();
   }
 
   _textures.clear();
   _normalization_cube_map = nullptr;
+  _ram_size = 0;
+  _ram_pcollector.set_level(0);
 
   // Blow away the cache of resolved relative filenames.
   _relpath_lookup.clear();
@@ -957,13 +998,14 @@ ns_garbage_collect() {
 
   Textures::iterator ti;
   for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
-    Texture *tex = (*ti).second;
+    Texture *tex = (*ti).second._texture;
     if (tex->get_ref_count() == 1) {
       if (gobj_cat.is_debug()) {
         gobj_cat.debug()
           << "Releasing " << (*ti).first._fullpath << "\n";
       }
       ++num_released;
+      _ram_size -= (*ti).second._ram_size;
       tex->_texture_pool_key = string();
     } else {
       new_set.insert(new_set.end(), *ti);
@@ -982,9 +1024,38 @@ ns_garbage_collect() {
     _normalization_cube_map = nullptr;
   }
 
+  _ram_pcollector.set_level((double)_ram_size);
   return num_released;
 }
 
+/**
+ * The nonstatic implementation of set_ram_budget().
+ */
+void TexturePool::
+ns_set_ram_budget(size_t budget) {
+  MutexHolder holder(_lock);
+  _ram_budget = budget;
+  do_evict_to_budget();
+}
+
+/**
+ * The nonstatic implementation of get_ram_size().
+ */
+size_t TexturePool::
+ns_get_ram_size() {
+  MutexHolder holder(_lock);
+  return do_count_ram_size();
+}
+
+/**
+ * The nonstatic implementation of evict_to_budget().
+ */
+int TexturePool::
+ns_evict_to_budget() {
+  MutexHolder holder(_lock);
+  return do_evict_to_budget();
+}
+
 /**
  * The nonstatic implementation of list_contents().
  */
@@ -1001,7 +1072,7 @@ ns_list_contents(ostream &out) const {
   total_size = 0;
   total_ram_size = 0;
   for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
-    Texture *tex = (*ti).second;
+    Texture *tex = (*ti).second._texture;
     out << (*ti).first._fullpath << "\n";
     out << "  (count = " << tex->get_ref_count()
         << ", ram  = " << tex->get_ram_image_size()
@@ -1030,7 +1101,7 @@ ns_find_texture(const string &name) const {
 
   Textures::const_iterator ti;
   for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
-    Texture *tex = (*ti).second;
+    Texture *tex = (*ti).second._texture;
     if (glob.matches(tex->get_name())) {
       return tex;
     }
@@ -1050,7 +1121,7 @@ ns_find_all_textures(const string &name) const {
 
   Textures::const_iterator ti;
   for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
-    Texture *tex = (*ti).second;
+    Texture *tex = (*ti).second._texture;
     if (glob.matches(tex->get_name())) {
       result.add_texture(tex);
     }
@@ -1258,6 +1329,171 @@ report_texture_unreadable(const Filename &filename) const {
   }
 }
 
+/**
+ * Called after a texture has been added to the pool, to count its RAM image
+ * into the running total and to make room for it if the pool has gone over
+ * its RAM budget.
+ */
+void TexturePool::
+consider_evict(const LookupKey &key) {
+  MutexHolder holder(_lock);
+  Textures::iterator ti = _textures.find(key);
+  if (ti != _textures.end()) {
+    Entry &entry = (*ti).second;
+    _ram_size -= entry._ram_size;
+    entry._ram_size = get_texture_ram_size(entry._texture);
+    _ram_size += entry._ram_size;
+    _ram_pcollector.set_level((double)_ram_size);
+  }
+
+  // The running total goes stale as textures drop or reload their images, so
+  // it is only a hint; do_evict_to_budget() recounts before evicting.
+  if (_ram_budget != 0 && _ram_size > _ram_budget) {
+    do_evict_to_budget();
+  }
+}
+
+/**
+ * Recounts the RAM occupied by each texture in the pool, and returns the
+ * total.  Assumes the lock is held.
+ */
+size_t TexturePool::
+do_count_ram_size() {
+  size_t total = 0;
+  for (Textures::value_type &item : _textures) {
+    Entry &entry = item.second;
+    entry._ram_size = get_texture_ram_size(entry._texture);
+    total += entry._ram_size;
+  }
+  _ram_size = total;
+  _ram_pcollector.set_level((double)total);
+  return total;
+}
+
+/**
+ * Evicts the least-recently-used textures until the pool fits within its RAM
+ * budget, as described in set_ram_budget().  Returns the number of textures
+ * evicted.  Assumes the lock is held.
+ */
+int TexturePool::
+do_evict_to_budget() {
+  size_t total = do_count_ram_size();
+  if (_ram_budget == 0 || total <= _ram_budget) {
+    return 0;
+  }
+
+  // Only the textures that hold a RAM image can help.
+  typedef pvector<Textures::iterator> Candidates;
+  Candidates candidates;
+  for (Textures::iterator ti = _textures.begin(); ti != _textures.end(); ++ti) {
+    if ((*ti).second._ram_size != 0) {
+      candidates.push_back(ti);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](Textures::iterator a, Textures::iterator b) {
+    return (*a).second._last_use < (*b).second._last_use;
+  });
+
+  // First release the textures that nothing else is using.
+  int num_evicted = 0;
+  Candidates referenced;
+  for (Textures::iterator ti : candidates) {
+    Texture *tex = (*ti).second._texture;
+    if (total <= _ram_budget) {
+      break;
+    }
+    if (tex->get_ref_count() != 1) {
+      referenced.push_back(ti);
+      continue;
+    }
+    if (gobj_cat.is_debug()) {
+      gobj_cat.debug()
+        << "Evicting " << (*ti).first._fullpath << " from texture pool ("
+        << (*ti).second._ram_size << " bytes)\n";
+    }
+    total -= (*ti).second._ram_size;
+    tex->_texture_pool_key = string();
+    _textures.erase(ti);
+    ++num_evicted;
+  }
+
+  // Then drop the RAM copies of the textures that are on the graphics card.
+  for (Textures::iterator ti : referenced) {
+    if (total <= _ram_budget) {
+      break;
+    }
+    if (drop_resident_ram_image((*ti).second._texture)) {
+      if (gobj_cat.is_debug()) {
+        gobj_cat.debug()
+          << "Dropping RAM image of " << (*ti).first._fullpath << " ("
+          << (*ti).second._ram_size << " bytes)\n";
+      }
+      total -= (*ti).second._ram_size;
+      (*ti).second._ram_size = 0;
+      ++num_evicted;
+    }
+  }
+
+  if (total > _ram_budget && gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Texture pool is still " << total - _ram_budget
+      << " bytes over budget\n";
+  }
+
+  _ram_size = total;
+  _ram_pcollector.set_level((double)total);
+  return num_evicted;
+}
+
+/**
+ * Returns the number of bytes of main RAM occupied by the images of the
+ * indicated texture, including all of its mipmap levels.
+ */
+size_t TexturePool::
+get_texture_ram_size(Texture *tex) {
+  Texture::CDReader cdata(tex->_cycler);
+  size_t size = 0;
+  for (const Texture::RamImage &image : cdata->_ram_images) {
+    size += image._image.size();
+  }
+  return size;
+}
+
+/**
+ * Drops the RAM image of the indicated texture if it is redundant: that is,
+ * if every GSG that has prepared the texture has an up-to-date copy, and the
+ * image can be reloaded from disk.  Returns true if the image was dropped.
+ */
+bool TexturePool::
+drop_resident_ram_image(Texture *tex) {
+  MutexHolder holder(tex->_lock);
+  if (tex->_prepared_views.empty()) {
+    return false;
+  }
+
+  Texture::CDLockedReader cdata(tex->_cycler);
+  if (cdata->_keep_ram_image || !tex->do_can_reload(cdata)) {
+    return false;
+  }
+
+  for (const Texture::PreparedViews::value_type &pvi : tex->_prepared_views) {
+    const Texture::Contexts &contexts = pvi.second;
+    if ((int)contexts.size() < cdata->_num_views) {
+      return false;
+    }
+    for (const Texture::Contexts::value_type &ci : contexts) {
+      if (ci.second->was_image_modified()) {
+        return false;
+      }
+    }
+  }
+
+  Texture::CDWriter cdataw(tex->_cycler, cdata, false);
+  tex->do_clear_ram_image(cdataw);
+  return true;
+}
+
 /**
  * Invokes pre_load() on all registered filters until one returns non-NULL;
  * returns NULL if there are no registered filters or if all registered
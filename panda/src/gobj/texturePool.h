@@ -24,6 +24,7 @@
 #include "pmutex.h"
 #include "pmap.h"
 #include "textureCollection.h"
+#include "pStatCollector.h"
 
 class TexturePoolFilter;
 class BamCache;
@@ -76,6 +77,11 @@ PUBLISHED:
 
   INLINE static int garbage_collect();
 
+  INLINE static void set_ram_budget(size_t budget);
+  INLINE static size_t get_ram_budget();
+  INLINE static size_t get_ram_size();
+  INLINE static int evict_to_budget();
+
   INLINE static void list_contents(std::ostream &out);
   INLINE static void list_contents();
 
@@ -138,6 +144,9 @@ private:
   void ns_release_texture(Texture *texture);
   void ns_release_all_textures();
   int ns_garbage_collect();
+  void ns_set_ram_budget(size_t budget);
+  size_t ns_get_ram_size();
+  int ns_evict_to_budget();
   void ns_list_contents(std::ostream &out) const;
   Texture *ns_find_texture(const std::string &name) const;
   TextureCollection ns_find_all_textures(const std::string &name) const;
@@ -152,6 +161,13 @@ private:
                       const LoaderOptions &options);
   void report_texture_unreadable(const Filename &filename) const;
 
+  struct LookupKey;
+  void consider_evict(const LookupKey &key);
+  size_t do_count_ram_size();
+  int do_evict_to_budget();
+  static size_t get_texture_ram_size(Texture *tex);
+  static bool drop_resident_ram_image(Texture *tex);
+
   // Methods to invoke a TexturePoolFilter.
   PT(Texture) pre_load(const Filename &orig_filename,
                        const Filename &orig_alpha_filename,
@@ -174,8 +190,22 @@ private:
 
     INLINE bool operator < (const LookupKey &other) const;
   };
-  typedef pmap<LookupKey, PT(Texture)> Textures;
+  // The RAM size is as of when the texture was added or the pool was last
+  // counted, and _ram_size keeps their running total.  The last use is a
+  // stamp from _use_count, for choosing what to evict first.
+  class Entry {
+  public:
+    INLINE Entry(Texture *texture = nullptr, uint64_t last_use = 0);
+
+    PT(Texture) _texture;
+    size_t _ram_size;
+    uint64_t _last_use;
+  };
+  typedef pmap<LookupKey, Entry> Textures;
   Textures _textures;
+  uint64_t _use_count;
+  size_t _ram_budget;
+  size_t _ram_size;
   typedef pmap<Filename, Filename> RelpathLookup;
   RelpathLookup _relpath_lookup;
 
@@ -189,6 +219,8 @@ private:
 
   typedef pvector<TexturePoolFilter *> FilterRegistry;
   FilterRegistry _filter_registry;
+
+  static PStatCollector _ram_pcollector;
 };
 
 #include "texturePool.I"
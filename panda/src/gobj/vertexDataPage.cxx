@@ -13,6 +13,7 @@
 
 #include "vertexDataPage.h"
 #include "configVariableInt.h"
+#include "configVariableString.h"
 #include "vertexDataSaveFile.h"
 #include "vertexDataBook.h"
 #include "vertexDataBlock.h"
@@ -25,6 +26,11 @@
 #include <zlib.h>
 #endif
 
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
 ConfigVariableInt max_resident_vertex_data
 ("max-resident-vertex-data", -1,
  PRC_DESC("Specifies the maximum number of bytes of all vertex data "
@@ -41,11 +47,21 @@ ConfigVariableInt max_compressed_vertex_data
           "the least-recently-used ones will be temporarily flushed to "
           "disk until they are needed.  Set it to -1 for no limit."));
 
+ConfigVariableString vertex_data_compression
+("vertex-data-compression", "zlib",
+ PRC_DESC("Specifies the codec used to compress vertex data in system RAM.  "
+          "This may be \"zlib\", or \"lz4\" if Panda was built with LZ4 "
+          "support.  lz4 gives somewhat larger pages than zlib, but "
+          "compresses and especially expands them many times faster, so "
+          "pages that are needed again are made resident sooner."));
+
 ConfigVariableInt vertex_data_compression_level
 ("vertex-data-compression-level", 1,
- PRC_DESC("Specifies the zlib compression level to use when compressing "
-          "vertex data.  The number should be in the range 1 to 9, where "
-          "larger values are slower but give better compression."));
+ PRC_DESC("Specifies the compression level to use when compressing "
+          "vertex data.  For zlib, the number should be in the range 1 to 9, "
+          "where larger values are slower but give better compression.  For "
+          "lz4, values above 1 select the slower LZ4HC compressor at that "
+          "level, which does not slow down expanding the data."));
 
 ConfigVariableInt max_disk_vertex_data
 ("max-disk-vertex-data", -1,
@@ -115,6 +131,7 @@ VertexDataPage(size_t book_size) :
   _size = 0;
   _uncompressed_size = 0;
   _ram_class = RC_resident;
+  _compression = C_zlib;
   _pending_ram_class = RC_resident;
 }
 
@@ -134,6 +151,7 @@ VertexDataPage(VertexDataBook *book, size_t page_size, size_t block_size) :
   _size = page_size;
 
   _uncompressed_size = _size;
+  _compression = C_zlib;
   _pending_ram_class = RC_resident;
   set_ram_class(RC_resident);
 }
@@ -347,6 +365,15 @@ make_resident() {
     do_restore_from_disk();
   }
 
+#ifdef HAVE_LZ4
+  if (_ram_class == RC_compressed && _compression == C_lz4) {
+    do_expand_lz4();
+    set_lru_size(_size);
+    set_ram_class(RC_resident);
+    return;
+  }
+#endif
+
   if (_ram_class == RC_compressed) {
 #ifdef HAVE_ZLIB
     PStatTimer timer(_vdata_decompress_pcollector);
@@ -445,6 +472,15 @@ make_compressed() {
   if (_ram_class == RC_resident) {
     nassertv(_size == _uncompressed_size);
 
+#ifdef HAVE_LZ4
+    if (vertex_data_compression.get_value() == "lz4") {
+      do_compress_lz4();
+      set_lru_size(_size);
+      set_ram_class(RC_compressed);
+      return;
+    }
+#endif
+
 #ifdef HAVE_ZLIB
     PStatTimer timer(_vdata_compress_pcollector);
 
@@ -538,6 +574,7 @@ make_compressed() {
     _page_data = new_data;
     _size = output_size;
     _allocated_size = new_allocated_size;
+    _compression = C_zlib;
 
     if (gobj_cat.is_debug()) {
       gobj_cat.debug()
@@ -550,6 +587,92 @@ make_compressed() {
   }
 }
 
+#ifdef HAVE_LZ4
+/**
+ * Expands a page that was compressed by do_compress_lz4().  The caller is
+ * responsible for updating the ram class.
+ *
+ * Assumes the lock is already held.
+ */
+void VertexDataPage::
+do_expand_lz4() {
+  PStatTimer timer(_vdata_decompress_pcollector);
+
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Expanding page from " << _size
+      << " to " << _uncompressed_size << " with lz4\n";
+  }
+  size_t new_allocated_size = round_up(_uncompressed_size);
+  unsigned char *new_data = alloc_page_data(new_allocated_size);
+
+  int output_size =
+    LZ4_decompress_safe((const char *)_page_data, (char *)new_data,
+                        (int)_size, (int)_uncompressed_size);
+  if (output_size < 0 || (size_t)output_size != _uncompressed_size) {
+    free_page_data(new_data, new_allocated_size);
+    nassert_raise("lz4 error");
+    return;
+  }
+
+  free_page_data(_page_data, _allocated_size);
+  _page_data = new_data;
+  _size = _uncompressed_size;
+  _allocated_size = new_allocated_size;
+}
+#endif  // HAVE_LZ4
+
+#ifdef HAVE_LZ4
+/**
+ * Compresses a resident page with LZ4.  Unlike zlib, LZ4 can tell us up front
+ * how large the result might be, so we compress it in one step.  The caller
+ * is responsible for updating the ram class.
+ *
+ * Assumes the lock is already held.
+ */
+void VertexDataPage::
+do_compress_lz4() {
+  PStatTimer timer(_vdata_compress_pcollector);
+
+  int bound = LZ4_compressBound((int)_uncompressed_size);
+  nassertv(bound > 0);
+  char *buffer = (char *)PANDA_MALLOC_ARRAY(bound);
+
+  int level = vertex_data_compression_level;
+  int output_size;
+  if (level > 1) {
+    output_size = LZ4_compress_HC((const char *)_page_data, buffer,
+                                  (int)_uncompressed_size, bound, level);
+  } else {
+    output_size = LZ4_compress_default((const char *)_page_data, buffer,
+                                       (int)_uncompressed_size, bound);
+  }
+  if (output_size <= 0) {
+    PANDA_FREE_ARRAY(buffer);
+    nassert_raise("lz4 error");
+    return;
+  }
+  Thread::consider_yield();
+
+  size_t new_allocated_size = round_up((size_t)output_size);
+  unsigned char *new_data = alloc_page_data(new_allocated_size);
+  memcpy(new_data, buffer, output_size);
+  PANDA_FREE_ARRAY(buffer);
+
+  free_page_data(_page_data, _allocated_size);
+  _page_data = new_data;
+  _size = (size_t)output_size;
+  _allocated_size = new_allocated_size;
+  _compression = C_lz4;
+
+  if (gobj_cat.is_debug()) {
+    gobj_cat.debug()
+      << "Compressed " << *this << " from " << _uncompressed_size
+      << " to " << _size << " with lz4\n";
+  }
+}
+#endif  // HAVE_LZ4
+
 /**
  * Moves the page to disk status by writing it to disk as necessary.
  *
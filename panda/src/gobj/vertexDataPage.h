@@ -96,6 +96,11 @@ private:
   void make_compressed();
   void make_disk();
 
+#ifdef HAVE_LZ4
+  void do_expand_lz4();
+  void do_compress_lz4();
+#endif
+
   bool do_save_to_disk();
   void do_restore_from_disk();
 
@@ -156,9 +161,17 @@ private:
   static PT(PageThreadManager) _thread_mgr;
   static Mutex &_tlock;  // Protects _thread_mgr and all of its members.
 
+  // The codec used to compress the page, which is only meaningful while it
+  // is compressed (or saved to disk in compressed form).
+  enum Compression {
+    C_zlib,
+    C_lz4,
+  };
+
   unsigned char *_page_data;
   size_t _size, _allocated_size, _uncompressed_size;
   RamClass _ram_class;
+  Compression _compression;
   PT(VertexDataSaveBlock) _saved_block;
   size_t _book_size;
   size_t _block_size;
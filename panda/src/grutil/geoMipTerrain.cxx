@@ -26,9 +26,13 @@
 #include "config_grutil.h"
 
 #include "sceneGraphReducer.h"
+#include "asyncTaskManager.h"
+#include "lensNode.h"
 
 #include "collideMask.h"
 
+#include <algorithm>
+
 using std::max;
 using std::min;
 
@@ -40,8 +44,34 @@ static ConfigVariableBool geomipterrain_incorrect_normals
           "the default value is true in 1.9 releases, and false in "
           "Panda3D 1.10.0 and above."));
 
+static ConfigVariableInt geomipterrain_num_threads
+("geomipterrain-num-threads", 1,
+ PRC_DESC("The number of threads that are started to regenerate the blocks "
+          "of GeoMipTerrains that are updated asynchronously.  This only "
+          "applies to the default task chain, and only if it has not been "
+          "created already."));
+
 TypeHandle GeoMipTerrain::_type_handle;
 
+/**
+ * Used to sort the blocks that are to be regenerated asynchronously, so that
+ * those in view and nearest the focal point are done first.
+ */
+class GeoMipBlockPriority {
+public:
+  bool operator < (const GeoMipBlockPriority &other) const {
+    if (_in_view != other._in_view) {
+      return _in_view;
+    }
+    return _distance < other._distance;
+  }
+
+  bool _in_view;
+  PN_stdfloat _distance;
+  unsigned short _mx;
+  unsigned short _my;
+};
+
 /**
  * Generates a chunk of terrain based on the level specified.  As arguments it
  * takes the x and y coords of the mipmap to be generated, and the level of
@@ -52,7 +82,24 @@ PT(GeomNode) GeoMipTerrain::
 generate_block(unsigned short mx,
                unsigned short my,
                unsigned short level) {
+  PT(GeomNode) node = make_block(mx, my, level, _levels);
+  if (node != nullptr) {
+    if (_bruteforce) {
+      level = 0;
+    }
+    _old_levels.at(mx).at(my) = min(max(_min_level, level), _max_level);
+  }
+  return node;
+}
 
+/**
+ * Does the work of generate_block(), taking the levels of the neighboring
+ * blocks from the indicated grid rather than from _levels.  This does not
+ * modify the terrain, so it may be called from a task thread.
+ */
+PT(GeomNode) GeoMipTerrain::
+make_block(unsigned short mx, unsigned short my, unsigned short level,
+           const pvector<pvector<unsigned short> > &levels) {
   nassertr(mx < (_xsize - 1) / _block_size, nullptr);
   nassertr(my < (_ysize - 1) / _block_size, nullptr);
 
@@ -100,10 +147,10 @@ generate_block(unsigned short mx,
   level = int(pow(2.0, int(level)));
 
   // Neighbor levels and junctions
-  unsigned short lnlevel = get_neighbor_level(mx, my, -1,  0);
-  unsigned short rnlevel = get_neighbor_level(mx, my,  1,  0);
-  unsigned short bnlevel = get_neighbor_level(mx, my,  0, -1);
-  unsigned short tnlevel = get_neighbor_level(mx, my,  0,  1);
+  unsigned short lnlevel = get_neighbor_level(mx, my, -1,  0, levels);
+  unsigned short rnlevel = get_neighbor_level(mx, my,  1,  0, levels);
+  unsigned short bnlevel = get_neighbor_level(mx, my,  0, -1, levels);
+  unsigned short tnlevel = get_neighbor_level(mx, my,  0,  1, levels);
   bool ljunction = (lnlevel != reallevel);
   bool rjunction = (rnlevel != reallevel);
   bool bjunction = (bnlevel != reallevel);
@@ -264,7 +311,6 @@ generate_block(unsigned short mx,
   PT(GeomNode) node = new GeomNode(sname.str());
   node->add_geom(geom);
   node->set_bounds_type(BoundingVolume::BT_box);
-  _old_levels.at(mx).at(my) = reallevel;
 
   return node;
 }
@@ -403,6 +449,7 @@ generate() {
     grutil_cat.error() << "No valid heightfield image has been set!\n";
     return;
   }
+  finish_async_update();
   calc_levels();
   _root.node()->remove_all_children();
   _blocks.clear();
@@ -444,19 +491,11 @@ update() {
   if (_is_dirty) {
     generate();
     return true;
+  } else if (_async_update) {
+    return update_async();
   } else if (!_bruteforce) {
     calc_levels();
-    if (root_flattened()) {
-      _root.node()->remove_all_children();
-      unsigned int xsize = _blocks.size();
-      for (unsigned int tx = 0; tx < xsize; tx++) {
-        unsigned int ysize = _blocks[tx].size();
-        for (unsigned int ty = 0;ty < ysize; ty++) {
-          _blocks[tx][ty].reparent_to(_root);
-        }
-      }
-      _root_flattened = false;
-    }
+    unflatten_root();
     bool returnVal = false;
     for (unsigned int mx = 0; mx < (_xsize - 1) / _block_size; mx++) {
       for (unsigned int my = 0; my < (_ysize - 1) / _block_size; my++) {
@@ -494,6 +533,221 @@ update() {
   return false;
 }
 
+/**
+ * Enables or disables asynchronous updates.  In asynchronous mode, update()
+ * does not regenerate the blocks whose level of detail has changed on the
+ * calling thread.  Instead, they are regenerated by tasks on the task chain
+ * named by set_task_chain(), while the old blocks are still being rendered.
+ * A later call to update() swaps in all of the new blocks at once, and
+ * returns true.
+ *
+ * Only one set of blocks is regenerated at a time, and all of them are
+ * generated against the same snapshot of block levels, including the
+ * neighbors that need new junctions, so that the borders between blocks
+ * never show cracks.  The size of each set may be limited with
+ * set_max_block_updates().
+ *
+ * generate(), and the first update() after the terrain has been marked
+ * dirty, still regenerate the whole terrain on the calling thread.
+ */
+void GeoMipTerrain::
+set_async_update(bool async_update) {
+  if (!async_update) {
+    finish_async_update();
+  }
+  _async_update = async_update;
+}
+
+/**
+ * The asynchronous version of update().  Swaps in the blocks that have
+ * finished regenerating, if any, and starts regenerating the next ones.
+ * Returns true if the terrain has changed.
+ */
+bool GeoMipTerrain::
+update_async() {
+  if (_bruteforce) {
+    return false;
+  }
+  calc_levels();
+
+  bool returnVal = false;
+  if (_batch != nullptr) {
+    if (AtomicAdjust::get(_batch->_num_pending) != 0) {
+      // The blocks aren't done yet.
+      return false;
+    }
+
+    unflatten_root();
+    for (size_t i = 0; i < _batch->_blocks.size(); ++i) {
+      const LVecBase2i &block = _batch->_blocks[i];
+      GeomNode *node = _batch->_nodes[i];
+      if (node != nullptr) {
+        node->replace_node(_blocks[block[0]][block[1]].node());
+        _old_levels[block[0]][block[1]] = _batch->_levels[block[0]][block[1]];
+      }
+    }
+    _batch->_tasks.clear();
+    _batch.clear();
+    auto_flatten();
+    returnVal = true;
+  }
+
+  start_async_update();
+  return returnVal;
+}
+
+/**
+ * Collects the blocks whose level of detail has changed, and starts tasks to
+ * regenerate them and their neighbors.
+ */
+void GeoMipTerrain::
+start_async_update() {
+  nassertv(_batch == nullptr);
+  unsigned short xblocks = (_xsize - 1) / _block_size;
+  unsigned short yblocks = (_ysize - 1) / _block_size;
+
+  // Get the view frustum in the terrain's coordinate space.
+  PT(GeometricBoundingVolume) frustum;
+  if (!_camera.is_empty() &&
+      _camera.node()->is_of_type(LensNode::get_class_type())) {
+    Lens *lens = DCAST(LensNode, _camera.node())->get_lens();
+    if (lens != nullptr) {
+      PT(BoundingVolume) bounds = lens->make_bounds();
+      if (bounds != nullptr &&
+          bounds->is_of_type(GeometricBoundingVolume::get_class_type())) {
+        frustum = DCAST(GeometricBoundingVolume, bounds);
+        frustum->xform(_camera.get_transform(_root)->get_mat());
+      }
+    }
+  }
+
+  PN_stdfloat fx = _focal_point.get_x(_root);
+  PN_stdfloat fy = _focal_point.get_y(_root);
+  PN_stdfloat sx = _root.get_sx();
+  PN_stdfloat sy = _root.get_sy();
+
+  pvector<GeoMipBlockPriority> changed;
+  for (unsigned short mx = 0; mx < xblocks; mx++) {
+    for (unsigned short my = 0; my < yblocks; my++) {
+      if (_levels[mx][my] == _old_levels[mx][my]) {
+        continue;
+      }
+      GeoMipBlockPriority priority;
+      priority._mx = mx;
+      priority._my = my;
+      priority._in_view = true;
+      if (frustum != nullptr) {
+        BoundingBox box(LPoint3(mx * _block_size, my * _block_size, 0),
+                        LPoint3((mx + 1) * _block_size,
+                                (my + 1) * _block_size, 1));
+        priority._in_view =
+          (frustum->contains(&box) != BoundingVolume::IF_no_intersection);
+      }
+      PN_stdfloat cx = (mx * _block_size + _block_size / 2) * sx;
+      PN_stdfloat cy = (my * _block_size + _block_size / 2) * sy;
+      priority._distance = (fx - cx) * (fx - cx) + (fy - cy) * (fy - cy);
+      changed.push_back(priority);
+    }
+  }
+  if (changed.empty()) {
+    return;
+  }
+
+  std::sort(changed.begin(), changed.end());
+  if (_max_block_updates > 0 && changed.size() > (size_t)_max_block_updates) {
+    changed.resize(_max_block_updates);
+  }
+
+  // The blocks that change level take on their new level in the snapshot;
+  // all other blocks keep the level they are currently displayed at.
+  PT(BlockBatch) batch = new BlockBatch;
+  batch->_levels = _old_levels;
+  pvector<bool> included(xblocks * yblocks, false);
+  for (size_t i = 0; i < changed.size(); ++i) {
+    unsigned short mx = changed[i]._mx;
+    unsigned short my = changed[i]._my;
+    batch->_levels[mx][my] = _levels[mx][my];
+    batch->_blocks.push_back(LVecBase2i(mx, my));
+    included[mx * yblocks + my] = true;
+  }
+
+  // The neighbors must be regenerated too, since their junctions with the
+  // changed blocks may be different.
+  for (size_t i = 0; i < changed.size(); ++i) {
+    static const int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    for (int j = 0; j < 4; ++j) {
+      int nx = changed[i]._mx + offsets[j][0];
+      int ny = changed[i]._my + offsets[j][1];
+      if (nx >= 0 && nx < xblocks && ny >= 0 && ny < yblocks &&
+          !included[nx * yblocks + ny]) {
+        batch->_blocks.push_back(LVecBase2i(nx, ny));
+        included[nx * yblocks + ny] = true;
+      }
+    }
+  }
+
+  size_t num_blocks = batch->_blocks.size();
+  batch->_nodes.resize(num_blocks);
+  batch->_num_pending = (AtomicAdjust::Integer)num_blocks;
+
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  if (task_mgr->find_task_chain(_task_chain) == nullptr) {
+    PT(AsyncTaskChain) chain = task_mgr->make_task_chain(_task_chain);
+    chain->set_num_threads(geomipterrain_num_threads);
+    chain->set_thread_priority(TP_low);
+  }
+
+  for (size_t i = 0; i < num_blocks; ++i) {
+    PT(AsyncTask) task = new BlockTask(this, batch, i);
+    task->set_task_chain(_task_chain);
+    batch->_tasks.push_back(task);
+  }
+  _batch = batch;
+  for (size_t i = 0; i < num_blocks; ++i) {
+    task_mgr->add(batch->_tasks[i]);
+  }
+}
+
+/**
+ * Cancels the blocks that are being regenerated asynchronously, if any, and
+ * waits for the tasks that have already started.
+ */
+void GeoMipTerrain::
+finish_async_update() {
+  if (_batch == nullptr) {
+    return;
+  }
+
+  for (size_t i = 0; i < _batch->_tasks.size(); ++i) {
+    _batch->_tasks[i]->remove();
+  }
+  for (size_t i = 0; i < _batch->_tasks.size(); ++i) {
+    _batch->_tasks[i]->wait();
+  }
+
+  // The tasks hold a reference to the batch.
+  _batch->_tasks.clear();
+  _batch.clear();
+}
+
+/**
+ * If the root has been flattened, puts the terrain blocks back underneath it.
+ */
+void GeoMipTerrain::
+unflatten_root() {
+  if (root_flattened()) {
+    _root.node()->remove_all_children();
+    unsigned int xsize = _blocks.size();
+    for (unsigned int tx = 0; tx < xsize; tx++) {
+      unsigned int ysize = _blocks[tx].size();
+      for (unsigned int ty = 0;ty < ysize; ty++) {
+        _blocks[tx][ty].reparent_to(_root);
+      }
+    }
+    _root_flattened = false;
+  }
+}
+
 /**
  * Normally, the root's children are the terrain blocks.  However, if we call
  * flatten_strong on the root, then the root will contain unpredictable stuff.
@@ -617,6 +871,8 @@ update_block(unsigned short mx, unsigned short my,
  */
 bool GeoMipTerrain::
 set_heightfield(const Filename &filename, PNMFileType *ftype) {
+  finish_async_update();
+
   // First, we need to load the header to determine the size and format.
   PNMImageHeader imgheader;
   if (imgheader.read_header(filename, ftype)) {
@@ -667,25 +923,54 @@ set_heightfield(const Filename &filename, PNMFileType *ftype) {
 }
 
 /**
- * Helper function for generate().
+ * Helper function for generate().  Returns the level that the indicated block
+ * must match along its border with the neighboring block, according to the
+ * indicated grid of block levels.
  */
 unsigned short GeoMipTerrain::
-get_neighbor_level(unsigned short mx, unsigned short my, short dmx, short dmy) {
+get_neighbor_level(unsigned short mx, unsigned short my, short dmx, short dmy,
+                   const pvector<pvector<unsigned short> > &levels) {
   // If we're across the terrain border, check if we want stitching.  If not,
   // return the same level as this one - it won't have to make junctions.
   if ((int)mx + (int)dmx < 0 || (int)mx + (int)dmx >= ((int)_xsize - 1) / (int)_block_size ||
       (int)my + (int)dmy < 0 || (int)my + (int)dmy >= ((int)_ysize - 1) / (int)_block_size) {
-    return (_stitching) ? _max_level : min(max(_min_level, _levels[mx][my]), _max_level);
+    return (_stitching) ? _max_level : min(max(_min_level, levels[mx][my]), _max_level);
   }
   // If we're rendering bruteforce, the level must be the same as this one.
   if (_bruteforce) {
-    return min(max(_min_level, _levels[mx][my]), _max_level);
+    return min(max(_min_level, levels[mx][my]), _max_level);
   }
   // Only if the level is higher than the current.  Otherwise, the junctions
   // will be made for the other chunk.
-  if (_levels[mx + dmx][my + dmy] > _levels[mx][my]) {
-    return min(max(_min_level, _levels[mx + dmx][my + dmy]), _max_level);
+  if (levels[mx + dmx][my + dmy] > levels[mx][my]) {
+    return min(max(_min_level, levels[mx + dmx][my + dmy]), _max_level);
   } else {
-    return min(max(_min_level, _levels[mx][my]), _max_level);
+    return min(max(_min_level, levels[mx][my]), _max_level);
   }
 }
+
+/**
+ *
+ */
+GeoMipTerrain::BlockTask::
+BlockTask(GeoMipTerrain *terrain, BlockBatch *batch, size_t index) :
+  AsyncTask("GeoMipTerrain block"),
+  _terrain(terrain),
+  _batch(batch),
+  _index(index)
+{
+}
+
+/**
+ * Regenerates one block of the batch.
+ */
+AsyncTask::DoneStatus GeoMipTerrain::BlockTask::
+do_task() {
+  const LVecBase2i &block = _batch->_blocks[_index];
+  _batch->_nodes[_index] =
+    _terrain->make_block(block[0], block[1],
+                         _batch->_levels[block[0]][block[1]],
+                         _batch->_levels);
+  AtomicAdjust::dec(_batch->_num_pending);
+  return DS_done;
+}
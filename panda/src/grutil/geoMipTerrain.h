@@ -24,6 +24,9 @@
 #include "nodePath.h"
 
 #include "texture.h"
+#include "geomNode.h"
+#include "asyncTask.h"
+#include "atomicAdjust.h"
 
 /**
  * GeoMipTerrain, meaning Panda3D GeoMipMapping, can convert a heightfield
@@ -104,6 +107,18 @@ PUBLISHED:
   INLINE double get_near();
   INLINE int get_flatten_mode();
 
+  // In asynchronous mode, update() regenerates the blocks on a task chain
+  // instead of the calling thread, and swaps them in when they are done.
+  void set_async_update(bool async_update);
+  INLINE bool get_async_update() const;
+  INLINE void set_task_chain(const std::string &chain_name);
+  INLINE const std::string &get_task_chain() const;
+  INLINE void set_max_block_updates(int max_block_updates);
+  INLINE int get_max_block_updates() const;
+  INLINE void set_camera(const NodePath &camera);
+  INLINE NodePath get_camera() const;
+  INLINE bool is_update_pending() const;
+
   PNMImage make_slope_image();
   void generate();
   bool update();
@@ -111,6 +126,13 @@ PUBLISHED:
 private:
 
   PT(GeomNode) generate_block(unsigned short mx, unsigned short my, unsigned short level);
+  PT(GeomNode) make_block(unsigned short mx, unsigned short my,
+                          unsigned short level,
+                          const pvector<pvector<unsigned short> > &levels);
+  bool update_async();
+  void start_async_update();
+  void finish_async_update();
+  void unflatten_root();
   bool update_block(unsigned short mx, unsigned short my,
                     signed short level = -1, bool forced = false);
   void calc_levels();
@@ -124,7 +146,8 @@ private:
   INLINE double get_pixel_value(int x, int y);
   INLINE double get_pixel_value(unsigned short mx, unsigned short my, int x, int y);
   INLINE unsigned short lod_decide(unsigned short mx, unsigned short my);
-  unsigned short get_neighbor_level(unsigned short mx, unsigned short my, short dmx, short dmy);
+  unsigned short get_neighbor_level(unsigned short mx, unsigned short my, short dmx, short dmy,
+                                    const pvector<pvector<unsigned short> > &levels);
 
   NodePath _root;
   int _auto_flatten;
@@ -150,6 +173,37 @@ private:
   pvector<pvector<unsigned short> > _levels;
   pvector<pvector<unsigned short> > _old_levels;
 
+  // A set of blocks that is being regenerated asynchronously.  All of the
+  // blocks are generated against the same snapshot of the block levels, and
+  // swapped into the scene graph at once, so that the stitching between
+  // neighboring blocks always matches.
+  class BlockBatch : public ReferenceCount {
+  public:
+    pvector<pvector<unsigned short> > _levels;
+    pvector<LVecBase2i> _blocks;
+    pvector<PT(GeomNode)> _nodes;
+    pvector<PT(AsyncTask)> _tasks;
+    AtomicAdjust::Integer _num_pending;
+  };
+
+  class BlockTask : public AsyncTask {
+  public:
+    BlockTask(GeoMipTerrain *terrain, BlockBatch *batch, size_t index);
+    ALLOC_DELETED_CHAIN(BlockTask);
+
+    virtual DoneStatus do_task();
+
+    GeoMipTerrain *_terrain;
+    PT(BlockBatch) _batch;
+    size_t _index;
+  };
+
+  bool _async_update;
+  std::string _task_chain;
+  int _max_block_updates;
+  NodePath _camera;
+  PT(BlockBatch) _batch;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -33,6 +33,10 @@
 #include "samplerState.h"
 #include "config_grutil.h"
 #include "typeHandle.h"
+#include "virtualFileSystem.h"
+#include "asyncTaskManager.h"
+#include <algorithm>
+#include <functional>
 
 using std::endl;
 using std::max;
@@ -68,8 +72,31 @@ ConfigVariableEnum<SamplerState::FilterType> stm_heightfield_magfilter
          "can be used to create heightfield that is visual correct with collision "
          "geometry (for example bullet terrain mesh) by changing it to nearest"));
 
+ConfigVariableInt stm_tile_size
+("stm-tile-size", 256,
+ PRC_DESC("Controls the size of the tiles in which a streaming heightfield is loaded. "
+          "Has to be a power of two, and at least as large as the chunk size. Larger "
+          "tiles mean fewer requests, but more memory per tile."));
+
+ConfigVariableInt stm_streaming_budget
+("stm-streaming-budget", 64,
+ PRC_DESC("Controls how many megabytes of heightfield data a streaming terrain may "
+          "keep in memory at once. This determines the size of the tile atlas; when "
+          "it is full, the least recently used tiles are evicted."));
+
+ConfigVariableInt stm_overview_size
+("stm-overview-size", 1024,
+ PRC_DESC("Controls the resolution of the overview texture of a streaming terrain, "
+          "which is used to render the parts of the terrain whose tiles are not "
+          "loaded."));
+
+ConfigVariableInt stm_streaming_threads
+("stm-streaming-threads", 1,
+ PRC_DESC("The number of threads used to load the tiles of streaming terrains."));
+
 PStatCollector ShaderTerrainMesh::_basic_collector("Cull:ShaderTerrainMesh:Setup");
 PStatCollector ShaderTerrainMesh::_lod_collector("Cull:ShaderTerrainMesh:CollectLOD");
+PStatCollector ShaderTerrainMesh::_streaming_collector("Cull:ShaderTerrainMesh:Streaming");
 
 NotifyCategoryDef(shader_terrain, "");
 
@@ -104,7 +131,13 @@ ShaderTerrainMesh::ShaderTerrainMesh() :
   _last_frame_count(-1),
   _target_triangle_width(10.0f),
   _update_enabled(true),
-  _heightfield_tex(nullptr)
+  _heightfield_tex(nullptr),
+  _streaming(false),
+  _tile_size(max(stm_tile_size.get_value(), 0)),
+  _streaming_budget((size_t)max(stm_streaming_budget.get_value(), 0) * 1024 * 1024),
+  _tiles_per_side(0),
+  _slots_per_side(0),
+  _num_resident_tiles(0)
 {
   set_final(true);
   set_bounds(new OmniBoundingVolume());
@@ -123,8 +156,20 @@ ShaderTerrainMesh::ShaderTerrainMesh() :
  */
 bool ShaderTerrainMesh::generate() {
   MutexHolder holder(_lock);
-  if (!do_check_heightfield())
-    return false;
+  do_clear_streaming();
+
+  _streaming = !_stream_filename.empty();
+  if (_streaming) {
+    if (!do_open_streaming_heightfield())
+      return false;
+  } else {
+    if (_heightfield_tex == nullptr) {
+      shader_terrain_cat.error() << "No heightfield set!" << endl;
+      return false;
+    }
+    if (!do_check_heightfield())
+      return false;
+  }
 
   if (_chunk_size < 8 || !check_power_of_two(_chunk_size)) {
     shader_terrain_cat.error() << "Invalid chunk size! Has to be >= 8 and a power of two!" << endl;
@@ -136,12 +181,48 @@ bool ShaderTerrainMesh::generate() {
     return false;
   }
 
-  do_extract_heightfield();
-  do_create_chunks();
+  if (_streaming) {
+    if (_tile_size < _chunk_size || _tile_size > _size || !check_power_of_two(_tile_size)) {
+      shader_terrain_cat.error() << "Invalid tile size! Has to be a power of two, at least "
+        "as large as the chunk size and at most the terrain size!" << endl;
+      return false;
+    }
+    _tiles_per_side = _size / _tile_size;
+    _tiles.resize(_tiles_per_side * _tiles_per_side);
+
+    do_create_chunks();
+
+    // Read the entire file once, to compute the bounds of the tiles and to
+    // generate the overview texture.
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    std::istream *in = vfs->open_read_file(_stream_filename, false);
+    if (in == nullptr) {
+      shader_terrain_cat.error() << "Could not open " << _stream_filename << "!" << endl;
+    }
+    bool success = (in != nullptr) && do_scan_streaming_heightfield(*in);
+    if (in != nullptr) {
+      vfs->close_read_file(in);
+    }
+    if (!success) {
+      do_clear_streaming();
+      _base_chunk.clear_children();
+      _data_texture = nullptr;
+      _chunk_geom = nullptr;
+      return false;
+    }
+  } else {
+    do_extract_heightfield();
+    do_create_chunks();
+  }
+
   do_compute_bounds(&_base_chunk);
   do_create_chunk_geom();
   do_init_data_texture();
 
+  if (_streaming) {
+    do_init_streaming_textures();
+  }
+
   // Clear image after using it, otherwise we have two copies of the heightfield
   // in memory.
   _heightfield.clear();
@@ -232,7 +313,11 @@ void ShaderTerrainMesh::do_create_chunks() {
   _base_chunk.min_height = 0.0;
   _base_chunk.max_height = 1.0;
   _base_chunk.last_clod = 0.0;
-  do_init_chunk(&_base_chunk);
+  _base_chunk.last_tesselation = 0.0;
+
+  // When streaming, the chunks within a tile are only created once the tile
+  // is loaded.
+  do_init_chunk(&_base_chunk, _streaming ? _tile_size : _chunk_size);
 }
 
 /**
@@ -247,9 +332,10 @@ void ShaderTerrainMesh::do_create_chunks() {
  *   The chunk parameter may not be zero or undefined behaviour occurs.
  *
  * @param chunk The parent chunk
+ * @param leaf_size Size of the leaf chunks
  */
-void ShaderTerrainMesh::do_init_chunk(Chunk* chunk) {
-  if (chunk->size > _chunk_size) {
+void ShaderTerrainMesh::do_init_chunk(Chunk* chunk, size_t leaf_size) {
+  if (chunk->size > leaf_size) {
 
     // Compute children chunk size
     size_t child_chunk_size = chunk->size / 2;
@@ -262,7 +348,7 @@ void ShaderTerrainMesh::do_init_chunk(Chunk* chunk) {
         child->depth = chunk->depth + 1;
         child->x = chunk->x + x * child_chunk_size;
         child->y = chunk->y + y * child_chunk_size;
-        do_init_chunk(child);
+        do_init_chunk(child, leaf_size);
         chunk->children[x + 2*y] = child;
       }
     }
@@ -271,6 +357,11 @@ void ShaderTerrainMesh::do_init_chunk(Chunk* chunk) {
     for (size_t i = 0; i < 4; ++i) {
       chunk->children[i] = nullptr;
     }
+
+    // Keep track of the chunks covering a tile
+    if (_streaming && chunk->size == _tile_size) {
+      _tiles[(chunk->y / _tile_size) * _tiles_per_side + chunk->x / _tile_size].chunk = chunk;
+    }
   }
 }
 
@@ -293,7 +384,13 @@ void ShaderTerrainMesh::do_init_chunk(Chunk* chunk) {
 void ShaderTerrainMesh::do_compute_bounds(Chunk* chunk) {
 
   // Final chunk (Leaf)
-  if (chunk->size == _chunk_size) {
+  if (chunk->children[0] == nullptr) {
+
+    // When streaming, the leaves are the tiles, which were already computed
+    // while reading the heightfield.
+    if (_streaming) {
+      return;
+    }
 
     // Get a pointer to the PNMImage data, this is faster than using get_xel()
     // for all pixels, since get_xel() also includes bounds checks and so on.
@@ -339,25 +436,40 @@ void ShaderTerrainMesh::do_compute_bounds(Chunk* chunk) {
 
   } else {
 
-    // Reset heights
-    chunk->avg_height = 0.0;
-    chunk->min_height = 1.0;
-    chunk->max_height = 0.0;
-
     // Perform bounds computation for every children and merge the children values
     for (size_t i = 0; i < 4; ++i) {
       do_compute_bounds(chunk->children[i]);
-      chunk->avg_height += chunk->children[i]->avg_height / 4.0;
-      chunk->min_height = min(chunk->min_height, chunk->children[i]->min_height);
-      chunk->max_height = max(chunk->max_height, chunk->children[i]->max_height);
     }
+    do_merge_bounds(chunk);
+  }
+}
+
+/**
+ * @brief Computes the bounds of a chunk from its children
+ * @details This method computes the average, min and max values and the edges
+ *   of a chunk by merging those values of its children, which should already
+ *   have been computed.
+ *
+ * @param chunk The parent chunk
+ */
+void ShaderTerrainMesh::do_merge_bounds(Chunk* chunk) {
+
+  // Reset heights
+  chunk->avg_height = 0.0;
+  chunk->min_height = 1.0;
+  chunk->max_height = 0.0;
 
-    // Also take the edge points from the children
-    chunk->edges.set_x(chunk->children[0]->edges.get_x());
-    chunk->edges.set_y(chunk->children[1]->edges.get_y());
-    chunk->edges.set_z(chunk->children[2]->edges.get_z());
-    chunk->edges.set_w(chunk->children[3]->edges.get_w());
+  for (size_t i = 0; i < 4; ++i) {
+    chunk->avg_height += chunk->children[i]->avg_height / 4.0;
+    chunk->min_height = min(chunk->min_height, chunk->children[i]->min_height);
+    chunk->max_height = max(chunk->max_height, chunk->children[i]->max_height);
   }
+
+  // Also take the edge points from the children
+  chunk->edges.set_x(chunk->children[0]->edges.get_x());
+  chunk->edges.set_y(chunk->children[1]->edges.get_y());
+  chunk->edges.set_z(chunk->children[2]->edges.get_z());
+  chunk->edges.set_w(chunk->children[3]->edges.get_w());
 }
 
 /**
@@ -484,6 +596,13 @@ void ShaderTerrainMesh::add_for_draw(CullTraverser *trav, CullTraverserData &dat
     _current_view_index = 0;
   }
 
+  // Take over the tiles that were loaded in the meantime
+  if (_streaming) {
+    _streaming_collector.start();
+    do_finish_tile_requests();
+    _streaming_collector.stop();
+  }
+
   // Get transform and render state for this render pass
   CPT(TransformState) modelview_transform = data.get_internal_transform(trav);
   CPT(RenderState) state = data._state->compose(get_state());
@@ -508,6 +627,7 @@ void ShaderTerrainMesh::add_for_draw(CullTraverser *trav, CullTraverserData &dat
   traversal_data.emitted_chunks = 0;
   traversal_data.storage_ptr = (ChunkDataEntry*)_data_texture->modify_ram_image().p();
   traversal_data.screen_size.set(scene->get_viewport_width(), scene->get_viewport_height());
+  traversal_data.frame = frame_count;
 
   // Move write pointer so it points to the beginning of the current view
   traversal_data.storage_ptr += _data_texture->get_x_size() * _current_view_index;
@@ -517,6 +637,12 @@ void ShaderTerrainMesh::add_for_draw(CullTraverser *trav, CullTraverserData &dat
     _lod_collector.start();
     do_traverse(&_base_chunk, &traversal_data);
     _lod_collector.stop();
+
+    if (_streaming) {
+      _streaming_collector.start();
+      do_request_tiles(&traversal_data);
+      _streaming_collector.stop();
+    }
   } else {
     // Do a rough guess of the emitted chunks, we don't know the actual count
     // (we would have to store it). This is only for debugging anyways, so
@@ -544,7 +670,33 @@ void ShaderTerrainMesh::add_for_draw(CullTraverser *trav, CullTraverserData &dat
   current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
     ShaderInput("ShaderTerrainMesh.data_texture", _data_texture));
   current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
-    ShaderInput("ShaderTerrainMesh.heightfield", _heightfield_tex));
+    ShaderInput("ShaderTerrainMesh.tiles_per_side", LVecBase2i(_tiles_per_side)));
+  current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+    ShaderInput("ShaderTerrainMesh.tile_size", LVecBase2i(_tile_size)));
+
+  if (_streaming) {
+    // The overview is bound as heightfield, so that shaders which don't know
+    // about streaming still render a coarse version of the terrain.
+    current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+      ShaderInput("ShaderTerrainMesh.heightfield", _overview_tex));
+    current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+      ShaderInput("ShaderTerrainMesh.tile_atlas", _atlas_tex));
+    current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+      ShaderInput("ShaderTerrainMesh.tile_table", _tile_table_tex));
+    current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+      ShaderInput("ShaderTerrainMesh.streaming", LVecBase2i(1)));
+  } else {
+    // Bind something to the streaming inputs as well, so that the same shader
+    // can be used for both modes.
+    current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+      ShaderInput("ShaderTerrainMesh.heightfield", _heightfield_tex));
+    current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+      ShaderInput("ShaderTerrainMesh.tile_atlas", _heightfield_tex));
+    current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+      ShaderInput("ShaderTerrainMesh.tile_table", _data_texture));
+    current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_shader_input(
+      ShaderInput("ShaderTerrainMesh.streaming", LVecBase2i(0)));
+  }
   current_shader_attrib = DCAST(ShaderAttrib, current_shader_attrib)->set_instance_count(
     traversal_data.emitted_chunks);
 
@@ -607,7 +759,20 @@ void ShaderTerrainMesh::do_traverse(Chunk* chunk, TraversalData* data, bool full
   // the chunk will never get subdivided.
   // NOTE: We still always perform the LOD check. This is for the reason that
   // the lod check also computes the CLOD factor, which is useful.
-  if (do_check_lod_matches(chunk, data) || chunk->size == _chunk_size) {
+  bool lod_matches = do_check_lod_matches(chunk, data);
+
+  // When streaming, a tile that needs more detail has to be loaded first.
+  // Until then, it is rendered as a single chunk.
+  if (_streaming && !lod_matches && chunk->size == _tile_size) {
+    size_t tile_index = (chunk->y / _tile_size) * _tiles_per_side + chunk->x / _tile_size;
+    Tile &tile = _tiles[tile_index];
+    tile.last_used = data->frame;
+    if (!tile.resident && tile.request == nullptr) {
+      data->wanted_tiles.push_back(tile_index);
+    }
+  }
+
+  if (lod_matches || chunk->children[0] == nullptr) {
     do_emit_chunk(chunk, data);
   } else {
     // Traverse children
@@ -672,6 +837,7 @@ bool ShaderTerrainMesh::do_check_lod_matches(Chunk* chunk, TraversalData* data)
 
   // Store the clod factor
   chunk->last_clod = clod_factor;
+  chunk->last_tesselation = tesselation_factor;
 
   return tesselation_factor <= 2.0;
 }
@@ -710,17 +876,21 @@ void ShaderTerrainMesh::do_emit_chunk(Chunk* chunk, TraversalData* data) {
  * @brief Transforms a texture coordinate to world space
  * @details This transforms a texture coordinatefrom uv-space (0 to 1) to world
  *   space. This takes the terrains transform into account, and also samples the
- *   heightmap. This method should be called after generate().
+ *   heightmap. This method should be called after generate(). When streaming,
+ *   the overview is sampled, so the result is only approximate.
  *
  * @param coord Coordinate in uv-space from 0, 0 to 1, 1
  * @return World-Space point
  */
 LPoint3 ShaderTerrainMesh::uv_to_world(const LTexCoord& coord) const {
   MutexHolder holder(_lock);
-  nassertr(_heightfield_tex != nullptr, LPoint3(0)); // Heightfield not set yet
-  nassertr(_heightfield_tex->has_ram_image(), LPoint3(0)); // Heightfield not in memory
 
-  PT(TexturePeeker) peeker = _heightfield_tex->peek();
+  // When streaming, only the overview is guaranteed to be in memory
+  Texture *heightfield_tex = _streaming ? _overview_tex.p() : _heightfield_tex.p();
+  nassertr(heightfield_tex != nullptr, LPoint3(0)); // Heightfield not set yet
+  nassertr(heightfield_tex->has_ram_image(), LPoint3(0)); // Heightfield not in memory
+
+  PT(TexturePeeker) peeker = heightfield_tex->peek();
   nassertr(peeker != nullptr, LPoint3(0));
 
   LColor result;
@@ -731,3 +901,490 @@ LPoint3 ShaderTerrainMesh::uv_to_world(const LTexCoord& coord) const {
   LPoint3 unit_point(coord.get_x(), coord.get_y(), result.get_x());
   return get_transform()->get_mat().xform_point_general(unit_point);
 }
+
+/**
+ * @brief Internal method to check the streaming heightfield
+ * @details This method checks the file set with set_streaming_heightfield(),
+ *   and derives the terrain size from its length. The same requirements apply
+ *   as for a regular heightfield.
+ *
+ * @return true if the file meets the requirements
+ */
+bool ShaderTerrainMesh::do_open_streaming_heightfield() {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  PT(VirtualFile) file = vfs->get_file(_stream_filename);
+  if (file == nullptr) {
+    shader_terrain_cat.error() << "Could not find " << _stream_filename << "!" << endl;
+    return false;
+  }
+
+  std::streamsize length = file->get_file_size();
+  size_t size = (size_t)(sqrt((double)(length / 2)) + 0.5);
+  if ((std::streamsize)(size * size * 2) != length) {
+    shader_terrain_cat.error() << "Streaming heightfield " << _stream_filename
+      << " is not a square raw 16-bit heightfield!" << endl;
+    return false;
+  }
+
+  _size = size;
+  if (_size < 32 || !check_power_of_two(_size)) {
+    shader_terrain_cat.error() << "Invalid heightfield! Needs to be >= 32 and a power of two (was: "
+         << _size << ")!" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Internal method to read the streaming heightfield
+ * @details This method reads the streaming heightfield once, row by row, so
+ *   that it never has to be in memory as a whole. While doing so, it computes
+ *   the average, min and max values and the edges of every tile, and generates
+ *   the overview texture by averaging blocks of pixels.
+ *
+ * @param in Stream to read the heightfield from
+ * @return true if the entire heightfield could be read
+ */
+bool ShaderTerrainMesh::do_scan_streaming_heightfield(std::istream &in) {
+
+  // Determine the overview size, it should be a power of two as well
+  size_t overview_size = min(_size, (size_t)max(stm_overview_size.get_value(), 1));
+  while (!check_power_of_two(overview_size)) {
+    overview_size &= overview_size - 1;
+  }
+  size_t step = _size / overview_size;
+
+  PTA_uchar overview_image = PTA_uchar::empty_array(overview_size * overview_size * sizeof(uint16_t));
+  uint16_t* overview = (uint16_t*)overview_image.p();
+  pvector<uint64_t> overview_row(overview_size, 0);
+
+  // Reset the tile heights
+  pvector<double> tile_sums(_tiles.size(), 0.0);
+  for (size_t i = 0; i < _tiles.size(); ++i) {
+    _tiles[i].chunk->min_height = 1.0;
+    _tiles[i].chunk->max_height = 0.0;
+  }
+
+  const PN_stdfloat scale = 1.0 / (PN_stdfloat)65535;
+  pvector<unsigned char> buffer(_size * 2);
+
+  // The rows are stored from top to bottom, so the first row is the one with
+  // the highest y coordinate
+  for (size_t row = 0; row < _size; ++row) {
+    in.read((char*)&buffer[0], buffer.size());
+    if (in.gcount() != (std::streamsize)buffer.size()) {
+      shader_terrain_cat.error() << "Unexpected end of file while reading "
+        << _stream_filename << "!" << endl;
+      return false;
+    }
+
+    size_t y = _size - 1 - row;
+    size_t tile_y = y / _tile_size;
+    size_t local_y = y % _tile_size;
+
+    for (size_t tile_x = 0; tile_x < _tiles_per_side; ++tile_x) {
+      size_t tile_index = tile_y * _tiles_per_side + tile_x;
+      Chunk* chunk = _tiles[tile_index].chunk;
+
+      uint32_t row_sum = 0;
+      uint16_t row_min = 65535, row_max = 0;
+      for (size_t x = tile_x * _tile_size; x < (tile_x + 1) * _tile_size; ++x) {
+        uint16_t value = buffer[x * 2] | (buffer[x * 2 + 1] << 8);
+        row_sum += value;
+        row_min = min(row_min, value);
+        row_max = max(row_max, value);
+        overview_row[x / step] += value;
+      }
+
+      tile_sums[tile_index] += row_sum;
+      chunk->min_height = min(chunk->min_height, row_min * scale);
+      chunk->max_height = max(chunk->max_height, row_max * scale);
+
+      // Get edges in the order (0, 0) (1, 0) (0, 1) (1, 1)
+      if (local_y == 0 || local_y == _tile_size - 1) {
+        size_t cell = (local_y == 0) ? 0 : 2;
+        size_t x0 = tile_x * _tile_size;
+        size_t x1 = x0 + _tile_size - 1;
+        chunk->edges.set_cell(cell, (buffer[x0 * 2] | (buffer[x0 * 2 + 1] << 8)) * scale);
+        chunk->edges.set_cell(cell + 1, (buffer[x1 * 2] | (buffer[x1 * 2 + 1] << 8)) * scale);
+      }
+    }
+
+    // This was the last row of a row of overview pixels
+    if (y % step == 0) {
+      uint16_t* overview_ptr = overview + (y / step) * overview_size;
+      for (size_t x = 0; x < overview_size; ++x) {
+        overview_ptr[x] = (uint16_t)((overview_row[x] + step * step / 2) / (step * step));
+        overview_row[x] = 0;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < _tiles.size(); ++i) {
+    _tiles[i].chunk->avg_height = tile_sums[i] / (_tile_size * _tile_size) * scale;
+  }
+
+  _overview_tex = new Texture("TerrainOverview");
+  _overview_tex->setup_2d_texture(overview_size, overview_size, Texture::T_unsigned_short, Texture::F_r16);
+  _overview_tex->set_compression(Texture::CM_off);
+  _overview_tex->set_minfilter(stm_heightfield_minfilter);
+  _overview_tex->set_magfilter(stm_heightfield_magfilter);
+  _overview_tex->set_wrap_u(SamplerState::WM_clamp);
+  _overview_tex->set_wrap_v(SamplerState::WM_clamp);
+  _overview_tex->set_ram_image(overview_image);
+  return true;
+}
+
+/**
+ * @brief Internal method to init the streaming textures
+ * @details This method creates the tile atlas, which holds the loaded tiles,
+ *   and the tile table, which stores for every tile where it is located in the
+ *   atlas, and whether it is loaded at all.
+ *
+ *   The atlas is made as large as the streaming budget permits. Every slot in
+ *   the atlas holds a tile with a border of one pixel, so that filtering at
+ *   the tile borders works as expected.
+ */
+void ShaderTerrainMesh::do_init_streaming_textures() {
+  size_t slot_texels = _tile_size + 2;
+  size_t slot_bytes = slot_texels * slot_texels * sizeof(uint16_t);
+
+  _slots_per_side = (size_t)sqrt((double)(_streaming_budget / slot_bytes));
+  _slots_per_side = min(_slots_per_side, _tiles_per_side);
+  if (_slots_per_side == 0) {
+    shader_terrain_cat.warning() << "Streaming budget too small to load a single tile!" << endl;
+    _slots_per_side = 1;
+  }
+
+  // Hand out the first slots first
+  size_t num_slots = _slots_per_side * _slots_per_side;
+  _free_slots.reserve(num_slots);
+  for (size_t i = num_slots; i > 0; --i) {
+    _free_slots.push_back((int)(i - 1));
+  }
+
+  // Mipmaps would bleed between the tiles
+  SamplerState::FilterType minfilter = stm_heightfield_minfilter;
+  if (SamplerState::is_mipmap(minfilter)) {
+    minfilter = SamplerState::FT_linear;
+  }
+
+  size_t atlas_size = _slots_per_side * slot_texels;
+  _atlas_tex = new Texture("TerrainTileAtlas");
+  _atlas_tex->setup_2d_texture(atlas_size, atlas_size, Texture::T_unsigned_short, Texture::F_r16);
+  _atlas_tex->set_compression(Texture::CM_off);
+  _atlas_tex->set_minfilter(minfilter);
+  _atlas_tex->set_magfilter(stm_heightfield_magfilter);
+  _atlas_tex->set_wrap_u(SamplerState::WM_clamp);
+  _atlas_tex->set_wrap_v(SamplerState::WM_clamp);
+  _atlas_tex->set_clear_color(LVector4(0));
+  _atlas_tex->clear_image();
+
+  _tile_table_tex = new Texture("TerrainTileTable");
+  _tile_table_tex->setup_2d_texture(_tiles_per_side, _tiles_per_side, Texture::T_float, Texture::F_rgba32);
+  _tile_table_tex->set_compression(Texture::CM_off);
+  _tile_table_tex->set_minfilter(SamplerState::FT_nearest);
+  _tile_table_tex->set_magfilter(SamplerState::FT_nearest);
+  _tile_table_tex->set_clear_color(LVector4(0));
+  _tile_table_tex->clear_image();
+
+  // Tiles are loaded on their own task chain, so that they don't hold up
+  // anything else
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  if (task_mgr->find_task_chain("shaderterrain") == nullptr) {
+    PT(AsyncTaskChain) chain = task_mgr->make_task_chain("shaderterrain");
+    chain->set_num_threads(max(stm_streaming_threads.get_value(), 1));
+    chain->set_thread_priority(TP_low);
+  }
+}
+
+/**
+ * @brief Recursively computes the bounds for the chunks of a tile
+ * @details This method works like do_compute_bounds(), except that the
+ *   heights are taken from the pixels of a loaded tile.
+ *
+ * @param chunk The parent chunk, which has to lie within the tile
+ * @param pixels Pixels of the tile, as read by a TileRequest
+ */
+void ShaderTerrainMesh::do_compute_tile_bounds(Chunk* chunk, const uint16_t* pixels) {
+
+  if (chunk->children[0] != nullptr) {
+    for (size_t i = 0; i < 4; ++i) {
+      do_compute_tile_bounds(chunk->children[i], pixels);
+    }
+    do_merge_bounds(chunk);
+    return;
+  }
+
+  // The pixels start one pixel before the tile origin, because of the border
+  size_t tile_x = chunk->x - chunk->x % _tile_size;
+  size_t tile_y = chunk->y - chunk->y % _tile_size;
+  size_t stride = _tile_size + 2;
+  #define get_xel(x, y) (pixels[((y) - tile_y + 1) * stride + (x) - tile_x + 1] / (PN_stdfloat)65535)
+
+  // Iterate over all pixels
+  PN_stdfloat avg_height = 0.0, min_height = 1.0, max_height = 0.0;
+  for (size_t x = 0; x < chunk->size; ++x) {
+    for (size_t y = 0; y < chunk->size; ++y) {
+      PN_stdfloat height = get_xel(chunk->x + x, chunk->y + y);
+      avg_height += height;
+      min_height = min(min_height, height);
+      max_height = max(max_height, height);
+    }
+  }
+
+  chunk->min_height = min_height;
+  chunk->max_height = max_height;
+  chunk->avg_height = avg_height / (chunk->size * chunk->size);
+
+  // Get edges in the order (0, 0) (1, 0) (0, 1) (1, 1)
+  for (size_t y = 0; y < 2; ++y) {
+    for (size_t x = 0; x < 2; ++x) {
+      chunk->edges.set_cell(x + 2 * y, get_xel(
+          chunk->x + x * (chunk->size - 1),
+          chunk->y + y * (chunk->size - 1)
+        ));
+    }
+  }
+
+  #undef get_xel
+}
+
+/**
+ * @brief Internal method to take over loaded tiles
+ * @details This method checks which of the pending tile requests are done, and
+ *   copies their pixels into the atlas. The chunks within those tiles are then
+ *   created, so that the traversal can descend into them.
+ *
+ *   Since textures can only be updated as a whole, the atlas is uploaded again
+ *   in any frame in which a tile was loaded.
+ */
+void ShaderTerrainMesh::do_finish_tile_requests() {
+  uint16_t* atlas = nullptr;
+  PN_float32* table = nullptr;
+  size_t atlas_size = _slots_per_side * (_tile_size + 2);
+  size_t slot_texels = _tile_size + 2;
+
+  size_t i = 0;
+  while (i < _pending_tiles.size()) {
+    size_t tile_index = _pending_tiles[i];
+    Tile &tile = _tiles[tile_index];
+    if (!tile.request->done()) {
+      ++i;
+      continue;
+    }
+
+    PT(TileRequest) request = tile.request;
+    tile.request = nullptr;
+    _pending_tiles[i] = _pending_tiles.back();
+    _pending_tiles.pop_back();
+
+    if (request->_pixels.empty()) {
+      // The tile could not be read, give back the slot
+      _free_slots.push_back(tile.slot);
+      tile.slot = -1;
+      continue;
+    }
+
+    if (atlas == nullptr) {
+      atlas = (uint16_t*)_atlas_tex->modify_ram_image().p();
+      table = (PN_float32*)_tile_table_tex->modify_ram_image().p();
+    }
+
+    // Copy the tile into its slot
+    size_t slot_x = (tile.slot % _slots_per_side) * slot_texels;
+    size_t slot_y = (tile.slot / _slots_per_side) * slot_texels;
+    for (size_t y = 0; y < slot_texels; ++y) {
+      memcpy(atlas + (slot_y + y) * atlas_size + slot_x,
+             &request->_pixels[y * slot_texels], slot_texels * sizeof(uint16_t));
+    }
+
+    // Panda uses BGRA, so this makes the entry read as (x, y, resident, 0)
+    PN_float32* entry = table + tile_index * 4;
+    entry[0] = 1.0f;
+    entry[1] = (PN_float32)slot_y;
+    entry[2] = (PN_float32)slot_x;
+    entry[3] = 0.0f;
+
+    // Now the tile can be subdivided further
+    do_init_chunk(tile.chunk, _chunk_size);
+    do_compute_tile_bounds(tile.chunk, &request->_pixels[0]);
+    tile.resident = true;
+    ++_num_resident_tiles;
+  }
+}
+
+/**
+ * @brief Internal method to request tiles
+ * @details This method starts loading the tiles that the traversal found to
+ *   be missing, starting with the ones that need the most detail. If the
+ *   atlas is full, the least recently used tiles are evicted, but never any
+ *   tile that was needed in the current frame.
+ *
+ * @param data Traversal data
+ */
+void ShaderTerrainMesh::do_request_tiles(TraversalData* data) {
+  if (data->wanted_tiles.empty()) {
+    return;
+  }
+
+  pvector<std::pair<PN_stdfloat, size_t> > wanted;
+  wanted.reserve(data->wanted_tiles.size());
+  for (size_t i = 0; i < data->wanted_tiles.size(); ++i) {
+    size_t tile_index = data->wanted_tiles[i];
+    wanted.push_back(std::make_pair(_tiles[tile_index].chunk->last_tesselation, tile_index));
+  }
+  std::sort(wanted.begin(), wanted.end(), std::greater<std::pair<PN_stdfloat, size_t> >());
+
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  for (size_t i = 0; i < wanted.size() && _pending_tiles.size() < (size_t)max_pending_tiles; ++i) {
+    size_t tile_index = wanted[i].second;
+    Tile &tile = _tiles[tile_index];
+    if (tile.slot >= 0) {
+      // Already requested, by a different view
+      continue;
+    }
+
+    if (_free_slots.empty()) {
+      size_t lru_index = _tiles.size();
+      int lru_frame = data->frame;
+      for (size_t j = 0; j < _tiles.size(); ++j) {
+        if (_tiles[j].resident && _tiles[j].last_used < lru_frame) {
+          lru_index = j;
+          lru_frame = _tiles[j].last_used;
+        }
+      }
+      if (lru_index == _tiles.size()) {
+        // All loaded tiles are in use
+        break;
+      }
+      do_evict_tile(lru_index);
+    }
+
+    tile.slot = _free_slots.back();
+    _free_slots.pop_back();
+    tile.request = new TileRequest(_stream_filename, _size, tile.chunk->x,
+                                   tile.chunk->y, _tile_size);
+    tile.request->set_task_chain("shaderterrain");
+    task_mgr->add(tile.request);
+    _pending_tiles.push_back(tile_index);
+  }
+}
+
+/**
+ * @brief Internal method to evict a tile
+ * @details This method removes a tile from the atlas, deleting the chunks
+ *   within it, and makes its slot available again.
+ *
+ * @param tile_index Index of the tile to evict
+ */
+void ShaderTerrainMesh::do_evict_tile(size_t tile_index) {
+  Tile &tile = _tiles[tile_index];
+  nassertv(tile.resident);
+
+  tile.chunk->clear_children();
+
+  PN_float32* table = (PN_float32*)_tile_table_tex->modify_ram_image().p();
+  table[tile_index * 4] = 0.0f;
+
+  _free_slots.push_back(tile.slot);
+  tile.slot = -1;
+  tile.resident = false;
+  --_num_resident_tiles;
+}
+
+/**
+ * @brief Internal method to release all streaming data
+ * @details This method stops all pending tile requests and releases the
+ *   streaming textures. It does not touch the chunks.
+ */
+void ShaderTerrainMesh::do_clear_streaming() {
+  for (size_t i = 0; i < _pending_tiles.size(); ++i) {
+    _tiles[_pending_tiles[i]].request->remove();
+  }
+  _pending_tiles.clear();
+  _tiles.clear();
+  _free_slots.clear();
+  _tiles_per_side = 0;
+  _slots_per_side = 0;
+  _num_resident_tiles = 0;
+  _overview_tex = nullptr;
+  _atlas_tex = nullptr;
+  _tile_table_tex = nullptr;
+  _streaming = false;
+}
+
+/**
+ * @brief Constructs a new tile request
+ * @details This constructs a request to read the tile at the given position
+ *   from the given heightfield.
+ */
+ShaderTerrainMesh::TileRequest::TileRequest(const Filename &filename, size_t size,
+                                            size_t x, size_t y, size_t tile_size) :
+  AsyncTask("ShaderTerrainMesh tile"),
+  _filename(filename),
+  _size(size),
+  _x(x),
+  _y(y),
+  _tile_size(tile_size)
+{
+}
+
+/**
+ * @brief Reads the tile
+ * @details This reads the pixels of the tile, including a border of one pixel.
+ *   At the edges of the terrain, the border repeats the outermost pixels. If
+ *   the tile could not be read, the pixels are left empty.
+ */
+AsyncTask::DoneStatus ShaderTerrainMesh::TileRequest::do_task() {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  std::istream *in = vfs->open_read_file(_filename, false);
+  if (in == nullptr) {
+    shader_terrain_cat.error() << "Could not open " << _filename << "!" << endl;
+    return DS_done;
+  }
+
+  size_t stride = _tile_size + 2;
+  pvector<uint16_t> pixels(stride * stride);
+
+  // Range of columns to read, clamped to the heightfield
+  size_t x0 = (_x > 0) ? _x - 1 : 0;
+  size_t x1 = min(_x + _tile_size, _size - 1);
+  size_t offset = (_x > 0) ? 0 : 1;
+  pvector<unsigned char> buffer((x1 - x0 + 1) * 2);
+
+  bool success = true;
+  for (size_t j = 0; j < stride && success; ++j) {
+    // The rows are stored from top to bottom
+    int y = max(0, min((int)_size - 1, (int)_y - 1 + (int)j));
+    std::streamoff pos = ((std::streamoff)(_size - 1 - y) * _size + x0) * 2;
+    in->seekg(pos);
+    in->read((char*)&buffer[0], buffer.size());
+    if (in->gcount() != (std::streamsize)buffer.size()) {
+      success = false;
+      break;
+    }
+
+    uint16_t* row = &pixels[j * stride];
+    for (size_t i = 0; i < x1 - x0 + 1; ++i) {
+      row[offset + i] = buffer[i * 2] | (buffer[i * 2 + 1] << 8);
+    }
+    if (_x == 0) {
+      row[0] = row[1];
+    }
+    if (_x + _tile_size == _size) {
+      row[stride - 1] = row[stride - 2];
+    }
+  }
+  vfs->close_read_file(in);
+
+  if (!success) {
+    shader_terrain_cat.error() << "Could not read tile at (" << _x << ", " << _y
+      << ") from " << _filename << "!" << endl;
+    return DS_done;
+  }
+
+  _pixels.swap(pixels);
+  return DS_done;
+}
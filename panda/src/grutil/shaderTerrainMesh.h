@@ -27,11 +27,17 @@
 #include "filename.h"
 #include "pmutex.h"
 #include "mutexHolder.h"
+#include "asyncTask.h"
+#include "pvector.h"
 #include <stdint.h>
 
 extern ConfigVariableBool stm_use_hexagonal_layout;
 extern ConfigVariableInt stm_max_chunk_count;
 extern ConfigVariableInt stm_max_views;
+extern ConfigVariableInt stm_tile_size;
+extern ConfigVariableInt stm_streaming_budget;
+extern ConfigVariableInt stm_overview_size;
+extern ConfigVariableInt stm_streaming_threads;
 
 
 NotifyCategoryDecl(shader_terrain, EXPCL_PANDA_GRUTIL, EXPTP_PANDA_GRUTIL);
@@ -77,6 +83,22 @@ PUBLISHED:
   INLINE PN_stdfloat get_target_triangle_width() const;
   MAKE_PROPERTY(target_triangle_width, get_target_triangle_width, set_target_triangle_width);
 
+  INLINE void set_streaming_heightfield(const Filename &filename);
+  INLINE const Filename &get_streaming_heightfield() const;
+  INLINE bool is_streaming() const;
+  MAKE_PROPERTY(streaming_heightfield, get_streaming_heightfield, set_streaming_heightfield);
+
+  INLINE void set_tile_size(size_t tile_size);
+  INLINE size_t get_tile_size() const;
+  MAKE_PROPERTY(tile_size, get_tile_size, set_tile_size);
+
+  INLINE void set_streaming_budget(size_t streaming_budget);
+  INLINE size_t get_streaming_budget() const;
+  MAKE_PROPERTY(streaming_budget, get_streaming_budget, set_streaming_budget);
+
+  INLINE int get_num_resident_tiles() const;
+  INLINE int get_max_resident_tiles() const;
+
   LPoint3 uv_to_world(const LTexCoord& coord) const;
   INLINE LPoint3 uv_to_world(PN_stdfloat u, PN_stdfloat v) const;
 
@@ -115,6 +137,9 @@ private:
     // Last CLOD factor, stored while computing LOD, used for seamless transitions between lods
     PN_stdfloat last_clod;
 
+    // Last tesselation factor, used to decide which tiles to stream in first
+    PN_stdfloat last_tesselation;
+
     INLINE void clear_children();
     INLINE Chunk();
     INLINE ~Chunk();
@@ -149,19 +174,72 @@ private:
 
     // Pointer to the texture memory, where each chunk is written to
     ChunkDataEntry* storage_ptr;
+
+    // Streaming only: current frame, and the tiles that need to be loaded
+    // to render the terrain at the desired detail
+    int frame;
+    pvector<size_t> wanted_tiles;
+  };
+
+  // Streaming only: a request to read one tile from the heightfield file,
+  // including a border of one pixel on each side.  The pixels are stored
+  // bottom row first, like in a texture.
+  class TileRequest : public AsyncTask {
+  public:
+    TileRequest(const Filename &filename, size_t size, size_t x, size_t y,
+                size_t tile_size);
+    ALLOC_DELETED_CHAIN(TileRequest);
+
+    virtual DoneStatus do_task();
+
+    Filename _filename;
+    size_t _size;
+    size_t _x, _y;
+    size_t _tile_size;
+    pvector<uint16_t> _pixels;
+  };
+
+  // Streaming only: the state of a single tile
+  struct Tile {
+    // Chunk covering this tile.  Its children exist only while the tile is
+    // resident.
+    Chunk* chunk;
+
+    // Slot in the atlas, or -1 if the tile is neither resident nor loading
+    int slot;
+
+    // Whether the tile data is in the atlas
+    bool resident;
+
+    // Frame in which the tile was last needed
+    int last_used;
+
+    PT(TileRequest) request;
+
+    INLINE Tile();
   };
 
   bool do_check_heightfield();
   void do_extract_heightfield();
   void do_init_data_texture();
   void do_create_chunks();
-  void do_init_chunk(Chunk* chunk);
+  void do_init_chunk(Chunk* chunk, size_t leaf_size);
   void do_compute_bounds(Chunk* chunk);
+  void do_merge_bounds(Chunk* chunk);
   void do_create_chunk_geom();
   void do_traverse(Chunk* chunk, TraversalData* data, bool fully_visible = false);
   void do_emit_chunk(Chunk* chunk, TraversalData* data);
   bool do_check_lod_matches(Chunk* chunk, TraversalData* data);
 
+  bool do_open_streaming_heightfield();
+  bool do_scan_streaming_heightfield(std::istream &in);
+  void do_init_streaming_textures();
+  void do_compute_tile_bounds(Chunk* chunk, const uint16_t* pixels);
+  void do_finish_tile_requests();
+  void do_request_tiles(TraversalData* data);
+  void do_evict_tile(size_t tile_index);
+  void do_clear_streaming();
+
   Mutex _lock;
   Chunk _base_chunk;
   size_t _size;
@@ -176,9 +254,28 @@ private:
   PN_stdfloat _target_triangle_width;
   bool _update_enabled;
 
+  // Streaming mode
+  Filename _stream_filename;
+  bool _streaming;
+  size_t _tile_size;
+  size_t _streaming_budget;
+  size_t _tiles_per_side;
+  size_t _slots_per_side;
+  int _num_resident_tiles;
+  pvector<Tile> _tiles;
+  pvector<int> _free_slots;
+  pvector<size_t> _pending_tiles;
+  PT(Texture) _overview_tex;
+  PT(Texture) _atlas_tex;
+  PT(Texture) _tile_table_tex;
+
+  // The number of tile loads that may be in flight at once
+  static const int max_pending_tiles = 8;
+
   // PStats stuff
   static PStatCollector _lod_collector;
   static PStatCollector _basic_collector;
+  static PStatCollector _streaming_collector;
 
 
 // Type handle stuff
@@ -146,6 +146,35 @@ ConfigVariableEnum<ThreadPriority> net_thread_priority
  PRC_DESC("The default thread priority when creating threaded readers "
           "or writers."));
 
+ConfigVariableBool net_use_epoll
+("net-use-epoll", true,
+ PRC_DESC("On Linux, set this true to have each ConnectionReader wait for "
+          "activity with epoll rather than select().  Each reader thread "
+          "then waits on its own share of the sockets, and there is no "
+          "limit on the number of sockets that may be monitored.  This has "
+          "no effect on other platforms."));
+
+ConfigVariableBool net_batch_io
+("net-batch-io", true,
+ PRC_DESC("On Linux, set this true to have ConnectionReader receive UDP "
+          "datagrams with recvmmsg(), and threaded ConnectionWriters send "
+          "the datagrams waiting in their queue with sendmmsg() (UDP) or "
+          "writev() (TCP), so that many datagrams are transferred with a "
+          "single system call.  This has no effect on other platforms."));
+
+ConfigVariableInt net_batch_size
+("net-batch-size", 32,
+ PRC_DESC("The maximum number of datagrams transferred by a single system "
+          "call when net-batch-io is in effect.  This is clamped to the "
+          "range 1 to 64."));
+
+ConfigVariableInt net_datagram_pool_size
+("net-datagram-pool-size", 256,
+ PRC_DESC("The number of data buffers each ConnectionReader keeps for "
+          "reuse by incoming UDP datagrams.  A buffer is recycled once the "
+          "application has released every datagram that used it.  Set "
+          "this to 0 to allocate a new buffer for each datagram."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
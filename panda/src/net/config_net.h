@@ -37,6 +37,14 @@ extern ConfigVariableInt net_max_read_per_epoch;
 extern ConfigVariableInt net_max_write_per_epoch;
 
 extern ConfigVariableEnum<ThreadPriority> net_thread_priority;
+extern ConfigVariableBool net_use_epoll;
+extern ConfigVariableBool net_batch_io;
+extern ConfigVariableInt net_batch_size;
+extern ConfigVariableInt net_datagram_pool_size;
+
+// The upper limit on net-batch-size.  This determines the size of the arrays
+// that are set up on the stack for each batched system call.
+static const int max_net_batch_size = 64;
 
 extern EXPCL_PANDA_NET void init_libnet();
 
@@ -26,6 +26,12 @@
 #include "socket_udp.h"
 #include "dcast.h"
 
+#ifdef IS_LINUX
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <errno.h>
+#endif
+
 
 /**
  * Creates a connection.  Normally this constructor should not be used
@@ -409,6 +415,250 @@ send_raw_datagram(const NetDatagram &datagram) {
   return true;
 }
 
+/**
+ * This method is intended only to be called by ConnectionWriter.  It writes
+ * the indicated datagrams, in order, to the socket, as if by calling
+ * send_datagram() or send_raw_datagram() on each one, returning true if they
+ * were all sent successfully.
+ *
+ * On Linux, when net-batch-io is in effect, UDP datagrams are written with a
+ * single call to sendmmsg(), and TCP datagrams with a single call to
+ * writev(), unless collect-tcp is in effect for this connection.
+ */
+bool Connection::
+send_datagram_batch(const NetDatagram *datagrams, size_t num_datagrams,
+                    bool raw_mode, int tcp_header_size) {
+  nassertr(_socket != nullptr, false);
+
+#if defined(IS_LINUX) && !(defined(HAVE_THREADS) && defined(SIMPLE_THREADS))
+  // With SIMPLE_THREADS, the socket is non-blocking; we leave that case to
+  // the ordinary loop, which knows how to yield while waiting.
+  if (net_batch_io && num_datagrams > 1) {
+    if (_socket->is_exact_type(Socket_UDP::get_class_type())) {
+      return send_udp_batch(datagrams, num_datagrams, raw_mode);
+    }
+
+    bool can_batch = !_collect_tcp;
+    if (!raw_mode && tcp_header_size == 2) {
+      // Let send_datagram() report any datagram that is too long.
+      for (size_t i = 0; i < num_datagrams && can_batch; ++i) {
+        can_batch = (datagrams[i].get_length() < 0x10000);
+      }
+    }
+    if (can_batch) {
+      return send_tcp_batch(datagrams, num_datagrams, raw_mode, tcp_header_size);
+    }
+  }
+#endif
+
+  bool okflag = true;
+  for (size_t i = 0; i < num_datagrams; ++i) {
+    if (raw_mode) {
+      okflag = send_raw_datagram(datagrams[i]) && okflag;
+    } else {
+      okflag = send_datagram(datagrams[i], tcp_header_size) && okflag;
+    }
+  }
+  return okflag;
+}
+
+#ifdef IS_LINUX
+/**
+ * The implementation of send_datagram_batch() for a UDP socket.  Sends the
+ * datagrams with sendmmsg(), up to net-batch-size at a time.
+ */
+bool Connection::
+send_udp_batch(const NetDatagram *datagrams, size_t num_datagrams,
+               bool raw_mode) {
+  int fd = _socket->GetSocket();
+  size_t batch_size = (size_t)std::max(std::min((int)net_batch_size, max_net_batch_size), 1);
+
+  // Each message is gathered from the header and the datagram itself, so we
+  // don't have to copy the datagram to put the header in front of it.
+  unsigned char headers[max_net_batch_size][datagram_udp_header_size];
+  struct iovec iovs[max_net_batch_size][2];
+  struct mmsghdr msgs[max_net_batch_size];
+
+  LightReMutexHolder holder(_write_mutex);
+
+  bool okflag = true;
+  size_t total_bytes = 0;
+  size_t start = 0;
+  while (okflag && start < num_datagrams) {
+    size_t count = std::min(batch_size, num_datagrams - start);
+    for (size_t i = 0; i < count; ++i) {
+      const NetDatagram &datagram = datagrams[start + i];
+
+      struct msghdr &hdr = msgs[i].msg_hdr;
+      int num_iovs = 0;
+      if (!raw_mode) {
+        DatagramUDPHeader header(datagram);
+        if (net_cat.is_debug()) {
+          header.verify_datagram(datagram);
+        }
+        std::string header_data = header.get_header();
+        nassertr(header_data.size() == datagram_udp_header_size, false);
+        memcpy(headers[i], header_data.data(), datagram_udp_header_size);
+        iovs[i][num_iovs].iov_base = headers[i];
+        iovs[i][num_iovs].iov_len = datagram_udp_header_size;
+        ++num_iovs;
+      }
+      iovs[i][num_iovs].iov_base = (void *)datagram.get_data();
+      iovs[i][num_iovs].iov_len = datagram.get_length();
+      ++num_iovs;
+
+      const sockaddr &addr = datagram.get_address().get_addr().GetAddressInfo();
+      hdr.msg_name = (void *)&addr;
+      hdr.msg_namelen = SA_SIZEOF(&addr);
+      hdr.msg_iov = iovs[i];
+      hdr.msg_iovlen = num_iovs;
+      hdr.msg_control = nullptr;
+      hdr.msg_controllen = 0;
+      hdr.msg_flags = 0;
+      msgs[i].msg_len = 0;
+    }
+
+    // sendmmsg() may stop short, in which case we carry on from the first
+    // message that wasn't sent.  If that message fails outright, it returns
+    // an error.
+    size_t sent = 0;
+    while (sent < count) {
+      int result = sendmmsg(fd, msgs + sent, count - sent, 0);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        okflag = false;
+        break;
+      }
+      for (int i = 0; i < result; ++i) {
+        total_bytes += msgs[sent + i].msg_len;
+      }
+      sent += result;
+    }
+    start += sent;
+  }
+
+  if (net_cat.is_spam()) {
+    net_cat.spam()
+      << "Sent " << start << " UDP datagram(s) with "
+      << total_bytes << " total bytes to " << (void *)this
+      << ", ok = " << okflag << "\n";
+  }
+
+  return check_send_error(okflag);
+}
+
+/**
+ * The implementation of send_datagram_batch() for a TCP socket.  Writes any
+ * data already queued on the connection, followed by the datagrams, with
+ * writev(), so that small datagrams are coalesced into as few packets as
+ * possible without first being copied into one buffer.
+ */
+bool Connection::
+send_tcp_batch(const NetDatagram *datagrams, size_t num_datagrams,
+               bool raw_mode, int tcp_header_size) {
+  Socket_TCP *tcp;
+  DCAST_INTO_R(tcp, _socket, false);
+  int fd = tcp->GetSocket();
+  size_t batch_size = (size_t)std::max(std::min((int)net_batch_size, max_net_batch_size), 1);
+
+  unsigned char headers[max_net_batch_size][datagram_tcp32_header_size];
+  struct iovec iovs[max_net_batch_size * 2 + 1];
+
+  LightReMutexHolder holder(_write_mutex);
+
+  // Anything previously queued by send_datagram() must go out first.
+  std::string queued_data;
+  _queued_data.swap(queued_data);
+  _queued_count = 0;
+  _queued_data_start = TrueClock::get_global_ptr()->get_short_time();
+
+  bool okflag = true;
+  size_t total_bytes = 0;
+  size_t start = 0;
+  while (okflag && start < num_datagrams) {
+    size_t count = std::min(batch_size, num_datagrams - start);
+    int num_iovs = 0;
+    size_t bytes_to_send = 0;
+
+    if (!queued_data.empty()) {
+      iovs[num_iovs].iov_base = (void *)queued_data.data();
+      iovs[num_iovs].iov_len = queued_data.size();
+      bytes_to_send += queued_data.size();
+      ++num_iovs;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      const NetDatagram &datagram = datagrams[start + i];
+
+      if (!raw_mode && tcp_header_size != 0) {
+        DatagramTCPHeader header(datagram, tcp_header_size);
+        if (net_cat.is_debug()) {
+          header.verify_datagram(datagram, tcp_header_size);
+        }
+        std::string header_data = header.get_header();
+        nassertr(header_data.size() == (size_t)tcp_header_size, false);
+        memcpy(headers[i], header_data.data(), tcp_header_size);
+        iovs[num_iovs].iov_base = headers[i];
+        iovs[num_iovs].iov_len = tcp_header_size;
+        bytes_to_send += tcp_header_size;
+        ++num_iovs;
+      }
+      if (datagram.get_length() != 0) {
+        iovs[num_iovs].iov_base = (void *)datagram.get_data();
+        iovs[num_iovs].iov_len = datagram.get_length();
+        bytes_to_send += datagram.get_length();
+        ++num_iovs;
+      }
+    }
+
+    // A blocking socket may still accept less than everything; in that case
+    // we advance past whatever was written and go around again.
+    struct iovec *iov = iovs;
+    while (bytes_to_send > 0) {
+      ssize_t result = writev(fd, iov, num_iovs);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        okflag = false;
+        break;
+      }
+      if (result == 0) {
+        okflag = false;
+        break;
+      }
+
+      size_t written = (size_t)result;
+      bytes_to_send -= written;
+      total_bytes += written;
+      while (num_iovs > 0 && written >= iov->iov_len) {
+        written -= iov->iov_len;
+        ++iov;
+        --num_iovs;
+      }
+      if (written > 0) {
+        iov->iov_base = (char *)iov->iov_base + written;
+        iov->iov_len -= written;
+      }
+    }
+
+    queued_data.clear();
+    start += count;
+  }
+
+  if (net_cat.is_spam()) {
+    net_cat.spam()
+      << "Sent " << num_datagrams << " TCP datagram(s) with "
+      << total_bytes << " total bytes to " << (void *)this
+      << ", ok = " << okflag << "\n";
+  }
+
+  return check_send_error(okflag);
+}
+#endif  // IS_LINUX
+
 /**
  * The private implementation of flush(), this assumes the _write_mutex is
  * already held.
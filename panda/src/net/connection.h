@@ -58,6 +58,14 @@ PUBLISHED:
 private:
   bool send_datagram(const NetDatagram &datagram, int tcp_header_size);
   bool send_raw_datagram(const NetDatagram &datagram);
+  bool send_datagram_batch(const NetDatagram *datagrams, size_t num_datagrams,
+                           bool raw_mode, int tcp_header_size);
+#ifdef IS_LINUX
+  bool send_udp_batch(const NetDatagram *datagrams, size_t num_datagrams,
+                      bool raw_mode);
+  bool send_tcp_batch(const NetDatagram *datagrams, size_t num_datagrams,
+                      bool raw_mode, int tcp_header_size);
+#endif
   bool do_flush();
   bool check_send_error(bool okflag);
 
@@ -33,6 +33,10 @@
 #include <ifaddrs.h>
 #endif
 
+#ifdef IS_LINUX
+#include <poll.h>
+#endif
+
 using std::stringstream;
 using std::string;
 
@@ -253,9 +257,18 @@ open_TCP_client_connection(const NetAddress &address, int timeout_ms) {
     TrueClock *clock = TrueClock::get_global_ptr();
     double start = clock->get_short_time();
     Thread::force_yield();
+#ifdef IS_LINUX
+    // poll() has no limit on the descriptor number, unlike select(); a
+    // server with an epoll-based reader may have thousands open.
+    struct pollfd pfd;
+    pfd.fd = socket->GetSocket();
+    pfd.events = POLLOUT;
+    int ready = ::poll(&pfd, 1, 0);
+#else
     Socket_fdset fset;
     fset.setForSocket(*socket);
     int ready = fset.WaitForWrite(true, 0);
+#endif
     while (ready == 0) {
       double elapsed = clock->get_short_time() - start;
       if (elapsed * 1000.0 > timeout_ms) {
@@ -264,8 +277,12 @@ open_TCP_client_connection(const NetAddress &address, int timeout_ms) {
         break;
       }
       Thread::force_yield();
+#ifdef IS_LINUX
+      ready = ::poll(&pfd, 1, 0);
+#else
       fset.setForSocket(*socket);
       ready = fset.WaitForWrite(true, 0);
+#endif
     }
   }
 
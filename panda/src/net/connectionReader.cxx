@@ -27,10 +27,23 @@
 #include "atomicAdjust.h"
 #include "config_downloader.h"
 
+#ifdef IS_LINUX
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
 using std::min;
 
 static const int read_buffer_size = maximum_udp_datagram + datagram_udp_header_size;
 
+#ifdef IS_LINUX
+// The maximum number of events collected by a single call to epoll_wait().
+static const int max_epoll_events = 256;
+#endif
+
 /**
  *
  */
@@ -40,6 +53,10 @@ SocketInfo(const PT(Connection) &connection) :
 {
   _busy = false;
   _error = false;
+#ifdef IS_LINUX
+  _epoll_index = -1;
+  _removed = false;
+#endif
 }
 
 /**
@@ -88,7 +105,8 @@ thread_main() {
 ConnectionReader::
 ConnectionReader(ConnectionManager *manager, int num_threads,
                  const std::string &thread_name) :
-  _manager(manager)
+  _manager(manager),
+  _buffer_pool(std::max((int)net_datagram_pool_size, 0))
 {
   if (!Thread::is_threading_supported()) {
 #ifndef NDEBUG
@@ -113,6 +131,34 @@ ConnectionReader(ConnectionManager *manager, int num_threads,
 
   _currently_polling_thread = -1;
 
+#ifdef IS_LINUX
+  _batch_io = net_batch_io;
+  _use_epoll = net_use_epoll;
+  if (_use_epoll) {
+    // One epoll set per thread, or just one if we are polling.
+    int num_sets = (num_threads > 0) ? num_threads : 1;
+    _epoll_sets.resize(num_sets);
+    for (EpollSet &set : _epoll_sets) {
+      set._fd = epoll_create1(EPOLL_CLOEXEC);
+      set._num_sockets = 0;
+      set._next_ready = 0;
+      if (set._fd < 0) {
+        net_cat.warning()
+          << "epoll_create1() failed; falling back to select().\n";
+        _use_epoll = false;
+      }
+    }
+    if (!_use_epoll) {
+      for (EpollSet &set : _epoll_sets) {
+        if (set._fd >= 0) {
+          close(set._fd);
+        }
+      }
+      _epoll_sets.clear();
+    }
+  }
+#endif
+
   std::string reader_thread_name = thread_name;
   if (thread_name.empty()) {
     reader_thread_name = "ReaderThread";
@@ -158,6 +204,12 @@ ConnectionReader::
       sinfo->_connection.clear();
     }
   }
+
+#ifdef IS_LINUX
+  for (EpollSet &set : _epoll_sets) {
+    close(set._fd);
+  }
+#endif
 }
 
 /**
@@ -187,7 +239,16 @@ add_connection(Connection *connection) {
     }
   }
 
-  _sockets.push_back(new SocketInfo(connection));
+  SocketInfo *sinfo = new SocketInfo(connection);
+
+#ifdef IS_LINUX
+  if (_use_epoll && !register_epoll_socket(sinfo)) {
+    delete sinfo;
+    return false;
+  }
+#endif
+
+  _sockets.push_back(sinfo);
 
   return true;
 }
@@ -214,6 +275,12 @@ remove_connection(Connection *connection) {
     return false;
   }
 
+#ifdef IS_LINUX
+  if (_use_epoll) {
+    unregister_epoll_socket(*si);
+  }
+#endif
+
   _removed_sockets.push_back(*si);
   _sockets.erase(si);
 
@@ -386,6 +453,22 @@ flush_read_connection(Connection *connection) {
   // available on just this one socket; we can do this right here in this
   // thread, since we've already removed this connection from the reader.
 
+#ifdef IS_LINUX
+  // Use poll() rather than select() here, since with epoll we may be
+  // monitoring descriptors beyond FD_SETSIZE.
+  struct pollfd pfd;
+  pfd.fd = sinfo.get_socket()->GetSocket();
+  pfd.events = POLLIN;
+  int num_results = ::poll(&pfd, 1, 0);
+  while (num_results != 0) {
+    sinfo._busy = true;
+    if (!process_incoming_data(&sinfo)) {
+      break;
+    }
+    pfd.fd = sinfo.get_socket()->GetSocket();
+    num_results = ::poll(&pfd, 1, 0);
+  }
+#else
   Socket_fdset fdset;
   fdset.clear();
   fdset.setForSocket(*(sinfo.get_socket()));
@@ -398,6 +481,7 @@ flush_read_connection(Connection *connection) {
     fdset.setForSocket(*(sinfo.get_socket()));
     num_results = fdset.WaitForRead(true, 0);
   }
+#endif
 }
 
 /**
@@ -419,6 +503,14 @@ void ConnectionReader::
 finish_socket(SocketInfo *sinfo) {
   nassertv(sinfo->_busy);
 
+#ifdef IS_LINUX
+  if (sinfo->_epoll_index >= 0) {
+    // Ask for the next readiness event.  If there is more data waiting
+    // already, this reports it right away.
+    rearm_epoll_socket(sinfo);
+  }
+#endif
+
   // By marking the SocketInfo nonbusy, we make it available for future polls.
   sinfo->_busy = false;
 }
@@ -450,6 +542,12 @@ process_incoming_data(SocketInfo *sinfo) {
  */
 bool ConnectionReader::
 process_incoming_udp_data(SocketInfo *sinfo) {
+#ifdef IS_LINUX
+  if (_batch_io) {
+    return process_incoming_udp_batch(sinfo);
+  }
+#endif
+
   Socket_UDP *socket;
   DCAST_INTO_R(socket, sinfo->get_socket(), false);
   Socket_Address addr;
@@ -489,7 +587,10 @@ process_incoming_udp_data(SocketInfo *sinfo) {
   char *dp = buffer + datagram_udp_header_size;
   bytes_read -= datagram_udp_header_size;
 
-  NetDatagram datagram(dp, bytes_read);
+  PTA_uchar data = _buffer_pool.get_buffer(bytes_read);
+  data.v().insert(data.v().end(), (unsigned char *)dp, (unsigned char *)dp + bytes_read);
+  NetDatagram datagram;
+  datagram.set_array(data);
 
   // Now that we've read all the data, it's time to finish the socket so
   // another thread can read the next datagram.
@@ -521,6 +622,107 @@ process_incoming_udp_data(SocketInfo *sinfo) {
   return true;
 }
 
+#ifdef IS_LINUX
+/**
+ * The form of process_incoming_udp_data() used when net-batch-io is in
+ * effect.  This collects as many datagrams as are waiting on the socket, up
+ * to net-batch-size, with a single call to recvmmsg().
+ */
+bool ConnectionReader::
+process_incoming_udp_batch(SocketInfo *sinfo) {
+  Socket_UDP *socket;
+  DCAST_INTO_R(socket, sinfo->get_socket(), false);
+
+  int num_messages = std::max(min((int)net_batch_size, max_net_batch_size), 1);
+
+  char buffers[max_net_batch_size][read_buffer_size];
+  struct sockaddr_storage addrs[max_net_batch_size];
+  struct iovec iovs[max_net_batch_size];
+  struct mmsghdr msgs[max_net_batch_size];
+
+  for (int i = 0; i < num_messages; ++i) {
+    iovs[i].iov_base = buffers[i];
+    iovs[i].iov_len = read_buffer_size;
+
+    struct msghdr &hdr = msgs[i].msg_hdr;
+    hdr.msg_name = &addrs[i];
+    hdr.msg_namelen = sizeof(addrs[i]);
+    hdr.msg_iov = &iovs[i];
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = nullptr;
+    hdr.msg_controllen = 0;
+    hdr.msg_flags = 0;
+    msgs[i].msg_len = 0;
+  }
+
+  // We were told there is data waiting, but another reader may have beaten
+  // us to it, so we must not block here.
+  int num_received;
+  do {
+    num_received = recvmmsg(socket->GetSocket(), msgs, num_messages,
+                            MSG_DONTWAIT, nullptr);
+  } while (num_received < 0 && errno == EINTR);
+
+  // Now that we've read all the data, it's time to finish the socket so
+  // another thread can read the next batch.
+  finish_socket(sinfo);
+
+  if (num_received < 0) {
+    return (errno == EAGAIN || errno == EWOULDBLOCK);
+  }
+
+  for (int i = 0; i < num_received; ++i) {
+    if (_shutdown) {
+      return false;
+    }
+
+    int bytes_read = (int)msgs[i].msg_len;
+    if (bytes_read == 0) {
+      // An empty UDP datagram doesn't mean the socket was closed.  As in
+      // process_incoming_udp_data(), just skip it, and go on to the rest of
+      // the batch.
+      continue;
+    }
+
+    if (bytes_read < datagram_udp_header_size) {
+      net_cat.error()
+        << "Did not read entire header, discarding UDP datagram.\n";
+      continue;
+    }
+
+    DatagramUDPHeader header(buffers[i]);
+
+    unsigned char *dp = (unsigned char *)buffers[i] + datagram_udp_header_size;
+    bytes_read -= datagram_udp_header_size;
+
+    PTA_uchar data = _buffer_pool.get_buffer(bytes_read);
+    data.v().insert(data.v().end(), dp, dp + bytes_read);
+    NetDatagram datagram;
+    datagram.set_array(data);
+
+    if (!header.verify_datagram(datagram)) {
+      net_cat.error()
+        << "Ignoring invalid UDP datagram.\n";
+    } else {
+      datagram.set_connection(sinfo->_connection);
+      datagram.set_address(NetAddress(Socket_Address(addrs[i])));
+
+      if (net_cat.is_spam()) {
+        net_cat.spam()
+          << "Received UDP datagram with "
+          << datagram_udp_header_size + datagram.get_length()
+          << " bytes on " << (void *)datagram.get_connection()
+          << " from " << datagram.get_address() << "\n";
+      }
+
+      receive_datagram(datagram);
+    }
+  }
+
+  return true;
+}
+#endif  // IS_LINUX
+
 /**
  *
  */
@@ -795,6 +997,18 @@ thread_run(int thread_index) {
  */
 ConnectionReader::SocketInfo *ConnectionReader::
 get_next_available_socket(bool allow_block, int current_thread_index) {
+#ifdef IS_LINUX
+  if (_use_epoll) {
+    if (current_thread_index < 0) {
+      // A polling reader has only the one epoll set.  poll() might be called
+      // from more than one thread, so it still needs the select mutex.
+      MutexHolder holder(_select_mutex);
+      return get_next_epoll_socket(allow_block, 0);
+    }
+    return get_next_epoll_socket(allow_block, current_thread_index);
+  }
+#endif
+
   // Go to sleep on the select() mutex.  This guarantees that only one thread
   // is in this function at a time.
   MutexHolder holder(_select_mutex);
@@ -925,3 +1139,159 @@ accumulate_fdset(Socket_fdset &fdset) {
     }
   }
 }
+
+#ifdef IS_LINUX
+/**
+ * Adds the socket to the epoll set with the fewest sockets.  Returns true on
+ * success.  _sockets_mutex must be held.
+ */
+bool ConnectionReader::
+register_epoll_socket(SocketInfo *sinfo) {
+  int epoll_index = 0;
+  for (size_t i = 1; i < _epoll_sets.size(); ++i) {
+    if (_epoll_sets[i]._num_sockets < _epoll_sets[epoll_index]._num_sockets) {
+      epoll_index = (int)i;
+    }
+  }
+
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+  event.data.ptr = sinfo;
+  if (epoll_ctl(_epoll_sets[epoll_index]._fd, EPOLL_CTL_ADD,
+                sinfo->get_socket()->GetSocket(), &event) != 0) {
+    net_cat.error()
+      << "Unable to add socket to epoll set: " << strerror(errno) << "\n";
+    return false;
+  }
+
+  sinfo->_epoll_index = epoll_index;
+  ++_epoll_sets[epoll_index]._num_sockets;
+  return true;
+}
+
+/**
+ * Removes the socket from its epoll set.  _sockets_mutex must be held.
+ */
+void ConnectionReader::
+unregister_epoll_socket(SocketInfo *sinfo) {
+  nassertv(sinfo->_epoll_index >= 0);
+  sinfo->_removed = true;
+
+  // If the socket has already been closed, the kernel has removed it for us,
+  // and the descriptor may even have been reused by now.
+  SOCKET fd = sinfo->get_socket()->GetSocket();
+  if (fd != BAD_SOCKET) {
+    epoll_ctl(_epoll_sets[sinfo->_epoll_index]._fd, EPOLL_CTL_DEL, fd, nullptr);
+  }
+  --_epoll_sets[sinfo->_epoll_index]._num_sockets;
+}
+
+/**
+ * Re-enables the one-shot readiness event for a socket that has just been
+ * read.
+ */
+void ConnectionReader::
+rearm_epoll_socket(SocketInfo *sinfo) {
+  LightMutexHolder holder(_sockets_mutex);
+  if (sinfo->_removed) {
+    return;
+  }
+
+  SOCKET fd = sinfo->get_socket()->GetSocket();
+  if (fd == BAD_SOCKET) {
+    return;
+  }
+
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+  event.data.ptr = sinfo;
+  epoll_ctl(_epoll_sets[sinfo->_epoll_index]._fd, EPOLL_CTL_MOD, fd, &event);
+}
+
+/**
+ * The epoll equivalent of get_next_available_socket().  Returns the next
+ * socket in the indicated epoll set that has activity, waiting for one if
+ * allow_block is true.  Only one thread at a time may call this for a given
+ * epoll set.
+ */
+ConnectionReader::SocketInfo *ConnectionReader::
+get_next_epoll_socket(bool allow_block, int epoll_index) {
+  nassertr(epoll_index >= 0 && epoll_index < (int)_epoll_sets.size(), nullptr);
+  EpollSet &set = _epoll_sets[epoll_index];
+
+  while (!_shutdown) {
+    // First, hand out any sockets left over from the previous epoll_wait().
+    while (set._next_ready < set._ready.size()) {
+      SocketInfo *sinfo = set._ready[set._next_ready];
+      set._next_ready++;
+
+      LightMutexHolder holder(_sockets_mutex);
+      if (!sinfo->_removed && !sinfo->_error) {
+        sinfo->_busy = true;
+        return sinfo;
+      }
+    }
+    set._ready.clear();
+    set._next_ready = 0;
+
+    // We are no longer holding any events, so this is a safe time to delete
+    // the sockets that were removed from this set.
+    delete_removed_sockets(epoll_index);
+
+    int timeout = (int)(get_net_max_block() * 1000.0);
+    if (!allow_block) {
+      timeout = 0;
+    }
+#if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
+    timeout = 0;
+#endif
+
+    struct epoll_event events[max_epoll_events];
+    int num_results = epoll_wait(set._fd, events, max_epoll_events, timeout);
+    if (num_results < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      Thread::force_yield();
+      return nullptr;
+    }
+
+    if (num_results == 0) {
+      if (!allow_block) {
+        return nullptr;
+      }
+      // We reached net_max_block; go back and check the shutdown flag.
+      Thread::force_yield();
+      continue;
+    }
+
+    for (int i = 0; i < num_results; ++i) {
+      set._ready.push_back((SocketInfo *)events[i].data.ptr);
+    }
+  }
+
+  return nullptr;
+}
+
+/**
+ * Deletes the sockets on _removed_sockets that belonged to the indicated
+ * epoll set and are no longer busy.
+ */
+void ConnectionReader::
+delete_removed_sockets(int epoll_index) {
+  LightMutexHolder holder(_sockets_mutex);
+  if (_removed_sockets.empty()) {
+    return;
+  }
+
+  Sockets still_pending;
+  for (SocketInfo *sinfo : _removed_sockets) {
+    if (sinfo->_epoll_index == epoll_index && !sinfo->_busy) {
+      delete sinfo;
+    } else {
+      still_pending.push_back(sinfo);
+    }
+  }
+  _removed_sockets.swap(still_pending);
+}
+#endif  // IS_LINUX
@@ -17,6 +17,7 @@
 #include "pandabase.h"
 
 #include "connection.h"
+#include "datagramBufferPool.h"
 
 #include "pointerTo.h"
 #include "pmutex.h"
@@ -95,6 +96,13 @@ protected:
     PT(Connection) _connection;
     bool _busy;
     bool _error;
+#ifdef IS_LINUX
+    // The index of the epoll set this socket is registered with, or -1.
+    int _epoll_index;
+    // Set by remove_connection(), so that a readiness event that was already
+    // collected for this socket will be ignored.
+    bool _removed;
+#endif
   };
   typedef pvector<SocketInfo *> Sockets;
 
@@ -107,6 +115,10 @@ protected:
   virtual bool process_raw_incoming_udp_data(SocketInfo *sinfo);
   virtual bool process_raw_incoming_tcp_data(SocketInfo *sinfo);
 
+#ifdef IS_LINUX
+  bool process_incoming_udp_batch(SocketInfo *sinfo);
+#endif
+
 protected:
   ConnectionManager *_manager;
 
@@ -119,6 +131,9 @@ protected:
   // Any operations on _sockets are protected by this mutex.
   LightMutex _sockets_mutex;
 
+  // Incoming UDP datagrams take their data arrays from here.
+  DatagramBufferPool _buffer_pool;
+
 private:
   void thread_run(int thread_index);
 
@@ -128,6 +143,14 @@ private:
   void rebuild_select_list();
   void accumulate_fdset(Socket_fdset &fdset);
 
+#ifdef IS_LINUX
+  bool register_epoll_socket(SocketInfo *sinfo);
+  void unregister_epoll_socket(SocketInfo *sinfo);
+  void rearm_epoll_socket(SocketInfo *sinfo);
+  SocketInfo *get_next_epoll_socket(bool allow_block, int epoll_index);
+  void delete_removed_sockets(int epoll_index);
+#endif
+
 private:
   bool _raw_mode;
   int _tcp_header_size;
@@ -162,6 +185,30 @@ private:
   // thread is so waiting.
   AtomicAdjust::Integer _currently_polling_thread;
 
+#ifdef IS_LINUX
+  // On Linux, unless net-use-epoll is false, the sockets are instead divided
+  // among several epoll sets, one for each reader thread (or a single one
+  // for a polling reader), so that each thread waits only on its own
+  // sockets.  Each socket is registered edge-triggered and one-shot, and
+  // re-armed by finish_socket(), so it is only ever handed to one thread at
+  // a time.
+  class EpollSet {
+  public:
+    int _fd;
+    int _num_sockets;
+    // The sockets reported ready by the last epoll_wait(), not yet handed
+    // out.  Only the owning thread touches these.
+    Sockets _ready;
+    size_t _next_ready;
+  };
+  typedef pvector<EpollSet> EpollSets;
+  EpollSets _epoll_sets;
+  bool _use_epoll;
+
+  // True to read UDP datagrams with recvmmsg(); see net-batch-io.
+  bool _batch_io;
+#endif
+
   friend class ConnectionManager;
   friend class ReaderThread;
 };
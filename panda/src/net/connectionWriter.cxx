@@ -155,7 +155,7 @@ send(const Datagram &datagram, const PT(Connection) &connection, bool block) {
       return connection->send_datagram(copy, _tcp_header_size);
     }
   } else {
-    return _queue.insert(copy, block);
+    return _queue.insert(std::move(copy), block);
   }
 }
 
@@ -199,7 +199,7 @@ send(const Datagram &datagram, const PT(Connection) &connection,
       return connection->send_datagram(copy, _tcp_header_size);
     }
   } else {
-    return _queue.insert(copy, block);
+    return _queue.insert(std::move(copy), block);
   }
 }
 
@@ -320,13 +320,39 @@ void ConnectionWriter::
 thread_run(int thread_index) {
   nassertv(!_immediate);
 
-  NetDatagram datagram;
-  while (_queue.extract(datagram)) {
-    if (_raw_mode) {
-      datagram.get_connection()->send_raw_datagram(datagram);
-    } else {
-      datagram.get_connection()->send_datagram(datagram, _tcp_header_size);
+  // We take everything that is waiting on the queue at once, up to
+  // net-batch-size datagrams, so that consecutive datagrams for the same
+  // connection can be written together.
+  size_t batch_size = 1;
+  if (net_batch_io) {
+    batch_size = (size_t)std::max(std::min((int)net_batch_size, max_net_batch_size), 1);
+  }
+
+  pvector<NetDatagram> batch;
+  batch.reserve(batch_size);
+  while (_queue.extract_batch(batch, batch_size)) {
+    size_t i = 0;
+    while (i < batch.size()) {
+      Connection *connection = batch[i].get_connection();
+      size_t j = i + 1;
+      while (j < batch.size() && batch[j].get_connection() == connection) {
+        ++j;
+      }
+
+      if (j - i > 1) {
+        connection->send_datagram_batch(&batch[i], j - i, _raw_mode,
+                                        _tcp_header_size);
+      } else if (_raw_mode) {
+        connection->send_raw_datagram(batch[i]);
+      } else {
+        connection->send_datagram(batch[i], _tcp_header_size);
+      }
+      i = j;
     }
+
+    // Release the datagrams, and the connections, before we go back to
+    // sleep.
+    batch.clear();
     Thread::consider_yield();
   }
 }
@@ -0,0 +1,93 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramBufferPool.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "datagramBufferPool.h"
+#include "lightMutexHolder.h"
+
+/**
+ * Creates a pool that will retain up to max_buffers buffers for reuse.  If
+ * max_buffers is 0, every buffer is freshly allocated.
+ */
+DatagramBufferPool::
+DatagramBufferPool(size_t max_buffers) :
+  _next(0),
+  _max_buffers(max_buffers),
+  _lock("DatagramBufferPool::_lock")
+{
+}
+
+/**
+ * Returns an empty buffer, with room for at least the indicated number of
+ * bytes, which is no longer in use by any Datagram.  The caller should fill
+ * it and hand it to Datagram::set_array().
+ */
+PTA_uchar DatagramBufferPool::
+get_buffer(size_t capacity) {
+  {
+    LightMutexHolder holder(_lock);
+
+    // Look for a buffer that only we still reference.  We resume the search
+    // where the previous one left off, since the buffers that were handed
+    // out longest ago are the likeliest to have been released.
+    size_t num_buffers = _buffers.size();
+    for (size_t i = 0; i < num_buffers; ++i) {
+      PTA_uchar &buffer = _buffers[_next];
+      if (++_next >= num_buffers) {
+        _next = 0;
+      }
+      if (buffer.get_ref_count() == 1) {
+        // Clearing the vector keeps its storage, so this doesn't allocate.
+        buffer.v().clear();
+        buffer.v().reserve(capacity);
+        return buffer;
+      }
+    }
+
+    if (num_buffers < _max_buffers) {
+      PTA_uchar buffer = PTA_uchar::empty_array(0);
+      buffer.v().reserve(capacity);
+      _buffers.push_back(buffer);
+      return buffer;
+    }
+  }
+
+  // The pool is exhausted; this one won't be recycled.
+  PTA_uchar buffer = PTA_uchar::empty_array(0);
+  buffer.v().reserve(capacity);
+  return buffer;
+}
+
+/**
+ * Returns the number of buffers currently retained by the pool.
+ */
+size_t DatagramBufferPool::
+get_num_buffers() const {
+  LightMutexHolder holder(_lock);
+  return _buffers.size();
+}
+
+/**
+ * Returns the number of retained buffers that are not currently in use by
+ * any Datagram.
+ */
+size_t DatagramBufferPool::
+get_num_free_buffers() const {
+  LightMutexHolder holder(_lock);
+  size_t num_free = 0;
+  for (const PTA_uchar &buffer : _buffers) {
+    if (buffer.get_ref_count() == 1) {
+      ++num_free;
+    }
+  }
+  return num_free;
+}
@@ -0,0 +1,58 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramBufferPool.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef DATAGRAMBUFFERPOOL_H
+#define DATAGRAMBUFFERPOOL_H
+
+#include "pandabase.h"
+#include "pta_uchar.h"
+#include "pvector.h"
+#include "lightMutex.h"
+
+/**
+ * A thread-safe set of reusable data buffers for incoming datagrams.  This is
+ * used by ConnectionReader so that a steady stream of small datagrams does
+ * not allocate a new data array for each one.
+ *
+ * A buffer handed out by get_buffer() is attached to a Datagram with
+ * Datagram::set_array().  The pool keeps its own reference to each buffer,
+ * and considers a buffer free again once all other references to it have
+ * gone away; that is, once every Datagram that shared it has been destroyed
+ * or has moved on to a different array.  Since Datagram copies its array on
+ * write when the array is shared, it is safe for the application to modify
+ * such a datagram.
+ */
+class EXPCL_PANDA_NET DatagramBufferPool {
+public:
+  explicit DatagramBufferPool(size_t max_buffers);
+  DatagramBufferPool(const DatagramBufferPool &copy) = delete;
+  DatagramBufferPool &operator = (const DatagramBufferPool &copy) = delete;
+
+  PTA_uchar get_buffer(size_t capacity);
+
+  INLINE size_t get_max_buffers() const;
+  size_t get_num_buffers() const;
+  size_t get_num_free_buffers() const;
+
+private:
+  typedef pvector<PTA_uchar> Buffers;
+  Buffers _buffers;
+  size_t _next;
+  size_t _max_buffers;
+
+  mutable LightMutex _lock;
+};
+
+#include "datagramBufferPool.I"
+
+#endif
@@ -64,6 +64,15 @@ shutdown() {
  */
 bool DatagramQueue::
 insert(const NetDatagram &data, bool block) {
+  return insert(NetDatagram(data), block);
+}
+
+/**
+ * This variant of insert() moves the datagram onto the queue instead of
+ * copying it.
+ */
+bool DatagramQueue::
+insert(NetDatagram &&data, bool block) {
   MutexHolder holder(_cvlock);
 
   bool enqueue_ok = ((int)_queue.size() < _max_queue_size);
@@ -75,7 +84,7 @@ insert(const NetDatagram &data, bool block) {
   }
 
   if (enqueue_ok) {
-    _queue.push_back(data);
+    _queue.push_back(std::move(data));
   }
   _cv.notify();  // Only need to wake up one thread.
 
@@ -112,7 +121,7 @@ extract(NetDatagram &result) {
   }
 
   nassertr(!_queue.empty(), false);
-  result = _queue.front();
+  result = std::move(_queue.front());
   _queue.pop_front();
 
   // Wake up any threads waiting to stuff things into the queue.
@@ -121,6 +130,40 @@ extract(NetDatagram &result) {
   return true;
 }
 
+/**
+ * Like extract(), but extracts up to max_count datagrams at once, appending
+ * them to the end of result.  This blocks until at least one datagram is
+ * available, and then takes whatever others are already waiting, so that
+ * they may all be written together.
+ *
+ * The return value is true if at least one datagram is extracted, or false if
+ * the queue was destroyed while waiting.
+ */
+bool DatagramQueue::
+extract_batch(pvector<NetDatagram> &result, size_t max_count) {
+  MutexHolder holder(_cvlock);
+
+  while (_queue.empty() && !_shutdown) {
+    _cv.wait();
+  }
+
+  if (_shutdown) {
+    return false;
+  }
+
+  nassertr(!_queue.empty(), false);
+  size_t count = std::min(std::max(max_count, (size_t)1), _queue.size());
+  for (size_t i = 0; i < count; ++i) {
+    result.push_back(std::move(_queue.front()));
+    _queue.pop_front();
+  }
+
+  // Wake up any threads waiting to stuff things into the queue.
+  _cv.notify_all();
+
+  return true;
+}
+
 /**
  * Sets the maximum size the queue is allowed to grow to.  This is primarily
  * for a sanity check; this is a limit beyond which we can assume something
@@ -20,6 +20,7 @@
 #include "pmutex.h"
 #include "conditionVarFull.h"
 #include "pdeque.h"
+#include "pvector.h"
 
 /**
  * A thread-safe, FIFO queue of NetDatagrams.  This is used by
@@ -33,7 +34,9 @@ public:
   void shutdown();
 
   bool insert(const NetDatagram &data, bool block = false);
+  bool insert(NetDatagram &&data, bool block = false);
   bool extract(NetDatagram &result);
+  bool extract_batch(pvector<NetDatagram> &result, size_t max_count);
 
   void set_max_queue_size(int max_size);
   int get_max_queue_size() const;
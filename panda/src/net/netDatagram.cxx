@@ -50,6 +50,17 @@ NetDatagram(const NetDatagram &copy) :
 {
 }
 
+/**
+ *
+ */
+NetDatagram::
+NetDatagram(NetDatagram &&from) noexcept :
+  Datagram(std::move(from)),
+  _connection(std::move(from._connection)),
+  _address(from._address)
+{
+}
+
 /**
  *
  */
@@ -70,6 +81,16 @@ operator = (const NetDatagram &copy) {
   _address = copy._address;
 }
 
+/**
+ *
+ */
+void NetDatagram::
+operator = (NetDatagram &&from) noexcept {
+  Datagram::operator = (std::move(from));
+  _connection = std::move(from._connection);
+  _address = from._address;
+}
+
 /**
  * Resets the datagram to empty, in preparation for building up a new
  * datagram.
@@ -0,0 +1,218 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_batch_io_bench.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+
+#include "queuedConnectionManager.h"
+#include "queuedConnectionListener.h"
+#include "queuedConnectionReader.h"
+#include "connectionWriter.h"
+#include "netAddress.h"
+#include "connection.h"
+#include "netDatagram.h"
+#include "datagramIterator.h"
+#include "config_net.h"
+#include "trueClock.h"
+#include "thread.h"
+#include "socket_udp.h"
+
+/**
+ * Checks that the datagram is the one with the given sequence number.
+ */
+static bool
+check_datagram(const NetDatagram &datagram, uint32_t &sequence) {
+  DatagramIterator dgi(datagram);
+  if (dgi.get_remaining_size() < 4) {
+    return false;
+  }
+  sequence = dgi.get_uint32();
+  size_t length = sequence % 64;
+  if (dgi.get_remaining_size() != length) {
+    return false;
+  }
+  for (size_t i = 0; i < length; ++i) {
+    if (dgi.get_uint8() != (uint8_t)(sequence + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Sends a stream of small datagrams through a threaded ConnectionWriter to a
+ * threaded QueuedConnectionReader in the same process, over the loopback
+ * interface, and reports how long it takes for them to arrive.  Every
+ * datagram is checked on receipt; over TCP, they must also all arrive in
+ * order.
+ *
+ * Pass "single" as the third parameter to turn off net-batch-io, for
+ * comparison.  Over UDP, some datagrams may be dropped when the reader
+ * falls behind; the number that arrived is reported.  An empty datagram is
+ * also sent now and then over UDP, which must not reset the connection.
+ */
+int
+main(int argc, char *argv[]) {
+  bool use_tcp = false;
+  int num_messages = 200000;
+  bool batch_io = true;
+  int port = 6061;
+
+  if (argc > 1) {
+    use_tcp = (std::string(argv[1]) == "tcp");
+  }
+  if (argc > 2) {
+    num_messages = atoi(argv[2]);
+  }
+  if (argc > 3) {
+    batch_io = (std::string(argv[3]) != "single");
+  }
+  if (argc > 4) {
+    port = atoi(argv[4]);
+  }
+  if (argc > 5 || num_messages <= 0) {
+    nout << "test_batch_io_bench [udp|tcp [num_messages [batch|single [port]]]]\n";
+    exit(1);
+  }
+
+  net_batch_io.set_value(batch_io);
+
+  QueuedConnectionManager cm;
+  QueuedConnectionReader reader(&cm, 1);
+  ConnectionWriter writer(&cm, 1);
+  writer.set_max_queue_size(4096);
+
+  PT(Connection) client, server, rendezvous;
+  NetAddress server_address;
+  if (use_tcp) {
+    rendezvous = cm.open_TCP_server_rendezvous(port, 5);
+    if (rendezvous.is_null()) {
+      nout << "Cannot grab port " << port << ".\n";
+      exit(1);
+    }
+    QueuedConnectionListener listener(&cm, 0);
+    listener.add_connection(rendezvous);
+
+    client = cm.open_TCP_client_connection("127.0.0.1", port, 5000);
+    if (client.is_null()) {
+      nout << "Cannot connect to port " << port << ".\n";
+      exit(1);
+    }
+    while (server.is_null()) {
+      listener.poll();
+      PT(Connection) rv;
+      NetAddress address;
+      if (!listener.get_new_connection(rv, address, server)) {
+        Thread::sleep(0.001);
+      }
+    }
+  } else {
+    server = cm.open_UDP_connection(port);
+    client = cm.open_UDP_connection(0);
+    if (server.is_null() || client.is_null()) {
+      nout << "Cannot open UDP port " << port << ".\n";
+      exit(1);
+    }
+    server->set_recv_buffer_size(4 * 1024 * 1024);
+    server_address.set_host("127.0.0.1", port);
+  }
+
+  Socket_UDP empty_sender;
+  if (!use_tcp && !empty_sender.InitToAddress(server_address.get_addr())) {
+    nout << "Cannot open UDP socket.\n";
+    exit(1);
+  }
+  reader.add_connection(server);
+
+  int num_received = 0;
+  int num_invalid = 0;
+  uint32_t next_sequence = 0;
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  NetDatagram received;
+  for (int m = 0; m < num_messages; ++m) {
+    NetDatagram datagram;
+    datagram.add_uint32(m);
+    size_t length = m % 64;
+    for (size_t i = 0; i < length; ++i) {
+      datagram.add_uint8((uint8_t)(m + i));
+    }
+
+    if (use_tcp) {
+      writer.send(datagram, client, true);
+    } else {
+      writer.send(datagram, client, server_address, true);
+      if (m % 100 == 50) {
+        empty_sender.Send("", 0);
+      }
+    }
+
+    while (reader.data_available() && reader.get_data(received)) {
+      uint32_t sequence;
+      if (!check_datagram(received, sequence) ||
+          (use_tcp && sequence != next_sequence)) {
+        ++num_invalid;
+      }
+      next_sequence = sequence + 1;
+      ++num_received;
+    }
+  }
+  double sent = clock->get_short_time();
+
+  // Wait until nothing more arrives for a while.
+  double idle_until = clock->get_short_time() + 1.0;
+  while (num_received < num_messages && clock->get_short_time() < idle_until) {
+    if (reader.data_available() && reader.get_data(received)) {
+      uint32_t sequence;
+      if (!check_datagram(received, sequence) ||
+          (use_tcp && sequence != next_sequence)) {
+        ++num_invalid;
+      }
+      next_sequence = sequence + 1;
+      ++num_received;
+      idle_until = clock->get_short_time() + 1.0;
+    } else {
+      Thread::sleep(0.0005);
+    }
+  }
+  double finished = clock->get_short_time();
+  if (num_received < num_messages) {
+    // Don't count the idle period.
+    finished = idle_until - 1.0;
+  }
+
+  nout << (use_tcp ? "TCP" : "UDP")
+       << (batch_io ? " with" : " without") << " net-batch-io: sent "
+       << num_messages << " datagrams in " << (sent - start) << " s, received "
+       << num_received << " (" << num_invalid << " invalid) in "
+       << (finished - start) << " s ("
+       << num_received / (finished - start) << " per second).\n";
+
+  bool was_reset = cm.reset_connection_available();
+  if (was_reset) {
+    nout << "The connection was reset.\n";
+  }
+
+  writer.shutdown();
+  cm.close_connection(client);
+  cm.close_connection(server);
+  if (!rendezvous.is_null()) {
+    cm.close_connection(rendezvous);
+  }
+
+  if (num_invalid != 0 || was_reset) {
+    return 1;
+  }
+  return (use_tcp && num_received != num_messages) ? 1 : 0;
+}
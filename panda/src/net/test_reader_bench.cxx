@@ -0,0 +1,183 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_reader_bench.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+
+#include "queuedConnectionManager.h"
+#include "queuedConnectionListener.h"
+#include "queuedConnectionReader.h"
+#include "connectionWriter.h"
+#include "netAddress.h"
+#include "connection.h"
+#include "netDatagram.h"
+#include "config_net.h"
+#include "trueClock.h"
+#include "thread.h"
+
+#include "pvector.h"
+#include <sys/resource.h>
+
+/**
+ * Opens a large number of loopback TCP connections to a server in the same
+ * process, sends a burst of datagrams on each of them, and reports how long
+ * it takes the server's QueuedConnectionReader to receive them all.
+ *
+ * Pass "select" as the fourth parameter to measure the select()-based reader
+ * instead of the epoll-based one.  Note that select() cannot handle more than
+ * FD_SETSIZE descriptors, and each client here uses two.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_clients = 2000;
+  int num_threads = 4;
+  int num_messages = 20;
+  bool use_select = false;
+  int port = 6060;
+
+  if (argc > 1) {
+    num_clients = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_threads = atoi(argv[2]);
+  }
+  if (argc > 3) {
+    num_messages = atoi(argv[3]);
+  }
+  if (argc > 4) {
+    use_select = (std::string(argv[4]) == "select");
+  }
+  if (argc > 5) {
+    port = atoi(argv[5]);
+  }
+  if (argc > 6 || num_clients <= 0 || num_messages <= 0) {
+    nout << "test_reader_bench [num_clients [num_threads [num_messages [epoll|select [port]]]]]\n";
+    exit(1);
+  }
+
+  // Each client needs a descriptor on either end.
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    if ((rlim_t)num_clients * 2 + 64 > limit.rlim_cur) {
+      nout << "Warning: descriptor limit is " << limit.rlim_cur
+           << "; not all clients may be able to connect.\n";
+    }
+  }
+
+  net_use_epoll.set_value(!use_select);
+
+  QueuedConnectionManager cm;
+  PT(Connection) rendezvous = cm.open_TCP_server_rendezvous(port, 1024);
+  if (rendezvous.is_null()) {
+    nout << "Cannot grab port " << port << ".\n";
+    exit(1);
+  }
+
+  QueuedConnectionListener listener(&cm, 1);
+  listener.add_connection(rendezvous);
+
+  QueuedConnectionReader reader(&cm, num_threads);
+
+  // Connect all of the clients.
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  typedef pvector< PT(Connection) > Connections;
+  Connections clients, servers;
+  for (int i = 0; i < num_clients; ++i) {
+    PT(Connection) client = cm.open_TCP_client_connection("127.0.0.1", port, 5000);
+    if (client.is_null()) {
+      nout << "Could only open " << i << " clients.\n";
+      break;
+    }
+    clients.push_back(client);
+
+    while (listener.new_connection_available()) {
+      PT(Connection) rv;
+      NetAddress address;
+      PT(Connection) new_connection;
+      if (listener.get_new_connection(rv, address, new_connection)) {
+        reader.add_connection(new_connection);
+        servers.push_back(new_connection);
+      }
+    }
+  }
+
+  while (servers.size() < clients.size()) {
+    PT(Connection) rv;
+    NetAddress address;
+    PT(Connection) new_connection;
+    if (listener.new_connection_available() &&
+        listener.get_new_connection(rv, address, new_connection)) {
+      reader.add_connection(new_connection);
+      servers.push_back(new_connection);
+    } else {
+      Thread::sleep(0.001);
+    }
+  }
+
+  double connected = clock->get_short_time();
+  nout << clients.size() << " clients connected in "
+       << (connected - start) << " s, reading with " << num_threads
+       << (use_select ? " select()" : " epoll") << " threads.\n";
+
+  // Now send a burst of datagrams from every client.
+  ConnectionWriter writer(&cm, 0);
+  NetDatagram datagram;
+  datagram.add_string("The quick brown fox jumps over the lazy dog.");
+  datagram.add_uint32(0);
+
+  int num_expected = (int)clients.size() * num_messages;
+  int num_received = 0;
+
+  start = clock->get_short_time();
+  for (int m = 0; m < num_messages; ++m) {
+    for (Connection *client : clients) {
+      writer.send(datagram, client);
+    }
+
+    while (reader.data_available()) {
+      NetDatagram received;
+      if (reader.get_data(received)) {
+        ++num_received;
+      }
+    }
+  }
+
+  double timeout = clock->get_short_time() + 60.0;
+  while (num_received < num_expected && clock->get_short_time() < timeout) {
+    if (reader.data_available()) {
+      NetDatagram received;
+      if (reader.get_data(received)) {
+        ++num_received;
+      }
+    } else {
+      Thread::sleep(0.0005);
+    }
+  }
+  double finished = clock->get_short_time();
+
+  nout << "Received " << num_received << " of " << num_expected
+       << " datagrams in " << (finished - start) << " s ("
+       << num_received / (finished - start) << " per second).\n";
+
+  for (Connection *client : clients) {
+    cm.close_connection(client);
+  }
+  for (Connection *server : servers) {
+    cm.close_connection(server);
+  }
+
+  return (num_received == num_expected) ? 0 : 1;
+}
@@ -75,6 +75,23 @@ set_ignore_scale(bool ignore_scale) {
   }
 }
 
+/**
+ * Returns true if this renderer can draw a ParticleSystem in array mode, by
+ * reading the particles directly from its ParticleArrays.
+ */
+bool BaseParticleRenderer::
+supports_arrays() const {
+  return false;
+}
+
+/**
+ * Populates the geometry from the arrays of a ParticleSystem in array mode.
+ * This is only called if supports_arrays() returns true.
+ */
+void BaseParticleRenderer::
+render_arrays(const ParticleArrays &) {
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
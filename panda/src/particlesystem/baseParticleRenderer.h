@@ -23,6 +23,7 @@
 #include "nodePath.h"
 #include "particleCommonFuncs.h"
 #include "baseParticle.h"
+#include "particleArrays.h"
 
 #include "pvector.h"
 
@@ -62,6 +63,8 @@ PUBLISHED:
   void set_ignore_scale(bool ignore_scale);
   INLINE bool get_ignore_scale() const;
 
+  virtual bool supports_arrays() const;
+
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
 
@@ -105,6 +108,7 @@ private:
   virtual void init_geoms() = 0;
   virtual void render(pvector< PT(PhysicsObject) >& po_vector,
                       int ttl_particles) = 0;
+  virtual void render_arrays(const ParticleArrays &arrays);
 
   friend class ParticleSystem;
 };
@@ -11,6 +11,7 @@
 // oriented particles unimplemented
 //#include "orientedParticle.cxx"
 //#include "orientedParticleFactory.cxx"
+#include "particleArrays.cxx"
 #include "particleSystem.cxx"
 #include "particleSystemManager.cxx"
 
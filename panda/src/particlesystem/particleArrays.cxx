@@ -0,0 +1,218 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file particleArrays.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "particleArrays.h"
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+#include <xmmintrin.h>
+#define PARTICLE_ARRAYS_SSE 1
+#endif
+
+/**
+ *
+ */
+ParticleArrays::
+ParticleArrays() :
+  _capacity(0),
+  _stride(0),
+  _num_particles(0)
+{
+  set_capacity(0);
+}
+
+/**
+ * Changes the number of particles the arrays can hold.  If there are more
+ * living particles than that, the extra ones are removed.
+ */
+void ParticleArrays::
+set_capacity(int capacity) {
+  nassertv(capacity >= 0);
+
+  // Each array starts on a multiple of four floats, and there is always room
+  // for at least one particle, so that the arrays always exist.
+  int stride = (std::max(capacity, 1) + 3) & ~3;
+  int num_particles = std::min(_num_particles, capacity);
+
+  pvector<float> data(stride * C_num_columns, 0.0f);
+  for (int c = 0; c < C_num_columns && num_particles > 0; ++c) {
+    memcpy(&data[c * stride], &_data[c * _stride],
+           num_particles * sizeof(float));
+  }
+
+  _data.swap(data);
+  _capacity = capacity;
+  _stride = stride;
+  _num_particles = num_particles;
+}
+
+/**
+ * Resets the per-particle accelerations that are added with add_accel().
+ */
+void ParticleArrays::
+clear_accel() {
+  float *data = &_data[0];
+  memset(data + C_accel_x * _stride, 0, _num_particles * sizeof(float));
+  memset(data + C_accel_y * _stride, 0, _num_particles * sizeof(float));
+  memset(data + C_accel_z * _stride, 0, _num_particles * sizeof(float));
+}
+
+/**
+ * Advances all of the particles by dt seconds, in the same way that
+ * LinearEulerIntegrator does.  Each particle is accelerated by md_force
+ * divided by its mass, plus accel, plus its own acceleration from
+ * add_accel() if use_particle_accel is true.  The sum is scaled by damper,
+ * which is one minus the viscosity.
+ */
+void ParticleArrays::
+integrate(const LVector3 &md_force, const LVector3 &accel,
+          bool use_particle_accel, PN_stdfloat damper, PN_stdfloat dt) {
+  float *data = &_data[0];
+  float *px = data + C_pos_x * _stride;
+  float *py = data + C_pos_y * _stride;
+  float *pz = data + C_pos_z * _stride;
+  float *vx = data + C_vel_x * _stride;
+  float *vy = data + C_vel_y * _stride;
+  float *vz = data + C_vel_z * _stride;
+  const float *ax = data + C_accel_x * _stride;
+  const float *ay = data + C_accel_y * _stride;
+  const float *az = data + C_accel_z * _stride;
+  const float *inv_mass = data + C_inv_mass * _stride;
+
+  // x = x + v * t + 0.5 * a * t * t
+  // v = v + a * t
+  const float fx = md_force[0], fy = md_force[1], fz = md_force[2];
+  const float cx = accel[0], cy = accel[1], cz = accel[2];
+  const float d = damper;
+  const float t = dt;
+  const float half_tt = 0.5f * t * t;
+
+  int n = 0;
+#ifdef PARTICLE_ARRAYS_SSE
+  const __m128 fx4 = _mm_set1_ps(fx), fy4 = _mm_set1_ps(fy), fz4 = _mm_set1_ps(fz);
+  const __m128 cx4 = _mm_set1_ps(cx), cy4 = _mm_set1_ps(cy), cz4 = _mm_set1_ps(cz);
+  const __m128 d4 = _mm_set1_ps(d);
+  const __m128 t4 = _mm_set1_ps(t);
+  const __m128 half_tt4 = _mm_set1_ps(half_tt);
+  const __m128 zero4 = _mm_setzero_ps();
+  for (; n + 4 <= _num_particles; n += 4) {
+    __m128 im = _mm_loadu_ps(inv_mass + n);
+    __m128 ax4 = use_particle_accel ? _mm_loadu_ps(ax + n) : zero4;
+    __m128 ay4 = use_particle_accel ? _mm_loadu_ps(ay + n) : zero4;
+    __m128 az4 = use_particle_accel ? _mm_loadu_ps(az + n) : zero4;
+    ax4 = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(fx4, im), cx4), ax4), d4);
+    ay4 = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(fy4, im), cy4), ay4), d4);
+    az4 = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(fz4, im), cz4), az4), d4);
+
+    __m128 vx4 = _mm_loadu_ps(vx + n);
+    __m128 vy4 = _mm_loadu_ps(vy + n);
+    __m128 vz4 = _mm_loadu_ps(vz + n);
+    _mm_storeu_ps(px + n, _mm_add_ps(_mm_loadu_ps(px + n), _mm_add_ps(_mm_mul_ps(vx4, t4), _mm_mul_ps(ax4, half_tt4))));
+    _mm_storeu_ps(py + n, _mm_add_ps(_mm_loadu_ps(py + n), _mm_add_ps(_mm_mul_ps(vy4, t4), _mm_mul_ps(ay4, half_tt4))));
+    _mm_storeu_ps(pz + n, _mm_add_ps(_mm_loadu_ps(pz + n), _mm_add_ps(_mm_mul_ps(vz4, t4), _mm_mul_ps(az4, half_tt4))));
+    _mm_storeu_ps(vx + n, _mm_add_ps(vx4, _mm_mul_ps(ax4, t4)));
+    _mm_storeu_ps(vy + n, _mm_add_ps(vy4, _mm_mul_ps(ay4, t4)));
+    _mm_storeu_ps(vz + n, _mm_add_ps(vz4, _mm_mul_ps(az4, t4)));
+  }
+#endif  // PARTICLE_ARRAYS_SSE
+
+  for (; n < _num_particles; ++n) {
+    float ax1 = fx * inv_mass[n] + cx;
+    float ay1 = fy * inv_mass[n] + cy;
+    float az1 = fz * inv_mass[n] + cz;
+    if (use_particle_accel) {
+      ax1 += ax[n];
+      ay1 += ay[n];
+      az1 += az[n];
+    }
+    ax1 *= d;
+    ay1 *= d;
+    az1 *= d;
+
+    px[n] += vx[n] * t + ax1 * half_tt;
+    py[n] += vy[n] * t + ay1 * half_tt;
+    pz[n] += vz[n] * t + az1 * half_tt;
+    vx[n] += ax1 * t;
+    vy[n] += ay1 * t;
+    vz[n] += az1 * t;
+  }
+}
+
+/**
+ * Adds dt to the age of all of the particles.
+ */
+void ParticleArrays::
+add_age(PN_stdfloat dt) {
+  float *age = &_data[0] + C_age * _stride;
+  const float t = dt;
+
+  int n = 0;
+#ifdef PARTICLE_ARRAYS_SSE
+  const __m128 t4 = _mm_set1_ps(t);
+  for (; n + 4 <= _num_particles; n += 4) {
+    _mm_storeu_ps(age + n, _mm_add_ps(_mm_loadu_ps(age + n), t4));
+  }
+#endif  // PARTICLE_ARRAYS_SSE
+
+  for (; n < _num_particles; ++n) {
+    age[n] += t;
+  }
+}
+
+/**
+ * Computes the axis-aligned bounding box of the particle positions.  Returns
+ * false, leaving the parameters unchanged, if there are no particles.
+ */
+bool ParticleArrays::
+get_bounds(LPoint3 &min_point, LPoint3 &max_point) const {
+  if (_num_particles == 0) {
+    return false;
+  }
+
+  float mins[3], maxs[3];
+  for (int c = 0; c < 3; ++c) {
+    const float *p = &_data[0] + (C_pos_x + c) * _stride;
+    float lo = p[0];
+    float hi = p[0];
+
+    int n = 0;
+#ifdef PARTICLE_ARRAYS_SSE
+    if (_num_particles >= 4) {
+      __m128 lo4 = _mm_loadu_ps(p);
+      __m128 hi4 = lo4;
+      for (n = 4; n + 4 <= _num_particles; n += 4) {
+        __m128 v = _mm_loadu_ps(p + n);
+        lo4 = _mm_min_ps(lo4, v);
+        hi4 = _mm_max_ps(hi4, v);
+      }
+      float lo_v[4], hi_v[4];
+      _mm_storeu_ps(lo_v, lo4);
+      _mm_storeu_ps(hi_v, hi4);
+      for (int i = 0; i < 4; ++i) {
+        lo = std::min(lo, lo_v[i]);
+        hi = std::max(hi, hi_v[i]);
+      }
+    }
+#endif  // PARTICLE_ARRAYS_SSE
+
+    for (; n < _num_particles; ++n) {
+      lo = std::min(lo, p[n]);
+      hi = std::max(hi, p[n]);
+    }
+    mins[c] = lo;
+    maxs[c] = hi;
+  }
+
+  min_point.set(mins[0], mins[1], mins[2]);
+  max_point.set(maxs[0], maxs[1], maxs[2]);
+  return true;
+}
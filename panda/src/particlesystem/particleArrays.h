@@ -0,0 +1,92 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file particleArrays.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef PARTICLEARRAYS_H
+#define PARTICLEARRAYS_H
+
+#include "pandabase.h"
+#include "luse.h"
+#include "pvector.h"
+
+/**
+ * The particle storage used by a ParticleSystem in array mode.  Rather than
+ * one BaseParticle object per particle, the state of all of the particles is
+ * kept in a handful of contiguous float arrays, one per component, so that it
+ * can be aged, integrated and rendered by tight loops over the arrays.
+ *
+ * The living particles always occupy the first get_num_particles() elements
+ * of each array; removing a particle moves the last one into its place.
+ */
+class EXPCL_PANDA_PARTICLESYSTEM ParticleArrays {
+public:
+  enum Column {
+    C_pos_x,
+    C_pos_y,
+    C_pos_z,
+    C_vel_x,
+    C_vel_y,
+    C_vel_z,
+    C_accel_x,
+    C_accel_y,
+    C_accel_z,
+    C_age,
+    C_lifespan,
+    C_inv_mass,
+    C_terminal_velocity,
+
+    C_num_columns
+  };
+
+  ParticleArrays();
+
+  void set_capacity(int capacity);
+  INLINE int get_capacity() const;
+  INLINE int get_num_particles() const;
+
+  INLINE int add_particle(const LPoint3 &pos, const LVector3 &vel,
+                          PN_stdfloat lifespan, PN_stdfloat mass,
+                          PN_stdfloat terminal_velocity);
+  INLINE void remove_particle(int n);
+  INLINE void clear();
+
+  INLINE LPoint3 get_position(int n) const;
+  INLINE LVector3 get_velocity(int n) const;
+  INLINE PN_stdfloat get_age(int n) const;
+  INLINE PN_stdfloat get_lifespan(int n) const;
+  INLINE PN_stdfloat get_mass(int n) const;
+  INLINE PN_stdfloat get_terminal_velocity(int n) const;
+  INLINE PN_stdfloat get_parameterized_age(int n) const;
+  INLINE PN_stdfloat get_parameterized_vel(int n) const;
+
+  INLINE const float *get_column(Column column) const;
+  INLINE float *modify_column(Column column);
+
+  void clear_accel();
+  INLINE void add_accel(int n, const LVector3 &accel);
+
+  void integrate(const LVector3 &md_force, const LVector3 &accel,
+                 bool use_particle_accel, PN_stdfloat damper,
+                 PN_stdfloat dt);
+  void add_age(PN_stdfloat dt);
+  bool get_bounds(LPoint3 &min_point, LPoint3 &max_point) const;
+
+private:
+  pvector<float> _data;
+  int _capacity;
+  int _stride;
+  int _num_particles;
+};
+
+#include "particleArrays.I"
+
+#endif // PARTICLEARRAYS_H
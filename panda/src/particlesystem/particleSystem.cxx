@@ -28,6 +28,7 @@
 #include "pointParticleRenderer.h"
 #include "pointParticleFactory.h"
 #include "sphereSurfaceEmitter.h"
+#include "linearVectorForce.h"
 #include "pStatTimer.h"
 
 using std::cout;
@@ -37,6 +38,7 @@ using std::ostream;
 TypeHandle ParticleSystem::_type_handle;
 
 PStatCollector ParticleSystem::_update_collector("App:Particles:Update");
+PStatCollector ParticleSystem::_integrate_collector("App:Particles:Integrate");
 
 /**
  * Default Constructor.
@@ -60,6 +62,7 @@ ParticleSystem(int pool_size) :
   _i_was_spawned_flag = false;
   _particle_pool_size = 0;
   _floor_z = -HUGE_VAL;
+  _array_mode = false;
 
   // just in case someone tries to do something that requires the use of an
   // emitter, renderer, or factory before they've actually assigned one.  This
@@ -110,6 +113,7 @@ ParticleSystem(const ParticleSystem& copy) :
   _tics_since_birth = 0.0;
   _system_lifespan = copy._system_lifespan;
   _living_particles = 0;
+  _array_mode = copy._array_mode;
 
   set_pool_size(copy._particle_pool_size);
 }
@@ -133,6 +137,10 @@ ParticleSystem::
  */
 bool ParticleSystem::
 birth_particle() {
+  if (_array_mode) {
+    return birth_array_particle();
+  }
+
   int pool_index;
 
   // make sure there's room for a new particle
@@ -166,10 +174,29 @@ birth_particle() {
   bp->init();
 
   // get the location of the new particle.
-  LPoint3 new_pos, world_pos;
+  LPoint3 world_pos;
   LVector3 new_vel;
+  generate_birth_position(world_pos, new_vel);
 
-  _emitter->generate(new_pos, new_vel);
+  bp->reset_position(world_pos/* + (NORMALIZED_RAND() * new_vel)*/);
+  bp->set_velocity(new_vel);
+
+  ++_living_particles;
+
+  // propogate information down to renderer
+  _renderer->birth_particle(pool_index);
+
+  return true;
+}
+
+/**
+ * Asks the emitter for the position and velocity of a new particle, and
+ * transforms them from birth space to render space.
+ */
+void ParticleSystem::
+generate_birth_position(LPoint3 &pos, LVector3 &vel) {
+  LPoint3 new_pos;
+  _emitter->generate(new_pos, vel);
 
   // go from birth space to render space
   NodePath physical_np = get_physical_node_path();
@@ -177,22 +204,41 @@ birth_particle() {
 
   CPT(TransformState) transform = physical_np.get_transform(render_np);
   const LMatrix4 &birth_to_render_xform = transform->get_mat();
-  world_pos = new_pos * birth_to_render_xform;
+  pos = new_pos * birth_to_render_xform;
 
-  // cout << "New particle at " << world_pos << endl;
+  // cout << "New particle at " << pos << endl;
 
   // possibly transform the initial velocity as well.
   if (_local_velocity_flag == false)
-    new_vel = new_vel * birth_to_render_xform;
+    vel = vel * birth_to_render_xform;
+}
 
-  bp->reset_position(world_pos/* + (NORMALIZED_RAND() * new_vel)*/);
-  bp->set_velocity(new_vel);
+/**
+ * A new particle is born in array mode.  The factory fills in the scratch
+ * particle, from which the new particle takes its lifespan, mass and
+ * terminal velocity.
+ */
+bool ParticleSystem::
+birth_array_particle() {
+  // make sure there's room for a new particle
+  if (_living_particles >= _particle_pool_size) {
+    return false;
+  }
+  nassertr(_scratch_particle != nullptr, false);
+  BaseParticle *bp = (BaseParticle *) _scratch_particle.p();
 
-  ++_living_particles;
+  _factory->populate_particle(bp);
 
-  // propogate information down to renderer
-  _renderer->birth_particle(pool_index);
+  LPoint3 world_pos;
+  LVector3 new_vel;
+  generate_birth_position(world_pos, new_vel);
 
+  if (_arrays.add_particle(world_pos, new_vel, bp->get_lifespan(),
+                           bp->get_mass(), bp->get_terminal_velocity()) < 0) {
+    return false;
+  }
+
+  ++_living_particles;
   return true;
 }
 
@@ -309,6 +355,146 @@ kill_particle(int pool_index) {
   _living_particles--;
 }
 
+/**
+ * Kills the nth particle in array mode.  The last particle takes its place in
+ * the arrays.
+ */
+void ParticleSystem::
+kill_array_particle(int n) {
+  // create a new system where this one died, maybe.
+  if (_spawn_on_death_flag == true) {
+    BaseParticle *bp = (BaseParticle *) _scratch_particle.p();
+    bp->set_position(_arrays.get_position(n));
+    spawn_child_system(bp);
+  }
+
+  _arrays.remove_particle(n);
+  _living_particles--;
+}
+
+/**
+ * Ages the particles in array mode by dt, and kills those that have reached
+ * the end of their lifespan or gone under the floor.
+ */
+void ParticleSystem::
+age_array_particles(PN_stdfloat dt) {
+  _arrays.add_age(dt);
+
+  const float *age = _arrays.get_column(ParticleArrays::C_age);
+  const float *lifespan = _arrays.get_column(ParticleArrays::C_lifespan);
+  const float *pos_z = _arrays.get_column(ParticleArrays::C_pos_z);
+  bool have_floor = (get_floor_z() != -HUGE_VAL);
+  float floor_z = get_floor_z();
+
+  // Walk backwards, so that the particle moved into the place of a dead one
+  // has already been looked at.
+  for (int n = _arrays.get_num_particles() - 1; n >= 0; --n) {
+    if (age[n] >= lifespan[n] || (have_floor && pos_z[n] <= floor_z)) {
+      kill_array_particle(n);
+    }
+  }
+}
+
+/**
+ * Integrates the particles in array mode, in place of the LinearIntegrator.
+ * Forces that do not depend on the particle, such as a LinearVectorForce,
+ * are summed once and applied to all of the particles by a single pass over
+ * the arrays; any other forces are evaluated for each particle in turn.
+ */
+void ParticleSystem::
+integrate_linear_arrays(const LinearForceVector &forces,
+                        const epvector<LMatrix4> &matrices,
+                        PN_stdfloat dt) {
+  if (!_array_mode || _arrays.get_num_particles() == 0) {
+    return;
+  }
+  PStatTimer t1(_integrate_collector);
+
+  const LinearForceVector &local_forces = get_linear_forces();
+  nassertv(matrices.size() == forces.size() + local_forces.size());
+
+  LVector3 md_force(0.0f, 0.0f, 0.0f);
+  LVector3 accel(0.0f, 0.0f, 0.0f);
+  pvector<size_t> varying_forces;
+
+  for (size_t i = 0; i < matrices.size(); ++i) {
+    LinearForce *force = (i < forces.size()) ? forces[i].p() : local_forces[i - forces.size()].p();
+    if (!force->get_active()) {
+      continue;
+    }
+
+    if (force->is_exact_type(LinearVectorForce::get_class_type())) {
+      LVector3 f = force->get_vector(_scratch_particle) * matrices[i];
+      if (force->get_mass_dependent()) {
+        md_force += f;
+      } else {
+        accel += f;
+      }
+    } else {
+      varying_forces.push_back(i);
+    }
+  }
+
+  if (!varying_forces.empty()) {
+    _arrays.clear_accel();
+    int num_particles = _arrays.get_num_particles();
+    for (int n = 0; n < num_particles; ++n) {
+      PN_stdfloat mass = _arrays.get_mass(n);
+      _scratch_particle->set_position(_arrays.get_position(n));
+      _scratch_particle->set_velocity(_arrays.get_velocity(n));
+      _scratch_particle->set_mass(mass);
+
+      LVector3 particle_accel(0.0f, 0.0f, 0.0f);
+      for (size_t vi = 0; vi < varying_forces.size(); ++vi) {
+        size_t i = varying_forces[vi];
+        LinearForce *force = (i < forces.size()) ? forces[i].p() : local_forces[i - forces.size()].p();
+        LVector3 f = force->get_vector(_scratch_particle) * matrices[i];
+        if (force->get_mass_dependent()) {
+          f /= mass;
+        }
+        particle_accel += f;
+      }
+      _arrays.add_accel(n, particle_accel);
+    }
+  }
+
+  _arrays.integrate(md_force, accel, !varying_forces.empty(),
+                    1.0f - get_viscosity(), dt);
+}
+
+/**
+ * Puts the system into or out of array mode.  In array mode, the particles
+ * are not BaseParticle objects, but are kept in contiguous arrays that are
+ * aged, integrated and rendered in bulk, which is much faster for systems
+ * with many particles.  The particles are still created by the factory and
+ * emitter, and moved by the physics manager's linear forces.
+ *
+ * Array mode is only available with a renderer that supports it; see
+ * BaseParticleRenderer::supports_arrays().  The particles have no
+ * orientation, so angular forces and a factory's rotation settings have no
+ * effect on them.  All living particles are killed when the mode changes.
+ */
+void ParticleSystem::
+set_array_mode(bool flag) {
+  if (flag == _array_mode) {
+    return;
+  }
+  if (flag && !_renderer->supports_arrays()) {
+    particlesystem_cat.error()
+      << "ParticleSystem::set_array_mode: the renderer cannot render a "
+      << "particle system in array mode." << endl;
+    return;
+  }
+
+  int pool_size = _particle_pool_size;
+  set_pool_size(0);
+  _array_mode = flag;
+  if (!_array_mode) {
+    _arrays.set_capacity(0);
+  }
+  set_pool_size(pool_size);
+}
+
 /**
  * Resizes the particle pool
  */
@@ -338,6 +524,25 @@ resize_pool(int size) {
     return;
   }
 
+  if (_array_mode) {
+    // Kill off any particles that won't fit.
+    while (_arrays.get_num_particles() > size) {
+      kill_array_particle(_arrays.get_num_particles() - 1);
+    }
+    _particle_pool_size = size;
+    _arrays.set_capacity(size);
+    if (size == 0) {
+      // The factory may be about to change.
+      _scratch_particle.clear();
+    } else if (_scratch_particle == nullptr) {
+      _scratch_particle = _factory->alloc_particle();
+    }
+    if (delta != 0) {
+      _renderer->resize_pool(_particle_pool_size);
+    }
+    return;
+  }
+
   _particle_pool_size = size;
 
   // make sure the physics_objects array is OK
@@ -472,6 +677,12 @@ update(PN_stdfloat dt) {
        << ", live particles: " << _living_particles << endl;
   #endif
 
+  if (_array_mode) {
+    // The particles are in _arrays, not in _physics_objects.
+    age_array_particles(dt);
+    ttl_updates_left = 0;
+  }
+
   // run through the particle array
   while (ttl_updates_left) {
     current_index = index_counter;
@@ -25,6 +25,7 @@
 #include "baseParticleRenderer.h"
 #include "baseParticleEmitter.h"
 #include "baseParticleFactory.h"
+#include "particleArrays.h"
 
 class ParticleSystemManager;
 
@@ -85,6 +86,9 @@ PUBLISHED:
   INLINE PN_stdfloat get_floor_z() const;
   INLINE PN_stdfloat get_tics_since_birth() const;
 
+  void set_array_mode(bool flag);
+  INLINE bool get_array_mode() const;
+
   // particle template vector
 
   INLINE void add_spawn_template(ParticleSystem *ps);
@@ -105,6 +109,13 @@ PUBLISHED:
   virtual void write_spawn_templates(std::ostream &out, int indent=0) const;
   virtual void write(std::ostream &out, int indent=0) const;
 
+public:
+  INLINE const ParticleArrays &get_arrays() const;
+
+  virtual void integrate_linear_arrays(const LinearForceVector &forces,
+                                       const epvector<LMatrix4> &matrices,
+                                       PN_stdfloat dt);
+
 private:
   #ifdef PSSANITYCHECK
   int sanity_check();
@@ -112,6 +123,10 @@ private:
 
   bool birth_particle();
   void kill_particle(int pool_index);
+  void generate_birth_position(LPoint3 &pos, LVector3 &vel);
+  bool birth_array_particle();
+  void kill_array_particle(int n);
+  void age_array_particles(PN_stdfloat dt);
   void birth_litter();
   void resize_pool(int size);
 
@@ -157,6 +172,14 @@ private:
   // information for spawned systems
   bool _i_was_spawned_flag;
 
+  // In array mode, the particles are kept in _arrays instead of as
+  // BaseParticles in _physics_objects.  _scratch_particle is a BaseParticle
+  // that is filled in by the factory for each birth, and stands in for a
+  // particle wherever one is needed.
+  bool _array_mode;
+  ParticleArrays _arrays;
+  PT(PhysicsObject) _scratch_particle;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -177,6 +200,7 @@ private:
   friend class ParticleSystemManager; // particleSystemManager.h
 
   static PStatCollector _update_collector;
+  static PStatCollector _integrate_collector;
 };
 
 #include "particleSystem.I"
@@ -118,11 +118,9 @@ kill_particle(int) {
  * Generates the point color based on the render_type
  */
 LColor PointParticleRenderer::
-create_color(const BaseParticle *p) {
+create_color(PN_stdfloat parameterized_age, PN_stdfloat parameterized_vel) {
   LColor color;
   PN_stdfloat life_t, vel_t;
-  PN_stdfloat parameterized_age = 1.0f;
-  bool have_alpha_t = false;
 
   switch (_blend_type) {
   case PP_ONE_COLOR:
@@ -132,9 +130,7 @@ create_color(const BaseParticle *p) {
 
   case PP_BLEND_LIFE:
     // Blending colors based on life
-    parameterized_age = p->get_parameterized_age();
     life_t = parameterized_age;
-    have_alpha_t = true;
 
     if (_blend_method == PP_BLEND_CUBIC) {
       life_t = CUBIC_T(life_t);
@@ -145,7 +141,7 @@ create_color(const BaseParticle *p) {
 
   case PP_BLEND_VEL:
     // Blending colors based on vel
-    vel_t = p->get_parameterized_vel();
+    vel_t = parameterized_vel;
 
     if (_blend_method == PP_BLEND_CUBIC) {
       vel_t = CUBIC_T(vel_t);
@@ -160,10 +156,6 @@ create_color(const BaseParticle *p) {
     if (_alpha_mode == PR_ALPHA_USER) {
       parameterized_age = 1.0;
     } else {
-      if (!have_alpha_t) {
-        parameterized_age = p->get_parameterized_age();
-      }
-
       if (_alpha_mode == PR_ALPHA_OUT) {
         parameterized_age = 1.0f - parameterized_age;
       } else if (_alpha_mode == PR_ALPHA_IN_OUT) {
@@ -231,7 +223,11 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
     // stuff it into the arrays
 
     vertex.add_data3(position);
-    color.add_data4(create_color(cur_particle));
+    PN_stdfloat vel_t = 0.0f;
+    if (_blend_type == PP_BLEND_VEL) {
+      vel_t = cur_particle->get_parameterized_vel();
+    }
+    color.add_data4(create_color(cur_particle->get_parameterized_age(), vel_t));
 
     // maybe jump out early?
 
@@ -253,6 +249,100 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
   get_render_node()->mark_internal_bounds_stale();
 }
 
+/**
+ * Populates the GeomVertexData directly from the arrays of a particle system
+ * in array mode.
+ */
+void PointParticleRenderer::
+render_arrays(const ParticleArrays &arrays) {
+  PStatTimer t1(_render_collector);
+
+  int num_particles = arrays.get_num_particles();
+  const float *px = arrays.get_column(ParticleArrays::C_pos_x);
+  const float *py = arrays.get_column(ParticleArrays::C_pos_y);
+  const float *pz = arrays.get_column(ParticleArrays::C_pos_z);
+  const float *age = arrays.get_column(ParticleArrays::C_age);
+  const float *lifespan = arrays.get_column(ParticleArrays::C_lifespan);
+
+  const GeomVertexFormat *format = _vdata->get_format();
+  const GeomVertexColumn *vertex_column = format->get_vertex_column();
+  const GeomVertexColumn *color_column = format->get_color_column();
+  bool direct =
+    format->get_num_arrays() == 1 &&
+    vertex_column->get_numeric_type() == GeomEnums::NT_float32 &&
+    vertex_column->get_num_components() == 3 &&
+    color_column->get_numeric_type() == GeomEnums::NT_packed_dabc;
+
+  if (direct) {
+    // The usual case: write the positions and packed colors straight into
+    // the vertex array, without going through a GeomVertexWriter.
+    PT(GeomVertexArrayDataHandle) handle = _vdata->modify_array_handle(0);
+    handle->unclean_set_num_rows(num_particles);
+    unsigned char *pointer = handle->get_write_pointer();
+    int stride = format->get_array(0)->get_stride();
+    int vertex_start = vertex_column->get_start();
+    int color_start = color_column->get_start();
+
+    for (int n = 0; n < num_particles; ++n) {
+      PN_float32 *v = (PN_float32 *)(pointer + vertex_start);
+      v[0] = px[n];
+      v[1] = py[n];
+      v[2] = pz[n];
+
+      PN_stdfloat life_t = (lifespan[n] <= 0.0f) ? 1.0f : age[n] / lifespan[n];
+      PN_stdfloat vel_t = 0.0f;
+      if (_blend_type == PP_BLEND_VEL) {
+        vel_t = arrays.get_parameterized_vel(n);
+      }
+      LColor c = create_color(life_t, vel_t);
+      *(uint32_t *)(pointer + color_start) = GeomVertexData::pack_abcd
+        ((unsigned int)(std::min(std::max(c[3], (PN_stdfloat)0), (PN_stdfloat)1) * 255.0f),
+         (unsigned int)(std::min(std::max(c[0], (PN_stdfloat)0), (PN_stdfloat)1) * 255.0f),
+         (unsigned int)(std::min(std::max(c[1], (PN_stdfloat)0), (PN_stdfloat)1) * 255.0f),
+         (unsigned int)(std::min(std::max(c[2], (PN_stdfloat)0), (PN_stdfloat)1) * 255.0f));
+
+      pointer += stride;
+    }
+
+  } else {
+    _vdata->unclean_set_num_rows(num_particles);
+    GeomVertexWriter vertex(_vdata, InternalName::get_vertex());
+    GeomVertexWriter color(_vdata, InternalName::get_color());
+
+    for (int n = 0; n < num_particles; ++n) {
+      vertex.set_data3f(px[n], py[n], pz[n]);
+
+      PN_stdfloat vel_t = 0.0f;
+      if (_blend_type == PP_BLEND_VEL) {
+        vel_t = arrays.get_parameterized_vel(n);
+      }
+      color.set_data4(create_color(arrays.get_parameterized_age(n), vel_t));
+    }
+  }
+
+  _points->clear_vertices();
+  _points->add_next_vertices(num_particles);
+
+  _aabb_min.set(99999.0f, 99999.0f, 99999.0f);
+  _aabb_max.set(-99999.0f, -99999.0f, -99999.0f);
+  arrays.get_bounds(_aabb_min, _aabb_max);
+
+  LPoint3 aabb_center = _aabb_min + ((_aabb_max - _aabb_min) * 0.5f);
+  PN_stdfloat radius = (aabb_center - _aabb_min).length();
+
+  BoundingSphere sphere(aabb_center, radius);
+  _point_primitive->set_bounds(&sphere);
+  get_render_node()->mark_internal_bounds_stale();
+}
+
+/**
+ * Returns true, since this renderer can draw a particle system in array mode.
+ */
+bool PointParticleRenderer::
+supports_arrays() const {
+  return true;
+}
+
 /**
  * Write a string representation of this instance to <out>.
  */
@@ -50,6 +50,7 @@ PUBLISHED:
 
 public:
   virtual BaseParticleRenderer *make_copy();
+  virtual bool supports_arrays() const;
 
 PUBLISHED:
   INLINE void set_point_size(PN_stdfloat point_size);
@@ -85,13 +86,15 @@ private:
   LPoint3 _aabb_min;
   LPoint3 _aabb_max;
 
-  LColor create_color(const BaseParticle *p);
+  LColor create_color(PN_stdfloat parameterized_age,
+                      PN_stdfloat parameterized_vel);
 
   virtual void birth_particle(int index);
   virtual void kill_particle(int index);
   virtual void init_geoms();
   virtual void render(pvector< PT(PhysicsObject) >& po_vector,
                       int ttl_particles);
+  virtual void render_arrays(const ParticleArrays &arrays);
   virtual void resize_pool(int new_size);
 
   static PStatCollector _render_collector;
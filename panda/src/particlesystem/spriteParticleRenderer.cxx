@@ -534,7 +534,6 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
   int remaining_particles = ttl_particles;
   int i,j;                                  // loop counters
   int anim_count = _anims.size();           // number of animations
-  int frame;                                // frame index, used in indicating which frame to use when not animated
   // First, since this is the only time we have access to the actual
   // particles, do some delayed initialization.
   if (_animate_frames || anim_count) {
@@ -563,20 +562,7 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
   }
   _birth_list.clear();
 
-  // Create vertex writers for each of the possible geoms.  Could possibly be
-  // changed to only create writers for geoms that would be used according to
-  // the animation configuration.
-  for (i = 0; i < anim_count; ++i) {
-    for (j = 0; j < _anim_size[i]; ++j) {
-      // Set the particle per frame counts to 0.
-      memset(_ttl_count[i], 0, _anim_size[i]*sizeof(int));
-      _sprite_writer[i][j].vertex = GeomVertexWriter(_vdata[i][j], InternalName::get_vertex());
-      _sprite_writer[i][j].color = GeomVertexWriter(_vdata[i][j], InternalName::get_color());
-      _sprite_writer[i][j].rotate = GeomVertexWriter(_vdata[i][j], InternalName::get_rotate());
-      _sprite_writer[i][j].size = GeomVertexWriter(_vdata[i][j], InternalName::get_size());
-      _sprite_writer[i][j].aspect_ratio = GeomVertexWriter(_vdata[i][j], InternalName::get_aspect_ratio());
-    }
-  }
+  begin_sprites();
 
   // init the aabb
   _aabb_min.set(99999.0f, 99999.0f, 99999.0f);
@@ -622,80 +608,173 @@ render(pvector< PT(PhysicsObject) >& po_vector, int ttl_particles) {
       cur_particle->set_index(anim_index);
     }
 
-    // Find the frame
-    if (_animate_frames) {
-      if (_animate_frames_rate == 0.0f) {
-        frame = (int)(t*_anim_size[anim_index]);
-      } else {
-        frame = (int)fmod(cur_particle->get_age()*_animate_frames_rate+1,_anim_size[anim_index]);
-      }
-    } else {
-      frame = _animate_frames_index;
-    }
+    write_sprite(anim_index, position, t, cur_particle->get_age(),
+                 cur_particle->get_theta());
 
-    // Quick check make sure our math above didn't result in an invalid frame.
-    frame = (frame < _anim_size[anim_index]) ? frame : (_anim_size[anim_index]-1);
-    ++_ttl_count[anim_index][frame];
-
-    // Calculate the color This is where we'll want to give the renderer the
-    // new color
-    LColor c = _color_interpolation_manager->generateColor(t);
-
-    int alphamode=get_alpha_mode();
-    if (alphamode != PR_ALPHA_NONE) {
-      if (alphamode == PR_ALPHA_OUT)
-        c[3] *= (1.0f - t) * get_user_alpha();
-      else if (alphamode == PR_ALPHA_IN)
-        c[3] *= t * get_user_alpha();
-      else if (alphamode == PR_ALPHA_IN_OUT) {
-        c[3] *= 2.0f * min(t, 1.0f - t) * get_user_alpha();
-      }
-      else {
-        assert(alphamode == PR_ALPHA_USER);
-        c[3] *= get_user_alpha();
-      }
+    // maybe jump out early?
+    remaining_particles--;
+    if (remaining_particles == 0) {
+      break;
     }
+  }
+  end_sprites();
+}
 
-    // Send the data on its way...
-    _sprite_writer[anim_index][frame].vertex.add_data3(position);
-    _sprite_writer[anim_index][frame].color.add_data4(c);
+/**
+ * Populates the GeomVertexData directly from the arrays of a particle system
+ * in array mode.  These particles have no animation index or rotation of
+ * their own, so they are all drawn with the first animation and the fixed
+ * rotation.
+ */
+void SpriteParticleRenderer::
+render_arrays(const ParticleArrays &arrays) {
+  PStatTimer t1(_render_collector);
+  // There is no texture data available, exit.
+  if (_anims.empty()) {
+    return;
+  }
 
-    PN_stdfloat current_x_scale = _initial_x_scale;
-    PN_stdfloat current_y_scale = _initial_y_scale;
+  begin_sprites();
 
-    if (_animate_x_ratio || _animate_y_ratio) {
-      if (_blend_method == PP_BLEND_CUBIC) {
-        t = CUBIC_T(t);
-      }
+  _aabb_min.set(99999.0f, 99999.0f, 99999.0f);
+  _aabb_max.set(-99999.0f, -99999.0f, -99999.0f);
+  LPoint3 min_point, max_point;
+  if (arrays.get_bounds(min_point, max_point)) {
+    _aabb_min = min_point;
+    _aabb_max = max_point;
+  }
 
-      if (_animate_x_ratio) {
-        current_x_scale = (_initial_x_scale +
-                           (t * (_final_x_scale - _initial_x_scale)));
-      }
-      if (_animate_y_ratio) {
-        current_y_scale = (_initial_y_scale +
-                           (t * (_final_y_scale - _initial_y_scale)));
-      }
+  int num_particles = arrays.get_num_particles();
+  const float *px = arrays.get_column(ParticleArrays::C_pos_x);
+  const float *py = arrays.get_column(ParticleArrays::C_pos_y);
+  const float *pz = arrays.get_column(ParticleArrays::C_pos_z);
+  const float *age = arrays.get_column(ParticleArrays::C_age);
+  const float *lifespan = arrays.get_column(ParticleArrays::C_lifespan);
+
+  for (int n = 0; n < num_particles; ++n) {
+    PN_stdfloat t = (lifespan[n] <= 0.0f) ? 1.0f : age[n] / lifespan[n];
+    write_sprite(0, LPoint3(px[n], py[n], pz[n]), t, age[n], _theta);
+  }
+
+  end_sprites();
+}
+
+/**
+ * Returns true, since this renderer can draw a particle system in array mode.
+ */
+bool SpriteParticleRenderer::
+supports_arrays() const {
+  return true;
+}
+
+/**
+ * Prepares the vertex writers and per-frame counts for a call to
+ * write_sprite() for each particle.
+ */
+void SpriteParticleRenderer::
+begin_sprites() {
+  // Create vertex writers for each of the possible geoms.  Could possibly be
+  // changed to only create writers for geoms that would be used according to
+  // the animation configuration.
+  int anim_count = _anims.size();
+  for (int i = 0; i < anim_count; ++i) {
+    for (int j = 0; j < _anim_size[i]; ++j) {
+      // Set the particle per frame counts to 0.
+      memset(_ttl_count[i], 0, _anim_size[i]*sizeof(int));
+      _sprite_writer[i][j].vertex = GeomVertexWriter(_vdata[i][j], InternalName::get_vertex());
+      _sprite_writer[i][j].color = GeomVertexWriter(_vdata[i][j], InternalName::get_color());
+      _sprite_writer[i][j].rotate = GeomVertexWriter(_vdata[i][j], InternalName::get_rotate());
+      _sprite_writer[i][j].size = GeomVertexWriter(_vdata[i][j], InternalName::get_size());
+      _sprite_writer[i][j].aspect_ratio = GeomVertexWriter(_vdata[i][j], InternalName::get_aspect_ratio());
+    }
+  }
+}
+
+/**
+ * Adds a single particle to the geom for the indicated animation, at the
+ * frame determined by its age.  t is the particle's parameterized age.
+ */
+void SpriteParticleRenderer::
+write_sprite(int anim_index, const LPoint3 &position, PN_stdfloat t,
+             PN_stdfloat age, PN_stdfloat theta) {
+  // Find the frame
+  int frame;
+  if (_animate_frames) {
+    if (_animate_frames_rate == 0.0f) {
+      frame = (int)(t*_anim_size[anim_index]);
+    } else {
+      frame = (int)fmod(age*_animate_frames_rate+1,_anim_size[anim_index]);
     }
+  } else {
+    frame = _animate_frames_index;
+  }
 
-    if (_sprite_writer[anim_index][frame].size.has_column()) {
-      _sprite_writer[anim_index][frame].size.add_data1f(current_y_scale * _height);
+  // Quick check make sure our math above didn't result in an invalid frame.
+  frame = (frame < _anim_size[anim_index]) ? frame : (_anim_size[anim_index]-1);
+  ++_ttl_count[anim_index][frame];
+
+  // Calculate the color This is where we'll want to give the renderer the
+  // new color
+  LColor c = _color_interpolation_manager->generateColor(t);
+
+  int alphamode=get_alpha_mode();
+  if (alphamode != PR_ALPHA_NONE) {
+    if (alphamode == PR_ALPHA_OUT)
+      c[3] *= (1.0f - t) * get_user_alpha();
+    else if (alphamode == PR_ALPHA_IN)
+      c[3] *= t * get_user_alpha();
+    else if (alphamode == PR_ALPHA_IN_OUT) {
+      c[3] *= 2.0f * min(t, 1.0f - t) * get_user_alpha();
     }
-    if (_sprite_writer[anim_index][frame].aspect_ratio.has_column()) {
-      _sprite_writer[anim_index][frame].aspect_ratio.add_data1f(_aspect_ratio * current_x_scale / current_y_scale);
+    else {
+      assert(alphamode == PR_ALPHA_USER);
+      c[3] *= get_user_alpha();
     }
-    if (_animate_theta) {
-      _sprite_writer[anim_index][frame].rotate.add_data1f(cur_particle->get_theta());
-    } else if (_sprite_writer[anim_index][frame].rotate.has_column()) {
-      _sprite_writer[anim_index][frame].rotate.add_data1f(_theta);
+  }
+
+  // Send the data on its way...
+  _sprite_writer[anim_index][frame].vertex.add_data3(position);
+  _sprite_writer[anim_index][frame].color.add_data4(c);
+
+  PN_stdfloat current_x_scale = _initial_x_scale;
+  PN_stdfloat current_y_scale = _initial_y_scale;
+
+  if (_animate_x_ratio || _animate_y_ratio) {
+    if (_blend_method == PP_BLEND_CUBIC) {
+      t = CUBIC_T(t);
     }
 
-    // maybe jump out early?
-    remaining_particles--;
-    if (remaining_particles == 0) {
-      break;
+    if (_animate_x_ratio) {
+      current_x_scale = (_initial_x_scale +
+                         (t * (_final_x_scale - _initial_x_scale)));
     }
+    if (_animate_y_ratio) {
+      current_y_scale = (_initial_y_scale +
+                         (t * (_final_y_scale - _initial_y_scale)));
+    }
+  }
+
+  if (_sprite_writer[anim_index][frame].size.has_column()) {
+    _sprite_writer[anim_index][frame].size.add_data1f(current_y_scale * _height);
   }
+  if (_sprite_writer[anim_index][frame].aspect_ratio.has_column()) {
+    _sprite_writer[anim_index][frame].aspect_ratio.add_data1f(_aspect_ratio * current_x_scale / current_y_scale);
+  }
+  if (_animate_theta) {
+    _sprite_writer[anim_index][frame].rotate.add_data1f(theta);
+  } else if (_sprite_writer[anim_index][frame].rotate.has_column()) {
+    _sprite_writer[anim_index][frame].rotate.add_data1f(_theta);
+  }
+}
+
+/**
+ * Finishes the geoms after the particles have been written, and updates their
+ * bounding volume from _aabb_min and _aabb_max.
+ */
+void SpriteParticleRenderer::
+end_sprites() {
+  int i, j;
+  int anim_count = _anims.size();
   int n = 0;
   GeomNode *render_node = get_render_node();
 
@@ -159,6 +159,7 @@ PUBLISHED:
 
 public:
   virtual BaseParticleRenderer *make_copy();
+  virtual bool supports_arrays() const;
 
 PUBLISHED:
   void set_from_node(const NodePath &node_path, bool size_from_texels = false);
@@ -262,7 +263,12 @@ private:
   virtual void init_geoms();
   virtual void render(pvector< PT(PhysicsObject) > &po_vector,
                       int ttl_particles);
+  virtual void render_arrays(const ParticleArrays &arrays);
   virtual void resize_pool(int new_size);
+  void begin_sprites();
+  void write_sprite(int anim_index, const LPoint3 &position, PN_stdfloat t,
+                    PN_stdfloat age, PN_stdfloat theta);
+  void end_sprites();
   int extract_textures_from_node(const NodePath &node_path, NodePathCollection &np_col, TextureCollection &tex_col);
 
   vector_int _anim_size;   // Holds the number of frames in each animation.
@@ -0,0 +1,206 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file childBoundsTree.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "childBoundsTree.h"
+#include "clipPlaneAttrib.h"
+#include "boundingBox.h"
+
+#include <algorithm>
+
+/**
+ * Builds a tree over the indicated children, given the entries computed for
+ * each of them, in the same order.
+ */
+ChildBoundsTree::
+ChildBoundsTree(const pvector<PandaNode *> &children, const Entries &entries) :
+  _root_span(1),
+  _num_children(entries.size())
+{
+  nassertv(children.size() == entries.size());
+
+  PT(Index) index = new Index;
+  index->_entries.reserve(_num_children);
+  for (size_t i = 0; i < _num_children; ++i) {
+    index->_entries.push_back(IndexEntry(children[i], (int)i));
+  }
+  std::sort(index->_entries.begin(), index->_entries.end());
+  _index = index;
+
+  // Fill in the bottom level, then group the blocks of each level into the
+  // level above until only the root remains.
+  pvector<PT(Block) > level;
+  for (size_t i = 0; i < _num_children; i += fanout) {
+    Block *block = new Block;
+    block->_num_entries = (int)std::min((size_t)fanout, _num_children - i);
+    std::copy(entries.begin() + i, entries.begin() + i + block->_num_entries,
+              block->_entries);
+    level.push_back(block);
+  }
+
+  while (level.size() > 1) {
+    pvector<PT(Block) > next_level;
+    for (size_t i = 0; i < level.size(); i += fanout) {
+      Block *block = new Block;
+      block->_num_entries = (int)std::min((size_t)fanout, level.size() - i);
+      for (int j = 0; j < block->_num_entries; ++j) {
+        Block *child = level[i + j];
+        block->_blocks[j] = child;
+        combine(block->_entries[j], child->_entries,
+                child->_entries + child->_num_entries);
+      }
+      next_level.push_back(block);
+    }
+    level.swap(next_level);
+    _root_span *= fanout;
+  }
+
+  if (level.empty()) {
+    _root = new Block;
+  } else {
+    _root = level[0];
+  }
+  combine(_total, _root->_entries, _root->_entries + _root->_num_entries);
+}
+
+/**
+ * Returns the index of the indicated child within the list of children the
+ * tree was built for, or -1 if it is not one of them.
+ */
+int ChildBoundsTree::
+find_child(PandaNode *child) const {
+  pvector<IndexEntry>::const_iterator it =
+    std::lower_bound(_index->_entries.begin(), _index->_entries.end(),
+                     IndexEntry(child, 0));
+  if (it != _index->_entries.end() && (*it).first == child) {
+    return (*it).second;
+  }
+  return -1;
+}
+
+/**
+ * Returns the entry for the nth child.
+ */
+const ChildBoundsTree::Entry &ChildBoundsTree::
+get_entry(size_t n) const {
+  static Entry empty_entry;
+  nassertr(n < _num_children, empty_entry);
+
+  const Block *block = _root;
+  size_t span = _root_span;
+  while (span > 1) {
+    block = block->_blocks[n / span];
+    n %= span;
+    span /= fanout;
+  }
+  return block->_entries[n];
+}
+
+/**
+ * Replaces the entry for the nth child, and recomputes the groups that
+ * contain it, and the total.  Any groups that are shared with another tree
+ * are copied first.
+ */
+void ChildBoundsTree::
+set_entry(size_t n, const Entry &entry) {
+  nassertv(n < _num_children);
+
+  Block *path[max_depth];
+  int indices[max_depth];
+  int depth = 0;
+
+  PT(Block) *slot = &_root;
+  size_t span = _root_span;
+  while (true) {
+    Block *block = *slot;
+    if (block->get_ref_count() > 1) {
+      *slot = new Block(*block);
+      block = *slot;
+    }
+    nassertv(depth < max_depth);
+    int i = (int)(n / span);
+    n %= span;
+    path[depth] = block;
+    indices[depth] = i;
+    ++depth;
+
+    if (span == 1) {
+      block->_entries[i] = entry;
+      break;
+    }
+    slot = &block->_blocks[i];
+    span /= fanout;
+  }
+
+  for (int d = depth - 2; d >= 0; --d) {
+    Block *child = path[d + 1];
+    combine(path[d]->_entries[indices[d]], child->_entries,
+            child->_entries + child->_num_entries);
+  }
+  combine(_total, _root->_entries, _root->_entries + _root->_num_entries);
+}
+
+/**
+ * Accumulates the indicated range of entries into a single entry, in the same
+ * way that PandaNode::update_cached() accumulates its children.  The bounding
+ * volume of the result is a box around all of the volumes, since that is
+ * exactly their union along each axis, while a sphere around spheres around
+ * spheres would grow looser with each level of the tree.
+ */
+void ChildBoundsTree::
+combine(Entry &result, const Entry *begin, const Entry *end) {
+  const BoundingVolume **volumes = (const BoundingVolume **)alloca(sizeof(BoundingVolume *) * (end - begin));
+  int num_volumes = 0;
+  bool all_box = true;
+
+  CollideMask net_collide_mask;
+  DrawMask net_draw_control_mask, net_draw_show_mask;
+  CPT(RenderAttrib) off_clip_planes;
+  int nested_vertices = 0;
+
+  for (const Entry *entry = begin; entry != end; ++entry) {
+    net_collide_mask |= entry->_net_collide_mask;
+    compose_draw_masks(net_draw_control_mask, net_draw_show_mask,
+                       entry->_net_draw_control_mask,
+                       entry->_net_draw_show_mask);
+
+    if (off_clip_planes == nullptr) {
+      off_clip_planes = entry->_off_clip_planes;
+    } else if (entry->_off_clip_planes != nullptr &&
+               entry->_off_clip_planes != off_clip_planes) {
+      off_clip_planes = DCAST(ClipPlaneAttrib, off_clip_planes)->compose_off(entry->_off_clip_planes);
+    }
+
+    nested_vertices += entry->_nested_vertices;
+
+    if (entry->_bounds != nullptr) {
+      volumes[num_volumes++] = entry->_bounds;
+    }
+    all_box = all_box && entry->_all_box;
+  }
+
+  if (num_volumes == 0) {
+    result._bounds = nullptr;
+  } else if (num_volumes == 1) {
+    result._bounds = volumes[0];
+  } else {
+    PT(BoundingVolume) bounds = new BoundingBox;
+    bounds->around(volumes, volumes + num_volumes);
+    result._bounds = bounds;
+  }
+  result._all_box = all_box;
+  result._off_clip_planes = std::move(off_clip_planes);
+  result._net_collide_mask = net_collide_mask;
+  result._net_draw_control_mask = net_draw_control_mask;
+  result._net_draw_show_mask = net_draw_show_mask;
+  result._nested_vertices = nested_vertices;
+}
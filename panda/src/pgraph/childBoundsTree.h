@@ -0,0 +1,113 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file childBoundsTree.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef CHILDBOUNDSTREE_H
+#define CHILDBOUNDSTREE_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "boundingVolume.h"
+#include "renderAttrib.h"
+#include "collideMask.h"
+#include "drawMask.h"
+#include "pvector.h"
+
+class PandaNode;
+
+/**
+ * Used by a PandaNode with many children to accumulate the values that it
+ * derives from its children (the external bounding volume, the net collide
+ * and draw masks, and so on) over fixed-size groups of children, and groups
+ * of those groups, up to a single total.  When one child changes, only the
+ * groups along the path to that child need to be recomputed, which takes
+ * O(log n) time instead of O(n).
+ *
+ * The tree is immutable once it is shared: set_entry() copies each group
+ * that it modifies if another tree still references it, so a modified copy
+ * of a tree costs only as much as the path that changed, and the original
+ * remains valid for other pipeline stages.
+ */
+class EXPCL_PANDA_PGRAPH ChildBoundsTree : public ReferenceCount {
+public:
+  // The values derived from one child, or accumulated over a group.
+  class Entry {
+  public:
+    INLINE Entry();
+    INLINE void set(const BoundingVolume *bounds,
+                    const RenderAttrib *off_clip_planes,
+                    CollideMask net_collide_mask,
+                    DrawMask net_draw_control_mask,
+                    DrawMask net_draw_show_mask, int nested_vertices);
+
+    // NULL if the volume is empty.  To keep the groups tight, the volume of
+    // a group is always a box; _all_box records whether the volumes of all
+    // of the children in it were boxes.
+    CPT(BoundingVolume) _bounds;
+    bool _all_box;
+    CPT(RenderAttrib) _off_clip_planes;
+    CollideMask _net_collide_mask;
+    DrawMask _net_draw_control_mask;
+    DrawMask _net_draw_show_mask;
+    int _nested_vertices;
+  };
+  typedef pvector<Entry> Entries;
+
+  ChildBoundsTree(const pvector<PandaNode *> &children,
+                  const Entries &entries);
+  INLINE ChildBoundsTree(const ChildBoundsTree &copy);
+
+  INLINE size_t get_num_children() const;
+  INLINE bool should_rebuild(size_t num_stale) const;
+  int find_child(PandaNode *child) const;
+
+  const Entry &get_entry(size_t n) const;
+  void set_entry(size_t n, const Entry &entry);
+  INLINE const Entry &get_total() const;
+
+  static void combine(Entry &result, const Entry *begin, const Entry *end);
+  INLINE static void compose_draw_masks(DrawMask &net_control_mask,
+                                        DrawMask &net_show_mask,
+                                        const DrawMask &child_control_mask,
+                                        const DrawMask &child_show_mask);
+
+private:
+  enum { fanout = 16, max_depth = 8 };
+
+  // A group of up to fanout entries.  Above the bottom level, each entry
+  // accumulates the entries of the corresponding block one level down.
+  class Block : public ReferenceCount {
+  public:
+    Entry _entries[fanout];
+    PT(Block) _blocks[fanout];
+    int _num_entries = 0;
+  };
+
+  // The children in pointer order, with their indices, for find_child().
+  // This never changes after the tree is built, so it is shared by copies.
+  typedef std::pair<PandaNode *, int> IndexEntry;
+  class Index : public ReferenceCount {
+  public:
+    pvector<IndexEntry> _entries;
+  };
+
+  PT(Block) _root;
+  size_t _root_span;
+  size_t _num_children;
+  Entry _total;
+  CPT(Index) _index;
+};
+
+#include "childBoundsTree.I"
+
+#endif
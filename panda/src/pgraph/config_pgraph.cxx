@@ -36,6 +36,7 @@
 #include "depthOffsetAttrib.h"
 #include "depthTestAttrib.h"
 #include "depthWriteAttrib.h"
+#include "filePrefetchRequest.h"
 #include "findApproxLevelEntry.h"
 #include "fog.h"
 #include "fogAttrib.h"
@@ -130,6 +131,18 @@ ConfigVariableBool debug_portal_cull
           "(You first need to enable portal culling, using the allow-portal-cull"
           "variable.)"));
 
+ConfigVariableBool cull_arena
+("cull-arena", true,
+ PRC_DESC("Set this true to allocate the CullableObjects created during each "
+          "frame's cull traversal from an arena that is released all at once "
+          "after the frame has been drawn, or false to allocate each one "
+          "individually."));
+
+ConfigVariableInt cull_arena_chunk_size
+("cull-arena-chunk-size", 65536,
+ PRC_DESC("The size in bytes of each block of memory that a cull arena "
+          "allocates at a time."));
+
 ConfigVariableBool show_occluder_volumes
 ("show-occluder-volumes", false,
  PRC_DESC("Set this true to enable debug visualization of the volumes used "
@@ -147,6 +160,26 @@ ConfigVariableBool detect_graph_cycles
           "(e.g. a node which is its own parent) as soon as they are "
           "made.  This has no effect in NDEBUG mode."));
 
+ConfigVariableInt incremental_bounds_min_children
+("incremental-bounds-min-children", 64,
+ PRC_DESC("A node with at least this many children keeps the bounding "
+          "volumes and masks of its children grouped in a tree, so that when "
+          "only a few of the children change, its bounding volume can be "
+          "recomputed in time proportional to the logarithm of the number of "
+          "children, instead of walking through all of them.  The "
+          "resulting volume may be a little looser than one computed "
+          "directly from the children.  Set this to 0 to disable."));
+
+ConfigVariableInt child_records_min_children
+("child-records-min-children", 64,
+ PRC_DESC("A node with at least this many children keeps a compact copy of "
+          "the bounding volume, draw mask and collide mask of each child in "
+          "one contiguous array, so that the cull and collision traversals "
+          "can pass over the children that are hidden or out of bounds "
+          "without visiting each child node.  This costs some memory and a "
+          "little time whenever the bounds of the node are recomputed.  Set "
+          "this to 0 to disable."));
+
 ConfigVariableBool no_unsupported_copy
 ("no-unsupported-copy", false,
  PRC_DESC("Set this true to make an attempt to copy an unsupported type "
@@ -364,6 +397,15 @@ ConfigVariableString default_model_extension
           "Panda's loader; new code should probably give the correct name "
           "for each model file they intend to load."));
 
+ConfigVariableInt64 model_pool_ram_budget
+("model-pool-ram-budget", 0,
+ PRC_DESC("The maximum number of bytes of main RAM that the vertex and index "
+          "data of the models in the ModelPool may occupy, or 0 for no "
+          "limit.  When a newly loaded model takes the pool over this "
+          "budget, the least-recently-used models that are not referenced "
+          "outside of the pool are released, and will be loaded again if "
+          "they are requested later."));
+
 ConfigVariableBool allow_live_flatten
 ("allow-live-flatten", true,
  PRC_DESC("Set this true to allow the use of flatten_strong() or any "
@@ -417,6 +459,7 @@ init_libpgraph() {
   DepthOffsetAttrib::init_type();
   DepthTestAttrib::init_type();
   DepthWriteAttrib::init_type();
+  FilePrefetchRequest::init_type();
   FindApproxLevelEntry::init_type();
   Fog::init_type();
   FogAttrib::init_type();
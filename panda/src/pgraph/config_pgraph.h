@@ -19,6 +19,7 @@
 #include "dconfig.h"
 #include "configVariableBool.h"
 #include "configVariableInt.h"
+#include "configVariableInt64.h"
 #include "configVariableDouble.h"
 #include "configVariableList.h"
 #include "configVariableString.h"
@@ -34,9 +35,13 @@ extern ConfigVariableBool fake_view_frustum_cull;
 extern ConfigVariableBool clip_plane_cull;
 extern ConfigVariableBool allow_portal_cull;
 extern ConfigVariableBool debug_portal_cull;
+extern ConfigVariableBool cull_arena;
+extern ConfigVariableInt cull_arena_chunk_size;
 extern ConfigVariableBool show_occluder_volumes;
 extern ConfigVariableBool unambiguous_graph;
 extern ConfigVariableBool detect_graph_cycles;
+extern EXPCL_PANDA_PGRAPH ConfigVariableInt incremental_bounds_min_children;
+extern EXPCL_PANDA_PGRAPH ConfigVariableInt child_records_min_children;
 extern ConfigVariableBool no_unsupported_copy;
 extern ConfigVariableBool allow_unrelated_wrt;
 extern ConfigVariableBool paranoid_compose;
@@ -71,6 +76,7 @@ extern ConfigVariableBool m_dual_flash;
 
 extern ConfigVariableList load_file_type;
 extern ConfigVariableString default_model_extension;
+extern ConfigVariableInt64 model_pool_ram_budget;
 
 extern ConfigVariableBool allow_live_flatten;
 
@@ -0,0 +1,220 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullArena.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "cullArena.h"
+#include "config_pgraph.h"
+#include "lightMutexHolder.h"
+#include "memoryHook.h"
+
+CullArena::Arenas CullArena::_free_arenas;
+LightMutex CullArena::_free_arenas_lock;
+
+// The most arenas we keep around for reuse.  Each DisplayRegion normally
+// needs two or three at a time.
+static const size_t max_free_arenas = 16;
+
+static thread_local CullArena *current_arena = nullptr;
+
+/**
+ *
+ */
+CullArena::
+CullArena() :
+  _chunk_size(std::max(cull_arena_chunk_size.get_value(), 1024)),
+  _chunk_index(0),
+  _next(nullptr),
+  _end(nullptr),
+  _live(1)
+{
+}
+
+/**
+ *
+ */
+CullArena::
+~CullArena() {
+  for (char *chunk : _chunks) {
+    PANDA_FREE_ARRAY(chunk);
+  }
+}
+
+/**
+ * Returns an arena that is ready to be filled, which the caller owns until it
+ * calls release().  Returns NULL if cull arenas have been disabled.
+ */
+CullArena *CullArena::
+make_arena() {
+#ifdef SIMPLE_THREADS
+  // The current arena is kept per system thread, and all simple threads share
+  // one system thread, so we can't tell them apart.
+  return nullptr;
+#else
+  if (!cull_arena) {
+    return nullptr;
+  }
+
+  {
+    LightMutexHolder holder(_free_arenas_lock);
+    if (!_free_arenas.empty()) {
+      CullArena *arena = _free_arenas.back();
+      _free_arenas.pop_back();
+      return arena;
+    }
+  }
+  return new CullArena;
+#endif
+}
+
+/**
+ * Indicates that the owner is done with the arena.  It is reset and reused
+ * as soon as all of the objects allocated from it have been freed, which may
+ * be right away.
+ */
+void CullArena::
+release() {
+  nassertv(current_arena != this);
+  if (!AtomicAdjust::dec(_live)) {
+    recycle();
+  }
+}
+
+/**
+ * Returns the arena from which the current thread is allocating objects, or
+ * NULL if there is none.
+ */
+CullArena *CullArena::
+get_current() {
+  return current_arena;
+}
+
+/**
+ * Makes the indicated arena (which may be NULL) the one from which the
+ * current thread allocates objects, and returns the one that was current
+ * before, which should be restored afterwards.
+ */
+CullArena *CullArena::
+set_current(CullArena *arena) {
+  CullArena *prev = current_arena;
+  current_arena = arena;
+  return prev;
+}
+
+/**
+ * Returns the DeletedBufferChain that should be passed to allocate() and
+ * deallocate() for objects of the indicated size.
+ */
+DeletedBufferChain *CullArena::
+get_deleted_chain(size_t size) {
+  init_memory_hook();
+  return memory_hook->get_deleted_chain(size + header_size);
+}
+
+/**
+ * Allocates memory for an object of the indicated size from the current
+ * thread's arena, or from the indicated chain if there is no current arena.
+ * This is meant to be called from a class's operator new.
+ */
+void *CullArena::
+allocate(size_t size, DeletedBufferChain *chain, TypeHandle type_handle) {
+  CullArena *arena = current_arena;
+  char *mem = nullptr;
+  if (arena != nullptr) {
+    mem = (char *)arena->bump(size + header_size);
+    if (mem != nullptr) {
+      AtomicAdjust::inc(arena->_live);
+    } else {
+      arena = nullptr;
+    }
+  }
+  if (mem == nullptr) {
+    mem = (char *)chain->allocate(size + header_size, type_handle);
+  }
+
+  *(CullArena **)mem = arena;
+  return mem + header_size;
+}
+
+/**
+ * Frees memory previously returned by allocate().  This is meant to be called
+ * from a class's operator delete.
+ */
+void CullArena::
+deallocate(void *ptr, DeletedBufferChain *chain, TypeHandle type_handle) {
+  if (ptr == nullptr) {
+    return;
+  }
+  char *mem = (char *)ptr - header_size;
+  CullArena *arena = *(CullArena **)mem;
+  if (arena != nullptr) {
+    arena->release_object();
+  } else {
+    chain->deallocate(mem, type_handle);
+  }
+}
+
+/**
+ * Returns the next size bytes of the arena, or NULL if the request is too
+ * large for the arena.
+ */
+void *CullArena::
+bump(size_t size) {
+  size = (size + MEMORY_HOOK_ALIGNMENT - 1) & ~(MEMORY_HOOK_ALIGNMENT - 1);
+  if (size > _chunk_size) {
+    return nullptr;
+  }
+
+  if ((size_t)(_end - _next) < size) {
+    // Move on to the next chunk, making one if necessary.
+    size_t index = (_next != nullptr) ? _chunk_index + 1 : 0;
+    if (index >= _chunks.size()) {
+      _chunks.push_back((char *)PANDA_MALLOC_ARRAY(_chunk_size));
+    }
+    _chunk_index = index;
+    _next = _chunks[index];
+    _end = _next + _chunk_size;
+  }
+
+  char *result = _next;
+  _next += size;
+  return result;
+}
+
+/**
+ * Called when the owner has released the arena and all of its objects have
+ * been freed.  Resets the arena and puts it back in the pool, or deletes it
+ * if the pool is full.
+ */
+void CullArena::
+recycle() {
+  // Free the chunks that the last use didn't need, so that the arena follows
+  // the size of recent frames.
+  size_t num_used = (_next != nullptr) ? _chunk_index + 1 : 1;
+  while (_chunks.size() > num_used) {
+    PANDA_FREE_ARRAY(_chunks.back());
+    _chunks.pop_back();
+  }
+
+  _chunk_index = 0;
+  _next = nullptr;
+  _end = nullptr;
+  AtomicAdjust::set(_live, 1);
+
+  {
+    LightMutexHolder holder(_free_arenas_lock);
+    if (_free_arenas.size() < max_free_arenas) {
+      _free_arenas.push_back(this);
+      return;
+    }
+  }
+  delete this;
+}
@@ -0,0 +1,85 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullArena.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef CULLARENA_H
+#define CULLARENA_H
+
+#include "pandabase.h"
+#include "atomicAdjust.h"
+#include "lightMutex.h"
+#include "pvector.h"
+#include "deletedBufferChain.h"
+
+/**
+ * A block of memory from which the short-lived objects created by one cull
+ * traversal, chiefly CullableObjects, are allocated by simply advancing a
+ * pointer.  Freeing an individual object only decrements a counter; once the
+ * owner (normally the CullResult for that frame) has released the arena and
+ * all of its objects have been freed, the whole arena is reset in one step
+ * and kept for reuse by a later frame.
+ *
+ * An arena is only used while it has been made current for the thread, with
+ * set_current(); at other times, objects come from a DeletedBufferChain as
+ * usual.
+ */
+class EXPCL_PANDA_PGRAPH CullArena {
+private:
+  CullArena();
+  ~CullArena();
+
+public:
+  static CullArena *make_arena();
+  void release();
+
+  INLINE size_t get_num_objects() const;
+  INLINE size_t get_num_chunks() const;
+
+  static CullArena *get_current();
+  static CullArena *set_current(CullArena *arena);
+
+  static DeletedBufferChain *get_deleted_chain(size_t size);
+  static void *allocate(size_t size, DeletedBufferChain *chain,
+                        TypeHandle type_handle);
+  static void deallocate(void *ptr, DeletedBufferChain *chain,
+                         TypeHandle type_handle);
+
+private:
+  void *bump(size_t size);
+  INLINE void release_object();
+  void recycle();
+
+private:
+  // Every object is preceded by a header that records which arena, if any,
+  // it came from.
+  static const size_t header_size = MEMORY_HOOK_ALIGNMENT;
+
+  typedef pvector<char *> Chunks;
+  Chunks _chunks;
+  size_t _chunk_size;
+  size_t _chunk_index;
+  char *_next;
+  char *_end;
+
+  // This counts the objects that have not yet been freed, plus one for the
+  // owner.
+  TVOLATILE AtomicAdjust::Integer _live;
+
+  // Arenas that are not in use are kept here for reuse.
+  typedef pvector<CullArena *> Arenas;
+  static Arenas _free_arenas;
+  static LightMutex _free_arenas_lock;
+};
+
+#include "cullArena.I"
+
+#endif
@@ -19,6 +19,7 @@
 #include "cullBinManager.h"
 #include "renderState.h"
 #include "cullableObject.h"
+#include "cullArena.h"
 #include "geomMunger.h"
 #include "referenceCount.h"
 #include "pointerTo.h"
@@ -59,6 +60,8 @@ PUBLISHED:
   PT(PandaNode) make_result_graph();
 
 public:
+  INLINE CullArena *get_arena();
+
   static void bin_removed(int bin_index);
 
 private:
@@ -88,6 +91,9 @@ private:
 
   bool _show_transparency = false;
 
+  // The CullableObjects for this frame are allocated from here.
+  CullArena *_arena = nullptr;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
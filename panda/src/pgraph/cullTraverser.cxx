@@ -195,9 +195,38 @@ traverse_below(CullTraverserData &data) {
 
   // Now visit all the node's children.
   PandaNode::Children children = node_reader->get_children();
+  CPT(PandaNode::ChildRecords) records;
+  if (!node->has_selective_visibility()) {
+    records = node_reader->get_child_records();
+  }
   node_reader->release();
   int num_children = children.get_num_children();
-  if (!node->has_selective_visibility()) {
+  if (records != nullptr) {
+    // This node keeps a compact record of each child, so we can pass over the
+    // children that are hidden from this camera or outside the view frustum
+    // without visiting them.  These are the same tests that is_in_view()
+    // makes, except that the frustum is compared to a sphere around the
+    // child's bounding volume.
+    const GeometricBoundingVolume *view_frustum = data._view_frustum;
+#ifndef NDEBUG
+    if (fake_view_frustum_cull) {
+      view_frustum = nullptr;
+    }
+#endif
+    for (const PandaNode::ChildRecord &record : *records) {
+      if (!record.compare_draw_mask(data._draw_mask, _camera_mask)) {
+        continue;
+      }
+      if (view_frustum != nullptr && record.has_bounds()) {
+        BoundingSphere sphere(record.get_center(), record.get_radius());
+        if (view_frustum->contains(&sphere) == BoundingVolume::IF_no_intersection) {
+          continue;
+        }
+      }
+      CullTraverserData next_data(data, record.get_child());
+      do_traverse(next_data);
+    }
+  } else if (!node->has_selective_visibility()) {
     for (int i = 0; i < num_children; ++i) {
       CullTraverserData next_data(data, children.get_child(i));
       do_traverse(next_data);
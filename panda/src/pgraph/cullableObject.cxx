@@ -41,8 +41,28 @@ PStatCollector CullableObject::_munge_sprites_verts_pcollector("*:Munge:Sprites:
 PStatCollector CullableObject::_munge_sprites_prims_pcollector("*:Munge:Sprites:Prims");
 PStatCollector CullableObject::_sw_sprites_pcollector("SW Sprites");
 
+DeletedBufferChain *CullableObject::_deleted_chain = nullptr;
 TypeHandle CullableObject::_type_handle;
 
+/**
+ * Allocates a new CullableObject from the current thread's CullArena, if any.
+ */
+void *CullableObject::
+operator new(size_t size) {
+  if (_deleted_chain == nullptr) {
+    _deleted_chain = CullArena::get_deleted_chain(sizeof(CullableObject));
+  }
+  return CullArena::allocate(size, _deleted_chain, get_class_type());
+}
+
+/**
+ *
+ */
+void CullableObject::
+operator delete(void *ptr) {
+  CullArena::deallocate(ptr, _deleted_chain, get_class_type());
+}
+
 /**
  * Uses the indicated GeomMunger to transform the geom and/or its vertices.
  *
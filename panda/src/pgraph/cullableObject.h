@@ -25,6 +25,7 @@
 #include "cullTraverserData.h"
 #include "pStatCollector.h"
 #include "deletedChain.h"
+#include "cullArena.h"
 #include "graphicsStateGuardianBase.h"
 #include "sceneSetup.h"
 #include "lightMutex.h"
@@ -63,7 +64,12 @@ public:
                             bool force, Thread *current_thread);
 
 public:
-  ALLOC_DELETED_CHAIN(CullableObject);
+  // CullableObjects are allocated from the current CullArena during cull, or
+  // from a DeletedBufferChain otherwise.
+  void *operator new(size_t size) RETURNS_ALIGNED(MEMORY_HOOK_ALIGNMENT);
+  INLINE void *operator new(size_t size, void *ptr);
+  void operator delete(void *ptr);
+  INLINE void operator delete(void *, void *);
 
   void output(std::ostream &out) const;
 
@@ -115,6 +121,8 @@ private:
   static PStatCollector _munge_sprites_prims_pcollector;
   static PStatCollector _sw_sprites_pcollector;
 
+  static DeletedBufferChain *_deleted_chain;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
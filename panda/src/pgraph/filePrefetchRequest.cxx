@@ -0,0 +1,58 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file filePrefetchRequest.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "filePrefetchRequest.h"
+#include "loader.h"
+#include "config_pgraph.h"
+#include "config_putil.h"
+#include "virtualFileSystem.h"
+
+TypeHandle FilePrefetchRequest::_type_handle;
+
+/**
+ * Create a new FilePrefetchRequest.  Normally, you would call
+ * Loader::prefetch_file() instead.
+ */
+FilePrefetchRequest::
+FilePrefetchRequest(const std::string &name, const Filename &filename,
+                    Loader *loader) :
+  AsyncTask(name),
+  _filename(filename),
+  _loader(loader),
+  _success(false)
+{
+}
+
+/**
+ * Performs the task: that is, reads the one file into memory.
+ */
+AsyncTask::DoneStatus FilePrefetchRequest::
+do_task() {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+
+  // A relative filename is looked up along the model path, as the loader
+  // would.
+  Filename filename = _filename;
+  if (filename.is_local()) {
+    vfs->resolve_filename(filename, get_model_path());
+  }
+
+  _success = vfs->prefetch_file(filename);
+  if (!_success && loader_cat.is_debug()) {
+    loader_cat.debug()
+      << "Could not prefetch " << _filename << "\n";
+  }
+
+  // Don't continue the task; we're done.
+  return DS_done;
+}
@@ -0,0 +1,76 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file filePrefetchRequest.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef FILEPREFETCHREQUEST_H
+#define FILEPREFETCHREQUEST_H
+
+#include "pandabase.h"
+
+#include "asyncTask.h"
+#include "filename.h"
+#include "pointerTo.h"
+#include "loader.h"
+
+/**
+ * A class object that manages a single asynchronous file prefetch request.
+ * These are created by Loader::prefetch_file(), and read a file into the
+ * VirtualFileSystem's memory on one of the loader's prefetch threads, so that
+ * a later load of the file doesn't have to wait for the disk.
+ */
+class EXPCL_PANDA_PGRAPH FilePrefetchRequest : public AsyncTask {
+public:
+  ALLOC_DELETED_CHAIN(FilePrefetchRequest);
+
+PUBLISHED:
+  explicit FilePrefetchRequest(const std::string &name,
+                               const Filename &filename,
+                               Loader *loader);
+
+  INLINE const Filename &get_filename() const;
+  INLINE Loader *get_loader() const;
+
+  INLINE bool is_ready() const;
+  INLINE bool get_success() const;
+
+  MAKE_PROPERTY(filename, get_filename);
+  MAKE_PROPERTY(loader, get_loader);
+
+protected:
+  virtual DoneStatus do_task();
+
+private:
+  Filename _filename;
+  PT(Loader) _loader;
+  bool _success;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AsyncTask::init_type();
+    register_type(_type_handle, "FilePrefetchRequest",
+                  AsyncTask::get_class_type());
+    }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "filePrefetchRequest.I"
+
+#endif
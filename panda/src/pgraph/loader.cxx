@@ -18,6 +18,7 @@
 #include "modelPool.h"
 #include "modelLoadRequest.h"
 #include "modelSaveRequest.h"
+#include "filePrefetchRequest.h"
 #include "config_express.h"
 #include "config_putil.h"
 #include "virtualFileSystem.h"
@@ -107,6 +108,65 @@ load_bam_stream(std::istream &in) {
   return bam_file.read_node();
 }
 
+/**
+ * Starts reading the indicated file into memory in the background, so that a
+ * later attempt to load it, whether as a model or as a texture, finds its
+ * contents already in memory.  A relative filename is searched for along the
+ * model path.  This is meant for warming up the files that a level will need
+ * before loading it; the files are read on several threads at once (see
+ * loader-prefetch-threads), which keeps slow disks and compressed multifiles
+ * busy.
+ *
+ * The returned task may be awaited or polled if necessary, but there is no
+ * need to wait for it before loading the file.
+ */
+PT(AsyncTask) Loader::
+prefetch_file(const Filename &filename) {
+  string chain_name = _task_chain + "_prefetch";
+  if (_task_manager->find_task_chain(chain_name) == nullptr) {
+    PT(AsyncTaskChain) chain = _task_manager->make_task_chain(chain_name);
+
+    ConfigVariableInt loader_prefetch_threads
+      ("loader-prefetch-threads", 4,
+       PRC_DESC("The number of threads that will be started by the Loader "
+                "class to read files into memory ahead of time, when "
+                "prefetch_file() or prefetch_manifest() is used.  Since "
+                "these threads spend most of their time waiting for the disk, "
+                "this may usefully be higher than the number of CPU's."));
+    chain->set_num_threads(loader_prefetch_threads);
+    chain->set_thread_priority(TP_low);
+  }
+
+  PT(AsyncTask) request =
+    new FilePrefetchRequest(string("prefetch:") + filename.get_basename(),
+                            filename, this);
+  request->set_task_chain(chain_name);
+  _task_manager->add(request);
+  return request;
+}
+
+/**
+ * Reads the indicated manifest, which lists one filename per line, and calls
+ * prefetch_file() for each file listed there.  A suitable manifest may be
+ * written by VirtualFileSystem::write_access_manifest() after loading a
+ * level, so that the same files are prefetched on the next run.  Returns the
+ * number of files that were queued.
+ */
+int Loader::
+prefetch_manifest(const Filename &manifest) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  DSearchPath::Results results;
+  if (!vfs->read_manifest(manifest, results)) {
+    return 0;
+  }
+
+  size_t num_files = results.get_num_files();
+  for (size_t i = 0; i < num_files; ++i) {
+    prefetch_file(results.get_file(i));
+  }
+  return (int)num_files;
+}
+
 /**
  *
  */
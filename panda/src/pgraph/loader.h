@@ -96,6 +96,9 @@ PUBLISHED:
 
   BLOCKING PT(PandaNode) load_bam_stream(std::istream &in);
 
+  PT(AsyncTask) prefetch_file(const Filename &filename);
+  BLOCKING int prefetch_manifest(const Filename &manifest);
+
   virtual void output(std::ostream &out) const;
 
   INLINE static Loader *get_global_ptr();
@@ -140,6 +143,7 @@ private:
   static TypeHandle _type_handle;
 
   friend class ModelLoadRequest;
+  friend class FilePrefetchRequest;
 };
 
 #include "loader.I"
@@ -16,9 +16,25 @@
 #include "config_pgraph.h"
 #include "lightMutexHolder.h"
 #include "virtualFileSystem.h"
-
+#include "geomNode.h"
+#include "texturePool.h"
+#include "pset.h"
+#include <algorithm>
 
 ModelPool *ModelPool::_global_ptr = nullptr;
+PStatCollector ModelPool::_ram_pcollector("Model pool");
+
+/**
+ * The constructor is not intended to be called directly; there's only
+ * supposed to be one ModelPool in the universe and it constructs itself.
+ */
+ModelPool::
+ModelPool() :
+  _use_count(0),
+  _ram_budget((size_t)std::max(model_pool_ram_budget.get_value(), (int64_t)0)),
+  _ram_size(0)
+{
+}
 
 /**
  * Lists the contents of the model pool to the indicated output stream.  Helps
@@ -37,7 +53,7 @@ ns_has_model(const Filename &filename) {
   LightMutexHolder holder(_lock);
   Models::const_iterator ti;
   ti = _models.find(filename);
-  if (ti != _models.end() && (*ti).second != nullptr) {
+  if (ti != _models.end() && (*ti).second._model != nullptr) {
     // This model was previously loaded.
     return true;
   }
@@ -56,11 +72,12 @@ ns_get_model(const Filename &filename, bool verify) {
 
   {
     LightMutexHolder holder(_lock);
-    Models::const_iterator ti;
+    Models::iterator ti;
     ti = _models.find(filename);
     if (ti != _models.end()) {
       // This filename was previously loaded.
-      cached_model = (*ti).second;
+      cached_model = (*ti).second._model;
+      (*ti).second._last_use = ++_use_count;
       got_cached_model = true;
     }
   }
@@ -149,6 +166,8 @@ ns_load_model(const Filename &filename, const LoaderOptions &options) {
     node->set_fullpath(filename);
   }
 
+  size_t ram_size = (node != nullptr) ? estimate_ram_size(node) : 0;
+  int num_evicted;
   {
     LightMutexHolder holder(_lock);
 
@@ -156,13 +175,15 @@ ns_load_model(const Filename &filename, const LoaderOptions &options) {
     // thread.
     Models::const_iterator ti;
     ti = _models.find(filename);
-    if (ti != _models.end() && (*ti).second != cached_model) {
+    if (ti != _models.end() && (*ti).second._model != cached_model) {
       // This model was previously loaded.
-      return (*ti).second;
+      return (*ti).second._model;
     }
 
-    _models[filename] = node;
+    do_store(filename, node, ram_size);
+    num_evicted = do_evict_to_budget();
   }
+  evict_textures(num_evicted);
 
   return node;
 }
@@ -172,13 +193,20 @@ ns_load_model(const Filename &filename, const LoaderOptions &options) {
  */
 void ModelPool::
 ns_add_model(const Filename &filename, ModelRoot *model) {
-  LightMutexHolder holder(_lock);
-  if (pgraph_cat.is_debug()) {
-    pgraph_cat.debug()
-      << "ModelPool storing " << model << " for " << filename << "\n";
+  PT(ModelRoot) keep = model;
+  size_t ram_size = (model != nullptr) ? estimate_ram_size(model) : 0;
+  int num_evicted;
+  {
+    LightMutexHolder holder(_lock);
+    if (pgraph_cat.is_debug()) {
+      pgraph_cat.debug()
+        << "ModelPool storing " << model << " for " << filename << "\n";
+    }
+    // We blow away whatever model was there previously, if any.
+    do_store(filename, model, ram_size);
+    num_evicted = do_evict_to_budget();
   }
-  // We blow away whatever model was there previously, if any.
-  _models[filename] = model;
+  evict_textures(num_evicted);
 }
 
 /**
@@ -190,6 +218,8 @@ ns_release_model(const Filename &filename) {
   Models::iterator ti;
   ti = _models.find(filename);
   if (ti != _models.end()) {
+    _ram_size -= (*ti).second._ram_size;
+    _ram_pcollector.set_level((double)_ram_size);
     _models.erase(ti);
   }
 }
@@ -199,9 +229,7 @@ ns_release_model(const Filename &filename) {
  */
 void ModelPool::
 ns_add_model(ModelRoot *model) {
-  LightMutexHolder holder(_lock);
-  // We blow away whatever model was there previously, if any.
-  _models[model->get_fullpath()] = model;
+  ns_add_model(model->get_fullpath(), model);
 }
 
 /**
@@ -213,6 +241,8 @@ ns_release_model(ModelRoot *model) {
   Models::iterator ti;
   ti = _models.find(model->get_fullpath());
   if (ti != _models.end()) {
+    _ram_size -= (*ti).second._ram_size;
+    _ram_pcollector.set_level((double)_ram_size);
     _models.erase(ti);
   }
 }
@@ -224,6 +254,8 @@ void ModelPool::
 ns_release_all_models() {
   LightMutexHolder holder(_lock);
   _models.clear();
+  _ram_size = 0;
+  _ram_pcollector.set_level(0);
 }
 
 /**
@@ -238,13 +270,14 @@ ns_garbage_collect() {
 
   Models::iterator ti;
   for (ti = _models.begin(); ti != _models.end(); ++ti) {
-    ModelRoot *node = (*ti).second;
+    ModelRoot *node = (*ti).second._model;
     if (node == nullptr ||
         node->get_model_ref_count() == 1) {
       if (loader_cat.is_debug()) {
         loader_cat.debug()
           << "Releasing " << (*ti).first << "\n";
       }
+      _ram_size -= (*ti).second._ram_size;
       ++num_released;
     } else {
       new_set.insert(new_set.end(), *ti);
@@ -252,9 +285,38 @@ ns_garbage_collect() {
   }
 
   _models.swap(new_set);
+  _ram_pcollector.set_level((double)_ram_size);
   return num_released;
 }
 
+/**
+ * The nonstatic implementation of set_ram_budget().
+ */
+void ModelPool::
+ns_set_ram_budget(size_t budget) {
+  int num_evicted;
+  {
+    LightMutexHolder holder(_lock);
+    _ram_budget = budget;
+    num_evicted = do_evict_to_budget();
+  }
+  evict_textures(num_evicted);
+}
+
+/**
+ * The nonstatic implementation of evict_to_budget().
+ */
+int ModelPool::
+ns_evict_to_budget() {
+  int num_evicted;
+  {
+    LightMutexHolder holder(_lock);
+    num_evicted = do_evict_to_budget();
+  }
+  evict_textures(num_evicted);
+  return num_evicted;
+}
+
 /**
  * The nonstatic implementation of list_contents().
  */
@@ -267,16 +329,149 @@ ns_list_contents(std::ostream &out) const {
   Models::const_iterator ti;
   int num_models = 0;
   for (ti = _models.begin(); ti != _models.end(); ++ti) {
-    if ((*ti).second != nullptr) {
+    if ((*ti).second._model != nullptr) {
       ++num_models;
       out << (*ti).first << "\n"
-          << "  (count = " << (*ti).second->get_model_ref_count()
+          << "  (count = " << (*ti).second._model->get_model_ref_count()
+          << ", ram = " << (*ti).second._ram_size
           << ")\n";
     }
   }
 
   out << "total number of models: " << num_models << " (plus "
       << _models.size() - num_models << " entries for nonexistent files)\n";
+  out << "model pool ram: " << _ram_size << "\n";
+}
+
+/**
+ * Stores the indicated model in the pool, replacing whatever was there
+ * before, and marks it as just used.  Assumes the lock is held.
+ */
+void ModelPool::
+do_store(const Filename &filename, ModelRoot *model, size_t ram_size) {
+  Entry &entry = _models[filename];
+  _ram_size -= entry._ram_size;
+  entry._model = model;
+  entry._ram_size = ram_size;
+  entry._last_use = ++_use_count;
+  _ram_size += ram_size;
+  _ram_pcollector.set_level((double)_ram_size);
+}
+
+/**
+ * Releases the least-recently-used models that are not referenced outside of
+ * the pool until the pool fits within its RAM budget.  Returns the number of
+ * models released.  Assumes the lock is held.
+ */
+int ModelPool::
+do_evict_to_budget() {
+  if (_ram_budget == 0 || _ram_size <= _ram_budget) {
+    return 0;
+  }
+
+  // The model that was used last is spared even if nothing references it
+  // yet, since it has usually just been stored by a caller that is about to
+  // copy it.
+  typedef pvector<Models::iterator> Candidates;
+  Candidates candidates;
+  for (Models::iterator ti = _models.begin(); ti != _models.end(); ++ti) {
+    ModelRoot *node = (*ti).second._model;
+    if (node != nullptr && (*ti).second._ram_size != 0 &&
+        (*ti).second._last_use != _use_count &&
+        node->get_model_ref_count() == 1) {
+      candidates.push_back(ti);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](Models::iterator a, Models::iterator b) {
+    return (*a).second._last_use < (*b).second._last_use;
+  });
+
+  int num_evicted = 0;
+  for (Models::iterator ti : candidates) {
+    if (_ram_size <= _ram_budget) {
+      break;
+    }
+    if (loader_cat.is_debug()) {
+      loader_cat.debug()
+        << "Evicting " << (*ti).first << " from model pool ("
+        << (*ti).second._ram_size << " bytes)\n";
+    }
+    _ram_size -= (*ti).second._ram_size;
+    _models.erase(ti);
+    ++num_evicted;
+  }
+
+  _ram_pcollector.set_level((double)_ram_size);
+  return num_evicted;
+}
+
+/**
+ * Called after models have been evicted, since their textures may now be
+ * referenced only by the TexturePool, and can be evicted in turn if it has a
+ * budget of its own.  Must not be called with the lock held.
+ */
+void ModelPool::
+evict_textures(int num_evicted) {
+  if (num_evicted != 0 && TexturePool::get_ram_budget() != 0) {
+    TexturePool::evict_to_budget();
+  }
+}
+
+/**
+ * Returns an estimate of the number of bytes of main RAM occupied by the
+ * vertex and index data under the indicated node.  Arrays that are shared by
+ * several Geoms are counted only once.
+ */
+size_t ModelPool::
+estimate_ram_size(PandaNode *root) {
+  Thread *current_thread = Thread::get_current_thread();
+  size_t size = 0;
+  pset<const GeomVertexArrayData *> arrays;
+  pset<PandaNode *> visited;
+
+  pvector<PandaNode *> stack(1, root);
+  while (!stack.empty()) {
+    PandaNode *node = stack.back();
+    stack.pop_back();
+    if (!visited.insert(node).second) {
+      continue;
+    }
+
+    if (node->is_geom_node()) {
+      GeomNode *gnode = (GeomNode *)node;
+      int num_geoms = gnode->get_num_geoms();
+      for (int i = 0; i < num_geoms; ++i) {
+        CPT(Geom) geom = gnode->get_geom(i);
+        CPT(GeomVertexData) vdata = geom->get_vertex_data(current_thread);
+        size_t num_arrays = vdata->get_num_arrays();
+        for (size_t j = 0; j < num_arrays; ++j) {
+          CPT(GeomVertexArrayData) array = vdata->get_array(j);
+          if (arrays.insert(array).second) {
+            size += array->get_data_size_bytes();
+          }
+        }
+        size_t num_primitives = geom->get_num_primitives();
+        for (size_t j = 0; j < num_primitives; ++j) {
+          CPT(GeomVertexArrayData) vertices = geom->get_primitive(j)->get_vertices();
+          if (vertices != nullptr && arrays.insert(vertices).second) {
+            size += vertices->get_data_size_bytes();
+          }
+        }
+      }
+    }
+
+    int num_children = node->get_num_children(current_thread);
+    for (int i = 0; i < num_children; ++i) {
+      stack.push_back(node->get_child(i, current_thread));
+    }
+    int num_stashed = node->get_num_stashed(current_thread);
+    for (int i = 0; i < num_stashed; ++i) {
+      stack.push_back(node->get_stashed(i, current_thread));
+    }
+  }
+
+  return size;
 }
 
 /**
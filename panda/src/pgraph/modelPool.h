@@ -22,6 +22,7 @@
 #include "lightMutex.h"
 #include "pmap.h"
 #include "loaderOptions.h"
+#include "pStatCollector.h"
 
 /**
  * This class unifies all references to the same filename, so that multiple
@@ -57,12 +58,17 @@ PUBLISHED:
 
   INLINE static int garbage_collect();
 
+  INLINE static void set_ram_budget(size_t budget);
+  INLINE static size_t get_ram_budget();
+  INLINE static size_t get_ram_size();
+  INLINE static int evict_to_budget();
+
   INLINE static void list_contents(std::ostream &out);
   INLINE static void list_contents();
   static void write(std::ostream &out);
 
 private:
-  INLINE ModelPool();
+  ModelPool();
 
   bool ns_has_model(const Filename &filename);
   ModelRoot *ns_get_model(const Filename &filename, bool verify);
@@ -76,15 +82,39 @@ private:
 
   void ns_release_all_models();
   int ns_garbage_collect();
+  void ns_set_ram_budget(size_t budget);
+  int ns_evict_to_budget();
   void ns_list_contents(std::ostream &out) const;
 
+  void do_store(const Filename &filename, ModelRoot *model, size_t ram_size);
+  int do_evict_to_budget();
+  void evict_textures(int num_evicted);
+  static size_t estimate_ram_size(PandaNode *root);
+
   static ModelPool *get_ptr();
 
   static ModelPool *_global_ptr;
 
   LightMutex _lock;
-  typedef pmap<Filename,  PT(ModelRoot) > Models;
+
+  // The RAM size is estimated when the model is stored, and the last use is a
+  // stamp from _use_count, for choosing what to evict first.
+  class Entry {
+  public:
+    INLINE Entry(ModelRoot *model = nullptr, size_t ram_size = 0,
+                 uint64_t last_use = 0);
+
+    PT(ModelRoot) _model;
+    size_t _ram_size;
+    uint64_t _last_use;
+  };
+  typedef pmap<Filename, Entry> Models;
   Models _models;
+  uint64_t _use_count;
+  size_t _ram_budget;
+  size_t _ram_size;
+
+  static PStatCollector _ram_pcollector;
 };
 
 #include "modelPool.I"
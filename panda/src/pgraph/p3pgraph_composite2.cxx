@@ -1,3 +1,4 @@
+#include "cullArena.cxx"
 #include "cullBin.cxx"
 #include "cullBinAttrib.cxx"
 #include "cullBinManager.cxx"
@@ -13,6 +14,7 @@
 #include "depthTestAttrib.cxx"
 #include "depthWriteAttrib.cxx"
 #include "alphaTestAttrib.cxx"
+#include "filePrefetchRequest.cxx"
 #include "findApproxPath.cxx"
 #include "findApproxLevelEntry.cxx"
 #include "fog.cxx"
@@ -1952,6 +1952,31 @@ get_bounds(Thread *current_thread) const {
   return cdata->_external_bounds;
 }
 
+/**
+ * Returns the compact records of this node's children, in the same order as
+ * get_children(), recomputing them first if they are stale.  Returns NULL if
+ * this node has fewer than child-records-min-children children.
+ *
+ * A traversal may use these to decide which children to visit, without
+ * having to look at the children themselves.
+ */
+CPT(PandaNode::ChildRecords) PandaNode::
+get_child_records(Thread *current_thread) const {
+  int pipeline_stage = current_thread->get_pipeline_stage();
+  CDLockedStageReader cdata(_cycler, pipeline_stage, current_thread);
+  if (cdata->_last_bounds_update != cdata->_next_update) {
+    CPT(ChildRecords) result;
+    {
+      PStatTimer timer(_update_bounds_pcollector);
+      CDStageWriter cdataw =
+        ((PandaNode *)this)->update_cached(true, pipeline_stage, cdata);
+      result = cdataw->_child_records;
+    }
+    return result;
+  }
+  return cdata->_child_records;
+}
+
 /**
  * This flavor of get_bounds() return the external bounding volume, and also
  * fills in seq with the bounding volume's current sequence number.  When this
@@ -2276,7 +2301,7 @@ force_bounds_stale(int pipeline_stage, Thread *current_thread) {
   int num_parents = parents.get_num_parents();
   for (int i = 0; i < num_parents; ++i) {
     PandaNode *parent = parents.get_parent(i);
-    parent->mark_bounds_stale(pipeline_stage, current_thread);
+    parent->mark_child_bounds_stale(this, pipeline_stage, current_thread);
   }
 }
 
@@ -3261,22 +3286,50 @@ update_cached(bool update_bounds, int pipeline_stage, PandaNode::CDLockedStageRe
 
     // Also get the list of the node's children.
     Children children(cdata);
+    CPT(Down) down = cdata->get_down();
+    int num_children = children.get_num_children();
+
+    // If there are many children, we accumulate them through the tree of
+    // child bounds, which always includes the bounding volumes.
+    int min_children = incremental_bounds_min_children;
+    bool use_tree = (min_children > 0 && num_children >= min_children);
+    PT(ChildBoundsTree) child_bounds;
+    pvector<PandaNode *> stale_children;
+    if (use_tree) {
+      update_bounds = true;
+      child_bounds = cdata->_child_bounds;
+      stale_children = cdata->_stale_children;
+    }
+
+    // We may also keep a compact record of each child.  Without the tree,
+    // these are filled in as we walk through the children below; with it,
+    // only the stale ones are updated, when we store the results.
+    int min_records = child_records_min_children;
+    bool use_records = (update_bounds && min_records > 0 && num_children >= min_records);
+    PT(ChildRecords) child_records;
+    if (use_records && !use_tree) {
+      child_records = new ChildRecords;
+      child_records->reserve(num_children);
+      for (int i = 0; i < num_children; ++i) {
+        child_records->push_back(ChildRecord(children.get_child(i), children.get_child_sort(i)));
+      }
+    }
 
     // Now that we've got all the data we need from the node, we can release
     // the lock.
     _cycler.release_read_stage(pipeline_stage, cdata.take_pointer());
 
-    int num_children = children.get_num_children();
-
     // We need to keep references to the bounding volumes, since in a threaded
     // environment the pointers might go away while we're working (since we're
     // not holding a lock on our set of children right now).  But we also need
-    // the regular pointers, to pass to BoundingVolume::around().
+    // the regular pointers, to pass to BoundingVolume::around().  With the
+    // tree, there are only the internal volume and the tree's total.
     const BoundingVolume **child_volumes;
+    int max_volumes = use_tree ? 2 : num_children + 1;
 #if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
     pvector<CPT(BoundingVolume) > child_volumes_ref;
     if (update_bounds) {
-      child_volumes_ref.reserve(num_children + 1);
+      child_volumes_ref.reserve(max_volumes);
     }
 #endif
     int child_volumes_i = 0;
@@ -3285,14 +3338,14 @@ update_cached(bool update_bounds, int pipeline_stage, PandaNode::CDLockedStageRe
     CPT(BoundingVolume) internal_bounds = nullptr;
 
     if (update_bounds) {
-      child_volumes = (const BoundingVolume **)alloca(sizeof(BoundingVolume *) * (num_children + 1));
+      child_volumes = (const BoundingVolume **)alloca(sizeof(BoundingVolume *) * max_volumes);
       internal_bounds = get_internal_bounds(pipeline_stage, current_thread);
 
       if (!internal_bounds->is_empty()) {
 #if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
         child_volumes_ref.push_back(internal_bounds);
 #endif
-        nassertr(child_volumes_i < num_children + 1, CDStageWriter(_cycler, pipeline_stage, cdata));
+        nassertr(child_volumes_i < max_volumes, CDStageWriter(_cycler, pipeline_stage, cdata));
         child_volumes[child_volumes_i++] = internal_bounds;
         if (internal_bounds->as_bounding_box() == nullptr) {
           all_box = false;
@@ -3303,156 +3356,206 @@ update_cached(bool update_bounds, int pipeline_stage, PandaNode::CDLockedStageRe
     // Now expand those contents to include all of our children.
     int child_vertices = 0;
 
-    for (int i = 0; i < num_children; ++i) {
-      PandaNode *child = children.get_child(i);
+    if (use_tree) {
+      // Bring the tree up to date with just the children that have changed
+      // since it was last computed, then take its total.
+      child_bounds = update_child_bounds(child_bounds, stale_children,
+                                         children, pipeline_stage,
+                                         current_thread);
+      const ChildBoundsTree::Entry &total = child_bounds->get_total();
+
+      net_collide_mask |= total._net_collide_mask;
+
+      if (!(total._net_draw_control_mask | total._net_draw_show_mask).is_zero()) {
+        // See the comments in the loop below.  Accumulating the draw masks
+        // of groups of children gives the same result as accumulating them
+        // one at a time.
+        renderable = true;
+        ChildBoundsTree::compose_draw_masks(net_draw_control_mask,
+                                            net_draw_show_mask,
+                                            total._net_draw_control_mask,
+                                            total._net_draw_show_mask);
+      }
 
-      const ClipPlaneAttrib *orig_cp = DCAST(ClipPlaneAttrib, off_clip_planes);
+      if (total._off_clip_planes != nullptr) {
+        off_clip_planes = DCAST(ClipPlaneAttrib, off_clip_planes)->compose_off(total._off_clip_planes);
+      }
 
-      CDLockedStageReader child_cdata(child->_cycler, pipeline_stage, current_thread);
+      // The tree keeps a reference to the volume.  It is a box even if the
+      // children's volumes weren't.
+      if (total._bounds != nullptr) {
+        nassertr(child_volumes_i < max_volumes, CDStageWriter(_cycler, pipeline_stage, cdata));
+        child_volumes[child_volumes_i++] = total._bounds;
+      }
+      all_box = all_box && total._all_box;
+      child_vertices += total._nested_vertices;
 
-      UpdateSeq last_child_update = update_bounds
-                                  ? child_cdata->_last_bounds_update
-                                  : child_cdata->_last_update;
+    } else {
+      for (int i = 0; i < num_children; ++i) {
+        PandaNode *child = children.get_child(i);
 
-      if (last_child_update != child_cdata->_next_update) {
-        // Child needs update.
-        CDStageWriter child_cdataw = child->update_cached(update_bounds, pipeline_stage, child_cdata);
+        const ClipPlaneAttrib *orig_cp = DCAST(ClipPlaneAttrib, off_clip_planes);
 
-        net_collide_mask |= child_cdataw->_net_collide_mask;
+        CDLockedStageReader child_cdata(child->_cycler, pipeline_stage, current_thread);
 
-        if (drawmask_cat.is_debug()) {
-          drawmask_cat.debug(false)
-            << "\nchild update " << *child << ":\n";
-        }
+        UpdateSeq last_child_update = update_bounds
+                                    ? child_cdata->_last_bounds_update
+                                    : child_cdata->_last_update;
+
+        if (last_child_update != child_cdata->_next_update) {
+          // Child needs update.
+          CDStageWriter child_cdataw = child->update_cached(update_bounds, pipeline_stage, child_cdata);
 
-        DrawMask child_control_mask = child_cdataw->_net_draw_control_mask;
-        DrawMask child_show_mask = child_cdataw->_net_draw_show_mask;
-        if (!(child_control_mask | child_show_mask).is_zero()) {
-          // This child includes a renderable node or subtree.  Thus, we
-          // should propagate its draw masks.
-          renderable = true;
-
-          // For each bit position in the masks, we have assigned the
-          // following semantic meaning.  The number on the left represents
-          // the pairing of the corresponding bit from the control mask and
-          // from the show mask:
-
-          // 00 : not a renderable node   (control 0, show 0) 01 : a normally
-          // visible node (control 0, show 1) 10 : a hidden node
-          // (control 1, show 0) 11 : a show-through node     (control 1, show
-          // 1)
-
-          // Now, when we accumulate these masks, we want to do so according
-          // to the following table, for each bit position:
-
-          // 00   01   10   11     (child) --------------------- 00 | 00   01
-          // 10   11 01 | 01   01   01*  11 10 | 10   01*  10   11 11 | 11
-          // 11   11   11 (parent)
-
-          // This table is almost the same as the union of both masks, with
-          // one exception, marked with a * in the above table: if one is 10
-          // and the other is 01--that is, one is hidden and the other is
-          // normally visible--then the result should be 01, normally visible.
-          // This is because we only want to propagate the hidden bit upwards
-          // if *all* renderable nodes are hidden.
-
-          // Get the set of exception bits for which the above rule applies.
-          // These are the bits for which both bits have flipped, but which
-          // were not the same in the original.
-          DrawMask exception_mask = (net_draw_control_mask ^ child_control_mask) & (net_draw_show_mask ^ child_show_mask);
-          exception_mask &= (net_draw_control_mask ^ net_draw_show_mask);
+          net_collide_mask |= child_cdataw->_net_collide_mask;
 
           if (drawmask_cat.is_debug()) {
             drawmask_cat.debug(false)
-              << "exception_mask = " << exception_mask << "\n";
+              << "\nchild update " << *child << ":\n";
           }
 
-          // Now compute the union, applying the above exception.
-          net_draw_control_mask |= child_control_mask;
-          net_draw_show_mask |= child_show_mask;
+          DrawMask child_control_mask = child_cdataw->_net_draw_control_mask;
+          DrawMask child_show_mask = child_cdataw->_net_draw_show_mask;
+          if (!(child_control_mask | child_show_mask).is_zero()) {
+            // This child includes a renderable node or subtree.  Thus, we
+            // should propagate its draw masks.
+            renderable = true;
+
+            // For each bit position in the masks, we have assigned the
+            // following semantic meaning.  The number on the left represents
+            // the pairing of the corresponding bit from the control mask and
+            // from the show mask:
+
+            // 00 : not a renderable node   (control 0, show 0) 01 : a normally
+            // visible node (control 0, show 1) 10 : a hidden node
+            // (control 1, show 0) 11 : a show-through node     (control 1, show
+            // 1)
+
+            // Now, when we accumulate these masks, we want to do so according
+            // to the following table, for each bit position:
+
+            // 00   01   10   11     (child) --------------------- 00 | 00   01
+            // 10   11 01 | 01   01   01*  11 10 | 10   01*  10   11 11 | 11
+            // 11   11   11 (parent)
+
+            // This table is almost the same as the union of both masks, with
+            // one exception, marked with a * in the above table: if one is 10
+            // and the other is 01--that is, one is hidden and the other is
+            // normally visible--then the result should be 01, normally visible.
+            // This is because we only want to propagate the hidden bit upwards
+            // if *all* renderable nodes are hidden.
+
+            // Get the set of exception bits for which the above rule applies.
+            // These are the bits for which both bits have flipped, but which
+            // were not the same in the original.
+            DrawMask exception_mask = (net_draw_control_mask ^ child_control_mask) & (net_draw_show_mask ^ child_show_mask);
+            exception_mask &= (net_draw_control_mask ^ net_draw_show_mask);
+
+            if (drawmask_cat.is_debug()) {
+              drawmask_cat.debug(false)
+                << "exception_mask = " << exception_mask << "\n";
+            }
 
-          net_draw_control_mask &= ~exception_mask;
-          net_draw_show_mask |= exception_mask;
-        }
+            // Now compute the union, applying the above exception.
+            net_draw_control_mask |= child_control_mask;
+            net_draw_show_mask |= child_show_mask;
 
-        if (drawmask_cat.is_debug()) {
-          drawmask_cat.debug(false)
-            << "child_control_mask = " << child_control_mask
-            << "\nchild_show_mask = " << child_show_mask
-            << "\nnet_draw_control_mask = " << net_draw_control_mask
-            << "\nnet_draw_show_mask = " << net_draw_show_mask
-            << "\n";
-        }
+            net_draw_control_mask &= ~exception_mask;
+            net_draw_show_mask |= exception_mask;
+          }
 
-        off_clip_planes = orig_cp->compose_off(child_cdataw->_off_clip_planes);
+          if (drawmask_cat.is_debug()) {
+            drawmask_cat.debug(false)
+              << "child_control_mask = " << child_control_mask
+              << "\nchild_show_mask = " << child_show_mask
+              << "\nnet_draw_control_mask = " << net_draw_control_mask
+              << "\nnet_draw_show_mask = " << net_draw_show_mask
+              << "\n";
+          }
 
-        if (update_bounds) {
-          if (!child_cdataw->_external_bounds->is_empty()) {
+          off_clip_planes = orig_cp->compose_off(child_cdataw->_off_clip_planes);
+
+          if (update_bounds) {
+            if (!child_cdataw->_external_bounds->is_empty()) {
 #if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
-            child_volumes_ref.push_back(child_cdataw->_external_bounds);
+              child_volumes_ref.push_back(child_cdataw->_external_bounds);
 #endif
-            nassertr(child_volumes_i < num_children + 1, CDStageWriter(_cycler, pipeline_stage, cdata));
-            child_volumes[child_volumes_i++] = child_cdataw->_external_bounds;
-            if (child_cdataw->_external_bounds->as_bounding_box() == nullptr) {
-              all_box = false;
+              nassertr(child_volumes_i < max_volumes, CDStageWriter(_cycler, pipeline_stage, cdata));
+              child_volumes[child_volumes_i++] = child_cdataw->_external_bounds;
+              if (child_cdataw->_external_bounds->as_bounding_box() == nullptr) {
+                all_box = false;
+              }
             }
-          }
-          child_vertices += child_cdataw->_nested_vertices;
-        }
+            child_vertices += child_cdataw->_nested_vertices;
 
-      } else {
-        // Child is good.
-        net_collide_mask |= child_cdata->_net_collide_mask;
-
-        // See comments in similar block above.
-        if (drawmask_cat.is_debug()) {
-          drawmask_cat.debug(false)
-            << "\nchild fresh " << *child << ":\n";
-        }
-        DrawMask child_control_mask = child_cdata->_net_draw_control_mask;
-        DrawMask child_show_mask = child_cdata->_net_draw_show_mask;
-        if (!(child_control_mask | child_show_mask).is_zero()) {
-          renderable = true;
+            if (child_records != nullptr) {
+              (*child_records)[i].set_cached(child_cdataw->_external_bounds,
+                                             child_cdataw->_net_collide_mask,
+                                             child_cdataw->_net_draw_control_mask,
+                                             child_cdataw->_net_draw_show_mask);
+            }
+          }
 
-          DrawMask exception_mask = (net_draw_control_mask ^ child_control_mask) & (net_draw_show_mask ^ child_show_mask);
-          exception_mask &= (net_draw_control_mask ^ net_draw_show_mask);
+        } else {
+          // Child is good.
+          net_collide_mask |= child_cdata->_net_collide_mask;
 
+          // See comments in similar block above.
           if (drawmask_cat.is_debug()) {
             drawmask_cat.debug(false)
-              << "exception_mask = " << exception_mask << "\n";
+              << "\nchild fresh " << *child << ":\n";
           }
+          DrawMask child_control_mask = child_cdata->_net_draw_control_mask;
+          DrawMask child_show_mask = child_cdata->_net_draw_show_mask;
+          if (!(child_control_mask | child_show_mask).is_zero()) {
+            renderable = true;
 
-          // Now compute the union, applying the above exception.
-          net_draw_control_mask |= child_control_mask;
-          net_draw_show_mask |= child_show_mask;
+            DrawMask exception_mask = (net_draw_control_mask ^ child_control_mask) & (net_draw_show_mask ^ child_show_mask);
+            exception_mask &= (net_draw_control_mask ^ net_draw_show_mask);
 
-          net_draw_control_mask &= ~exception_mask;
-          net_draw_show_mask |= exception_mask;
-        }
+            if (drawmask_cat.is_debug()) {
+              drawmask_cat.debug(false)
+                << "exception_mask = " << exception_mask << "\n";
+            }
 
-        if (drawmask_cat.is_debug()) {
-          drawmask_cat.debug(false)
-            << "child_control_mask = " << child_control_mask
-            << "\nchild_show_mask = " << child_show_mask
-            << "\nnet_draw_control_mask = " << net_draw_control_mask
-            << "\nnet_draw_show_mask = " << net_draw_show_mask
-            << "\n";
-        }
+            // Now compute the union, applying the above exception.
+            net_draw_control_mask |= child_control_mask;
+            net_draw_show_mask |= child_show_mask;
 
-        off_clip_planes = orig_cp->compose_off(child_cdata->_off_clip_planes);
+            net_draw_control_mask &= ~exception_mask;
+            net_draw_show_mask |= exception_mask;
+          }
 
-        if (update_bounds) {
-          if (!child_cdata->_external_bounds->is_empty()) {
+          if (drawmask_cat.is_debug()) {
+            drawmask_cat.debug(false)
+              << "child_control_mask = " << child_control_mask
+              << "\nchild_show_mask = " << child_show_mask
+              << "\nnet_draw_control_mask = " << net_draw_control_mask
+              << "\nnet_draw_show_mask = " << net_draw_show_mask
+              << "\n";
+          }
+
+          off_clip_planes = orig_cp->compose_off(child_cdata->_off_clip_planes);
+
+          if (update_bounds) {
+            if (!child_cdata->_external_bounds->is_empty()) {
 #if defined(HAVE_THREADS) && !defined(SIMPLE_THREADS)
-            child_volumes_ref.push_back(child_cdata->_external_bounds);
+              child_volumes_ref.push_back(child_cdata->_external_bounds);
 #endif
-            nassertr(child_volumes_i < num_children + 1, CDStageWriter(_cycler, pipeline_stage, cdata));
-            child_volumes[child_volumes_i++] = child_cdata->_external_bounds;
-            if (child_cdata->_external_bounds->as_bounding_box() == nullptr) {
-              all_box = false;
+              nassertr(child_volumes_i < max_volumes, CDStageWriter(_cycler, pipeline_stage, cdata));
+              child_volumes[child_volumes_i++] = child_cdata->_external_bounds;
+              if (child_cdata->_external_bounds->as_bounding_box() == nullptr) {
+                all_box = false;
+              }
+            }
+            child_vertices += child_cdata->_nested_vertices;
+
+            if (child_records != nullptr) {
+              (*child_records)[i].set_cached(child_cdata->_external_bounds,
+                                             child_cdata->_net_collide_mask,
+                                             child_cdata->_net_draw_control_mask,
+                                             child_cdata->_net_draw_show_mask);
             }
           }
-          child_vertices += child_cdata->_nested_vertices;
         }
       }
     }
@@ -3539,6 +3642,20 @@ update_cached(bool update_bounds, int pipeline_stage, PandaNode::CDLockedStageRe
           cdataw->_last_bounds_update = next_update;
         }
 
+        if (use_tree && cdataw->get_down() == down) {
+          if (use_records) {
+            update_child_records(cdataw, children, child_bounds, stale_children);
+          } else {
+            cdataw->_child_records = nullptr;
+          }
+          cdataw->_child_bounds = std::move(child_bounds);
+          cdataw->_stale_children.clear();
+        } else if (update_bounds) {
+          cdataw->_child_bounds = nullptr;
+          cdataw->_stale_children.clear();
+          cdataw->_child_records = std::move(child_records);
+        }
+
         cdataw->_last_update = next_update;
 
         if (drawmask_cat.is_debug()) {
@@ -3575,6 +3692,181 @@ update_cached(bool update_bounds, int pipeline_stage, PandaNode::CDLockedStageRe
   } while (true);
 }
 
+/**
+ * Called by force_bounds_stale() on each parent of a node whose bounds have
+ * changed.  Marks this node stale in the same way as mark_bounds_stale(), but
+ * if this node has enough children to accumulate them through a tree, also
+ * records the child, so that update_cached() can recompute only the part of
+ * the tree that contains it.
+ */
+void PandaNode::
+mark_child_bounds_stale(PandaNode *child, int pipeline_stage,
+                        Thread *current_thread) {
+  int min_children = incremental_bounds_min_children;
+  bool use_tree;
+  {
+    CDStageReader cdata(_cycler, pipeline_stage, current_thread);
+    use_tree = (cdata->_child_bounds != nullptr ||
+                (min_children > 0 && (int)cdata->get_down()->size() >= min_children));
+  }
+  if (!use_tree) {
+    mark_bounds_stale(pipeline_stage, current_thread);
+    return;
+  }
+
+  bool is_stale_bounds;
+  {
+    CDStageWriter cdata(_cycler, pipeline_stage, current_thread);
+    is_stale_bounds = (cdata->_last_update != cdata->_next_update);
+
+    ChildBoundsTree *child_bounds = cdata->_child_bounds;
+    if (child_bounds != nullptr) {
+      if (child_bounds->should_rebuild(cdata->_stale_children.size() + 1)) {
+        // So many children have changed that it will be cheaper to start
+        // over.  The child records are kept in step with the tree.
+        cdata->_child_bounds = nullptr;
+        cdata->_stale_children.clear();
+        cdata->_child_records = nullptr;
+      } else {
+        cdata->_stale_children.push_back(child);
+      }
+    }
+
+    if (is_stale_bounds) {
+      // We are already stale, but an update_cached() in progress might have
+      // missed this child, so make sure that it goes around again.
+      ++cdata->_next_update;
+    }
+  }
+  // As in mark_bounds_stale(), we must not hold the lock here.
+  if (!is_stale_bounds) {
+    force_bounds_stale(pipeline_stage, current_thread);
+  }
+}
+
+/**
+ * Brings the indicated tree of child bounds up to date with the children that
+ * have changed since it was computed, and returns the updated tree.  The
+ * original tree is not modified.  If there is no tree, or it cannot be
+ * updated, a new one is built from all of the children.
+ */
+PT(ChildBoundsTree) PandaNode::
+update_child_bounds(ChildBoundsTree *child_bounds,
+                    const pvector<PandaNode *> &stale_children,
+                    const Children &children, int pipeline_stage,
+                    Thread *current_thread) {
+  size_t num_children = children.get_num_children();
+
+  if (child_bounds != nullptr &&
+      child_bounds->get_num_children() == num_children) {
+    if (stale_children.empty()) {
+      return child_bounds;
+    }
+
+    PT(ChildBoundsTree) result = new ChildBoundsTree(*child_bounds);
+    bool all_found = true;
+    for (PandaNode *child : stale_children) {
+      int n = result->find_child(child);
+      if (n < 0) {
+        all_found = false;
+        break;
+      }
+      ChildBoundsTree::Entry entry;
+      get_child_bounds_entry(entry, child, pipeline_stage, current_thread);
+      result->set_entry(n, entry);
+    }
+    if (all_found) {
+      return result;
+    }
+  }
+
+  pvector<PandaNode *> nodes;
+  ChildBoundsTree::Entries entries(num_children);
+  nodes.reserve(num_children);
+  for (size_t i = 0; i < num_children; ++i) {
+    PandaNode *child = children.get_child(i);
+    nodes.push_back(child);
+    get_child_bounds_entry(entries[i], child, pipeline_stage, current_thread);
+  }
+  return new ChildBoundsTree(nodes, entries);
+}
+
+/**
+ * Fills in the entry with the cached values of the indicated child,
+ * recomputing them first if they are stale.
+ */
+void PandaNode::
+get_child_bounds_entry(ChildBoundsTree::Entry &entry, PandaNode *child,
+                       int pipeline_stage, Thread *current_thread) {
+  CDLockedStageReader child_cdata(child->_cycler, pipeline_stage, current_thread);
+  if (child_cdata->_last_bounds_update != child_cdata->_next_update) {
+    CDStageWriter child_cdataw = child->update_cached(true, pipeline_stage, child_cdata);
+    entry.set(child_cdataw->_external_bounds, child_cdataw->_off_clip_planes,
+              child_cdataw->_net_collide_mask,
+              child_cdataw->_net_draw_control_mask,
+              child_cdataw->_net_draw_show_mask,
+              child_cdataw->_nested_vertices);
+  } else {
+    entry.set(child_cdata->_external_bounds, child_cdata->_off_clip_planes,
+              child_cdata->_net_collide_mask,
+              child_cdata->_net_draw_control_mask,
+              child_cdata->_net_draw_show_mask,
+              child_cdata->_nested_vertices);
+  }
+}
+
+/**
+ * Brings the child records up to date with the indicated tree of child bounds,
+ * which is about to be stored on the node.  If the node already has records
+ * that match the tree it is replacing, only the records of the stale children
+ * are updated; otherwise, they are all filled in anew from the tree.  This is
+ * called with the node's write lock held.
+ */
+void PandaNode::
+update_child_records(CData *cdata, const Children &children,
+                     const ChildBoundsTree *child_bounds,
+                     const pvector<PandaNode *> &stale_children) {
+  size_t num_children = children.get_num_children();
+  ChildRecords *records = cdata->_child_records;
+
+  if (records != nullptr && cdata->_child_bounds != nullptr &&
+      records->size() == num_children) {
+    if (records->get_ref_count() > 1) {
+      // Another pipeline stage, or a traversal, is still looking at these.
+      records = new ChildRecords(*records);
+      cdata->_child_records = records;
+    }
+
+    bool all_found = true;
+    for (PandaNode *child : stale_children) {
+      int n = child_bounds->find_child(child);
+      if (n < 0) {
+        all_found = false;
+        break;
+      }
+      const ChildBoundsTree::Entry &entry = child_bounds->get_entry(n);
+      (*records)[n].set_cached(entry._bounds, entry._net_collide_mask,
+                               entry._net_draw_control_mask,
+                               entry._net_draw_show_mask);
+    }
+    if (all_found) {
+      return;
+    }
+  }
+
+  records = new ChildRecords;
+  records->reserve(num_children);
+  for (size_t i = 0; i < num_children; ++i) {
+    ChildRecord record(children.get_child(i), children.get_child_sort(i));
+    const ChildBoundsTree::Entry &entry = child_bounds->get_entry(i);
+    record.set_cached(entry._bounds, entry._net_collide_mask,
+                      entry._net_draw_control_mask,
+                      entry._net_draw_show_mask);
+    records->push_back(record);
+  }
+  cdata->_child_records = records;
+}
+
 /**
  * This is used by the GraphicsEngine to hook in a pointer to the
  * scene_root_func(), the function to determine whether the node is an active
@@ -3676,6 +3968,36 @@ fillin_recorder(DatagramIterator &scan, BamReader *) {
   set_name(name);
 }
 
+/**
+ * Fills in the record with the cached values of the child.  The child's
+ * bounding volume is reduced to a sphere around it.
+ */
+void PandaNode::ChildRecord::
+set_cached(const BoundingVolume *bounds, CollideMask net_collide_mask,
+           DrawMask net_draw_control_mask, DrawMask net_draw_show_mask) {
+  _net_collide_mask = net_collide_mask;
+  _net_draw_control_mask = net_draw_control_mask;
+  _net_draw_show_mask = net_draw_show_mask;
+
+  _radius = -1;
+  if (bounds == nullptr || bounds->is_empty() || bounds->is_infinite()) {
+    return;
+  }
+  const BoundingSphere *sphere = bounds->as_bounding_sphere();
+  if (sphere != nullptr) {
+    _center = sphere->get_center();
+    _radius = sphere->get_radius();
+    return;
+  }
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv != nullptr) {
+    LPoint3 min_point = fbv->get_min();
+    LPoint3 max_point = fbv->get_max();
+    _center = (min_point + max_point) * 0.5f;
+    _radius = (max_point - min_point).length() * 0.5f;
+  }
+}
+
 /**
  *
  */
@@ -3734,6 +4056,9 @@ CData(const PandaNode::CData &copy) :
   _last_update(copy._last_update),
   _next_update(copy._next_update),
   _last_bounds_update(copy._last_bounds_update),
+  _child_bounds(copy._child_bounds),
+  _stale_children(copy._stale_children),
+  _child_records(copy._child_records),
 
   _down(copy._down),
   _stashed(copy._stashed),
@@ -46,6 +46,7 @@
 #include "lightReMutex.h"
 #include "extension.h"
 #include "simpleHashMap.h"
+#include "childBoundsTree.h"
 
 class NodePathComponent;
 class CullTraverser;
@@ -460,6 +461,44 @@ public:
     int _sort;
   };
 
+  // A compact copy of the values cached on one child that a traversal needs
+  // in order to decide whether to visit it.  A node with enough children
+  // keeps one of these for each child in a single array, so that a traversal
+  // can pass over the children that are hidden or out of bounds without
+  // touching the child nodes at all.  See child-records-min-children.
+  class EXPCL_PANDA_PGRAPH ChildRecord {
+  public:
+    INLINE ChildRecord(PandaNode *child, int sort);
+    void set_cached(const BoundingVolume *bounds, CollideMask net_collide_mask,
+                    DrawMask net_draw_control_mask,
+                    DrawMask net_draw_show_mask);
+
+    INLINE PandaNode *get_child() const;
+    INLINE int get_sort() const;
+    INLINE CollideMask get_net_collide_mask() const;
+    INLINE bool compare_draw_mask(DrawMask running_draw_mask,
+                                  DrawMask camera_mask) const;
+
+    INLINE bool has_bounds() const;
+    INLINE const LPoint3 &get_center() const;
+    INLINE PN_stdfloat get_radius() const;
+
+  private:
+    // The child is not reference counted here; the _down list holds it.
+    PandaNode *_child;
+    int _sort;
+    CollideMask _net_collide_mask;
+    DrawMask _net_draw_control_mask;
+    DrawMask _net_draw_show_mask;
+
+    // A sphere around the child's external bounding volume, in this node's
+    // coordinate space.  The radius is negative if the child's volume is
+    // empty, infinite, or not a finite shape.
+    LPoint3 _center;
+    PN_stdfloat _radius;
+  };
+  typedef RefCountObj<pvector<ChildRecord> > ChildRecords;
+
 private:
   typedef ov_multiset<DownConnection> DownList;
   typedef CopyOnWriteObj1< DownList, TypeHandle > Down;
@@ -635,6 +674,19 @@ private:
     // higher than _last_update.
     UpdateSeq _last_bounds_update;
 
+    // For a node with many children, the values above are also accumulated
+    // over groups of children in this tree, so that they can be recomputed
+    // quickly when only a few of the children change.  _stale_children
+    // lists the children that have changed since the tree was last brought
+    // up to date.  See incremental-bounds-min-children.
+    PT(ChildBoundsTree) _child_bounds;
+    pvector<PandaNode *> _stale_children;
+
+    // The children's cached values, in the same order as _down, for a node
+    // with many children.  This is only valid when _last_bounds_update is
+    // current.
+    PT(ChildRecords) _child_records;
+
   public:
     // This section stores the links to other nodes above and below this node
     // in the graph.
@@ -690,6 +742,11 @@ private:
   int do_find_child(PandaNode *node, const Down *down) const;
   CDStageWriter update_cached(bool update_bounds, int pipeline_stage,
                               CDLockedStageReader &cdata);
+  void mark_child_bounds_stale(PandaNode *child, int pipeline_stage,
+                               Thread *current_thread);
+  static void get_child_bounds_entry(ChildBoundsTree::Entry &entry,
+                                     PandaNode *child, int pipeline_stage,
+                                     Thread *current_thread);
 
   static DrawMask _overall_bit;
 
@@ -774,6 +831,7 @@ public:
   INLINE Children get_children(Thread *current_thread = Thread::get_current_thread()) const;
   INLINE Stashed get_stashed(Thread *current_thread = Thread::get_current_thread()) const;
   INLINE Parents get_parents(Thread *current_thread = Thread::get_current_thread()) const;
+  CPT(ChildRecords) get_child_records(Thread *current_thread = Thread::get_current_thread()) const;
 
   typedef bool SceneRootFunc(const PandaNode *);
   static void set_scene_root_func(SceneRootFunc *func);
@@ -784,6 +842,15 @@ PUBLISHED:
   MAKE_PROPERTY(parents, get_parents);
 
 private:
+  static PT(ChildBoundsTree)
+  update_child_bounds(ChildBoundsTree *child_bounds,
+                      const pvector<PandaNode *> &stale_children,
+                      const Children &children, int pipeline_stage,
+                      Thread *current_thread);
+  static void update_child_records(CData *cdata, const Children &children,
+                                   const ChildBoundsTree *child_bounds,
+                                   const pvector<PandaNode *> &stale_children);
+
   static SceneRootFunc *_scene_root_func;
 
 public:
@@ -891,6 +958,7 @@ public:
   INLINE PandaNode::Children get_children() const;
   INLINE PandaNode::Stashed get_stashed() const;
   INLINE PandaNode::Parents get_parents() const;
+  INLINE CPT(PandaNode::ChildRecords) get_child_records() const;
 
 private:
   const PandaNode *_node;
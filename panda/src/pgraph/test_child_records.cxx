@@ -0,0 +1,162 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_child_records.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "config_pgraph.h"
+#include "pandaNode.h"
+#include "cullTraverser.h"
+#include "cullTraverserData.h"
+#include "cullHandler.h"
+#include "transformState.h"
+#include "renderState.h"
+#include "perspectiveLens.h"
+#include "boundingSphere.h"
+#include "randomizer.h"
+#include "trueClock.h"
+
+/**
+ * A renderable node that counts how often the cull traversal reaches it.
+ */
+class CountingNode : public PandaNode {
+public:
+  CountingNode() : PandaNode("counting") {}
+
+  virtual bool is_renderable() const {
+    return true;
+  }
+  virtual void add_for_draw(CullTraverser *trav, CullTraverserData &data) {
+    ++_count;
+  }
+
+  static int _count;
+};
+
+int CountingNode::_count = 0;
+
+/**
+ * Moves num_moving of the children to random places on each frame, then
+ * culls the scene.  Returns the time per frame; num_drawn receives the number
+ * of children drawn on the last frame.
+ */
+static double
+run_frames(CullTraverser *trav, PandaNode *root,
+           GeometricBoundingVolume *frustum,
+           const pvector<PT(PandaNode) > &children, int num_moving,
+           int num_frames, int &num_drawn) {
+  Randomizer random(1);
+  TrueClock *clock = TrueClock::get_global_ptr();
+  Thread *current_thread = Thread::get_current_thread();
+
+  double start = clock->get_short_time();
+  for (int f = 0; f < num_frames; ++f) {
+    for (int i = 0; i < num_moving; ++i) {
+      PandaNode *child = children[random.random_int(children.size())];
+      child->set_transform(TransformState::make_pos
+                           (LPoint3(random.random_real(2000.0) - 1000.0,
+                                    random.random_real(2000.0) - 1000.0,
+                                    random.random_real(10.0))));
+    }
+    CountingNode::_count = 0;
+    CullTraverserData data(NodePath(root), TransformState::make_identity(),
+                           RenderState::make_empty(), frustum, current_thread);
+    trav->traverse(data);
+    num_drawn = CountingNode::_count;
+  }
+  return (clock->get_short_time() - start) / num_frames;
+}
+
+/**
+ * Times the cull traversal of a node with many children, of which only a few
+ * are in view and some are hidden from the camera, with and without
+ * child-records-min-children, and checks that the same children are drawn.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_children = 10000;
+  int num_frames = 200;
+  if (argc > 1) {
+    num_children = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_frames = atoi(argv[2]);
+  }
+  if (argc > 3 || num_children <= 0 || num_frames <= 0) {
+    nout << "test_child_records [num_children [num_frames]]\n";
+    exit(1);
+  }
+
+  init_libpgraph();
+
+  DrawMask camera_mask = DrawMask::bit(1);
+  PT(PandaNode) root = new PandaNode("root");
+  pvector<PT(PandaNode) > children;
+  Randomizer random(2);
+  for (int i = 0; i < num_children; ++i) {
+    PT(PandaNode) child = new CountingNode;
+    child->set_bounds(new BoundingSphere(LPoint3::origin(), 1.0f));
+    child->set_transform(TransformState::make_pos
+                         (LPoint3(random.random_real(2000.0) - 1000.0,
+                                  random.random_real(2000.0) - 1000.0,
+                                  random.random_real(10.0))));
+    if (i % 7 == 0) {
+      child->adjust_draw_mask(DrawMask::all_off(), camera_mask,
+                              DrawMask::all_off());
+    }
+    root->add_child(child);
+    children.push_back(child);
+  }
+
+  // The camera sits at the origin looking down the Y axis, and sees only a
+  // small part of the scene.
+  PT(PerspectiveLens) lens = new PerspectiveLens;
+  lens->set_fov(40.0f);
+  lens->set_far(300.0f);
+  PT(BoundingVolume) bounds = lens->make_bounds();
+  PT(GeometricBoundingVolume) frustum = bounds->as_geometric_bounding_volume();
+
+  PT(CullTraverser) trav = new CullTraverser;
+  trav->set_camera_mask(camera_mask);
+  trav->set_cull_handler(new CullHandler);
+
+  bool ok = true;
+  int min_children = child_records_min_children;
+  if (min_children <= 0) {
+    min_children = 64;
+  }
+  int num_moving[] = { 0, 10 };
+  for (int moving : num_moving) {
+    int plain_drawn, records_drawn;
+
+    child_records_min_children.set_value(0);
+    root->mark_bounds_stale();
+    double plain_time = run_frames(trav, root, frustum, children, moving,
+                                   num_frames, plain_drawn);
+
+    child_records_min_children.set_value(min_children);
+    root->mark_bounds_stale();
+    double records_time = run_frames(trav, root, frustum, children, moving,
+                                     num_frames, records_drawn);
+
+    // Both runs move the same children to the same places, so they end on
+    // the same scene.
+    nout << num_children << " children, " << moving << " moving: "
+         << plain_time * 1000000.0 << " us per frame without records, "
+         << records_time * 1000000.0 << " us with records ("
+         << plain_drawn << " / " << records_drawn << " drawn)\n";
+    ok = ok && plain_drawn == records_drawn && plain_drawn > 0 &&
+      plain_drawn < num_children / 10;
+  }
+
+  nout << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
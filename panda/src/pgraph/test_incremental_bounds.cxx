@@ -0,0 +1,133 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_incremental_bounds.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "config_pgraph.h"
+#include "pandaNode.h"
+#include "geomNode.h"
+#include "transformState.h"
+#include "boundingSphere.h"
+#include "randomizer.h"
+#include "trueClock.h"
+
+/**
+ * Moves num_moving of the children to random places on each frame, then
+ * recomputes the bounding volume of the parent, as the cull traversal would.
+ * Returns the time per frame, and checks that the bounds of the parent
+ * contain each of the children.
+ */
+static double
+run_frames(PandaNode *parent, const pvector<PT(PandaNode) > &children,
+           int num_moving, int num_frames, bool &ok) {
+  Randomizer random(1);
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  // Get the bounds once, so that we measure only the changes.
+  parent->get_bounds();
+
+  double start = clock->get_short_time();
+  for (int f = 0; f < num_frames; ++f) {
+    for (int i = 0; i < num_moving; ++i) {
+      PandaNode *child = children[random.random_int(children.size())];
+      child->set_transform(TransformState::make_pos
+                           (LPoint3(random.random_real(1000.0),
+                                    random.random_real(1000.0),
+                                    random.random_real(100.0))));
+    }
+    parent->get_bounds();
+  }
+  double elapsed = clock->get_short_time() - start;
+
+  // The bounds of the children are already in the parent's space.  Shrink
+  // them a little, since a child may touch the parent's bounds.
+  const GeometricBoundingVolume *bounds = parent->get_bounds()->as_geometric_bounding_volume();
+  for (PandaNode *child : children) {
+    const BoundingSphere *child_bounds = DCAST(BoundingSphere, child->get_bounds());
+    BoundingSphere inner(child_bounds->get_center(), child_bounds->get_radius() * 0.99f);
+    if ((bounds->contains(&inner) & BoundingVolume::IF_all) == 0) {
+      ok = false;
+    }
+  }
+  return elapsed / num_frames;
+}
+
+/**
+ * Times recomputing the bounding volume of a node with many children when one
+ * or all of them move on each frame, with and without
+ * incremental-bounds-min-children.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_children = 10000;
+  int num_frames = 200;
+  if (argc > 1) {
+    num_children = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_frames = atoi(argv[2]);
+  }
+  if (argc > 3 || num_children <= 0 || num_frames <= 0) {
+    nout << "test_incremental_bounds [num_children [num_frames]]\n";
+    exit(1);
+  }
+
+  init_libpgraph();
+
+  PT(PandaNode) parent = new PandaNode("parent");
+  pvector<PT(PandaNode) > children;
+  for (int i = 0; i < num_children; ++i) {
+    // A few of the children are GeomNodes, which may have a collide mask.
+    PT(PandaNode) child;
+    if (i % 100 == 0) {
+      child = new GeomNode("child");
+      child->set_into_collide_mask(CollideMask::all_off());
+    } else {
+      child = new PandaNode("child");
+    }
+    child->set_bounds(new BoundingSphere(LPoint3::origin(), 1.0f));
+    parent->add_child(child);
+    children.push_back(child);
+  }
+
+  bool ok = true;
+  int min_children = incremental_bounds_min_children;
+  int num_moving[] = { 1, 10, num_children };
+  for (int moving : num_moving) {
+    int frames = (moving == num_children) ? std::max(num_frames / 20, 1) : num_frames;
+
+    incremental_bounds_min_children.set_value(0);
+    double full_time = run_frames(parent, children, moving, frames, ok);
+    PN_stdfloat full_radius = DCAST(BoundingSphere, parent->get_bounds())->get_radius();
+
+    incremental_bounds_min_children.set_value(min_children);
+    double tree_time = run_frames(parent, children, moving, frames, ok);
+    PN_stdfloat tree_radius = DCAST(BoundingSphere, parent->get_bounds())->get_radius();
+
+    nout << num_children << " children, " << moving << " moving: "
+         << full_time * 1000000.0 << " us per frame without tree, "
+         << tree_time * 1000000.0 << " us with tree (radius "
+         << full_radius << " / " << tree_radius << ")\n";
+  }
+
+  // The other values accumulated from the children follow a change to one
+  // of them, too.
+  CollideMask bit = GeomNode::get_default_collide_mask();
+  children[0]->set_into_collide_mask(bit);
+  bool collide_set = (parent->get_net_collide_mask() & bit) == bit;
+  children[0]->set_into_collide_mask(CollideMask::all_off());
+  bool collide_cleared = (parent->get_net_collide_mask() & bit).is_zero();
+  ok = ok && collide_set && collide_cleared;
+
+  nout << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
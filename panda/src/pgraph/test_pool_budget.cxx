@@ -0,0 +1,178 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_pool_budget.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "config_gobj.h"
+#include "config_pgraph.h"
+#include "texturePool.h"
+#include "modelPool.h"
+#include "modelRoot.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "virtualFileSystem.h"
+
+/**
+ * Writes a texture of the indicated size to a txo file, and returns its
+ * filename.
+ */
+static Filename
+make_texture_file(const Filename &dir, int i, int size) {
+  PT(Texture) tex = new Texture("tex" + std::to_string(i));
+  tex->setup_2d_texture(size, size, Texture::T_unsigned_byte, Texture::F_rgba);
+  PTA_uchar image = tex->modify_ram_image();
+  for (size_t j = 0; j < image.size(); ++j) {
+    image[j] = (unsigned char)(i + j);
+  }
+  Filename filename(dir, "tex" + std::to_string(i) + ".txo");
+  tex->write(filename);
+  return filename;
+}
+
+/**
+ * Returns a model with one Geom whose vertex data occupies num_rows * 16
+ * bytes, plus index data.
+ */
+static PT(ModelRoot)
+make_model(const Filename &filename, int num_rows) {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("vdata", GeomVertexFormat::get_v3c4(), GeomEnums::UH_static);
+  vdata->unclean_set_num_rows(num_rows);
+  PT(GeomTriangles) tris = new GeomTriangles(GeomEnums::UH_static);
+  for (int i = 0; i + 2 < num_rows; i += 3) {
+    tris->add_vertices(i, i + 1, i + 2);
+  }
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+
+  PT(GeomNode) gnode = new GeomNode("geom");
+  gnode->add_geom(geom);
+  PT(ModelRoot) root = new ModelRoot(filename);
+  root->add_child(gnode);
+  return root;
+}
+
+/**
+ * Fills the TexturePool and the ModelPool past a RAM budget, and checks that
+ * the least-recently-used unreferenced entries are evicted, that referenced
+ * ones are kept, and that evicted textures are reloaded on demand.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_assets = 40;
+  if (argc > 1) {
+    num_assets = atoi(argv[1]);
+  }
+  if (argc > 2 || num_assets < 10) {
+    nout << "test_pool_budget [num_assets]\n";
+    exit(1);
+  }
+
+  init_libpgraph();
+  bool ok = true;
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  Filename dir = Filename::temporary("", "pool_budget");
+  vfs->make_directory_full(dir);
+
+  // Textures.  Keep the RAM images after loading, as if they had been
+  // preloaded or keep-texture-ram were set.
+  const int tex_size = 128;
+  const size_t tex_bytes = tex_size * tex_size * 4;
+  pvector<Filename> tex_files;
+  for (int i = 0; i < num_assets; ++i) {
+    tex_files.push_back(make_texture_file(dir, i, tex_size));
+  }
+
+  LoaderOptions options;
+  options.set_texture_flags(LoaderOptions::TF_preload);
+  PT(Texture) held;
+  for (int i = 0; i < num_assets; ++i) {
+    Texture *tex = TexturePool::load_texture(tex_files[i], 0, false, options);
+    if (i == 1) {
+      // The second texture is in use, so it must survive even though it is
+      // old.
+      held = tex;
+    }
+  }
+  size_t unbudgeted_size = TexturePool::get_ram_size();
+
+  size_t budget = tex_bytes * num_assets / 4;
+  TexturePool::set_ram_budget(budget);
+  int num_released = num_assets - TexturePool::find_all_textures().size();
+  size_t budgeted_size = TexturePool::get_ram_size();
+  bool held_kept = (TexturePool::find_texture("tex1") == held);
+  bool oldest_gone = (TexturePool::find_texture("tex0") == nullptr);
+  bool newest_kept = (TexturePool::find_texture("tex" + std::to_string(num_assets - 1)) != nullptr);
+
+  // Loading another texture keeps the pool in budget, and an evicted texture
+  // comes back from disk with its image intact.
+  PT(Texture) reloaded = TexturePool::load_texture(tex_files[0], 0, false, options);
+  CPTA_uchar image = reloaded->get_ram_image();
+  bool reload_ok = (image.size() == tex_bytes && image[5] == 5);
+  bool still_in_budget = TexturePool::get_ram_size() <= budget;
+
+  nout << num_assets << " textures: " << unbudgeted_size
+       << " bytes without a budget, " << budgeted_size << " bytes with a "
+       << budget << " byte budget (" << num_released << " released)\n";
+  ok = ok && (unbudgeted_size == tex_bytes * num_assets) &&
+    budgeted_size <= budget && num_released > 0 &&
+    held_kept && oldest_gone && newest_kept && reload_ok && still_in_budget;
+
+  // Models.
+  const int num_rows = 3000;
+  pvector<PT(ModelRoot) > kept;
+  for (int i = 0; i < num_assets; ++i) {
+    Filename filename(dir, "model" + std::to_string(i) + ".bam");
+    PT(ModelRoot) model = make_model(filename, num_rows);
+    ModelPool::add_model(filename, model);
+    if (i % 4 == 0) {
+      // A copy of the model, as the Loader returns, keeps it in use.
+      kept.push_back(DCAST(ModelRoot, model->copy_subgraph()));
+    }
+  }
+  size_t model_bytes = ModelPool::get_ram_size() / num_assets;
+  size_t model_budget = model_bytes * num_assets / 2;
+  ModelPool::set_ram_budget(model_budget);
+
+  int num_models = 0;
+  bool kept_ok = true;
+  for (int i = 0; i < num_assets; ++i) {
+    Filename filename(dir, "model" + std::to_string(i) + ".bam");
+    bool present = ModelPool::has_model(filename);
+    num_models += present;
+    if (i % 4 == 0 && !present) {
+      kept_ok = false;
+    }
+  }
+
+  nout << num_assets << " models of " << model_bytes << " bytes: "
+       << num_models << " kept with a " << model_budget << " byte budget, "
+       << ModelPool::get_ram_size() << " bytes\n";
+  ok = ok && model_bytes >= num_rows * 16 &&
+    ModelPool::get_ram_size() <= model_budget && kept_ok &&
+    num_models < num_assets;
+
+  // Clean up.
+  ModelPool::release_all_models();
+  TexturePool::release_all_textures();
+  for (const Filename &filename : tex_files) {
+    vfs->delete_file(filename);
+  }
+  vfs->delete_file(dir);
+
+  nout << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
@@ -30,6 +30,14 @@ AngularEulerIntegrator::
 ~AngularEulerIntegrator() {
 }
 
+/**
+ * Returns a new integrator of the same kind as this one.
+ */
+AngularIntegrator *AngularEulerIntegrator::
+make_copy() const {
+  return new AngularEulerIntegrator;
+}
+
 /**
  * Integrate a step of motion (based on dt) by applying every force in
  * force_vec to every object in obj_vec.
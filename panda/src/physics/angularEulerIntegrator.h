@@ -25,6 +25,10 @@ PUBLISHED:
   AngularEulerIntegrator();
   virtual ~AngularEulerIntegrator();
 
+public:
+  virtual AngularIntegrator *make_copy() const;
+
+PUBLISHED:
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
 
@@ -30,6 +30,16 @@ AngularIntegrator::
 ~AngularIntegrator() {
 }
 
+/**
+ * Returns a new integrator of the same kind as this one, or NULL if this
+ * integrator cannot be copied.  PhysicsManager uses a copy for each of its
+ * worker threads, since an integrator keeps state while it integrates.
+ */
+AngularIntegrator *AngularIntegrator::
+make_copy() const {
+  return nullptr;
+}
+
 /**
  * high-level integration.  API.
  */
@@ -30,6 +30,8 @@ public:
   void integrate(Physical *physical, AngularForceVector &forces,
                  PN_stdfloat dt);
 
+  virtual AngularIntegrator *make_copy() const;
+
 PUBLISHED:
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
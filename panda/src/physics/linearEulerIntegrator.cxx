@@ -12,6 +12,7 @@
  */
 
 #include "linearEulerIntegrator.h"
+#include "linearVectorForce.h"
 #include "forceNode.h"
 #include "physicalNode.h"
 #include "config_physics.h"
@@ -30,6 +31,14 @@ LinearEulerIntegrator::
 ~LinearEulerIntegrator() {
 }
 
+/**
+ * Returns a new integrator of the same kind as this one.
+ */
+LinearIntegrator *LinearEulerIntegrator::
+make_copy() const {
+  return new LinearEulerIntegrator;
+}
+
 /**
  * Integrate a step of motion (based on dt) by applying every force in
  * force_vec to every object in obj_vec.
@@ -59,6 +68,33 @@ child_integrate(Physical *physical,
   // Get the greater of the local or global viscosity:
   PN_stdfloat viscosityDamper=1.0f-physical->get_viscosity();
 
+  // If every active force is a LinearVectorForce, the forces don't depend on
+  // the object, so they can be summed just once, in the same order as below.
+  bool uniform_forces = true;
+  LVector3 md_uniform_vec(0.0f, 0.0f, 0.0f);
+  LVector3 non_md_uniform_vec(0.0f, 0.0f, 0.0f);
+  {
+    int index = 0;
+    size_t num_global = forces.size();
+    size_t num_forces = num_global + physical->get_linear_forces().size();
+    for (size_t i = 0; i < num_forces && uniform_forces; ++i) {
+      LinearForce *cur_force = (i < num_global) ? forces[i].p() : physical->get_linear_forces()[i - num_global].p();
+      if (cur_force->get_active() == false) {
+        continue;
+      }
+      if (!cur_force->is_exact_type(LinearVectorForce::get_class_type())) {
+        uniform_forces = false;
+        break;
+      }
+      LVector3 f = cur_force->get_vector(nullptr) * matrices[index++];
+      if (cur_force->get_mass_dependent() == true) {
+        md_uniform_vec += f;
+      } else {
+        non_md_uniform_vec += f;
+      }
+    }
+  }
+
   // Loop through each object in the set.  This processing occurs in O(pf)
   // time, where p is the number of physical objects and f is the number of
   // forces.  Unfortunately, no precomputation of forces can occur, as each
@@ -85,58 +121,63 @@ child_integrate(Physical *physical,
     LVector3 accel_vec;
     LVector3 vel_vec;
 
-    // reset the accumulation vectors for this object
-    md_accum_vec.set(0.0f, 0.0f, 0.0f);
-    non_md_accum_vec.set(0.0f, 0.0f, 0.0f);
-
-    // run through each acting force and sum it
-    LVector3 f;
-    // LMatrix4 force_to_object_xform;
-
-    LinearForceVector::const_iterator f_cur;
-
-    // global forces
-    f_cur = forces.begin();
-    int index = 0;
-    for (; f_cur != forces.end(); ++f_cur) {
-      LinearForce *cur_force = *f_cur;
-
-      // make sure the force is turned on.
-      if (cur_force->get_active() == false) {
-        continue;
-      }
-
-      // now we go from force space to our object's space.
-      f = cur_force->get_vector(current_object) * matrices[index++];
-
-      physics_spam("child_integrate "<<f);
-      // tally it into the accum vectors.
-      if (cur_force->get_mass_dependent() == true) {
-        md_accum_vec += f;
-      } else {
-        non_md_accum_vec += f;
+    if (uniform_forces) {
+      md_accum_vec = md_uniform_vec;
+      non_md_accum_vec = non_md_uniform_vec;
+    } else {
+      // reset the accumulation vectors for this object
+      md_accum_vec.set(0.0f, 0.0f, 0.0f);
+      non_md_accum_vec.set(0.0f, 0.0f, 0.0f);
+
+      // run through each acting force and sum it
+      LVector3 f;
+      // LMatrix4 force_to_object_xform;
+
+      LinearForceVector::const_iterator f_cur;
+
+      // global forces
+      f_cur = forces.begin();
+      int index = 0;
+      for (; f_cur != forces.end(); ++f_cur) {
+        LinearForce *cur_force = *f_cur;
+
+        // make sure the force is turned on.
+        if (cur_force->get_active() == false) {
+          continue;
+        }
+
+        // now we go from force space to our object's space.
+        f = cur_force->get_vector(current_object) * matrices[index++];
+
+        physics_spam("child_integrate "<<f);
+        // tally it into the accum vectors.
+        if (cur_force->get_mass_dependent() == true) {
+          md_accum_vec += f;
+        } else {
+          non_md_accum_vec += f;
+        }
       }
-    }
-
-    // local forces
-    f_cur = physical->get_linear_forces().begin();
-    for (; f_cur != physical->get_linear_forces().end(); ++f_cur) {
-      LinearForce *cur_force = *f_cur;
 
-      // make sure the force is turned on.
-      if (cur_force->get_active() == false) {
-        continue;
-      }
-
-      // go from force space to object space
-      f = cur_force->get_vector(current_object) * matrices[index++];
-
-      physics_spam("child_integrate "<<f);
-      // tally it into the accum vectors
-      if (cur_force->get_mass_dependent() == true) {
-        md_accum_vec += f;
-      } else {
-        non_md_accum_vec += f;
+      // local forces
+      f_cur = physical->get_linear_forces().begin();
+      for (; f_cur != physical->get_linear_forces().end(); ++f_cur) {
+        LinearForce *cur_force = *f_cur;
+
+        // make sure the force is turned on.
+        if (cur_force->get_active() == false) {
+          continue;
+        }
+
+        // go from force space to object space
+        f = cur_force->get_vector(current_object) * matrices[index++];
+
+        physics_spam("child_integrate "<<f);
+        // tally it into the accum vectors
+        if (cur_force->get_mass_dependent() == true) {
+          md_accum_vec += f;
+        } else {
+          non_md_accum_vec += f;
+        }
       }
     }
 
@@ -34,6 +34,16 @@ LinearIntegrator::
 ~LinearIntegrator() {
 }
 
+/**
+ * Returns a new integrator of the same kind as this one, or NULL if this
+ * integrator cannot be copied.  PhysicsManager uses a copy for each of its
+ * worker threads, since an integrator keeps state while it integrates.
+ */
+LinearIntegrator *LinearIntegrator::
+make_copy() const {
+  return nullptr;
+}
+
 /**
  * parent integration routine, hands off to child virtual.
  */
@@ -46,6 +56,14 @@ integrate(Physical *physical, LinearForceVector &forces,
     dt = _max_linear_dt;
 */
 
+  if (physical->get_object_vector().empty()) {
+    // There are no PhysicsObjects to integrate, but the Physical may keep
+    // objects of its own.
+    precompute_linear_matrices(physical, forces);
+    physical->integrate_linear_arrays(forces, get_precomputed_linear_matrices(), dt);
+    return;
+  }
+
   PhysicsObject::Vector::const_iterator current_object_iter;
   current_object_iter = physical->get_object_vector().begin();
   for (; current_object_iter != physical->get_object_vector().end();
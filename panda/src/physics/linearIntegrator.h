@@ -31,6 +31,8 @@ public:
   void integrate(Physical *physical, LinearForceVector &forces,
                  PN_stdfloat dt);
 
+  virtual LinearIntegrator *make_copy() const;
+
 PUBLISHED:
   virtual void output(std::ostream &out) const;
   virtual void write(std::ostream &out, int indent=0) const;
@@ -106,6 +106,22 @@ Physical::
   }
 }
 
+/**
+ * Called by the LinearIntegrator instead of integrating each PhysicsObject,
+ * when this Physical has none.  A Physical that keeps its objects in arrays
+ * of its own, such as a ParticleSystem in array mode, overrides this to
+ * integrate them all at once.
+ *
+ * forces are the global forces passed to the integrator; matrices holds the
+ * transform from each of those forces, followed by each of this Physical's
+ * own linear forces, to the space of the Physical's parent.  The default
+ * implementation does nothing.
+ */
+void Physical::
+integrate_linear_arrays(const LinearForceVector &, const epvector<LMatrix4> &,
+                        PN_stdfloat) {
+}
+
 /**
 
  */
@@ -19,6 +19,7 @@
 #include "typedReferenceCount.h"
 
 #include "pvector.h"
+#include "epvector.h"
 #include "plist.h"
 
 #include "physicsObject.h"
@@ -91,6 +92,10 @@ public:
   INLINE const LinearForceVector &get_linear_forces() const;
   INLINE const AngularForceVector &get_angular_forces() const;
 
+  virtual void integrate_linear_arrays(const LinearForceVector &forces,
+                                       const epvector<LMatrix4> &matrices,
+                                       PN_stdfloat dt);
+
   friend class PhysicsManager;
   friend class PhysicalNode;
 
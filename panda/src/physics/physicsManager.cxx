@@ -13,6 +13,8 @@
 
 #include "physicsManager.h"
 #include "actorNode.h"
+#include "linearRandomForce.h"
+#include "linearUserDefinedForce.h"
 
 #include <algorithm>
 #include "pvector.h"
@@ -22,14 +24,25 @@ using std::ostream;
 ConfigVariableInt PhysicsManager::_random_seed
 ("physics_manager_random_seed", 139);
 
+ConfigVariableInt PhysicsManager::_default_num_threads
+("physics-manager-threads", 1,
+ PRC_DESC("The default number of threads, including the calling thread, "
+          "that PhysicsManager::do_physics() may use to integrate its "
+          "Physicals.  Only managers with many Physicals are split across "
+          "threads."));
+
 /**
  * Default Constructor.  NOTE: EulerIntegrator is the standard default.
  */
 PhysicsManager::
-PhysicsManager() {
+PhysicsManager() :
+  _pool("physics"),
+  _dt(0.0f)
+{
   _linear_integrator.clear();
   _angular_integrator.clear();
   _viscosity=0.0;
+  _pool.set_num_threads(std::max((int)_default_num_threads, 1));
 }
 
 /**
@@ -44,6 +57,27 @@ PhysicsManager::
   }
 }
 
+/**
+ * Sets the number of threads, including the calling thread, that
+ * do_physics() may use to integrate the Physicals.  The default is taken from
+ * the physics-manager-threads config variable.
+ *
+ * The Physicals are divided among the threads, and the ActorNodes are all
+ * updated afterwards on the calling thread, rather than each one right after
+ * its Physical is integrated.  So that this gives the same results as a
+ * single thread, the Physicals are integrated on one thread whenever a force
+ * node, or the parent of a Physical's node, is below another ActorNode of
+ * this manager.  Physicals acted on by a LinearRandomForce, which draws from
+ * rand(), or a LinearUserDefinedForce are always integrated in order on the
+ * calling thread.  The integrators must support make_copy() for threads to be
+ * used.
+ */
+void PhysicsManager::
+set_num_threads(int num_threads) {
+  nassertv(num_threads >= 1);
+  _pool.set_num_threads(num_threads);
+}
+
 /**
  * One-time config function, sets up the random seed used by the physics and
  * particle systems.  For synchronizing across distributed computers
@@ -123,6 +157,10 @@ remove_physical_node(PhysicalNode *p) {
  */
 void PhysicsManager::
 do_physics(PN_stdfloat dt) {
+  if (do_physics_parallel(dt)) {
+    return;
+  }
+
   // now, run through each physics object in the set.
   PhysicalsVector::iterator p_cur = _physicals.begin();
   for (; p_cur != _physicals.end(); ++p_cur) {
@@ -296,3 +334,202 @@ debug_output(ostream &out, int indent) const {
   }
   #endif //] NDEBUG
 }
+
+/**
+ * Integrates the Physicals on several threads, if that is enabled and worth
+ * doing.  Returns false, having done nothing, if do_physics() should instead
+ * integrate them on the calling thread.
+ */
+bool PhysicsManager::
+do_physics_parallel(PN_stdfloat dt) {
+  int num_threads = _pool.get_num_threads();
+  if (num_threads <= 1 || !Thread::is_true_threads() ||
+      _physicals.size() < min_physicals_per_thread * 2) {
+    return false;
+  }
+
+  // A global force that must be evaluated serially affects everything.
+  LinearForceVector::const_iterator fi;
+  for (fi = _linear_forces.begin(); fi != _linear_forces.end(); ++fi) {
+    if ((*fi)->is_of_type(LinearRandomForce::get_class_type()) ||
+        (*fi)->is_of_type(LinearUserDefinedForce::get_class_type())) {
+      return false;
+    }
+  }
+
+  // Make sure each thread has copies of the current integrators.
+  _thread_integrators.resize(num_threads);
+  for (int i = 1; i < num_threads; ++i) {
+    ThreadIntegrators &ti = _thread_integrators[i];
+    if (ti._linear_source != _linear_integrator) {
+      ti._linear_source = _linear_integrator;
+      ti._linear_integrator.clear();
+      if (_linear_integrator != nullptr) {
+        ti._linear_integrator = _linear_integrator->make_copy();
+      }
+    }
+    if (ti._angular_source != _angular_integrator) {
+      ti._angular_source = _angular_integrator;
+      ti._angular_integrator.clear();
+      if (_angular_integrator != nullptr) {
+        ti._angular_integrator = _angular_integrator->make_copy();
+      }
+    }
+    if (ti._linear_integrator == nullptr && _linear_integrator != nullptr) {
+      return false;
+    }
+    if (ti._angular_integrator == nullptr && _angular_integrator != nullptr) {
+      return false;
+    }
+  }
+
+  // The serial loop updates each ActorNode right after integrating it, so
+  // the Physicals after it see its new transform.  We update them all at
+  // the end instead, which gives the same result only if no force node, and
+  // no parent of a Physical's node, is below one of our ActorNodes.
+  _actor_nodes.clear();
+  PhysicalsVector::const_iterator pi;
+  for (pi = _physicals.begin(); pi != _physicals.end(); ++pi) {
+    PhysicalNode *pn = (*pi)->get_physical_node();
+    if (pn && pn->is_of_type(ActorNode::get_class_type())) {
+      _actor_nodes.insert(pn);
+    }
+  }
+
+  bool parallel_ok = true;
+  for (fi = _linear_forces.begin(); fi != _linear_forces.end() && parallel_ok; ++fi) {
+    parallel_ok = !depends_on_actor((*fi)->get_force_node_path(), nullptr);
+  }
+  AngularForceVector::const_iterator ai;
+  for (ai = _angular_forces.begin(); ai != _angular_forces.end() && parallel_ok; ++ai) {
+    parallel_ok = !depends_on_actor((*ai)->get_force_node_path(), nullptr);
+  }
+
+  _parallel_physicals.clear();
+  _serial_physicals.clear();
+  for (pi = _physicals.begin(); pi != _physicals.end() && parallel_ok; ++pi) {
+    Physical *physical = *pi;
+    const PandaNode *node = physical->get_physical_node();
+    parallel_ok = !depends_on_actor(physical->get_physical_node_path().get_parent(), node);
+
+    // A force below the Physical's own node moves along with it, which is
+    // the same either way.
+    const LinearForceVector &linear_forces = physical->get_linear_forces();
+    for (fi = linear_forces.begin(); fi != linear_forces.end() && parallel_ok; ++fi) {
+      parallel_ok = !depends_on_actor((*fi)->get_force_node_path(), node);
+    }
+    const AngularForceVector &angular_forces = physical->get_angular_forces();
+    for (ai = angular_forces.begin(); ai != angular_forces.end() && parallel_ok; ++ai) {
+      parallel_ok = !depends_on_actor((*ai)->get_force_node_path(), node);
+    }
+
+    if (is_parallel_safe(physical)) {
+      _parallel_physicals.push_back(physical);
+    } else {
+      _serial_physicals.push_back(physical);
+    }
+  }
+  _actor_nodes.clear();
+
+  if (!parallel_ok) {
+    _parallel_physicals.clear();
+    _serial_physicals.clear();
+    return false;
+  }
+
+  // The calling thread first takes the Physicals that must be done in order,
+  // and then its share of the rest.
+  integrate_range(_serial_physicals, 0, _serial_physicals.size(),
+                  _linear_integrator, _angular_integrator, dt);
+  _dt = dt;
+  _pool.run(_parallel_physicals.size(), min_physicals_per_thread,
+            &integrate_range_func, this);
+
+  // Now that all of the integration is done, update the ActorNodes, which
+  // changes the scene graph.
+  for (pi = _physicals.begin(); pi != _physicals.end(); ++pi) {
+    PhysicalNode *pn = (*pi)->get_physical_node();
+    if (pn && pn->is_of_type(ActorNode::get_class_type())) {
+      ActorNode *an = (ActorNode *) pn;
+      an->update_transform();
+    }
+  }
+
+  _parallel_physicals.clear();
+  _serial_physicals.clear();
+  return true;
+}
+
+/**
+ * Integrates the Physicals in the indicated range of the vector, using the
+ * given integrators.  This may be called on several threads at once, for
+ * different ranges and with different integrators.
+ */
+void PhysicsManager::
+integrate_range(const PhysicalsVector &physicals, size_t begin, size_t end,
+                LinearIntegrator *linear_integrator,
+                AngularIntegrator *angular_integrator,
+                PN_stdfloat dt) {
+  for (size_t i = begin; i < end; ++i) {
+    Physical *physical = physicals[i];
+    if (linear_integrator != nullptr) {
+      linear_integrator->integrate(physical, _linear_forces, dt);
+    }
+    if (angular_integrator != nullptr) {
+      angular_integrator->integrate(physical, _angular_forces, dt);
+    }
+  }
+}
+
+/**
+ * The function run by the WorkerThreadPool for each range of
+ * _parallel_physicals.
+ */
+void PhysicsManager::
+integrate_range_func(void *data, int thread_index, size_t begin, size_t end) {
+  PhysicsManager *manager = (PhysicsManager *)data;
+  if (thread_index == 0) {
+    manager->integrate_range(manager->_parallel_physicals, begin, end,
+                             manager->_linear_integrator,
+                             manager->_angular_integrator, manager->_dt);
+  } else {
+    const ThreadIntegrators &ti = manager->_thread_integrators[thread_index];
+    manager->integrate_range(manager->_parallel_physicals, begin, end,
+                             ti._linear_integrator, ti._angular_integrator,
+                             manager->_dt);
+  }
+}
+
+/**
+ * Returns true if the indicated Physical may be integrated on any thread, or
+ * false if one of its own forces must be evaluated on the calling thread.
+ */
+bool PhysicsManager::
+is_parallel_safe(const Physical *physical) const {
+  const LinearForceVector &forces = physical->get_linear_forces();
+  LinearForceVector::const_iterator fi;
+  for (fi = forces.begin(); fi != forces.end(); ++fi) {
+    if ((*fi)->is_of_type(LinearRandomForce::get_class_type()) ||
+        (*fi)->is_of_type(LinearUserDefinedForce::get_class_type())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns true if the indicated node, or any of its ancestors other than
+ * except, is the ActorNode of one of our Physicals.  Only valid during
+ * do_physics_parallel().
+ */
+bool PhysicsManager::
+depends_on_actor(NodePath np, const PandaNode *except) const {
+  while (!np.is_empty()) {
+    const PandaNode *node = np.node();
+    if (node != except && _actor_nodes.find(node) != _actor_nodes.end()) {
+      return true;
+    }
+    np = np.get_parent();
+  }
+  return false;
+}
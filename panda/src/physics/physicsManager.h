@@ -23,9 +23,12 @@
 #include "linearIntegrator.h"
 #include "angularIntegrator.h"
 #include "physicalNode.h"
+#include "nodePath.h"
 
 #include "plist.h"
 #include "pvector.h"
+#include "pset.h"
+#include "workerThreadPool.h"
 
 #include "configVariableInt.h"
 
@@ -63,6 +66,9 @@ PUBLISHED:
   INLINE void set_viscosity(PN_stdfloat viscosity);
   INLINE PN_stdfloat get_viscosity() const;
 
+  void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+
   void remove_physical(Physical *p);
   void remove_physical_node(PhysicalNode *p);
   void remove_linear_force(LinearForce *f);
@@ -82,8 +88,23 @@ PUBLISHED:
 public:
   friend class Physical;
   static ConfigVariableInt _random_seed;
+  static ConfigVariableInt _default_num_threads;
 
 private:
+  bool do_physics_parallel(PN_stdfloat dt);
+  void integrate_range(const PhysicalsVector &physicals,
+                       size_t begin, size_t end,
+                       LinearIntegrator *linear_integrator,
+                       AngularIntegrator *angular_integrator,
+                       PN_stdfloat dt);
+  static void integrate_range_func(void *data, int thread_index,
+                                   size_t begin, size_t end);
+  bool is_parallel_safe(const Physical *physical) const;
+  bool depends_on_actor(NodePath np, const PandaNode *except) const;
+
+  // The minimum number of Physicals worth handing to each thread.
+  static const size_t min_physicals_per_thread = 32;
+
   PN_stdfloat _viscosity;
   PhysicalsVector _physicals;
   LinearForceVector _linear_forces;
@@ -91,6 +112,32 @@ private:
 
   PT(LinearIntegrator) _linear_integrator;
   PT(AngularIntegrator) _angular_integrator;
+
+  // Each worker thread uses its own copies of the integrators, since they
+  // cache per-Physical state while integrating.  These are indexed by the
+  // thread index; the calling thread, number 0, uses the integrators above.
+  class ThreadIntegrators {
+  public:
+    PT(LinearIntegrator) _linear_source;
+    PT(LinearIntegrator) _linear_integrator;
+    PT(AngularIntegrator) _angular_source;
+    PT(AngularIntegrator) _angular_integrator;
+  };
+  typedef pvector<ThreadIntegrators> ThreadIntegratorsVector;
+  ThreadIntegratorsVector _thread_integrators;
+
+  // The Physicals that may be integrated on any thread during the current
+  // call to do_physics(), and those that must be integrated in order on the
+  // calling thread.
+  PhysicalsVector _parallel_physicals;
+  PhysicalsVector _serial_physicals;
+
+  // The ActorNodes of the Physicals, during the current call to do_physics().
+  typedef pset<const PandaNode *> ActorNodes;
+  ActorNodes _actor_nodes;
+
+  WorkerThreadPool _pool;
+  PN_stdfloat _dt;
 };
 
 #include "physicsManager.I"
@@ -0,0 +1,155 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_physics_threads.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "physicsManager.h"
+#include "linearEulerIntegrator.h"
+#include "angularEulerIntegrator.h"
+#include "actorNode.h"
+#include "forceNode.h"
+#include "forces.h"
+#include "nodePath.h"
+#include "trueClock.h"
+
+/**
+ * Builds a scene of num_actors ActorNodes falling under gravity, some with
+ * friction and a few with jitter, and runs it for num_frames frames using the
+ * indicated number of threads.  Returns the time taken, and fills in the
+ * final positions of the actors.
+ *
+ * If nested is true, some of the actors are parented to other actors, and
+ * one of the forces is parented to an actor, so that the integration depends
+ * on the order in which the actors are updated.
+ */
+static double
+run_scene(int num_actors, int num_frames, int num_threads, bool nested,
+          pvector<LPoint3> &positions) {
+  NodePath root("root");
+  PhysicsManager manager;
+  manager.attach_linear_integrator(new LinearEulerIntegrator);
+  manager.attach_angular_integrator(new AngularEulerIntegrator);
+  manager.set_num_threads(num_threads);
+
+  PT(ForceNode) force_node = new ForceNode("forces");
+  root.attach_new_node(force_node);
+  PT(LinearVectorForce) gravity = new LinearVectorForce(0.0f, 0.0f, -9.8f);
+  force_node->add_force(gravity);
+  manager.add_linear_force(gravity);
+
+  PT(LinearFrictionForce) friction = new LinearFrictionForce(0.2f);
+  force_node->add_force(friction);
+  PT(LinearJitterForce) jitter = new LinearJitterForce(0.5f);
+  force_node->add_force(jitter);
+
+  pvector<PT(ActorNode) > actors;
+  NodePath prev_np;
+  for (int i = 0; i < num_actors; ++i) {
+    PT(ActorNode) actor = new ActorNode("actor");
+    NodePath parent = root;
+    if (nested && i % 10 == 5) {
+      parent = prev_np;
+    }
+    NodePath np = parent.attach_new_node(actor);
+    prev_np = np;
+    np.set_pos(i % 100, i / 100, 100.0f);
+
+    PhysicsObject *object = actor->get_physics_object();
+    object->set_position(np.get_pos());
+    object->set_velocity(LVector3((i % 7) - 3.0f, (i % 5) - 2.0f, 10.0f));
+    object->set_mass(1.0f + (i % 3));
+    if (i % 4 == 0) {
+      actor->get_physical(0)->add_linear_force(friction);
+    }
+    if (i % 500 == 0) {
+      actor->get_physical(0)->add_linear_force(jitter);
+    }
+    manager.attach_physical_node(actor);
+    actors.push_back(actor);
+  }
+
+  if (nested) {
+    PT(ForceNode) wind_node = new ForceNode("wind");
+    NodePath(actors[0]).attach_new_node(wind_node);
+    PT(LinearVectorForce) wind = new LinearVectorForce(1.0f, 0.0f, 0.0f);
+    wind_node->add_force(wind);
+    manager.add_linear_force(wind);
+  }
+
+  srand(1);
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int f = 0; f < num_frames; ++f) {
+    manager.do_physics(1.0f / 60.0f);
+  }
+  double elapsed = clock->get_short_time() - start;
+
+  positions.clear();
+  for (size_t i = 0; i < actors.size(); ++i) {
+    positions.push_back(actors[i]->get_physics_object()->get_position());
+    positions.push_back(actors[i]->get_transform()->get_pos());
+  }
+
+  manager.clear_physicals();
+  return elapsed;
+}
+
+/**
+ * Times PhysicsManager::do_physics() on a scene with thousands of ActorNodes
+ * with one thread and with the indicated number of threads, and checks that
+ * both produce exactly the same positions, with and without actors and
+ * forces parented to other actors.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_actors = 10000;
+  int num_frames = 200;
+  int num_threads = 4;
+
+  if (argc > 1) {
+    num_actors = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_frames = atoi(argv[2]);
+  }
+  if (argc > 3) {
+    num_threads = atoi(argv[3]);
+  }
+  if (argc > 4 || num_actors <= 0 || num_frames <= 0 || num_threads <= 0) {
+    nout << "test_physics_threads [num_actors [num_frames [num_threads]]]\n";
+    exit(1);
+  }
+
+  size_t num_different = 0;
+  for (int nested = 0; nested < 2; ++nested) {
+    pvector<LPoint3> serial_positions, parallel_positions;
+    double serial_time = run_scene(num_actors, num_frames, 1, nested != 0,
+                                   serial_positions);
+    double parallel_time = run_scene(num_actors, num_frames, num_threads,
+                                     nested != 0, parallel_positions);
+
+    size_t scene_different = 0;
+    for (size_t i = 0; i < serial_positions.size(); ++i) {
+      if (serial_positions[i] != parallel_positions[i]) {
+        ++scene_different;
+      }
+    }
+    num_different += scene_different;
+
+    nout << num_actors << (nested ? " nested" : "") << " actors, "
+         << num_frames << " frames: " << serial_time << " s with 1 thread, "
+         << parallel_time << " s with " << num_threads << " threads; "
+         << scene_different << " positions differ.\n";
+  }
+
+  return (num_different == 0) ? 0 : 1;
+}
@@ -15,6 +15,7 @@
 #include "pipelineCyclerTrueImpl.h"
 #include "configVariableInt.h"
 #include "config_pipeline.h"
+#include "trueClock.h"
 
 Pipeline *Pipeline::_render_pipeline = nullptr;
 
@@ -26,6 +27,7 @@ Pipeline(const std::string &name, int num_stages) :
   Namable(name),
 #ifdef THREADED_PIPELINE
   _num_stages(num_stages),
+  _cycle_pool("pipeline-cycle"),
   _cycle_lock("Pipeline cycle"),
   _lock("Pipeline"),
   _next_cycle_seq(1)
@@ -33,6 +35,10 @@ Pipeline(const std::string &name, int num_stages) :
   _num_stages(1)
 #endif
 {
+  _num_cycle_threads = 1;
+  _cycle_time = 0.0;
+  _release_time = 0.0;
+
 #ifdef THREADED_PIPELINE
   // We maintain all of the cyclers in the world on one of two linked
   // lists.  Cyclers that are "clean", which is to say, they have the
@@ -55,6 +61,9 @@ Pipeline(const std::string &name, int num_stages) :
   // This flag is true only during the call to cycle().
   _cycling = false;
 
+  _cycle_prev_seq = 0;
+  _cycle_next_seq = 0;
+
 #else
   if (num_stages != 1) {
     pipeline_cat.warning()
@@ -72,6 +81,13 @@ Pipeline(const std::string &name, int num_stages) :
 Pipeline::
 ~Pipeline() {
 #ifdef THREADED_PIPELINE
+  _cycle_pool.stop_threads();
+  for (CyclePart *part : _cycle_parts) {
+    part->_list.clear_head();
+    delete part;
+  }
+  _cycle_parts.clear();
+
   nassertv(_num_cyclers == 0);
   nassertv(_num_dirty_cyclers == 0);
   _clean.clear_head();
@@ -91,10 +107,14 @@ cycle() {
       << "Beginning the pipeline cycle\n";
   }
 
-  pvector< PT(CycleData) > saved_cdatas;
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start_time = clock->get_short_time();
+
+  CycleDatas saved_cdatas;
   {
     ReMutexHolder cycle_holder(_cycle_lock);
     unsigned int prev_seq, next_seq;
+    int num_dirty;
     PipelineCyclerLinks prev_dirty;
     {
       // We can't hold the lock protecting the linked lists during the cycling
@@ -122,139 +142,33 @@ cycle() {
       prev_dirty.make_head();
       prev_dirty.take_list(_dirty);
 
-      saved_cdatas.reserve(_num_dirty_cyclers);
+      num_dirty = _num_dirty_cyclers;
       _num_dirty_cyclers = 0;
     }
 
-    // This is duplicated for different number of stages, as an optimization.
-    switch (_num_stages) {
-    case 2:
-      while (prev_dirty._next != &prev_dirty) {
-        PipelineCyclerLinks *link = prev_dirty._next;
-        while (link != &prev_dirty) {
-          PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
-
-          if (!cycler->_lock.try_lock()) {
-            // No big deal, just move on to the next one for now, and we'll
-            // come back around to it.  It's important not to block here in
-            // order to prevent one cycler from deadlocking another.
-            if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
-              link = cycler->_next;
-              continue;
-            } else {
-              // Well, we are the last cycler left, so we might as well wait.
-              // This is necessary to trigger the deadlock detection code.
-              cycler->_lock.lock();
-            }
-          }
-
-          MutexHolder holder(_lock);
-          cycler->remove_from_list();
-
-          // We save the result of cycle(), so that we can defer the side-
-          // effects that might occur when CycleDatas destruct, at least until
-          // the end of this loop.
-          saved_cdatas.push_back(cycler->cycle_2());
-
-          // cycle_2() won't leave a cycler dirty.  Add it to the clean list.
-          nassertd(!cycler->_dirty) break;
-          cycler->insert_before(&_clean);
-#ifdef DEBUG_THREADS
-          inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
-#endif
-          cycler->_lock.unlock();
-          break;
+    // If there are enough dirty cyclers, divide them among several threads.
+    int num_parts = std::min(_num_cycle_threads, num_dirty / min_cyclers_per_thread);
+    if (num_parts > 1) {
+      num_parts = cycle_parallel(prev_dirty, num_dirty, num_parts,
+                                 prev_seq, next_seq);
+
+      // Collect the saved CycleDatas from each part, so they can be released
+      // below.
+      saved_cdatas.reserve(num_dirty);
+      for (int i = 0; i < num_parts; ++i) {
+        CycleDatas &part_cdatas = _cycle_parts[i]->_saved_cdatas;
+        if (saved_cdatas.empty()) {
+          saved_cdatas.swap(part_cdatas);
+        } else {
+          saved_cdatas.insert(saved_cdatas.end(),
+                              std::make_move_iterator(part_cdatas.begin()),
+                              std::make_move_iterator(part_cdatas.end()));
+          part_cdatas.clear();
         }
       }
-      break;
-
-    case 3:
-      while (prev_dirty._next != &prev_dirty) {
-        PipelineCyclerLinks *link = prev_dirty._next;
-        while (link != &prev_dirty) {
-          PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
-
-          if (!cycler->_lock.try_lock()) {
-            // No big deal, just move on to the next one for now, and we'll
-            // come back around to it.  It's important not to block here in
-            // order to prevent one cycler from deadlocking another.
-            if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
-              link = cycler->_next;
-              continue;
-            } else {
-              // Well, we are the last cycler left, so we might as well wait.
-              // This is necessary to trigger the deadlock detection code.
-              cycler->_lock.lock();
-            }
-          }
-
-          MutexHolder holder(_lock);
-          cycler->remove_from_list();
-
-          saved_cdatas.push_back(cycler->cycle_3());
-
-          if (cycler->_dirty) {
-            // The cycler is still dirty.  Add it back to the dirty list.
-            nassertd(cycler->_dirty == prev_seq) break;
-            cycler->insert_before(&_dirty);
-            cycler->_dirty = next_seq;
-            ++_num_dirty_cyclers;
-          } else {
-            // The cycler is now clean.  Add it back to the clean list.
-            cycler->insert_before(&_clean);
-#ifdef DEBUG_THREADS
-            inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
-#endif
-          }
-          cycler->_lock.unlock();
-          break;
-        }
-      }
-      break;
-
-    default:
-      while (prev_dirty._next != &prev_dirty) {
-        PipelineCyclerLinks *link = prev_dirty._next;
-        while (link != &prev_dirty) {
-          PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
-
-          if (!cycler->_lock.try_lock()) {
-            // No big deal, just move on to the next one for now, and we'll
-            // come back around to it.  It's important not to block here in
-            // order to prevent one cycler from deadlocking another.
-            if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
-              link = cycler->_next;
-              continue;
-            } else {
-              // Well, we are the last cycler left, so we might as well wait.
-              // This is necessary to trigger the deadlock detection code.
-              cycler->_lock.lock();
-            }
-          }
-
-          MutexHolder holder(_lock);
-          cycler->remove_from_list();
-
-          saved_cdatas.push_back(cycler->cycle());
-
-          if (cycler->_dirty) {
-            // The cycler is still dirty.  Add it back to the dirty list.
-            nassertd(cycler->_dirty == prev_seq) break;
-            cycler->insert_before(&_dirty);
-            cycler->_dirty = next_seq;
-            ++_num_dirty_cyclers;
-          } else {
-            // The cycler is now clean.  Add it back to the clean list.
-            cycler->insert_before(&_clean);
-#ifdef DEBUG_THREADS
-            inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
-#endif
-          }
-          cycler->_lock.unlock();
-          break;
-        }
-      }
-      break;
+    } else {
+      saved_cdatas.reserve(num_dirty);
+      cycle_serial(prev_dirty, prev_seq, next_seq, saved_cdatas);
     }
 
     // Now we're ready for the next frame.
@@ -262,12 +176,17 @@ cycle() {
     _cycling = false;
   }
 
+  double release_start_time = clock->get_short_time();
+  _cycle_time = release_start_time - start_time;
+
   // And now it's safe to let the CycleData pointers in saved_cdatas destruct,
   // which may cause cascading deletes, and which will in turn cause
   // PipelineCyclers to remove themselves from (or add themselves to) the
   // _dirty list.
   saved_cdatas.clear();
 
+  _release_time = clock->get_short_time() - release_start_time;
+
   if (pipeline_cat.is_debug()) {
     pipeline_cat.debug()
       << "Finished the pipeline cycle\n";
@@ -276,6 +195,25 @@ cycle() {
 #endif  // THREADED_PIPELINE
 }
 
+/**
+ * Specifies the number of threads, including the thread calling cycle(), that
+ * may be used to cycle the dirty PipelineCyclers.  The default is taken from
+ * the pipeline-cycle-threads config variable.
+ *
+ * The threads are only used when there are at least a few thousand dirty
+ * cyclers per thread; smaller cycles are faster on a single thread.  This has
+ * no effect unless threaded pipelining is compiled in.
+ */
+void Pipeline::
+set_num_cycle_threads(int num_threads) {
+  nassertv(num_threads >= 1);
+#ifdef THREADED_PIPELINE
+  ReMutexHolder cycle_holder(_cycle_lock);
+  _cycle_pool.set_num_threads(num_threads);
+#endif  // THREADED_PIPELINE
+  _num_cycle_threads = num_threads;
+}
+
 /**
  * Specifies the number of stages required for the pipeline.
  */
@@ -536,8 +474,16 @@ make_render_pipeline() {
               "pipeline stages than your application requires will incur "
               "additional runtime overhead."));
 
+  ConfigVariableInt pipeline_cycle_threads
+    ("pipeline-cycle-threads", 1,
+     PRC_DESC("The number of threads that may be used to cycle the render "
+              "pipeline at the end of each frame, when many PipelineCyclers "
+              "(for instance, many moving nodes) are dirty.  This is only "
+              "meaningful if threaded pipelining is compiled into Panda."));
+
   nassertv(_render_pipeline == nullptr);
   _render_pipeline = new Pipeline("render", pipeline_stages);
+  _render_pipeline->set_num_cycle_threads(std::max((int)pipeline_cycle_threads, 1));
 }
 
 #if defined(THREADED_PIPELINE) && defined(DEBUG_THREADS)
@@ -559,3 +505,317 @@ inc_cycler_type(TypeCount &count, TypeHandle type, int addend) {
   nassertv((*ci).second >= 0);
 }
 #endif  // THREADED_PIPELINE && DEBUG_THREADS
+
+#ifdef THREADED_PIPELINE
+/**
+ * Cycles all of the cyclers on the indicated list on the current thread.
+ * This is called by cycle() with the cycle lock held.
+ */
+void Pipeline::
+cycle_serial(PipelineCyclerLinks &prev_dirty, unsigned int prev_seq,
+             unsigned int next_seq, CycleDatas &saved_cdatas) {
+  // This is duplicated for different number of stages, as an optimization.
+  switch (_num_stages) {
+  case 2:
+    while (prev_dirty._next != &prev_dirty) {
+      PipelineCyclerLinks *link = prev_dirty._next;
+      while (link != &prev_dirty) {
+        PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
+
+        if (!cycler->_lock.try_lock()) {
+          // No big deal, just move on to the next one for now, and we'll
+          // come back around to it.  It's important not to block here in
+          // order to prevent one cycler from deadlocking another.
+          if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
+            link = cycler->_next;
+            continue;
+          } else {
+            // Well, we are the last cycler left, so we might as well wait.
+            // This is necessary to trigger the deadlock detection code.
+            cycler->_lock.lock();
+          }
+        }
+
+        MutexHolder holder(_lock);
+        cycler->remove_from_list();
+
+        // We save the result of cycle(), so that we can defer the side-
+        // effects that might occur when CycleDatas destruct, at least until
+        // the end of this loop.
+        saved_cdatas.push_back(cycler->cycle_2());
+
+        // cycle_2() won't leave a cycler dirty.  Add it to the clean list.
+        nassertd(!cycler->_dirty) break;
+        cycler->insert_before(&_clean);
+#ifdef DEBUG_THREADS
+        inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
+#endif
+        cycler->_lock.unlock();
+        break;
+      }
+    }
+    break;
+
+  case 3:
+    while (prev_dirty._next != &prev_dirty) {
+      PipelineCyclerLinks *link = prev_dirty._next;
+      while (link != &prev_dirty) {
+        PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
+
+        if (!cycler->_lock.try_lock()) {
+          // No big deal, just move on to the next one for now, and we'll
+          // come back around to it.  It's important not to block here in
+          // order to prevent one cycler from deadlocking another.
+          if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
+            link = cycler->_next;
+            continue;
+          } else {
+            // Well, we are the last cycler left, so we might as well wait.
+            // This is necessary to trigger the deadlock detection code.
+            cycler->_lock.lock();
+          }
+        }
+
+        MutexHolder holder(_lock);
+        cycler->remove_from_list();
+
+        saved_cdatas.push_back(cycler->cycle_3());
+
+        if (cycler->_dirty) {
+          // The cycler is still dirty.  Add it back to the dirty list.
+          nassertd(cycler->_dirty == prev_seq) break;
+          cycler->insert_before(&_dirty);
+          cycler->_dirty = next_seq;
+          ++_num_dirty_cyclers;
+        } else {
+          // The cycler is now clean.  Add it back to the clean list.
+          cycler->insert_before(&_clean);
+#ifdef DEBUG_THREADS
+          inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
+#endif
+        }
+        cycler->_lock.unlock();
+        break;
+      }
+    }
+    break;
+
+  default:
+    while (prev_dirty._next != &prev_dirty) {
+      PipelineCyclerLinks *link = prev_dirty._next;
+      while (link != &prev_dirty) {
+        PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
+
+        if (!cycler->_lock.try_lock()) {
+          // No big deal, just move on to the next one for now, and we'll
+          // come back around to it.  It's important not to block here in
+          // order to prevent one cycler from deadlocking another.
+          if (link->_prev != &prev_dirty || link->_next != &prev_dirty) {
+            link = cycler->_next;
+            continue;
+          } else {
+            // Well, we are the last cycler left, so we might as well wait.
+            // This is necessary to trigger the deadlock detection code.
+            cycler->_lock.lock();
+          }
+        }
+
+        MutexHolder holder(_lock);
+        cycler->remove_from_list();
+
+        saved_cdatas.push_back(cycler->cycle());
+
+        if (cycler->_dirty) {
+          // The cycler is still dirty.  Add it back to the dirty list.
+          nassertd(cycler->_dirty == prev_seq) break;
+          cycler->insert_before(&_dirty);
+          cycler->_dirty = next_seq;
+          ++_num_dirty_cyclers;
+        } else {
+          // The cycler is now clean.  Add it back to the clean list.
+          cycler->insert_before(&_clean);
+#ifdef DEBUG_THREADS
+          inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
+#endif
+        }
+        cycler->_lock.unlock();
+        break;
+      }
+    }
+    break;
+  }
+}
+#endif  // THREADED_PIPELINE
+
+#ifdef THREADED_PIPELINE
+/**
+ * Cycles all of the cyclers on the indicated list, dividing them into
+ * num_parts parts that are cycled at the same time by the current thread and
+ * the cycle threads.  This is called by cycle() with the cycle lock held.
+ * Returns the number of parts actually used, which may be fewer if not enough
+ * threads could be started.
+ */
+int Pipeline::
+cycle_parallel(PipelineCyclerLinks &prev_dirty, int num_dirty, int num_parts,
+               unsigned int prev_seq, unsigned int next_seq) {
+  num_parts = _cycle_pool.start_threads(num_parts);
+
+  while ((int)_cycle_parts.size() < num_parts) {
+    CyclePart *part = new CyclePart;
+    part->_list.make_head();
+    _cycle_parts.push_back(part);
+  }
+
+  // Deal the dirty list out into parts of roughly equal size.  Nothing else
+  // touches the cyclers on prev_dirty until we're done with them, so we don't
+  // need to hold the lock.
+  for (int i = 0; i < num_parts; ++i) {
+    PipelineCyclerLinks &list = _cycle_parts[i]->_list;
+    int count = (num_dirty * (i + 1)) / num_parts - (num_dirty * i) / num_parts;
+    if (i == num_parts - 1) {
+      // The last part takes whatever is left.
+      list.take_list(prev_dirty);
+    } else {
+      while (count > 0 && prev_dirty._next != &prev_dirty) {
+        PipelineCyclerLinks *link = prev_dirty._next;
+        link->remove_from_list();
+        link->insert_before(&list);
+        --count;
+      }
+    }
+  }
+
+  // Each thread, including the current one, cycles the part with its own
+  // index.
+  _cycle_prev_seq = prev_seq;
+  _cycle_next_seq = next_seq;
+  _cycle_pool.run(num_parts, 1, &cycle_parts_func, this);
+  return num_parts;
+}
+#endif  // THREADED_PIPELINE
+
+#ifdef THREADED_PIPELINE
+/**
+ * Cycles all of the cyclers in the indicated part of the dirty list.  This may
+ * be called on several threads at once, for different parts.
+ *
+ * Each cycler stays locked after it is cycled until a batch of them has been
+ * collected, and then the whole batch is moved back to the clean or dirty
+ * list at once, so that the threads don't contend so much for the lock on
+ * those lists.
+ */
+void Pipeline::
+cycle_part(CyclePart &part, unsigned int prev_seq, unsigned int next_seq) {
+  PipelineCyclerLinks &list = part._list;
+  CycleDatas &saved_cdatas = part._saved_cdatas;
+
+  PipelineCyclerTrueImpl *batch[cycle_batch_size];
+  size_t num_batch = 0;
+
+  while (list._next != &list) {
+    PipelineCyclerLinks *link = list._next;
+    while (link != &list) {
+      PipelineCyclerTrueImpl *cycler = (PipelineCyclerTrueImpl *)link;
+
+      if (!cycler->_lock.try_lock()) {
+        // As in cycle(), move on and come back to it later.  We never block
+        // while we are holding the cyclers in the batch, though, since
+        // another thread might be waiting for one of those.
+        if (link->_prev != &list || link->_next != &list) {
+          link = cycler->_next;
+          continue;
+        } else {
+          release_batch(batch, num_batch, prev_seq, next_seq);
+          num_batch = 0;
+          cycler->_lock.lock();
+        }
+      }
+
+      cycler->remove_from_list();
+
+      switch (_num_stages) {
+      case 2:
+        saved_cdatas.push_back(cycler->cycle_2());
+        break;
+
+      case 3:
+        saved_cdatas.push_back(cycler->cycle_3());
+        break;
+
+      default:
+        saved_cdatas.push_back(cycler->cycle());
+        break;
+      }
+
+      batch[num_batch++] = cycler;
+      if (num_batch == cycle_batch_size) {
+        release_batch(batch, num_batch, prev_seq, next_seq);
+        num_batch = 0;
+      }
+      break;
+    }
+
+    if (link == &list && num_batch != 0) {
+      // All of the remaining cyclers are locked by other threads.  Let go of
+      // ours before we try again.
+      release_batch(batch, num_batch, prev_seq, next_seq);
+      num_batch = 0;
+    }
+  }
+
+  release_batch(batch, num_batch, prev_seq, next_seq);
+}
+#endif  // THREADED_PIPELINE
+
+#ifdef THREADED_PIPELINE
+/**
+ * The function run by the cycle pool for each range of parts of the dirty
+ * list.
+ */
+void Pipeline::
+cycle_parts_func(void *data, int thread_index, size_t begin, size_t end) {
+  Pipeline *pipeline = (Pipeline *)data;
+  for (size_t i = begin; i < end; ++i) {
+    pipeline->cycle_part(*pipeline->_cycle_parts[i],
+                         pipeline->_cycle_prev_seq, pipeline->_cycle_next_seq);
+  }
+}
+#endif  // THREADED_PIPELINE
+
+#ifdef THREADED_PIPELINE
+/**
+ * Moves the indicated cyclers, which have just been cycled, back to the clean
+ * or dirty list as appropriate, and unlocks them.
+ */
+void Pipeline::
+release_batch(PipelineCyclerTrueImpl **batch, size_t num_batch,
+              unsigned int prev_seq, unsigned int next_seq) {
+  if (num_batch == 0) {
+    return;
+  }
+
+  {
+    MutexHolder holder(_lock);
+    for (size_t i = 0; i < num_batch; ++i) {
+      PipelineCyclerTrueImpl *cycler = batch[i];
+      if (cycler->_dirty) {
+        // The cycler is still dirty.  Add it back to the dirty list.
+        nassertd(cycler->_dirty == prev_seq) continue;
+        cycler->insert_before(&_dirty);
+        cycler->_dirty = next_seq;
+        ++_num_dirty_cyclers;
+      } else {
+        // The cycler is now clean.  Add it back to the clean list.
+        cycler->insert_before(&_clean);
+#ifdef DEBUG_THREADS
+        inc_cycler_type(_dirty_cycler_types, cycler->get_parent_type(), -1);
+#endif
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_batch; ++i) {
+    batch[i]->_lock.unlock();
+  }
+}
+#endif  // THREADED_PIPELINE
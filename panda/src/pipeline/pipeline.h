@@ -22,6 +22,9 @@
 #include "mutexHolder.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "workerThreadPool.h"
+#include "cycleData.h"
+#include "pvector.h"
 #include "selectThreadImpl.h"  // for THREADED_PIPELINE definition
 
 struct PipelineCyclerTrueImpl;
@@ -48,6 +51,12 @@ public:
   INLINE void set_min_stages(int min_stages);
   INLINE int get_num_stages() const;
 
+  void set_num_cycle_threads(int num_threads);
+  INLINE int get_num_cycle_threads() const;
+
+  INLINE double get_cycle_time() const;
+  INLINE double get_release_time() const;
+
 #ifdef THREADED_PIPELINE
   void add_cycler(PipelineCyclerTrueImpl *cycler);
   void add_cycler(PipelineCyclerTrueImpl *cycler, bool dirty);
@@ -67,6 +76,12 @@ public:
 
 private:
   int _num_stages;
+  int _num_cycle_threads;
+
+  // The time taken by the last cycle() to cycle the dirty cyclers, and to
+  // release the old CycleData pointers afterwards.
+  double _cycle_time;
+  double _release_time;
 
   static void make_render_pipeline();
   static Pipeline *_render_pipeline;
@@ -78,6 +93,41 @@ private:
   int _num_cyclers;
   int _num_dirty_cyclers;
 
+  typedef pvector<PT(CycleData) > CycleDatas;
+
+  // Each part of the dirty list is cycled separately, possibly by different
+  // threads.
+  class CyclePart {
+  public:
+    PipelineCyclerLinks _list;
+    CycleDatas _saved_cdatas;
+  };
+
+  void cycle_serial(PipelineCyclerLinks &prev_dirty, unsigned int prev_seq,
+                    unsigned int next_seq, CycleDatas &saved_cdatas);
+  int cycle_parallel(PipelineCyclerLinks &prev_dirty, int num_dirty,
+                     int num_parts, unsigned int prev_seq,
+                     unsigned int next_seq);
+  void cycle_part(CyclePart &part, unsigned int prev_seq,
+                  unsigned int next_seq);
+  static void cycle_parts_func(void *data, int thread_index,
+                               size_t begin, size_t end);
+  void release_batch(PipelineCyclerTrueImpl **batch, size_t num_batch,
+                     unsigned int prev_seq, unsigned int next_seq);
+
+  // The minimum number of dirty cyclers worth handing to each thread, and the
+  // number of cyclers a thread locks at once before it moves them back to the
+  // clean or dirty list.
+  static const int min_cyclers_per_thread = 2048;
+  static const size_t cycle_batch_size = 64;
+
+  // Each thread of _cycle_pool cycles the part of the dirty list with its own
+  // index, using the sequence numbers of the current cycle.
+  pvector<CyclePart *> _cycle_parts;
+  WorkerThreadPool _cycle_pool;
+  unsigned int _cycle_prev_seq;
+  unsigned int _cycle_next_seq;
+
 #ifdef DEBUG_THREADS
   typedef pmap<TypeHandle, int> TypeCount;
   TypeCount _all_cycler_types, _dirty_cycler_types;
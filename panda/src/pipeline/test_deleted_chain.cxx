@@ -0,0 +1,158 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_deleted_chain.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "thread.h"
+#include "deletedChain.h"
+#include "trueClock.h"
+
+// The number of objects each thread allocates before freeing them again.
+static const int objects_per_round = 200;
+
+/**
+ * Objects of a few different sizes, as a cull traversal might make.
+ */
+template<int Size>
+class Blob {
+public:
+  Blob(int value) { _data[0] = (char)value; }
+  ALLOC_DELETED_CHAIN(Blob<Size>);
+
+  char _data[Size];
+
+public:
+  static TypeHandle get_class_type() {
+    return TypeHandle::none();
+  }
+};
+
+typedef Blob<24> SmallBlob;
+typedef Blob<72> MediumBlob;
+typedef Blob<200> LargeBlob;
+
+/**
+ * Each thread allocates and frees objects of all three sizes in rounds.
+ */
+class AllocThread : public Thread {
+public:
+  AllocThread(int num_rounds) :
+    Thread("alloc", "alloc"),
+    _num_rounds(num_rounds),
+    _checksum(0)
+  {
+  }
+
+  virtual void thread_main() {
+    pvector<SmallBlob *> small(objects_per_round);
+    pvector<MediumBlob *> medium(objects_per_round);
+    pvector<LargeBlob *> large(objects_per_round);
+
+    for (int r = 0; r < _num_rounds; ++r) {
+      for (int i = 0; i < objects_per_round; ++i) {
+        small[i] = new SmallBlob(i);
+        medium[i] = new MediumBlob(i);
+        large[i] = new LargeBlob(i);
+      }
+      for (int i = 0; i < objects_per_round; ++i) {
+        _checksum += small[i]->_data[0] + medium[i]->_data[0] + large[i]->_data[0];
+        delete small[i];
+        delete medium[i];
+        delete large[i];
+      }
+    }
+    DeletedBufferChain::flush_thread_cache();
+  }
+
+  int _num_rounds;
+  size_t _checksum;
+};
+
+/**
+ * Runs the indicated number of threads at once, and returns the time taken.
+ */
+static double
+run_threads(int num_threads, int num_rounds, size_t &checksum) {
+  pvector<PT(AllocThread) > threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new AllocThread(num_rounds));
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int i = 0; i < num_threads; ++i) {
+    threads[i]->start(TP_normal, true);
+  }
+  checksum = 0;
+  for (int i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+    checksum += threads[i]->_checksum;
+  }
+  return clock->get_short_time() - start;
+}
+
+/**
+ * Returns the total number of times the shared chains were locked.
+ */
+static size_t
+count_locks() {
+  size_t locks = 0;
+  size_t num_chains = DeletedBufferChain::get_num_chains();
+  for (size_t i = 0; i < num_chains; ++i) {
+    DeletedBufferChain *chain = DeletedBufferChain::get_chain(i);
+    locks += chain->get_num_refills() + chain->get_num_flushes();
+  }
+  return locks;
+}
+
+/**
+ * Times allocating and freeing objects from several threads at once, with
+ * and without the per-thread caches in front of the DeletedBufferChains.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_threads = 4;
+  int num_rounds = 5000;
+
+  if (argc > 1) {
+    num_threads = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_rounds = atoi(argv[2]);
+  }
+  if (argc > 3 || num_threads <= 0 || num_rounds <= 0) {
+    nout << "test_deleted_chain [num_threads [num_rounds]]\n";
+    exit(1);
+  }
+
+  size_t shared_checksum, cached_checksum;
+
+  DeletedBufferChain::set_thread_cache(false);
+  size_t start_locks = count_locks();
+  double shared_time = run_threads(num_threads, num_rounds, shared_checksum);
+  size_t shared_locks = count_locks() - start_locks;
+
+  DeletedBufferChain::set_thread_cache(true);
+  start_locks = count_locks();
+  double cached_time = run_threads(num_threads, num_rounds, cached_checksum);
+  size_t cached_locks = count_locks() - start_locks;
+
+  size_t num_objects = (size_t)num_threads * num_rounds * objects_per_round * 3;
+  nout << num_threads << " threads, " << num_objects << " objects:\n"
+       << "  shared chain only: " << shared_time << " s, "
+       << shared_locks << " locks\n"
+       << "  with thread caches: " << cached_time << " s, "
+       << cached_locks << " locks\n";
+
+  Thread::prepare_for_exit();
+  return (shared_checksum == cached_checksum) ? 0 : 1;
+}
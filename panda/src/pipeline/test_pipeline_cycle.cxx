@@ -0,0 +1,153 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_pipeline_cycle.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "pipeline.h"
+#include "pipelineCycler.h"
+#include "cycleData.h"
+#include "cycleDataReader.h"
+#include "cycleDataWriter.h"
+#include "cycleDataStageReader.h"
+#include "trueClock.h"
+
+/**
+ * An object with some pipelined data, standing in for a node that moves every
+ * frame.
+ */
+class Mover {
+public:
+  class CData : public CycleData {
+  public:
+    CData() : _value(0) {}
+    CData(const CData &copy) : _value(copy._value) {}
+    virtual CycleData *make_copy() const { return new CData(*this); }
+
+    int _value;
+    float _matrix[16];
+  };
+
+  PipelineCycler<CData> _cycler;
+  typedef CycleDataWriter<CData> CDWriter;
+  typedef CycleDataStageReader<CData> CDStageReader;
+};
+
+/**
+ * Makes num_objects objects, and writes to most of them and cycles the
+ * pipeline on every frame, using the indicated number of cycle threads.
+ * Returns the time spent in Pipeline::cycle(), and counts the objects whose
+ * data did not come out as expected in each stage.
+ */
+static double
+run_frames(int num_objects, int num_frames, int num_threads,
+           int &num_different) {
+  Pipeline *pipeline = Pipeline::get_render_pipeline();
+  pipeline->set_num_cycle_threads(num_threads);
+  int num_stages = pipeline->get_num_stages();
+  Thread *current_thread = Thread::get_current_thread();
+
+  pvector<Mover *> objects;
+  for (int i = 0; i < num_objects; ++i) {
+    objects.push_back(new Mover);
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double cycle_time = 0.0;
+  for (int f = 1; f <= num_frames; ++f) {
+    // Every tenth object stands still on odd frames.
+    for (int i = 0; i < num_objects; ++i) {
+      if (i % 10 != 0 || f % 2 == 0) {
+        Mover::CDWriter cdata(objects[i]->_cycler, current_thread);
+        cdata->_value = f * num_objects + i;
+      }
+    }
+
+    double start = clock->get_short_time();
+    pipeline->cycle();
+    cycle_time += clock->get_short_time() - start;
+  }
+
+  // Stage 1 should now hold what was written on the last frame, and each
+  // further stage what was written one frame before that.
+  num_different = 0;
+  for (int i = 0; i < num_objects; ++i) {
+    for (int stage = 0; stage < num_stages; ++stage) {
+      int f = num_frames - std::max(stage - 1, 0);
+      if (i % 10 == 0 && f % 2 != 0) {
+        --f;
+      }
+      Mover::CDStageReader cdata(objects[i]->_cycler, stage, current_thread);
+      if (cdata->_value != f * num_objects + i) {
+        ++num_different;
+        break;
+      }
+    }
+  }
+
+  for (Mover *object : objects) {
+    delete object;
+  }
+
+  // Let the deleted objects drain out of the pipeline.
+  for (int stage = 0; stage < num_stages; ++stage) {
+    pipeline->cycle();
+  }
+  return cycle_time;
+}
+
+/**
+ * Times Pipeline::cycle() with many dirty PipelineCyclers on one thread and
+ * on the indicated number of threads, and checks that every stage holds the
+ * expected data afterwards.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_objects = 100000;
+  int num_frames = 100;
+  int num_threads = 4;
+  int num_stages = 3;
+
+  if (argc > 1) {
+    num_objects = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_frames = atoi(argv[2]);
+  }
+  if (argc > 3) {
+    num_threads = atoi(argv[3]);
+  }
+  if (argc > 4) {
+    num_stages = atoi(argv[4]);
+  }
+  if (argc > 5 || num_objects <= 0 || num_frames < num_stages ||
+      num_threads <= 0 || num_stages < 2) {
+    nout << "test_pipeline_cycle [num_objects [num_frames [num_threads [num_stages]]]]\n";
+    exit(1);
+  }
+
+  Pipeline::get_render_pipeline()->set_num_stages(num_stages);
+
+  int serial_different, parallel_different;
+  double serial_time = run_frames(num_objects, num_frames, 1,
+                                  serial_different);
+  double parallel_time = run_frames(num_objects, num_frames, num_threads,
+                                    parallel_different);
+
+  nout << num_objects << " objects, " << num_stages << " stages, "
+       << num_frames << " frames: " << serial_time << " s cycling with 1 thread ("
+       << serial_different << " wrong), " << parallel_time << " s with "
+       << num_threads << " threads (" << parallel_different << " wrong).\n";
+
+  Pipeline::get_render_pipeline()->set_num_cycle_threads(1);
+  Thread::prepare_for_exit();
+  return (serial_different == 0 && parallel_different == 0) ? 0 : 1;
+}
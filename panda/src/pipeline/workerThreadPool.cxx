@@ -0,0 +1,211 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file workerThreadPool.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "workerThreadPool.h"
+#include "mutexHolder.h"
+
+/**
+ * The name is used for the worker threads and the lock.  The pool starts out
+ * with just the calling thread; see set_num_threads().
+ */
+WorkerThreadPool::
+WorkerThreadPool(const std::string &name) :
+  _name(name),
+  _num_threads(1),
+  _lock(name),
+  _cv(_lock),
+  _generation(0),
+  _func(nullptr),
+  _data(nullptr),
+  _num_items(0),
+  _num_parts(1),
+  _num_pending(0),
+  _shutdown(false)
+{
+}
+
+/**
+ *
+ */
+WorkerThreadPool::
+~WorkerThreadPool() {
+  stop_threads();
+}
+
+/**
+ * Specifies the number of threads, including the calling thread, that run()
+ * may use.  Any worker threads beyond that number are stopped.
+ */
+void WorkerThreadPool::
+set_num_threads(int num_threads) {
+  nassertv(num_threads >= 1);
+  if (num_threads < (int)_threads.size() + 1) {
+    stop_threads();
+  }
+  _num_threads = num_threads;
+}
+
+/**
+ * Makes sure that enough worker threads are running to divide a job into
+ * num_threads parts, limited by get_num_threads().  Returns the number of
+ * threads, including the calling thread, that are now available; this may be
+ * fewer if threads could not be started, or if true threads are not
+ * available.
+ */
+int WorkerThreadPool::
+start_threads(int num_threads) {
+  if (!Thread::is_true_threads()) {
+    return 1;
+  }
+  num_threads = std::min(num_threads, _num_threads);
+
+  while ((int)_threads.size() < num_threads - 1) {
+    // No work is handed out while we are starting threads, so the thread
+    // should wait for the generation after this one.
+    PT(WorkerThread) thread =
+      new WorkerThread(this, (int)_threads.size() + 1, _generation);
+    if (!thread->start(TP_normal, true)) {
+      break;
+    }
+    _threads.push_back(thread);
+  }
+  return std::min(num_threads, (int)_threads.size() + 1);
+}
+
+/**
+ * Stops and waits for the worker threads.  They will be started again by the
+ * next call to run() that needs them.
+ */
+void WorkerThreadPool::
+stop_threads() {
+  if (_threads.empty()) {
+    return;
+  }
+
+  {
+    MutexHolder holder(_lock);
+    _shutdown = true;
+    _cv.notify_all();
+  }
+
+  for (WorkerThread *thread : _threads) {
+    thread->join();
+  }
+  _threads.clear();
+  _shutdown = false;
+}
+
+/**
+ * Calls func(data, thread_index, begin, end) for contiguous ranges that
+ * together cover [0, num_items), possibly on several threads at once, and
+ * returns when all of them have finished.  Each thread is given at least
+ * min_items_per_thread items; smaller jobs are done entirely on the calling
+ * thread, with a thread_index of 0.
+ *
+ * Returns the number of parts the items were divided into.  Part i, which
+ * covers items [num_items * i / n, num_items * (i + 1) / n), is always given
+ * to thread i.
+ */
+int WorkerThreadPool::
+run(size_t num_items, size_t min_items_per_thread,
+    RangeFunc *func, void *data) {
+  size_t max_parts = num_items / std::max(min_items_per_thread, (size_t)1);
+  int num_parts = (int)std::min((size_t)_num_threads, max_parts);
+  if (num_parts > 1) {
+    num_parts = start_threads(num_parts);
+  }
+  if (num_parts <= 1) {
+    (*func)(data, 0, 0, num_items);
+    return 1;
+  }
+
+  {
+    MutexHolder holder(_lock);
+    _func = func;
+    _data = data;
+    _num_items = num_items;
+    _num_parts = num_parts;
+    _num_pending = num_parts - 1;
+    ++_generation;
+    _cv.notify_all();
+  }
+
+  // The calling thread takes the first part.
+  (*func)(data, 0, 0, num_items / num_parts);
+
+  MutexHolder holder(_lock);
+  while (_num_pending > 0) {
+    _cv.wait();
+  }
+  _func = nullptr;
+  _data = nullptr;
+  return num_parts;
+}
+
+/**
+ * The main loop of each worker thread.  generation is the value of
+ * _generation when the thread was started.
+ */
+void WorkerThreadPool::
+worker_run(int thread_index, int generation) {
+  _lock.acquire();
+
+  while (true) {
+    while (_generation == generation && !_shutdown) {
+      _cv.wait();
+    }
+    if (_shutdown) {
+      break;
+    }
+    generation = _generation;
+
+    // Threads beyond the number of parts sit this one out.
+    int num_parts = _num_parts;
+    if (thread_index < num_parts) {
+      RangeFunc *func = _func;
+      void *data = _data;
+      size_t begin = (_num_items * thread_index) / num_parts;
+      size_t end = (_num_items * (thread_index + 1)) / num_parts;
+
+      _lock.release();
+      (*func)(data, thread_index, begin, end);
+      _lock.acquire();
+
+      if (--_num_pending == 0) {
+        _cv.notify_all();
+      }
+    }
+  }
+
+  _lock.release();
+}
+
+/**
+ *
+ */
+WorkerThreadPool::WorkerThread::
+WorkerThread(WorkerThreadPool *pool, int thread_index, int generation) :
+  Thread(pool->_name, pool->_name),
+  _pool(pool),
+  _thread_index(thread_index),
+  _generation(generation)
+{
+}
+
+/**
+ *
+ */
+void WorkerThreadPool::WorkerThread::
+thread_main() {
+  _pool->worker_run(_thread_index, _generation);
+}
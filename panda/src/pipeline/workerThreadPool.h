@@ -0,0 +1,89 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file workerThreadPool.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef WORKERTHREADPOOL_H
+#define WORKERTHREADPOOL_H
+
+#include "pandabase.h"
+#include "thread.h"
+#include "pmutex.h"
+#include "conditionVarFull.h"
+#include "pvector.h"
+
+/**
+ * A set of persistent worker threads, used to divide a loop over a range of
+ * items among several threads.  This is meant for work that is done every
+ * frame, which is too short to be worth starting new threads each time.
+ *
+ * The thread calling run() always does a share of the work itself, as thread
+ * 0; the worker threads are numbered from 1.  They are started the first time
+ * they are needed, and stopped by stop_threads(), set_num_threads() or the
+ * destructor.
+ *
+ * The pool itself is not thread-safe: only one thread at a time may call its
+ * methods.
+ */
+class EXPCL_PANDA_PIPELINE WorkerThreadPool {
+public:
+  typedef void RangeFunc(void *data, int thread_index,
+                         size_t begin, size_t end);
+
+  explicit WorkerThreadPool(const std::string &name);
+  ~WorkerThreadPool();
+
+  void set_num_threads(int num_threads);
+  INLINE int get_num_threads() const;
+
+  int start_threads(int num_threads);
+  void stop_threads();
+
+  int run(size_t num_items, size_t min_items_per_thread,
+          RangeFunc *func, void *data);
+
+private:
+  void worker_run(int thread_index, int generation);
+
+  class WorkerThread : public Thread {
+  public:
+    WorkerThread(WorkerThreadPool *pool, int thread_index, int generation);
+    virtual void thread_main();
+
+    WorkerThreadPool *_pool;
+    int _thread_index;
+    int _generation;
+  };
+  typedef pvector<PT(WorkerThread) > Threads;
+
+  std::string _name;
+  int _num_threads;
+  Threads _threads;
+
+  // The worker threads wait on _cv for _generation to change, then each
+  // calls _func on its share (one of _num_parts) of the _num_items items, and
+  // the last one to finish wakes up the thread calling run().
+  Mutex _lock;
+  ConditionVarFull _cv;
+  int _generation;
+  RangeFunc *_func;
+  void *_data;
+  size_t _num_items;
+  int _num_parts;
+  int _num_pending;
+  bool _shutdown;
+
+  friend class WorkerThread;
+};
+
+#include "workerThreadPool.I"
+
+#endif
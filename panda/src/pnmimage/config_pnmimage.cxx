@@ -62,6 +62,26 @@ ConfigVariableDouble pfm_resize_radius
           "always call box_filter() or gaussian_filter() explicitly with "
           "a specific radius."));
 
+ConfigVariableInt pnm_filter_threads
+("pnm-filter-threads", 0,
+ PRC_DESC("The number of threads used by the PNMImage and PfmFile filter "
+          "operations, such as box_filter(), gaussian_filter(), "
+          "quick_filter(), xform() and the distort methods, when they are "
+          "applied to a large image.  Set this to 0 to use one thread per "
+          "CPU, or 1 to do all of the work on the calling thread.  The "
+          "results do not depend on this setting."));
+
+ConfigVariableInt pfm_tile_size
+("pfm-tile-size", 256,
+ PRC_DESC("The default width and height, in points, of the square tiles "
+          "used by a newly-created PfmTiledFile."));
+
+ConfigVariableInt64 pfm_tile_cache_size
+("pfm-tile-cache-size", 256 * 1024 * 1024,
+ PRC_DESC("The default number of bytes of tile data that each PfmTiledFile "
+          "will keep mapped into memory at once.  When this is exceeded, the "
+          "least-recently-used tiles are unmapped."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -18,6 +18,8 @@
 #include "notifyCategoryProxy.h"
 #include "configVariableBool.h"
 #include "configVariableDouble.h"
+#include "configVariableInt.h"
+#include "configVariableInt64.h"
 
 NotifyCategoryDecl(pnmimage, EXPCL_PANDA_PNMIMAGE, EXPTP_PANDA_PNMIMAGE);
 
@@ -26,6 +28,9 @@ extern EXPCL_PANDA_PNMIMAGE ConfigVariableBool pfm_reverse_dimensions;
 extern EXPCL_PANDA_PNMIMAGE ConfigVariableBool pfm_resize_gaussian;
 extern EXPCL_PANDA_PNMIMAGE ConfigVariableBool pfm_resize_quick;
 extern EXPCL_PANDA_PNMIMAGE ConfigVariableDouble pfm_resize_radius;
+extern EXPCL_PANDA_PNMIMAGE ConfigVariableInt pnm_filter_threads;
+extern EXPCL_PANDA_PNMIMAGE ConfigVariableInt pfm_tile_size;
+extern EXPCL_PANDA_PNMIMAGE ConfigVariableInt64 pfm_tile_cache_size;
 
 extern EXPCL_PANDA_PNMIMAGE void init_libpnmimage();
 
@@ -1,6 +1,7 @@
 #include "config_pnmimage.cxx"
 #include "convert_srgb.cxx"
 #include "pfmFile.cxx"
+#include "pfmTiledFile.cxx"
 #include "pnm-image-filter.cxx"
 #include "pnmbitio.cxx"
 #include "pnmBrush.cxx"
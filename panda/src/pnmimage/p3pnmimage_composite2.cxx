@@ -1,6 +1,7 @@
 #include "pnmImage.cxx"
 #include "pnmImageHeader.cxx"
 #include "pnmPainter.cxx"
+#include "pnmParallelRows.cxx"
 #include "pnmReader.cxx"
 #include "pnmWriter.cxx"
 #include "pnmFileTypeRegistry.cxx"
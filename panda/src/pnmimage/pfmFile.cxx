@@ -23,6 +23,8 @@
 #include "pnmWriter.h"
 #include "string_utils.h"
 #include "look_at.h"
+#include "pnmParallelRows.h"
+#include "thread.h"
 
 using std::istream;
 using std::max;
@@ -1000,143 +1002,108 @@ quick_filter_from(const PfmFile &from) {
     return;
   }
 
-  Table new_data;
-  new_data.reserve(_table.size());
+  nassertv(_num_channels >= 1 && _num_channels <= 4);
 
-  PN_float32 from_x0, from_x1, from_y0, from_y1;
-
-  int orig_x_size = from.get_x_size();
-  int orig_y_size = from.get_y_size();
+  Table new_data(_table.size(), (PN_float32)0.0);
 
-  PN_float32 x_scale = 1.0;
-  PN_float32 y_scale = 1.0;
+  QuickFilterRows rows;
+  rows._new_data = &new_data[0];
+  rows._from = &from;
+  rows._x_size = _x_size;
+  rows._num_channels = _num_channels;
+  rows._x_scale = 1.0;
+  rows._y_scale = 1.0;
 
   if (_x_size > 1) {
-    x_scale = (PN_float32)orig_x_size / (PN_float32)_x_size;
+    rows._x_scale = (PN_float32)from.get_x_size() / (PN_float32)_x_size;
   }
   if (_y_size > 1) {
-    y_scale = (PN_float32)orig_y_size / (PN_float32)_y_size;
+    rows._y_scale = (PN_float32)from.get_y_size() / (PN_float32)_y_size;
   }
 
-  switch (_num_channels) {
-  case 1:
-    {
-      from_y0 = 0.0;
-      for (int to_y = 0; to_y < _y_size; ++to_y) {
-        from_y1 = (to_y + 1.0) * y_scale;
-        from_y1 = min(from_y1, (PN_float32)orig_y_size);
-
-        from_x0 = 0.0;
-        for (int to_x = 0; to_x < _x_size; ++to_x) {
-          from_x1 = (to_x + 1.0) * x_scale;
-          from_x1 = min(from_x1, (PN_float32)orig_x_size);
-
-          // Now the box from (from_x0, from_y0) - (from_x1, from_y1) but not
-          // including (from_x1, from_y1) maps to the pixel (to_x, to_y).
+  size_t work_per_row = (size_t)(_x_size * (rows._x_scale + 1.0f) * (rows._y_scale + 1.0f));
+  PNMParallelRows::run(_y_size, work_per_row, &quick_filter_rows, &rows);
+
+  nassertv(new_data.size() == _table.size());
+  _table.swap(new_data);
+}
+
+/**
+ * Fills in rows [begin, end) of the table being built by quick_filter_from().
+ * This may be called on several threads at once for different rows.
+ */
+void PfmFile::
+quick_filter_rows(void *data, int begin, int end) {
+  const QuickFilterRows &rows = *(const QuickFilterRows *)data;
+  const PfmFile &from = *rows._from;
+
+  PN_float32 from_x0, from_x1, from_y0, from_y1;
+
+  int orig_x_size = from.get_x_size();
+  int orig_y_size = from.get_y_size();
+  int x_size = rows._x_size;
+  PN_float32 x_scale = rows._x_scale;
+  PN_float32 y_scale = rows._y_scale;
+
+  PN_float32 *p = rows._new_data + (size_t)begin * x_size * rows._num_channels;
+
+  for (int to_y = begin; to_y < end; ++to_y) {
+    from_y0 = (to_y + 0.0) * y_scale;
+    from_y0 = min(from_y0, (PN_float32)orig_y_size);
+    from_y1 = (to_y + 1.0) * y_scale;
+    from_y1 = min(from_y1, (PN_float32)orig_y_size);
+
+    from_x0 = 0.0;
+    for (int to_x = 0; to_x < x_size; ++to_x) {
+      from_x1 = (to_x + 1.0) * x_scale;
+      from_x1 = min(from_x1, (PN_float32)orig_x_size);
+
+      // Now the box from (from_x0, from_y0) - (from_x1, from_y1) but not
+      // including (from_x1, from_y1) maps to the pixel (to_x, to_y).
+      switch (rows._num_channels) {
+      case 1:
+        {
           PN_float32 result;
           from.box_filter_region(result, from_x0, from_y0, from_x1, from_y1);
-          new_data.push_back(result);
-
-          from_x0 = from_x1;
+          *p++ = result;
         }
-        from_y0 = from_y1;
-      }
-    }
-    break;
+        break;
 
-  case 2:
-    {
-      from_y0 = 0.0;
-      for (int to_y = 0; to_y < _y_size; ++to_y) {
-        from_y1 = (to_y + 1.0) * y_scale;
-        from_y1 = min(from_y1, (PN_float32)orig_y_size);
-
-        from_x0 = 0.0;
-        for (int to_x = 0; to_x < _x_size; ++to_x) {
-          from_x1 = (to_x + 1.0) * x_scale;
-          from_x1 = min(from_x1, (PN_float32)orig_x_size);
-
-          // Now the box from (from_x0, from_y0) - (from_x1, from_y1) but not
-          // including (from_x1, from_y1) maps to the pixel (to_x, to_y).
+      case 2:
+        {
           LPoint2f result;
           from.box_filter_region(result, from_x0, from_y0, from_x1, from_y1);
-          new_data.push_back(result[0]);
-          new_data.push_back(result[1]);
-
-          from_x0 = from_x1;
+          *p++ = result[0];
+          *p++ = result[1];
         }
-        from_y0 = from_y1;
-      }
-    }
-    break;
+        break;
 
-  case 3:
-    {
-      from_y0 = 0.0;
-      for (int to_y = 0; to_y < _y_size; ++to_y) {
-        from_y1 = (to_y + 1.0) * y_scale;
-        from_y1 = min(from_y1, (PN_float32)orig_y_size);
-
-        from_x0 = 0.0;
-        for (int to_x = 0; to_x < _x_size; ++to_x) {
-          from_x1 = (to_x + 1.0) * x_scale;
-          from_x1 = min(from_x1, (PN_float32)orig_x_size);
-
-          // Now the box from (from_x0, from_y0) - (from_x1, from_y1) but not
-          // including (from_x1, from_y1) maps to the pixel (to_x, to_y).
+      case 3:
+        {
           LPoint3f result;
           from.box_filter_region(result, from_x0, from_y0, from_x1, from_y1);
-          new_data.push_back(result[0]);
-          new_data.push_back(result[1]);
-          new_data.push_back(result[2]);
-
-          from_x0 = from_x1;
+          *p++ = result[0];
+          *p++ = result[1];
+          *p++ = result[2];
         }
-        from_y0 = from_y1;
-      }
-    }
-    break;
+        break;
 
-  case 4:
-    {
-      from_y0 = 0.0;
-      for (int to_y = 0; to_y < _y_size; ++to_y) {
-        from_y1 = (to_y + 1.0) * y_scale;
-        from_y1 = min(from_y1, (PN_float32)orig_y_size);
-
-        from_x0 = 0.0;
-        for (int to_x = 0; to_x < _x_size; ++to_x) {
-          from_x1 = (to_x + 1.0) * x_scale;
-          from_x1 = min(from_x1, (PN_float32)orig_x_size);
-
-          // Now the box from (from_x0, from_y0) - (from_x1, from_y1) but not
-          // including (from_x1, from_y1) maps to the pixel (to_x, to_y).
+      case 4:
+        {
           LPoint4f result;
           from.box_filter_region(result, from_x0, from_y0, from_x1, from_y1);
-          new_data.push_back(result[0]);
-          new_data.push_back(result[1]);
-          new_data.push_back(result[2]);
-          new_data.push_back(result[3]);
-
-          from_x0 = from_x1;
+          *p++ = result[0];
+          *p++ = result[1];
+          *p++ = result[2];
+          *p++ = result[3];
         }
-        from_y0 = from_y1;
+        break;
       }
-    }
-    break;
 
-  default:
-    nassert_raise("unexpected channel count");
-    return;
+      from_x0 = from_x1;
+    }
+    Thread::consider_yield();
   }
-
-  new_data.push_back(0.0);
-  new_data.push_back(0.0);
-  new_data.push_back(0.0);
-  new_data.push_back(0.0);
-
-  nassertv(new_data.size() == _table.size());
-  _table.swap(new_data);
 }
 
 /**
@@ -1222,18 +1189,35 @@ void PfmFile::
 xform(const LMatrix4f &transform) {
   nassertv(is_valid());
 
-  int num_channels = get_num_channels();
+  XformRows rows;
+  rows._file = this;
+  rows._transform = &transform;
+  PNMParallelRows::run(_y_size, (size_t)_x_size * 16, &xform_rows, &rows);
+}
+
+/**
+ * Applies the transform to rows [begin, end) on behalf of xform().  This may
+ * be called on several threads at once for different rows.
+ */
+void PfmFile::
+xform_rows(void *data, int begin, int end) {
+  const XformRows &rows = *(const XformRows *)data;
+  PfmFile &file = *rows._file;
+  const LMatrix4f &transform = *rows._transform;
+  int x_size = file._x_size;
+
+  int num_channels = file.get_num_channels();
   switch (num_channels) {
   case 1:
     {
-      for (int yi = 0; yi < _y_size; ++yi) {
-        for (int xi = 0; xi < _x_size; ++xi) {
-          if (!has_point(xi, yi)) {
+      for (int yi = begin; yi < end; ++yi) {
+        for (int xi = 0; xi < x_size; ++xi) {
+          if (!file.has_point(xi, yi)) {
             continue;
           }
-          PN_float32 pi = get_point1(xi, yi);
+          PN_float32 pi = file.get_point1(xi, yi);
           LPoint3f po = transform.xform_point(LPoint3f(pi, 0.0, 0.0));
-          set_point1(xi, yi, po[0]);
+          file.set_point1(xi, yi, po[0]);
         }
       }
     }
@@ -1241,14 +1225,14 @@ xform(const LMatrix4f &transform) {
 
   case 2:
     {
-      for (int yi = 0; yi < _y_size; ++yi) {
-        for (int xi = 0; xi < _x_size; ++xi) {
-          if (!has_point(xi, yi)) {
+      for (int yi = begin; yi < end; ++yi) {
+        for (int xi = 0; xi < x_size; ++xi) {
+          if (!file.has_point(xi, yi)) {
             continue;
           }
-          LPoint2f pi = get_point2(xi, yi);
+          LPoint2f pi = file.get_point2(xi, yi);
           LPoint3f po = transform.xform_point(LPoint3f(pi[0], pi[1], 0.0));
-          set_point2(xi, yi, LPoint2f(po[0], po[1]));
+          file.set_point2(xi, yi, LPoint2f(po[0], po[1]));
         }
       }
     }
@@ -1256,12 +1240,12 @@ xform(const LMatrix4f &transform) {
 
   case 3:
     {
-      for (int yi = 0; yi < _y_size; ++yi) {
-        for (int xi = 0; xi < _x_size; ++xi) {
-          if (!has_point(xi, yi)) {
+      for (int yi = begin; yi < end; ++yi) {
+        for (int xi = 0; xi < x_size; ++xi) {
+          if (!file.has_point(xi, yi)) {
             continue;
           }
-          LPoint3f &p = modify_point3(xi, yi);
+          LPoint3f &p = file.modify_point3(xi, yi);
           transform.xform_point_general_in_place(p);
         }
       }
@@ -1270,12 +1254,12 @@ xform(const LMatrix4f &transform) {
 
   case 4:
     {
-      for (int yi = 0; yi < _y_size; ++yi) {
-        for (int xi = 0; xi < _x_size; ++xi) {
-          if (!has_point(xi, yi)) {
+      for (int yi = begin; yi < end; ++yi) {
+        for (int xi = 0; xi < x_size; ++xi) {
+          if (!file.has_point(xi, yi)) {
             continue;
           }
-          LPoint4f &p = modify_point4(xi, yi);
+          LPoint4f &p = file.modify_point4(xi, yi);
           transform.xform_in_place(p);
         }
       }
@@ -1335,19 +1319,15 @@ forward_distort(const PfmFile &dist, PN_float32 scale_factor) {
     result.fill(_no_data_value);
   }
 
-  for (int yi = 0; yi < working_y_size; ++yi) {
-    for (int xi = 0; xi < working_x_size; ++xi) {
-      if (!dist_p->has_point(xi, yi)) {
-        continue;
-      }
-      LPoint2f uv = dist_p->get_point2(xi, yi);
-      LPoint3f p;
-      if (!source_p->calc_bilinear_point(p, uv[0], 1.0 - uv[1])) {
-        continue;
-      }
-      nassertv(!p.is_nan());
-      result.set_point(xi, working_y_size - 1 - yi, p);
-    }
+  DistortRows rows;
+  rows._result = &result;
+  rows._source = source_p;
+  rows._dist = dist_p;
+  rows._failed = 0;
+  PNMParallelRows::run(working_y_size, (size_t)working_x_size * 16,
+                       &forward_distort_rows, &rows);
+  if (AtomicAdjust::get(rows._failed)) {
+    return;
   }
 
   // Resize to the target size for completion.
@@ -1408,7 +1388,67 @@ reverse_distort(const PfmFile &dist, PN_float32 scale_factor) {
     result.fill(_no_data_value);
   }
 
-  for (int yi = 0; yi < working_y_size; ++yi) {
+  DistortRows rows;
+  rows._result = &result;
+  rows._source = source_p;
+  rows._dist = dist_p;
+  rows._failed = 0;
+  PNMParallelRows::run(working_y_size, (size_t)working_x_size * 16,
+                       &reverse_distort_rows, &rows);
+
+  // Resize to the target size for completion.
+  result.resize(_x_size, _y_size);
+
+  nassertv(result._table.size() == _table.size());
+  _table.swap(result._table);
+}
+
+/**
+ * Computes rows [begin, end) of the result on behalf of forward_distort().
+ * This may be called on several threads at once for different rows.
+ */
+void PfmFile::
+forward_distort_rows(void *data, int begin, int end) {
+  DistortRows &rows = *(DistortRows *)data;
+  const PfmFile *source_p = rows._source;
+  const PfmFile *dist_p = rows._dist;
+  PfmFile &result = *rows._result;
+  int working_x_size = result._x_size;
+  int working_y_size = result._y_size;
+
+  for (int yi = begin; yi < end; ++yi) {
+    for (int xi = 0; xi < working_x_size; ++xi) {
+      if (!dist_p->has_point(xi, yi)) {
+        continue;
+      }
+      LPoint2f uv = dist_p->get_point2(xi, yi);
+      LPoint3f p;
+      if (!source_p->calc_bilinear_point(p, uv[0], 1.0 - uv[1])) {
+        continue;
+      }
+      nassertd(!p.is_nan()) {
+        AtomicAdjust::set(rows._failed, 1);
+        return;
+      }
+      result.set_point(xi, working_y_size - 1 - yi, p);
+    }
+    Thread::consider_yield();
+  }
+}
+
+/**
+ * Computes rows [begin, end) of the result on behalf of reverse_distort().
+ * This may be called on several threads at once for different rows.
+ */
+void PfmFile::
+reverse_distort_rows(void *data, int begin, int end) {
+  const DistortRows &rows = *(const DistortRows *)data;
+  const PfmFile *source_p = rows._source;
+  const PfmFile *dist_p = rows._dist;
+  PfmFile &result = *rows._result;
+  int working_x_size = result._x_size;
+
+  for (int yi = begin; yi < end; ++yi) {
     for (int xi = 0; xi < working_x_size; ++xi) {
       if (!source_p->has_point(xi, yi)) {
         continue;
@@ -1420,13 +1460,8 @@ reverse_distort(const PfmFile &dist, PN_float32 scale_factor) {
       }
       result.set_point(xi, yi, LPoint3f(p[0], 1.0 - p[1], p[2]));
     }
+    Thread::consider_yield();
   }
-
-  // Resize to the target size for completion.
-  result.resize(_x_size, _y_size);
-
-  nassertv(result._table.size() == _table.size());
-  _table.swap(result._table);
 }
 
 /**
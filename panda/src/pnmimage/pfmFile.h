@@ -19,6 +19,7 @@
 #include "luse.h"
 #include "boundingHexahedron.h"
 #include "vector_float.h"
+#include "atomicAdjust.h"
 
 class PNMImage;
 class PNMReader;
@@ -220,6 +221,35 @@ private:
   void fill_mini_grid(MiniGridCell *mini_grid, int x_size, int y_size,
                       int xi, int yi, int dist, int sxi, int syi) const;
 
+  // These hold the state shared by the threads of the row-parallel
+  // operations; see PNMParallelRows.
+  class QuickFilterRows {
+  public:
+    PN_float32 *_new_data;
+    const PfmFile *_from;
+    int _x_size;
+    int _num_channels;
+    PN_float32 _x_scale, _y_scale;
+  };
+  static void quick_filter_rows(void *data, int begin, int end);
+
+  class XformRows {
+  public:
+    PfmFile *_file;
+    const LMatrix4f *_transform;
+  };
+  static void xform_rows(void *data, int begin, int end);
+
+  class DistortRows {
+  public:
+    PfmFile *_result;
+    const PfmFile *_source;
+    const PfmFile *_dist;
+    AtomicAdjust::Integer _failed;
+  };
+  static void forward_distort_rows(void *data, int begin, int end);
+  static void reverse_distort_rows(void *data, int begin, int end);
+
   static bool has_point_noop(const PfmFile *file, int x, int y);
   static bool has_point_1(const PfmFile *file, int x, int y);
   static bool has_point_2(const PfmFile *file, int x, int y);
@@ -0,0 +1,1226 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pfmTiledFile.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pfmTiledFile.h"
+#include "pfmFile.h"
+#include "config_pnmimage.h"
+#include "lightMutexHolder.h"
+#include "cmath.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using std::max;
+using std::min;
+
+// The header and every tile begin on a multiple of this many bytes, which is
+// the granularity at which a file may be mapped on all supported platforms
+// (it is the allocation granularity on Windows).
+static const size_t tile_alignment = 65536;
+
+static const char tiled_magic[8] = { 'p', 'f', 'm', 't', 'i', 'l', 'e', '\n' };
+static const uint32_t tiled_byte_order = 0x01020304;
+static const uint32_t tiled_version = 1;
+
+/**
+ * The source points, and their weights, that contribute to one destination
+ * point along one axis of resize().
+ */
+class PfmResizeTap {
+public:
+  int _source;
+  PN_float32 _weight;
+};
+typedef pvector<PfmResizeTap> PfmResizeTaps;
+
+/**
+ * Computes the taps for destination point d along an axis that is being
+ * scaled from source_size points by the indicated factor (source / dest).
+ * When shrinking, this is a box filter over the points covered by d; when
+ * growing, it is a linear interpolation between the nearest two points.
+ */
+static void
+calc_resize_taps(PfmResizeTaps &taps, int d, double scale, int source_size) {
+  taps.clear();
+  PfmResizeTap tap;
+
+  if (scale >= 1.0) {
+    double a = d * scale;
+    double b = (d + 1) * scale;
+    int begin = (int)cfloor(a);
+    int end = min((int)cceil(b), source_size);
+    for (int i = begin; i < end; ++i) {
+      double w = min(b, (double)(i + 1)) - max(a, (double)i);
+      if (w > 0.0) {
+        tap._source = i;
+        tap._weight = (PN_float32)w;
+        taps.push_back(tap);
+      }
+    }
+
+  } else {
+    double c = (d + 0.5) * scale - 0.5;
+    int i = (int)cfloor(c);
+    double frac = c - i;
+    if (i < 0) {
+      tap._source = 0;
+      tap._weight = 1.0f;
+      taps.push_back(tap);
+    } else if (i + 1 >= source_size) {
+      tap._source = source_size - 1;
+      tap._weight = 1.0f;
+      taps.push_back(tap);
+    } else {
+      tap._source = i;
+      tap._weight = (PN_float32)(1.0 - frac);
+      taps.push_back(tap);
+      tap._source = i + 1;
+      tap._weight = (PN_float32)frac;
+      taps.push_back(tap);
+    }
+  }
+}
+
+/**
+ *
+ */
+PfmTiledFile::
+PfmTiledFile() :
+  _writable(false),
+  _tile_size(0),
+  _num_tiles_x(0),
+  _num_tiles_y(0),
+  _tile_bytes(0),
+  _has_no_data_value(false),
+  _no_data_value(LPoint4f::zero()),
+#ifdef _WIN32
+  _file_handle(INVALID_HANDLE_VALUE),
+  _mapping_handle(nullptr),
+#else
+  _fd(-1),
+#endif
+  _header(nullptr),
+  _max_cache_size((size_t)pfm_tile_cache_size.get_value()),
+  _lru_head(nullptr),
+  _lru_tail(nullptr),
+  _num_cached_tiles(0)
+{
+  _x_size = 0;
+  _y_size = 0;
+  _num_channels = 0;
+}
+
+/**
+ *
+ */
+PfmTiledFile::
+~PfmTiledFile() {
+  close();
+}
+
+/**
+ * Creates a new tiled file on disk of the indicated size, replacing any file
+ * that was already there, and leaves it open for writing.  All points are
+ * initially zero.  If tile_size is 0, the value of pfm-tile-size is used.
+ *
+ * The disk space is not written until each tile is first touched, so on most
+ * filesystems a new file occupies little space until it is filled in.
+ */
+bool PfmTiledFile::
+create(const Filename &fullpath, int x_size, int y_size, int num_channels,
+       int tile_size) {
+  close();
+  nassertr(x_size > 0 && y_size > 0, false);
+  nassertr(num_channels > 0 && num_channels <= 4, false);
+
+  if (tile_size <= 0) {
+    tile_size = max((int)pfm_tile_size, 1);
+  }
+
+  _x_size = x_size;
+  _y_size = y_size;
+  _num_channels = num_channels;
+  _tile_size = tile_size;
+  _num_tiles_x = (x_size + tile_size - 1) / tile_size;
+  _num_tiles_y = (y_size + tile_size - 1) / tile_size;
+  _tile_bytes = (size_t)tile_size * tile_size * num_channels * sizeof(PN_float32);
+  _tile_bytes = (_tile_bytes + tile_alignment - 1) & ~(tile_alignment - 1);
+
+  uint64_t file_size = tile_alignment +
+    (uint64_t)_num_tiles_x * (uint64_t)_num_tiles_y * (uint64_t)_tile_bytes;
+  if (!open_file(fullpath, true, true, file_size)) {
+    close();
+    return false;
+  }
+
+  _tiles.assign((size_t)_num_tiles_x * (size_t)_num_tiles_y, nullptr);
+  return write_header();
+}
+
+/**
+ * Opens an existing tiled file, such as one previously written by create().
+ * If writable is true, the points may be modified in place.  Returns true on
+ * success, false on failure.
+ */
+bool PfmTiledFile::
+open(const Filename &fullpath, bool writable) {
+  close();
+
+  uint64_t file_size = 0;
+  if (!open_file(fullpath, writable, false, file_size)) {
+    close();
+    return false;
+  }
+
+  const Header &header = *_header;
+  if (memcmp(header._magic, tiled_magic, sizeof(tiled_magic)) != 0) {
+    pnmimage_cat.error()
+      << fullpath << " is not a tiled pfm file.\n";
+    close();
+    return false;
+  }
+  if (header._byte_order != tiled_byte_order) {
+    pnmimage_cat.error()
+      << fullpath << " was written on a machine with a different byte order.\n";
+    close();
+    return false;
+  }
+  if (header._version != tiled_version) {
+    pnmimage_cat.error()
+      << fullpath << " has unsupported version " << header._version << ".\n";
+    close();
+    return false;
+  }
+  if (header._x_size <= 0 || header._y_size <= 0 || header._tile_size <= 0 ||
+      header._num_channels <= 0 || header._num_channels > 4) {
+    pnmimage_cat.error()
+      << fullpath << " has an invalid header.\n";
+    close();
+    return false;
+  }
+
+  _x_size = header._x_size;
+  _y_size = header._y_size;
+  _num_channels = header._num_channels;
+  _tile_size = header._tile_size;
+  _num_tiles_x = (_x_size + _tile_size - 1) / _tile_size;
+  _num_tiles_y = (_y_size + _tile_size - 1) / _tile_size;
+  _tile_bytes = (size_t)_tile_size * _tile_size * _num_channels * sizeof(PN_float32);
+  _tile_bytes = (_tile_bytes + tile_alignment - 1) & ~(tile_alignment - 1);
+
+  _has_no_data_value = (header._has_no_data_value != 0);
+  _no_data_value.set(header._no_data_value[0], header._no_data_value[1],
+                     header._no_data_value[2], header._no_data_value[3]);
+
+  uint64_t expected_size = tile_alignment +
+    (uint64_t)_num_tiles_x * (uint64_t)_num_tiles_y * (uint64_t)_tile_bytes;
+  if (file_size < expected_size) {
+    pnmimage_cat.error()
+      << fullpath << " is truncated.\n";
+    close();
+    return false;
+  }
+
+  _tiles.assign((size_t)_num_tiles_x * (size_t)_num_tiles_y, nullptr);
+  return true;
+}
+
+/**
+ * Releases all of the mapped tiles and closes the file.  Any changes are
+ * written back to disk.
+ */
+void PfmTiledFile::
+close() {
+  unmap_all_tiles();
+  _tiles.clear();
+
+  if (_header != nullptr) {
+    unmap_region(_header, tile_alignment);
+    _header = nullptr;
+  }
+
+#ifdef _WIN32
+  if (_mapping_handle != nullptr) {
+    CloseHandle(_mapping_handle);
+    _mapping_handle = nullptr;
+  }
+  if (_file_handle != INVALID_HANDLE_VALUE) {
+    CloseHandle(_file_handle);
+    _file_handle = INVALID_HANDLE_VALUE;
+  }
+#else
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+#endif
+
+  _filename = Filename();
+  _writable = false;
+  _x_size = 0;
+  _y_size = 0;
+  _num_channels = 0;
+  _tile_size = 0;
+  _num_tiles_x = 0;
+  _num_tiles_y = 0;
+  _tile_bytes = 0;
+  _has_no_data_value = false;
+  _no_data_value = LPoint4f::zero();
+}
+
+/**
+ * Ensures that all modified tiles currently in memory have been written to
+ * disk.
+ */
+void PfmTiledFile::
+flush() {
+  if (!_writable) {
+    return;
+  }
+
+  LightMutexHolder holder(_lock);
+  for (Tile *tile = _lru_head; tile != nullptr; tile = tile->_next) {
+#ifdef _WIN32
+    FlushViewOfFile(tile->_data, _tile_bytes);
+#else
+    msync(tile->_data, _tile_bytes, MS_SYNC);
+#endif
+  }
+#ifdef _WIN32
+  FlushViewOfFile(_header, tile_alignment);
+  FlushFileBuffers(_file_handle);
+#else
+  msync(_header, tile_alignment, MS_SYNC);
+#endif
+}
+
+/**
+ * Specifies the maximum number of bytes of tile data that may be mapped into
+ * memory at once.  At least one tile is always kept.  The initial value comes
+ * from pfm-tile-cache-size.
+ */
+void PfmTiledFile::
+set_max_cache_size(size_t max_cache_size) {
+  LightMutexHolder holder(_lock);
+  _max_cache_size = max_cache_size;
+  while (_num_cached_tiles > 1 &&
+         (size_t)_num_cached_tiles * _tile_bytes > _max_cache_size) {
+    evict_tile();
+  }
+}
+
+/**
+ * Returns the number of tiles that are currently mapped into memory.
+ */
+int PfmTiledFile::
+get_num_cached_tiles() const {
+  LightMutexHolder holder(_lock);
+  return _num_cached_tiles;
+}
+
+/**
+ * Sets the special value that means "no data" at a particular point.  If the
+ * file is writable, this value is also stored in the file.
+ */
+void PfmTiledFile::
+set_no_data_value(const LPoint4f &no_data_value) {
+  nassertv(is_valid());
+  _has_no_data_value = true;
+  _no_data_value = no_data_value;
+  if (_writable) {
+    write_header();
+  }
+}
+
+/**
+ * Removes the special value that means "no data" at a particular point.
+ */
+void PfmTiledFile::
+clear_no_data_value() {
+  _has_no_data_value = false;
+  _no_data_value = LPoint4f::zero();
+  if (_writable) {
+    write_header();
+  }
+}
+
+/**
+ * Returns true if there is a valid point at x, y.  This always returns true
+ * unless a "no data" value has been set, in which case it returns false if
+ * the point at x, y is the "no data" value.
+ */
+bool PfmTiledFile::
+has_point(int x, int y) const {
+  if (x < 0 || x >= _x_size || y < 0 || y >= _y_size) {
+    return false;
+  }
+  if (!_has_no_data_value) {
+    return true;
+  }
+
+  LightMutexHolder holder(_lock);
+  int tx = x / _tile_size;
+  int ty = y / _tile_size;
+  const PN_float32 *tile = get_tile(tx, ty);
+  nassertr(tile != nullptr, false);
+  size_t i = (size_t)(y - ty * _tile_size) * _tile_size + (x - tx * _tile_size);
+  return has_point_data(tile + i * _num_channels);
+}
+
+/**
+ * Returns the cth channel of the point value at the indicated point.
+ */
+PN_float32 PfmTiledFile::
+get_channel(int x, int y, int c) const {
+  nassertr(x >= 0 && x < _x_size &&
+           y >= 0 && y < _y_size &&
+           c >= 0 && c < _num_channels, 0.0f);
+
+  LightMutexHolder holder(_lock);
+  int tx = x / _tile_size;
+  int ty = y / _tile_size;
+  const PN_float32 *tile = get_tile(tx, ty);
+  nassertr(tile != nullptr, 0.0f);
+  size_t i = (size_t)(y - ty * _tile_size) * _tile_size + (x - tx * _tile_size);
+  return tile[i * _num_channels + c];
+}
+
+/**
+ * Replaces the cth channel of the point value at the indicated point.
+ */
+void PfmTiledFile::
+set_channel(int x, int y, int c, PN_float32 value) {
+  nassertv(_writable);
+  nassertv(x >= 0 && x < _x_size &&
+           y >= 0 && y < _y_size &&
+           c >= 0 && c < _num_channels);
+
+  LightMutexHolder holder(_lock);
+  int tx = x / _tile_size;
+  int ty = y / _tile_size;
+  PN_float32 *tile = get_tile(tx, ty);
+  nassertv(tile != nullptr);
+  size_t i = (size_t)(y - ty * _tile_size) * _tile_size + (x - tx * _tile_size);
+  tile[i * _num_channels + c] = value;
+}
+
+/**
+ * Returns the 3-component point value at the indicated point.  In a 1- or
+ * 2-channel file, the missing components are zero.
+ */
+LPoint3f PfmTiledFile::
+get_point(int x, int y) const {
+  LPoint4f p = get_point4(x, y);
+  return LPoint3f(p[0], p[1], p[2]);
+}
+
+/**
+ * Replaces the 3-component point value at the indicated point.  In a 1- or
+ * 2-channel file, the extra components are ignored.
+ */
+void PfmTiledFile::
+set_point(int x, int y, const LVecBase3f &point) {
+  nassertv(_writable);
+  nassertv(x >= 0 && x < _x_size && y >= 0 && y < _y_size);
+
+  LightMutexHolder holder(_lock);
+  int tx = x / _tile_size;
+  int ty = y / _tile_size;
+  PN_float32 *tile = get_tile(tx, ty);
+  nassertv(tile != nullptr);
+  size_t i = (size_t)(y - ty * _tile_size) * _tile_size + (x - tx * _tile_size);
+  PN_float32 *p = tile + i * _num_channels;
+  int num_channels = min(_num_channels, 3);
+  for (int c = 0; c < num_channels; ++c) {
+    p[c] = point[c];
+  }
+}
+
+/**
+ * Returns the 4-component point value at the indicated point.  In a file with
+ * fewer than 4 channels, the missing components are zero.
+ */
+LPoint4f PfmTiledFile::
+get_point4(int x, int y) const {
+  nassertr(x >= 0 && x < _x_size && y >= 0 && y < _y_size, LPoint4f::zero());
+
+  LPoint4f result(LPoint4f::zero());
+
+  LightMutexHolder holder(_lock);
+  int tx = x / _tile_size;
+  int ty = y / _tile_size;
+  const PN_float32 *tile = get_tile(tx, ty);
+  nassertr(tile != nullptr, result);
+  size_t i = (size_t)(y - ty * _tile_size) * _tile_size + (x - tx * _tile_size);
+  const PN_float32 *p = tile + i * _num_channels;
+  for (int c = 0; c < _num_channels; ++c) {
+    result[c] = p[c];
+  }
+  return result;
+}
+
+/**
+ * Replaces the 4-component point value at the indicated point.  In a file
+ * with fewer than 4 channels, the extra components are ignored.
+ */
+void PfmTiledFile::
+set_point4(int x, int y, const LVecBase4f &point) {
+  nassertv(_writable);
+  nassertv(x >= 0 && x < _x_size && y >= 0 && y < _y_size);
+
+  LightMutexHolder holder(_lock);
+  int tx = x / _tile_size;
+  int ty = y / _tile_size;
+  PN_float32 *tile = get_tile(tx, ty);
+  nassertv(tile != nullptr);
+  size_t i = (size_t)(y - ty * _tile_size) * _tile_size + (x - tx * _tile_size);
+  PN_float32 *p = tile + i * _num_channels;
+  for (int c = 0; c < _num_channels; ++c) {
+    p[c] = point[c];
+  }
+}
+
+/**
+ * Fills the entire file with the indicated value, one tile at a time.
+ */
+void PfmTiledFile::
+fill(const LPoint4f &value) {
+  nassertv(_writable);
+
+  size_t points_per_tile = (size_t)_tile_size * _tile_size;
+
+  LightMutexHolder holder(_lock);
+  for (int ty = 0; ty < _num_tiles_y; ++ty) {
+    for (int tx = 0; tx < _num_tiles_x; ++tx) {
+      PN_float32 *tile = get_tile(tx, ty);
+      nassertv(tile != nullptr);
+      for (size_t i = 0; i < points_per_tile; ++i) {
+        for (int c = 0; c < _num_channels; ++c) {
+          tile[i * _num_channels + c] = value[c];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Computes the weighted average of the four nearest points to the floating-
+ * point index (x, y), where (0, 0) is one corner of the image and (1, 1) the
+ * other.  Returns true if the point has any contributors, false if the point
+ * is unknown.  This is the same computation as PfmFile::calc_bilinear_point().
+ */
+bool PfmTiledFile::
+calc_bilinear_point(LPoint3f &result, PN_float32 x, PN_float32 y) const {
+  result = LPoint3f::zero();
+
+  x = (x * _x_size - 0.5);
+  y = (y * _y_size - 0.5);
+
+  int min_x = int(floor(x));
+  int min_y = int(floor(y));
+
+  PN_float32 frac_x = x - min_x;
+  PN_float32 frac_y = y - min_y;
+
+  LPoint3f p00(LPoint3f::zero()), p01(LPoint3f::zero()), p10(LPoint3f::zero()), p11(LPoint3f::zero());
+  PN_float32 w00 = 0.0, w01 = 0.0, w10 = 0.0, w11 = 0.0;
+
+  if (has_point(min_x, min_y)) {
+    w00 = (1.0 - frac_y) * (1.0 - frac_x);
+    p00 = get_point(min_x, min_y);
+  }
+  if (has_point(min_x + 1, min_y)) {
+    w10 = (1.0 - frac_y) * frac_x;
+    p10 = get_point(min_x + 1, min_y);
+  }
+  if (has_point(min_x, min_y + 1)) {
+    w01 = frac_y * (1.0 - frac_x);
+    p01 = get_point(min_x, min_y + 1);
+  }
+  if (has_point(min_x + 1, min_y + 1)) {
+    w11 = frac_y * frac_x;
+    p11 = get_point(min_x + 1, min_y + 1);
+  }
+
+  PN_float32 net_w = w00 + w01 + w10 + w11;
+  if (net_w == 0.0) {
+    return false;
+  }
+
+  result = (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11) / net_w;
+  return true;
+}
+
+/**
+ * Calculates the minimum and maximum x, y, and z depth component values,
+ * representing the bounding box of depth values, and places them in the
+ * indicated vectors.  Returns true if successful, false if the file contains
+ * no points.  In a 1- or 2-channel file, the missing components are zero.
+ */
+bool PfmTiledFile::
+calc_min_max(LVecBase3f &min_depth, LVecBase3f &max_depth) const {
+  bool any_points = false;
+
+  min_depth = LVecBase3f::zero();
+  max_depth = LVecBase3f::zero();
+
+  int num_channels = min(_num_channels, 3);
+
+  LightMutexHolder holder(_lock);
+  for (int ty = 0; ty < _num_tiles_y; ++ty) {
+    int y_end = min(_tile_size, _y_size - ty * _tile_size);
+    for (int tx = 0; tx < _num_tiles_x; ++tx) {
+      int x_end = min(_tile_size, _x_size - tx * _tile_size);
+      const PN_float32 *tile = get_tile(tx, ty);
+      nassertr(tile != nullptr, false);
+
+      for (int yi = 0; yi < y_end; ++yi) {
+        const PN_float32 *p = tile + (size_t)yi * _tile_size * _num_channels;
+        for (int xi = 0; xi < x_end; ++xi, p += _num_channels) {
+          if (!has_point_data(p)) {
+            continue;
+          }
+
+          if (!any_points) {
+            for (int c = 0; c < num_channels; ++c) {
+              min_depth[c] = p[c];
+              max_depth[c] = p[c];
+            }
+            any_points = true;
+          } else {
+            for (int c = 0; c < num_channels; ++c) {
+              min_depth[c] = min(min_depth[c], p[c]);
+              max_depth[c] = max(max_depth[c], p[c]);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return any_points;
+}
+
+/**
+ * Copies the rectangular region of this file beginning at (xfrom, yfrom) into
+ * result, which is reinitialized to the size of the region.  The "no data"
+ * value, if any, is copied as well.  Returns true on success, false if the
+ * region does not lie within the file.
+ */
+bool PfmTiledFile::
+store_sub_image(PfmFile &result, int xfrom, int yfrom,
+                int x_size, int y_size) const {
+  nassertr(is_valid(), false);
+  nassertr(xfrom >= 0 && yfrom >= 0 && x_size >= 0 && y_size >= 0 &&
+           xfrom + x_size <= _x_size && yfrom + y_size <= _y_size, false);
+
+  result.clear(x_size, y_size, _num_channels);
+
+  vector_float table;
+  result.swap_table(table);
+  read_region(&table[0], xfrom, yfrom, x_size, y_size);
+  result.swap_table(table);
+
+  if (_has_no_data_value) {
+    result.set_no_data_value(_no_data_value);
+  }
+  return true;
+}
+
+/**
+ * Copies a rectangular area of a PfmFile into a rectangular area of this
+ * file, with the same meaning as PfmFile::copy_sub_image(): points for which
+ * the source has no data are left unchanged.  The source must have the same
+ * number of channels as this file.
+ */
+void PfmTiledFile::
+copy_sub_image(const PfmFile &copy, int xto, int yto,
+               int xfrom, int yfrom, int x_size, int y_size) {
+  nassertv(_writable);
+  nassertv(copy.get_num_channels() == _num_channels);
+
+  if (x_size < 0) {
+    x_size = copy.get_x_size() - xfrom;
+  }
+  if (y_size < 0) {
+    y_size = copy.get_y_size() - yfrom;
+  }
+
+  if (xfrom < 0) {
+    xto += -xfrom;
+    x_size -= -xfrom;
+    xfrom = 0;
+  }
+  if (yfrom < 0) {
+    yto += -yfrom;
+    y_size -= -yfrom;
+    yfrom = 0;
+  }
+
+  if (xto < 0) {
+    xfrom += -xto;
+    x_size -= -xto;
+    xto = 0;
+  }
+  if (yto < 0) {
+    yfrom += -yto;
+    y_size -= -yto;
+    yto = 0;
+  }
+
+  x_size = min(x_size, copy.get_x_size() - xfrom);
+  y_size = min(y_size, copy.get_y_size() - yfrom);
+
+  int xmin = xto;
+  int ymin = yto;
+  int xmax = min(xmin + x_size, _x_size);
+  int ymax = min(ymin + y_size, _y_size);
+  if (xmin >= xmax || ymin >= ymax) {
+    return;
+  }
+
+  const vector_float &table = copy.get_table();
+  int copy_x_size = copy.get_x_size();
+
+  // Walk through the destination one tile at a time, so that each tile is
+  // only mapped once.
+  LightMutexHolder holder(_lock);
+  for (int ty = ymin / _tile_size; ty * _tile_size < ymax; ++ty) {
+    int y_begin = max(ymin, ty * _tile_size);
+    int y_end = min(ymax, (ty + 1) * _tile_size);
+    for (int tx = xmin / _tile_size; tx * _tile_size < xmax; ++tx) {
+      int x_begin = max(xmin, tx * _tile_size);
+      int x_end = min(xmax, (tx + 1) * _tile_size);
+      PN_float32 *tile = get_tile(tx, ty);
+      nassertv(tile != nullptr);
+
+      for (int y = y_begin; y < y_end; ++y) {
+        for (int x = x_begin; x < x_end; ++x) {
+          int sx = x - xmin + xfrom;
+          int sy = y - ymin + yfrom;
+          if (copy.has_point(sx, sy)) {
+            const PN_float32 *s = &table[((size_t)sy * copy_x_size + sx) * _num_channels];
+            PN_float32 *d = tile + ((size_t)(y - ty * _tile_size) * _tile_size + (x - tx * _tile_size)) * _num_channels;
+            memcpy(d, s, _num_channels * sizeof(PN_float32));
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Reduces the file to the cells in the rectangle bounded by (x_begin, x_end,
+ * y_begin, y_end), where the _end cells are not included.  The cropped image
+ * is written to a temporary file alongside this one, which then replaces it.
+ * Returns true on success, false on failure.
+ */
+bool PfmTiledFile::
+apply_crop(int x_begin, int x_end, int y_begin, int y_end) {
+  nassertr(_writable, false);
+  nassertr(x_begin >= 0 && x_begin < x_end && x_end <= _x_size, false);
+  nassertr(y_begin >= 0 && y_begin < y_end && y_end <= _y_size, false);
+
+  int new_x_size = x_end - x_begin;
+  int new_y_size = y_end - y_begin;
+
+  PfmTiledFile temp;
+  if (!make_temp_file(temp, new_x_size, new_y_size)) {
+    return false;
+  }
+
+  // Copy across one destination tile at a time; each reads from at most four
+  // tiles of the source.
+  vector_float buffer;
+  for (int ty = 0; ty < temp._num_tiles_y; ++ty) {
+    int y0 = ty * _tile_size;
+    int ys = min(_tile_size, new_y_size - y0);
+    for (int tx = 0; tx < temp._num_tiles_x; ++tx) {
+      int x0 = tx * _tile_size;
+      int xs = min(_tile_size, new_x_size - x0);
+      buffer.resize((size_t)xs * ys * _num_channels);
+      read_region(&buffer[0], x0 + x_begin, y0 + y_begin, xs, ys);
+      temp.write_region(&buffer[0], x0, y0, xs, ys);
+    }
+  }
+
+  return replace_with(temp);
+}
+
+/**
+ * Resamples the file to the indicated size.  Each axis is box-filtered when
+ * it is being shrunk, and linearly interpolated when it is being grown;
+ * points with no data do not contribute.  The new image is computed a block
+ * at a time into a temporary file alongside this one, which then replaces
+ * it, so that only a few tiles of either file need be in memory at once.
+ * Returns true on success, false on failure.
+ */
+bool PfmTiledFile::
+resize(int new_x_size, int new_y_size) {
+  nassertr(_writable, false);
+  nassertr(new_x_size > 0 && new_y_size > 0, false);
+
+  if (new_x_size == _x_size && new_y_size == _y_size) {
+    return true;
+  }
+
+  PfmTiledFile temp;
+  if (!make_temp_file(temp, new_x_size, new_y_size)) {
+    return false;
+  }
+
+  double x_scale = (double)_x_size / (double)new_x_size;
+  double y_scale = (double)_y_size / (double)new_y_size;
+
+  // Choose a block size for which the source region is not much more than a
+  // tile in each dimension.
+  int x_block = max(1, min(_tile_size, (int)(_tile_size / ceil(x_scale))));
+  int y_block = max(1, min(_tile_size, (int)(_tile_size / ceil(y_scale))));
+
+  pvector<PfmResizeTaps> x_taps, y_taps;
+  vector_float source, dest;
+
+  for (int y0 = 0; y0 < new_y_size; y0 += y_block) {
+    int ys = min(y_block, new_y_size - y0);
+    y_taps.resize(ys);
+    int sy_begin = _y_size, sy_end = 0;
+    for (int yi = 0; yi < ys; ++yi) {
+      calc_resize_taps(y_taps[yi], y0 + yi, y_scale, _y_size);
+      sy_begin = min(sy_begin, y_taps[yi].front()._source);
+      sy_end = max(sy_end, y_taps[yi].back()._source + 1);
+    }
+
+    for (int x0 = 0; x0 < new_x_size; x0 += x_block) {
+      int xs = min(x_block, new_x_size - x0);
+      x_taps.resize(xs);
+      int sx_begin = _x_size, sx_end = 0;
+      for (int xi = 0; xi < xs; ++xi) {
+        calc_resize_taps(x_taps[xi], x0 + xi, x_scale, _x_size);
+        sx_begin = min(sx_begin, x_taps[xi].front()._source);
+        sx_end = max(sx_end, x_taps[xi].back()._source + 1);
+      }
+
+      int source_x_size = sx_end - sx_begin;
+      source.resize((size_t)source_x_size * (sy_end - sy_begin) * _num_channels);
+      read_region(&source[0], sx_begin, sy_begin, source_x_size, sy_end - sy_begin);
+
+      dest.resize((size_t)xs * ys * _num_channels);
+      PN_float32 *d = &dest[0];
+      for (int yi = 0; yi < ys; ++yi) {
+        const PfmResizeTaps &ytaps = y_taps[yi];
+        for (int xi = 0; xi < xs; ++xi, d += _num_channels) {
+          const PfmResizeTaps &xtaps = x_taps[xi];
+
+          PN_float32 net_value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+          PN_float32 net_weight = 0.0f;
+          for (const PfmResizeTap &yt : ytaps) {
+            for (const PfmResizeTap &xt : xtaps) {
+              const PN_float32 *s = &source[((size_t)(yt._source - sy_begin) * source_x_size + (xt._source - sx_begin)) * _num_channels];
+              if (has_point_data(s)) {
+                PN_float32 w = yt._weight * xt._weight;
+                for (int c = 0; c < _num_channels; ++c) {
+                  net_value[c] += s[c] * w;
+                }
+                net_weight += w;
+              }
+            }
+          }
+
+          for (int c = 0; c < _num_channels; ++c) {
+            if (net_weight > 0.0f) {
+              d[c] = net_value[c] / net_weight;
+            } else {
+              d[c] = _has_no_data_value ? _no_data_value[c] : 0.0f;
+            }
+          }
+        }
+      }
+
+      temp.write_region(&dest[0], x0, y0, xs, ys);
+    }
+  }
+
+  return replace_with(temp);
+}
+
+/**
+ *
+ */
+void PfmTiledFile::
+output(std::ostream &out) const {
+  out << "PfmTiledFile " << _x_size << " by " << _y_size << " pixels, "
+      << _num_channels << " channels, " << _num_tiles_x * _num_tiles_y
+      << " tiles of " << _tile_size << " by " << _tile_size;
+  if (!_filename.empty()) {
+    out << ", " << _filename;
+  }
+}
+
+/**
+ * Opens or creates the file on disk and maps its header.  If create is true,
+ * the file is extended to file_size bytes; otherwise, file_size is filled in
+ * with the size of the existing file.
+ */
+bool PfmTiledFile::
+open_file(const Filename &fullpath, bool writable, bool create,
+          uint64_t &file_size) {
+  _filename = fullpath;
+  _writable = writable;
+
+#ifdef _WIN32
+  std::wstring os_specific = fullpath.to_os_specific_w();
+  DWORD access = writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+  DWORD disposition = create ? CREATE_ALWAYS : OPEN_EXISTING;
+  HANDLE file_handle =
+    CreateFileW(os_specific.c_str(), access, FILE_SHARE_READ, nullptr,
+                disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_handle == INVALID_HANDLE_VALUE) {
+    pnmimage_cat.error()
+      << "Unable to open " << fullpath << "\n";
+    return false;
+  }
+  _file_handle = file_handle;
+
+  LARGE_INTEGER size;
+  if (create) {
+    size.QuadPart = (LONGLONG)file_size;
+    if (!SetFilePointerEx(file_handle, size, nullptr, FILE_BEGIN) ||
+        !SetEndOfFile(file_handle)) {
+      pnmimage_cat.error()
+        << "Unable to allocate " << file_size << " bytes for " << fullpath << "\n";
+      return false;
+    }
+  } else {
+    if (!GetFileSizeEx(file_handle, &size)) {
+      return false;
+    }
+    file_size = (uint64_t)size.QuadPart;
+  }
+
+  if (file_size < tile_alignment) {
+    pnmimage_cat.error()
+      << fullpath << " is not a tiled pfm file.\n";
+    return false;
+  }
+
+  _mapping_handle =
+    CreateFileMappingW(file_handle, nullptr,
+                       writable ? PAGE_READWRITE : PAGE_READONLY,
+                       0, 0, nullptr);
+  if (_mapping_handle == nullptr) {
+    pnmimage_cat.error()
+      << "Unable to map " << fullpath << "\n";
+    return false;
+  }
+
+#else
+  std::string os_specific = fullpath.to_os_specific();
+  int flags = writable ? O_RDWR : O_RDONLY;
+  if (create) {
+    flags |= O_CREAT | O_TRUNC;
+  }
+  _fd = ::open(os_specific.c_str(), flags, 0666);
+  if (_fd < 0) {
+    pnmimage_cat.error()
+      << "Unable to open " << fullpath << "\n";
+    return false;
+  }
+
+  if (create) {
+    if (ftruncate(_fd, (off_t)file_size) != 0) {
+      pnmimage_cat.error()
+        << "Unable to allocate " << file_size << " bytes for " << fullpath << "\n";
+      return false;
+    }
+  } else {
+    struct stat st;
+    if (fstat(_fd, &st) != 0) {
+      return false;
+    }
+    file_size = (uint64_t)st.st_size;
+  }
+
+  if (file_size < tile_alignment) {
+    pnmimage_cat.error()
+      << fullpath << " is not a tiled pfm file.\n";
+    return false;
+  }
+#endif
+
+  _header = (Header *)map_region(0, tile_alignment);
+  return (_header != nullptr);
+}
+
+/**
+ * Writes the current image properties into the header of the file.
+ */
+bool PfmTiledFile::
+write_header() {
+  nassertr(_header != nullptr && _writable, false);
+
+  Header &header = *_header;
+  memcpy(header._magic, tiled_magic, sizeof(tiled_magic));
+  header._byte_order = tiled_byte_order;
+  header._version = tiled_version;
+  header._x_size = _x_size;
+  header._y_size = _y_size;
+  header._num_channels = _num_channels;
+  header._tile_size = _tile_size;
+  header._has_no_data_value = _has_no_data_value ? 1 : 0;
+  for (int c = 0; c < 4; ++c) {
+    header._no_data_value[c] = _no_data_value[c];
+  }
+  return true;
+}
+
+/**
+ * Returns a pointer to the data of the indicated tile, mapping it into memory
+ * if necessary and releasing the least-recently-used tiles to stay within the
+ * cache limit.  The pointer remains valid only while _lock is held, which
+ * must be the case on entry.
+ */
+PN_float32 *PfmTiledFile::
+get_tile(int tx, int ty) const {
+  nassertr(tx >= 0 && tx < _num_tiles_x && ty >= 0 && ty < _num_tiles_y, nullptr);
+  int index = ty * _num_tiles_x + tx;
+
+  Tile *tile = _tiles[index];
+  if (tile != nullptr) {
+    // Move it to the front of the LRU list.
+    if (tile != _lru_head) {
+      tile->_prev->_next = tile->_next;
+      if (tile->_next != nullptr) {
+        tile->_next->_prev = tile->_prev;
+      } else {
+        _lru_tail = tile->_prev;
+      }
+      tile->_prev = nullptr;
+      tile->_next = _lru_head;
+      _lru_head->_prev = tile;
+      _lru_head = tile;
+    }
+    return tile->_data;
+  }
+
+  while (_num_cached_tiles > 0 &&
+         (size_t)(_num_cached_tiles + 1) * _tile_bytes > _max_cache_size) {
+    evict_tile();
+  }
+
+  uint64_t offset = tile_alignment + (uint64_t)index * (uint64_t)_tile_bytes;
+  void *data = map_region(offset, _tile_bytes);
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  tile = new Tile;
+  tile->_index = index;
+  tile->_data = (PN_float32 *)data;
+  tile->_prev = nullptr;
+  tile->_next = _lru_head;
+  if (_lru_head != nullptr) {
+    _lru_head->_prev = tile;
+  } else {
+    _lru_tail = tile;
+  }
+  _lru_head = tile;
+  _tiles[index] = tile;
+  ++_num_cached_tiles;
+
+  return tile->_data;
+}
+
+/**
+ * Maps the indicated range of the file into memory.  The offset must be a
+ * multiple of tile_alignment.  Returns nullptr on failure.
+ */
+void *PfmTiledFile::
+map_region(uint64_t offset, size_t size) const {
+#ifdef _WIN32
+  DWORD access = _writable ? FILE_MAP_WRITE : FILE_MAP_READ;
+  void *data = MapViewOfFile(_mapping_handle, access,
+                             (DWORD)(offset >> 32),
+                             (DWORD)(offset & 0xffffffff), size);
+  if (data == nullptr) {
+    pnmimage_cat.error()
+      << "Unable to map " << size << " bytes of " << _filename << "\n";
+  }
+  return data;
+
+#else
+  int prot = _writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  void *data = mmap(nullptr, size, prot, MAP_SHARED, _fd, (off_t)offset);
+  if (data == MAP_FAILED) {
+    pnmimage_cat.error()
+      << "Unable to map " << size << " bytes of " << _filename << "\n";
+    return nullptr;
+  }
+  return data;
+#endif
+}
+
+/**
+ * Releases a range previously returned by map_region().
+ */
+void PfmTiledFile::
+unmap_region(void *data, size_t size) const {
+#ifdef _WIN32
+  UnmapViewOfFile(data);
+#else
+  munmap(data, size);
+#endif
+}
+
+/**
+ * Unmaps the least-recently-used tile.  _lock must be held.
+ */
+void PfmTiledFile::
+evict_tile() const {
+  Tile *tile = _lru_tail;
+  nassertv(tile != nullptr);
+
+  _lru_tail = tile->_prev;
+  if (_lru_tail != nullptr) {
+    _lru_tail->_next = nullptr;
+  } else {
+    _lru_head = nullptr;
+  }
+
+  _tiles[tile->_index] = nullptr;
+  --_num_cached_tiles;
+  unmap_region(tile->_data, _tile_bytes);
+  delete tile;
+}
+
+/**
+ * Unmaps all of the tiles.
+ */
+void PfmTiledFile::
+unmap_all_tiles() const {
+  LightMutexHolder holder(_lock);
+  while (_lru_tail != nullptr) {
+    evict_tile();
+  }
+}
+
+/**
+ * Copies the points of the indicated rectangle into dest, which is an array
+ * of x_size * y_size points.
+ */
+void PfmTiledFile::
+read_region(PN_float32 *dest, int x_begin, int y_begin,
+            int x_size, int y_size) const {
+  int x_end = x_begin + x_size;
+  int y_end = y_begin + y_size;
+  size_t point_size = _num_channels * sizeof(PN_float32);
+
+  LightMutexHolder holder(_lock);
+  for (int ty = y_begin / _tile_size; ty * _tile_size < y_end; ++ty) {
+    int ya = max(y_begin, ty * _tile_size);
+    int yb = min(y_end, (ty + 1) * _tile_size);
+    for (int tx = x_begin / _tile_size; tx * _tile_size < x_end; ++tx) {
+      int xa = max(x_begin, tx * _tile_size);
+      int xb = min(x_end, (tx + 1) * _tile_size);
+      const PN_float32 *tile = get_tile(tx, ty);
+      nassertv(tile != nullptr);
+
+      for (int y = ya; y < yb; ++y) {
+        memcpy(dest + ((size_t)(y - y_begin) * x_size + (xa - x_begin)) * _num_channels,
+               tile + ((size_t)(y - ty * _tile_size) * _tile_size + (xa - tx * _tile_size)) * _num_channels,
+               (xb - xa) * point_size);
+      }
+    }
+  }
+}
+
+/**
+ * Copies an array of x_size * y_size points into the indicated rectangle.
+ */
+void PfmTiledFile::
+write_region(const PN_float32 *source, int x_begin, int y_begin,
+             int x_size, int y_size) {
+  nassertv(_writable);
+  int x_end = x_begin + x_size;
+  int y_end = y_begin + y_size;
+  size_t point_size = _num_channels * sizeof(PN_float32);
+
+  LightMutexHolder holder(_lock);
+  for (int ty = y_begin / _tile_size; ty * _tile_size < y_end; ++ty) {
+    int ya = max(y_begin, ty * _tile_size);
+    int yb = min(y_end, (ty + 1) * _tile_size);
+    for (int tx = x_begin / _tile_size; tx * _tile_size < x_end; ++tx) {
+      int xa = max(x_begin, tx * _tile_size);
+      int xb = min(x_end, (tx + 1) * _tile_size);
+      PN_float32 *tile = get_tile(tx, ty);
+      nassertv(tile != nullptr);
+
+      for (int y = ya; y < yb; ++y) {
+        memcpy(tile + ((size_t)(y - ty * _tile_size) * _tile_size + (xa - tx * _tile_size)) * _num_channels,
+               source + ((size_t)(y - y_begin) * x_size + (xa - x_begin)) * _num_channels,
+               (xb - xa) * point_size);
+      }
+    }
+  }
+}
+
+/**
+ * Creates a temporary file alongside this one with the same tile size,
+ * channels and "no data" value, but the indicated dimensions.
+ */
+bool PfmTiledFile::
+make_temp_file(PfmTiledFile &temp, int x_size, int y_size) const {
+  Filename temp_filename(_filename.get_fullpath() + ".tmp");
+  if (!temp.create(temp_filename, x_size, y_size, _num_channels, _tile_size)) {
+    return false;
+  }
+  temp._max_cache_size = _max_cache_size;
+  if (_has_no_data_value) {
+    temp.set_no_data_value(_no_data_value);
+  }
+  return true;
+}
+
+/**
+ * Closes both files, moves the other file over this one, and reopens it.
+ */
+bool PfmTiledFile::
+replace_with(PfmTiledFile &other) {
+  Filename filename = _filename;
+  Filename other_filename = other._filename;
+  size_t max_cache_size = _max_cache_size;
+
+  other.close();
+  close();
+
+  filename.unlink();
+  if (!other_filename.rename_to(filename)) {
+    pnmimage_cat.error()
+      << "Unable to rename " << other_filename << " to " << filename << "\n";
+    return false;
+  }
+
+  if (!open(filename, true)) {
+    return false;
+  }
+  _max_cache_size = max_cache_size;
+  return true;
+}
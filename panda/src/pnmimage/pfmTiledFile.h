@@ -0,0 +1,183 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pfmTiledFile.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef PFMTILEDFILE_H
+#define PFMTILEDFILE_H
+
+#include "pandabase.h"
+#include "pnmImageHeader.h"
+#include "luse.h"
+#include "filename.h"
+#include "lightMutex.h"
+#include "pvector.h"
+
+class PfmFile;
+
+/**
+ * An out-of-core variant of PfmFile, for float maps that are too large to
+ * hold in memory at once.  The points are kept in a tiled file on disk, and
+ * each tile is memory-mapped only when it is needed; at most
+ * pfm-tile-cache-size bytes of tiles are mapped at any one time, the least
+ * recently used being released first.
+ *
+ * Only a subset of the PfmFile interface is provided.  Operations that
+ * process the whole image stream through it one tile at a time; to apply
+ * any other PfmFile operation, copy a region out with store_sub_image() and
+ * back in again with copy_sub_image().
+ *
+ * The file must be an ordinary file on the local filesystem, not in the VFS,
+ * and it is stored in the native byte order.
+ */
+class EXPCL_PANDA_PNMIMAGE PfmTiledFile : public PNMImageHeader {
+PUBLISHED:
+  PfmTiledFile();
+  ~PfmTiledFile();
+
+public:
+  PfmTiledFile(const PfmTiledFile &copy) = delete;
+  PfmTiledFile &operator = (const PfmTiledFile &copy) = delete;
+
+PUBLISHED:
+  BLOCKING bool create(const Filename &fullpath, int x_size, int y_size,
+                       int num_channels, int tile_size = 0);
+  BLOCKING bool open(const Filename &fullpath, bool writable = false);
+  BLOCKING void close();
+  BLOCKING void flush();
+
+  INLINE bool is_valid() const;
+  INLINE bool is_writable() const;
+  INLINE const Filename &get_filename() const;
+  INLINE int get_tile_size() const;
+  INLINE int get_num_tiles_x() const;
+  INLINE int get_num_tiles_y() const;
+  MAKE_PROPERTY(valid, is_valid);
+  MAKE_PROPERTY(writable, is_writable);
+  MAKE_PROPERTY(filename, get_filename);
+  MAKE_PROPERTY(tile_size, get_tile_size);
+
+  void set_max_cache_size(size_t max_cache_size);
+  INLINE size_t get_max_cache_size() const;
+  int get_num_cached_tiles() const;
+  MAKE_PROPERTY(max_cache_size, get_max_cache_size, set_max_cache_size);
+
+  void set_no_data_value(const LPoint4f &no_data_value);
+  INLINE void set_no_data_value(const LPoint4d &no_data_value);
+  void clear_no_data_value();
+  INLINE bool has_no_data_value() const;
+  INLINE const LPoint4f &get_no_data_value() const;
+
+  bool has_point(int x, int y) const;
+  PN_float32 get_channel(int x, int y, int c) const;
+  void set_channel(int x, int y, int c, PN_float32 value);
+  LPoint3f get_point(int x, int y) const;
+  void set_point(int x, int y, const LVecBase3f &point);
+  INLINE void set_point(int x, int y, const LVecBase3d &point);
+  LPoint4f get_point4(int x, int y) const;
+  void set_point4(int x, int y, const LVecBase4f &point);
+  INLINE void set_point4(int x, int y, const LVecBase4d &point);
+
+  BLOCKING void fill(const LPoint4f &value);
+
+  BLOCKING bool calc_bilinear_point(LPoint3f &result, PN_float32 x, PN_float32 y) const;
+  BLOCKING bool calc_min_max(LVecBase3f &min_points, LVecBase3f &max_points) const;
+
+  BLOCKING bool store_sub_image(PfmFile &result, int xfrom, int yfrom,
+                                int x_size, int y_size) const;
+  BLOCKING void copy_sub_image(const PfmFile &copy, int xto, int yto,
+                               int xfrom = 0, int yfrom = 0,
+                               int x_size = -1, int y_size = -1);
+
+  BLOCKING bool apply_crop(int x_begin, int x_end, int y_begin, int y_end);
+  BLOCKING bool resize(int new_x_size, int new_y_size);
+
+  void output(std::ostream &out) const;
+
+private:
+  // The fixed-size header at the start of the file.
+  class Header {
+  public:
+    char _magic[8];
+    uint32_t _byte_order;
+    uint32_t _version;
+    int32_t _x_size;
+    int32_t _y_size;
+    int32_t _num_channels;
+    int32_t _tile_size;
+    int32_t _has_no_data_value;
+    PN_float32 _no_data_value[4];
+  };
+
+  // One currently-mapped tile, linked into the LRU list.
+  class Tile {
+  public:
+    int _index;
+    PN_float32 *_data;
+    Tile *_prev;
+    Tile *_next;
+  };
+
+  bool open_file(const Filename &fullpath, bool writable, bool create,
+                 uint64_t &file_size);
+  bool write_header();
+
+  PN_float32 *get_tile(int tx, int ty) const;
+  void *map_region(uint64_t offset, size_t size) const;
+  void unmap_region(void *data, size_t size) const;
+  void evict_tile() const;
+  void unmap_all_tiles() const;
+
+  INLINE bool has_point_data(const PN_float32 *p) const;
+
+  void read_region(PN_float32 *dest, int x_begin, int y_begin,
+                   int x_size, int y_size) const;
+  void write_region(const PN_float32 *source, int x_begin, int y_begin,
+                    int x_size, int y_size);
+  bool replace_with(PfmTiledFile &other);
+  bool make_temp_file(PfmTiledFile &temp, int x_size, int y_size) const;
+
+private:
+  Filename _filename;
+  bool _writable;
+  int _tile_size;
+  int _num_tiles_x;
+  int _num_tiles_y;
+  size_t _tile_bytes;
+
+  bool _has_no_data_value;
+  LPoint4f _no_data_value;
+
+#ifdef _WIN32
+  void *_file_handle;
+  void *_mapping_handle;
+#else
+  int _fd;
+#endif
+  Header *_header;
+
+  // All of the tile cache is protected by _lock.
+  size_t _max_cache_size;
+  mutable LightMutex _lock;
+  mutable pvector<Tile *> _tiles;
+  mutable Tile *_lru_head;
+  mutable Tile *_lru_tail;
+  mutable int _num_cached_tiles;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const PfmTiledFile &file) {
+  file.output(out);
+  return out;
+}
+
+#include "pfmTiledFile.I"
+
+#endif
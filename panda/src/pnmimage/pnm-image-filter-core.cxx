@@ -21,68 +21,144 @@ FUNCTION_NAME(IMAGETYPE &dest, const IMAGETYPE &source,
     return;
   }
 
+  // Each pass below is split into runs of rows that may be processed on
+  // separate threads, so the state shared by a pass is gathered up in this
+  // structure.  Each run filters four rows at a time where it can.
+  struct Pass {
+    IMAGETYPE *_dest;
+    const IMAGETYPE *_source;
+    int _channel;
+    StoreType **_matrix;
+    const FilterKernel *_kernel;
+
+    // Scales source rows [begin, end) in the A direction, into the matrix.
+    static void
+    filter_a(void *data, int begin, int end) {
+      const Pass &pass = *(const Pass *)data;
+      const IMAGETYPE &source = *pass._source;
+      int source_size = source.ASIZE();
+      int dest_size = pass._kernel->_dest_len;
+
+      StoreType *temp_source = (StoreType *)PANDA_MALLOC_ARRAY(source_size * 4 * sizeof(StoreType));
+      StoreType *temp_dest = (StoreType *)PANDA_MALLOC_ARRAY(dest_size * 4 * sizeof(StoreType));
+
+      int a, b, r;
+      for (b = begin; b + 4 <= end; b += 4) {
+        for (a = 0; a < source_size; a++) {
+          for (r = 0; r < 4; r++) {
+            temp_source[a * 4 + r] = (StoreType)(source_max * source.GETVAL(a, b + r, pass._channel));
+          }
+        }
+
+        filter_rows4(temp_dest, temp_source, *pass._kernel);
+
+        for (a = 0; a < dest_size; a++) {
+          for (r = 0; r < 4; r++) {
+            pass._matrix[a][b + r] = temp_dest[a * 4 + r];
+          }
+        }
+      }
+
+      for (; b < end; b++) {
+        for (a = 0; a < source_size; a++) {
+          temp_source[a] = (StoreType)(source_max * source.GETVAL(a, b, pass._channel));
+        }
+
+        filter_row(temp_dest, temp_source, *pass._kernel);
+
+        for (a = 0; a < dest_size; a++) {
+          pass._matrix[a][b] = temp_dest[a];
+        }
+      }
+
+      PANDA_FREE_ARRAY(temp_source);
+      PANDA_FREE_ARRAY(temp_dest);
+    }
+
+    // Scales matrix columns [begin, end) in the B direction, into the
+    // destination image.
+    static void
+    filter_b(void *data, int begin, int end) {
+      const Pass &pass = *(const Pass *)data;
+      IMAGETYPE &dest = *pass._dest;
+      int source_size = pass._source->BSIZE();
+      int dest_size = pass._kernel->_dest_len;
+
+      StoreType *temp_source = (StoreType *)PANDA_MALLOC_ARRAY(source_size * 4 * sizeof(StoreType));
+      StoreType *temp_dest = (StoreType *)PANDA_MALLOC_ARRAY(dest_size * 4 * sizeof(StoreType));
+
+      int a, b, r;
+      for (a = begin; a + 4 <= end; a += 4) {
+        for (b = 0; b < source_size; b++) {
+          for (r = 0; r < 4; r++) {
+            temp_source[b * 4 + r] = pass._matrix[a + r][b];
+          }
+        }
+
+        filter_rows4(temp_dest, temp_source, *pass._kernel);
+
+        for (r = 0; r < 4; r++) {
+          for (b = 0; b < dest_size; b++) {
+            dest.SETVAL(a + r, b, pass._channel, (float)temp_dest[b * 4 + r]/(float)source_max);
+          }
+        }
+      }
+
+      for (; a < end; a++) {
+        filter_row(temp_dest, pass._matrix[a], *pass._kernel);
+
+        for (b = 0; b < dest_size; b++) {
+          dest.SETVAL(a, b, pass._channel, (float)temp_dest[b]/(float)source_max);
+        }
+      }
+
+      PANDA_FREE_ARRAY(temp_source);
+      PANDA_FREE_ARRAY(temp_dest);
+    }
+  };
+
   // First, set up a 2-d column-major matrix of StoreTypes, big enough to hold
   // the image xelvals scaled in the A direction only.  This will hold the
   // adjusted xel data from our first pass.
 
   StoreType **matrix = (StoreType **)PANDA_MALLOC_ARRAY(dest.ASIZE() * sizeof(StoreType *));
 
-  int a, b;
+  int a;
 
   for (a=0; a<dest.ASIZE(); a++) {
     matrix[a] = (StoreType *)PANDA_MALLOC_ARRAY(source.BSIZE() * sizeof(StoreType));
   }
 
+  Pass pass;
+  pass._dest = &dest;
+  pass._source = &source;
+  pass._channel = channel;
+  pass._matrix = matrix;
+
   // First, scale the image in the A direction.
   float scale;
-  StoreType *temp_source, *temp_dest;
-
-  scale = (float)dest.ASIZE() / (float)source.ASIZE();
-  temp_source = (StoreType *)PANDA_MALLOC_ARRAY(source.ASIZE() * sizeof(StoreType));
-  temp_dest = (StoreType *)PANDA_MALLOC_ARRAY(dest.ASIZE() * sizeof(StoreType));
-
   WorkType *filter;
   float filter_width;
 
+  scale = (float)dest.ASIZE() / (float)source.ASIZE();
   make_filter(scale, width, filter, filter_width);
-
-  for (b = 0; b < source.BSIZE(); b++) {
-    for (a = 0; a < source.ASIZE(); a++) {
-      temp_source[a] = (StoreType)(source_max * source.GETVAL(a, b, channel));
-    }
-
-    filter_row(temp_dest, dest.ASIZE(),
-               temp_source, source.ASIZE(),
-               scale,
-               filter, filter_width);
-
-    for (a = 0; a < dest.ASIZE(); a++) {
-      matrix[a][b] = temp_dest[a];
-    }
+  {
+    FilterKernel kernel(dest.ASIZE(), source.ASIZE(), scale, filter, filter_width);
+    pass._kernel = &kernel;
+    PNMParallelRows::run(source.BSIZE(), kernel._weights.size() + source.ASIZE(),
+                         &Pass::filter_a, &pass);
   }
-
-  PANDA_FREE_ARRAY(temp_source);
-  PANDA_FREE_ARRAY(temp_dest);
   PANDA_FREE_ARRAY(filter);
 
   // Now, scale the image in the B direction.
   scale = (float)dest.BSIZE() / (float)source.BSIZE();
-  temp_dest = (StoreType *)PANDA_MALLOC_ARRAY(dest.BSIZE() * sizeof(StoreType));
-
   make_filter(scale, width, filter, filter_width);
-
-  for (a = 0; a < dest.ASIZE(); a++) {
-    filter_row(temp_dest, dest.BSIZE(),
-               matrix[a], source.BSIZE(),
-               scale,
-               filter, filter_width);
-
-    for (b = 0; b < dest.BSIZE(); b++) {
-      dest.SETVAL(a, b, channel, (float)temp_dest[b]/(float)source_max);
-    }
+  {
+    FilterKernel kernel(dest.BSIZE(), source.BSIZE(), scale, filter, filter_width);
+    pass._kernel = &kernel;
+    PNMParallelRows::run(dest.ASIZE(), kernel._weights.size() + dest.BSIZE(),
+                         &Pass::filter_b, &pass);
   }
-
-  PANDA_FREE_ARRAY(temp_dest);
   PANDA_FREE_ARRAY(filter);
 
   // Now, clean up our temp matrix and go home!
@@ -0,0 +1,91 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pnmParallelRows.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pnmParallelRows.h"
+#include "config_pnmimage.h"
+
+#include <thread>
+
+// Below this many units of work (roughly, source samples touched), it is not
+// worth waking up the worker threads.
+static const size_t min_parallel_work = 256 * 1024;
+
+WorkerThreadPool *PNMParallelRows::_pool = nullptr;
+Mutex PNMParallelRows::_pool_lock("PNMParallelRows");
+
+/**
+ * Calls func(data, begin, end) for contiguous ranges of rows that together
+ * cover [0, num_rows), possibly on several threads at once, and returns when
+ * all of them have finished.  work_per_row is a rough measure of the cost of
+ * each row, used to decide whether threading is worthwhile.
+ */
+void PNMParallelRows::
+run(int num_rows, size_t work_per_row, RowFunc *func, void *data) {
+  if (num_rows <= 0) {
+    return;
+  }
+
+  int num_threads = get_num_threads();
+  if (num_threads <= 1 || num_rows <= 1 ||
+      (size_t)num_rows * work_per_row < min_parallel_work) {
+    (*func)(data, 0, num_rows);
+    return;
+  }
+
+  // The pool can run only one job at a time.  If another thread is using it,
+  // we don't wait for it to finish, but do all of the work here.
+  if (!_pool_lock.try_lock()) {
+    (*func)(data, 0, num_rows);
+    return;
+  }
+
+  if (_pool == nullptr) {
+    _pool = new WorkerThreadPool("pnm-filter");
+  }
+  _pool->set_num_threads(num_threads);
+
+  Job job;
+  job._func = func;
+  job._data = data;
+  _pool->run(num_rows, 1, &range_func, &job);
+
+  _pool_lock.unlock();
+}
+
+/**
+ * Returns the number of threads that run() will use for a sufficiently large
+ * job.
+ */
+int PNMParallelRows::
+get_num_threads() {
+  if (!Thread::is_true_threads()) {
+    return 1;
+  }
+
+  int num_threads = pnm_filter_threads;
+  if (num_threads > 0) {
+    return num_threads;
+  }
+
+  // 0 means to use one thread per logical CPU.
+  return std::max((int)std::thread::hardware_concurrency(), 1);
+}
+
+/**
+ * The function run by the WorkerThreadPool for each range of rows.
+ */
+void PNMParallelRows::
+range_func(void *data, int thread_index, size_t begin, size_t end) {
+  const Job *job = (const Job *)data;
+  (*job->_func)(job->_data, (int)begin, (int)end);
+}
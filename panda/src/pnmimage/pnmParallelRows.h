@@ -0,0 +1,56 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pnmParallelRows.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef PNMPARALLELROWS_H
+#define PNMPARALLELROWS_H
+
+#include "pandabase.h"
+#include "workerThreadPool.h"
+#include "pmutex.h"
+
+/**
+ * A helper used by the PNMImage and PfmFile filter operations to split a loop
+ * over the rows of an image among several threads.  Each thread is handed a
+ * contiguous range of rows; the function must not write to any row outside
+ * its own range, but it may read anywhere in its source image.
+ *
+ * The number of threads is controlled by the pnm-filter-threads config
+ * variable.  Small images, and builds without true threads, always run on
+ * the calling thread.  The rows are divided among the threads of a shared
+ * WorkerThreadPool; if another thread is already using it, the work is done
+ * on the calling thread instead.
+ */
+class EXPCL_PANDA_PNMIMAGE PNMParallelRows {
+public:
+  typedef void RowFunc(void *data, int begin, int end);
+
+  static void run(int num_rows, size_t work_per_row,
+                  RowFunc *func, void *data);
+
+  static int get_num_threads();
+
+private:
+  class Job {
+  public:
+    RowFunc *_func;
+    void *_data;
+  };
+
+  static void range_func(void *data, int thread_index,
+                         size_t begin, size_t end);
+
+  static WorkerThreadPool *_pool;
+  static Mutex _pool_lock;
+};
+
+#endif
@@ -18,6 +18,7 @@
 #include "config_pnmtext.h"
 
 FT_Library FreetypeFace::_ft_library;
+Mutex FreetypeFace::_ft_library_lock("FreetypeFace::_ft_library_lock");
 bool FreetypeFace::_ft_initialized = false;
 bool FreetypeFace::_ft_ok = false;
 
@@ -29,6 +30,9 @@ TypeHandle FreetypeFace::_type_handle;
 FreetypeFace::
 FreetypeFace() : _lock("FreetypeFace::_lock") {
   _face = nullptr;
+  _face_data = nullptr;
+  _face_data_length = 0;
+  _face_index = 0;
   _char_size = 0;
   _dpi = 0;
   _pixel_width = 0;
@@ -45,6 +49,7 @@ FreetypeFace() : _lock("FreetypeFace::_lock") {
 FreetypeFace::
 ~FreetypeFace() {
   if (_face != nullptr){
+    MutexHolder holder(_ft_library_lock);
     FT_Done_Face(_face);
   }
 }
@@ -102,6 +107,7 @@ set_face(FT_Face face) {
   MutexHolder holder(_lock);
 
   if (_face != nullptr){
+    MutexHolder library_holder(_ft_library_lock);
     FT_Done_Face(_face);
   }
   _face = face;
@@ -148,6 +154,44 @@ set_face(FT_Face face) {
   }
 }
 
+/**
+ * Returns a new FreetypeFace that opens the same font data as this one, but
+ * with its own FT_Face, so that glyphs can be rendered from it in a different
+ * thread at the same time.  Returns NULL if the font data is not available.
+ */
+PT(FreetypeFace) FreetypeFace::
+make_copy() const {
+  if (_face == nullptr || _face_data == nullptr) {
+    return nullptr;
+  }
+
+  // FreeType requires that faces are not created or destroyed concurrently
+  // within the same library.
+  FT_Face face = nullptr;
+  int error;
+  {
+    MutexHolder holder(_ft_library_lock);
+    error = FT_New_Memory_Face(_ft_library, (const FT_Byte *)_face_data,
+                               _face_data_length, _face_index, &face);
+  }
+  if (error || face == nullptr) {
+    return nullptr;
+  }
+
+  if (face->charmap == nullptr && face->num_charmaps > 0) {
+    FT_Set_Charmap(face, face->charmaps[0]);
+  }
+
+  PT(FreetypeFace) copy = new FreetypeFace;
+  copy->_face = face;
+  copy->_name = _name;
+  copy->_face_data = _face_data;
+  copy->_face_data_length = _face_data_length;
+  copy->_face_index = _face_index;
+  copy->_source = (_source != nullptr) ? _source.p() : this;
+  return copy;
+}
+
 /**
  * Should be called exactly once to initialize the FreeType library.
  */
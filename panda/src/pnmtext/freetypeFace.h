@@ -40,6 +40,7 @@ public:
   void release_face(FT_Face face);
 
   void set_face(FT_Face face);
+  PT(FreetypeFace) make_copy() const;
 
 private:
   static void initialize_ft_library();
@@ -48,6 +49,13 @@ private:
   // This is provided as a permanent storage for the raw font data, if needed.
   std::string _font_data;
 
+  // The data the face was loaded from, so that it can be opened again by
+  // make_copy().  If this face is a copy, _source keeps the data alive.
+  const char *_face_data;
+  size_t _face_data_length;
+  int _face_index;
+  CPT(FreetypeFace) _source;
+
   std::string _name;
   FT_Face _face;
   int _char_size;
@@ -57,6 +65,7 @@ private:
   Mutex _lock;
 
   static FT_Library _ft_library;
+  static Mutex _ft_library_lock;
   static bool _ft_initialized;
   static bool _ft_ok;
 
@@ -109,12 +109,18 @@ load_font(const Filename &font_filename, int face_index) {
   exists = vfs->read_file(path, _face->_font_data, true);
   if (exists) {
     FT_Face face = 0;
-    error = FT_New_Memory_Face(_face->_ft_library,
-                               (const FT_Byte *)_face->_font_data.data(),
-                               _face->_font_data.length(),
-                               face_index, &face);
+    {
+      MutexHolder holder(FreetypeFace::_ft_library_lock);
+      error = FT_New_Memory_Face(_face->_ft_library,
+                                 (const FT_Byte *)_face->_font_data.data(),
+                                 _face->_font_data.length(),
+                                 face_index, &face);
+    }
     if (face) {
       _face->set_face(face);
+      _face->_face_data = _face->_font_data.data();
+      _face->_face_data_length = _face->_font_data.length();
+      _face->_face_index = face_index;
     }
   }
 
@@ -160,10 +166,16 @@ load_font(const char *font_data, int data_length, int face_index) {
 
   int error;
   FT_Face face;
-  error = FT_New_Memory_Face(_face->_ft_library,
-                             (const FT_Byte *)font_data, data_length,
-                             face_index, &face);
+  {
+    MutexHolder holder(FreetypeFace::_ft_library_lock);
+    error = FT_New_Memory_Face(_face->_ft_library,
+                               (const FT_Byte *)font_data, data_length,
+                               face_index, &face);
+  }
   _face->set_face(face);
+  _face->_face_data = font_data;
+  _face->_face_data_length = data_length;
+  _face->_face_index = face_index;
 
   bool okflag = false;
   if (error == FT_Err_Unknown_File_Format) {
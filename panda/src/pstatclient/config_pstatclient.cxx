@@ -108,6 +108,14 @@ ConfigVariableBool pstats_mem_other
           "the total into a single \"Other\" category, or false to show "
           "each nonzero memory category."));
 
+ConfigVariableBool pstats_deleted_chains
+("pstats-deleted-chains", false,
+ PRC_DESC("Set this true to report, for each size of buffer managed by a "
+          "DeletedChain, how often the threads had to lock the shared chain "
+          "to take or return buffers, and how many free buffers it holds.  "
+          "This is useful for spotting allocation contention between "
+          "threads."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -45,6 +45,7 @@ extern EXPCL_PANDA_PSTATCLIENT ConfigVariableDouble pstats_history;
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableDouble pstats_average_time;
 
 extern EXPCL_PANDA_PSTATCLIENT ConfigVariableBool pstats_mem_other;
+extern EXPCL_PANDA_PSTATCLIENT ConfigVariableBool pstats_deleted_chains;
 
 extern EXPCL_PANDA_PSTATCLIENT void init_libpstatclient();
 
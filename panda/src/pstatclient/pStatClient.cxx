@@ -26,6 +26,7 @@
 #include "thread.h"
 #include "clockObject.h"
 #include "neverFreeMemory.h"
+#include "deletedBufferChain.h"
 
 using std::string;
 
@@ -58,6 +59,19 @@ public:
 typedef pvector<TypeHandleCollector> TypeHandleCols;
 static TypeHandleCols type_handle_cols;
 
+// This class is used to report the activity of each DeletedBufferChain.  We
+// create one of these for each chain, as it turns up.
+class DeletedChainCollector {
+public:
+  DeletedChainCollector() : _last_locks(0) {}
+
+  PStatCollector _locks;
+  PStatCollector _free;
+  size_t _last_locks;
+};
+typedef pvector<DeletedChainCollector> DeletedChainCols;
+static DeletedChainCols deleted_chain_cols;
+
 
 /**
  *
@@ -378,6 +392,33 @@ main_tick() {
   }
 #endif  // DO_MEMORY_USAGE
 
+  if (pstats_deleted_chains && is_connected()) {
+    size_t num_chains = DeletedBufferChain::get_num_chains();
+    while (deleted_chain_cols.size() < num_chains) {
+      deleted_chain_cols.push_back(DeletedChainCollector());
+    }
+
+    for (size_t i = 0; i < num_chains; ++i) {
+      DeletedBufferChain *chain = DeletedBufferChain::get_chain(i);
+      DeletedChainCollector &cols = deleted_chain_cols[i];
+
+      // Report the number of times the shared chain was locked since the
+      // last frame, but don't bother with chains that have never been used.
+      size_t locks = chain->get_num_refills() + chain->get_num_flushes();
+      if (locks != 0 && !cols._locks.is_valid()) {
+        std::ostringstream strm;
+        strm << chain->get_buffer_size() << " bytes";
+        cols._locks = PStatCollector("Deleted chain locks:" + strm.str());
+        cols._free = PStatCollector("Deleted chain free:" + strm.str());
+      }
+      if (cols._locks.is_valid()) {
+        cols._locks.set_level(locks - cols._last_locks);
+        cols._free.set_level(chain->get_num_free());
+        cols._last_locks = locks;
+      }
+    }
+  }
+
   get_global_pstats()->client_main_tick();
 }
 
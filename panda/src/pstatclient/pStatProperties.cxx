@@ -209,6 +209,8 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Vertex Data:Disk",                 { 0.6, 0.9, 0.1 } },
   { 1, "Vertex Data:Disk:Unused",          { 0.8, 0.4, 0.5 } },
   { 1, "Vertex Data:Disk:Used",            { 0.2, 0.1, 0.6 } },
+  { 1, "Texture pool",                     { 0.8, 0.5, 0.9 },  "MB", 64, 1048576 },
+  { 1, "Model pool",                       { 0.4, 0.7, 0.9 },  "MB", 64, 1048576 },
   { 1, "TransformStates",                  { 1.0, 0.5, 0.5 },  "", 5000 },
   { 1, "TransformStates:On nodes",         { 0.2, 0.8, 1.0 } },
   { 1, "TransformStates:Cached",           { 1.0, 0.0, 0.2 } },
@@ -221,7 +223,12 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Dirty PipelineCyclers",            { 0.2, 0.2, 0.2 },  "", 5000 },
   { 1, "Collision Volumes",                { 1.0, 0.8, 0.5 },  "", 500 },
   { 1, "Collision Tests",                  { 0.5, 0.8, 1.0 },  "", 100 },
+  { 1, "Deleted chain locks",              { 0.8, 0.6, 0.2 },  "", 1000 },
+  { 1, "Deleted chain free",               { 0.3, 0.6, 0.6 },  "", 5000 },
   { 1, "Command latency",                  { 0.8, 0.2, 0.0 },  "ms", 10, 1.0 / 1000.0 },
+  { 1, "Pipeline cycle",                   { 0.6, 0.4, 0.8 },  "ms", 5, 1.0 / 1000.0 },
+  { 1, "Pipeline cycle:Copy",              { 0.2, 0.6, 0.9 } },
+  { 1, "Pipeline cycle:Release",           { 0.9, 0.5, 0.3 } },
   { 0, nullptr }
 };
 
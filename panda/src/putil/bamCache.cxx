@@ -26,8 +26,10 @@
 #include "configVariableString.h"
 #include "configVariableFilename.h"
 #include "virtualFileSystem.h"
+#include "mutexHolder.h"
 
 using std::istream;
+using std::istringstream;
 using std::ostream;
 using std::ostringstream;
 using std::string;
@@ -42,7 +44,11 @@ BamCache() :
   _active(true),
   _read_only(false),
   _index(new BamCacheIndex),
-  _index_stale_since(0)
+  _index_stale_since(0),
+  _index_seq(0),
+  _write_cv(_write_lock),
+  _flush_requested(false),
+  _writer_shutdown(false)
 {
   ConfigVariableFilename model_cache_dir
     ("model-cache-dir", Filename(),
@@ -86,6 +92,14 @@ BamCache() :
     ("model-cache-max-kbytes", 10485760,
      PRC_DESC("This is the maximum size of the model cache, in kilobytes."));
 
+  ConfigVariableBool model_cache_async_writes
+    ("model-cache-async-writes", true,
+     PRC_DESC("If this is true, and threading is available, files are "
+              "written to the model cache, and the model-cache index is "
+              "flushed, by a background thread, so that the thread that "
+              "loaded the model or texture doesn't have to wait for the "
+              "disk.  If this is false, they are written right away."));
+
   _cache_models = model_cache_models;
   _cache_textures = model_cache_textures;
   _cache_compressed_textures = model_cache_compressed_textures;
@@ -93,6 +107,7 @@ BamCache() :
 
   _flush_time = model_cache_flush;
   _max_kbytes = model_cache_max_kbytes;
+  _async_writes = model_cache_async_writes;
 
   if (!model_cache_dir.empty()) {
     set_root(model_cache_dir);
@@ -105,6 +120,7 @@ BamCache() :
 BamCache::
 ~BamCache() {
   flush_index();
+  stop_writer_thread();
   delete _index;
   _index = nullptr;
 }
@@ -120,29 +136,34 @@ BamCache::
  */
 void BamCache::
 set_root(const Filename &root) {
-  ReMutexHolder holder(_lock);
   flush_index();
-  _root = root;
+  {
+    ReMutexHolder holder(_lock);
+    _root = root;
 
-  // The root filename must be a directory.
-  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-  if (!vfs->is_directory(_root)) {
-    vfs->make_directory_full(_root);
-  }
+    // The root filename must be a directory.
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    if (!vfs->is_directory(_root)) {
+      vfs->make_directory_full(_root);
+    }
 
-  delete _index;
-  _index = new BamCacheIndex;
-  _index_stale_since = 0;
+    delete _index;
+    _index = new BamCacheIndex;
+    _index_stale_since = 0;
 
-  if (!vfs->is_directory(_root)) {
-    util_cat.error()
-      << "Unable to make directory " << _root << ", caching disabled.\n";
-    _active = false;
-    return;
+    if (!vfs->is_directory(_root)) {
+      util_cat.error()
+        << "Unable to make directory " << _root << ", caching disabled.\n";
+      _active = false;
+      return;
+    }
+
+    read_index();
+    check_cache_size();
   }
 
-  read_index();
-  check_cache_size();
+  // If the index had to be rebuilt, write it out now.
+  flush_index();
 }
 
 /**
@@ -163,7 +184,6 @@ set_root(const Filename &root) {
  */
 PT(BamCacheRecord) BamCache::
 lookup(const Filename &source_filename, const string &cache_extension) {
-  ReMutexHolder holder(_lock);
   consider_flush_index();
 
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
@@ -171,8 +191,9 @@ lookup(const Filename &source_filename, const string &cache_extension) {
   Filename source_pathname(source_filename);
   source_pathname.make_absolute(vfs->get_cwd());
 
+  Filename root = get_root();
   Filename rel_pathname(source_pathname);
-  rel_pathname.make_relative_to(_root, false);
+  rel_pathname.make_relative_to(root, false);
   if (rel_pathname.is_local()) {
     // If the source pathname is already within the cache directory, don't
     // cache it further.
@@ -182,23 +203,32 @@ lookup(const Filename &source_filename, const string &cache_extension) {
   Filename cache_filename = hash_filename(source_pathname.get_fullpath());
   cache_filename.set_extension(cache_extension);
 
-  return find_and_read_record(source_pathname, cache_filename);
+  return find_and_read_record(source_pathname, root, cache_filename);
 }
 
 /**
  * Flushes a cache entry to disk.  You must have retrieved the cache record
  * via a prior call to lookup(), and then stored the data via
  * record->set_data().  Returns true on success, false on failure.
+ *
+ * The record is encoded right away, so the caller is free to modify the
+ * object afterwards; but when model-cache-async-writes is in effect, the file
+ * is written later by the writer thread, and this returns true as soon as it
+ * has been queued.  A lookup() of the same file in the meantime finds the
+ * queued record.
  */
 bool BamCache::
 store(BamCacheRecord *record) {
-  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-  ReMutexHolder holder(_lock);
   nassertr(!record->_cache_pathname.empty(), false);
   nassertr(record->has_data(), false);
 
-  if (_read_only) {
-    return false;
+  Filename root;
+  {
+    ReMutexHolder holder(_lock);
+    if (_read_only) {
+      return false;
+    }
+    root = _root;
   }
 
   consider_flush_index();
@@ -206,7 +236,7 @@ store(BamCacheRecord *record) {
 #ifndef NDEBUG
   // Ensure that the cache_pathname is within the _root directory tree.
   Filename rel_pathname(record->_cache_pathname);
-  rel_pathname.make_relative_to(_root, false);
+  rel_pathname.make_relative_to(root, false);
   nassertr(rel_pathname.is_local(), false);
 #endif  // NDEBUG
 
@@ -214,28 +244,13 @@ store(BamCacheRecord *record) {
 
   Filename cache_pathname = Filename::binary_filename(record->_cache_pathname);
 
-  // We actually do the write to a temporary filename first, and then move it
-  // into place, so that no one attempts to read the file while it is in the
-  // process of being written.
-  Thread *current_thread = Thread::get_current_thread();
-  string extension = current_thread->get_unique_id() + string(".tmp");
-  Filename temp_pathname = cache_pathname;
-  temp_pathname.set_extension(extension);
-  temp_pathname.set_binary();
-
+  // We encode the record into memory first; only the writing of the bytes to
+  // disk may be deferred to the writer thread.
+  ostringstream strm;
   DatagramOutputFile dout;
-  if (!dout.open(temp_pathname)) {
+  if (!dout.open(strm, cache_pathname) || !dout.write_header(_bam_header)) {
     util_cat.error()
-      << "Could not write cache file: " << temp_pathname << "\n";
-    vfs->delete_file(temp_pathname);
-    emergency_read_only();
-    return false;
-  }
-
-  if (!dout.write_header(_bam_header)) {
-    util_cat.error()
-      << "Unable to write to " << temp_pathname << "\n";
-    vfs->delete_file(temp_pathname);
+      << "Unable to encode cache file " << cache_pathname << "\n";
     return false;
   }
 
@@ -243,8 +258,7 @@ store(BamCacheRecord *record) {
     BamWriter writer(&dout);
     if (!writer.init()) {
       util_cat.error()
-        << "Unable to write Bam header to " << temp_pathname << "\n";
-      vfs->delete_file(temp_pathname);
+        << "Unable to write Bam header to " << cache_pathname << "\n";
       return false;
     }
 
@@ -266,15 +280,13 @@ store(BamCacheRecord *record) {
 
     if (!writer.write_object(record)) {
       util_cat.error()
-        << "Unable to write object to " << temp_pathname << "\n";
-      vfs->delete_file(temp_pathname);
+        << "Unable to write object to " << cache_pathname << "\n";
       return false;
     }
 
     if (!writer.write_object(record->get_data())) {
       util_cat.error()
-        << "Unable to write object data to " << temp_pathname << "\n";
-      vfs->delete_file(temp_pathname);
+        << "Unable to write object data to " << cache_pathname << "\n";
       return false;
     }
 
@@ -286,21 +298,26 @@ store(BamCacheRecord *record) {
   record->_record_size = dout.get_file_pos();
   dout.close();
 
-  // Now move the file into place.
-  if (!vfs->rename_file(temp_pathname, cache_pathname) && vfs->exists(temp_pathname)) {
-    vfs->delete_file(cache_pathname);
-    if (!vfs->rename_file(temp_pathname, cache_pathname)) {
-      util_cat.error()
-        << "Unable to rename " << temp_pathname << " to "
-        << cache_pathname << "\n";
-      vfs->delete_file(temp_pathname);
-      return false;
+  PT(PendingWrite) pending = new PendingWrite;
+  pending->_record = record->make_copy();
+  pending->_root = root;
+  pending->_cache_pathname = cache_pathname;
+  pending->_data = strm.str();
+
+  if (_async_writes && Thread::is_threading_supported()) {
+    MutexHolder holder(_write_lock);
+    if (_writer_thread == nullptr) {
+      start_writer_thread();
+    }
+    if (_writer_thread != nullptr) {
+      _write_queue.push_back(pending);
+      _pending_writes[record->get_source_pathname()] = pending;
+      _write_cv.notify_all();
+      return true;
     }
   }
 
-  add_to_index(record);
-
-  return true;
+  return do_write_record(pending);
 }
 
 /**
@@ -317,7 +334,8 @@ emergency_read_only() {
 
 /**
  * Flushes the index if enough time has elapsed since the index was last
- * flushed.
+ * flushed.  When model-cache-async-writes is in effect, this only asks the
+ * writer thread to do it.
  */
 void BamCache::
 consider_flush_index() {
@@ -329,68 +347,129 @@ consider_flush_index() {
   }
 #endif
 
+  bool due = false;
   if (_index_stale_since != 0) {
     int elapsed = (int)time(nullptr) - (int)_index_stale_since;
-    if (elapsed > _flush_time) {
-      flush_index();
-    }
+    due = (elapsed > _flush_time);
   }
 
 #if defined(HAVE_THREADS) || defined(DEBUG_THREADS)
   _lock.unlock();
 #endif
+
+  if (!due) {
+    return;
+  }
+
+  if (_async_writes && Thread::is_threading_supported()) {
+    MutexHolder holder(_write_lock);
+    if (_writer_thread == nullptr) {
+      start_writer_thread();
+    }
+    if (_writer_thread != nullptr) {
+      _flush_requested = true;
+      _write_cv.notify_all();
+      return;
+    }
+  }
+
+  do_flush_index();
 }
 
 /**
- * Ensures the index is written to disk.
+ * Ensures the index is written to disk, after first waiting for any cache
+ * files that are still waiting to be written.
  */
 void BamCache::
 flush_index() {
-  ReMutexHolder holder(_lock);
-  if (_index_stale_since == 0) {
-    // Never mind.
-    return;
+  wait_for_writes();
+  do_flush_index();
+}
+
+/**
+ * Waits for the writer thread to finish writing all of the cache files that
+ * have been passed to store() so far.  This is only necessary when
+ * model-cache-async-writes is in effect, and another process is expected to
+ * read the files.
+ */
+void BamCache::
+wait_for_writes() {
+  MutexHolder holder(_write_lock);
+  while (!_write_queue.empty()) {
+    _write_cv.wait();
   }
+}
 
-  while (true) {
-    if (_read_only) {
-      return;
-    }
+/**
+ * Writes the index to disk, if it has changed.  The index is copied first, so
+ * that lookups and stores need not wait while it is being written.
+ */
+void BamCache::
+do_flush_index() {
+  MutexHolder flush_holder(_flush_lock);
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+
+  _lock.acquire();
+  while (_index_stale_since != 0 && !_read_only) {
+    BamCacheIndex *snapshot = new BamCacheIndex;
+    snapshot->_records = _index->_records;
+    unsigned int index_seq = _index_seq;
+    Filename root = _root;
+    Filename old_index_pathname = _index_pathname;
+    string old_index = _index_ref_contents;
+    _lock.release();
 
-    Filename temp_pathname = Filename::temporary(_root, "index-", ".boo");
+    Filename temp_pathname = Filename::temporary(root, "index-", ".boo");
+    bool written = do_write_index(temp_pathname, snapshot);
 
-    if (!do_write_index(temp_pathname, _index)) {
-      emergency_read_only();
-      return;
-    }
+    // The records belong to the real index; don't let the snapshot's
+    // destructor unlink them.
+    snapshot->_records.clear();
+    delete snapshot;
 
     // Now atomically write the name of this index file to the index reference
     // file.
-    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-    Filename index_ref_pathname(_root, Filename("index_name.txt"));
-    string old_index = _index_ref_contents;
+    Filename index_ref_pathname(root, Filename("index_name.txt"));
     string new_index = temp_pathname.get_basename() + "\n";
     string orig_index;
+    bool exchanged = false;
+    if (written) {
+      exchanged = vfs->atomic_compare_and_exchange_contents(index_ref_pathname, orig_index, old_index, new_index);
+      if (exchanged) {
+        // We successfully wrote our version of the index, and no other
+        // process beat us to it.  Our index is now the official one.  Remove
+        // the old index.
+        vfs->delete_file(old_index_pathname);
+      } else {
+        vfs->delete_file(temp_pathname);
+      }
+    }
 
-    if (vfs->atomic_compare_and_exchange_contents(index_ref_pathname, orig_index, old_index, new_index)) {
-      // We successfully wrote our version of the index, and no other process
-      // beat us to it.  Our index is now the official one.  Remove the old
-      // index.
-      vfs->delete_file(_index_pathname);
+    _lock.acquire();
+    if (!written) {
+      emergency_read_only();
+      break;
+    }
+    if (root != _root) {
+      // The cache was moved while we were writing.
+      break;
+    }
+    if (exchanged) {
       _index_pathname = temp_pathname;
       _index_ref_contents = new_index;
-      _index_stale_since = 0;
-      return;
+      if (_index_seq == index_seq) {
+        _index_stale_since = 0;
+      }
+      break;
     }
 
     // Shoot, some other process updated the index while we were trying to
     // update it, and they beat us to it.  We have to merge, and try again.
-    vfs->delete_file(temp_pathname);
-    _index_pathname = Filename(_root, Filename(trim(orig_index)));
+    _index_pathname = Filename(root, Filename(trim(orig_index)));
     _index_ref_contents = orig_index;
     read_index();
   }
-  check_cache_size();
+  _lock.release();
 }
 
 /**
@@ -430,11 +509,13 @@ read_index() {
     }
 
     if (old_index_pathname == _index_pathname) {
-      // Nope, we just couldn't read it.  Delete it and build a new one.
+      // Nope, we just couldn't read it.  Delete it and build a new one.  We
+      // may be called with the locks held, so don't flush here; marking the
+      // index stale leaves the new one to be written by the next flush.
       VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
       vfs->delete_file(_index_pathname);
       rebuild_index();
-      flush_index();
+      mark_index_stale();
       return;
     }
   }
@@ -562,7 +643,8 @@ merge_index(BamCacheIndex *new_index) {
 }
 
 /**
- * Regenerates the index from scratch by scanning the directory.
+ * Regenerates the index from scratch by scanning the directory.  The new
+ * index is written to disk by the next flush.
  */
 void BamCache::
 rebuild_index() {
@@ -585,7 +667,8 @@ rebuild_index() {
     Filename filename = file->get_filename();
     if (filename.get_extension() == "bam" ||
         filename.get_extension() == "txo") {
-      Filename pathname(_root, filename);
+      // The scanned filename already includes the directory.
+      Filename pathname(_root, filename.get_basename());
 
       PT(BamCacheRecord) record = do_read_record(pathname, false);
       if (record == nullptr) {
@@ -612,7 +695,6 @@ rebuild_index() {
 
   _index_stale_since = time(nullptr);
   check_cache_size();
-  flush_index();
 }
 
 /**
@@ -623,6 +705,7 @@ void BamCache::
 add_to_index(const BamCacheRecord *record) {
   PT(BamCacheRecord) new_record = record->make_copy();
 
+  ReMutexHolder holder(_lock);
   if (_index->add_record(new_record)) {
     mark_index_stale();
     check_cache_size();
@@ -634,6 +717,7 @@ add_to_index(const BamCacheRecord *record) {
  */
 void BamCache::
 remove_from_index(const Filename &source_pathname) {
+  ReMutexHolder holder(_lock);
   if (_index->remove_record(source_pathname)) {
     mark_index_stale();
   }
@@ -773,11 +857,33 @@ do_write_index(const Filename &index_pathname, const BamCacheIndex *index) {
  */
 PT(BamCacheRecord) BamCache::
 find_and_read_record(const Filename &source_pathname,
+                     const Filename &root,
                      const Filename &cache_filename) {
+  // If the record has been stored but not yet written to disk, read it from
+  // memory instead.
+  PT(PendingWrite) pending = find_pending_write(source_pathname);
+  if (pending != nullptr) {
+    istringstream in(pending->_data);
+    DatagramInputFile din;
+    if (din.open(in, pending->_cache_pathname)) {
+      PT(BamCacheRecord) record =
+        do_read_record(din, pending->_cache_pathname, true);
+      if (record != nullptr &&
+          record->get_source_pathname() == source_pathname) {
+        if (!record->has_data()) {
+          record->clear_dependent_files();
+        }
+        record->_record_size = pending->_data.size();
+        record->_cache_pathname = pending->_cache_pathname;
+        return record;
+      }
+    }
+  }
+
   int pass = 0;
   while (true) {
     PT(BamCacheRecord) record =
-      read_record(source_pathname, cache_filename, pass);
+      read_record(source_pathname, root, cache_filename, pass);
     if (record != nullptr) {
       add_to_index(record);
       return record;
@@ -792,10 +898,11 @@ find_and_read_record(const Filename &source_pathname,
  */
 PT(BamCacheRecord) BamCache::
 read_record(const Filename &source_pathname,
+            const Filename &root,
             const Filename &cache_filename,
             int pass) {
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-  Filename cache_pathname(_root, cache_filename);
+  Filename cache_pathname(root, cache_filename);
   if (pass != 0) {
     ostringstream strm;
     strm << cache_pathname.get_basename_wo_extension() << "_" << pass;
@@ -869,6 +976,24 @@ do_read_record(const Filename &cache_pathname, bool read_data) {
     return nullptr;
   }
 
+  PT(BamCacheRecord) record = do_read_record(din, cache_pathname, read_data);
+  if (record != nullptr) {
+    // Also get the total file size.
+    PT(VirtualFile) vfile = din.get_vfile();
+    istream &in = din.get_stream();
+    in.clear();
+    record->_record_size = vfile->get_file_size(&in);
+  }
+  return record;
+}
+
+/**
+ * Reads a record from the indicated already-opened cache file, which may be
+ * on disk or in memory.
+ */
+PT(BamCacheRecord) BamCache::
+do_read_record(DatagramInputFile &din, const Filename &cache_pathname,
+               bool read_data) {
   string head;
   if (!din.read_header(head, _bam_header.size())) {
     if (util_cat.is_debug()) {
@@ -941,18 +1066,120 @@ do_read_record(const Filename &cache_pathname, bool read_data) {
     }
   }
 
-  // Also get the total file size.
-  PT(VirtualFile) vfile = din.get_vfile();
-  istream &in = din.get_stream();
-  in.clear();
-  record->_record_size = vfile->get_file_size(&in);
-
-  // And the last access time is now, duh.
+  // The last access time is now, duh.
   record->_record_access_time = time(nullptr);
 
   return record;
 }
 
+/**
+ * Writes the encoded cache file to disk, and adds it to the index.  This is
+ * called by the writer thread, or directly by store() if there is none.
+ * Returns true on success.
+ */
+bool BamCache::
+do_write_record(PendingWrite *pending) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  const Filename &cache_pathname = pending->_cache_pathname;
+
+  // We actually do the write to a temporary filename first, and then move it
+  // into place, so that no one attempts to read the file while it is in the
+  // process of being written.
+  Thread *current_thread = Thread::get_current_thread();
+  string extension = current_thread->get_unique_id() + string(".tmp");
+  Filename temp_pathname = cache_pathname;
+  temp_pathname.set_extension(extension);
+  temp_pathname.set_binary();
+
+  ostream *out = vfs->open_write_file(temp_pathname, false, true);
+  if (out == nullptr) {
+    util_cat.error()
+      << "Could not write cache file: " << temp_pathname << "\n";
+    vfs->delete_file(temp_pathname);
+    ReMutexHolder holder(_lock);
+    emergency_read_only();
+    return false;
+  }
+
+  out->write(pending->_data.data(), pending->_data.size());
+  bool okflag = !out->fail();
+  vfs->close_write_file(out);
+  if (!okflag) {
+    util_cat.error()
+      << "Unable to write to " << temp_pathname << "\n";
+    vfs->delete_file(temp_pathname);
+    return false;
+  }
+
+  // Now move the file into place.
+  if (!vfs->rename_file(temp_pathname, cache_pathname) && vfs->exists(temp_pathname)) {
+    vfs->delete_file(cache_pathname);
+    if (!vfs->rename_file(temp_pathname, cache_pathname)) {
+      util_cat.error()
+        << "Unable to rename " << temp_pathname << " to "
+        << cache_pathname << "\n";
+      vfs->delete_file(temp_pathname);
+      return false;
+    }
+  }
+
+  ReMutexHolder holder(_lock);
+  if (pending->_root == _root) {
+    add_to_index(pending->_record);
+  }
+  return true;
+}
+
+/**
+ * Returns the record for the indicated source file that is waiting to be
+ * written by the writer thread, or NULL if there is none.
+ */
+PT(BamCache::PendingWrite) BamCache::
+find_pending_write(const Filename &source_pathname) {
+  MutexHolder holder(_write_lock);
+  PendingWrites::const_iterator pi = _pending_writes.find(source_pathname);
+  if (pi != _pending_writes.end()) {
+    return (*pi).second;
+  }
+  return nullptr;
+}
+
+/**
+ * Starts the thread that writes cache files and flushes the index in the
+ * background.  Assumes _write_lock is held.
+ */
+void BamCache::
+start_writer_thread() {
+  PT(WriterThread) thread = new WriterThread(this);
+  if (thread->start(TP_low, true)) {
+    _writer_thread = thread;
+  }
+}
+
+/**
+ * Waits for the writer thread to finish whatever it has been given to do,
+ * and then stops it.
+ */
+void BamCache::
+stop_writer_thread() {
+  PT(WriterThread) thread;
+  {
+    MutexHolder holder(_write_lock);
+    thread = _writer_thread;
+    if (thread == nullptr) {
+      return;
+    }
+    _writer_shutdown = true;
+    _write_cv.notify_all();
+  }
+
+  thread->join();
+
+  MutexHolder holder(_write_lock);
+  _writer_thread = nullptr;
+  _writer_shutdown = false;
+}
+
 /**
  * Returns the appropriate filename to use for a cache file, given the
  * fullpath string to the source filename.
@@ -994,3 +1221,57 @@ make_global() {
     _global_ptr->set_active(false);
   }
 }
+
+/**
+ *
+ */
+BamCache::WriterThread::
+WriterThread(BamCache *cache) :
+  Thread("BamCacheWriter", "BamCacheWriter"),
+  _cache(cache)
+{
+}
+
+/**
+ * Writes the queued cache files in order, and flushes the index when asked,
+ * until the BamCache shuts us down.
+ */
+void BamCache::WriterThread::
+thread_main() {
+  BamCache *cache = _cache;
+  cache->_write_lock.acquire();
+  while (true) {
+    if (!cache->_write_queue.empty()) {
+      // Leave the record on the queue until it has been written, so that
+      // wait_for_writes() waits for it.
+      PT(PendingWrite) pending = cache->_write_queue.front();
+      cache->_write_lock.release();
+
+      cache->do_write_record(pending);
+
+      cache->_write_lock.acquire();
+      PendingWrites::iterator pi =
+        cache->_pending_writes.find(pending->_record->get_source_pathname());
+      if (pi != cache->_pending_writes.end() && (*pi).second == pending) {
+        cache->_pending_writes.erase(pi);
+      }
+      cache->_write_queue.pop_front();
+      cache->_write_cv.notify_all();
+
+    } else if (cache->_flush_requested) {
+      cache->_flush_requested = false;
+      cache->_write_lock.release();
+
+      cache->do_flush_index();
+
+      cache->_write_lock.acquire();
+
+    } else if (cache->_writer_shutdown) {
+      break;
+
+    } else {
+      cache->_write_cv.wait();
+    }
+  }
+  cache->_write_lock.release();
+}
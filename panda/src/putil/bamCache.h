@@ -22,10 +22,15 @@
 #include "pvector.h"
 #include "reMutex.h"
 #include "reMutexHolder.h"
+#include "pmutex.h"
+#include "conditionVarFull.h"
+#include "pdeque.h"
+#include "thread.h"
 
 #include <time.h>
 
 class BamCacheIndex;
+class DatagramInputFile;
 
 /**
  * This class maintains a cache of Bam and/or Txo objects generated from model
@@ -38,6 +43,12 @@ class BamCacheIndex;
  * multiple different processes writing to the same index, and without relying
  * too heavily on low-level os-provided file locks (which work poorly with C++
  * iostreams).
+ *
+ * When threading is available, the cache files written by store() and the
+ * index written by consider_flush_index() go to disk on a background thread,
+ * so that the loading thread doesn't wait for them (see
+ * model-cache-async-writes).  Lookups may proceed on any number of threads at
+ * once; the lock is held only while the in-memory index is updated.
  */
 class EXPCL_PANDA_PUTIL BamCache {
 PUBLISHED:
@@ -77,6 +88,7 @@ PUBLISHED:
 
   void consider_flush_index();
   void flush_index();
+  BLOCKING void wait_for_writes();
 
   void list_index(std::ostream &out, int indent_level = 0) const;
 
@@ -112,16 +124,48 @@ private:
 
   void emergency_read_only();
 
+  void do_flush_index();
+
   static BamCacheIndex *do_read_index(const Filename &index_pathname);
   static bool do_write_index(const Filename &index_pathname, const BamCacheIndex *index);
 
   PT(BamCacheRecord) find_and_read_record(const Filename &source_pathname,
+                                          const Filename &root,
                                           const Filename &cache_filename);
   PT(BamCacheRecord) read_record(const Filename &source_pathname,
+                                 const Filename &root,
                                  const Filename &cache_filename,
                                  int pass);
   static PT(BamCacheRecord) do_read_record(const Filename &cache_pathname,
                                            bool read_data);
+  static PT(BamCacheRecord) do_read_record(DatagramInputFile &din,
+                                           const Filename &cache_pathname,
+                                           bool read_data);
+
+  // A cache file that has been encoded by store(), but not yet written to
+  // disk.
+  class PendingWrite : public ReferenceCount {
+  public:
+    PT(BamCacheRecord) _record;
+    Filename _root;
+    Filename _cache_pathname;
+    std::string _data;
+  };
+  typedef pdeque<PT(PendingWrite) > WriteQueue;
+  typedef pmap<Filename, PT(PendingWrite) > PendingWrites;
+
+  bool do_write_record(PendingWrite *pending);
+  PT(PendingWrite) find_pending_write(const Filename &source_pathname);
+  void start_writer_thread();
+  void stop_writer_thread();
+
+  class WriterThread : public Thread {
+  public:
+    WriterThread(BamCache *cache);
+    virtual void thread_main();
+
+    BamCache *_cache;
+  };
 
   static std::string hash_filename(const std::string &filename);
   static void make_global();
@@ -132,6 +176,7 @@ private:
   bool _cache_compressed_textures;
   bool _cache_compiled_shaders;
   bool _read_only;
+  bool _async_writes;
   Filename _root;
   int _flush_time;
   int _max_kbytes;
@@ -139,11 +184,29 @@ private:
 
   BamCacheIndex *_index;
   time_t _index_stale_since;
+  unsigned int _index_seq;
 
   Filename _index_pathname;
   std::string _index_ref_contents;
 
   ReMutex _lock;
+
+  // Only one thread writes the index at a time.  This is never acquired
+  // while _lock is held.
+  Mutex _flush_lock;
+
+  // The writer thread waits on _write_cv for something to be added to
+  // _write_queue, or for _flush_requested to be set.  _pending_writes indexes
+  // the same records by source pathname, so that a lookup can find a record
+  // that hasn't been written yet.  These are all protected by _write_lock,
+  // which may be acquired while _lock is held, but not the reverse.
+  Mutex _write_lock;
+  ConditionVarFull _write_cv;
+  WriteQueue _write_queue;
+  PendingWrites _pending_writes;
+  bool _flush_requested;
+  bool _writer_shutdown;
+  PT(WriterThread) _writer_thread;
 };
 
 #include "bamCache.I"
@@ -0,0 +1,221 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_bam_cache.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "bamCache.h"
+#include "config_putil.h"
+#include "bamCacheRecord.h"
+#include "paramValue.h"
+#include "typeRegistry.h"
+#include "virtualFileSystem.h"
+#include "configVariableBool.h"
+#include "thread.h"
+#include "trueClock.h"
+#include "string_utils.h"
+
+/**
+ * Each thread looks up all of the sources in the cache, as several loader
+ * threads would.
+ */
+class LookupThread : public Thread {
+public:
+  LookupThread(BamCache *cache, const pvector<Filename> &sources) :
+    Thread("lookup", "lookup"),
+    _cache(cache),
+    _sources(sources),
+    _num_found(0)
+  {
+  }
+
+  virtual void thread_main() {
+    for (const Filename &source : _sources) {
+      PT(BamCacheRecord) record = _cache->lookup(source, "bam");
+      if (record != nullptr && record->has_data()) {
+        ++_num_found;
+      }
+    }
+  }
+
+  BamCache *_cache;
+  const pvector<Filename> &_sources;
+  int _num_found;
+};
+
+/**
+ * Deletes the indicated directory and everything in it.
+ */
+static void
+remove_tree(const Filename &dirname) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  PT(VirtualFileList) files = vfs->scan_directory(dirname);
+  if (files != nullptr) {
+    for (size_t i = 0; i < files->get_num_files(); ++i) {
+      VirtualFile *file = files->get_file(i);
+      if (file->is_directory()) {
+        remove_tree(file->get_filename());
+      } else {
+        file->delete_file();
+      }
+    }
+  }
+  vfs->delete_file(dirname);
+}
+
+/**
+ * Stores a record for each source into a new cache at the indicated root,
+ * then looks them all up again at once, then from several threads.  Returns
+ * false if any lookup did not find its record.
+ */
+static bool
+run_cache(const Filename &root, const pvector<Filename> &sources,
+          const std::string &contents, bool async_writes, int num_threads) {
+  ConfigVariableBool("model-cache-async-writes", true).set_value(async_writes);
+  BamCache *cache = new BamCache;
+  cache->set_root(root);
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  // The time spent in store() is the time a loading thread would spend.
+  double store_time = 0.0;
+  for (const Filename &source : sources) {
+    PT(BamCacheRecord) record = cache->lookup(source, "bam");
+    record->add_dependent_file(source);
+    record->set_data(new ParamString(contents + source.get_fullpath()));
+    double start = clock->get_short_time();
+    cache->store(record);
+    store_time += clock->get_short_time() - start;
+  }
+
+  // These may be served from the queued writes, or from disk.
+  int num_found = 0;
+  for (const Filename &source : sources) {
+    PT(BamCacheRecord) record = cache->lookup(source, "bam");
+    if (record != nullptr && record->has_data() &&
+        DCAST(ParamString, record->get_data())->get_value() ==
+        contents + source.get_fullpath()) {
+      ++num_found;
+    }
+  }
+
+  double start = clock->get_short_time();
+  cache->flush_index();
+  double drain_time = clock->get_short_time() - start;
+
+  pvector<PT(LookupThread) > threads;
+  start = clock->get_short_time();
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new LookupThread(cache, sources));
+    threads.back()->start(TP_normal, true);
+  }
+  int threaded_found = 0;
+  for (int i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+    threaded_found += threads[i]->_num_found;
+  }
+  double lookup_time = clock->get_short_time() - start;
+
+  nout << (async_writes ? "async" : "sync ") << " writes: "
+       << store_time << " s in store(), " << drain_time
+       << " s to finish writing, " << lookup_time << " s for " << num_threads
+       << " threads to look up all; found " << num_found << " + "
+       << threaded_found << "\n";
+
+  delete cache;
+  return num_found == (int)sources.size() &&
+    threaded_found == num_threads * (int)sources.size();
+}
+
+/**
+ * Replaces the index file of the cache at the indicated root with garbage,
+ * then opens the cache again.  The index should be rebuilt from the cache
+ * files that are still on disk, and written out again.  Returns false if any
+ * record is missing from the rebuilt index.
+ */
+static bool
+check_corrupt_index(const Filename &root, int num_files) {
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  std::string index_name;
+  if (!vfs->read_file(Filename(root, "index_name.txt"), index_name, true)) {
+    return false;
+  }
+  Filename index_pathname(root, Filename(trim(index_name)));
+  vfs->write_file(index_pathname, "not an index", false);
+
+  BamCache *cache = new BamCache;
+  cache->set_root(root);
+  std::ostringstream strm;
+  cache->list_index(strm);
+  cache->flush_index();
+  delete cache;
+
+  int num_records = 0;
+  std::istringstream in(strm.str());
+  std::string word;
+  in >> word >> num_records;
+
+  nout << "corrupt index: rebuilt with " << num_records << " records\n";
+  return num_records == num_files;
+}
+
+/**
+ * Times storing many records into the model cache with and without
+ * model-cache-async-writes, and checks that every record can be looked up
+ * again, including from several threads at once.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_files = 500;
+  int num_threads = 4;
+  if (argc > 1) {
+    num_files = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_threads = atoi(argv[2]);
+  }
+  if (argc > 3 || num_files <= 0 || num_threads <= 0) {
+    nout << "test_bam_cache [num_files [num_threads]]\n";
+    exit(1);
+  }
+
+  init_libputil();
+
+  // store() asks about these types, which are defined in libraries that this
+  // test doesn't link with.
+  TypeRegistry::ptr()->register_dynamic_type("Texture");
+  TypeRegistry::ptr()->register_dynamic_type("PandaNode");
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  Filename root = Filename::temporary("", "bam_cache");
+  Filename source_dir(root, "src");
+  vfs->make_directory_full(source_dir);
+
+  pvector<Filename> sources;
+  for (int i = 0; i < num_files; ++i) {
+    Filename source(source_dir, "model" + std::to_string(i) + ".egg");
+    vfs->write_file(source, "", false);
+    sources.push_back(source);
+  }
+
+  // About the size of a small model, and as much as a ParamString can hold.
+  std::string contents(60000, 'x');
+
+  bool ok = run_cache(Filename(root, "sync"), sources, contents, false,
+                      num_threads);
+  ok = run_cache(Filename(root, "async"), sources, contents, true,
+                 num_threads) && ok;
+  ok = check_corrupt_index(Filename(root, "async"), num_files) && ok;
+
+  nout << (ok ? "ok" : "FAILED") << "\n";
+  remove_tree(root);
+  Thread::prepare_for_exit();
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,636 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_tinybench.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "graphicsEngine.h"
+#include "graphicsPipeSelection.h"
+#include "graphicsOutput.h"
+#include "displayRegion.h"
+#include "displayRegionCullCallbackData.h"
+#include "displayRegionDrawCallbackData.h"
+#include "callbackObject.h"
+#include "frameBufferProperties.h"
+#include "windowProperties.h"
+#include "camera.h"
+#include "perspectiveLens.h"
+#include "nodePath.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomVertexWriter.h"
+#include "transformBlendTable.h"
+#include "userVertexTransform.h"
+#include "cardMaker.h"
+#include "textNode.h"
+#include "texture.h"
+#include "pnmImage.h"
+#include "trueClock.h"
+#include "load_prc_file.h"
+#include "cmath.h"
+#include "mathNumbers.h"
+#include "string_utils.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+/**
+ * Runs the default cull or draw traversal for a DisplayRegion and
+ * accumulates the wall-clock time it took.
+ */
+class StageTimer : public CallbackObject {
+public:
+  ALLOC_DELETED_CHAIN(StageTimer);
+  StageTimer() : _elapsed(0.0) {}
+
+  virtual void do_callback(CallbackData *cbdata) {
+    TrueClock *clock = TrueClock::get_global_ptr();
+    double start = clock->get_short_time();
+    cbdata->upcall();
+    _elapsed += clock->get_short_time() - start;
+  }
+
+  double _elapsed;
+};
+
+/**
+ * One of the standard benchmark scenes.  The scene graph is built once by
+ * setup(); update() is called once per frame and must depend only on the
+ * frame number, so that the final image is reproducible.
+ */
+class BenchScene {
+public:
+  BenchScene(const std::string &name) : _name(name) {}
+  virtual ~BenchScene() {}
+
+  virtual void setup(NodePath &render, NodePath &camera)=0;
+  virtual void update(NodePath &camera, int frame)=0;
+
+  std::string _name;
+};
+
+/**
+ * Returns a procedural checkerboard texture with a gradient, so that every
+ * texel is distinct enough for filtering errors to show up in the checksum.
+ */
+static PT(Texture)
+make_checker_texture(int size, int checks) {
+  PNMImage image(size, size, 3);
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      bool on = (((x * checks) / size) + ((y * checks) / size)) & 1;
+      PN_stdfloat u = (PN_stdfloat)x / (PN_stdfloat)size;
+      PN_stdfloat v = (PN_stdfloat)y / (PN_stdfloat)size;
+      if (on) {
+        image.set_xel(x, y, 0.9f, 0.8f * u, 0.8f * v);
+      } else {
+        image.set_xel(x, y, 0.2f * v, 0.3f, 0.2f * u);
+      }
+    }
+  }
+  PT(Texture) tex = new Texture("checker");
+  tex->load(image);
+  return tex;
+}
+
+/**
+ * Returns a soft round sprite with an alpha falloff.
+ */
+static PT(Texture)
+make_sprite_texture(int size) {
+  PNMImage image(size, size, 4);
+  PN_stdfloat half = (PN_stdfloat)size * 0.5f;
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      PN_stdfloat dx = ((PN_stdfloat)x + 0.5f - half) / half;
+      PN_stdfloat dy = ((PN_stdfloat)y + 0.5f - half) / half;
+      PN_stdfloat d = std::min(csqrt(dx * dx + dy * dy), (PN_stdfloat)1);
+      image.set_xel_a(x, y, 1.0f, 0.6f + 0.4f * (1.0f - d), 0.2f, 1.0f - d);
+    }
+  }
+  PT(Texture) tex = new Texture("sprite");
+  tex->load(image);
+  return tex;
+}
+
+/**
+ * Thousands of tiny, individually colored Geoms.  This stresses the per-node
+ * cost of the cull traversal and the per-Geom state changes in the GSG much
+ * more than it does the rasterizer.
+ */
+class SmallGeomsScene : public BenchScene {
+public:
+  SmallGeomsScene() : BenchScene("small-geoms") {}
+
+  virtual void setup(NodePath &render, NodePath &camera) {
+    static const int side = 64;
+    CardMaker cm("card");
+    cm.set_frame(-0.4f, 0.4f, -0.4f, 0.4f);
+    _root = render.attach_new_node("grid");
+    for (int yi = 0; yi < side; ++yi) {
+      for (int xi = 0; xi < side; ++xi) {
+        NodePath card = _root.attach_new_node(cm.generate());
+        card.set_pos(xi - side / 2, 0, yi - side / 2);
+        card.set_hpr((xi * 7) % 90, 0, (yi * 11) % 90);
+        card.set_color((PN_stdfloat)xi / side, (PN_stdfloat)yi / side,
+                       (PN_stdfloat)((xi + yi) & 7) / 7.0f, 1.0f);
+      }
+    }
+    _root.set_two_sided(true);
+    camera.set_pos(0, -90, 0);
+  }
+
+  virtual void update(NodePath &camera, int frame) {
+    _root.set_r(frame * 0.5f);
+  }
+
+  NodePath _root;
+};
+
+/**
+ * A single large heightfield with a mipmapped texture, viewed at a grazing
+ * angle.  Almost all of the time should be spent in the rasterizer.
+ */
+class TexturedMeshScene : public BenchScene {
+public:
+  TexturedMeshScene() : BenchScene("textured-mesh") {}
+
+  virtual void setup(NodePath &render, NodePath &camera) {
+    static const int side = 128;
+    PT(GeomVertexData) vdata = new GeomVertexData
+      ("mesh", GeomVertexFormat::get_v3n3t2(), Geom::UH_static);
+    vdata->unclean_set_num_rows((side + 1) * (side + 1));
+    GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+    GeomVertexWriter normal(vdata, InternalName::get_normal());
+    GeomVertexWriter texcoord(vdata, InternalName::get_texcoord());
+
+    for (int yi = 0; yi <= side; ++yi) {
+      for (int xi = 0; xi <= side; ++xi) {
+        PN_stdfloat u = (PN_stdfloat)xi / side;
+        PN_stdfloat v = (PN_stdfloat)yi / side;
+        PN_stdfloat z = csin(u * 12.0f) * ccos(v * 9.0f) * 2.0f;
+        vertex.add_data3(u * 100.0f - 50.0f, v * 100.0f - 50.0f, z);
+        normal.add_data3(0, 0, 1);
+        texcoord.add_data2(u * 8.0f, v * 8.0f);
+      }
+    }
+
+    PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+    for (int yi = 0; yi < side; ++yi) {
+      for (int xi = 0; xi < side; ++xi) {
+        int i = yi * (side + 1) + xi;
+        tris->add_vertices(i, i + 1, i + side + 2);
+        tris->add_vertices(i, i + side + 2, i + side + 1);
+      }
+    }
+
+    PT(Geom) geom = new Geom(vdata);
+    geom->add_primitive(tris);
+    PT(GeomNode) gnode = new GeomNode("mesh");
+    gnode->add_geom(geom);
+
+    PT(Texture) tex = make_checker_texture(512, 16);
+    tex->set_minfilter(SamplerState::FT_linear_mipmap_linear);
+    tex->set_magfilter(SamplerState::FT_linear);
+
+    _root = render.attach_new_node(gnode);
+    _root.set_texture(tex);
+    camera.set_pos(0, -60, 12);
+    camera.look_at(0, 0, 0);
+  }
+
+  virtual void update(NodePath &camera, int frame) {
+    _root.set_h(frame * 0.25f);
+  }
+
+  NodePath _root;
+};
+
+/**
+ * Camera-facing alpha-blended sprites, which must be depth-sorted back to
+ * front every frame and overlap heavily on screen.
+ */
+class ParticlesScene : public BenchScene {
+public:
+  ParticlesScene() : BenchScene("particles") {}
+
+  virtual void setup(NodePath &render, NodePath &camera) {
+    static const int count = 1500;
+    CardMaker cm("sprite");
+    cm.set_frame(-0.5f, 0.5f, -0.5f, 0.5f);
+    PT(PandaNode) card = cm.generate();
+
+    _root = render.attach_new_node("particles");
+    _root.set_texture(make_sprite_texture(64));
+    _root.set_transparency(TransparencyAttrib::M_alpha);
+    _root.set_depth_write(false);
+
+    _particles.reserve(count);
+    for (int i = 0; i < count; ++i) {
+      NodePath p = _root.attach_new_node("p");
+      p.attach_new_node(card->copy_subgraph());
+      p.set_billboard_point_eye();
+      p.set_scale(1.0f + (i % 5) * 0.5f);
+      _particles.push_back(p);
+    }
+    camera.set_pos(0, -40, 0);
+  }
+
+  virtual void update(NodePath &camera, int frame) {
+    // A deterministic fountain: each particle follows a parabola whose phase
+    // depends on its index.
+    size_t count = _particles.size();
+    for (size_t i = 0; i < count; ++i) {
+      PN_stdfloat t = (PN_stdfloat)((frame + (int)i * 7) % 120) / 120.0f;
+      PN_stdfloat angle = (PN_stdfloat)i * 2.39996f;
+      PN_stdfloat r = t * 12.0f;
+      _particles[i].set_pos(r * ccos(angle), r * csin(angle) * 0.5f,
+                            t * 20.0f - t * t * 24.0f - 4.0f);
+    }
+  }
+
+  NodePath _root;
+  pvector<NodePath> _particles;
+};
+
+/**
+ * Tubes deformed on the CPU by a three-bone skeleton, using the same
+ * TransformBlendTable path that Character-based models animate through.
+ */
+class SkinnedScene : public BenchScene {
+public:
+  SkinnedScene() : BenchScene("skinned") {}
+
+  virtual void setup(NodePath &render, NodePath &camera) {
+    static const int num_characters = 16;
+    static const int num_bones = 3;
+    static const int rings = 24;
+    static const int segments = 24;
+
+    PT(GeomVertexArrayFormat) array = new GeomVertexArrayFormat
+      (*GeomVertexFormat::get_v3n3t2()->get_array(0));
+    array->add_column(InternalName::get_transform_blend(), 1,
+                      Geom::NT_uint16, Geom::C_index);
+    PT(GeomVertexFormat) new_format = new GeomVertexFormat(array);
+    GeomVertexAnimationSpec spec;
+    spec.set_panda();
+    new_format->set_animation(spec);
+    CPT(GeomVertexFormat) format = GeomVertexFormat::register_format(new_format);
+
+    PT(Texture) tex = make_checker_texture(128, 8);
+    _root = render.attach_new_node("characters");
+    _root.set_texture(tex);
+
+    for (int c = 0; c < num_characters; ++c) {
+      PT(TransformBlendTable) table = new TransformBlendTable;
+      PT(UserVertexTransform) bones[num_bones];
+      for (int b = 0; b < num_bones; ++b) {
+        bones[b] = new UserVertexTransform("bone" + format_string(b));
+        _bones.push_back(bones[b]);
+      }
+
+      PT(GeomVertexData) vdata = new GeomVertexData
+        ("skin", format, Geom::UH_static);
+      vdata->unclean_set_num_rows((rings + 1) * (segments + 1));
+      GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+      GeomVertexWriter normal(vdata, InternalName::get_normal());
+      GeomVertexWriter texcoord(vdata, InternalName::get_texcoord());
+      GeomVertexWriter blend(vdata, InternalName::get_transform_blend());
+
+      for (int ri = 0; ri <= rings; ++ri) {
+        // Position along the tube in bone units, and the pair of bones whose
+        // influence is blended there.
+        PN_stdfloat s = (PN_stdfloat)ri / rings * (num_bones - 1);
+        int b0 = std::min((int)s, num_bones - 2);
+        PN_stdfloat w1 = s - b0;
+        int bi = table->add_blend(TransformBlend(bones[b0], 1.0f - w1,
+                                                 bones[b0 + 1], w1));
+        for (int si = 0; si <= segments; ++si) {
+          PN_stdfloat a = (PN_stdfloat)si / segments * MathNumbers::pi_f * 2.0f;
+          vertex.add_data3(ccos(a) * 0.5f, csin(a) * 0.5f, s * 2.0f);
+          normal.add_data3(ccos(a), csin(a), 0);
+          texcoord.add_data2((PN_stdfloat)si / segments, (PN_stdfloat)ri / rings);
+          blend.add_data1i(bi);
+        }
+      }
+      table->set_rows(SparseArray::lower_on(vdata->get_num_rows()));
+      vdata->set_transform_blend_table(table);
+
+      PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+      for (int ri = 0; ri < rings; ++ri) {
+        for (int si = 0; si < segments; ++si) {
+          int i = ri * (segments + 1) + si;
+          tris->add_vertices(i, i + 1, i + segments + 2);
+          tris->add_vertices(i, i + segments + 2, i + segments + 1);
+        }
+      }
+
+      PT(Geom) geom = new Geom(vdata);
+      geom->add_primitive(tris);
+      PT(GeomNode) gnode = new GeomNode("character");
+      gnode->add_geom(geom);
+
+      NodePath np = _root.attach_new_node(gnode);
+      np.set_pos((c % 4) * 3.0f - 4.5f, 0, (c / 4) * 3.0f - 6.0f);
+      np.set_two_sided(true);
+    }
+    camera.set_pos(0, -25, 0);
+  }
+
+  virtual void update(NodePath &camera, int frame) {
+    size_t count = _bones.size();
+    for (size_t i = 0; i < count; ++i) {
+      // Each bone bends about the X axis at its own root, so the tube curls
+      // progressively more towards the tip.
+      int b = (int)(i % 3);
+      PN_stdfloat angle = csin((frame + (int)i * 5) * 0.05f) * 20.0f * b;
+      LMatrix4 mat = LMatrix4::translate_mat(0, 0, -2.0f * b) *
+        LMatrix4::rotate_mat(angle, LVector3::right()) *
+        LMatrix4::translate_mat(0, 0, 2.0f * b);
+      _bones[i]->set_matrix(mat);
+    }
+  }
+
+  NodePath _root;
+  pvector<PT(UserVertexTransform)> _bones;
+};
+
+/**
+ * Blocks of text whose contents change every frame, so that the glyphs are
+ * re-assembled as well as drawn.
+ */
+class TextScene : public BenchScene {
+public:
+  TextScene() : BenchScene("text") {}
+
+  virtual void setup(NodePath &render, NodePath &camera) {
+    static const int count = 24;
+    _root = render.attach_new_node("text");
+    for (int i = 0; i < count; ++i) {
+      PT(TextNode) text = new TextNode("text" + format_string(i));
+      text->set_align(TextNode::A_center);
+      text->set_text_color(1.0f, 1.0f - i / (PN_stdfloat)count, 0.5f, 1.0f);
+      NodePath np = _root.attach_new_node(text);
+      np.set_pos(0, 0, 11.0f - i);
+      _texts.push_back(text);
+    }
+    camera.set_pos(0, -30, 0);
+  }
+
+  virtual void update(NodePath &camera, int frame) {
+    size_t count = _texts.size();
+    for (size_t i = 0; i < count; ++i) {
+      _texts[i]->set_text("The quick brown fox jumps over the lazy dog " +
+                          format_string(frame * 31 + (int)i));
+    }
+  }
+
+  NodePath _root;
+  pvector<PT(TextNode)> _texts;
+};
+
+/**
+ * Computes a hash of the rendered framebuffer contents.  This is a 64-bit
+ * FNV-1a hash, so that it is available without OpenSSL.
+ */
+static std::string
+checksum_image(const PNMImage &image) {
+  uint64_t hash = 14695981039346656037ULL;
+  int x_size = image.get_x_size();
+  int y_size = image.get_y_size();
+  for (int y = 0; y < y_size; ++y) {
+    for (int x = 0; x < x_size; ++x) {
+      unsigned char rgb[3] = {
+        (unsigned char)image.get_red_val(x, y),
+        (unsigned char)image.get_green_val(x, y),
+        (unsigned char)image.get_blue_val(x, y),
+      };
+      for (int c = 0; c < 3; ++c) {
+        hash = (hash ^ rgb[c]) * 1099511628211ULL;
+      }
+    }
+  }
+
+  char buffer[17];
+  sprintf(buffer, "%016llx", (unsigned long long)hash);
+  return buffer;
+}
+
+struct BenchResult {
+  double _app;
+  double _cull;
+  double _draw;
+  double _frame;
+  double _tiny_draw;
+  std::string _checksum;
+};
+
+/**
+ * Renders num_frames frames of the indicated display region, and returns
+ * the accumulated timings in seconds.
+ */
+static void
+run_frames(GraphicsEngine *engine, DisplayRegion *dr, BenchScene *scene,
+           NodePath &camera, int first_frame, int num_frames,
+           double &app, double &cull, double &draw, double &frame_time) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  PT(StageTimer) cull_timer = new StageTimer;
+  PT(StageTimer) draw_timer = new StageTimer;
+  dr->set_cull_callback(cull_timer);
+  dr->set_draw_callback(draw_timer);
+
+  app = 0.0;
+  frame_time = 0.0;
+  for (int f = first_frame; f < first_frame + num_frames; ++f) {
+    double start = clock->get_short_time();
+    scene->update(camera, f);
+    double mid = clock->get_short_time();
+    engine->render_frame();
+    double end = clock->get_short_time();
+    app += mid - start;
+    frame_time += end - start;
+  }
+
+  cull = cull_timer->_elapsed;
+  draw = draw_timer->_elapsed;
+  dr->clear_cull_callback();
+  dr->clear_draw_callback();
+}
+
+static void
+usage() {
+  std::cerr <<
+    "\n"
+    "Usage: test_tinybench [opts] [scene ...]\n\n"
+    "Renders a set of standard scenes through the offscreen tinydisplay pipe\n"
+    "and reports the average time per frame spent in each stage, along with\n"
+    "a checksum of the final image.  Run all scenes if none are named.\n\n"
+    "Options:\n\n"
+    "  -f frames   Number of timed frames per scene (default 100).\n"
+    "  -w width    Width of the offscreen buffer (default 640).\n"
+    "  -h height   Height of the offscreen buffer (default 480).\n"
+    "  -o prefix   Write the final image of each scene to prefix<scene>.png.\n"
+    "  -l          List the available scenes and exit.\n\n";
+}
+
+int
+main(int argc, char **argv) {
+  int num_frames = 100;
+  int width = 640;
+  int height = 480;
+  std::string image_prefix;
+  bool list_only = false;
+  vector_string scene_names;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if ((arg == "-f" || arg == "-w" || arg == "-h" || arg == "-o") &&
+        i + 1 < argc) {
+      std::string value = argv[++i];
+      if (arg == "-o") {
+        image_prefix = value;
+      } else {
+        int n;
+        if (!string_to_int(value, n) || n <= 0) {
+          std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+          return 1;
+        }
+        (arg == "-f" ? num_frames : arg == "-w" ? width : height) = n;
+      }
+    } else if (arg == "-l") {
+      list_only = true;
+    } else if (!arg.empty() && arg[0] == '-') {
+      usage();
+      return 1;
+    } else {
+      scene_names.push_back(arg);
+    }
+  }
+
+  pvector<BenchScene *> scenes;
+  scenes.push_back(new SmallGeomsScene);
+  scenes.push_back(new TexturedMeshScene);
+  scenes.push_back(new ParticlesScene);
+  scenes.push_back(new SkinnedScene);
+  scenes.push_back(new TextScene);
+
+  if (list_only) {
+    for (BenchScene *scene : scenes) {
+      std::cout << scene->_name << "\n";
+    }
+    return 0;
+  }
+
+  // Nothing should be waiting on the clock while we are measuring.
+  load_prc_file_data("test_tinybench", "sync-video 0\n");
+
+  GraphicsPipeSelection *selection = GraphicsPipeSelection::get_global_ptr();
+  PT(GraphicsPipe) pipe =
+    selection->make_pipe("TinyOffscreenGraphicsPipe", "p3tinydisplay");
+  if (pipe == nullptr) {
+    std::cerr << "Unable to create TinyOffscreenGraphicsPipe.\n";
+    return 1;
+  }
+
+  GraphicsEngine *engine = GraphicsEngine::get_global_ptr();
+  FrameBufferProperties fb_prop;
+  fb_prop.set_rgb_color(true);
+  fb_prop.set_depth_bits(16);
+  WindowProperties win_prop = WindowProperties::size(width, height);
+  GraphicsOutput *buffer = engine->make_output
+    (pipe, "tinybench", 0, fb_prop, win_prop,
+     GraphicsPipe::BF_refuse_window, nullptr, nullptr);
+  if (buffer == nullptr) {
+    std::cerr << "Unable to open offscreen buffer.\n";
+    return 1;
+  }
+  buffer->set_clear_color(LColor(0.1f, 0.1f, 0.2f, 1.0f));
+  engine->open_windows();
+
+  printf("%-14s %7s %9s %9s %9s %9s %9s  %s\n", "scene", "frames",
+         "app", "cull", "draw", "raster", "frame", "checksum");
+
+  int num_run = 0;
+  for (BenchScene *scene : scenes) {
+    if (!scene_names.empty() &&
+        std::find(scene_names.begin(), scene_names.end(), scene->_name) ==
+        scene_names.end()) {
+      continue;
+    }
+    ++num_run;
+
+    NodePath render("render");
+    PT(Camera) cam_node = new Camera("camera");
+    PT(Lens) lens = new PerspectiveLens;
+    lens->set_fov(60.0f);
+    lens->set_aspect_ratio((PN_stdfloat)width / (PN_stdfloat)height);
+    cam_node->set_lens(lens);
+    NodePath camera = render.attach_new_node(cam_node);
+    scene->setup(render, camera);
+
+    DisplayRegion *dr = buffer->make_display_region();
+    dr->set_camera(camera);
+
+    // A few untimed frames first, to prepare textures and fill caches.
+    double app, cull, draw, frame_time;
+    run_frames(engine, dr, scene, camera, 0, 5, app, cull, draw, frame_time);
+
+    BenchResult result;
+    run_frames(engine, dr, scene, camera, 5, num_frames,
+               result._app, result._cull, result._draw, result._frame);
+
+    PNMImage image;
+    if (!buffer->get_screenshot(image)) {
+      std::cerr << "Could not read back framebuffer for "
+                << scene->_name << "\n";
+      return 1;
+    }
+    result._checksum = checksum_image(image);
+    if (!image_prefix.empty()) {
+      image.write(Filename(image_prefix + scene->_name + ".png"));
+    }
+
+    // tinydisplay rasterizes inline while the draw traversal runs.  To
+    // separate the two, repeat the same frames with the region shrunk to a
+    // couple of pixels: the lens is unchanged, so the same vertices are
+    // transformed and clipped, but almost nothing is filled.
+    dr->set_dimensions(0, 2.0f / width, 0, 2.0f / height);
+    double tiny_app, tiny_cull, tiny_frame;
+    run_frames(engine, dr, scene, camera, 5, num_frames,
+               tiny_app, tiny_cull, result._tiny_draw, tiny_frame);
+
+    buffer->remove_display_region(dr);
+
+    double scale = 1000.0 / num_frames;
+    double raster = std::max(result._draw - result._tiny_draw, 0.0);
+    printf("%-14s %7d %9.3f %9.3f %9.3f %9.3f %9.3f  %s\n",
+           scene->_name.c_str(), num_frames,
+           result._app * scale, result._cull * scale, result._draw * scale,
+           raster * scale, result._frame * scale, result._checksum.c_str());
+    fflush(stdout);
+  }
+
+  if (num_run == 0) {
+    std::cerr << "No matching scenes; use -l to list them.\n";
+    return 1;
+  }
+  printf("(times are milliseconds per frame at %dx%d; raster is included "
+         "in draw)\n", width, height);
+
+  for (BenchScene *scene : scenes) {
+    delete scene;
+  }
+  engine->remove_all_windows();
+  return 0;
+}
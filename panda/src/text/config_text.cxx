@@ -54,6 +54,14 @@ ConfigVariableBool text_dynamic_merge
           "operation.  Usually it's a performance "
           "advantage to keep this true.  See TextNode::set_flatten_flags()."));
 
+ConfigVariableBool text_incremental_update
+("text-incremental-update", true,
+ PRC_DESC("Set this true to allow a TextNode whose text has changed, but "
+          "none of its other properties, to rewrite the vertices of its "
+          "existing geometry in place instead of generating it anew.  This "
+          "only applies to dynamic fonts with text-dynamic-merge enabled, and "
+          "to text without a card or frame."));
+
 ConfigVariableBool text_kerning
 ("text-kerning", false,
  PRC_DESC("Set this true to enable kerning when the font provides kerning "
@@ -215,6 +223,12 @@ ConfigVariableEnum<TextFont::RenderMode> text_render_mode
 ("text-render-mode", TextFont::RM_texture,
  PRC_DESC("The default render mode for dynamic text fonts"));
 
+ConfigVariableInt text_preload_threads
+("text-preload-threads", 4,
+ PRC_DESC("The number of threads that DynamicTextFont::preload_glyphs() "
+          "uses to render glyphs.  Set this to 1 to render them on the "
+          "calling thread."));
+
 
 
 /**
@@ -30,6 +30,7 @@ NotifyCategoryDecl(text, EXPCL_PANDA_TEXT, EXPTP_PANDA_TEXT);
 
 extern ConfigVariableBool text_flatten;
 extern ConfigVariableBool text_dynamic_merge;
+extern ConfigVariableBool text_incremental_update;
 extern ConfigVariableBool text_kerning;
 extern ConfigVariableBool text_use_harfbuzz;
 extern ConfigVariableInt text_anisotropic_degree;
@@ -56,6 +57,7 @@ extern ConfigVariableEnum<SamplerState::FilterType> text_magfilter;
 extern ConfigVariableEnum<SamplerState::WrapMode> text_wrap_mode;
 extern ConfigVariableEnum<Texture::QualityLevel> text_quality_level;
 extern ConfigVariableEnum<TextFont::RenderMode> text_render_mode;
+extern ConfigVariableInt text_preload_threads;
 
 extern EXPCL_PANDA_TEXT void init_libtext();
 
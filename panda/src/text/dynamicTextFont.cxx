@@ -43,6 +43,9 @@
 #include "colorAttrib.h"
 #include "textureAttrib.h"
 #include "transparencyAttrib.h"
+#include "asyncTaskManager.h"
+#include "pset.h"
+#include "thread.h"
 
 #ifdef HAVE_HARFBUZZ
 #include <hb-ft.h>
@@ -50,6 +53,98 @@
 
 TypeHandle DynamicTextFont::_type_handle;
 
+/**
+ * The result of rendering one glyph to an image, ready to be placed on a
+ * page.  This is filled in by a GlyphRasterizer, possibly in a different
+ * thread, and then passed to place_glyph() in the main thread.
+ */
+class DynamicTextFont::RasterizedGlyph {
+public:
+  RasterizedGlyph(int character = 0, int glyph_index = 0) :
+    _character(character),
+    _glyph_index(glyph_index),
+    _valid(false),
+    _advance(0.0f),
+    _tex_x_size(0.0f),
+    _tex_y_size(0.0f),
+    _tex_x_orig(0.0f),
+    _tex_y_orig(0.0f),
+    _alpha_mode(TransparencyAttrib::M_alpha),
+    _outline(0),
+    _x_size(0),
+    _y_size(0),
+    _direct(false)
+  {
+  }
+
+  int _character;
+  int _glyph_index;
+  bool _valid;
+  PN_stdfloat _advance;
+  PN_stdfloat _tex_x_size, _tex_y_size, _tex_x_orig, _tex_y_orig;
+  TransparencyAttrib::Mode _alpha_mode;
+  int _outline;
+  int _x_size, _y_size;
+
+  // If _direct is true, the glyph is stored in _pixels, one byte per pixel;
+  // otherwise, it is stored in _image (and _outline_image, if the font has an
+  // outline).
+  bool _direct;
+  pvector<unsigned char> _pixels;
+  PNMImage _image;
+  PNMImage _outline_image;
+};
+
+/**
+ * Renders glyphs for a DynamicTextFont into RasterizedGlyph objects.  Since
+ * this makes its own copy of the FreetypeFont state, and optionally its own
+ * FT_Face, several of these may render glyphs of the same font at once.
+ */
+class DynamicTextFont::GlyphRasterizer : public FreetypeFont {
+public:
+  GlyphRasterizer(const DynamicTextFont *font, bool own_face);
+
+  void rasterize(RasterizedGlyph &raster, FT_Face face);
+  void rasterize_range(pvector<RasterizedGlyph> &rasters, size_t first,
+                       size_t step);
+
+private:
+  void copy_bitmap(const FT_Bitmap &bitmap, RasterizedGlyph &raster);
+
+  const DynamicTextFont *_font;
+};
+
+/**
+ * A task that renders every nth glyph of a list of RasterizedGlyphs, on one
+ * of the threads of the text_preload task chain.
+ */
+class DynamicTextFont::RasterizeTask : public AsyncTask {
+public:
+  RasterizeTask(const DynamicTextFont *font, pvector<RasterizedGlyph> *rasters,
+                size_t first, size_t step) :
+    AsyncTask("rasterize_glyphs"),
+    _font(font),
+    _rasters(rasters),
+    _first(first),
+    _step(step)
+  {
+  }
+  ALLOC_DELETED_CHAIN(RasterizeTask);
+
+protected:
+  virtual DoneStatus do_task() {
+    GlyphRasterizer rasterizer(_font, true);
+    rasterizer.rasterize_range(*_rasters, _first, _step);
+    return DS_done;
+  }
+
+private:
+  const DynamicTextFont *_font;
+  pvector<RasterizedGlyph> *_rasters;
+  size_t _first;
+  size_t _step;
+};
+
 
 /**
  * The constructor expects the name of some font file that FreeType can read,
@@ -166,6 +261,42 @@ get_page(int n) const {
   return _pages[n];
 }
 
+/**
+ * Renders the glyphs for all of the characters in the indicated string that
+ * are not already in the font, and places them on the texture pages ahead of
+ * time, so that they do not need to be rendered when text that uses them is
+ * first generated.  For texture-based fonts, the glyphs are rendered on
+ * several threads; see text-preload-threads.
+ *
+ * Returns the number of new glyphs that were rendered.
+ */
+int DynamicTextFont::
+preload_glyphs(const std::wstring &text) {
+  pvector<int> characters;
+  characters.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    characters.push_back(text[i]);
+  }
+  return do_preload_glyphs(characters);
+}
+
+/**
+ * Renders the glyphs for all of the characters in the range first to last,
+ * inclusive, as preload_glyphs() does.  Returns the number of new glyphs that
+ * were rendered.
+ */
+int DynamicTextFont::
+preload_glyph_range(int first, int last) {
+  pvector<int> characters;
+  if (last >= first) {
+    characters.reserve(last - first + 1);
+    for (int ch = first; ch <= last; ++ch) {
+      characters.push_back(ch);
+    }
+  }
+  return do_preload_glyphs(characters);
+}
+
 /**
  * Removes all of the glyphs from the font that are no longer being used by
  * any Geoms.  Returns the number of glyphs removed.
@@ -486,304 +617,257 @@ determine_tex_format() {
  */
 CPT(TextGlyph) DynamicTextFont::
 make_glyph(int character, FT_Face face, int glyph_index) {
-  if (!load_glyph(face, glyph_index, false)) {
-    return nullptr;
-  }
-
-  FT_GlyphSlot slot = face->glyph;
-  FT_Bitmap &bitmap = slot->bitmap;
-
-  if ((bitmap.width == 0 || bitmap.rows == 0) && (glyph_index == 0)) {
-    // Here's a special case: a glyph_index of 0 means an invalid glyph.  Some
-    // fonts define a symbol to represent an invalid glyph, but if that symbol
-    // is the empty bitmap, we return NULL, and use Panda's invalid glyph in
-    // its place.  We do this to guarantee that every invalid glyph is visible
-    // as *something*.
-    return nullptr;
-  }
-
-  PN_stdfloat advance = slot->advance.x / 64.0;
-  advance /= _font_pixels_per_unit;
-
-  if (_render_mode != RM_texture &&
-      slot->format == ft_glyph_format_outline) {
-    // Re-stroke the glyph to make it an outline glyph.
-    /*
-    FT_Stroker stroker;
-    FT_Stroker_New(face->memory, &stroker);
-    FT_Stroker_Set(stroker, 16 * 16, FT_STROKER_LINECAP_BUTT,
-                   FT_STROKER_LINEJOIN_ROUND, 0);
-
-    FT_Stroker_ParseOutline(stroker, &slot->outline, 0);
-
-    FT_UInt num_points, num_contours;
-    FT_Stroker_GetCounts(stroker, &num_points, &num_contours);
-
-    FT_Outline border;
-    FT_Outline_New(_ft_library, num_points, num_contours, &border);
-    border.n_points = 0;
-    border.n_contours = 0;
-    FT_Stroker_Export(stroker, &border);
-    FT_Stroker_Done(stroker);
+  if (_render_mode != RM_texture && _render_mode != RM_distance_field) {
+    if (!load_glyph(face, glyph_index, false)) {
+      return nullptr;
+    }
 
-    FT_Outline_Done(_ft_library, &slot->outline);
-    memcpy(&slot->outline, &border, sizeof(border));
-    */
+    FT_GlyphSlot slot = face->glyph;
+    FT_Bitmap &bitmap = slot->bitmap;
 
-    // Ask FreeType to extract the contours out of the outline description.
-    decompose_outline(slot->outline);
+    if ((bitmap.width == 0 || bitmap.rows == 0) && (glyph_index == 0)) {
+      // See GlyphRasterizer::rasterize().
+      return nullptr;
+    }
 
-    PT(TextGlyph) glyph =
-      new TextGlyph(character, advance);
-    switch (_render_mode) {
-    case RM_wireframe:
-      render_wireframe_contours(glyph);
-      return glyph;
+    if (slot->format == ft_glyph_format_outline) {
+      PN_stdfloat advance = slot->advance.x / 64.0;
+      advance /= _font_pixels_per_unit;
+
+      // Re-stroke the glyph to make it an outline glyph.
+      /*
+      FT_Stroker stroker;
+      FT_Stroker_New(face->memory, &stroker);
+      FT_Stroker_Set(stroker, 16 * 16, FT_STROKER_LINECAP_BUTT,
+                     FT_STROKER_LINEJOIN_ROUND, 0);
+
+      FT_Stroker_ParseOutline(stroker, &slot->outline, 0);
+
+      FT_UInt num_points, num_contours;
+      FT_Stroker_GetCounts(stroker, &num_points, &num_contours);
+
+      FT_Outline border;
+      FT_Outline_New(_ft_library, num_points, num_contours, &border);
+      border.n_points = 0;
+      border.n_contours = 0;
+      FT_Stroker_Export(stroker, &border);
+      FT_Stroker_Done(stroker);
+
+      FT_Outline_Done(_ft_library, &slot->outline);
+      memcpy(&slot->outline, &border, sizeof(border));
+      */
+
+      // Ask FreeType to extract the contours out of the outline description.
+      decompose_outline(slot->outline);
+
+      PT(TextGlyph) glyph =
+        new TextGlyph(character, advance);
+      switch (_render_mode) {
+      case RM_wireframe:
+        render_wireframe_contours(glyph);
+        return glyph;
 
-    case RM_polygon:
-      render_polygon_contours(glyph, true, false);
-      return glyph;
+      case RM_polygon:
+        render_polygon_contours(glyph, true, false);
+        return glyph;
 
-    case RM_extruded:
-      render_polygon_contours(glyph, false, true);
-      return glyph;
+      case RM_extruded:
+        render_polygon_contours(glyph, false, true);
+        return glyph;
 
-    case RM_solid:
-      render_polygon_contours(glyph, true, true);
-      return glyph;
+      case RM_solid:
+        render_polygon_contours(glyph, true, true);
+        return glyph;
 
-    case RM_texture:
-    case RM_distance_field:
-    default:
-      break;
+      default:
+        break;
+      }
     }
   }
 
-  PN_stdfloat tex_x_size, tex_y_size, tex_x_orig, tex_y_orig;
-  FT_BBox bounds;
-  TransparencyAttrib::Mode alpha_mode;
-
-  if (_render_mode == RM_texture) {
-    // Render the glyph if necessary.
-    if (slot->format != ft_glyph_format_bitmap) {
-      FT_Render_Glyph(slot, ft_render_mode_normal);
-    }
-
-    tex_x_size = bitmap.width;
-    tex_y_size = bitmap.rows;
-    tex_x_orig = slot->bitmap_left;
-    tex_y_orig = slot->bitmap_top;
-    alpha_mode = TransparencyAttrib::M_alpha;
-
-  } else {
-    // Calculate suitable texture dimensions for the signed distance field.
-    // This is the same calculation that Freetype uses in its bitmap renderer.
-    FT_Outline_Get_CBox(&slot->outline, &bounds);
-
-    bounds.xMin = bounds.xMin & ~63;
-    bounds.yMin = bounds.yMin & ~63;
-    bounds.xMax = (bounds.xMax + 63) & ~63;
-    bounds.yMax = (bounds.yMax + 63) & ~63;
+  // Otherwise, the glyph is rendered to an image, which is placed on a page.
+  GlyphRasterizer rasterizer(this, false);
+  RasterizedGlyph raster(character, glyph_index);
+  rasterizer.rasterize(raster, face);
+  return place_glyph(raster);
+}
 
-    tex_x_size = (bounds.xMax - bounds.xMin) >> 6;
-    tex_y_size = (bounds.yMax - bounds.yMin) >> 6;
-    tex_x_orig = (bounds.xMin >> 6);
-    tex_y_orig = (bounds.yMax >> 6);
-    alpha_mode = TransparencyAttrib::M_binary;
+/**
+ * Slots a space in the texture map for a glyph that was rendered by a
+ * GlyphRasterizer, and copies its image there.  Returns the newly-created
+ * TextGlyph object, or NULL if the glyph could not be rendered or placed.
+ */
+CPT(TextGlyph) DynamicTextFont::
+place_glyph(const RasterizedGlyph &raster) {
+  if (!raster._valid) {
+    return nullptr;
   }
 
-  if (tex_x_size == 0 || tex_y_size == 0) {
+  if (raster._tex_x_size == 0 || raster._tex_y_size == 0) {
     // If we got an empty bitmap, it's a special case.
 
     PT(TextGlyph) glyph =
-      new DynamicTextGlyph(character, advance);
+      new DynamicTextGlyph(raster._character, raster._advance);
     _empty_glyphs.push_back(glyph);
     return glyph;
+  }
 
-  } else {
-    DynamicTextGlyph *glyph;
-
-    int outline = 0;
-
-    if (_render_mode == RM_distance_field) {
-      tex_x_size /= _scale_factor;
-      tex_y_size /= _scale_factor;
-      int int_x_size = (int)ceil(tex_x_size);
-      int int_y_size = (int)ceil(tex_y_size);
-
-      outline = 4;
-      int_x_size += outline * 2;
-      int_y_size += outline * 2;
-      tex_x_size += outline * 2;
-      tex_y_size += outline * 2;
-
-      PNMImage image(int_x_size, int_y_size, PNMImage::CT_grayscale);
-      render_distance_field(image, outline, bounds.xMin, bounds.yMin);
-
-      glyph = slot_glyph(character, int_x_size, int_y_size, advance);
-      if (glyph == nullptr) {
-        return nullptr;
-      }
-      if (!_needs_image_processing) {
-        copy_pnmimage_to_texture(image, glyph);
-      } else {
-        blend_pnmimage_to_texture(image, glyph, _fg);
-      }
-
-    } else if (_tex_pixels_per_unit == _font_pixels_per_unit &&
-               !_needs_image_processing) {
-      // If the bitmap produced from the font doesn't require scaling or any
-      // other processing before it goes to the texture, we can just copy it
-      // directly into the texture.
-      glyph = slot_glyph(character, bitmap.width, bitmap.rows, advance);
-      if (glyph == nullptr) {
-        return nullptr;
-      }
-      copy_bitmap_to_texture(bitmap, glyph);
-
-    } else {
-      // Otherwise, we need to copy to a PNMImage first, so we can scale it
-      // andor process it; and then copy it to the texture from there.
-      tex_x_size /= _scale_factor;
-      tex_y_size /= _scale_factor;
-      int int_x_size = (int)ceil(tex_x_size);
-      int int_y_size = (int)ceil(tex_y_size);
-      int bmp_x_size = (int)(int_x_size * _scale_factor + 0.5f);
-      int bmp_y_size = (int)(int_y_size * _scale_factor + 0.5f);
-
-      PNMImage image(bmp_x_size, bmp_y_size, PNMImage::CT_grayscale);
-      copy_bitmap_to_pnmimage(bitmap, image);
-
-      PNMImage reduced(int_x_size, int_y_size, PNMImage::CT_grayscale);
-      reduced.quick_filter_from(image);
-
-      // convert the outline width from points to tex_pixels.
-      PN_stdfloat outline_pixels = _outline_width / _points_per_unit * _tex_pixels_per_unit;
-      outline = (int)ceil(outline_pixels);
-
-      int_x_size += outline * 2;
-      int_y_size += outline * 2;
-      tex_x_size += outline * 2;
-      tex_y_size += outline * 2;
-      glyph = slot_glyph(character, int_x_size, int_y_size, advance);
-      if (glyph == nullptr) {
-        return nullptr;
-      }
-
-      if (outline != 0) {
-        // Pad the glyph image to make room for the outline.
-        PNMImage padded(int_x_size, int_y_size, PNMImage::CT_grayscale);
-        padded.copy_sub_image(reduced, outline, outline);
-        copy_pnmimage_to_texture(padded, glyph);
+  DynamicTextGlyph *glyph = slot_glyph(raster._character, raster._x_size,
+                                       raster._y_size, raster._advance);
+  if (glyph == nullptr) {
+    return nullptr;
+  }
 
-      } else {
-        copy_pnmimage_to_texture(reduced, glyph);
-      }
+  if (raster._direct) {
+    // The bitmap produced from the font can be copied directly into the
+    // texture, one row at a time.
+    const unsigned char *buffer_row = &raster._pixels[0];
+    for (int yi = 0; yi < raster._y_size; yi++) {
+      unsigned char *texture_row = glyph->get_row(yi);
+      nassertr(texture_row != nullptr, glyph);
+      memcpy(texture_row, buffer_row, raster._x_size);
+      buffer_row += raster._x_size;
     }
 
-    DynamicTextPage *page = glyph->get_page();
-    if (page != nullptr) {
-      int bitmap_top = (int)floor(tex_y_orig + outline * _scale_factor + 0.5f);
-      int bitmap_left = (int)floor(tex_x_orig - outline * _scale_factor + 0.5f);
-
-      tex_x_size += glyph->_margin * 2;
-      tex_y_size += glyph->_margin * 2;
-
-      // Determine the corners of the rectangle in geometric units.
-      PN_stdfloat tex_poly_margin = _poly_margin / _tex_pixels_per_unit;
-      PN_stdfloat origin_y = bitmap_top / _font_pixels_per_unit;
-      PN_stdfloat origin_x = bitmap_left / _font_pixels_per_unit;
-
-      LVecBase4 dimensions(
-        origin_x - tex_poly_margin,
-        origin_y - tex_y_size / _tex_pixels_per_unit - tex_poly_margin,
-        origin_x + tex_x_size / _tex_pixels_per_unit + tex_poly_margin,
-        origin_y + tex_poly_margin);
-
-      // And the corresponding corners in UV units.  We add 0.5f to center the
-      // UV in the middle of its texel, to minimize roundoff errors when we
-      // are close to 1-to-1 pixel size.
-      LVecBase2i page_size = page->get_size();
-      LVecBase4 texcoords(
-        ((PN_stdfloat)(glyph->_x - _poly_margin) + 0.5f) / page_size[0],
-        1.0f - ((PN_stdfloat)(glyph->_y + _poly_margin + tex_y_size) + 0.5f) / page_size[1],
-        ((PN_stdfloat)(glyph->_x + _poly_margin + tex_x_size) + 0.5f) / page_size[0],
-        1.0f - ((PN_stdfloat)(glyph->_y - _poly_margin) + 0.5f) / page_size[1]);
-
-      CPT(RenderState) state;
-      state = RenderState::make(TextureAttrib::make(page),
-                                TransparencyAttrib::make(alpha_mode));
-      state = state->add_attrib(ColorAttrib::make_flat(LColor(1.0f, 1.0f, 1.0f, 1.0f)), -1);
-
-      glyph->set_quad(dimensions, texcoords, state);
+  } else if (!_needs_image_processing) {
+    copy_pnmimage_to_texture(raster._image, glyph);
+
+  } else {
+    // The outline, if any, was already generated by the rasterizer.
+    if (raster._outline_image.is_valid()) {
+      blend_pnmimage_to_texture(raster._outline_image, glyph, _outline_color);
     }
+    blend_pnmimage_to_texture(raster._image, glyph, _fg);
+  }
 
-    return glyph;
+  DynamicTextPage *page = glyph->get_page();
+  if (page != nullptr) {
+    PN_stdfloat tex_x_size = raster._tex_x_size;
+    PN_stdfloat tex_y_size = raster._tex_y_size;
+    int outline = raster._outline;
+
+    int bitmap_top = (int)floor(raster._tex_y_orig + outline * _scale_factor + 0.5f);
+    int bitmap_left = (int)floor(raster._tex_x_orig - outline * _scale_factor + 0.5f);
+
+    tex_x_size += glyph->_margin * 2;
+    tex_y_size += glyph->_margin * 2;
+
+    // Determine the corners of the rectangle in geometric units.
+    PN_stdfloat tex_poly_margin = _poly_margin / _tex_pixels_per_unit;
+    PN_stdfloat origin_y = bitmap_top / _font_pixels_per_unit;
+    PN_stdfloat origin_x = bitmap_left / _font_pixels_per_unit;
+
+    LVecBase4 dimensions(
+      origin_x - tex_poly_margin,
+      origin_y - tex_y_size / _tex_pixels_per_unit - tex_poly_margin,
+      origin_x + tex_x_size / _tex_pixels_per_unit + tex_poly_margin,
+      origin_y + tex_poly_margin);
+
+    // And the corresponding corners in UV units.  We add 0.5f to center the
+    // UV in the middle of its texel, to minimize roundoff errors when we
+    // are close to 1-to-1 pixel size.
+    LVecBase2i page_size = page->get_size();
+    LVecBase4 texcoords(
+      ((PN_stdfloat)(glyph->_x - _poly_margin) + 0.5f) / page_size[0],
+      1.0f - ((PN_stdfloat)(glyph->_y + _poly_margin + tex_y_size) + 0.5f) / page_size[1],
+      ((PN_stdfloat)(glyph->_x + _poly_margin + tex_x_size) + 0.5f) / page_size[0],
+      1.0f - ((PN_stdfloat)(glyph->_y - _poly_margin) + 0.5f) / page_size[1]);
+
+    CPT(RenderState) state;
+    state = RenderState::make(TextureAttrib::make(page),
+                              TransparencyAttrib::make(raster._alpha_mode));
+    state = state->add_attrib(ColorAttrib::make_flat(LColor(1.0f, 1.0f, 1.0f, 1.0f)), -1);
+
+    glyph->set_quad(dimensions, texcoords, state);
   }
+
+  return glyph;
 }
 
 /**
- * Copies a bitmap as rendered by FreeType directly into the texture memory
- * image for the indicated glyph, without any scaling of pixels.
+ * Renders the glyphs for the indicated characters that are not already in the
+ * cache, and places them on the pages.  Returns the number of new glyphs.
  */
-void DynamicTextFont::
-copy_bitmap_to_texture(const FT_Bitmap &bitmap, DynamicTextGlyph *glyph) {
-  if (bitmap.pixel_mode == ft_pixel_mode_grays && bitmap.num_grays == 256) {
-    // This is the easy case: we can memcpy the rendered glyph directly into
-    // our texture image, one row at a time.
-    unsigned char *buffer_row = bitmap.buffer;
-    for (int yi = 0; yi < (int)bitmap.rows; yi++) {
+int DynamicTextFont::
+do_preload_glyphs(const pvector<int> &characters) {
+  if (!_is_valid) {
+    return 0;
+  }
 
-      unsigned char *texture_row = glyph->get_row(yi);
-      nassertv(texture_row != nullptr);
-      memcpy(texture_row, buffer_row, bitmap.width);
-      buffer_row += bitmap.pitch;
+  // First, determine which glyphs we don't have yet.
+  pvector<int> new_characters;
+  pvector<int> new_glyph_indices;
+  {
+    pset<int> glyph_indices;
+    FT_Face face = acquire_face();
+    for (size_t i = 0; i < characters.size(); ++i) {
+      int glyph_index = FT_Get_Char_Index(face, characters[i]);
+      if (_cache.find(glyph_index) == _cache.end() &&
+          glyph_indices.insert(glyph_index).second) {
+        new_characters.push_back(characters[i]);
+        new_glyph_indices.push_back(glyph_index);
+      }
     }
+    release_face(face);
+  }
 
-  } else if (bitmap.pixel_mode == ft_pixel_mode_mono) {
-    // This is a little bit more work: we have to expand the one-bit-per-pixel
-    // bitmap into a one-byte-per-pixel texture.
-    unsigned char *buffer_row = bitmap.buffer;
-    for (int yi = 0; yi < (int)bitmap.rows; yi++) {
-      unsigned char *texture_row = glyph->get_row(yi);
-      nassertv(texture_row != nullptr);
+  if (new_characters.empty()) {
+    return 0;
+  }
 
-      int bit = 0x80;
-      unsigned char *b = buffer_row;
-      for (int xi = 0; xi < (int)bitmap.width; xi++) {
-        if (*b & bit) {
-          texture_row[xi] = 0xff;
-        } else {
-          texture_row[xi] = 0x00;
-        }
-        bit >>= 1;
-        if (bit == 0) {
-          ++b;
-          bit = 0x80;
-        }
-      }
+  // These are constructed in place, since an empty PNMImage can't be copied.
+  pvector<RasterizedGlyph> rasters;
+  rasters.resize(new_characters.size());
+  for (size_t i = 0; i < rasters.size(); ++i) {
+    rasters[i]._character = new_characters[i];
+    rasters[i]._glyph_index = new_glyph_indices[i];
+  }
 
-      buffer_row += bitmap.pitch;
+  // Keep the new glyphs referenced until all of them are placed, so that
+  // garbage_collect() won't remove them again if a page fills up.
+  pvector<CPT(TextGlyph)> glyphs;
+  glyphs.reserve(rasters.size());
+
+  int num_threads = std::min((int)text_preload_threads, (int)rasters.size());
+  if (num_threads < 2 || !Thread::is_threading_supported() ||
+      (_render_mode != RM_texture && _render_mode != RM_distance_field)) {
+    // Make the glyphs one at a time, on this thread.
+    for (size_t i = 0; i < rasters.size(); ++i) {
+      FT_Face face = acquire_face();
+      CPT(TextGlyph) glyph = make_glyph(rasters[i]._character, face, rasters[i]._glyph_index);
+      release_face(face);
+      _cache.insert(Cache::value_type(rasters[i]._glyph_index, glyph.p()));
+      glyphs.push_back(glyph);
     }
+    return (int)rasters.size();
+  }
 
+  AsyncTaskManager *task_mgr = AsyncTaskManager::get_global_ptr();
+  if (task_mgr->find_task_chain("text_preload") == nullptr) {
+    PT(AsyncTaskChain) chain = task_mgr->make_task_chain("text_preload");
+    chain->set_num_threads(text_preload_threads);
+  }
 
-  } else if (bitmap.pixel_mode == ft_pixel_mode_grays) {
-    // Here we must expand a grayscale pixmap with n levels of gray into our
-    // 256-level texture.
-    unsigned char *buffer_row = bitmap.buffer;
-    for (int yi = 0; yi < (int)bitmap.rows; yi++) {
-      unsigned char *texture_row = glyph->get_row(yi);
-      nassertv(texture_row != nullptr);
-      for (int xi = 0; xi < (int)bitmap.width; xi++) {
-        texture_row[xi] = (int)(buffer_row[xi] * 255) / (bitmap.num_grays - 1);
-      }
-      buffer_row += bitmap.pitch;
-    }
+  // Render the glyphs on the task chain, each task taking every nth glyph.
+  pvector<PT(RasterizeTask)> tasks;
+  for (int ti = 0; ti < num_threads; ++ti) {
+    PT(RasterizeTask) task = new RasterizeTask(this, &rasters, ti, num_threads);
+    task->set_task_chain("text_preload");
+    task_mgr->add(task);
+    tasks.push_back(task);
+  }
+  for (size_t ti = 0; ti < tasks.size(); ++ti) {
+    tasks[ti]->wait();
+  }
 
-  } else {
-    text_cat.error()
-      << "Unexpected pixel mode in bitmap: " << (int)bitmap.pixel_mode << "\n";
+  // Now place them on the pages, in the order they were requested.
+  for (size_t i = 0; i < rasters.size(); ++i) {
+    CPT(TextGlyph) glyph = place_glyph(rasters[i]);
+    _cache.insert(Cache::value_type(rasters[i]._glyph_index, glyph.p()));
+    glyphs.push_back(glyph);
   }
+
+  return (int)rasters.size();
 }
 
 /**
@@ -805,33 +889,8 @@ copy_pnmimage_to_texture(const PNMImage &image, DynamicTextGlyph *glyph) {
 
   } else {
     if (_has_outline) {
-      // Gaussian blur the glyph to generate an outline.
-      PNMImage outline(image.get_x_size(), image.get_y_size(), PNMImage::CT_grayscale);
-      PN_stdfloat outline_pixels = _outline_width / _points_per_unit * _tex_pixels_per_unit;
-      outline.gaussian_filter_from(outline_pixels * 0.707, image);
-
-      // Filter the resulting outline to make a harder edge.  Square
-      // _outline_feather first to make the range more visually linear (this
-      // approximately compensates for the Gaussian falloff of the feathered
-      // edge).
-      PN_stdfloat f = _outline_feather * _outline_feather;
-
-      for (int yi = 0; yi < outline.get_y_size(); yi++) {
-        for (int xi = 0; xi < outline.get_x_size(); xi++) {
-          PN_stdfloat v = outline.get_gray(xi, yi);
-          if (v == 0.0f) {
-            // Do nothing.
-          } else if (v >= f) {
-            // Clamp to 1.
-            outline.set_gray(xi, yi, 1.0);
-          } else {
-            // Linearly scale the range 0 .. f onto 0 .. 1.
-            outline.set_gray(xi, yi, v / f);
-          }
-        }
-      }
-
-      // Now blend that into the texture.
+      PNMImage outline;
+      make_outline_image(image, outline);
       blend_pnmimage_to_texture(outline, glyph, _outline_color);
     }
 
@@ -842,6 +901,39 @@ copy_pnmimage_to_texture(const PNMImage &image, DynamicTextGlyph *glyph) {
   }
 }
 
+/**
+ * Generates the image of the outline for the indicated glyph image, by
+ * blurring it according to the font's outline width and feather.
+ */
+void DynamicTextFont::
+make_outline_image(const PNMImage &image, PNMImage &outline) const {
+  // Gaussian blur the glyph to generate an outline.
+  outline.clear(image.get_x_size(), image.get_y_size(), 1);
+  PN_stdfloat outline_pixels = _outline_width / _points_per_unit * _tex_pixels_per_unit;
+  outline.gaussian_filter_from(outline_pixels * 0.707, image);
+
+  // Filter the resulting outline to make a harder edge.  Square
+  // _outline_feather first to make the range more visually linear (this
+  // approximately compensates for the Gaussian falloff of the feathered
+  // edge).
+  PN_stdfloat f = _outline_feather * _outline_feather;
+
+  for (int yi = 0; yi < outline.get_y_size(); yi++) {
+    for (int xi = 0; xi < outline.get_x_size(); xi++) {
+      PN_stdfloat v = outline.get_gray(xi, yi);
+      if (v == 0.0f) {
+        // Do nothing.
+      } else if (v >= f) {
+        // Clamp to 1.
+        outline.set_gray(xi, yi, 1.0);
+      } else {
+        // Linearly scale the range 0 .. f onto 0 .. 1.
+        outline.set_gray(xi, yi, v / f);
+      }
+    }
+  }
+}
+
 /**
  * Blends the PNMImage into the appropriate part of the texture, where 0.0 in
  * the image indicates the color remains the same, and 1.0 indicates the color
@@ -1182,4 +1274,236 @@ render_polygon_contours(TextGlyph *glyph, bool face, bool extrude) {
   _contours.clear();
 }
 
+/**
+ * Makes a copy of the font's FreeType settings.  If own_face is true, the
+ * rasterizer also opens its own FT_Face on the same font data, so that it
+ * does not need to share the font's face with other threads.
+ */
+DynamicTextFont::GlyphRasterizer::
+GlyphRasterizer(const DynamicTextFont *font, bool own_face) :
+  FreetypeFont(*font),
+  _font(font)
+{
+  if (own_face && _face != nullptr) {
+    PT(FreetypeFace) face = _face->make_copy();
+    if (face != nullptr) {
+      _face = face;
+    }
+  }
+}
+
+/**
+ * Renders the glyph indicated by the RasterizedGlyph's glyph index, as
+ * make_glyph() would for a font with RM_texture or RM_distance_field, and
+ * stores the result in the RasterizedGlyph.  The face must already have been
+ * acquired.  This does not modify the DynamicTextFont.
+ */
+void DynamicTextFont::GlyphRasterizer::
+rasterize(RasterizedGlyph &raster, FT_Face face) {
+  if (!load_glyph(face, raster._glyph_index, false)) {
+    return;
+  }
+
+  FT_GlyphSlot slot = face->glyph;
+  FT_Bitmap &bitmap = slot->bitmap;
+
+  if ((bitmap.width == 0 || bitmap.rows == 0) && (raster._glyph_index == 0)) {
+    // Here's a special case: a glyph_index of 0 means an invalid glyph.  Some
+    // fonts define a symbol to represent an invalid glyph, but if that symbol
+    // is the empty bitmap, we return NULL, and use Panda's invalid glyph in
+    // its place.  We do this to guarantee that every invalid glyph is visible
+    // as *something*.
+    return;
+  }
+
+  raster._valid = true;
+  raster._advance = slot->advance.x / 64.0;
+  raster._advance /= _font_pixels_per_unit;
+
+  FT_BBox bounds;
+
+  if (_font->_render_mode == RM_texture) {
+    // Render the glyph if necessary.
+    if (slot->format != ft_glyph_format_bitmap) {
+      FT_Render_Glyph(slot, ft_render_mode_normal);
+    }
+
+    raster._tex_x_size = bitmap.width;
+    raster._tex_y_size = bitmap.rows;
+    raster._tex_x_orig = slot->bitmap_left;
+    raster._tex_y_orig = slot->bitmap_top;
+    raster._alpha_mode = TransparencyAttrib::M_alpha;
+
+  } else {
+    if (slot->format == ft_glyph_format_outline) {
+      decompose_outline(slot->outline);
+    }
+
+    // Calculate suitable texture dimensions for the signed distance field.
+    // This is the same calculation that Freetype uses in its bitmap renderer.
+    FT_Outline_Get_CBox(&slot->outline, &bounds);
+
+    bounds.xMin = bounds.xMin & ~63;
+    bounds.yMin = bounds.yMin & ~63;
+    bounds.xMax = (bounds.xMax + 63) & ~63;
+    bounds.yMax = (bounds.yMax + 63) & ~63;
+
+    raster._tex_x_size = (bounds.xMax - bounds.xMin) >> 6;
+    raster._tex_y_size = (bounds.yMax - bounds.yMin) >> 6;
+    raster._tex_x_orig = (bounds.xMin >> 6);
+    raster._tex_y_orig = (bounds.yMax >> 6);
+    raster._alpha_mode = TransparencyAttrib::M_binary;
+  }
+
+  if (raster._tex_x_size == 0 || raster._tex_y_size == 0) {
+    // An empty glyph, such as a space.
+    return;
+  }
+
+  if (_font->_render_mode == RM_distance_field) {
+    raster._tex_x_size /= _scale_factor;
+    raster._tex_y_size /= _scale_factor;
+    int int_x_size = (int)ceil(raster._tex_x_size);
+    int int_y_size = (int)ceil(raster._tex_y_size);
+
+    int outline = 4;
+    int_x_size += outline * 2;
+    int_y_size += outline * 2;
+    raster._tex_x_size += outline * 2;
+    raster._tex_y_size += outline * 2;
+
+    raster._image.clear(int_x_size, int_y_size, 1);
+    render_distance_field(raster._image, outline, bounds.xMin, bounds.yMin);
+
+    raster._outline = outline;
+    raster._x_size = int_x_size;
+    raster._y_size = int_y_size;
+
+  } else if (_tex_pixels_per_unit == _font_pixels_per_unit &&
+             !_font->_needs_image_processing) {
+    // If the bitmap produced from the font doesn't require scaling or any
+    // other processing before it goes to the texture, we can just copy it
+    // directly into the texture.
+    copy_bitmap(bitmap, raster);
+
+  } else {
+    // Otherwise, we need to copy to a PNMImage first, so we can scale it
+    // andor process it; and then copy it to the texture from there.
+    raster._tex_x_size /= _scale_factor;
+    raster._tex_y_size /= _scale_factor;
+    int int_x_size = (int)ceil(raster._tex_x_size);
+    int int_y_size = (int)ceil(raster._tex_y_size);
+    int bmp_x_size = (int)(int_x_size * _scale_factor + 0.5f);
+    int bmp_y_size = (int)(int_y_size * _scale_factor + 0.5f);
+
+    PNMImage image(bmp_x_size, bmp_y_size, PNMImage::CT_grayscale);
+    copy_bitmap_to_pnmimage(bitmap, image);
+
+    PNMImage reduced(int_x_size, int_y_size, PNMImage::CT_grayscale);
+    reduced.quick_filter_from(image);
+
+    // convert the outline width from points to tex_pixels.
+    PN_stdfloat outline_pixels = _font->_outline_width / _points_per_unit * _tex_pixels_per_unit;
+    int outline = (int)ceil(outline_pixels);
+
+    int_x_size += outline * 2;
+    int_y_size += outline * 2;
+    raster._tex_x_size += outline * 2;
+    raster._tex_y_size += outline * 2;
+
+    if (outline != 0) {
+      // Pad the glyph image to make room for the outline.
+      raster._image.clear(int_x_size, int_y_size, 1);
+      raster._image.copy_sub_image(reduced, outline, outline);
+    } else {
+      raster._image.take_from(reduced);
+    }
+
+    if (_font->_needs_image_processing && _font->_has_outline) {
+      _font->make_outline_image(raster._image, raster._outline_image);
+    }
+
+    raster._outline = outline;
+    raster._x_size = int_x_size;
+    raster._y_size = int_y_size;
+  }
+}
+
+/**
+ * Renders every step'th glyph of the list, starting at first.
+ */
+void DynamicTextFont::GlyphRasterizer::
+rasterize_range(pvector<RasterizedGlyph> &rasters, size_t first, size_t step) {
+  FT_Face face = acquire_face();
+  for (size_t i = first; i < rasters.size(); i += step) {
+    rasterize(rasters[i], face);
+  }
+  release_face(face);
+}
+
+/**
+ * Copies a bitmap as rendered by FreeType into the RasterizedGlyph's pixel
+ * buffer, one byte per pixel, without any scaling of pixels.
+ */
+void DynamicTextFont::GlyphRasterizer::
+copy_bitmap(const FT_Bitmap &bitmap, RasterizedGlyph &raster) {
+  int width = bitmap.width;
+  int rows = bitmap.rows;
+  raster._direct = true;
+  raster._x_size = width;
+  raster._y_size = rows;
+  raster._pixels.assign((size_t)width * rows, 0);
+
+  if (bitmap.pixel_mode == ft_pixel_mode_grays && bitmap.num_grays == 256) {
+    // This is the easy case: we can memcpy the rendered glyph directly into
+    // our buffer, one row at a time.
+    unsigned char *buffer_row = bitmap.buffer;
+    for (int yi = 0; yi < rows; yi++) {
+      memcpy(&raster._pixels[yi * width], buffer_row, width);
+      buffer_row += bitmap.pitch;
+    }
+
+  } else if (bitmap.pixel_mode == ft_pixel_mode_mono) {
+    // This is a little bit more work: we have to expand the one-bit-per-pixel
+    // bitmap into a one-byte-per-pixel texture.
+    unsigned char *buffer_row = bitmap.buffer;
+    for (int yi = 0; yi < rows; yi++) {
+      unsigned char *texture_row = &raster._pixels[yi * width];
+
+      int bit = 0x80;
+      unsigned char *b = buffer_row;
+      for (int xi = 0; xi < width; xi++) {
+        if (*b & bit) {
+          texture_row[xi] = 0xff;
+        } else {
+          texture_row[xi] = 0x00;
+        }
+        bit >>= 1;
+        if (bit == 0) {
+          ++b;
+          bit = 0x80;
+        }
+      }
+
+      buffer_row += bitmap.pitch;
+    }
+
+  } else if (bitmap.pixel_mode == ft_pixel_mode_grays) {
+    // Here we must expand a grayscale pixmap with n levels of gray into our
+    // 256-level texture.
+    unsigned char *buffer_row = bitmap.buffer;
+    for (int yi = 0; yi < rows; yi++) {
+      unsigned char *texture_row = &raster._pixels[yi * width];
+      for (int xi = 0; xi < width; xi++) {
+        texture_row[xi] = (int)(buffer_row[xi] * 255) / (bitmap.num_grays - 1);
+      }
+      buffer_row += bitmap.pitch;
+    }
+
+  } else {
+    text_cat.error()
+      << "Unexpected pixel mode in bitmap: " << (int)bitmap.pixel_mode << "\n";
+  }
+}
+
 #endif  // HAVE_FREETYPE
@@ -118,6 +118,9 @@ PUBLISHED:
   MAKE_SEQ(get_pages, get_num_pages, get_page);
   MAKE_SEQ_PROPERTY(pages, get_num_pages, get_page);
 
+  int preload_glyphs(const std::wstring &text);
+  int preload_glyph_range(int first, int last);
+
   int garbage_collect();
   void clear();
 
@@ -131,12 +134,18 @@ public:
   hb_font_t *get_hb_font() const;
 
 private:
+  class RasterizedGlyph;
+  class GlyphRasterizer;
+  class RasterizeTask;
+
   void initialize();
   void update_filters();
   void determine_tex_format();
   CPT(TextGlyph) make_glyph(int character, FT_Face face, int glyph_index);
-  void copy_bitmap_to_texture(const FT_Bitmap &bitmap, DynamicTextGlyph *glyph);
+  CPT(TextGlyph) place_glyph(const RasterizedGlyph &raster);
+  int do_preload_glyphs(const pvector<int> &characters);
   void copy_pnmimage_to_texture(const PNMImage &image, DynamicTextGlyph *glyph);
+  void make_outline_image(const PNMImage &image, PNMImage &outline) const;
   void blend_pnmimage_to_texture(const PNMImage &image, DynamicTextGlyph *glyph,
                                  const LColor &fg);
   DynamicTextGlyph *slot_glyph(int character, int x_size, int y_size, PN_stdfloat advance);
@@ -59,6 +59,8 @@ DynamicTextPage(DynamicTextFont *font, int page_number) :
 
   // Fill the page with the font's background color.
   fill_region(0, 0, _size[0], _size[1], font->get_bg());
+
+  _free_regions.push_back(LVecBase4i(0, 0, _size[0], _size[1]));
 }
 
 /**
@@ -75,6 +77,7 @@ slot_glyph(int character, int x_size, int y_size, int margin,
   }
 
   // The glyph can be fit at (x, y).  Slot it.
+  reserve_region(x, y, x_size, y_size);
   PT(DynamicTextGlyph) glyph =
     new DynamicTextGlyph(character, this,
                          x, y, x_size, y_size, margin, advance);
@@ -187,6 +190,12 @@ garbage_collect(DynamicTextFont *font) {
   }
 
   _glyphs.swap(new_glyphs);
+
+  if (removed_count != 0) {
+    // Merge the space freed by the removed glyphs with the surrounding free
+    // space, so that larger glyphs can fit there again.
+    rebuild_free_regions();
+  }
   return removed_count;
 }
 
@@ -194,58 +203,122 @@ garbage_collect(DynamicTextFont *font) {
  * Searches for a hole of at least x_size by y_size pixels somewhere within
  * the page.  If a suitable hole is found, sets x and y to the top left corner
  * and returns true; otherwise, returns false.
+ *
+ * Of all the free rectangles that are big enough, this picks the one that
+ * leaves the shortest leftover side, which tends to keep the remaining space
+ * in large pieces.
  */
 bool DynamicTextPage::
 find_hole(int &x, int &y, int x_size, int y_size) const {
-  y = 0;
-  while (y + y_size <= _size[1]) {
-    int next_y = _size[1];
-    // Scan along the row at 'y'.
-    x = 0;
-    while (x + x_size <= _size[0]) {
-      int next_x = x;
-
-      // Consider the spot at x, y.
-      DynamicTextGlyph *overlap = find_overlap(x, y, x_size, y_size);
-
-      if (overlap == nullptr) {
-        // Hooray!
-        return true;
-      }
+  int best_short_side = INT_MAX;
+  int best_long_side = INT_MAX;
+
+  Regions::const_iterator ri;
+  for (ri = _free_regions.begin(); ri != _free_regions.end(); ++ri) {
+    const LVecBase4i &region = (*ri);
+    if (region[2] < x_size || region[3] < y_size) {
+      continue;
+    }
 
-      next_x = overlap->_x + overlap->_x_size;
-      next_y = std::min(next_y, overlap->_y + overlap->_y_size);
-      nassertr(next_x > x, false);
-      x = next_x;
+    int leftover_x = region[2] - x_size;
+    int leftover_y = region[3] - y_size;
+    int short_side = std::min(leftover_x, leftover_y);
+    int long_side = std::max(leftover_x, leftover_y);
+    if (short_side < best_short_side ||
+        (short_side == best_short_side && long_side < best_long_side)) {
+      x = region[0];
+      y = region[1];
+      best_short_side = short_side;
+      best_long_side = long_side;
     }
+  }
 
-    nassertr(next_y > y, false);
-    y = next_y;
+  return (best_short_side != INT_MAX);
+}
+
+/**
+ * Removes the indicated rectangle from the free regions of the page.  Each
+ * free region that it intersects is split into the (up to four) maximal
+ * rectangles that remain around it.
+ */
+void DynamicTextPage::
+reserve_region(int x, int y, int x_size, int y_size) {
+  int right = x + x_size;
+  int bottom = y + y_size;
+
+  Regions new_regions;
+  new_regions.reserve(_free_regions.size() + 4);
+
+  Regions::const_iterator ri;
+  for (ri = _free_regions.begin(); ri != _free_regions.end(); ++ri) {
+    const LVecBase4i &region = (*ri);
+    int rright = region[0] + region[2];
+    int rbottom = region[1] + region[3];
+
+    if (x >= rright || right <= region[0] ||
+        y >= rbottom || bottom <= region[1]) {
+      // No overlap; keep this one as it is.
+      new_regions.push_back(region);
+      continue;
+    }
+
+    if (x > region[0]) {
+      new_regions.push_back(LVecBase4i(region[0], region[1],
+                                       x - region[0], region[3]));
+    }
+    if (right < rright) {
+      new_regions.push_back(LVecBase4i(right, region[1],
+                                       rright - right, region[3]));
+    }
+    if (y > region[1]) {
+      new_regions.push_back(LVecBase4i(region[0], region[1],
+                                       region[2], y - region[1]));
+    }
+    if (bottom < rbottom) {
+      new_regions.push_back(LVecBase4i(region[0], bottom,
+                                       region[2], rbottom - bottom));
+    }
   }
 
-  // Nope, wouldn't fit anywhere.
-  return false;
+  // Now remove any region that is wholly contained within another one.
+  _free_regions.clear();
+  size_t num_regions = new_regions.size();
+  for (size_t i = 0; i < num_regions; ++i) {
+    const LVecBase4i &a = new_regions[i];
+    bool contained = false;
+    for (size_t j = 0; j < num_regions && !contained; ++j) {
+      if (i == j) {
+        continue;
+      }
+      const LVecBase4i &b = new_regions[j];
+      if (a[0] >= b[0] && a[1] >= b[1] &&
+          a[0] + a[2] <= b[0] + b[2] && a[1] + a[3] <= b[1] + b[3]) {
+        // If the two are identical, keep only the later one.
+        contained = (a != b || i < j);
+      }
+    }
+    if (!contained) {
+      _free_regions.push_back(a);
+    }
+  }
 }
 
 /**
- * If the rectangle whose top left corner is x, y and whose size is x_size,
- * y_size describes an empty hole that does not overlap any placed glyphs,
- * returns NULL; otherwise, returns the first placed glyph that the image does
- * overlap.  It is assumed the rectangle lies completely within the boundaries
- * of the page itself.
+ * Recomputes the free regions of the page from the glyphs that remain on it.
+ * This is called after glyphs have been removed; the glyphs that remain are
+ * not moved, since their texture coordinates are already baked into any text
+ * that uses them.
  */
-DynamicTextGlyph *DynamicTextPage::
-find_overlap(int x, int y, int x_size, int y_size) const {
+void DynamicTextPage::
+rebuild_free_regions() {
+  _free_regions.clear();
+  _free_regions.push_back(LVecBase4i(0, 0, _size[0], _size[1]));
+
   Glyphs::const_iterator gi;
   for (gi = _glyphs.begin(); gi != _glyphs.end(); ++gi) {
     DynamicTextGlyph *glyph = (*gi);
-    if (glyph->intersects(x, y, x_size, y_size)) {
-      return glyph;
-    }
+    reserve_region(glyph->_x, glyph->_y, glyph->_x_size, glyph->_y_size);
   }
-
-  return nullptr;
 }
 
-
 #endif  // HAVE_FREETYPE
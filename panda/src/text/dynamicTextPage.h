@@ -51,11 +51,17 @@ private:
   int garbage_collect(DynamicTextFont *font);
 
   bool find_hole(int &x, int &y, int x_size, int y_size) const;
-  DynamicTextGlyph *find_overlap(int x, int y, int x_size, int y_size) const;
+  void reserve_region(int x, int y, int x_size, int y_size);
+  void rebuild_free_regions();
 
   typedef pvector< PT(DynamicTextGlyph) > Glyphs;
   Glyphs _glyphs;
 
+  // The maximal empty rectangles of the page, as (x, y, x_size, y_size).
+  // These may overlap each other, but none is contained within another.
+  typedef pvector<LVecBase4i> Regions;
+  Regions _free_regions;
+
   LVecBase2i _size;
 
   DynamicTextFont *_font;
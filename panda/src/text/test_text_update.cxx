@@ -0,0 +1,121 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_text_update.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "textNode.h"
+#include "config_text.h"
+#include "geomNode.h"
+#include "trueClock.h"
+
+/**
+ * Appends the vertex data of all of the Geoms under the node to the buffer.
+ */
+static void
+collect_vertices(PandaNode *node, pvector<unsigned char> &buffer) {
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = (GeomNode *)node;
+    for (int i = 0; i < geom_node->get_num_geoms(); ++i) {
+      CPT(GeomVertexArrayDataHandle) handle =
+        geom_node->get_geom(i)->get_vertex_data()->get_array_handle(0);
+      const unsigned char *data = handle->get_read_pointer(true);
+      buffer.insert(buffer.end(), data, data + handle->get_data_size_bytes());
+    }
+  }
+  for (int i = 0; i < node->get_num_children(); ++i) {
+    collect_vertices(node->get_child(i), buffer);
+  }
+}
+
+/**
+ * Makes num_nodes TextNodes, and changes the text of all of them on every
+ * frame, as a HUD full of counters and timers would.  Returns the time
+ * taken.
+ */
+static double
+run_frames(int num_nodes, int num_frames, pvector<PT(TextNode) > &nodes) {
+  nodes.clear();
+  for (int i = 0; i < num_nodes; ++i) {
+    PT(TextNode) node = new TextNode("counter");
+    if (i % 4 == 1) {
+      node->set_align(TextNode::A_center);
+    }
+    if (i % 4 == 2) {
+      node->set_shadow(0.05f, 0.05f);
+    }
+    node->set_text("Score: 0");
+    node->force_update();
+    nodes.push_back(node);
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int f = 0; f < num_frames; ++f) {
+    for (int i = 0; i < num_nodes; ++i) {
+      std::ostringstream strm;
+      strm << "Score: " << (f * 37 + i) << "\nTime: " << (f / 60) << ":"
+           << (f % 60);
+      nodes[i]->set_text(strm.str());
+      nodes[i]->force_update();
+    }
+  }
+  return clock->get_short_time() - start;
+}
+
+/**
+ * Times updating the text of many TextNodes on every frame, with and without
+ * text-incremental-update, and checks that the updated geometry matches
+ * freshly generated geometry.
+ */
+int
+main(int argc, char *argv[]) {
+  int num_nodes = 500;
+  int num_frames = 100;
+
+  if (argc > 1) {
+    num_nodes = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_frames = atoi(argv[2]);
+  }
+  if (argc > 3 || num_nodes <= 0 || num_frames <= 0) {
+    nout << "test_text_update [num_nodes [num_frames]]\n";
+    exit(1);
+  }
+
+  // Quiet the nuisance warning from get_internal_geom().
+  text_cat->set_severity(NS_warning);
+
+  pvector<PT(TextNode) > nodes;
+  text_incremental_update.set_value(false);
+  double full_time = run_frames(num_nodes, num_frames, nodes);
+
+  text_incremental_update.set_value(true);
+  double update_time = run_frames(num_nodes, num_frames, nodes);
+
+  int num_different = 0;
+  for (int i = 0; i < num_nodes; ++i) {
+    pvector<unsigned char> updated, generated;
+    collect_vertices(nodes[i]->get_internal_geom(), updated);
+    collect_vertices(nodes[i]->generate(), generated);
+    if (updated != generated) {
+      ++num_different;
+    }
+  }
+
+  nout << num_nodes << " text nodes, " << num_frames << " frames: "
+       << full_time << " s regenerating, " << update_time
+       << " s updating in place; " << num_different
+       << " nodes differ.\n";
+
+  return (num_different == 0) ? 0 : 1;
+}
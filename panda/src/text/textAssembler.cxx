@@ -634,6 +634,115 @@ assemble_text() {
   return parent_node;
 }
 
+/**
+ * Updates the text in a node previously returned by assemble_text() (or
+ * flattened from it) to show the current text, without creating a new node.
+ * The glyph quads that did not change are left alone; only the vertices of
+ * the quads that did change are rewritten in place.
+ *
+ * This is only possible if dynamic merge is enabled, and if the new text
+ * consists entirely of textured glyphs that use the same set of render
+ * states as the existing geometry; otherwise, this returns false without
+ * modifying the node, and the caller should call assemble_text() instead.
+ */
+bool TextAssembler::
+update_text(PandaNode *root) {
+  if (!_dynamic_merge) {
+    return false;
+  }
+
+  PlacedGlyphs placed_glyphs;
+  assemble_paragraph(placed_glyphs);
+
+  const TextProperties *properties = nullptr;
+  CPT(RenderState) text_state;
+  CPT(RenderState) shadow_state;
+  LVector2 shadow(0);
+
+  QuadMap quad_map;
+  QuadMap quad_shadow_map;
+
+  PlacedGlyphs::const_iterator pgi;
+  for (pgi = placed_glyphs.begin(); pgi != placed_glyphs.end(); ++pgi) {
+    const GlyphPlacement &placement = (*pgi);
+    if (placement._graphic_model != nullptr) {
+      // Graphics are parented as separate nodes.
+      return false;
+    }
+    if (placement._glyph.is_null()) {
+      continue;
+    }
+    if (!placement._glyph->has_quad()) {
+      return false;
+    }
+
+    if (placement._properties != properties) {
+      properties = placement._properties;
+      text_state = properties->get_text_state();
+
+      if (properties->has_shadow()) {
+        shadow = properties->get_shadow();
+        shadow_state = properties->get_shadow_state();
+      } else {
+        shadow.set(0, 0);
+        shadow_state.clear();
+      }
+    }
+
+    if (properties->has_shadow()) {
+      placement.assign_quad_to(quad_shadow_map, shadow_state, shadow);
+    }
+    placement.assign_quad_to(quad_map, text_state);
+  }
+  placed_glyphs.clear();
+
+  // Now find the Geom that holds the quads for each state.  Each state must
+  // already have exactly one Geom, or we can't do this in place.
+  QuadTargets targets;
+  if (!r_find_quad_targets(root, targets)) {
+    return false;
+  }
+
+  static const QuadDefs no_quads;
+  size_t num_found = 0;
+  for (size_t ti = 0; ti < targets.size(); ++ti) {
+    QuadTarget &target = targets[ti];
+    const RenderState *state = target._geom_node->get_geom_state(target._index);
+    for (size_t tj = 0; tj < ti; ++tj) {
+      if (targets[tj]._geom_node->get_geom_state(targets[tj]._index) == state) {
+        return false;
+      }
+    }
+
+    QuadMap::const_iterator qmi = quad_map.find(state);
+    QuadMap::const_iterator smi = quad_shadow_map.find(state);
+    if (qmi != quad_map.end()) {
+      if (smi != quad_shadow_map.end()) {
+        return false;
+      }
+      target._quads = &(*qmi).second;
+      ++num_found;
+    } else if (smi != quad_shadow_map.end()) {
+      target._quads = &(*smi).second;
+      ++num_found;
+    } else {
+      // No glyphs use this state any more.
+      target._quads = &no_quads;
+    }
+  }
+
+  if (num_found != quad_map.size() + quad_shadow_map.size()) {
+    // Some glyphs need a state that isn't in the node yet.
+    return false;
+  }
+
+  for (size_t ti = 0; ti < targets.size(); ++ti) {
+    const QuadTarget &target = targets[ti];
+    update_quads(target._geom_node, target._index, *target._quads);
+  }
+  return true;
+}
+
 /**
  * Returns the width of a single character, according to its associated font.
  * This also correctly calculates the width of cheesy ligatures and accented
@@ -1178,6 +1287,92 @@ calc_hyphen_width(const TextCharacter &tch) {
   return hyphen_width;
 }
 
+/**
+ * Writes the four vertices of the indicated quad in the order expected by
+ * generate_quads(), and advances the pointers past them.  The stride is
+ * measured in units of FloatType.
+ */
+template<class FloatType>
+void TextAssembler::
+write_quad(const QuadDef &quad, FloatType *&vtx_ptr, FloatType *&tex_ptr,
+           size_t stride) {
+  vtx_ptr[0] = quad._dimensions[0] + quad._slanth;
+  vtx_ptr[1] = 0;
+  vtx_ptr[2] = quad._dimensions[3];
+  vtx_ptr += stride;
+
+  tex_ptr[0] = quad._uvs[0];
+  tex_ptr[1] = quad._uvs[3];
+  tex_ptr += stride;
+
+  vtx_ptr[0] = quad._dimensions[0] + quad._slantl;
+  vtx_ptr[1] = 0;
+  vtx_ptr[2] = quad._dimensions[1];
+  vtx_ptr += stride;
+
+  tex_ptr[0] = quad._uvs[0];
+  tex_ptr[1] = quad._uvs[1];
+  tex_ptr += stride;
+
+  vtx_ptr[0] = quad._dimensions[2] + quad._slanth;
+  vtx_ptr[1] = 0;
+  vtx_ptr[2] = quad._dimensions[3];
+  vtx_ptr += stride;
+
+  tex_ptr[0] = quad._uvs[2];
+  tex_ptr[1] = quad._uvs[3];
+  tex_ptr += stride;
+
+  vtx_ptr[0] = quad._dimensions[2] + quad._slantl;
+  vtx_ptr[1] = 0;
+  vtx_ptr[2] = quad._dimensions[1];
+  vtx_ptr += stride;
+
+  tex_ptr[0] = quad._uvs[2];
+  tex_ptr[1] = quad._uvs[1];
+  tex_ptr += stride;
+}
+
+/**
+ * Writes the vertices for quads begin through end - 1 to the indicated
+ * buffer, which should point to the place for the first vertex of quad
+ * begin, in the format used by generate_quads().
+ */
+void TextAssembler::
+write_quads(const QuadDefs &quads, size_t begin, size_t end,
+            unsigned char *write_ptr) {
+  const GeomVertexFormat *format = GeomVertexFormat::get_v3t2();
+
+  // This is quite a critical loop and GeomVertexWriter quickly becomes the
+  // bottleneck.  So, I've written this out the hard way instead.  Two
+  // versions of the loop: one for 32-bit floats, the other for 64-bit.
+  if (format->get_vertex_column()->get_numeric_type() == GeomEnums::NT_float32) {
+    // 32-bit vertex case.
+    size_t stride = format->get_array(0)->get_stride() / sizeof(PN_float32);
+
+    PN_float32 *vtx_ptr = (PN_float32 *)
+      (write_ptr + format->get_column(InternalName::get_vertex())->get_start());
+    PN_float32 *tex_ptr = (PN_float32 *)
+      (write_ptr + format->get_column(InternalName::get_texcoord())->get_start());
+
+    for (size_t i = begin; i < end; ++i) {
+      write_quad(quads[i], vtx_ptr, tex_ptr, stride);
+    }
+  } else {
+    // 64-bit vertex case.
+    size_t stride = format->get_array(0)->get_stride() / sizeof(PN_float64);
+
+    PN_float64 *vtx_ptr = (PN_float64 *)
+      (write_ptr + format->get_column(InternalName::get_vertex())->get_start());
+    PN_float64 *tex_ptr = (PN_float64 *)
+      (write_ptr + format->get_column(InternalName::get_texcoord())->get_start());
+
+    for (size_t i = begin; i < end; ++i) {
+      write_quad(quads[i], vtx_ptr, tex_ptr, stride);
+    }
+  }
+}
+
 /**
  * Generates Geoms for the given quads and adds them to the GeomNode.
  */
@@ -1194,112 +1389,14 @@ generate_quads(GeomNode *geom_node, const QuadMap &quad_map) {
 
     Thread *current_thread = Thread::get_current_thread();
 
-    // This is quite a critical loop and GeomVertexWriter quickly becomes the
-    // bottleneck.  So, I've written this out the hard way instead.  Two
-    // versions of the loop: one for 32-bit floats, the other for 64-bit.
     {
       PT(GeomVertexArrayDataHandle) vtx_handle = vdata->modify_array_handle(0);
       vtx_handle->unclean_set_num_rows(quads.size() * 4);
+      write_quads(quads, 0, quads.size(), vtx_handle->get_write_pointer());
+    }
 
-      unsigned char *write_ptr = vtx_handle->get_write_pointer();
-
-      if (format->get_vertex_column()->get_numeric_type() == GeomEnums::NT_float32) {
-        // 32-bit vertex case.
-        size_t stride = format->get_array(0)->get_stride() / sizeof(PN_float32);
-
-        PN_float32 *vtx_ptr = (PN_float32 *)
-          (write_ptr + format->get_column(InternalName::get_vertex())->get_start());
-        PN_float32 *tex_ptr = (PN_float32 *)
-          (write_ptr + format->get_column(InternalName::get_texcoord())->get_start());
-
-        for (const QuadDef &quad : quads) {
-          vtx_ptr[0] = quad._dimensions[0] + quad._slanth;
-          vtx_ptr[1] = 0;
-          vtx_ptr[2] = quad._dimensions[3];
-          vtx_ptr += stride;
-
-          tex_ptr[0] = quad._uvs[0];
-          tex_ptr[1] = quad._uvs[3];
-          tex_ptr += stride;
-
-          vtx_ptr[0] = quad._dimensions[0] + quad._slantl;
-          vtx_ptr[1] = 0;
-          vtx_ptr[2] = quad._dimensions[1];
-          vtx_ptr += stride;
-
-          tex_ptr[0] = quad._uvs[0];
-          tex_ptr[1] = quad._uvs[1];
-          tex_ptr += stride;
-
-          vtx_ptr[0] = quad._dimensions[2] + quad._slanth;
-          vtx_ptr[1] = 0;
-          vtx_ptr[2] = quad._dimensions[3];
-          vtx_ptr += stride;
-
-          tex_ptr[0] = quad._uvs[2];
-          tex_ptr[1] = quad._uvs[3];
-          tex_ptr += stride;
-
-          vtx_ptr[0] = quad._dimensions[2] + quad._slantl;
-          vtx_ptr[1] = 0;
-          vtx_ptr[2] = quad._dimensions[1];
-          vtx_ptr += stride;
-
-          tex_ptr[0] = quad._uvs[2];
-          tex_ptr[1] = quad._uvs[1];
-          tex_ptr += stride;
-
-          glyphs.push_back(std::move(quad._glyph));
-        }
-      } else {
-        // 64-bit vertex case.
-        size_t stride = format->get_array(0)->get_stride() / sizeof(PN_float64);
-
-        PN_float64 *vtx_ptr = (PN_float64 *)
-          (write_ptr + format->get_column(InternalName::get_vertex())->get_start());
-        PN_float64 *tex_ptr = (PN_float64 *)
-          (write_ptr + format->get_column(InternalName::get_texcoord())->get_start());
-
-        for (const QuadDef &quad : quads) {
-          vtx_ptr[0] = quad._dimensions[0] + quad._slanth;
-          vtx_ptr[1] = 0;
-          vtx_ptr[2] = quad._dimensions[3];
-          vtx_ptr += stride;
-
-          tex_ptr[0] = quad._uvs[0];
-          tex_ptr[1] = quad._uvs[3];
-          tex_ptr += stride;
-
-          vtx_ptr[0] = quad._dimensions[0] + quad._slantl;
-          vtx_ptr[1] = 0;
-          vtx_ptr[2] = quad._dimensions[1];
-          vtx_ptr += stride;
-
-          tex_ptr[0] = quad._uvs[0];
-          tex_ptr[1] = quad._uvs[1];
-          tex_ptr += stride;
-
-          vtx_ptr[0] = quad._dimensions[2] + quad._slanth;
-          vtx_ptr[1] = 0;
-          vtx_ptr[2] = quad._dimensions[3];
-          vtx_ptr += stride;
-
-          tex_ptr[0] = quad._uvs[2];
-          tex_ptr[1] = quad._uvs[3];
-          tex_ptr += stride;
-
-          vtx_ptr[0] = quad._dimensions[2] + quad._slantl;
-          vtx_ptr[1] = 0;
-          vtx_ptr[2] = quad._dimensions[1];
-          vtx_ptr += stride;
-
-          tex_ptr[0] = quad._uvs[2];
-          tex_ptr[1] = quad._uvs[1];
-          tex_ptr += stride;
-
-          glyphs.push_back(std::move(quad._glyph));
-        }
-      }
+    for (const QuadDef &quad : quads) {
+      glyphs.push_back(quad._glyph);
     }
 
     // Now write the indices.  Two cases: 32-bit indices and 16-bit indices.
@@ -1350,6 +1447,174 @@ generate_quads(GeomNode *geom_node, const QuadMap &quad_map) {
   }
 }
 
+/**
+ * Collects the Geoms under the indicated node that were made by
+ * generate_quads().  Returns false if there are any other kinds of Geoms, or
+ * if any of them has been modified such that it can no longer be updated by
+ * update_quads().
+ */
+bool TextAssembler::
+r_find_quad_targets(PandaNode *node, QuadTargets &targets) {
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = (GeomNode *)node;
+    const GeomVertexFormat *format = GeomVertexFormat::get_v3t2();
+
+    int num_geoms = geom_node->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(Geom) geom = geom_node->get_geom(i);
+      if (!geom->is_of_type(GeomTextGlyph::get_class_type()) ||
+          geom->get_num_primitives() != 1) {
+        return false;
+      }
+      const GeomTextGlyph *text_geom = (const GeomTextGlyph *)geom.p();
+      const GeomPrimitive *prim = geom->get_primitive(0);
+      int num_quads = (int)text_geom->_glyphs.size();
+
+      CPT(GeomVertexData) vdata = geom->get_vertex_data();
+      if (vdata->get_format() != format ||
+          vdata->get_num_rows() != num_quads * 4 ||
+          !prim->is_of_type(GeomTriangles::get_class_type()) ||
+          !prim->is_indexed() ||
+          prim->get_num_vertices() != num_quads * 6) {
+        // It's been merged with something else by a flatten operation.
+        return false;
+      }
+
+      QuadTarget target;
+      target._geom_node = geom_node;
+      target._index = i;
+      target._quads = nullptr;
+      targets.push_back(target);
+    }
+  }
+
+  PandaNode::Children children = node->get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    if (!r_find_quad_targets(children.get_child(i), targets)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Replaces the quads in the nth Geom of the GeomNode, which was made by
+ * generate_quads(), with the indicated quads.  Only the vertices of the quads
+ * that have actually changed are written.
+ */
+void TextAssembler::
+update_quads(GeomNode *geom_node, int n, const QuadDefs &quads) {
+  size_t quad_size = GeomVertexFormat::get_v3t2()->get_array(0)->get_stride() * 4;
+  nassertv(quad_size <= sizeof(PN_float64) * 5 * 4);
+  int num_quads = (int)quads.size();
+
+  // Find the range of quads that differ from the existing ones.  Each new
+  // quad is written to a scratch buffer to compare it against the old one.
+  int old_num_quads;
+  int begin = 0;
+  int end = num_quads;
+  {
+    CPT(Geom) geom = geom_node->get_geom(n);
+    const GeomTextGlyph *text_geom = (const GeomTextGlyph *)geom.p();
+    old_num_quads = (int)text_geom->_glyphs.size();
+
+    CPT(GeomVertexArrayDataHandle) handle =
+      geom->get_vertex_data()->get_array_handle(0);
+    const unsigned char *old_data = handle->get_read_pointer(true);
+
+    PN_float64 scratch[5 * 4];
+    unsigned char *scratch_data = (unsigned char *)scratch;
+
+    int num_common = std::min(num_quads, old_num_quads);
+    while (begin < num_common && text_geom->_glyphs[begin] == quads[begin]._glyph) {
+      write_quads(quads, begin, begin + 1, scratch_data);
+      if (memcmp(old_data + begin * quad_size, scratch_data, quad_size) != 0) {
+        break;
+      }
+      ++begin;
+    }
+
+    if (num_quads == old_num_quads) {
+      while (end > begin && text_geom->_glyphs[end - 1] == quads[end - 1]._glyph) {
+        write_quads(quads, end - 1, end, scratch_data);
+        if (memcmp(old_data + (end - 1) * quad_size, scratch_data, quad_size) != 0) {
+          break;
+        }
+        --end;
+      }
+      if (begin == end) {
+        // Nothing has changed.
+        return;
+      }
+    }
+  }
+
+  PT(Geom) geom = geom_node->modify_geom(n);
+  GeomTextGlyph *text_geom = DCAST(GeomTextGlyph, geom);
+  text_geom->_glyphs.resize(num_quads);
+  for (int i = begin; i < end; ++i) {
+    text_geom->_glyphs[i] = quads[i]._glyph;
+  }
+
+  {
+    PT(GeomVertexData) vdata = geom->modify_vertex_data();
+    PT(GeomVertexArrayDataHandle) vtx_handle = vdata->modify_array_handle(0);
+    if (num_quads != old_num_quads) {
+      vtx_handle->set_num_rows(num_quads * 4);
+    }
+    write_quads(quads, begin, end,
+                vtx_handle->get_write_pointer() + begin * quad_size);
+  }
+
+  if (num_quads != old_num_quads) {
+    // The number of quads changed, so we have to change the indices as well.
+    // The existing indices remain valid.
+    int vtx_count = num_quads * 4;
+    PT(GeomPrimitive) tris = geom->modify_primitive(0);
+    if (vtx_count > 65535 && tris->get_index_type() == GeomEnums::NT_uint16) {
+      tris->set_index_type(GeomEnums::NT_uint32);
+    }
+
+    Thread *current_thread = Thread::get_current_thread();
+    PT(GeomVertexArrayDataHandle) idx_handle = tris->modify_vertices_handle(current_thread);
+    idx_handle->set_num_rows(num_quads * 6);
+    if (num_quads > old_num_quads) {
+      unsigned char *write_ptr = idx_handle->get_write_pointer();
+      if (tris->get_index_type() == GeomEnums::NT_uint16) {
+        // 16-bit index case.
+        uint16_t *idx_ptr = (uint16_t *)write_ptr + old_num_quads * 6;
+
+        for (int i = old_num_quads * 4; i < vtx_count; i += 4) {
+          *(idx_ptr++) = i + 0;
+          *(idx_ptr++) = i + 1;
+          *(idx_ptr++) = i + 2;
+          *(idx_ptr++) = i + 2;
+          *(idx_ptr++) = i + 1;
+          *(idx_ptr++) = i + 3;
+        }
+      } else {
+        // 32-bit index case.
+        uint32_t *idx_ptr = (uint32_t *)write_ptr + old_num_quads * 6;
+
+        for (int i = old_num_quads * 4; i < vtx_count; i += 4) {
+          *(idx_ptr++) = i + 0;
+          *(idx_ptr++) = i + 1;
+          *(idx_ptr++) = i + 2;
+          *(idx_ptr++) = i + 2;
+          *(idx_ptr++) = i + 1;
+          *(idx_ptr++) = i + 3;
+        }
+      }
+    }
+    idx_handle.clear();
+
+    if (vtx_count > 0) {
+      tris->set_minmax(0, vtx_count - 1, nullptr, nullptr);
+    }
+  }
+}
+
 /**
  * Fills up placed_glyphs, _ul, _lr with the contents of _text_block.  Also
  * updates _xpos and _ypos within the _text_block structure.
@@ -93,6 +93,7 @@ PUBLISHED:
   INLINE PN_stdfloat get_ypos(int r, int c) const;
 
   PT(PandaNode) assemble_text();
+  bool update_text(PandaNode *root);
 
   INLINE const LVector2 &get_ul() const;
   INLINE const LVector2 &get_lr() const;
@@ -224,6 +225,22 @@ private:
   typedef pmap<CPT(RenderState), QuadDefs> QuadMap;
 
   void generate_quads(GeomNode *geom_node, const QuadMap &quad_map);
+  static void write_quads(const QuadDefs &quads, size_t begin, size_t end,
+                          unsigned char *write_ptr);
+  template<class FloatType>
+  static void write_quad(const QuadDef &quad, FloatType *&vtx_ptr,
+                         FloatType *&tex_ptr, size_t stride);
+
+  class QuadTarget {
+  public:
+    GeomNode *_geom_node;
+    int _index;
+    const QuadDefs *_quads;
+  };
+  typedef pvector<QuadTarget> QuadTargets;
+
+  static bool r_find_quad_targets(PandaNode *node, QuadTargets &targets);
+  static void update_quads(GeomNode *geom_node, int n, const QuadDefs &quads);
 
   class GlyphPlacement {
   public:
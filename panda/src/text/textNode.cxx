@@ -16,6 +16,7 @@
 #include "stringDecoder.h"
 #include "config_text.h"
 #include "textAssembler.h"
+#include "dynamicTextFont.h"
 
 #include "compose_matrix.h"
 #include "geom.h"
@@ -54,6 +55,7 @@ using std::string;
 TypeHandle TextNode::_type_handle;
 
 PStatCollector TextNode::_text_generate_pcollector("*:Generate Text");
+PStatCollector TextNode::_text_update_pcollector("*:Generate Text:Update");
 
 /**
  *
@@ -325,7 +327,14 @@ get_internal_geom() const {
 void TextNode::
 text_changed() {
   MutexHolder holder(_lock);
+  bool needs_rebuild = (_flags & F_needs_rebuild) != 0;
   invalidate_with_measure();
+
+  if (!needs_rebuild) {
+    // Nothing but the text has changed since the text was last generated, so
+    // we may be able to update the existing geometry instead.
+    _flags |= F_text_changed;
+  }
 }
 
 /**
@@ -544,7 +553,12 @@ r_prepare_scene(GraphicsStateGuardianBase *gsg, const RenderState *node_state,
 void TextNode::
 do_rebuild() {
   nassertv(_lock.debug_is_locked());
-  _flags &= ~(F_needs_rebuild | F_needs_measure);
+  bool text_changed = (_flags & F_text_changed) != 0;
+  _flags &= ~(F_needs_rebuild | F_needs_measure | F_text_changed);
+
+  if (text_changed && do_update_text()) {
+    return;
+  }
   _internal_geom = do_generate();
 }
 
@@ -722,6 +736,89 @@ do_generate() {
   return root;
 }
 
+/**
+ * Called by do_rebuild() when nothing but the text has changed since the last
+ * call to do_generate(), to update the glyphs of the existing internal
+ * geometry in place.  Returns true if this was done, or false if the text
+ * needs to be generated again instead.
+ */
+bool TextNode::
+do_update_text() {
+  nassertr(_lock.debug_is_locked(), false);
+
+  if (!text_incremental_update || _internal_geom == nullptr ||
+      (_flatten_flags & FF_dynamic_merge) == 0 ||
+      (_flags & (F_has_card | F_has_frame)) != 0 || !has_text()) {
+    return false;
+  }
+
+  // Only the textured glyphs of a DynamicTextFont can be updated in place.
+  // Fonts made from models usually have polygon glyphs.
+#ifdef HAVE_FREETYPE
+  TextFont *font = get_font();
+  if (font == nullptr || !font->is_of_type(DynamicTextFont::get_class_type())) {
+    return false;
+  }
+  DynamicTextFont::RenderMode render_mode = DCAST(DynamicTextFont, font)->get_render_mode();
+  if (render_mode != TextFont::RM_texture &&
+      render_mode != TextFont::RM_distance_field) {
+    return false;
+  }
+#else
+  return false;
+#endif
+
+  PStatTimer timer(_text_update_pcollector);
+
+  std::wstring wtext = get_wtext();
+
+  TextAssembler assembler(this);
+  assembler.set_properties(*this);
+  assembler.set_max_rows(_max_rows);
+  assembler.set_usage_hint(_usage_hint);
+  assembler.set_dynamic_merge(true);
+  bool all_set = assembler.set_wtext(wtext);
+
+  if (!assembler.update_text(_internal_geom)) {
+    return false;
+  }
+
+  if (text_cat.is_debug()) {
+    text_cat.debug()
+      << "Updated " << get_type() << " " << get_name()
+      << " with '" << get_text() << "'\n";
+  }
+
+  if (all_set) {
+    _flags &= ~F_has_overflow;
+  } else {
+    _flags |= F_has_overflow;
+  }
+
+  _text_ul = assembler.get_ul();
+  _text_lr = assembler.get_lr();
+  _num_rows = assembler.get_num_rows();
+  _wordwrapped_wtext = assembler.get_wordwrapped_wtext();
+
+  const LVector2 &ul = assembler.get_ul();
+  const LVector2 &lr = assembler.get_lr();
+  _ul3d.set(ul[0], 0.0f, ul[1]);
+  _lr3d.set(lr[0], 0.0f, lr[1]);
+
+  _ul3d = _ul3d * _transform;
+  _lr3d = _lr3d * _transform;
+
+  // The root node is named for the first line of the text.
+  std::string name = get_text();
+  size_t newline = name.find('\n');
+  if (newline != std::string::npos) {
+    name = name.substr(0, newline);
+  }
+  _internal_geom->set_name(name);
+
+  return true;
+}
+
 /**
  * Returns the actual node that is used internally to render the text, if the
  * TextNode is parented within the scene graph.
@@ -304,6 +304,7 @@ private:
   void do_measure();
 
   PT(PandaNode) do_generate();
+  bool do_update_text();
   PT(PandaNode) do_get_internal_geom() const;
 
   PT(PandaNode) make_frame();
@@ -332,6 +333,7 @@ private:
     F_needs_measure    =  0x0200,
     F_has_overflow     =  0x0400,
     F_card_decal       =  0x0800,
+    F_text_changed     =  0x1000,
   };
 
   int _flags;
@@ -356,6 +358,7 @@ private:
   std::wstring _wordwrapped_wtext;
 
   static PStatCollector _text_generate_pcollector;
+  static PStatCollector _text_update_pcollector;
 
 public:
   static TypeHandle get_class_type() {
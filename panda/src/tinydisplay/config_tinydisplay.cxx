@@ -77,6 +77,13 @@ ConfigVariableBool td_perspective_textures
             "textures on the tinydisplay software renderer, for a small "
             "performance gain."));
 
+ConfigVariableBool td_simd
+  ("td-simd", true,
+   PRC_DESC("Configure this true to allow the tinydisplay software renderer "
+            "to use SSE2-optimized triangle-filling routines when the CPU "
+            "supports them.  These produce the same image as the generic "
+            "routines; set this false to compare the two."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
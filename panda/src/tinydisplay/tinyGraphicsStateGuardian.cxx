@@ -72,6 +72,7 @@ TinyGraphicsStateGuardian(GraphicsEngine *engine, GraphicsPipe *pipe,
   _c = nullptr;
   _vertices = nullptr;
   _vertices_size = 0;
+  _use_sse2 = false;
 }
 
 /**
@@ -135,6 +136,15 @@ reset() {
   _filled_flat = false;
   _auto_rescale_normal = false;
 
+#ifdef ZB_HAVE_SSE2
+  _use_sse2 = td_simd && ZB_has_sse2();
+  if (tinydisplay_cat.is_debug()) {
+    tinydisplay_cat.debug()
+      << "SSE2-optimized triangle-filling routines "
+      << (_use_sse2 ? "enabled" : "disabled") << ".\n";
+  }
+#endif
+
   // Now that the GSG has been initialized, make it available for
   // optimizations.
   add_gsg(this);
@@ -923,6 +933,16 @@ begin_draw_primitives(const GeomPipelineReader *geom_reader,
 
   _c->zb_fill_tri = fill_tri_funcs[depth_write_state][color_write_state][alpha_test_state][depth_test_state][texfilter_state][shade_model_state][texturing_state];
 
+#ifdef ZB_HAVE_SSE2
+  if (_use_sse2 && color_write_state <= 1 && alpha_test_state == 0 &&
+      texfilter_state == 0 && texturing_state <= 2) {
+    // There is a vectorized version of this function available; the common
+    // cases (opaque or alpha-blended, single nearest-filtered texture) are
+    // covered.
+    _c->zb_fill_tri = fill_tri_funcs_sse2[depth_write_state][color_write_state][depth_test_state][shade_model_state][texturing_state];
+  }
+#endif
+
 #ifdef DO_PSTATS
   pixel_count_white_untextured = 0;
   pixel_count_flat_untextured = 0;
@@ -3066,6 +3086,11 @@ get_tex_filter_func(SamplerState::FilterType filter) {
     return &lookup_texture_nearest;
 
   case SamplerState::FT_linear:
+#ifdef ZB_HAVE_SSE2
+    if (td_simd && ZB_has_sse2()) {
+      return &lookup_texture_bilinear_sse2;
+    }
+#endif
     return &lookup_texture_bilinear;
 
   case SamplerState::FT_nearest_mipmap_nearest:
@@ -164,6 +164,7 @@ private:
   bool _texture_replace;
   bool _filled_flat;
   bool _auto_rescale_normal;
+  bool _use_sse2;
 
   CPT(TransformState) _scissor_mat;
 
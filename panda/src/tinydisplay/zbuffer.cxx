@@ -659,3 +659,48 @@ texcoord_mirror_once(int coord, int max_coord) {
   }
   return max(coord, 0);
 }
+
+#ifdef ZB_HAVE_SSE2
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+// SSE2 support enabled at compile time.  No runtime detection mechanism
+// needed.
+int
+ZB_has_sse2() {
+  return 1;
+}
+
+#else
+// SSE2 support not guaranteed.  Use a runtime detection mechanism.
+
+#ifdef __GNUC__
+#include <cpuid.h>
+#endif
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#endif
+
+int
+ZB_has_sse2() {
+#if defined(__GNUC__)
+  unsigned int a, b, c, d;
+  static const int has_support =
+    (__get_cpuid(1, &a, &b, &c, &d) == 1 && (d & 0x04000000) != 0);
+
+#elif defined(_WIN32)
+  static const int has_support =
+    (IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE) != FALSE);
+
+#else
+  static const int has_support = 0;
+#endif
+
+  return has_support;
+}
+
+#endif  // __SSE2__
+#endif  // ZB_HAVE_SSE2
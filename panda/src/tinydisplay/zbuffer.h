@@ -257,6 +257,17 @@ void ZB_zoomFrameBuffer(ZBuffer *dest, int dest_xmin, int dest_ymin,
                         const ZBuffer *source, int source_xmin, int source_ymin,
                         int source_xsize, int source_ysize);
 
+/* ztriangle_sse2.c */
+
+#if defined(__SSE2__) || defined(__i386__) || defined(_M_IX86) || defined(_M_X64) || defined(_M_AMD64)
+// These may only be called if ZB_has_sse2() returns true.
+#define ZB_HAVE_SSE2 1
+int ZB_has_sse2();
+
+extern const ZB_fillTriangleFunc fill_tri_funcs_sse2[2][2][2][3][3];
+PIXEL lookup_texture_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx);
+#endif
+
 /* zdither.c */
 
 void ZB_initDither(ZBuffer *zb,int nb_colors,
@@ -0,0 +1,341 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file ztriangle_sse2.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+// This file should always be compiled with SSE2 support.  These functions
+// will only be called when SSE2 support is detected at run-time; see
+// ZB_has_sse2().
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "pandabase.h"
+#include "zbuffer.h"
+
+#if defined(__SSE2__) || (_M_IX86_FP >= 2) || defined(_M_X64) || defined(_M_AMD64)
+
+#include <emmintrin.h>
+
+/**
+ * Returns the low 32 bits of the unsigned product of each lane, like the
+ * scalar (unsigned int) multiply.  SSE2 has no pmulld, so the even and odd
+ * lanes are multiplied separately.
+ */
+static INLINE __m128i
+mullo_epu32_sse2(__m128i a, __m128i b) {
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/**
+ * Returns a mask of the lanes in which a < b, treating both as unsigned.
+ */
+static INLINE __m128i
+cmplt_epu32_sse2(__m128i a, __m128i b) {
+  const __m128i bias = _mm_set1_epi32((int)0x80000000);
+  return _mm_cmplt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+/**
+ * Returns (0, d, 2d, 3d): the offsets of an interpolated value across four
+ * consecutive pixels.
+ */
+static INLINE __m128i
+ramp_epi32_sse2(int d) {
+  unsigned int ud = (unsigned int)d;
+  return _mm_set_epi32((int)(ud * 3), (int)(ud * 2), (int)ud, 0);
+}
+
+/**
+ * Returns a where the mask is set, and b elsewhere.
+ */
+static INLINE __m128i
+select_si128_sse2(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// The four-pixel equivalents of the macros in zbuffer.h.
+
+static INLINE __m128i
+rgba_to_pixel_sse2(__m128i r, __m128i g, __m128i b, __m128i a) {
+  __m128i pa = _mm_and_si128(_mm_slli_epi32(a, 16), _mm_set1_epi32((int)0xff000000));
+  __m128i pr = _mm_and_si128(_mm_slli_epi32(r, 8), _mm_set1_epi32(0xff0000));
+  __m128i pg = _mm_and_si128(g, _mm_set1_epi32(0xff00));
+  __m128i pb = _mm_srli_epi32(b, 8);
+  return _mm_or_si128(_mm_or_si128(pa, pr), _mm_or_si128(pg, pb));
+}
+
+static INLINE __m128i
+pixel_r_sse2(__m128i p) {
+  return _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xff0000)), 8);
+}
+
+static INLINE __m128i
+pixel_g_sse2(__m128i p) {
+  return _mm_and_si128(p, _mm_set1_epi32(0xff00));
+}
+
+static INLINE __m128i
+pixel_b_sse2(__m128i p) {
+  return _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xff)), 8);
+}
+
+static INLINE __m128i
+pixel_a_sse2(__m128i p) {
+  return _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32((int)0xff000000)), 16);
+}
+
+static INLINE __m128i
+pcomponent_mult_sse2(__m128i c1, __m128i c2) {
+  return _mm_srli_epi32(mullo_epu32_sse2(c1, c2), 16);
+}
+
+static INLINE __m128i
+palpha_mult_sse2(__m128i c1, __m128i c2) {
+  return _mm_srai_epi32(mullo_epu32_sse2(_mm_srai_epi32(c1, 2), c2), 14);
+}
+
+static INLINE __m128i
+pcomponent_blend_sse2(__m128i c1, __m128i c2, __m128i a2) {
+  __m128i inv_a2 = _mm_sub_epi32(_mm_set1_epi32(0xffff), a2);
+  return _mm_srli_epi32(_mm_add_epi32(mullo_epu32_sse2(c1, inv_a2),
+                                      mullo_epu32_sse2(c2, a2)), 16);
+}
+
+static INLINE __m128i
+palpha_blend_sse2(__m128i a1, __m128i a2) {
+  __m128i inv_a2 = _mm_sub_epi32(_mm_set1_epi32(0xffff), a2);
+  return _mm_add_epi32(_mm_srli_epi32(mullo_epu32_sse2(a1, inv_a2), 16), a2);
+}
+
+static INLINE __m128i
+pixel_blend_rgb_sse2(__m128i rgb, __m128i r, __m128i g, __m128i b, __m128i a) {
+  return rgba_to_pixel_sse2(pcomponent_blend_sse2(pixel_r_sse2(rgb), r, a),
+                            pcomponent_blend_sse2(pixel_g_sse2(rgb), g, a),
+                            pcomponent_blend_sse2(pixel_b_sse2(rgb), b, a),
+                            palpha_blend_sse2(pixel_a_sse2(rgb), a));
+}
+
+/**
+ * Looks up four texels in the base level of the texture.  The texel indices
+ * are computed in parallel, but the fetches themselves are scalar.
+ */
+static INLINE __m128i
+lookup_texture_nearest_sse2(const ZTextureDef *texture_def, __m128i s, __m128i t) {
+  const ZTextureLevel &level = texture_def->levels[0];
+  __m128i si = _mm_srl_epi32(_mm_and_si128(s, _mm_set1_epi32((int)level.s_mask)),
+                             _mm_cvtsi32_si128((int)level.s_shift));
+  __m128i ti = _mm_srl_epi32(_mm_and_si128(t, _mm_set1_epi32((int)level.t_mask)),
+                             _mm_cvtsi32_si128((int)level.t_shift));
+  ALIGN_16BYTE unsigned int index[4];
+  _mm_store_si128((__m128i *)index, _mm_or_si128(si, ti));
+
+  const PIXEL *pixmap = level.pixmap;
+  return _mm_set_epi32((int)pixmap[index[3]], (int)pixmap[index[2]],
+                       (int)pixmap[index[1]], (int)pixmap[index[0]]);
+}
+
+/* The remaining per-combination macros.  The scalar ones match the
+   definitions generated by ztriangle.py. */
+
+#define ACMP(zb, a) 1
+#define CALC_MIPMAP_LEVEL(mipmap_level, mipmap_dx, dsdx, dtdx)
+#define ZB_LOOKUP_TEXTURE(texture_def, s, t, level, level_dx) ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t)
+
+#define STORE_Z_ON(zpix, z) (zpix) = (z)
+#define STORE_Z_OFF(zpix, z)
+#define STORE_Z4_ON(zp, mask, zold, z) _mm_storeu_si128((__m128i *)(zp), select_si128_sse2(mask, z, zold))
+#define STORE_Z4_OFF(zp, mask, zold, z)
+
+#define STORE_PIX_STORE(pix, rgb, r, g, b, a) (pix) = (rgb)
+#define STORE_PIX_BLEND(pix, rgb, r, g, b, a) (pix) = PIXEL_BLEND_RGB(pix, r, g, b, a)
+#define STORE_PIX4_STORE(pp, mask, rgb, r, g, b, a)                     \
+  {                                                                     \
+    __m128i pold4 = _mm_loadu_si128((const __m128i *)(pp));             \
+    _mm_storeu_si128((__m128i *)(pp), select_si128_sse2(mask, rgb, pold4)); \
+  }
+#define STORE_PIX4_BLEND(pp, mask, rgb, r, g, b, a)                     \
+  {                                                                     \
+    __m128i pold4 = _mm_loadu_si128((const __m128i *)(pp));             \
+    __m128i pnew4 = pixel_blend_rgb_sse2(pold4, r, g, b, a);            \
+    _mm_storeu_si128((__m128i *)(pp), select_si128_sse2(mask, pnew4, pold4)); \
+  }
+
+#define ZCMP_NONE(zpix, z) 1
+#define ZCMP_LESS(zpix, z) ((ZPOINT)(zpix) < (ZPOINT)(z))
+#define ZCMP4_NONE(zold, z) _mm_set1_epi32(-1)
+#define ZCMP4_LESS(zold, z) cmplt_epu32_sse2(zold, z)
+
+#define STORE_Z(zpix, z) STORE_Z_ON(zpix, z)
+#define STORE_Z4(zp, mask, zold, z) STORE_Z4_ON(zp, mask, zold, z)
+#define STORE_PIX(pix, rgb, r, g, b, a) STORE_PIX_STORE(pix, rgb, r, g, b, a)
+#define STORE_PIX4(pp, mask, rgb, r, g, b, a) STORE_PIX4_STORE(pp, mask, rgb, r, g, b, a)
+#define ZCMP(zpix, z) ZCMP_NONE(zpix, z)
+#define ZCMP4(zold, z) ZCMP4_NONE(zold, z)
+#define FNAME(name) FB_triangle_sse2_zon_cstore_znone_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define STORE_Z(zpix, z) STORE_Z_ON(zpix, z)
+#define STORE_Z4(zp, mask, zold, z) STORE_Z4_ON(zp, mask, zold, z)
+#define STORE_PIX(pix, rgb, r, g, b, a) STORE_PIX_STORE(pix, rgb, r, g, b, a)
+#define STORE_PIX4(pp, mask, rgb, r, g, b, a) STORE_PIX4_STORE(pp, mask, rgb, r, g, b, a)
+#define ZCMP(zpix, z) ZCMP_LESS(zpix, z)
+#define ZCMP4(zold, z) ZCMP4_LESS(zold, z)
+#define FNAME(name) FB_triangle_sse2_zon_cstore_zless_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define STORE_Z(zpix, z) STORE_Z_ON(zpix, z)
+#define STORE_Z4(zp, mask, zold, z) STORE_Z4_ON(zp, mask, zold, z)
+#define STORE_PIX(pix, rgb, r, g, b, a) STORE_PIX_BLEND(pix, rgb, r, g, b, a)
+#define STORE_PIX4(pp, mask, rgb, r, g, b, a) STORE_PIX4_BLEND(pp, mask, rgb, r, g, b, a)
+#define ZCMP(zpix, z) ZCMP_NONE(zpix, z)
+#define ZCMP4(zold, z) ZCMP4_NONE(zold, z)
+#define FNAME(name) FB_triangle_sse2_zon_cblend_znone_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define STORE_Z(zpix, z) STORE_Z_ON(zpix, z)
+#define STORE_Z4(zp, mask, zold, z) STORE_Z4_ON(zp, mask, zold, z)
+#define STORE_PIX(pix, rgb, r, g, b, a) STORE_PIX_BLEND(pix, rgb, r, g, b, a)
+#define STORE_PIX4(pp, mask, rgb, r, g, b, a) STORE_PIX4_BLEND(pp, mask, rgb, r, g, b, a)
+#define ZCMP(zpix, z) ZCMP_LESS(zpix, z)
+#define ZCMP4(zold, z) ZCMP4_LESS(zold, z)
+#define FNAME(name) FB_triangle_sse2_zon_cblend_zless_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define STORE_Z(zpix, z) STORE_Z_OFF(zpix, z)
+#define STORE_Z4(zp, mask, zold, z) STORE_Z4_OFF(zp, mask, zold, z)
+#define STORE_PIX(pix, rgb, r, g, b, a) STORE_PIX_STORE(pix, rgb, r, g, b, a)
+#define STORE_PIX4(pp, mask, rgb, r, g, b, a) STORE_PIX4_STORE(pp, mask, rgb, r, g, b, a)
+#define ZCMP(zpix, z) ZCMP_NONE(zpix, z)
+#define ZCMP4(zold, z) ZCMP4_NONE(zold, z)
+#define FNAME(name) FB_triangle_sse2_zoff_cstore_znone_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define STORE_Z(zpix, z) STORE_Z_OFF(zpix, z)
+#define STORE_Z4(zp, mask, zold, z) STORE_Z4_OFF(zp, mask, zold, z)
+#define STORE_PIX(pix, rgb, r, g, b, a) STORE_PIX_STORE(pix, rgb, r, g, b, a)
+#define STORE_PIX4(pp, mask, rgb, r, g, b, a) STORE_PIX4_STORE(pp, mask, rgb, r, g, b, a)
+#define ZCMP(zpix, z) ZCMP_LESS(zpix, z)
+#define ZCMP4(zold, z) ZCMP4_LESS(zold, z)
+#define FNAME(name) FB_triangle_sse2_zoff_cstore_zless_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define STORE_Z(zpix, z) STORE_Z_OFF(zpix, z)
+#define STORE_Z4(zp, mask, zold, z) STORE_Z4_OFF(zp, mask, zold, z)
+#define STORE_PIX(pix, rgb, r, g, b, a) STORE_PIX_BLEND(pix, rgb, r, g, b, a)
+#define STORE_PIX4(pp, mask, rgb, r, g, b, a) STORE_PIX4_BLEND(pp, mask, rgb, r, g, b, a)
+#define ZCMP(zpix, z) ZCMP_NONE(zpix, z)
+#define ZCMP4(zold, z) ZCMP4_NONE(zold, z)
+#define FNAME(name) FB_triangle_sse2_zoff_cblend_znone_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define STORE_Z(zpix, z) STORE_Z_OFF(zpix, z)
+#define STORE_Z4(zp, mask, zold, z) STORE_Z4_OFF(zp, mask, zold, z)
+#define STORE_PIX(pix, rgb, r, g, b, a) STORE_PIX_BLEND(pix, rgb, r, g, b, a)
+#define STORE_PIX4(pp, mask, rgb, r, g, b, a) STORE_PIX4_BLEND(pp, mask, rgb, r, g, b, a)
+#define ZCMP(zpix, z) ZCMP_LESS(zpix, z)
+#define ZCMP4(zold, z) ZCMP4_LESS(zold, z)
+#define FNAME(name) FB_triangle_sse2_zoff_cblend_zless_ ## name
+#include "ztriangle_two_sse2.h"
+
+#define SSE2_FUNCS(prefix)                                              \
+  {                                                                     \
+    {                                                                   \
+      prefix ## white_untextured,                                       \
+      prefix ## white_textured,                                         \
+      prefix ## white_perspective                                       \
+    },                                                                  \
+    {                                                                   \
+      prefix ## flat_untextured,                                        \
+      prefix ## flat_textured,                                          \
+      prefix ## flat_perspective                                        \
+    },                                                                  \
+    {                                                                   \
+      prefix ## smooth_untextured,                                      \
+      prefix ## smooth_textured,                                        \
+      prefix ## smooth_perspective                                      \
+    }                                                                   \
+  }
+
+/**
+ * Indexed the same way as fill_tri_funcs, except that only the first two
+ * color write states and the first three texturing states are present, and
+ * the alpha test and texture filter dimensions are omitted (anone and
+ * tnearest are implied).
+ */
+const ZB_fillTriangleFunc fill_tri_funcs_sse2[2][2][2][3][3] = {
+  {
+    {
+      SSE2_FUNCS(FB_triangle_sse2_zon_cstore_znone_),
+      SSE2_FUNCS(FB_triangle_sse2_zon_cstore_zless_),
+    },
+    {
+      SSE2_FUNCS(FB_triangle_sse2_zon_cblend_znone_),
+      SSE2_FUNCS(FB_triangle_sse2_zon_cblend_zless_),
+    },
+  },
+  {
+    {
+      SSE2_FUNCS(FB_triangle_sse2_zoff_cstore_znone_),
+      SSE2_FUNCS(FB_triangle_sse2_zoff_cstore_zless_),
+    },
+    {
+      SSE2_FUNCS(FB_triangle_sse2_zoff_cblend_znone_),
+      SSE2_FUNCS(FB_triangle_sse2_zoff_cblend_zless_),
+    },
+  },
+};
+
+#define ZB_ST_FRAC_HIGH (1 << ZB_POINT_ST_FRAC_BITS)
+#define ZB_ST_FRAC_MASK (ZB_ST_FRAC_HIGH - 1)
+
+/**
+ * A version of lookup_texture_bilinear() that filters all four channels at
+ * once.  The fixed-point arithmetic is the same, so the result is identical.
+ */
+PIXEL
+lookup_texture_bilinear_sse2(ZTextureDef *texture_def, int s, int t, unsigned int level, unsigned int level_dx) {
+  const __m128i zero = _mm_setzero_si128();
+
+  // Expand each texel to four 32-bit lanes (b, g, r, a), scaled up the same
+  // way as the PIXEL_R() etc. macros do.
+  __m128i p1 = _mm_cvtsi32_si128((int)ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t - ZB_ST_FRAC_HIGH));
+  __m128i p2 = _mm_cvtsi32_si128((int)ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t - ZB_ST_FRAC_HIGH));
+  __m128i p3 = _mm_cvtsi32_si128((int)ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s - ZB_ST_FRAC_HIGH, t));
+  __m128i p4 = _mm_cvtsi32_si128((int)ZB_LOOKUP_TEXTURE_NEAREST(texture_def, s, t));
+  p1 = _mm_slli_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(p1, zero), zero), 8);
+  p2 = _mm_slli_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(p2, zero), zero), 8);
+  p3 = _mm_slli_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(p3, zero), zero), 8);
+  p4 = _mm_slli_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(p4, zero), zero), 8);
+
+  __m128i sf = _mm_set1_epi32(s & ZB_ST_FRAC_MASK);
+  __m128i tf = _mm_set1_epi32(t & ZB_ST_FRAC_MASK);
+  __m128i sf_inv = _mm_sub_epi32(_mm_set1_epi32(ZB_ST_FRAC_HIGH), sf);
+  __m128i tf_inv = _mm_sub_epi32(_mm_set1_epi32(ZB_ST_FRAC_HIGH), tf);
+
+  // This is BILINEAR_FILTER, from zbuffer.cxx.
+  __m128i c12 = _mm_add_epi32(_mm_srli_epi32(mullo_epu32_sse2(p2, sf), ZB_POINT_ST_FRAC_BITS),
+                              _mm_srli_epi32(mullo_epu32_sse2(p1, sf_inv), ZB_POINT_ST_FRAC_BITS));
+  __m128i c34 = _mm_add_epi32(_mm_srli_epi32(mullo_epu32_sse2(p4, sf), ZB_POINT_ST_FRAC_BITS),
+                              _mm_srli_epi32(mullo_epu32_sse2(p3, sf_inv), ZB_POINT_ST_FRAC_BITS));
+  __m128i c = _mm_add_epi32(_mm_srli_epi32(mullo_epu32_sse2(c34, tf), ZB_POINT_ST_FRAC_BITS),
+                            _mm_srli_epi32(mullo_epu32_sse2(c12, tf_inv), ZB_POINT_ST_FRAC_BITS));
+
+  // Each channel is at most 0xff00, so this is equivalent to RGBA_TO_PIXEL.
+  c = _mm_srli_epi32(c, 8);
+  c = _mm_packs_epi32(c, c);
+  c = _mm_packus_epi16(c, c);
+  return (PIXEL)_mm_cvtsi128_si32(c);
+}
+
+#endif  // __SSE2__
@@ -0,0 +1,871 @@
+/*
+ * SSE2 variants of the triangle-filling functions in ztriangle_two.h.
+ * These share the edge-walking code in ztriangle.h, but replace the
+ * inner span loop (via DRAW_LINE) with one that shades four pixels per
+ * iteration.  The leftover pixels at the end of each span are handled by
+ * the same scalar PUT_PIXEL as the generic code, so the results are
+ * bit-identical to the scalar functions.
+ *
+ * Only the inlined cases are covered here: no alpha test, nearest texture
+ * filtering, and a single texture stage.  In addition to the macros
+ * required by ztriangle_two.h, the includer must define ZCMP4, STORE_Z4
+ * and STORE_PIX4, the four-pixel versions of ZCMP, STORE_Z and STORE_PIX.
+ */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#endif
+
+static void
+FNAME(white_untextured) (ZBuffer *zb,
+                         ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  __m128i zramp;
+
+#define INTERP_Z
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      STORE_PIX(pp[_a], 0xffffffffUL, 0xffffUL, 0xffffUL, 0xffffUL, 0xffffUL); \
+      STORE_Z(pz[_a], zz);                                              \
+    }                                                                   \
+    z+=dzdx;                                                            \
+  }
+
+#define PUT_PIXEL4()                                                    \
+  {                                                                     \
+    __m128i zz4 = _mm_srli_epi32(_mm_add_epi32(_mm_set1_epi32(z), zramp), \
+                                 ZB_POINT_Z_FRAC_BITS);                 \
+    __m128i zold4 = _mm_loadu_si128((const __m128i *)pz);               \
+    __m128i mask4 = ZCMP4(zold4, zz4);                                  \
+    if (_mm_movemask_epi8(mask4) != 0) {                                \
+      __m128i white4 = _mm_set1_epi32(0xffff);                          \
+      STORE_PIX4(pp, mask4, _mm_set1_epi32(-1),                         \
+                 white4, white4, white4, white4);                       \
+      STORE_Z4(pz, mask4, zold4, zz4);                                  \
+    }                                                                   \
+    z+=4*(unsigned int)dzdx;                                            \
+  }
+
+#define DRAW_LINE()                                                     \
+  {                                                                     \
+    PIXEL *pp;                                                          \
+    ZPOINT *pz;                                                         \
+    unsigned int z,zz;                                                  \
+    int n;                                                              \
+    n=(x2 >> 16) - x1;                                                  \
+    pp=(PIXEL *)((char *)pp1 + x1 * PSZB);                              \
+    pz=pz1+x1;                                                          \
+    z=z1;                                                               \
+    while (n>=3) {                                                      \
+      PUT_PIXEL4();                                                     \
+      pz+=4;                                                            \
+      pp=(PIXEL *)((char *)pp + 4 * PSZB);                              \
+      n-=4;                                                             \
+    }                                                                   \
+    while (n>=0) {                                                      \
+      PUT_PIXEL(0);                                                     \
+      pz+=1;                                                            \
+      pp=(PIXEL *)((char *)pp + PSZB);                                  \
+      n-=1;                                                             \
+    }                                                                   \
+  }
+
+#define PIXEL_COUNT pixel_count_white_untextured
+
+#include "ztriangle.h"
+#undef PUT_PIXEL4
+}
+
+static void
+FNAME(flat_untextured) (ZBuffer *zb,
+                        ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  __m128i zramp;
+  UNUSED int color;
+  UNUSED int or0, og0, ob0, oa0;
+
+#define INTERP_Z
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    if (!ACMP(zb, p2->a)) {                                             \
+      return;                                                           \
+    }                                                                   \
+    or0 = p2->r;                                                        \
+    og0 = p2->g;                                                        \
+    ob0 = p2->b;                                                        \
+    oa0 = p2->a;                                                        \
+    color=RGBA_TO_PIXEL(or0, og0, ob0, oa0);                            \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      STORE_PIX(pp[_a], color, or0, og0, ob0, oa0);                     \
+      STORE_Z(pz[_a], zz);                                              \
+    }                                                                   \
+    z+=dzdx;                                                            \
+  }
+
+#define PUT_PIXEL4()                                                    \
+  {                                                                     \
+    __m128i zz4 = _mm_srli_epi32(_mm_add_epi32(_mm_set1_epi32(z), zramp), \
+                                 ZB_POINT_Z_FRAC_BITS);                 \
+    __m128i zold4 = _mm_loadu_si128((const __m128i *)pz);               \
+    __m128i mask4 = ZCMP4(zold4, zz4);                                  \
+    if (_mm_movemask_epi8(mask4) != 0) {                                \
+      STORE_PIX4(pp, mask4, _mm_set1_epi32(color),                      \
+                 _mm_set1_epi32(or0), _mm_set1_epi32(og0),              \
+                 _mm_set1_epi32(ob0), _mm_set1_epi32(oa0));             \
+      STORE_Z4(pz, mask4, zold4, zz4);                                  \
+    }                                                                   \
+    z+=4*(unsigned int)dzdx;                                            \
+  }
+
+#define DRAW_LINE()                                                     \
+  {                                                                     \
+    PIXEL *pp;                                                          \
+    ZPOINT *pz;                                                         \
+    unsigned int z,zz;                                                  \
+    int n;                                                              \
+    n=(x2 >> 16) - x1;                                                  \
+    pp=(PIXEL *)((char *)pp1 + x1 * PSZB);                              \
+    pz=pz1+x1;                                                          \
+    z=z1;                                                               \
+    while (n>=3) {                                                      \
+      PUT_PIXEL4();                                                     \
+      pz+=4;                                                            \
+      pp=(PIXEL *)((char *)pp + 4 * PSZB);                              \
+      n-=4;                                                             \
+    }                                                                   \
+    while (n>=0) {                                                      \
+      PUT_PIXEL(0);                                                     \
+      pz+=1;                                                            \
+      pp=(PIXEL *)((char *)pp + PSZB);                                  \
+      n-=1;                                                             \
+    }                                                                   \
+  }
+
+#define PIXEL_COUNT pixel_count_flat_untextured
+
+#include "ztriangle.h"
+#undef PUT_PIXEL4
+}
+
+/*
+ * Smooth filled triangle.  The four lanes of each color component are
+ * kept as a ramp that is added to the scalar value at the start of each
+ * group of four pixels.
+ */
+
+static void
+FNAME(smooth_untextured) (ZBuffer *zb,
+                          ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  __m128i zramp, rramp, gramp, bramp, aramp;
+
+#define INTERP_Z
+#define INTERP_RGB
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+    unsigned int c0, c1, c2;                                            \
+    c0 = RGBA_TO_PIXEL(p0->r, p0->g, p0->b, p0->a);                     \
+    c1 = RGBA_TO_PIXEL(p1->r, p1->g, p1->b, p1->a);                     \
+    c2 = RGBA_TO_PIXEL(p2->r, p2->g, p2->b, p2->a);                     \
+    if (c0 == c1 && c0 == c2) {                                         \
+      /* It's really a flat-shaded triangle. */                         \
+      FNAME(flat_untextured)(zb, p0, p1, p2);                           \
+      return;                                                           \
+    }                                                                   \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+    rramp = ramp_epi32_sse2(drdx);                                      \
+    gramp = ramp_epi32_sse2(dgdx);                                      \
+    bramp = ramp_epi32_sse2(dbdx);                                      \
+    aramp = ramp_epi32_sse2(dadx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      if (ACMP(zb, oa1)) {                                              \
+        STORE_PIX(pp[_a], RGBA_TO_PIXEL(or1, og1, ob1, oa1), or1, og1, ob1, oa1); \
+        STORE_Z(pz[_a], zz);                                            \
+      }                                                                 \
+    }                                                                   \
+    z+=dzdx;                                                            \
+    og1+=dgdx;                                                          \
+    or1+=drdx;                                                          \
+    ob1+=dbdx;                                                          \
+    oa1+=dadx;                                                          \
+  }
+
+#define PUT_PIXEL4()                                                    \
+  {                                                                     \
+    __m128i zz4 = _mm_srli_epi32(_mm_add_epi32(_mm_set1_epi32(z), zramp), \
+                                 ZB_POINT_Z_FRAC_BITS);                 \
+    __m128i zold4 = _mm_loadu_si128((const __m128i *)pz);               \
+    __m128i mask4 = ZCMP4(zold4, zz4);                                  \
+    if (_mm_movemask_epi8(mask4) != 0) {                                \
+      __m128i r4 = _mm_add_epi32(_mm_set1_epi32(or1), rramp);           \
+      __m128i g4 = _mm_add_epi32(_mm_set1_epi32(og1), gramp);           \
+      __m128i b4 = _mm_add_epi32(_mm_set1_epi32(ob1), bramp);           \
+      __m128i a4 = _mm_add_epi32(_mm_set1_epi32(oa1), aramp);           \
+      STORE_PIX4(pp, mask4, rgba_to_pixel_sse2(r4, g4, b4, a4),         \
+                 r4, g4, b4, a4);                                       \
+      STORE_Z4(pz, mask4, zold4, zz4);                                  \
+    }                                                                   \
+    z+=4*(unsigned int)dzdx;                                            \
+    og1+=4*(unsigned int)dgdx;                                          \
+    or1+=4*(unsigned int)drdx;                                          \
+    ob1+=4*(unsigned int)dbdx;                                          \
+    oa1+=4*(unsigned int)dadx;                                          \
+  }
+
+#define DRAW_LINE()                                                     \
+  {                                                                     \
+    PIXEL *pp;                                                          \
+    ZPOINT *pz;                                                         \
+    unsigned int z,zz;                                                  \
+    unsigned int or1,og1,ob1,oa1;                                       \
+    int n;                                                              \
+    n=(x2 >> 16) - x1;                                                  \
+    pp=(PIXEL *)((char *)pp1 + x1 * PSZB);                              \
+    pz=pz1+x1;                                                          \
+    z=z1;                                                               \
+    or1 = r1;                                                           \
+    og1 = g1;                                                           \
+    ob1 = b1;                                                           \
+    oa1 = a1;                                                           \
+    while (n>=3) {                                                      \
+      PUT_PIXEL4();                                                     \
+      pz+=4;                                                            \
+      pp=(PIXEL *)((char *)pp + 4 * PSZB);                              \
+      n-=4;                                                             \
+    }                                                                   \
+    while (n>=0) {                                                      \
+      PUT_PIXEL(0);                                                     \
+      pz+=1;                                                            \
+      pp=(PIXEL *)((char *)pp + PSZB);                                  \
+      n-=1;                                                             \
+    }                                                                   \
+  }
+
+#define PIXEL_COUNT pixel_count_smooth_untextured
+
+#include "ztriangle.h"
+#undef PUT_PIXEL4
+}
+
+/*
+ * The textured variants below all share the same four-pixel body; only the
+ * way the texel is combined with the vertex color differs.  The texels
+ * themselves are still fetched one at a time, since SSE2 has no gather.
+ */
+
+#define TEXTURED_PUT_PIXEL4(COMBINE4)                                   \
+  {                                                                     \
+    __m128i zz4 = _mm_srli_epi32(_mm_add_epi32(_mm_set1_epi32(z), zramp), \
+                                 ZB_POINT_Z_FRAC_BITS);                 \
+    __m128i zold4 = _mm_loadu_si128((const __m128i *)pz);               \
+    __m128i mask4 = ZCMP4(zold4, zz4);                                  \
+    if (_mm_movemask_epi8(mask4) != 0) {                                \
+      __m128i s4 = _mm_add_epi32(_mm_set1_epi32(s), sramp);             \
+      __m128i t4 = _mm_add_epi32(_mm_set1_epi32(t), tramp);             \
+      __m128i tex4 = lookup_texture_nearest_sse2(texture_def, s4, t4);  \
+      COMBINE4(tex4);                                                   \
+      STORE_Z4(pz, mask4, zold4, zz4);                                  \
+    }                                                                   \
+  }
+
+#define WHITE_COMBINE4(tex4)                                            \
+  {                                                                     \
+    STORE_PIX4(pp, mask4, tex4,                                         \
+               pixel_r_sse2(tex4), pixel_g_sse2(tex4),                  \
+               pixel_b_sse2(tex4), pixel_a_sse2(tex4));                 \
+  }
+
+#define FLAT_COMBINE4(tex4)                                             \
+  {                                                                     \
+    __m128i r4 = pcomponent_mult_sse2(_mm_set1_epi32(or0), pixel_r_sse2(tex4)); \
+    __m128i g4 = pcomponent_mult_sse2(_mm_set1_epi32(og0), pixel_g_sse2(tex4)); \
+    __m128i b4 = pcomponent_mult_sse2(_mm_set1_epi32(ob0), pixel_b_sse2(tex4)); \
+    __m128i a4 = palpha_mult_sse2(_mm_set1_epi32(oa0), pixel_a_sse2(tex4)); \
+    STORE_PIX4(pp, mask4, rgba_to_pixel_sse2(r4, g4, b4, a4),           \
+               r4, g4, b4, a4);                                         \
+  }
+
+#define SMOOTH_COMBINE4(tex4)                                           \
+  {                                                                     \
+    __m128i r4 = _mm_add_epi32(_mm_set1_epi32(or1), rramp);             \
+    __m128i g4 = _mm_add_epi32(_mm_set1_epi32(og1), gramp);             \
+    __m128i b4 = _mm_add_epi32(_mm_set1_epi32(ob1), bramp);             \
+    __m128i a4 = _mm_add_epi32(_mm_set1_epi32(oa1), aramp);             \
+    r4 = pcomponent_mult_sse2(r4, pixel_r_sse2(tex4));                  \
+    g4 = pcomponent_mult_sse2(g4, pixel_g_sse2(tex4));                  \
+    b4 = pcomponent_mult_sse2(b4, pixel_b_sse2(tex4));                  \
+    a4 = palpha_mult_sse2(a4, pixel_a_sse2(tex4));                      \
+    STORE_PIX4(pp, mask4, rgba_to_pixel_sse2(r4, g4, b4, a4),           \
+               r4, g4, b4, a4);                                         \
+  }
+
+/*
+ * Affine texture mapping.
+ */
+
+#define TEXTURED_DRAW_LINE(SHADE)                                       \
+  {                                                                     \
+    PIXEL *pp;                                                          \
+    ZPOINT *pz;                                                         \
+    unsigned int z,zz;                                                  \
+    UNUSED unsigned int or1,og1,ob1,oa1;                                \
+    unsigned int s,t;                                                   \
+    int n;                                                              \
+    n=(x2 >> 16) - x1;                                                  \
+    pp=(PIXEL *)((char *)pp1 + x1 * PSZB);                              \
+    pz=pz1+x1;                                                          \
+    z=z1;                                                               \
+    SHADE##_INIT();                                                     \
+    s=s1;                                                               \
+    t=t1;                                                               \
+    while (n>=3) {                                                      \
+      TEXTURED_PUT_PIXEL4(SHADE##_COMBINE4);                            \
+      SHADE##_STEP4();                                                  \
+      z+=4*(unsigned int)dzdx;                                          \
+      s+=4*(unsigned int)dsdx;                                          \
+      t+=4*(unsigned int)dtdx;                                          \
+      pz+=4;                                                            \
+      pp=(PIXEL *)((char *)pp + 4 * PSZB);                              \
+      n-=4;                                                             \
+    }                                                                   \
+    while (n>=0) {                                                      \
+      PUT_PIXEL(0);                                                     \
+      pz+=1;                                                            \
+      pp=(PIXEL *)((char *)pp + PSZB);                                  \
+      n-=1;                                                             \
+    }                                                                   \
+  }
+
+/*
+ * Perspective-correct texture mapping.  The texture coordinates are
+ * recomputed every NB_INTERP pixels exactly as in ztriangle_two.h, and are
+ * interpolated linearly in between, two groups of four at a time.
+ */
+
+#define NB_INTERP 8
+
+#define PERSPECTIVE_SETUP()                                             \
+  {                                                                     \
+    PN_stdfloat ss,tt;                                                  \
+    ss=(sz * zinv);                                                     \
+    tt=(tz * zinv);                                                     \
+    s=(int) ss;                                                         \
+    t=(int) tt;                                                         \
+    dsdx= (int)( (dszdx - ss*fdzdx)*zinv );                             \
+    dtdx= (int)( (dtzdx - tt*fdzdx)*zinv );                             \
+    sramp = ramp_epi32_sse2(dsdx);                                      \
+    tramp = ramp_epi32_sse2(dtdx);                                      \
+  }
+
+#define PERSPECTIVE_DRAW_LINE(SHADE)                                    \
+  {                                                                     \
+    ZPOINT *pz;                                                         \
+    PIXEL *pp;                                                          \
+    int s,t,z,zz;                                                       \
+    int n,dsdx,dtdx;                                                    \
+    UNUSED unsigned int or1,og1,ob1,oa1;                                \
+    PN_stdfloat sz,tz,fz,zinv;                                          \
+    __m128i sramp, tramp;                                               \
+    n=(x2>>16)-x1;                                                      \
+    fz=(PN_stdfloat)z1;                                                 \
+    zinv=1.0f / fz;                                                     \
+    pp=(PIXEL *)((char *)pp1 + x1 * PSZB);                              \
+    pz=pz1+x1;                                                          \
+    z=z1;                                                               \
+    sz=sz1;                                                             \
+    tz=tz1;                                                             \
+    SHADE##_INIT();                                                     \
+    while (n>=(NB_INTERP-1)) {                                          \
+      PERSPECTIVE_SETUP();                                              \
+      fz+=fndzdx;                                                       \
+      zinv=1.0f / fz;                                                   \
+      TEXTURED_PUT_PIXEL4(SHADE##_COMBINE4);                            \
+      SHADE##_STEP4();                                                  \
+      z+=4*(unsigned int)dzdx;                                          \
+      s+=4*(unsigned int)dsdx;                                          \
+      t+=4*(unsigned int)dtdx;                                          \
+      pz+=4;                                                            \
+      pp=(PIXEL *)((char *)pp + 4 * PSZB);                              \
+      TEXTURED_PUT_PIXEL4(SHADE##_COMBINE4);                            \
+      SHADE##_STEP4();                                                  \
+      z+=4*(unsigned int)dzdx;                                          \
+      pz+=4;                                                            \
+      pp=(PIXEL *)((char *)pp + 4 * PSZB);                              \
+      n-=NB_INTERP;                                                     \
+      sz+=ndszdx;                                                       \
+      tz+=ndtzdx;                                                       \
+    }                                                                   \
+    PERSPECTIVE_SETUP();                                                \
+    while (n>=3) {                                                      \
+      TEXTURED_PUT_PIXEL4(SHADE##_COMBINE4);                            \
+      SHADE##_STEP4();                                                  \
+      z+=4*(unsigned int)dzdx;                                          \
+      s+=4*(unsigned int)dsdx;                                          \
+      t+=4*(unsigned int)dtdx;                                          \
+      pz+=4;                                                            \
+      pp=(PIXEL *)((char *)pp + 4 * PSZB);                              \
+      n-=4;                                                             \
+    }                                                                   \
+    while (n>=0) {                                                      \
+      PUT_PIXEL(0);                                                     \
+      pz+=1;                                                            \
+      pp=(PIXEL *)((char *)pp + PSZB);                                  \
+      n-=1;                                                             \
+    }                                                                   \
+  }
+
+#define WHITE_INIT()
+#define FLAT_INIT()
+#define SMOOTH_INIT()                                                   \
+  {                                                                     \
+    or1 = r1;                                                           \
+    og1 = g1;                                                           \
+    ob1 = b1;                                                           \
+    oa1 = a1;                                                           \
+  }
+
+#define WHITE_STEP4()
+#define FLAT_STEP4()
+#define SMOOTH_STEP4()                                                  \
+  {                                                                     \
+    og1+=4*(unsigned int)dgdx;                                          \
+    or1+=4*(unsigned int)drdx;                                          \
+    ob1+=4*(unsigned int)dbdx;                                          \
+    oa1+=4*(unsigned int)dadx;                                          \
+  }
+
+static void
+FNAME(white_textured) (ZBuffer *zb,
+                       ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  __m128i zramp, sramp, tramp;
+
+#define INTERP_Z
+#define INTERP_ST
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    texture_def = &zb->current_textures[0];                             \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+    sramp = ramp_epi32_sse2(dsdx);                                      \
+    tramp = ramp_epi32_sse2(dtdx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      tmp = ZB_LOOKUP_TEXTURE(texture_def, s, t, mipmap_level, mipmap_dx); \
+      if (ACMP(zb, PIXEL_A(tmp))) {                                     \
+        STORE_PIX(pp[_a], tmp, PIXEL_R(tmp), PIXEL_G(tmp), PIXEL_B(tmp), PIXEL_A(tmp)); \
+        STORE_Z(pz[_a], zz);                                            \
+      }                                                                 \
+    }                                                                   \
+    z+=dzdx;                                                            \
+    s+=dsdx;                                                            \
+    t+=dtdx;                                                            \
+  }
+
+#define DRAW_LINE() TEXTURED_DRAW_LINE(WHITE)
+
+#define PIXEL_COUNT pixel_count_white_textured
+
+#include "ztriangle.h"
+}
+
+static void
+FNAME(flat_textured) (ZBuffer *zb,
+                      ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  __m128i zramp, sramp, tramp;
+  UNUSED int or0, og0, ob0, oa0;
+
+#define INTERP_Z
+#define INTERP_ST
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    if (p2->a == 0 && !ACMP(zb, p2->a)) {                               \
+      /* This alpha is zero, and we'll never get other than 0. */       \
+      return;                                                           \
+    }                                                                   \
+    texture_def = &zb->current_textures[0];                             \
+    or0 = p2->r;                                                        \
+    og0 = p2->g;                                                        \
+    ob0 = p2->b;                                                        \
+    oa0 = p2->a;                                                        \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+    sramp = ramp_epi32_sse2(dsdx);                                      \
+    tramp = ramp_epi32_sse2(dtdx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      tmp = ZB_LOOKUP_TEXTURE(texture_def, s, t, mipmap_level, mipmap_dx); \
+      UNUSED int a = PALPHA_MULT(oa0, PIXEL_A(tmp));                    \
+      if (ACMP(zb, a)) {                                                \
+        STORE_PIX(pp[_a],                                               \
+                  RGBA_TO_PIXEL(PCOMPONENT_MULT(or0, PIXEL_R(tmp)),     \
+                                PCOMPONENT_MULT(og0, PIXEL_G(tmp)),     \
+                                PCOMPONENT_MULT(ob0, PIXEL_B(tmp)),     \
+                                a),                                     \
+                  PCOMPONENT_MULT(or0, PIXEL_R(tmp)),                   \
+                  PCOMPONENT_MULT(og0, PIXEL_G(tmp)),                   \
+                  PCOMPONENT_MULT(ob0, PIXEL_B(tmp)),                   \
+                  a);                                                   \
+        STORE_Z(pz[_a], zz);                                            \
+      }                                                                 \
+    }                                                                   \
+    z+=dzdx;                                                            \
+    s+=dsdx;                                                            \
+    t+=dtdx;                                                            \
+  }
+
+#define DRAW_LINE() TEXTURED_DRAW_LINE(FLAT)
+
+#define PIXEL_COUNT pixel_count_flat_textured
+
+#include "ztriangle.h"
+}
+
+static void
+FNAME(smooth_textured) (ZBuffer *zb,
+                        ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  __m128i zramp, sramp, tramp, rramp, gramp, bramp, aramp;
+
+#define INTERP_Z
+#define INTERP_ST
+#define INTERP_RGB
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+    unsigned int c0, c1, c2;                                            \
+    c0 = RGBA_TO_PIXEL(p0->r, p0->g, p0->b, p0->a);                     \
+    c1 = RGBA_TO_PIXEL(p1->r, p1->g, p1->b, p1->a);                     \
+    c2 = RGBA_TO_PIXEL(p2->r, p2->g, p2->b, p2->a);                     \
+    if (c0 == c1 && c0 == c2) {                                         \
+      /* It's really a flat-shaded triangle. */                         \
+      if (c0 == 0xffffffffu) {                                          \
+        /* Actually, it's a white triangle. */                          \
+        FNAME(white_textured)(zb, p0, p1, p2);                          \
+        return;                                                         \
+      }                                                                 \
+      FNAME(flat_textured)(zb, p0, p1, p2);                             \
+      return;                                                           \
+    }                                                                   \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    texture_def = &zb->current_textures[0];                             \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+    sramp = ramp_epi32_sse2(dsdx);                                      \
+    tramp = ramp_epi32_sse2(dtdx);                                      \
+    rramp = ramp_epi32_sse2(drdx);                                      \
+    gramp = ramp_epi32_sse2(dgdx);                                      \
+    bramp = ramp_epi32_sse2(dbdx);                                      \
+    aramp = ramp_epi32_sse2(dadx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      tmp = ZB_LOOKUP_TEXTURE(texture_def, s, t, mipmap_level, mipmap_dx); \
+      UNUSED int a = PALPHA_MULT(oa1, PIXEL_A(tmp));                    \
+      if (ACMP(zb, a)) {                                                \
+        STORE_PIX(pp[_a],                                               \
+                  RGBA_TO_PIXEL(PCOMPONENT_MULT(or1, PIXEL_R(tmp)),     \
+                                PCOMPONENT_MULT(og1, PIXEL_G(tmp)),     \
+                                PCOMPONENT_MULT(ob1, PIXEL_B(tmp)),     \
+                                a),                                     \
+                  PCOMPONENT_MULT(or1, PIXEL_R(tmp)),                   \
+                  PCOMPONENT_MULT(og1, PIXEL_G(tmp)),                   \
+                  PCOMPONENT_MULT(ob1, PIXEL_B(tmp)),                   \
+                  a);                                                   \
+        STORE_Z(pz[_a], zz);                                            \
+      }                                                                 \
+    }                                                                   \
+    z+=dzdx;                                                            \
+    og1+=dgdx;                                                          \
+    or1+=drdx;                                                          \
+    ob1+=dbdx;                                                          \
+    oa1+=dadx;                                                          \
+    s+=dsdx;                                                            \
+    t+=dtdx;                                                            \
+  }
+
+#define DRAW_LINE() TEXTURED_DRAW_LINE(SMOOTH)
+
+#define PIXEL_COUNT pixel_count_smooth_textured
+
+#include "ztriangle.h"
+}
+
+static void
+FNAME(white_perspective) (ZBuffer *zb,
+                          ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  PN_stdfloat fdzdx,fndzdx,ndszdx,ndtzdx;
+  __m128i zramp;
+
+#define INTERP_Z
+#define INTERP_STZ
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    texture_def = &zb->current_textures[0];                             \
+    fdzdx=(PN_stdfloat)dzdx;                                            \
+    fndzdx=NB_INTERP * fdzdx;                                           \
+    ndszdx=NB_INTERP * dszdx;                                           \
+    ndtzdx=NB_INTERP * dtzdx;                                           \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      tmp = ZB_LOOKUP_TEXTURE(texture_def, s, t, mipmap_level, mipmap_dx); \
+      if (ACMP(zb, PIXEL_A(tmp))) {                                     \
+        STORE_PIX(pp[_a], tmp, PIXEL_R(tmp), PIXEL_G(tmp), PIXEL_B(tmp), PIXEL_A(tmp)); \
+        STORE_Z(pz[_a], zz);                                            \
+      }                                                                 \
+    }                                                                   \
+    z+=dzdx;                                                            \
+    s+=dsdx;                                                            \
+    t+=dtdx;                                                            \
+  }
+
+#define DRAW_LINE() PERSPECTIVE_DRAW_LINE(WHITE)
+
+#define PIXEL_COUNT pixel_count_white_perspective
+
+#include "ztriangle.h"
+}
+
+static void
+FNAME(flat_perspective) (ZBuffer *zb,
+                         ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  PN_stdfloat fdzdx,fndzdx,ndszdx,ndtzdx;
+  __m128i zramp;
+  UNUSED int or0, og0, ob0, oa0;
+
+#define INTERP_Z
+#define INTERP_STZ
+#define INTERP_RGB
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    if (p2->a == 0 && !ACMP(zb, p2->a)) {                               \
+      /* This alpha is zero, and we'll never get other than 0. */       \
+      return;                                                           \
+    }                                                                   \
+    texture_def = &zb->current_textures[0];                             \
+    fdzdx=(PN_stdfloat)dzdx;                                            \
+    fndzdx=NB_INTERP * fdzdx;                                           \
+    ndszdx=NB_INTERP * dszdx;                                           \
+    ndtzdx=NB_INTERP * dtzdx;                                           \
+    or0 = p2->r;                                                        \
+    og0 = p2->g;                                                        \
+    ob0 = p2->b;                                                        \
+    oa0 = p2->a;                                                        \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      tmp = ZB_LOOKUP_TEXTURE(texture_def, s, t, mipmap_level, mipmap_dx); \
+      UNUSED int a = PALPHA_MULT(oa0, PIXEL_A(tmp));                    \
+      if (ACMP(zb, a)) {                                                \
+        STORE_PIX(pp[_a],                                               \
+                  RGBA_TO_PIXEL(PCOMPONENT_MULT(or0, PIXEL_R(tmp)),     \
+                                PCOMPONENT_MULT(og0, PIXEL_G(tmp)),     \
+                                PCOMPONENT_MULT(ob0, PIXEL_B(tmp)),     \
+                                a),                                     \
+                  PCOMPONENT_MULT(or0, PIXEL_R(tmp)),                   \
+                  PCOMPONENT_MULT(og0, PIXEL_G(tmp)),                   \
+                  PCOMPONENT_MULT(ob0, PIXEL_B(tmp)),                   \
+                  a);                                                   \
+        STORE_Z(pz[_a], zz);                                            \
+      }                                                                 \
+    }                                                                   \
+    z+=dzdx;                                                            \
+    s+=dsdx;                                                            \
+    t+=dtdx;                                                            \
+  }
+
+#define DRAW_LINE() PERSPECTIVE_DRAW_LINE(FLAT)
+
+#define PIXEL_COUNT pixel_count_flat_perspective
+
+#include "ztriangle.h"
+}
+
+static void
+FNAME(smooth_perspective) (ZBuffer *zb,
+                           ZBufferPoint *p0,ZBufferPoint *p1,ZBufferPoint *p2)
+{
+  ZTextureDef *texture_def;
+  PN_stdfloat fdzdx,fndzdx,ndszdx,ndtzdx;
+  __m128i zramp, rramp, gramp, bramp, aramp;
+
+#define INTERP_Z
+#define INTERP_STZ
+#define INTERP_RGB
+
+#define EARLY_OUT()                                                     \
+  {                                                                     \
+    unsigned int c0, c1, c2;                                            \
+    c0 = RGBA_TO_PIXEL(p0->r, p0->g, p0->b, p0->a);                     \
+    c1 = RGBA_TO_PIXEL(p1->r, p1->g, p1->b, p1->a);                     \
+    c2 = RGBA_TO_PIXEL(p2->r, p2->g, p2->b, p2->a);                     \
+    if (c0 == c1 && c0 == c2) {                                         \
+      /* It's really a flat-shaded triangle. */                         \
+      if (c0 == 0xffffffffu) {                                          \
+        /* Actually, it's a white triangle. */                          \
+        FNAME(white_perspective)(zb, p0, p1, p2);                       \
+        return;                                                         \
+      }                                                                 \
+      FNAME(flat_perspective)(zb, p0, p1, p2);                          \
+      return;                                                           \
+    }                                                                   \
+  }
+
+#define DRAW_INIT()                                                     \
+  {                                                                     \
+    texture_def = &zb->current_textures[0];                             \
+    fdzdx=(PN_stdfloat)dzdx;                                            \
+    fndzdx=NB_INTERP * fdzdx;                                           \
+    ndszdx=NB_INTERP * dszdx;                                           \
+    ndtzdx=NB_INTERP * dtzdx;                                           \
+    zramp = ramp_epi32_sse2(dzdx);                                      \
+    rramp = ramp_epi32_sse2(drdx);                                      \
+    gramp = ramp_epi32_sse2(dgdx);                                      \
+    bramp = ramp_epi32_sse2(dbdx);                                      \
+    aramp = ramp_epi32_sse2(dadx);                                      \
+  }
+
+#define PUT_PIXEL(_a)                                                   \
+  {                                                                     \
+    zz=z >> ZB_POINT_Z_FRAC_BITS;                                       \
+    if (ZCMP(pz[_a], zz)) {                                             \
+      tmp = ZB_LOOKUP_TEXTURE(texture_def, s, t, mipmap_level, mipmap_dx); \
+      UNUSED int a = PALPHA_MULT(oa1, PIXEL_A(tmp));                    \
+      if (ACMP(zb, a)) {                                                \
+        STORE_PIX(pp[_a],                                               \
+                  RGBA_TO_PIXEL(PCOMPONENT_MULT(or1, PIXEL_R(tmp)),     \
+                                PCOMPONENT_MULT(og1, PIXEL_G(tmp)),     \
+                                PCOMPONENT_MULT(ob1, PIXEL_B(tmp)),     \
+                                a),                                     \
+                  PCOMPONENT_MULT(or1, PIXEL_R(tmp)),                   \
+                  PCOMPONENT_MULT(og1, PIXEL_G(tmp)),                   \
+                  PCOMPONENT_MULT(ob1, PIXEL_B(tmp)),                   \
+                  a);                                                   \
+        STORE_Z(pz[_a], zz);                                            \
+      }                                                                 \
+    }                                                                   \
+    z+=dzdx;                                                            \
+    og1+=dgdx;                                                          \
+    or1+=drdx;                                                          \
+    ob1+=dbdx;                                                          \
+    oa1+=dadx;                                                          \
+    s+=dsdx;                                                            \
+    t+=dtdx;                                                            \
+  }
+
+#define DRAW_LINE() PERSPECTIVE_DRAW_LINE(SMOOTH)
+
+#define PIXEL_COUNT pixel_count_smooth_perspective
+
+#include "ztriangle.h"
+}
+
+#undef NB_INTERP
+#undef TEXTURED_PUT_PIXEL4
+#undef WHITE_COMBINE4
+#undef FLAT_COMBINE4
+#undef SMOOTH_COMBINE4
+#undef TEXTURED_DRAW_LINE
+#undef PERSPECTIVE_SETUP
+#undef PERSPECTIVE_DRAW_LINE
+#undef WHITE_INIT
+#undef FLAT_INIT
+#undef SMOOTH_INIT
+#undef WHITE_STEP4
+#undef FLAT_STEP4
+#undef SMOOTH_STEP4
+
+#undef ZCMP
+#undef ZCMP4
+#undef STORE_PIX
+#undef STORE_PIX4
+#undef STORE_Z
+#undef STORE_Z4
+#undef FNAME
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
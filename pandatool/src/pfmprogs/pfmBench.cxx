@@ -0,0 +1,401 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pfmBench.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pfmBench.h"
+#include "config_pnmimage.h"
+#include "pnmParallelRows.h"
+#include "trueClock.h"
+#include "cmath.h"
+
+#include <stdio.h>
+
+/**
+ *
+ */
+PfmBench::
+PfmBench() {
+  set_program_brief("time the PfmFile and PNMImage filter operations");
+  set_program_description
+    ("pfm-bench runs each of the PfmFile and PNMImage filtering operations "
+     "(box_filter, gaussian_filter, quick_filter, xform, and the distort "
+     "operations) first with pnm-filter-threads set to 1, and then with "
+     "the indicated number of threads, and reports the time taken by "
+     "each along with the largest difference between the two results, "
+     "which should be zero.\n\n"
+     "By default a synthetic image is used; you may also name a pfm file "
+     "on the command line.");
+
+  add_option
+    ("s", "x,y", 0,
+     "Specify the size of the synthetic image.  The default is 2048,2048.",
+     &PfmBench::dispatch_int_pair, nullptr, _size);
+
+  add_option
+    ("c", "channels", 0,
+     "Specify the number of channels, 1 to 4, in the synthetic image.  "
+     "The default is 3.",
+     &PfmBench::dispatch_int, nullptr, &_num_channels);
+
+  add_option
+    ("z", "", 0,
+     "Punch holes in the synthetic image, marked with the zero-special "
+     "no-data value, to exercise the sparse filter variants.",
+     &PfmBench::dispatch_none, &_got_holes);
+
+  add_option
+    ("t", "threads", 0,
+     "Specify the number of threads for the multithreaded run.  The "
+     "default, 0, means one per CPU.",
+     &PfmBench::dispatch_int, nullptr, &_num_threads);
+
+  add_option
+    ("n", "count", 0,
+     "Run each operation this many times and report the fastest.  The "
+     "default is 3.",
+     &PfmBench::dispatch_int, nullptr, &_num_repeats);
+
+  _size[0] = 2048;
+  _size[1] = 2048;
+  _num_channels = 3;
+  _num_threads = 0;
+  _num_repeats = 3;
+}
+
+// The operations to be timed.  Each one computes a result from the source
+// image (and, for the distort operations, the distortion map) without
+// modifying its inputs.
+
+static void
+pfm_box_filter_down(PfmFile &result, const PfmFile &source, const PfmFile &) {
+  result.clear(source.get_x_size() / 2, source.get_y_size() / 2,
+               source.get_num_channels());
+  result.box_filter_from(1.0f, source);
+}
+
+static void
+pfm_gaussian_filter_up(PfmFile &result, const PfmFile &source, const PfmFile &) {
+  result.clear(source.get_x_size() * 3 / 2, source.get_y_size() * 3 / 2,
+               source.get_num_channels());
+  result.gaussian_filter_from(1.0f, source);
+}
+
+static void
+pfm_quick_filter_down(PfmFile &result, const PfmFile &source, const PfmFile &) {
+  result.clear(source.get_x_size() / 3, source.get_y_size() / 3,
+               source.get_num_channels());
+  result.quick_filter_from(source);
+}
+
+static void
+pfm_xform(PfmFile &result, const PfmFile &source, const PfmFile &) {
+  result = source;
+  LMatrix4f mat = LMatrix4f::scale_mat(1.5f, 0.5f, 2.0f) *
+    LMatrix4f::rotate_mat(30.0f, LVector3f(1.0f, 1.0f, 0.0f).normalized()) *
+    LMatrix4f::translate_mat(0.25f, -1.0f, 3.0f);
+  result.xform(mat);
+}
+
+static void
+pfm_forward_distort(PfmFile &result, const PfmFile &source, const PfmFile &dist) {
+  result = source;
+  result.forward_distort(dist);
+}
+
+static void
+pfm_reverse_distort(PfmFile &result, const PfmFile &source, const PfmFile &dist) {
+  result = source;
+  result.reverse_distort(dist);
+}
+
+static void
+image_box_filter_down(PNMImage &result, const PNMImage &source) {
+  result.clear(source.get_x_size() / 2, source.get_y_size() / 2,
+               source.get_num_channels(), source.get_maxval());
+  result.box_filter_from(1.0f, source);
+}
+
+static void
+image_gaussian_filter_up(PNMImage &result, const PNMImage &source) {
+  result.clear(source.get_x_size() * 3 / 2, source.get_y_size() * 3 / 2,
+               source.get_num_channels(), source.get_maxval());
+  result.gaussian_filter_from(1.0f, source);
+}
+
+static void
+image_quick_filter_down(PNMImage &result, const PNMImage &source) {
+  result.clear(source.get_x_size() / 3, source.get_y_size() / 3,
+               source.get_num_channels(), source.get_maxval());
+  result.quick_filter_from(source);
+}
+
+/**
+ *
+ */
+void PfmBench::
+run() {
+  if (!_input_filename.empty()) {
+    if (!_source_pfm.read(_input_filename)) {
+      nout << "Cannot read " << _input_filename << "\n";
+      exit(1);
+    }
+  } else {
+    make_source_pfm();
+  }
+  make_dist_pfm();
+
+  // The PNMImage tests use the same data, scaled into the range 0..1.
+  PfmFile normalized = _source_pfm;
+  LVecBase3f min_depth, max_depth;
+  if (normalized.calc_min_max(min_depth, max_depth)) {
+    LVecBase3f range = max_depth - min_depth;
+    for (int i = 0; i < 3; ++i) {
+      if (range[i] == 0.0f) {
+        range[i] = 1.0f;
+      }
+    }
+    normalized.xform(LMatrix4f::translate_mat(-min_depth) *
+                     LMatrix4f::scale_mat(1.0f / range[0], 1.0f / range[1], 1.0f / range[2]));
+  }
+  normalized.store(_source_image);
+
+  pnm_filter_threads.set_value(_num_threads);
+  int num_threads = PNMParallelRows::get_num_threads();
+
+  nout << "Source is " << _source_pfm.get_x_size() << " x "
+       << _source_pfm.get_y_size() << ", " << _source_pfm.get_num_channels()
+       << " channels";
+  if (_source_pfm.has_no_data_value()) {
+    nout << ", with no-data value";
+  }
+  nout << "; comparing 1 thread with " << num_threads << ".\n\n";
+
+  printf("%-24s %12s %12s %8s  %s\n", "operation", "1 thread ms",
+         "N threads ms", "speedup", "max difference");
+
+  bench_pfm("pfm box_filter", &pfm_box_filter_down);
+  bench_pfm("pfm gaussian_filter", &pfm_gaussian_filter_up);
+  bench_pfm("pfm quick_filter", &pfm_quick_filter_down);
+  bench_pfm("pfm xform", &pfm_xform);
+  if (_source_pfm.get_num_channels() >= 2) {
+    bench_pfm("pfm forward_distort", &pfm_forward_distort);
+    bench_pfm("pfm reverse_distort", &pfm_reverse_distort);
+  }
+  bench_image("image box_filter", &image_box_filter_down);
+  bench_image("image gaussian_filter", &image_gaussian_filter_up);
+  bench_image("image quick_filter", &image_quick_filter_down);
+}
+
+/**
+ * Does something with the additional arguments on the command line (after all
+ * the -options have been parsed).  Returns true if the arguments are good,
+ * false otherwise.
+ */
+bool PfmBench::
+handle_args(ProgramBase::Args &args) {
+  if (args.size() > 1) {
+    nout << "Specify at most one pfm file on the command line.\n";
+    return false;
+  }
+  if (!args.empty()) {
+    _input_filename = Filename::from_os_specific(args[0]);
+  }
+  if (_num_channels < 1 || _num_channels > 4) {
+    nout << "The number of channels must be between 1 and 4.\n";
+    return false;
+  }
+  if (_size[0] < 4 || _size[1] < 4) {
+    nout << "The image must be at least 4 x 4.\n";
+    return false;
+  }
+  _num_repeats = std::max(_num_repeats, 1);
+  return true;
+}
+
+/**
+ * Generates a smooth synthetic surface, with texture coordinates in the first
+ * two channels so that it can also serve as the input to the distort
+ * operations.
+ */
+void PfmBench::
+make_source_pfm() {
+  int x_size = _size[0];
+  int y_size = _size[1];
+  _source_pfm.clear(x_size, y_size, _num_channels);
+
+  for (int yi = 0; yi < y_size; ++yi) {
+    for (int xi = 0; xi < x_size; ++xi) {
+      float u = ((float)xi + 0.5f) / (float)x_size;
+      float v = ((float)yi + 0.5f) / (float)y_size;
+      LPoint4f p(u, 1.0f - v,
+                 csin(u * 17.0f) * ccos(v * 11.0f) + 2.0f, u * v + 0.5f);
+      if (_got_holes) {
+        // Cut out a grid of round holes.
+        float hu = u * 8.0f - cfloor(u * 8.0f) - 0.5f;
+        float hv = v * 8.0f - cfloor(v * 8.0f) - 0.5f;
+        if (hu * hu + hv * hv < 0.04f) {
+          p = LPoint4f::zero();
+        }
+      }
+      _source_pfm.set_point4(xi, yi, p);
+    }
+  }
+
+  if (_got_holes) {
+    _source_pfm.set_zero_special(true);
+  }
+}
+
+/**
+ * Generates a gently swirled texture-coordinate map to use as the
+ * distortion for the distort operations.
+ */
+void PfmBench::
+make_dist_pfm() {
+  int x_size = std::max(_source_pfm.get_x_size() / 2, 1);
+  int y_size = std::max(_source_pfm.get_y_size() / 2, 1);
+  _dist_pfm.clear_to_texcoords(x_size, y_size);
+
+  for (int yi = 0; yi < y_size; ++yi) {
+    for (int xi = 0; xi < x_size; ++xi) {
+      LPoint3f p = _dist_pfm.get_point3(xi, yi);
+      float du = p[0] - 0.5f;
+      float dv = p[1] - 0.5f;
+      float angle = 0.4f * (0.5f - csqrt(du * du + dv * dv));
+      float c = ccos(angle);
+      float s = csin(angle);
+      _dist_pfm.set_point3(xi, yi, LPoint3f(0.5f + du * c - dv * s,
+                                            0.5f + du * s + dv * c, p[2]));
+    }
+  }
+}
+
+/**
+ * Times a PfmFile operation with one thread and with many, and reports the
+ * difference between the two results.
+ */
+void PfmBench::
+bench_pfm(const std::string &name, PfmOperation *op) {
+  PfmFile single, multi;
+  double single_time = time_pfm(op, 1, single);
+  double multi_time = time_pfm(op, _num_threads, multi);
+
+  double max_diff = 0.0;
+  const vector_float &a = single.get_table();
+  const vector_float &b = multi.get_table();
+  if (a.size() != b.size()) {
+    max_diff = make_inf(0.0);
+  } else {
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (cnan(a[i]) != cnan(b[i])) {
+        max_diff = make_inf(0.0);
+        break;
+      }
+      if (!cnan(a[i])) {
+        max_diff = std::max(max_diff, (double)cabs(a[i] - b[i]));
+      }
+    }
+  }
+
+  report(name, single_time, multi_time, max_diff);
+}
+
+/**
+ * Times a PNMImage operation with one thread and with many, and reports the
+ * difference between the two results, in units of the maxval.
+ */
+void PfmBench::
+bench_image(const std::string &name, ImageOperation *op) {
+  PNMImage single, multi;
+  double single_time = time_image(op, 1, single);
+  double multi_time = time_image(op, _num_threads, multi);
+
+  double max_diff = 0.0;
+  if (single.get_x_size() != multi.get_x_size() ||
+      single.get_y_size() != multi.get_y_size()) {
+    max_diff = make_inf(0.0);
+  } else {
+    int num_channels = single.get_num_channels();
+    for (int yi = 0; yi < single.get_y_size(); ++yi) {
+      for (int xi = 0; xi < single.get_x_size(); ++xi) {
+        for (int c = 0; c < num_channels; ++c) {
+          int diff = (int)single.get_channel_val(xi, yi, c) -
+            (int)multi.get_channel_val(xi, yi, c);
+          max_diff = std::max(max_diff, (double)std::abs(diff));
+        }
+      }
+    }
+  }
+
+  report(name, single_time, multi_time, max_diff);
+}
+
+/**
+ * Runs the operation the requested number of times with the indicated
+ * pnm-filter-threads setting, and returns the fastest time in seconds.
+ */
+double PfmBench::
+time_pfm(PfmOperation *op, int num_threads, PfmFile &result) {
+  pnm_filter_threads.set_value(num_threads);
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  double best = 0.0;
+  for (int i = 0; i < _num_repeats; ++i) {
+    double start = clock->get_short_time();
+    (*op)(result, _source_pfm, _dist_pfm);
+    double elapsed = clock->get_short_time() - start;
+    if (i == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+  return best;
+}
+
+/**
+ * Runs the operation the requested number of times with the indicated
+ * pnm-filter-threads setting, and returns the fastest time in seconds.
+ */
+double PfmBench::
+time_image(ImageOperation *op, int num_threads, PNMImage &result) {
+  pnm_filter_threads.set_value(num_threads);
+  TrueClock *clock = TrueClock::get_global_ptr();
+
+  double best = 0.0;
+  for (int i = 0; i < _num_repeats; ++i) {
+    double start = clock->get_short_time();
+    (*op)(result, _source_image);
+    double elapsed = clock->get_short_time() - start;
+    if (i == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+  return best;
+}
+
+/**
+ * Writes one line of the results table.
+ */
+void PfmBench::
+report(const std::string &name, double single_time, double multi_time,
+       double max_diff) {
+  double speedup = (multi_time > 0.0) ? single_time / multi_time : 0.0;
+  printf("%-24s %12.1f %12.1f %7.2fx  %g\n", name.c_str(),
+         single_time * 1000.0, multi_time * 1000.0, speedup, max_diff);
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+  PfmBench prog;
+  prog.parse_command_line(argc, argv);
+  prog.run();
+  return 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pfmBench.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef PFMBENCH_H
+#define PFMBENCH_H
+
+#include "pandatoolbase.h"
+#include "programBase.h"
+#include "filename.h"
+#include "pfmFile.h"
+#include "pnmImage.h"
+
+/**
+ * Times the PfmFile and PNMImage filter operations, first on a single thread
+ * and then on several, and checks that both produce the same result.
+ */
+class PfmBench : public ProgramBase {
+public:
+  PfmBench();
+
+  void run();
+
+protected:
+  virtual bool handle_args(Args &args);
+
+private:
+  typedef void PfmOperation(PfmFile &result, const PfmFile &source,
+                            const PfmFile &dist);
+  typedef void ImageOperation(PNMImage &result, const PNMImage &source);
+
+  void make_source_pfm();
+  void make_dist_pfm();
+
+  void bench_pfm(const std::string &name, PfmOperation *op);
+  void bench_image(const std::string &name, ImageOperation *op);
+  double time_pfm(PfmOperation *op, int num_threads, PfmFile &result);
+  double time_image(ImageOperation *op, int num_threads, PNMImage &result);
+  void report(const std::string &name, double single_time, double multi_time,
+              double max_diff);
+
+  Filename _input_filename;
+  int _size[2];
+  int _num_channels;
+  int _num_threads;
+  int _num_repeats;
+  bool _got_holes;
+
+  PfmFile _source_pfm;
+  PfmFile _dist_pfm;
+  PNMImage _source_image;
+};
+
+#endif
@@ -13,11 +13,40 @@ uniform struct {
   int view_index;
   int terrain_size;
   int chunk_size;
+
+  // Only used when streaming the heightfield
+  sampler2D tile_atlas;
+  sampler2D tile_table;
+  int tiles_per_side;
+  int tile_size;
+  int streaming;
 } ShaderTerrainMesh;
 
 out vec2 terrain_uv;
 out vec3 vtx_pos;
 
+// Returns the terrain height at the given uv. When streaming, the height is
+// taken from the tile atlas if the tile is loaded, and from the overview
+// (bound as heightfield) otherwise.
+float sample_height(vec2 uv) {
+  if (ShaderTerrainMesh.streaming == 0) {
+    return texture(ShaderTerrainMesh.heightfield, uv).x;
+  }
+
+  float n = float(ShaderTerrainMesh.tiles_per_side);
+  vec2 tile = min(floor(uv * n), vec2(n - 1.0));
+  vec4 entry = texelFetch(ShaderTerrainMesh.tile_table, ivec2(tile), 0);
+  if (entry.z == 0.0) {
+    return texture(ShaderTerrainMesh.heightfield, uv).x;
+  }
+
+  // Every tile has a border of one pixel in the atlas
+  vec2 local = uv * n - tile;
+  vec2 atlas_pos = entry.xy + 1.0 + local * float(ShaderTerrainMesh.tile_size);
+  return texture(ShaderTerrainMesh.tile_atlas,
+                 atlas_pos / vec2(textureSize(ShaderTerrainMesh.tile_atlas, 0))).x;
+}
+
 void main() {
 
   // Terrain data has the layout:
@@ -47,7 +76,7 @@ void main() {
   // Sample the heightfield and offset the terrain - we do not need to multiply
   // the height with anything since the terrain transform is included in the
   // model view projection matrix.
-  chunk_position.z += texture(ShaderTerrainMesh.heightfield, terrain_uv).x;
+  chunk_position.z += sample_height(terrain_uv);
   gl_Position = p3d_ModelViewProjectionMatrix * vec4(chunk_position, 1);
 
   // Output the vertex world space position - in this case we use this to render
@@ -0,0 +1,83 @@
+import pytest
+from panda3d import core
+
+direct = pytest.importorskip("panda3d.direct")
+
+
+DC_SOURCE = b"""
+struct WayPoint {
+  int16 / 10 x;
+  int16 / 10 y;
+  uint8(0-9) kind;
+};
+
+dclass Avatar {
+  setHp(int16(0-100) hp, uint32 maxHp) broadcast;
+  setWaypoints(WayPoint points[0-2]) broadcast;
+  setFlags(uint8 flags[2], char tag[3]) broadcast;
+};
+"""
+
+
+@pytest.fixture
+def dclass():
+    dcfile = direct.DCFile()
+    assert dcfile.read(core.StringStream(DC_SOURCE), "test.dc")
+    return dcfile.get_class_by_name("Avatar")
+
+
+def test_validate_fixed(dclass):
+    field = dclass.get_field_by_name("setHp")
+
+    assert field.validate_ranges(field.parse_string("[50, 1000]"))
+
+    # Out of range.
+    packer = direct.DCPacker()
+    packer.raw_pack_int16(101)
+    packer.raw_pack_uint32(1000)
+    assert not field.validate_ranges(packer.get_bytes())
+
+    # Too short, and too long.
+    data = field.parse_string("[50, 1000]")
+    assert not field.validate_ranges(data[:-1])
+    assert not field.validate_ranges(data + b"\0")
+
+
+def test_validate_array(dclass):
+    field = dclass.get_field_by_name("setWaypoints")
+
+    assert field.validate_ranges(field.parse_string("[[]]"))
+    assert field.validate_ranges(field.parse_string("[[[1.5, -2, 3], [0, 0, 9]]]"))
+
+    # Too many elements.
+    packer = direct.DCPacker()
+    packer.raw_pack_uint16(15)
+    for i in range(3):
+        packer.raw_pack_int16(0)
+        packer.raw_pack_int16(0)
+        packer.raw_pack_uint8(0)
+    assert not field.validate_ranges(packer.get_bytes())
+
+    # An element out of range.
+    packer = direct.DCPacker()
+    packer.raw_pack_uint16(5)
+    packer.raw_pack_int16(0)
+    packer.raw_pack_int16(0)
+    packer.raw_pack_uint8(10)
+    assert not field.validate_ranges(packer.get_bytes())
+
+    # A length that is not a whole number of elements.
+    packer = direct.DCPacker()
+    packer.raw_pack_uint16(4)
+    packer.raw_pack_int16(0)
+    packer.raw_pack_int16(0)
+    assert not field.validate_ranges(packer.get_bytes())
+
+
+def test_validate_fixed_array(dclass):
+    field = dclass.get_field_by_name("setFlags")
+
+    data = field.parse_string("[[1, 2], 'abc']")
+    assert len(data) == 5
+    assert field.validate_ranges(data)
+    assert not field.validate_ranges(data[:4])
@@ -0,0 +1,145 @@
+import random
+
+import pytest
+from panda3d.core import NodePath, Point3, Vec3
+
+direct = pytest.importorskip("panda3d.direct")
+SmoothMover = direct.SmoothMover
+SmoothMoverGroup = direct.SmoothMoverGroup
+
+
+def make_mover():
+    mover = SmoothMover()
+    mover.set_smooth_mode(SmoothMover.SM_on)
+    mover.set_prediction_mode(SmoothMover.PM_on)
+    mover.set_delay(0.1)
+    mover.set_accept_clock_skew(False)
+    mover.set_max_position_age(0.25)
+    mover.set_expected_broadcast_period(0.2)
+    mover.set_default_to_standing_still(True)
+    return mover
+
+
+def test_smooth_mover_standing_still():
+    # Two reports far apart in time make the mover insert a standing-still
+    # report in front of the later one, moving the reports after it back.
+    mover = make_mover()
+    mover.set_delay(0.0)
+    mover.set_prediction_mode(SmoothMover.PM_off)
+    for timestamp, x in ((0.0, 0.0), (1.0, 10.0), (1.1, 20.0)):
+        mover.set_pos_hpr(Vec3(x, 0, 0), Vec3(0, 0, 0))
+        mover.set_timestamp(timestamp)
+        mover.mark_position()
+
+    # The object stood still at 0 until 0.8, then moved to 10 by 1.0.
+    assert mover.compute_smooth_position(0.5)
+    assert mover.get_smooth_pos() == Point3(0, 0, 0)
+    assert mover.compute_smooth_position(0.9)
+    assert mover.get_smooth_pos().x == pytest.approx(5.0)
+
+    # The later reports are still in order after the inserted one.
+    assert mover.compute_smooth_position(1.05)
+    assert mover.get_smooth_pos().x == pytest.approx(15.0)
+
+
+def test_smooth_mover_standing_still_long_gaps():
+    # Reports a second apart with a short broadcast period make the mover
+    # insert a standing-still report in every gap, on top of the ten reports
+    # it keeps.  None of these may be dropped.
+    mover = make_mover()
+    mover.set_delay(0.0)
+    mover.set_prediction_mode(SmoothMover.PM_off)
+    mover.set_expected_broadcast_period(0.01)
+
+    def mark(timestamp):
+        mover.set_pos_hpr(Vec3(timestamp * timestamp, 0, 0), Vec3(0, 0, 0))
+        mover.set_timestamp(timestamp)
+        mover.mark_position()
+
+    for timestamp in range(1, 7):
+        mark(timestamp)
+    for timestamp in (0.0, 0.5, 1.0):
+        mover.compute_smooth_position(timestamp)
+    for timestamp in range(7, 11):
+        mark(timestamp)
+    mover.compute_smooth_position(1.5)
+    mark(11)
+    mark(12)
+    mover.compute_smooth_position(2.5)
+    mark(13)
+    mark(14)
+
+    # Between two reports the object stands still until one broadcast
+    # period before the later one, then moves to it.
+    for timestamp, x in ((3.5, 9.0), (3.995, 12.5), (4.5, 16.0),
+                         (4.995, 20.5), (9.5, 81.0), (13.995, 182.5)):
+        mover.compute_smooth_position(timestamp)
+        assert mover.get_smooth_pos().x == pytest.approx(x)
+
+
+@pytest.mark.parametrize("num_threads", [1, 4])
+def test_smooth_mover_group_matches_movers(num_threads):
+    rand = random.Random(1)
+    num_movers = 1000
+
+    group = SmoothMoverGroup()
+    group.set_template(make_mover())
+    group.set_num_threads(num_threads)
+
+    root = NodePath("root")
+    nodes = []
+    movers = []
+    for i in range(num_movers):
+        node = root.attach_new_node("mover")
+        assert group.add_mover(node) == i
+        nodes.append(node)
+        movers.append(make_mover())
+
+    timestamp = 0.0
+    for frame in range(60):
+        timestamp += 1.0 / 30.0
+
+        # Each mover gets a report now and then, sometimes late or out of
+        # order, and is occasionally cleared.
+        for i in range(num_movers):
+            r = rand.random()
+            if r < 0.3:
+                pos = Vec3(rand.uniform(-100, 100), rand.uniform(-100, 100), 0)
+                hpr = Vec3(rand.uniform(-180, 180), 0, 0)
+                report_time = timestamp - rand.uniform(-0.05, 0.5)
+                group.mark_position(i, pos, hpr, report_time)
+                movers[i].set_pos_hpr(pos, hpr)
+                movers[i].set_timestamp(report_time)
+                movers[i].mark_position()
+            elif r < 0.31:
+                group.clear_positions(i, True)
+                movers[i].clear_positions(True)
+
+        group.compute_and_apply(timestamp)
+        for i in range(num_movers):
+            movers[i].compute_smooth_position(timestamp)
+            assert group.get_smooth_pos(i) == movers[i].get_smooth_pos()
+            assert group.get_smooth_hpr(i) == movers[i].get_smooth_hpr()
+            assert group.get_smooth_forward_velocity(i) == movers[i].get_smooth_forward_velocity()
+            assert group.get_smooth_rotational_velocity(i) == movers[i].get_smooth_rotational_velocity()
+
+    # The nodes were moved to the smooth positions.
+    for i in range(num_movers):
+        assert nodes[i].get_pos() == movers[i].get_smooth_pos()
+
+
+def test_smooth_mover_group_remove():
+    group = SmoothMoverGroup()
+    group.set_template(make_mover())
+
+    a = group.add_mover(NodePath("a"))
+    b = group.add_mover(NodePath("b"))
+    assert group.get_num_movers() == 2
+
+    group.remove_mover(a)
+    assert not group.has_mover(a)
+    assert group.has_mover(b)
+    assert group.get_num_movers() == 1
+
+    # The slot of a removed mover is reused.
+    assert group.add_mover(NodePath("c")) == a
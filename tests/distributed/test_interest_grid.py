@@ -0,0 +1,57 @@
+import pytest
+from panda3d.core import Point3
+
+direct = pytest.importorskip("panda3d.direct")
+
+
+def collect(grid):
+    grid.update()
+    changes = {}
+    for n in range(grid.get_num_changed_clients()):
+        entered = {grid.get_entered(n, i) for i in range(grid.get_num_entered(n))}
+        left = {grid.get_left(n, i) for i in range(grid.get_num_left(n))}
+        changes[grid.get_changed_client(n)] = (entered, left)
+    return changes
+
+
+def test_interest_grid_zone():
+    grid = direct.CInterestGrid(10, 4, 100)
+
+    assert grid.get_zone_from_xyz(Point3(-20, -20, 0)) == 100
+    assert grid.get_zone_from_xyz(Point3(5, -15, 0)) == 102
+    assert grid.get_zone_from_xyz(Point3(-15, 5, 0)) == 108
+
+    # Positions off the grid are clamped to the edge.
+    assert grid.get_zone_from_xyz(Point3(1000, 1000, 0)) == 115
+
+
+def test_interest_grid_enter_leave():
+    grid = direct.CInterestGrid(10, 10)
+    grid.set_object_pos(1, Point3(0, 0, 0))
+    grid.set_object_pos(2, Point3(40, 40, 0))
+
+    grid.set_client(1000, Point3(5, 5, 0), 1)
+    assert collect(grid) == {1000: ({1}, set())}
+    assert collect(grid) == {}
+
+    # An object moving into view.
+    grid.set_object_pos(2, Point3(15, 15, 0))
+    assert collect(grid) == {1000: ({2}, set())}
+
+    # The client moving away.
+    grid.set_client_pos(1000, Point3(-35, -35, 0))
+    assert collect(grid) == {1000: (set(), {1, 2})}
+    assert not grid.is_visible(1000, 1)
+
+    # Moving back and forth between updates reports nothing.
+    grid.set_client_pos(1000, Point3(5, 5, 0))
+    grid.set_client_pos(1000, Point3(-35, -35, 0))
+    assert collect(grid) == {}
+
+    grid.set_client_pos(1000, Point3(5, 5, 0))
+    grid.remove_object(2)
+    assert collect(grid) == {1000: ({1}, set())}
+
+    grid.remove_client(1000)
+    assert not grid.has_client(1000)
+    assert collect(grid) == {}
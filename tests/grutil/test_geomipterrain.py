@@ -0,0 +1,90 @@
+from panda3d.core import GeoMipTerrain, PNMImage, AsyncTaskManager
+
+
+def make_terrain(name):
+    image = PNMImage(65, 65, 1)
+    for x in range(65):
+        for y in range(65):
+            image.set_gray(x, y, ((x * 7 + y * 3) % 17) / 17.0)
+
+    terrain = GeoMipTerrain(name)
+    terrain.set_heightfield(image)
+    terrain.set_block_size(16)
+    terrain.set_factor(10)
+    terrain.set_focal_point(0, 0)
+    terrain.generate()
+    return terrain
+
+
+def get_blocks(terrain):
+    blocks = []
+    for mx in range(4):
+        for my in range(4):
+            geom = terrain.get_block_node_path(mx, my).node().get_geom(0)
+            blocks.append((geom.get_vertex_data().get_num_rows(),
+                           geom.get_primitive(0).get_num_vertices()))
+    return blocks
+
+
+def finish_updates(terrain):
+    task_mgr = AsyncTaskManager.get_global_ptr()
+    changed = False
+    for i in range(10000):
+        task_mgr.poll()
+        if terrain.update():
+            changed = True
+        if not terrain.is_update_pending():
+            break
+    assert not terrain.is_update_pending()
+    return changed
+
+
+def test_geomipterrain_async_update():
+    sync_terrain = make_terrain("sync")
+    sync_terrain.set_focal_point(64, 64)
+    assert sync_terrain.update()
+
+    terrain = make_terrain("async")
+    terrain.set_async_update(True)
+    assert terrain.get_async_update()
+    before = get_blocks(terrain)
+
+    terrain.set_focal_point(64, 64)
+    assert not terrain.update()
+    assert terrain.is_update_pending()
+
+    # The old blocks are still in place while the new ones are generated.
+    assert get_blocks(terrain) == before
+
+    assert finish_updates(terrain)
+    assert get_blocks(terrain) == get_blocks(sync_terrain)
+
+    # Nothing left to do.
+    assert not terrain.update()
+    assert not terrain.is_update_pending()
+
+
+def test_geomipterrain_async_budget():
+    sync_terrain = make_terrain("sync")
+    sync_terrain.set_focal_point(64, 64)
+    sync_terrain.update()
+
+    terrain = make_terrain("async")
+    terrain.set_async_update(True)
+    terrain.set_max_block_updates(1)
+    terrain.set_focal_point(64, 64)
+    terrain.update()
+
+    # Each batch changes the level of only one block, so it takes several
+    # batches to catch up.
+    task_mgr = AsyncTaskManager.get_global_ptr()
+    num_batches = 0
+    for i in range(10000):
+        task_mgr.poll()
+        if terrain.update():
+            num_batches += 1
+        if not terrain.is_update_pending():
+            break
+
+    assert num_batches > 1
+    assert get_blocks(terrain) == get_blocks(sync_terrain)
@@ -0,0 +1,41 @@
+from panda3d.core import ShaderTerrainMesh, Filename, Texture
+import struct
+
+
+def write_heightfield(path, size, height):
+    # Raw 16-bit little-endian, top row first
+    with open(path, "wb") as out:
+        for y in range(size):
+            out.write(struct.pack("<%dH" % size, *[height] * size))
+
+
+def test_shaderterrainmesh_streaming(tmp_path):
+    path = tmp_path / "heightfield.raw"
+    write_heightfield(str(path), 256, 32768)
+
+    terrain = ShaderTerrainMesh()
+    terrain.streaming_heightfield = Filename.from_os_specific(str(path))
+    terrain.chunk_size = 16
+    terrain.tile_size = 64
+    terrain.streaming_budget = 4 * 66 * 66 * 2
+    assert terrain.generate()
+
+    assert terrain.is_streaming()
+    assert terrain.get_max_resident_tiles() == 4
+    assert terrain.get_num_resident_tiles() == 0
+    assert abs(terrain.uv_to_world(0.5, 0.5).z - 32768 / 65535.0) < 0.001
+
+    # A regular heightfield replaces the streaming one.
+    terrain.heightfield = Texture()
+    assert terrain.streaming_heightfield.empty()
+
+
+def test_shaderterrainmesh_streaming_invalid(tmp_path):
+    path = tmp_path / "heightfield.raw"
+    with open(str(path), "wb") as out:
+        out.write(b"\0" * 1000)
+
+    terrain = ShaderTerrainMesh()
+    terrain.streaming_heightfield = Filename.from_os_specific(str(path))
+    assert not terrain.generate()
+    assert not terrain.is_streaming()
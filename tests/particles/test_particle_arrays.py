@@ -0,0 +1,69 @@
+from panda3d.core import NodePath, PandaNode
+from panda3d.physics import LineParticleRenderer, PointParticleRenderer
+from direct.particles.Particles import Particles
+
+
+def make_system(pool_size):
+    system = Particles("testSystem", pool_size)
+    system.set_render_parent(NodePath(PandaNode("test")))
+    system.set_spawn_render_node_path(NodePath(PandaNode("test")))
+    return system
+
+
+def test_particle_array_mode_birth_rate():
+    system = make_system(2)
+    system.set_array_mode(True)
+    assert system.get_array_mode()
+    assert system.get_living_particles() == 0
+
+    system.update(0.6)
+    assert system.get_living_particles() == 1
+
+    system.update(0.5)
+    assert system.get_living_particles() == 2
+
+    # Should still be 2, since the pool size was 2.
+    system.update(0.5)
+    assert system.get_living_particles() == 2
+
+    # Leaving array mode kills the particles.
+    system.set_array_mode(False)
+    assert not system.get_array_mode()
+    assert system.get_living_particles() == 0
+
+
+def test_particle_array_mode_lifespan():
+    system = make_system(10)
+    system.set_array_mode(True)
+    system.get_factory().set_lifespan_base(1.0)
+    system.get_factory().set_lifespan_spread(0.0)
+
+    # Birth a single litter.
+    system.set_birth_rate(100)
+    system.induce_labor()
+    system.update(0.5)
+    assert system.get_living_particles() == 1
+    system.render()
+
+    # The particle dies after a second.
+    system.update(0.75)
+    assert system.get_living_particles() == 0
+    system.render()
+
+
+def test_particle_array_mode_renderer():
+    system = make_system(4)
+    assert PointParticleRenderer().supports_arrays()
+    assert not LineParticleRenderer().supports_arrays()
+
+    system.set_renderer(LineParticleRenderer())
+    system.set_array_mode(True)
+    assert not system.get_array_mode()
+
+    system.set_renderer(PointParticleRenderer())
+    system.set_array_mode(True)
+    assert system.get_array_mode()
+
+    # Switching to a renderer that can't draw arrays leaves array mode.
+    system.set_renderer(LineParticleRenderer())
+    assert not system.get_array_mode()
@@ -0,0 +1,95 @@
+from panda3d.core import PfmFile, PfmTiledFile, Filename, LPoint3f, LPoint4f
+
+
+def make_pfm(x_size, y_size):
+    pfm = PfmFile()
+    pfm.clear(x_size, y_size, 3)
+    for y in range(y_size):
+        for x in range(x_size):
+            pfm.set_point(x, y, (x, y, x * y))
+    return pfm
+
+
+def test_pfm_tiled_roundtrip(tmp_path):
+    path = Filename.from_os_specific(str(tmp_path / "test.pfmt"))
+    pfm = make_pfm(37, 29)
+
+    tiled = PfmTiledFile()
+    assert tiled.create(path, 37, 29, 3, 8)
+    assert tiled.get_num_tiles_x() == 5
+    assert tiled.get_num_tiles_y() == 4
+
+    # Keep only one tile in memory at once, so that writing the image has to
+    # flush the others to disk.
+    tiled.max_cache_size = 1
+    tiled.copy_sub_image(pfm, 0, 0)
+    assert tiled.get_num_cached_tiles() == 1
+    tiled.close()
+
+    assert tiled.open(path)
+    assert not tiled.writable
+    assert tiled.get_x_size() == 37
+    assert tiled.get_y_size() == 29
+    assert tiled.get_point(13, 17) == pfm.get_point(13, 17)
+
+    sub = PfmFile()
+    assert tiled.store_sub_image(sub, 5, 6, 20, 10)
+    for y in range(10):
+        for x in range(20):
+            assert sub.get_point(x, y) == pfm.get_point(x + 5, y + 6)
+
+    min1, max1 = LPoint3f(), LPoint3f()
+    min2, max2 = LPoint3f(), LPoint3f()
+    assert tiled.calc_min_max(min1, max1)
+    assert pfm.calc_min_max(min2, max2)
+    assert min1 == min2
+    assert max1 == max2
+
+    p1, p2 = LPoint3f(), LPoint3f()
+    assert tiled.calc_bilinear_point(p1, 0.3, 0.7)
+    assert pfm.calc_bilinear_point(p2, 0.3, 0.7)
+    assert p1.almost_equal(p2)
+
+
+def test_pfm_tiled_no_data(tmp_path):
+    path = Filename.from_os_specific(str(tmp_path / "test.pfmt"))
+
+    tiled = PfmTiledFile()
+    assert tiled.create(path, 20, 20, 3, 8)
+    tiled.set_no_data_value(LPoint4f(-1, -1, -1, 0))
+    tiled.fill(LPoint4f(-1, -1, -1, 0))
+    tiled.set_point(3, 4, (1, 2, 3))
+    tiled.set_point(15, 16, (4, 5, 6))
+    tiled.close()
+
+    assert tiled.open(path)
+    assert tiled.has_no_data_value()
+    assert tiled.has_point(3, 4)
+    assert not tiled.has_point(4, 4)
+
+    min_point, max_point = LPoint3f(), LPoint3f()
+    assert tiled.calc_min_max(min_point, max_point)
+    assert min_point == (1, 2, 3)
+    assert max_point == (4, 5, 6)
+
+
+def test_pfm_tiled_crop_resize(tmp_path):
+    path = Filename.from_os_specific(str(tmp_path / "test.pfmt"))
+    pfm = make_pfm(40, 30)
+
+    tiled = PfmTiledFile()
+    assert tiled.create(path, 40, 30, 3, 16)
+    tiled.copy_sub_image(pfm, 0, 0)
+
+    assert tiled.apply_crop(4, 36, 2, 26)
+    assert tiled.writable
+    assert tiled.get_x_size() == 32
+    assert tiled.get_y_size() == 24
+    assert tiled.get_point(0, 0) == pfm.get_point(4, 2)
+    assert tiled.get_point(31, 23) == pfm.get_point(35, 25)
+
+    # Halving each axis averages each 2x2 block.
+    assert tiled.resize(16, 12)
+    assert tiled.get_x_size() == 16
+    assert tiled.get_y_size() == 12
+    assert tiled.get_point(0, 0).almost_equal((4.5, 2.5, 11.25))
@@ -0,0 +1,35 @@
+from panda3d import core
+import pytest
+
+
+@pytest.fixture
+def font():
+    default = core.TextNode.get_default_font()
+    if not isinstance(default, core.DynamicTextFont):
+        pytest.skip("requires FreeType")
+
+    font = default.make_copy()
+    font.clear()
+    return font
+
+
+def test_dynamic_text_font_preload_glyphs(font):
+    assert font.preload_glyphs("abcabc") == 3
+    assert font.preload_glyphs("abcd") == 1
+    assert font.get_num_pages() == 1
+
+    glyph = font.get_glyph(ord("d"))
+    assert glyph is not None
+    assert not glyph.is_whitespace()
+
+
+def test_dynamic_text_font_preload_glyph_range(font):
+    assert font.preload_glyph_range(ord("A"), ord("Z")) == 26
+    assert font.preload_glyph_range(ord("Z"), ord("A")) == 0
+
+    # Nothing refers to the glyphs, so they can all be collected, and the
+    # page is empty again.
+    assert font.garbage_collect() >= 26
+    assert font.get_page(0).is_empty()
+    assert font.preload_glyph_range(ord("A"), ord("Z")) == 26
+    assert font.get_num_pages() == 1
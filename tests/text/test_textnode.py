@@ -111,3 +111,24 @@ def test_textnode_flatten_colorscale():
     assert text.shadow_color.almost_equal((0, .5, 0, 0))
     assert text.frame_color.almost_equal((0, 0, .5, 0))
     assert text.card_color.almost_equal((0, 0, 0, .5))
+
+
+def test_textnode_update_text():
+    text = core.TextNode("test")
+    text.text = "Score: 10"
+    text.align = core.TextNode.A_center
+    width = text.width
+    text.get_internal_geom()
+
+    # Changing only the text should give the same result as a fresh node.
+    text.text = "Score: 1000\nTime: 0:00"
+    fresh = core.TextNode("fresh")
+    fresh.text = "Score: 1000\nTime: 0:00"
+    fresh.align = core.TextNode.A_center
+
+    assert text.width > width
+    assert text.width == fresh.width
+    assert text.height == fresh.height
+    assert text.get_num_rows() == 2
+    assert text.get_frame_actual() == fresh.get_frame_actual()
+    assert text.get_internal_geom().get_bounds() == fresh.get_internal_geom().get_bounds()